@@ -0,0 +1,593 @@
+/*
+* Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+* Licensed under the MIT license. See LICENSE file in the project root for details.
+* SPDX-License-Identifier: MIT
+*/
+
+/*************************************************************************************************/
+/*  Benchmarks                                                                                   */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "bench.h"
+#include "alloc.h"
+#include "common.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "fifo.h"
+#include "scene/array.h"
+#include "scene/baker.h"
+#include "scene/visual.h"
+#include "scene/visuals/point.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define BENCH_MAX_SAMPLES 1024
+#define BENCH_WARMUP      3
+#define BENCH_SEED        0x2545F491
+#define BENCH_FIFO_BURST  100
+
+#define BENCH_WIDTH  800
+#define BENCH_HEIGHT 600
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzBench DvzBench;
+typedef struct DvzBenchSpec DvzBenchSpec;
+typedef struct DvzBenchStats DvzBenchStats;
+
+typedef void (*DvzBenchCallback)(DvzBench* bench);
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzBench
+{
+    uint32_t items;      // number of items processed by an iteration
+    uint32_t iterations; // number of timed iterations
+    uint32_t iter;       // current iteration, warmup iterations included
+    uint32_t count;      // number of recorded samples
+    DvzTime start;
+    double samples[BENCH_MAX_SAMPLES]; // iteration durations, in seconds
+};
+
+
+
+struct DvzBenchSpec
+{
+    const char* name;
+    DvzBenchCallback callback;
+    uint32_t items;
+    uint32_t iterations;
+};
+
+
+
+struct DvzBenchStats
+{
+    double min, median, p95, p99, mean; // in microseconds
+};
+
+
+
+/*************************************************************************************************/
+/*  Harness                                                                                      */
+/*************************************************************************************************/
+
+// Start the next iteration, return false when all iterations have been run.
+static bool _bench_next(DvzBench* bench)
+{
+    ANN(bench);
+    return bench->iter++ < BENCH_WARMUP + bench->iterations;
+}
+
+
+
+static void _bench_tic(DvzBench* bench)
+{
+    ANN(bench);
+    dvz_time(&bench->start);
+}
+
+
+
+// NOTE: the warmup iterations are run but not recorded.
+static void _bench_toc(DvzBench* bench)
+{
+    ANN(bench);
+    DvzTime end = {0};
+    dvz_time(&end);
+    if (bench->iter <= BENCH_WARMUP || bench->count >= BENCH_MAX_SAMPLES)
+        return;
+    bench->samples[bench->count++] =
+        (double)(end.seconds - bench->start.seconds) +
+        ((double)end.nanoseconds - (double)bench->start.nanoseconds) * 1e-9;
+}
+
+
+
+static int _bench_compare(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+
+
+// Nearest-rank percentile of sorted samples.
+static double _bench_percentile(double* sorted, uint32_t count, double p)
+{
+    ANN(sorted);
+    ASSERT(count > 0);
+    uint32_t rank = (uint32_t)ceil(p * count);
+    rank = CLIP(rank, 1, count);
+    return sorted[rank - 1];
+}
+
+
+
+static DvzBenchStats _bench_stats(DvzBench* bench)
+{
+    ANN(bench);
+    DvzBenchStats stats = {0};
+    uint32_t n = bench->count;
+    if (n == 0)
+        return stats;
+
+    qsort(bench->samples, n, sizeof(double), _bench_compare);
+    double sum = 0;
+    for (uint32_t i = 0; i < n; i++)
+        sum += bench->samples[i];
+
+    stats.min = bench->samples[0] * 1e6;
+    stats.median = _bench_percentile(bench->samples, n, .5) * 1e6;
+    stats.p95 = _bench_percentile(bench->samples, n, .95) * 1e6;
+    stats.p99 = _bench_percentile(bench->samples, n, .99) * 1e6;
+    stats.mean = sum / n * 1e6;
+    return stats;
+}
+
+
+
+// Deterministic xorshift generator, so that all runs process the same data.
+static inline uint32_t _bench_rand(uint32_t* state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+
+
+static vec3* _bench_positions(uint32_t count)
+{
+    vec3* pos = (vec3*)calloc(count, sizeof(vec3));
+    ANN(pos);
+    uint32_t state = BENCH_SEED;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pos[i][0] = (_bench_rand(&state) & 0xFFFF) / 32768.0f - 1;
+        pos[i][1] = (_bench_rand(&state) & 0xFFFF) / 32768.0f - 1;
+    }
+    return pos;
+}
+
+
+
+/*************************************************************************************************/
+/*  CPU benchmarks                                                                               */
+/*************************************************************************************************/
+
+// Allocate blocks of random sizes, free every other one, fill the holes, and free everything.
+static void _bench_alloc_churn(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    DvzSize* offsets = (DvzSize*)calloc(n, sizeof(DvzSize));
+    DvzSize* sizes = (DvzSize*)calloc(n, sizeof(DvzSize));
+    uint32_t state = BENCH_SEED;
+    for (uint32_t i = 0; i < n; i++)
+        sizes[i] = 16 + (_bench_rand(&state) % 4096);
+
+    DvzSize resized = 0;
+    while (_bench_next(bench))
+    {
+        DvzAlloc* alloc = dvz_alloc(1024 * 1024, 16);
+
+        _bench_tic(bench);
+        for (uint32_t i = 0; i < n; i++)
+            offsets[i] = dvz_alloc_new(alloc, sizes[i], &resized);
+        for (uint32_t i = 0; i < n; i += 2)
+            dvz_alloc_free(alloc, offsets[i]);
+        for (uint32_t i = 0; i < n; i += 2)
+            offsets[i] = dvz_alloc_new(alloc, sizes[n - 1 - i], &resized);
+        for (uint32_t i = 0; i < n; i++)
+            dvz_alloc_free(alloc, offsets[i]);
+        _bench_toc(bench);
+
+        dvz_alloc_destroy(alloc);
+    }
+
+    FREE(offsets);
+    FREE(sizes);
+}
+
+
+
+// Enqueue and dequeue bursts of items, the FIFO queue capacity being bounded.
+static void _bench_fifo(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    DvzFifo* fifo = dvz_fifo(DVZ_MAX_FIFO_CAPACITY);
+    int item = 0;
+
+    while (_bench_next(bench))
+    {
+        _bench_tic(bench);
+        for (uint32_t i = 0; i < n; i += BENCH_FIFO_BURST)
+        {
+            for (uint32_t j = 0; j < BENCH_FIFO_BURST; j++)
+                dvz_fifo_enqueue(fifo, &item);
+            for (uint32_t j = 0; j < BENCH_FIFO_BURST; j++)
+                dvz_fifo_dequeue(fifo, false);
+        }
+        _bench_toc(bench);
+    }
+
+    dvz_fifo_destroy(fifo);
+}
+
+
+
+static void _bench_batch_add(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    DvzBatch* batch = dvz_batch();
+
+    while (_bench_next(bench))
+    {
+        _bench_tic(bench);
+        for (uint32_t i = 0; i < n; i++)
+            dvz_create_dat(batch, DVZ_BUFFER_TYPE_VERTEX, 1024, 0);
+        _bench_toc(bench);
+
+        dvz_batch_clear(batch);
+    }
+
+    dvz_batch_destroy(batch);
+}
+
+
+
+// Write a batch of requests to a file and read it back.
+static void _bench_batch_serialize(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/bench_batch.dvz", ARTIFACTS_DIR);
+
+    DvzBatch* batch = dvz_batch();
+    DvzBatch* loaded = dvz_batch();
+    for (uint32_t i = 0; i < n; i++)
+        dvz_create_dat(batch, DVZ_BUFFER_TYPE_VERTEX, 1024, 0);
+
+    while (_bench_next(bench))
+    {
+        _bench_tic(bench);
+        dvz_batch_dump(batch, path);
+        dvz_batch_load(loaded, path);
+        _bench_toc(bench);
+
+        ASSERT(loaded->count == n);
+        dvz_batch_clear(loaded);
+    }
+
+    remove(path);
+    dvz_batch_destroy(batch);
+    dvz_batch_destroy(loaded);
+}
+
+
+
+// Copy a vec3 column into a record array, as done when baking the point vertices.
+static void _bench_array_column(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    DvzArray* array = dvz_array_struct(n, sizeof(DvzPointVertex));
+    vec3* pos = _bench_positions(n);
+
+    while (_bench_next(bench))
+    {
+        _bench_tic(bench);
+        dvz_array_column(
+            array, 0, sizeof(vec3), 0, n, n, pos, DVZ_DTYPE_NONE, DVZ_DTYPE_NONE,
+            DVZ_ARRAY_COPY_SINGLE, 1);
+        _bench_toc(bench);
+    }
+
+    FREE(pos);
+    dvz_array_destroy(array);
+}
+
+
+
+// Repeat each position four times, as done when baking the quad-based visuals.
+static void _bench_baker_repeat(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    DvzBatch* batch = dvz_batch();
+    DvzBaker* baker = dvz_baker(batch, 0);
+    dvz_baker_vertex(baker, 0, sizeof(DvzPointVertex));
+    dvz_baker_attr(baker, 0, 0, 0, sizeof(vec3));
+    dvz_baker_create(baker, 0, 4 * n);
+    vec3* pos = _bench_positions(n);
+
+    while (_bench_next(bench))
+    {
+        _bench_tic(bench);
+        dvz_baker_repeat(baker, 0, 0, n, 4, pos);
+        _bench_toc(bench);
+    }
+
+    FREE(pos);
+    dvz_baker_destroy(baker);
+    dvz_batch_destroy(batch);
+}
+
+
+
+static void _bench_point_position(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    DvzBatch* batch = dvz_batch();
+    DvzVisual* visual = dvz_point(batch, 0);
+    dvz_point_alloc(visual, n);
+    vec3* pos = _bench_positions(n);
+
+    while (_bench_next(bench))
+    {
+        _bench_tic(bench);
+        dvz_point_position(visual, 0, n, pos, 0);
+        _bench_toc(bench);
+    }
+
+    FREE(pos);
+    dvz_visual_destroy(visual);
+    dvz_batch_destroy(batch);
+}
+
+
+
+static void _bench_path_position(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    DvzBatch* batch = dvz_batch();
+    DvzVisual* visual = dvz_path(batch, 0);
+    dvz_path_alloc(visual, n);
+    vec3* pos = _bench_positions(n);
+
+    while (_bench_next(bench))
+    {
+        _bench_tic(bench);
+        dvz_path_position(visual, 0, n, pos, 1, &n, 0);
+        _bench_toc(bench);
+    }
+
+    FREE(pos);
+    dvz_visual_destroy(visual);
+    dvz_batch_destroy(batch);
+}
+
+
+
+static void _bench_glyph_position(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    DvzBatch* batch = dvz_batch();
+    DvzVisual* visual = dvz_glyph(batch, 0);
+    dvz_glyph_alloc(visual, n);
+    vec3* pos = _bench_positions(n);
+
+    while (_bench_next(bench))
+    {
+        _bench_tic(bench);
+        dvz_glyph_position(visual, 0, n, pos, 0);
+        _bench_toc(bench);
+    }
+
+    FREE(pos);
+    dvz_visual_destroy(visual);
+    dvz_batch_destroy(batch);
+}
+
+
+
+/*************************************************************************************************/
+/*  GPU benchmarks                                                                               */
+/*************************************************************************************************/
+
+// Offscreen frame: update the point positions, render the scene, and download the image.
+static void _bench_server_frame(DvzBench* bench)
+{
+    ANN(bench);
+    uint32_t n = bench->items;
+    DvzServer* server = dvz_server(0);
+    ANN(server);
+
+    DvzScene* scene = dvz_scene(NULL);
+    DvzFigure* figure = dvz_figure(scene, BENCH_WIDTH, BENCH_HEIGHT, 0);
+    DvzPanel* panel = dvz_panel_default(figure);
+
+    DvzVisual* visual = dvz_point(dvz_scene_batch(scene), 0);
+    dvz_point_alloc(visual, n);
+    vec3* pos = _bench_positions(n);
+    DvzColor* color = dvz_mock_color(n, 200);
+    float* size = dvz_mock_uniform(n, 2.0, 10.0);
+    dvz_point_position(visual, 0, n, pos, 0);
+    dvz_point_color(visual, 0, n, color, 0);
+    dvz_point_size(visual, 0, n, size, 0);
+    dvz_panel_visual(panel, visual, 0);
+
+    DvzId canvas_id = dvz_figure_id(figure);
+    uint8_t* rgb = NULL;
+    while (_bench_next(bench))
+    {
+        // Move all points at every frame so that the vertex buffer is uploaded.
+        for (uint32_t i = 0; i < n; i++)
+            pos[i][2] = .001f * (bench->iter % 100);
+
+        _bench_tic(bench);
+        dvz_point_position(visual, 0, n, pos, 0);
+        dvz_scene_render(scene, server);
+        rgb = dvz_server_grab(server, canvas_id, 0);
+        _bench_toc(bench);
+
+        ANN(rgb);
+    }
+
+    FREE(pos);
+    FREE(color);
+    FREE(size);
+    dvz_scene_destroy(scene);
+    dvz_server_destroy(server);
+}
+
+
+
+/*************************************************************************************************/
+/*  Benchmark list                                                                               */
+/*************************************************************************************************/
+
+// NOTE: the path and glyph visuals bake four vertices per point, the largest sizes are therefore
+// limited to 1e6 items to keep the memory usage below a few gigabytes.
+static DvzBenchSpec BENCHMARKS[] = {
+    {"cpu/alloc_churn", _bench_alloc_churn, 2000, 50},
+    {"cpu/fifo_throughput", _bench_fifo, 100000, 100},
+    {"cpu/batch_add", _bench_batch_add, 10000, 100},
+    {"cpu/batch_serialize", _bench_batch_serialize, 10000, 50},
+    {"cpu/array_column", _bench_array_column, 1000000, 50},
+    {"cpu/baker_repeat", _bench_baker_repeat, 1000000, 50},
+
+    {"cpu/point_position_1e3", _bench_point_position, 1000, 1000},
+    {"cpu/point_position_1e4", _bench_point_position, 10000, 1000},
+    {"cpu/point_position_1e5", _bench_point_position, 100000, 100},
+    {"cpu/point_position_1e6", _bench_point_position, 1000000, 20},
+    {"cpu/point_position_1e7", _bench_point_position, 10000000, 5},
+
+    {"cpu/path_position_1e3", _bench_path_position, 1000, 1000},
+    {"cpu/path_position_1e4", _bench_path_position, 10000, 100},
+    {"cpu/path_position_1e5", _bench_path_position, 100000, 20},
+    {"cpu/path_position_1e6", _bench_path_position, 1000000, 5},
+
+    {"cpu/glyph_position_1e3", _bench_glyph_position, 1000, 1000},
+    {"cpu/glyph_position_1e4", _bench_glyph_position, 10000, 100},
+    {"cpu/glyph_position_1e5", _bench_glyph_position, 100000, 20},
+    {"cpu/glyph_position_1e6", _bench_glyph_position, 1000000, 5},
+
+    {"gpu/server_frame_1e5", _bench_server_frame, 100000, 100},
+};
+
+
+
+/*************************************************************************************************/
+/*  Entry point                                                                                  */
+/*************************************************************************************************/
+
+static void _bench_write(FILE* f, const char* name, DvzBench* bench, DvzBenchStats* stats)
+{
+    ANN(f);
+    ANN(bench);
+    ANN(stats);
+
+    double median = stats->median * 1e-6;
+    fprintf(
+        f,
+        "    {\"name\": \"%s\", \"items\": %u, \"iterations\": %u, \"min\": %.3f, "
+        "\"median\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"mean\": %.3f, "
+        "\"ops_per_second\": %.3f, \"items_per_second\": %.1f}",
+        name, bench->items, bench->count, stats->min, stats->median, stats->p95, stats->p99,
+        stats->mean, median > 0 ? 1.0 / median : 0.0,
+        median > 0 ? bench->items / median : 0.0);
+}
+
+
+
+int dvz_run_benchmarks(const char* match, const char* output)
+{
+    FILE* f = stdout;
+    if (output != NULL)
+    {
+        f = fopen(output, "w");
+        if (f == NULL)
+        {
+            log_error("unable to write the benchmark results to %s", output);
+            return 1;
+        }
+    }
+
+    uint32_t n = sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]);
+    bool first = true;
+    fprintf(
+        f, "{\n  \"datoviz\": \"%s\",\n  \"unit\": \"us\",\n  \"benchmarks\": [\n",
+        dvz_version());
+    for (uint32_t i = 0; i < n; i++)
+    {
+        DvzBenchSpec* spec = &BENCHMARKS[i];
+        if (match != NULL && strstr(spec->name, match) == NULL)
+            continue;
+
+        DvzBench* bench = (DvzBench*)calloc(1, sizeof(DvzBench));
+        ANN(bench);
+        bench->items = spec->items;
+        bench->iterations = MIN(spec->iterations, BENCH_MAX_SAMPLES);
+
+        log_info("running benchmark %s", spec->name);
+        spec->callback(bench);
+        DvzBenchStats stats = _bench_stats(bench);
+        log_info(
+            "%-28s median %12.3f us   p95 %12.3f us   p99 %12.3f us", spec->name, stats.median,
+            stats.p95, stats.p99);
+
+        if (!first)
+            fputs(",\n", f);
+        _bench_write(f, spec->name, bench, &stats);
+        first = false;
+        FREE(bench);
+    }
+    fputs("\n  ]\n}\n", f);
+
+    if (f != stdout)
+    {
+        fclose(f);
+        log_info("wrote the benchmark results to %s", output);
+    }
+    return 0;
+}
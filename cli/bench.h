@@ -0,0 +1,47 @@
+/*
+* Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+* Licensed under the MIT license. See LICENSE file in the project root for details.
+* SPDX-License-Identifier: MIT
+*/
+
+/*************************************************************************************************/
+/*  Benchmarks                                                                                   */
+/*************************************************************************************************/
+
+/*
+Micro-benchmarks of the hot paths of the library, run with `datoviz bench [match] [output.json]`.
+
+Each benchmark runs a fixed number of warmup and timed iterations on deterministic data, and
+reports the min, median, p95, p99 and mean durations of an iteration. The benchmark names start
+with `cpu/` or `gpu/`: `datoviz bench cpu` only runs the benchmarks that do not need a GPU.
+*/
+
+#ifndef DVZ_HEADER_BENCH
+#define DVZ_HEADER_BENCH
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_macros.h"
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Run the benchmarks and write the results as JSON.
+ *
+ * @param match only run the benchmarks whose name contains this string, or all if NULL
+ * @param output the path of the JSON file, or NULL to write the results to stdout
+ * @returns 0 if the benchmarks ran and the results were written
+ */
+int dvz_run_benchmarks(const char* match, const char* output);
+
+
+
+#endif
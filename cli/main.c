@@ -5,7 +5,7 @@
 */
 
 /*************************************************************************************************/
-/*  Command-line utility for running tests and demos                                             */
+/*  Command-line utility for running tests, benchmarks and demos                                 */
 /*************************************************************************************************/
 
 
@@ -20,6 +20,7 @@
 
 #include "main.h"
 #include "_macros.h"
+#include "bench.h"
 #include "common.h"
 #include "datoviz.h"
 #include "test.h"
@@ -49,6 +50,16 @@ static int test(int argc, char** argv)
 
 
 
+// Usage: datoviz bench [match] [output.json]
+static int bench(int argc, char** argv)
+{
+    const char* match = argc >= 2 ? argv[1] : NULL;
+    const char* output = argc >= 3 ? argv[2] : NULL;
+    return dvz_run_benchmarks(match, output);
+}
+
+
+
 static int info(int argc, char** argv)
 {
     printf("%s version %s\n", DVZ_NAME, dvz_version());
@@ -78,6 +89,7 @@ int main(int argc, char** argv)
 
     SWITCH_CLI_ARG(info)
     SWITCH_CLI_ARG(test)
+    SWITCH_CLI_ARG(bench)
     SWITCH_CLI_ARG(demo)
 
     return res;
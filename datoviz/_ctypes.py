@@ -402,6 +402,7 @@ DVZ_VERSION_PATCH = 1
 class DvzAppFlags(CtypesEnum):
     DVZ_APP_FLAGS_NONE = 0x000000
     DVZ_APP_FLAGS_OFFSCREEN = 0x008000
+    DVZ_APP_FLAGS_ON_DEMAND = 0x010000
     DVZ_APP_FLAGS_WHITE_BACKGROUND = 0x100000
 
 
@@ -414,6 +415,8 @@ class DvzCanvasFlags(CtypesEnum):
     DVZ_CANVAS_FLAGS_VSYNC = 0x0010
     DVZ_CANVAS_FLAGS_PICK = 0x0020
     DVZ_CANVAS_FLAGS_PUSH_SCALE = 0x0040
+    DVZ_CANVAS_FLAGS_OIT = 0x0080
+    DVZ_CANVAS_FLAGS_PROFILE = 0x0100
 
 
 class DvzKeyboardModifiers(CtypesEnum):
@@ -524,6 +527,7 @@ class DvzVisualFlags(CtypesEnum):
     DVZ_VISUAL_FLAGS_DEFAULT = 0x000000
     DVZ_VISUAL_FLAGS_INDEXED = 0x010000
     DVZ_VISUAL_FLAGS_INDIRECT = 0x020000
+    DVZ_VISUAL_FLAGS_SCALAR = 0x040000
     DVZ_VISUAL_FLAGS_FIXED_X = 0x001000
     DVZ_VISUAL_FLAGS_FIXED_Y = 0x002000
     DVZ_VISUAL_FLAGS_FIXED_Z = 0x004000
@@ -561,6 +565,8 @@ class DvzUploadFlags(CtypesEnum):
 class DvzTexFlags(CtypesEnum):
     DVZ_TEX_FLAGS_NONE = 0x0000
     DVZ_TEX_FLAGS_PERSISTENT_STAGING = 0x2000
+    DVZ_TEX_FLAGS_STREAMING = 0x4000
+    DVZ_TEX_FLAGS_OCCUPANCY = 0x8000
 
 
 class DvzFontFlags(CtypesEnum):
@@ -597,7 +603,9 @@ class DvzRecorderCommandType(CtypesEnum):
     DVZ_RECORDER_VIEWPORT = 6
     DVZ_RECORDER_PUSH = 7
     DVZ_RECORDER_END = 8
-    DVZ_RECORDER_COUNT = 9
+    DVZ_RECORDER_TIMESTAMP = 9
+    DVZ_RECORDER_DISPATCH = 10
+    DVZ_RECORDER_COUNT = 11
 
 
 class DvzRequestAction(CtypesEnum):
@@ -613,6 +621,7 @@ class DvzRequestAction(CtypesEnum):
     DVZ_REQUEST_ACTION_DOWNLOAD = 9
     DVZ_REQUEST_ACTION_SET = 10
     DVZ_REQUEST_ACTION_GET = 11
+    DVZ_REQUEST_ACTION_DISPATCH = 12
 
 
 class DvzRequestObject(CtypesEnum):
@@ -925,6 +934,7 @@ class DvzVolumeFlags(CtypesEnum):
     DVZ_VOLUME_FLAGS_RGBA = 0x0001
     DVZ_VOLUME_FLAGS_COLORMAP = 0x0002
     DVZ_VOLUME_FLAGS_BACK_FRONT = 0x0004
+    DVZ_VOLUME_FLAGS_BRICKED = 0x0008
 
 
 class DvzEasing(CtypesEnum):
@@ -974,6 +984,12 @@ class DvzBoxMergeStrategy(CtypesEnum):
     DVZ_BOX_MERGE_CORNER = 2
 
 
+class DvzSpatialType(CtypesEnum):
+    DVZ_SPATIAL_NONE = 0
+    DVZ_SPATIAL_POINTS = 1
+    DVZ_SPATIAL_MESH = 2
+
+
 class DvzViewportClip(CtypesEnum):
     DVZ_VIEWPORT_CLIP_INNER = 0x0001
     DVZ_VIEWPORT_CLIP_OUTER = 0x0002
@@ -1357,6 +1373,7 @@ ShaderType = DvzShaderType
 ShapeIndexingFlags = DvzShapeIndexingFlags
 ShapeType = DvzShapeType
 SlotType = DvzSlotType
+SpatialType = DvzSpatialType
 SphereFlags = DvzSphereFlags
 TexDims = DvzTexDims
 TexFlags = DvzTexFlags
@@ -1373,6 +1390,7 @@ ALIGN_MIDDLE = 2
 ALIGN_NONE = 0
 APP_FLAGS_NONE = 0x000000
 APP_FLAGS_OFFSCREEN = 0x008000
+APP_FLAGS_ON_DEMAND = 0x010000
 APP_FLAGS_WHITE_BACKGROUND = 0x100000
 ARCBALL_FLAGS_CONSTRAIN = 1
 ARCBALL_FLAGS_NONE = 0
@@ -1403,7 +1421,9 @@ CANVAS_FLAGS_IMGUI = 0x0001
 CANVAS_FLAGS_MONITOR = 0x0005
 CANVAS_FLAGS_NONE = 0x0000
 CANVAS_FLAGS_PICK = 0x0020
+CANVAS_FLAGS_PROFILE = 0x0100
 CANVAS_FLAGS_PUSH_SCALE = 0x0040
+CANVAS_FLAGS_OIT = 0x0080
 CANVAS_FLAGS_VSYNC = 0x0010
 CAP_BUTT = 5
 CAP_COUNT = 6
@@ -1925,7 +1945,8 @@ PRINT_FLAGS_ALL = 0x0001
 PRINT_FLAGS_NONE = 0x0000
 PRINT_FLAGS_SMALL = 0x0003
 RECORDER_BEGIN = 1
-RECORDER_COUNT = 9
+RECORDER_COUNT = 11
+RECORDER_DISPATCH = 10
 RECORDER_DRAW = 2
 RECORDER_DRAW_INDEXED = 3
 RECORDER_DRAW_INDEXED_INDIRECT = 5
@@ -1933,12 +1954,14 @@ RECORDER_DRAW_INDIRECT = 4
 RECORDER_END = 8
 RECORDER_NONE = 0
 RECORDER_PUSH = 7
+RECORDER_TIMESTAMP = 9
 RECORDER_VIEWPORT = 6
 REF_FLAGS_EQUAL = 0x01
 REF_FLAGS_NONE = 0x00
 REQUEST_ACTION_BIND = 5
 REQUEST_ACTION_CREATE = 1
 REQUEST_ACTION_DELETE = 2
+REQUEST_ACTION_DISPATCH = 12
 REQUEST_ACTION_DOWNLOAD = 9
 REQUEST_ACTION_GET = 11
 REQUEST_ACTION_NONE = 0
@@ -2014,6 +2037,9 @@ SHAPE_TORUS = 10
 SLOT_COUNT = 2
 SLOT_DAT = 0
 SLOT_TEX = 1
+SPATIAL_MESH = 2
+SPATIAL_NONE = 0
+SPATIAL_POINTS = 1
 SPHERE_FLAGS_EQUAL_RECTANGULAR = 0x0008
 SPHERE_FLAGS_LIGHTING = 0x0002
 SPHERE_FLAGS_NONE = 0x0000
@@ -2023,7 +2049,9 @@ TEX_1D = 1
 TEX_2D = 2
 TEX_3D = 3
 TEX_FLAGS_NONE = 0x0000
+TEX_FLAGS_OCCUPANCY = 0x8000
 TEX_FLAGS_PERSISTENT_STAGING = 0x2000
+TEX_FLAGS_STREAMING = 0x4000
 TEX_NONE = 0
 UPLOAD_FLAGS_NOCOPY = 0x0800
 VERTEX_INPUT_RATE_INSTANCE = 1
@@ -2043,8 +2071,10 @@ VISUAL_FLAGS_FIXED_Z = 0x004000
 VISUAL_FLAGS_INDEXED = 0x010000
 VISUAL_FLAGS_INDEX_MAPPABLE = 0x800000
 VISUAL_FLAGS_INDIRECT = 0x020000
+VISUAL_FLAGS_SCALAR = 0x040000
 VISUAL_FLAGS_VERTEX_MAPPABLE = 0x400000
 VOLUME_FLAGS_BACK_FRONT = 0x0004
+VOLUME_FLAGS_BRICKED = 0x0008
 VOLUME_FLAGS_COLORMAP = 0x0002
 VOLUME_FLAGS_NONE = 0x0000
 VOLUME_FLAGS_RGBA = 0x0001
@@ -2074,6 +2104,10 @@ class DvzBox(ctypes.Structure):
     pass
 
 
+class DvzBricks(ctypes.Structure):
+    pass
+
+
 class DvzCamera(ctypes.Structure):
     pass
 
@@ -2166,6 +2200,10 @@ class DvzTexture(ctypes.Structure):
     pass
 
 
+class DvzTiles(ctypes.Structure):
+    pass
+
+
 class DvzTimerItem(ctypes.Structure):
     pass
 
@@ -2405,6 +2443,23 @@ class DvzRecorderDrawIndexedIndirect(ctypes.Structure):
     ]
 
 
+class DvzRecorderTimestamp(ctypes.Structure):
+    _pack_ = 8
+    _fields_ = [
+        ("id", DvzId),
+        ("end", ctypes.c_bool),
+    ]
+
+
+class DvzRecorderDispatch(ctypes.Structure):
+    _pack_ = 8
+    _fields_ = [
+        ("pipe_id", DvzId),
+        ("group_count", uvec3),
+        ("dat_indirect_id", DvzId),
+    ]
+
+
 class DvzRecorderUnion(ctypes.Union):
     _pack_ = 8
     _fields_ = [
@@ -2414,6 +2469,8 @@ class DvzRecorderUnion(ctypes.Union):
         ("draw_indexed", DvzRecorderDrawIndexed),
         ("draw_indirect", DvzRecorderDrawIndirect),
         ("draw_indexed_indirect", DvzRecorderDrawIndexedIndirect),
+        ("timestamp", DvzRecorderTimestamp),
+        ("dispatch", DvzRecorderDispatch),
     ]
 
 
@@ -2512,6 +2569,20 @@ class DvzRequestGraphics(ctypes.Structure):
     ]
 
 
+class DvzRequestCompute(ctypes.Structure):
+    _pack_ = 8
+    _fields_ = [
+        ("shader", DvzId),
+    ]
+
+
+class DvzRequestDispatch(ctypes.Structure):
+    _pack_ = 8
+    _fields_ = [
+        ("group_count", uvec3),
+    ]
+
+
 class DvzRequestPrimitive(ctypes.Structure):
     _pack_ = 8
     _fields_ = [
@@ -2668,6 +2739,8 @@ class DvzRequestContent(ctypes.Union):
         ("dat_upload", DvzRequestDatUpload),
         ("tex_upload", DvzRequestTexUpload),
         ("graphics", DvzRequestGraphics),
+        ("compute", DvzRequestCompute),
+        ("dispatch", DvzRequestDispatch),
         ("set_primitive", DvzRequestPrimitive),
         ("set_blend", DvzRequestBlend),
         ("set_mask", DvzRequestMask),
@@ -2762,6 +2835,8 @@ RequestShader = DvzRequestShader
 RequestDatUpload = DvzRequestDatUpload
 RequestTexUpload = DvzRequestTexUpload
 RequestGraphics = DvzRequestGraphics
+RequestCompute = DvzRequestCompute
+RequestDispatch = DvzRequestDispatch
 RequestPrimitive = DvzRequestPrimitive
 RequestBlend = DvzRequestBlend
 RequestMask = DvzRequestMask
@@ -2800,6 +2875,8 @@ on_frame = DvzAppFrameCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, P_(Dv
 on_timer = DvzAppTimerCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, P_(DvzTimerEvent))
 on_resize = DvzAppResizeCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, P_(DvzWindowEvent))
 DvzErrorCallback = ctypes.CFUNCTYPE(None, ctypes.c_char_p)
+DvzBricksCallback = ctypes.CFUNCTYPE(None, P_(DvzBricks), ctypes.c_uint32, P_(ctypes.c_uint32), P_(ctypes.c_uint32), ctypes.c_void_p, ctypes.c_void_p)
+DvzTilesCallback = ctypes.CFUNCTYPE(None, P_(DvzTiles), ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_void_p, ctypes.c_void_p)
 
 # ===============================================================================
 # FUNCTIONS
@@ -4282,6 +4359,33 @@ visual_clip.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+visual_colormap = dvz.dvz_visual_colormap
+visual_colormap.__doc__ = """
+Set the colormap and the value range of a visual created with `DVZ_VISUAL_FLAGS_SCALAR`.
+The scalar values are mapped to colors on the GPU, so changing the colormap or the range does
+not upload the values again. Supported by the basic, pixel, point, marker, path, and mesh
+visuals.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+cmap : DvzColormap
+    the colormap
+vmin : float
+    the value mapped to the first color of the colormap
+vmax : float
+    the value mapped to the last color of the colormap
+"""
+visual_colormap.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    DvzColormap,  # DvzColormap cmap
+    ctypes.c_float,  # float vmin
+    ctypes.c_float,  # float vmax
+]
+
+
 # -------------------------------------------------------------------------------------------------
 visual_depth = dvz.dvz_visual_depth
 visual_depth.__doc__ = """
@@ -4318,6 +4422,183 @@ visual_show.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+visual_pick_id = dvz.dvz_visual_pick_id
+visual_pick_id.__doc__ = """
+Return the id written by a visual into the pick attachment of the canvas.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual, created with DVZ_VISUAL_FLAGS_PICK
+
+Returns
+-------
+result : int
+     the pick id, or 0 if picking is disabled for this visual
+"""
+visual_pick_id.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+]
+visual_pick_id.restype = ctypes.c_uint32
+
+
+# -------------------------------------------------------------------------------------------------
+visual_spatial = dvz.dvz_visual_spatial
+visual_spatial.__doc__ = """
+Enable a CPU spatial index of the visual positions, for hover and selection queries.
+
+The index must be enabled before the positions (attribute #0) are set, it is then updated by
+dvz_visual_data() and dvz_visual_index().
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+type : DvzSpatialType
+    the index type, DVZ_SPATIAL_POINTS for points and markers, DVZ_SPATIAL_MESH for
+    meshes, DVZ_SPATIAL_NONE to disable it
+"""
+visual_spatial.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    DvzSpatialType,  # DvzSpatialType type
+]
+
+
+# -------------------------------------------------------------------------------------------------
+visual_nearest = dvz.dvz_visual_nearest
+visual_nearest.__doc__ = """
+Find the item closest to a position, using the visual spatial index.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+mvp : DvzMVP*
+    if not NULL, the position and distance are in NDC and the MVP must be a panzoom-like
+    transformation, otherwise they are in data coordinates
+pos : Tuple[float, float, float]
+    the position
+max_distance : float
+    the maximum distance, use INFINITY for no limit
+item : Out[int] (out parameter)
+    the closest item (point index, or triangle index for meshes)
+
+Returns
+-------
+result : bool
+     whether an item was found within the maximum distance
+"""
+visual_nearest.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.POINTER(DvzMVP),  # DvzMVP* mvp
+    vec3,  # vec3 pos
+    ctypes.c_float,  # float max_distance
+    Out,  # out uint32_t* item
+]
+visual_nearest.restype = ctypes.c_bool
+
+
+# -------------------------------------------------------------------------------------------------
+visual_select = dvz.dvz_visual_select
+visual_select.__doc__ = """
+Find the items within a box, using the visual spatial index.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+mvp : DvzMVP*
+    if not NULL, the box corners are in NDC and the z coordinate is ignored, otherwise
+    they are in data coordinates
+p0 : Tuple[float, float, float]
+    one corner of the box
+p1 : Tuple[float, float, float]
+    the opposite corner of the box
+max_count : int
+    the maximum number of items to write
+items : Out[int] (out parameter)
+    (array) the selected items, may be NULL if max_count is 0
+
+Returns
+-------
+result : int
+     the total number of items within the box, possibly larger than max_count
+"""
+visual_select.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.POINTER(DvzMVP),  # DvzMVP* mvp
+    vec3,  # vec3 p0
+    vec3,  # vec3 p1
+    ctypes.c_uint32,  # uint32_t max_count
+    ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # out uint32_t* items
+]
+visual_select.restype = ctypes.c_uint32
+
+
+# -------------------------------------------------------------------------------------------------
+visual_culling = dvz.dvz_visual_culling
+visual_culling.__doc__ = """
+Enable GPU-driven culling of the items of a point-like visual (marker, sphere, glyph).
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+enabled : bool
+    whether to enable or disable the culling
+margin : float
+    the margin around the viewport, in pixels, for items that extend beyond their position (for example, glyphs)
+min_size : float
+    the items smaller than this size in pixels are culled (markers, and spheres created with DVZ_SPHERE_FLAGS_SIZE_PIXELS), 0 to disable
+"""
+visual_culling.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_bool,  # bool enabled
+    ctypes.c_float,  # float margin
+    ctypes.c_float,  # float min_size
+]
+
+
+# -------------------------------------------------------------------------------------------------
+visual_bounds = dvz.dvz_visual_bounds
+visual_bounds.__doc__ = """
+Enable CPU culling of a whole visual with its bounding box.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+enabled : bool
+    whether to enable or disable the culling
+margin : float
+    the margin around the bounding box, in pixels, for items that extend beyond their position (marker size, line width...)
+"""
+visual_bounds.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_bool,  # bool enabled
+    ctypes.c_float,  # float margin
+]
+
+
+# -------------------------------------------------------------------------------------------------
+visual_box = dvz.dvz_visual_box
+visual_box.__doc__ = """
+Set the bounding box of a visual used by the CPU culling.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+box : DvzBox*
+    the bounding box, in the coordinate system of the positions, or NULL to compute it from the positions again
+"""
+visual_box.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.POINTER(DvzBox),  # DvzBox* box
+]
+
+
 # -------------------------------------------------------------------------------------------------
 visual_primitive = dvz.dvz_visual_primitive
 visual_primitive.__doc__ = """
@@ -4983,6 +5264,34 @@ texture_data.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+texture_stream = dvz.dvz_texture_stream
+texture_stream.__doc__ = """
+Upload a new frame of a 2D texture, only sending the regions that changed since the last frame.
+The texture keeps a copy of the last frame and compares it with the new frame per block of
+pixels. The changed blocks are grouped in rectangles which are uploaded separately. For live
+images (video, cameras), create the texture with the `DVZ_TEX_FLAGS_STREAMING` flag so that
+the uploads do not wait for the GPU.
+
+Parameters
+----------
+texture : DvzTexture*
+    the texture
+data : np.ndarray
+    the full frame, with the size of the texture
+
+Returns
+-------
+result : DvzSize
+     the number of bytes uploaded
+"""
+texture_stream.argtypes = [
+    ctypes.POINTER(DvzTexture),  # DvzTexture* texture
+    ndpointer(dtype=None, ndim=None, flags="C_CONTIGUOUS"),  # void* data
+]
+texture_stream.restype = DvzSize
+
+
 # -------------------------------------------------------------------------------------------------
 texture_create = dvz.dvz_texture_create
 texture_create.__doc__ = """
@@ -5140,103 +5449,365 @@ texture_3D.restype = ctypes.POINTER(DvzTexture)
 
 
 # -------------------------------------------------------------------------------------------------
-colormap = dvz.dvz_colormap
-colormap.__doc__ = """
-Fetch a color from a colormap and a value (either 8-bit or float, depending on DVZ_COLOR_CVEC4).
+bricks = dvz.dvz_bricks
+bricks.__doc__ = """
+Create a bricked volume, streamed to the GPU on demand.
+The volume is split into bricks at multiple resolutions. Only the bricks needed for the current
+point of view are loaded, in a background thread, and stored in a fixed-size pool of bricks on
+the GPU, which allows for displaying volumes larger than the GPU memory.
 
 Parameters
 ----------
-cmap : DvzColormap
-    the colormap
-value : uint8_t
-    the value
-color : Out[Tuple[int, int, int, int]] (out parameter)
-    the fetched color
+batch : DvzBatch*
+    the batch
+format : DvzFormat
+    the format of the voxels
+shape : Tuple[int, int, int]
+    the shape of the volume (width, height, depth), in voxels
+brick_size : int
+    the size of the bricks, in voxels (0 for the default, 32)
+capacity : int
+    the maximum number of bricks stored on the GPU
+flags : int
+    the flags
+
+Returns
+-------
+result : DvzBricks*
+     the bricks
 """
-colormap.argtypes = [
-    DvzColormap,  # DvzColormap cmap
-    ctypes.c_uint8,  # uint8_t value
-    DvzColor,  # out DvzColor color
+bricks.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    DvzFormat,  # DvzFormat format
+    uvec3,  # uvec3 shape
+    ctypes.c_uint32,  # uint32_t brick_size
+    ctypes.c_uint32,  # uint32_t capacity
+    ctypes.c_int,  # int flags
 ]
+bricks.restype = ctypes.POINTER(DvzBricks)
 
 
 # -------------------------------------------------------------------------------------------------
-colormap_8bit = dvz.dvz_colormap_8bit
-colormap_8bit.__doc__ = """
-Fetch a color from a colormap and a value (8-bit version).
+bricks_callback = dvz.dvz_bricks_callback
+bricks_callback.__doc__ = """
+Set the callback function used to load the bricks.
+The callback is called from a background thread. It must fill `out` with the voxels of the
+region `offset`, `shape` of the volume at the given level, subsampled by a factor 2^level, with
+the x axis varying fastest.
 
 Parameters
 ----------
-cmap : DvzColormap
-    the colormap
-value : uint8_t
-    the value
-color : Out[cvec4] (out parameter)
-    the fetched color
+bricks : DvzBricks*
+    the bricks
+callback : DvzBricksCallback
+    the callback
+user_data : np.ndarray
+    the user data passed to the callback
 """
-colormap_8bit.argtypes = [
-    DvzColormap,  # DvzColormap cmap
-    ctypes.c_uint8,  # uint8_t value
-    cvec4,  # out cvec4 color
+bricks_callback.argtypes = [
+    ctypes.POINTER(DvzBricks),  # DvzBricks* bricks
+    DvzBricksCallback,  # DvzBricksCallback callback
+    ctypes.c_void_p,  # void* user_data
 ]
 
 
 # -------------------------------------------------------------------------------------------------
-colormap_scale = dvz.dvz_colormap_scale
-colormap_scale.__doc__ = """
-Fetch a color from a colormap and an interpolated value.
+bricks_file = dvz.dvz_bricks_file
+bricks_file.__doc__ = """
+Load the bricks from a raw binary file mapped in memory.
+The file contains the full-resolution volume with the x axis varying fastest. Lower
+resolution bricks are obtained by subsampling.
 
 Parameters
 ----------
-cmap : DvzColormap
-    the colormap
-value : float
-    the value
-vmin : float
-    the minimum value
-vmax : float
-    the maximum value
-color : Out[Tuple[int, int, int, int]] (out parameter)
-    the fetched color
+bricks : DvzBricks*
+    the bricks
+filename : str
+    the path to the file
+offset : DvzSize
+    the offset of the first voxel in the file, in bytes
 """
-colormap_scale.argtypes = [
-    DvzColormap,  # DvzColormap cmap
-    ctypes.c_float,  # float value
-    ctypes.c_float,  # float vmin
-    ctypes.c_float,  # float vmax
-    DvzColor,  # out DvzColor color
+bricks_file.argtypes = [
+    ctypes.POINTER(DvzBricks),  # DvzBricks* bricks
+    CStringBuffer,  # char* filename
+    DvzSize,  # DvzSize offset
 ]
 
 
 # -------------------------------------------------------------------------------------------------
-colormap_array = dvz.dvz_colormap_array
-colormap_array.__doc__ = """
-Fetch colors from a colormap and an array of values.
+bricks_update = dvz.dvz_bricks_update
+bricks_update.__doc__ = """
+Update the bricks for a given point of view.
+This function should be called at every frame. It selects the level of detail of each region
+of the volume, requests the missing bricks to the loader thread, and uploads the bricks that
+have been loaded since the last call.
 
 Parameters
 ----------
-cmap : DvzColormap
-    the colormap
-count : int
-    the number of values
-values : np.ndarray[float]
-    pointer to the array of float numbers
-vmin : float
-    the minimum value
-vmax : float
-    the maximum value
-out : Out[Tuple[int, int, int, int]] (out parameter)
-    (array) the fetched colors
-"""
-colormap_array.argtypes = [
-    DvzColormap,  # DvzColormap cmap
-    ctypes.c_uint32,  # uint32_t count
-    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
-    ctypes.c_float,  # float vmin
-    ctypes.c_float,  # float vmax
-    ndpointer(dtype=np.uint8, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # out DvzColor* out
-]
-
+bricks : DvzBricks*
+    the bricks
+eye : Tuple[float, float, float]
+    the position of the camera, in normalized volume coordinates (between 0 and 1)
+detail : float
+    the distance, in bricks, below which a brick is refined (2 is a good default)
+
+Returns
+-------
+result : uint32_t
+     the number of bricks that are still being loaded
+"""
+bricks_update.argtypes = [
+    ctypes.POINTER(DvzBricks),  # DvzBricks* bricks
+    vec3,  # vec3 eye
+    ctypes.c_float,  # float detail
+]
+bricks_update.restype = ctypes.c_uint32
+
+
+# -------------------------------------------------------------------------------------------------
+bricks_destroy = dvz.dvz_bricks_destroy
+bricks_destroy.__doc__ = """
+Destroy the bricks.
+
+Parameters
+----------
+bricks : DvzBricks*
+    the bricks
+"""
+bricks_destroy.argtypes = [
+    ctypes.POINTER(DvzBricks),  # DvzBricks* bricks
+]
+
+
+# -------------------------------------------------------------------------------------------------
+tiles = dvz.dvz_tiles
+tiles.__doc__ = """
+Create a tiled multiresolution image, streamed to the GPU on demand.
+The image is split into square tiles at multiple resolutions (an image pyramid). Only the tiles
+visible in the current view, at the resolution matching the zoom level, are loaded in a
+background thread and stored in a fixed-size tile cache on the GPU, which allows for displaying
+gigapixel images.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+format : DvzFormat
+    the format of the pixels
+width : int
+    the width of the image at full resolution, in pixels
+height : int
+    the height of the image at full resolution, in pixels
+tile_size : int
+    the size of the tiles, in pixels (0 for the default, 256)
+capacity : int
+    the maximum number of tiles stored on the GPU
+flags : int
+    the flags
+
+Returns
+-------
+result : DvzTiles*
+     the tiles
+"""
+tiles.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    DvzFormat,  # DvzFormat format
+    ctypes.c_uint32,  # uint32_t width
+    ctypes.c_uint32,  # uint32_t height
+    ctypes.c_uint32,  # uint32_t tile_size
+    ctypes.c_uint32,  # uint32_t capacity
+    ctypes.c_int,  # int flags
+]
+tiles.restype = ctypes.POINTER(DvzTiles)
+
+
+# -------------------------------------------------------------------------------------------------
+tiles_callback = dvz.dvz_tiles_callback
+tiles_callback.__doc__ = """
+Set the callback function used to load the tiles.
+The callback is called from a background thread. It must fill `out` with the T x T pixels of
+the tile (x, y) of the image downsampled by a factor 2^level, with the first row at the top and
+the x axis varying fastest. Pixels beyond the border of the image are ignored.
+
+Parameters
+----------
+tiles : DvzTiles*
+    the tiles
+callback : DvzTilesCallback
+    the callback
+user_data : np.ndarray
+    the user data passed to the callback
+"""
+tiles_callback.argtypes = [
+    ctypes.POINTER(DvzTiles),  # DvzTiles* tiles
+    DvzTilesCallback,  # DvzTilesCallback callback
+    ctypes.c_void_p,  # void* user_data
+]
+
+
+# -------------------------------------------------------------------------------------------------
+tiles_bounds = dvz.dvz_tiles_bounds
+tiles_bounds.__doc__ = """
+Set the position of the image, in normalized device coordinates.
+
+Parameters
+----------
+tiles : DvzTiles*
+    the tiles
+xlim : Tuple[float, float]
+    the left and right coordinates of the image (-1, +1 by default)
+ylim : Tuple[float, float]
+    the bottom and top coordinates of the image (-1, +1 by default)
+"""
+tiles_bounds.argtypes = [
+    ctypes.POINTER(DvzTiles),  # DvzTiles* tiles
+    vec2,  # vec2 xlim
+    vec2,  # vec2 ylim
+]
+
+
+# -------------------------------------------------------------------------------------------------
+tiles_update = dvz.dvz_tiles_update
+tiles_update.__doc__ = """
+Update the tiles for the current view of a panzoom.
+This function should be called at every frame. It selects the level of the pyramid matching
+the zoom level and the tiles visible in the view, requests the missing tiles to the loader
+thread, and uploads the tiles that have been loaded since the last call. The lower resolution
+tiles already loaded are displayed until the higher resolution tiles arrive.
+
+Parameters
+----------
+tiles : DvzTiles*
+    the tiles
+pz : DvzPanzoom*
+    the panzoom
+
+Returns
+-------
+result : uint32_t
+     the number of tiles that are still being loaded
+"""
+tiles_update.argtypes = [
+    ctypes.POINTER(DvzTiles),  # DvzTiles* tiles
+    ctypes.POINTER(DvzPanzoom),  # DvzPanzoom* pz
+]
+tiles_update.restype = ctypes.c_uint32
+
+
+# -------------------------------------------------------------------------------------------------
+tiles_destroy = dvz.dvz_tiles_destroy
+tiles_destroy.__doc__ = """
+Destroy the tiles.
+
+Parameters
+----------
+tiles : DvzTiles*
+    the tiles
+"""
+tiles_destroy.argtypes = [
+    ctypes.POINTER(DvzTiles),  # DvzTiles* tiles
+]
+
+
+# -------------------------------------------------------------------------------------------------
+colormap = dvz.dvz_colormap
+colormap.__doc__ = """
+Fetch a color from a colormap and a value (either 8-bit or float, depending on DVZ_COLOR_CVEC4).
+
+Parameters
+----------
+cmap : DvzColormap
+    the colormap
+value : uint8_t
+    the value
+color : Out[Tuple[int, int, int, int]] (out parameter)
+    the fetched color
+"""
+colormap.argtypes = [
+    DvzColormap,  # DvzColormap cmap
+    ctypes.c_uint8,  # uint8_t value
+    DvzColor,  # out DvzColor color
+]
+
+
+# -------------------------------------------------------------------------------------------------
+colormap_8bit = dvz.dvz_colormap_8bit
+colormap_8bit.__doc__ = """
+Fetch a color from a colormap and a value (8-bit version).
+
+Parameters
+----------
+cmap : DvzColormap
+    the colormap
+value : uint8_t
+    the value
+color : Out[cvec4] (out parameter)
+    the fetched color
+"""
+colormap_8bit.argtypes = [
+    DvzColormap,  # DvzColormap cmap
+    ctypes.c_uint8,  # uint8_t value
+    cvec4,  # out cvec4 color
+]
+
+
+# -------------------------------------------------------------------------------------------------
+colormap_scale = dvz.dvz_colormap_scale
+colormap_scale.__doc__ = """
+Fetch a color from a colormap and an interpolated value.
+
+Parameters
+----------
+cmap : DvzColormap
+    the colormap
+value : float
+    the value
+vmin : float
+    the minimum value
+vmax : float
+    the maximum value
+color : Out[Tuple[int, int, int, int]] (out parameter)
+    the fetched color
+"""
+colormap_scale.argtypes = [
+    DvzColormap,  # DvzColormap cmap
+    ctypes.c_float,  # float value
+    ctypes.c_float,  # float vmin
+    ctypes.c_float,  # float vmax
+    DvzColor,  # out DvzColor color
+]
+
+
+# -------------------------------------------------------------------------------------------------
+colormap_array = dvz.dvz_colormap_array
+colormap_array.__doc__ = """
+Fetch colors from a colormap and an array of values.
+
+Parameters
+----------
+cmap : DvzColormap
+    the colormap
+count : int
+    the number of values
+values : np.ndarray[float]
+    pointer to the array of float numbers
+vmin : float
+    the minimum value
+vmax : float
+    the maximum value
+out : Out[Tuple[int, int, int, int]] (out parameter)
+    (array) the fetched colors
+"""
+colormap_array.argtypes = [
+    DvzColormap,  # DvzColormap cmap
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+    ctypes.c_float,  # float vmin
+    ctypes.c_float,  # float vmax
+    ndpointer(dtype=np.uint8, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # out DvzColor* out
+]
+
 
 # -------------------------------------------------------------------------------------------------
 sdf_from_svg = dvz.dvz_sdf_from_svg
@@ -8765,6 +9336,39 @@ app_timestamps.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+app_gpu_times = dvz.dvz_app_gpu_times
+app_gpu_times.__doc__ = """
+Return the GPU durations of the views and visual draws of a canvas, a few frames behind.
+
+Parameters
+----------
+app : DvzApp*
+    the app
+canvas_id : DvzId
+    the ID of the canvas
+count : int
+    the size of the output arrays
+ids : Out[int] (out parameter)
+    (array) a buffer holding at least `count` DvzId values
+nanoseconds : Out[int] (out parameter)
+    (array) a buffer holding at least `count` uint64_t values
+
+Returns
+-------
+result : int
+     the number of spans written in the output arrays
+"""
+app_gpu_times.argtypes = [
+    ctypes.POINTER(DvzApp),  # DvzApp* app
+    DvzId,  # DvzId canvas_id
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.uint64, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # out DvzId* ids
+    ndpointer(dtype=np.uint64, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # out uint64_t* nanoseconds
+]
+app_gpu_times.restype = ctypes.c_uint32
+
+
 # -------------------------------------------------------------------------------------------------
 app_wait = dvz.dvz_app_wait
 app_wait.__doc__ = """
@@ -8904,71 +9508,241 @@ free.argtypes = [
 
 
 # -------------------------------------------------------------------------------------------------
-external_vertex = dvz.dvz_external_vertex
-external_vertex.__doc__ = """
-Get an external memory handle of a vertex dat.
+trace_start = dvz.dvz_trace_start
+trace_start.__doc__ = """
+Start recording trace events.
+"""
+trace_start.argtypes = [
+]
 
-Parameters
-----------
-rd : DvzRenderer*
-    the renderer
-visual : DvzVisual*
-    the visual
-binding_idx : int
-    the binding index of the dat that is being used as vertex buffer
-offset : Out[DvzSize] (out parameter)
-    the offset, in bytes, of the dat, within the buffer containing that dat
 
-Returns
--------
-result : int
-     the external memory handle of that buffer
+# -------------------------------------------------------------------------------------------------
+trace_stop = dvz.dvz_trace_stop
+trace_stop.__doc__ = """
+Stop recording trace events. The recorded events are kept until dvz_trace_clear().
 """
-external_vertex.argtypes = [
-    ctypes.POINTER(DvzRenderer),  # DvzRenderer* rd
-    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
-    ctypes.c_uint32,  # uint32_t binding_idx
-    Out,  # out DvzSize* offset
+trace_stop.argtypes = [
 ]
-external_vertex.restype = ctypes.c_int
 
 
 # -------------------------------------------------------------------------------------------------
-external_index = dvz.dvz_external_index
-external_index.__doc__ = """
-Get an external memory handle of an index dat.
-
-Parameters
-----------
-rd : DvzRenderer*
-    the renderer
-visual : DvzVisual*
-    the visual
-offset : Out[DvzSize] (out parameter)
-    the offset, in bytes, of the dat, within the buffer containing that dat
+trace_enabled = dvz.dvz_trace_enabled
+trace_enabled.__doc__ = """
+Return whether trace events are being recorded.
 
 Returns
 -------
-result : int
-     the external memory handle of that buffer
+result : bool
+     whether tracing is enabled
 """
-external_index.argtypes = [
-    ctypes.POINTER(DvzRenderer),  # DvzRenderer* rd
-    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
-    Out,  # out DvzSize* offset
+trace_enabled.argtypes = [
 ]
-external_index.restype = ctypes.c_int
+trace_enabled.restype = ctypes.c_bool
 
 
 # -------------------------------------------------------------------------------------------------
-external_dat = dvz.dvz_external_dat
-external_dat.__doc__ = """
-Get an external memory handle of a dat.
+trace_thread = dvz.dvz_trace_thread
+trace_thread.__doc__ = """
+Name the calling thread in the trace.
 
 Parameters
 ----------
-rd : DvzRenderer*
-    the renderer
+name : str
+    the thread name, with a static lifetime
+"""
+trace_thread.argtypes = [
+    CStringBuffer,  # const char* name
+]
+
+
+# -------------------------------------------------------------------------------------------------
+trace_begin = dvz.dvz_trace_begin
+trace_begin.__doc__ = """
+Begin a span on the calling thread.
+
+Parameters
+----------
+cat : str
+    the category
+name : str
+    the span name
+"""
+trace_begin.argtypes = [
+    CStringBuffer,  # const char* cat
+    CStringBuffer,  # const char* name
+]
+
+
+# -------------------------------------------------------------------------------------------------
+trace_begin_args = dvz.dvz_trace_begin_args
+trace_begin_args.__doc__ = """
+Begin a span on the calling thread, with two integer arguments.
+
+Parameters
+----------
+cat : str
+    the category
+name : str
+    the span name
+key0 : str
+    the name of the first argument
+val0 : int
+    the value of the first argument
+key1 : str
+    the name of the second argument, or NULL
+val1 : int
+    the value of the second argument
+"""
+trace_begin_args.argtypes = [
+    CStringBuffer,  # const char* cat
+    CStringBuffer,  # const char* name
+    CStringBuffer,  # const char* key0
+    ctypes.c_int64,  # int64_t val0
+    CStringBuffer,  # const char* key1
+    ctypes.c_int64,  # int64_t val1
+]
+
+
+# -------------------------------------------------------------------------------------------------
+trace_end = dvz.dvz_trace_end
+trace_end.__doc__ = """
+End the last span begun on the calling thread.
+"""
+trace_end.argtypes = [
+]
+
+
+# -------------------------------------------------------------------------------------------------
+trace_instant = dvz.dvz_trace_instant
+trace_instant.__doc__ = """
+Record an instant event on the calling thread.
+
+Parameters
+----------
+cat : str
+    the category
+name : str
+    the event name
+"""
+trace_instant.argtypes = [
+    CStringBuffer,  # const char* cat
+    CStringBuffer,  # const char* name
+]
+
+
+# -------------------------------------------------------------------------------------------------
+trace_count = dvz.dvz_trace_count
+trace_count.__doc__ = """
+Return the number of recorded events, across all threads.
+
+Returns
+-------
+result : int
+     the number of events
+"""
+trace_count.argtypes = [
+]
+trace_count.restype = ctypes.c_uint64
+
+
+# -------------------------------------------------------------------------------------------------
+trace_write = dvz.dvz_trace_write
+trace_write.__doc__ = """
+Write the recorded events to a Chrome trace-event JSON file.
+
+Parameters
+----------
+path : str
+    the file path
+
+Returns
+-------
+result : int
+     0 if the file was successfully written
+"""
+trace_write.argtypes = [
+    CStringBuffer,  # const char* path
+]
+trace_write.restype = ctypes.c_int
+
+
+# -------------------------------------------------------------------------------------------------
+trace_clear = dvz.dvz_trace_clear
+trace_clear.__doc__ = """
+Discard all recorded events.
+
+This function must be called when tracing is stopped and no other thread records events.
+"""
+trace_clear.argtypes = [
+]
+
+
+# -------------------------------------------------------------------------------------------------
+external_vertex = dvz.dvz_external_vertex
+external_vertex.__doc__ = """
+Get an external memory handle of a vertex dat.
+
+Parameters
+----------
+rd : DvzRenderer*
+    the renderer
+visual : DvzVisual*
+    the visual
+binding_idx : int
+    the binding index of the dat that is being used as vertex buffer
+offset : Out[DvzSize] (out parameter)
+    the offset, in bytes, of the dat, within the buffer containing that dat
+
+Returns
+-------
+result : int
+     the external memory handle of that buffer
+"""
+external_vertex.argtypes = [
+    ctypes.POINTER(DvzRenderer),  # DvzRenderer* rd
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t binding_idx
+    Out,  # out DvzSize* offset
+]
+external_vertex.restype = ctypes.c_int
+
+
+# -------------------------------------------------------------------------------------------------
+external_index = dvz.dvz_external_index
+external_index.__doc__ = """
+Get an external memory handle of an index dat.
+
+Parameters
+----------
+rd : DvzRenderer*
+    the renderer
+visual : DvzVisual*
+    the visual
+offset : Out[DvzSize] (out parameter)
+    the offset, in bytes, of the dat, within the buffer containing that dat
+
+Returns
+-------
+result : int
+     the external memory handle of that buffer
+"""
+external_index.argtypes = [
+    ctypes.POINTER(DvzRenderer),  # DvzRenderer* rd
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    Out,  # out DvzSize* offset
+]
+external_index.restype = ctypes.c_int
+
+
+# -------------------------------------------------------------------------------------------------
+external_dat = dvz.dvz_external_dat
+external_dat.__doc__ = """
+Get an external memory handle of a dat.
+
+Parameters
+----------
+rd : DvzRenderer*
+    the renderer
 visual : DvzVisual*
     the visual
 slot_idx : int
@@ -11387,6 +12161,32 @@ create_spirv.argtypes = [
 create_spirv.restype = DvzRequest
 
 
+# -------------------------------------------------------------------------------------------------
+delete_shader = dvz.dvz_delete_shader
+delete_shader.__doc__ = """
+Create a request for shader deletion.
+
+The shader must not be used by any graphics or compute pipe that has not been deleted.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+id : DvzId
+    the shader id
+
+Returns
+-------
+result : DvzRequest
+     the request
+"""
+delete_shader.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    DvzId,  # DvzId id
+]
+delete_shader.restype = DvzRequest
+
+
 # -------------------------------------------------------------------------------------------------
 create_graphics = dvz.dvz_create_graphics
 create_graphics.__doc__ = """
@@ -11822,6 +12622,84 @@ delete_graphics.argtypes = [
 delete_graphics.restype = DvzRequest
 
 
+# -------------------------------------------------------------------------------------------------
+create_compute = dvz.dvz_create_compute
+create_compute.__doc__ = """
+Create a request for a compute pipe creation.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+shader : DvzId
+    the id of the compute shader
+flags : int
+    the compute creation flags
+
+Returns
+-------
+result : DvzRequest
+     the request, containing a newly-generated id for the compute pipe to be created
+"""
+create_compute.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    DvzId,  # DvzId shader
+    ctypes.c_int,  # int flags
+]
+create_compute.restype = DvzRequest
+
+
+# -------------------------------------------------------------------------------------------------
+dispatch_compute = dvz.dvz_dispatch_compute
+dispatch_compute.__doc__ = """
+Create a request for dispatching a compute pipe.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+compute : DvzId
+    the id of the compute pipe
+group_count : uvec3
+    the number of workgroups along the three dimensions
+
+Returns
+-------
+result : DvzRequest
+     the request
+"""
+dispatch_compute.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    DvzId,  # DvzId compute
+    uvec3,  # uvec3 group_count
+]
+dispatch_compute.restype = DvzRequest
+
+
+# -------------------------------------------------------------------------------------------------
+delete_compute = dvz.dvz_delete_compute
+delete_compute.__doc__ = """
+Create a request for compute deletion.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+id : DvzId
+    the compute id
+
+Returns
+-------
+result : DvzRequest
+     the request
+"""
+delete_compute.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    DvzId,  # DvzId id
+]
+delete_compute.restype = DvzRequest
+
+
 # -------------------------------------------------------------------------------------------------
 bind_vertex = dvz.dvz_bind_vertex
 bind_vertex.__doc__ = """
@@ -12194,6 +13072,69 @@ record_push.argtypes = [
 record_push.restype = DvzRequest
 
 
+# -------------------------------------------------------------------------------------------------
+record_timestamp = dvz.dvz_record_timestamp
+record_timestamp.__doc__ = """
+Create a request for writing a GPU timestamp while recording a command buffer.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+canvas_id : DvzId
+    the id of the canvas
+id : DvzId
+    the span id, for example the id of a graphics pipeline
+end : bool
+    whether the timestamp ends the span, or begins it
+
+Returns
+-------
+result : DvzRequest
+     the request
+"""
+record_timestamp.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    DvzId,  # DvzId canvas_id
+    DvzId,  # DvzId id
+    ctypes.c_bool,  # bool end
+]
+record_timestamp.restype = DvzRequest
+
+
+# -------------------------------------------------------------------------------------------------
+record_dispatch = dvz.dvz_record_dispatch
+record_dispatch.__doc__ = """
+Create a request for a compute dispatch while recording a command buffer.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+canvas_id : DvzId
+    the id of the canvas
+compute : DvzId
+    the id of the compute pipe
+group_count : uvec3
+    the number of workgroups in each dimension
+indirect : DvzId
+    the id of the indirect dat written by the kernel, or 0
+
+Returns
+-------
+result : DvzRequest
+     the request
+"""
+record_dispatch.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    DvzId,  # DvzId canvas_id
+    DvzId,  # DvzId compute
+    uvec3,  # uvec3 group_count
+    DvzId,  # DvzId indirect
+]
+record_dispatch.restype = DvzRequest
+
+
 # -------------------------------------------------------------------------------------------------
 record_end = dvz.dvz_record_end
 record_end.__doc__ = """
@@ -12299,6 +13240,35 @@ basic_color.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+basic_scalar = dvz.dvz_basic_scalar
+basic_scalar.__doc__ = """
+Set the vertex scalar values, mapped to colors on the GPU.
+The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+range are set with `dvz_visual_colormap()`.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : int
+    the index of the first item to update
+count : int
+    the number of items to update
+values : np.ndarray[float]
+    the scalar values of the items to update
+flags : int
+    the data update flags
+"""
+basic_scalar.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+    ctypes.c_int,  # int flags
+]
+
+
 # -------------------------------------------------------------------------------------------------
 basic_group = dvz.dvz_basic_group
 basic_group.__doc__ = """
@@ -12467,6 +13437,35 @@ pixel_color.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+pixel_scalar = dvz.dvz_pixel_scalar
+pixel_scalar.__doc__ = """
+Set the pixel scalar values, mapped to colors on the GPU.
+The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+range are set with `dvz_visual_colormap()`.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : int
+    the index of the first item to update
+count : int
+    the number of items to update
+values : np.ndarray[float]
+    the scalar values of the items to update
+flags : int
+    the data update flags
+"""
+pixel_scalar.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+    ctypes.c_int,  # int flags
+]
+
+
 # -------------------------------------------------------------------------------------------------
 pixel_size = dvz.dvz_pixel_size
 pixel_size.__doc__ = """
@@ -12608,6 +13607,35 @@ point_color.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+point_scalar = dvz.dvz_point_scalar
+point_scalar.__doc__ = """
+Set the point scalar values, mapped to colors on the GPU.
+The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+range are set with `dvz_visual_colormap()`.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : int
+    the index of the first item to update
+count : int
+    the number of items to update
+values : np.ndarray[float]
+    the scalar values of the items to update
+flags : int
+    the data update flags
+"""
+point_scalar.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+    ctypes.c_int,  # int flags
+]
+
+
 # -------------------------------------------------------------------------------------------------
 point_alloc = dvz.dvz_point_alloc
 point_alloc.__doc__ = """
@@ -12812,6 +13840,35 @@ marker_color.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+marker_scalar = dvz.dvz_marker_scalar
+marker_scalar.__doc__ = """
+Set the marker scalar values, mapped to colors on the GPU.
+The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+range are set with `dvz_visual_colormap()`.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : int
+    the index of the first item to update
+count : int
+    the number of items to update
+values : np.ndarray[float]
+    the scalar values of the items to update
+flags : int
+    the data update flags
+"""
+marker_scalar.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+    ctypes.c_int,  # int flags
+]
+
+
 # -------------------------------------------------------------------------------------------------
 marker_edgecolor = dvz.dvz_marker_edgecolor
 marker_edgecolor.__doc__ = """
@@ -13160,6 +14217,35 @@ path_color.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+path_scalar = dvz.dvz_path_scalar
+path_scalar.__doc__ = """
+Set the path scalar values, mapped to colors on the GPU.
+The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+range are set with `dvz_visual_colormap()`.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : int
+    the index of the first item to update
+count : int
+    the number of items to update
+values : np.ndarray[float]
+    the scalar values of the items to update
+flags : int
+    the data update flags
+"""
+path_scalar.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+    ctypes.c_int,  # int flags
+]
+
+
 # -------------------------------------------------------------------------------------------------
 path_linewidth = dvz.dvz_path_linewidth
 path_linewidth.__doc__ = """
@@ -14116,6 +15202,27 @@ image_texture.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+image_tiles = dvz.dvz_image_tiles
+image_tiles.__doc__ = """
+Display a tiled multiresolution image in an image visual.
+The visual must have been created with the `DVZ_IMAGE_FLAGS_SIZE_NDC` and
+`DVZ_IMAGE_FLAGS_RESCALE` flags. Each item of the visual is a tile, and the items are updated
+by `dvz_tiles_update()`.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+tiles : DvzTiles*
+    the tiles
+"""
+image_tiles.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.POINTER(DvzTiles),  # DvzTiles* tiles
+]
+
+
 # -------------------------------------------------------------------------------------------------
 image_edgecolor = dvz.dvz_image_edgecolor
 image_edgecolor.__doc__ = """
@@ -14457,6 +15564,35 @@ mesh_color.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+mesh_scalar = dvz.dvz_mesh_scalar
+mesh_scalar.__doc__ = """
+Set the mesh scalar values, mapped to colors on the GPU.
+The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+range are set with `dvz_visual_colormap()`.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : int
+    the index of the first item to update
+count : int
+    the number of items to update
+values : np.ndarray[float]
+    the scalar values of the items to update
+flags : int
+    the data update flags
+"""
+mesh_scalar.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+    ctypes.c_int,  # int flags
+]
+
+
 # -------------------------------------------------------------------------------------------------
 mesh_texcoords = dvz.dvz_mesh_texcoords
 mesh_texcoords.__doc__ = """
@@ -15155,6 +16291,9 @@ volume_texture = dvz.dvz_volume_texture
 volume_texture.__doc__ = """
 Assign a 3D texture to a volume visual.
 
+Create the texture with DVZ_TEX_FLAGS_OCCUPANCY so that the empty bricks of its initial data
+are skipped during ray marching.
+
 Parameters
 ----------
 visual : DvzVisual*
@@ -15267,6 +16406,64 @@ volume_transfer.argtypes = [
 ]
 
 
+# -------------------------------------------------------------------------------------------------
+volume_step = dvz.dvz_volume_step
+volume_step.__doc__ = """
+Set the ray marching step size, as a fraction of the voxel size of the volume texture.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+step : float
+    the step size in voxels (1 by default)
+"""
+volume_step.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_float,  # float step
+]
+
+
+# -------------------------------------------------------------------------------------------------
+volume_threshold = dvz.dvz_volume_threshold
+volume_threshold.__doc__ = """
+Set the ray marching thresholds.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+termination : float
+    the accumulated alpha above which a ray stops (0.99 by default)
+empty : float
+    the maximum alpha of the bricks of voxels skipped by the rays (0 by default)
+"""
+volume_threshold.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_float,  # float termination
+    ctypes.c_float,  # float empty
+]
+
+
+# -------------------------------------------------------------------------------------------------
+volume_bricks = dvz.dvz_volume_bricks
+volume_bricks.__doc__ = """
+Assign a bricked volume to a volume visual.
+The visual must have been created with the `DVZ_VOLUME_FLAGS_BRICKED` flag.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+bricks : DvzBricks*
+    the bricked volume
+"""
+volume_bricks.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.POINTER(DvzBricks),  # DvzBricks* bricks
+]
+
+
 # -------------------------------------------------------------------------------------------------
 slice = dvz.dvz_slice
 slice.__doc__ = """
@@ -2199,6 +2199,30 @@ class Volume(Visual):
         """
         self.transfer = value
 
+    def set_step(self, value: float) -> None:
+        """
+        Set the ray marching step size, in voxels.
+
+        Parameters
+        ----------
+        value : float
+            The step size as a fraction of the voxel size, 1 by default.
+        """
+        dvz.volume_step(self.c_visual, value)
+
+    def set_threshold(self, termination: float = 0.99, empty: float = 0.0) -> None:
+        """
+        Set the ray marching thresholds.
+
+        Parameters
+        ----------
+        termination : float
+            The accumulated alpha above which a ray stops.
+        empty : float
+            The maximum alpha of the bricks of voxels skipped by the rays.
+        """
+        dvz.volume_threshold(self.c_visual, termination, empty)
+
     def set_texture(self, texture: Texture) -> None:
         """
         Set the texture for the volume.
@@ -57,6 +57,7 @@ typedef struct DvzAxes DvzAxes;
 typedef struct DvzAxis DvzAxis;
 typedef struct DvzBatch DvzBatch;
 typedef struct DvzBox DvzBox;
+typedef struct DvzBricks DvzBricks;
 typedef struct DvzCamera DvzCamera;
 typedef struct DvzColorbar DvzColorbar;
 typedef struct DvzFigure DvzFigure;
@@ -76,6 +77,7 @@ typedef struct DvzServer DvzServer;
 typedef struct DvzShape DvzShape;
 typedef struct DvzTex DvzTex;
 typedef struct DvzTexture DvzTexture;
+typedef struct DvzTiles DvzTiles;
 typedef struct DvzTransform DvzTransform;
 typedef struct DvzVisual DvzVisual;
 
@@ -881,6 +883,22 @@ DVZ_EXPORT void dvz_visual_clip(DvzVisual* visual, DvzViewportClip clip);
 
 
 
+/**
+ * Set the colormap and the value range of a visual created with `DVZ_VISUAL_FLAGS_SCALAR`.
+ *
+ * The scalar values are mapped to colors on the GPU, so changing the colormap or the range does
+ * not upload the values again. Supported by the basic, pixel, point, marker, path, and mesh
+ * visuals.
+ *
+ * @param visual the visual
+ * @param cmap the colormap
+ * @param vmin the value mapped to the first color of the colormap
+ * @param vmax the value mapped to the last color of the colormap
+ */
+DVZ_EXPORT void dvz_visual_colormap(DvzVisual* visual, DvzColormap cmap, float vmin, float vmax);
+
+
+
 /**
  * Set the visual depth.
  *
@@ -901,6 +919,111 @@ DVZ_EXPORT void dvz_visual_show(DvzVisual* visual, bool is_visible);
 
 
 
+/**
+ * Return the id written by a visual into the pick attachment of the canvas.
+ *
+ * @param visual the visual, created with DVZ_VISUAL_FLAGS_PICK
+ * @returns the pick id, or 0 if picking is disabled for this visual
+ */
+DVZ_EXPORT uint32_t dvz_visual_pick_id(DvzVisual* visual);
+
+
+
+/**
+ * Enable a CPU spatial index of the visual positions, for hover and selection queries.
+ *
+ * The index must be enabled before the positions (attribute #0) are set, it is then updated by
+ * dvz_visual_data() and dvz_visual_index().
+ *
+ * @param visual the visual
+ * @param type the index type, DVZ_SPATIAL_POINTS for points and markers, DVZ_SPATIAL_MESH for
+ *     meshes, DVZ_SPATIAL_NONE to disable it
+ */
+DVZ_EXPORT void dvz_visual_spatial(DvzVisual* visual, DvzSpatialType type);
+
+
+
+/**
+ * Find the item closest to a position, using the visual spatial index.
+ *
+ * @param visual the visual
+ * @param mvp if not NULL, the position and distance are in NDC and the MVP must be a panzoom-like
+ *     transformation, otherwise they are in data coordinates
+ * @param pos the position
+ * @param max_distance the maximum distance, use INFINITY for no limit
+ * @param[out] item the closest item (point index, or triangle index for meshes)
+ * @returns whether an item was found within the maximum distance
+ */
+DVZ_EXPORT bool
+dvz_visual_nearest(DvzVisual* visual, DvzMVP* mvp, vec3 pos, float max_distance, uint32_t* item);
+
+
+
+/**
+ * Find the items within a box, using the visual spatial index.
+ *
+ * @param visual the visual
+ * @param mvp if not NULL, the box corners are in NDC and the z coordinate is ignored, otherwise
+ *     they are in data coordinates
+ * @param p0 one corner of the box
+ * @param p1 the opposite corner of the box
+ * @param max_count the maximum number of items to write
+ * @param[out] items the selected items, may be NULL if max_count is 0
+ * @returns the total number of items within the box, possibly larger than max_count
+ */
+DVZ_EXPORT uint32_t dvz_visual_select(
+    DvzVisual* visual, DvzMVP* mvp, vec3 p0, vec3 p1, uint32_t max_count, uint32_t* items);
+
+
+
+/**
+ * Enable GPU-driven culling of the items of a point-like visual (marker, sphere, glyph).
+ *
+ * Whenever the data, the MVP or the viewport change, a compute kernel tests each item against
+ * the viewport and writes the visible items into an indirect draw, so that the vertex processing
+ * cost only depends on the number of visible items. The visual must be allocated first.
+ *
+ * @param visual the visual
+ * @param enabled whether to enable or disable the culling
+ * @param margin the margin around the viewport, in pixels, for items that extend beyond their
+ *     position (for example, glyphs)
+ * @param min_size the items smaller than this size in pixels are culled (markers, and spheres
+ *     created with DVZ_SPHERE_FLAGS_SIZE_PIXELS), 0 to disable
+ */
+DVZ_EXPORT void dvz_visual_culling(DvzVisual* visual, bool enabled, float margin, float min_size);
+
+
+
+/**
+ * Enable CPU culling of a whole visual with its bounding box.
+ *
+ * The bounding box of the positions (attribute #0) is cached in the visual and extended as
+ * positions are set. The draw commands of the visual are not recorded while its bounding box is
+ * entirely outside of the view, and they are recorded again as soon as it enters the view.
+ *
+ * @param visual the visual
+ * @param enabled whether to enable or disable the culling
+ * @param margin the margin around the bounding box, in pixels, for items that extend beyond their
+ *     position (marker size, line width...)
+ */
+DVZ_EXPORT void dvz_visual_bounds(DvzVisual* visual, bool enabled, float margin);
+
+
+
+/**
+ * Set the bounding box of a visual used by the CPU culling.
+ *
+ * This is useful when the positions do not cover the extent of the visual (for example, images
+ * or volumes). The bounding box is no longer updated from the positions.
+ *
+ * @param visual the visual
+ * @param box the bounding box, in the coordinate system of the positions, or NULL to compute it
+ *     from the positions again
+ */
+DVZ_EXPORT void dvz_visual_box(DvzVisual* visual, DvzBox* box);
+
+
+
 /*************************************************************************************************/
 /*  Visual fixed pipeline                                                                        */
 /*************************************************************************************************/
@@ -917,6 +1040,10 @@ DVZ_EXPORT void dvz_visual_primitive(DvzVisual* visual, DvzPrimitiveTopology pri
 /**
  * Set the blend type of a visual.
  *
+ * With DVZ_BLEND_OIT, mesh, point and basic visuals use weighted blended order-independent
+ * transparency on canvases created with DVZ_CANVAS_FLAGS_OIT, and an approximate blending
+ * otherwise.
+ *
  * @param visual the visual
  * @param blend_type the blend type
  */
@@ -1272,6 +1399,22 @@ DVZ_EXPORT void dvz_texture_data(
 
 
 
+/**
+ * Upload a new frame of a 2D texture, only sending the regions that changed since the last frame.
+ *
+ * The texture keeps a copy of the last frame and compares it with the new frame per block of
+ * pixels. The changed blocks are grouped in rectangles which are uploaded separately. For live
+ * images (video, cameras), create the texture with the `DVZ_TEX_FLAGS_STREAMING` flag so that
+ * the uploads do not wait for the GPU.
+ *
+ * @param texture the texture
+ * @param data the full frame, with the size of the texture
+ * @returns the number of bytes uploaded
+ */
+DVZ_EXPORT DvzSize dvz_texture_stream(DvzTexture* texture, void* data);
+
+
+
 /**
  * Create the texture once set.
  *
@@ -1347,6 +1490,164 @@ DVZ_EXPORT DvzTexture* dvz_texture_3D(
 
 
 
+/*************************************************************************************************/
+/*  Bricks                                                                                       */
+/*************************************************************************************************/
+
+/**
+ * Create a bricked volume, streamed to the GPU on demand.
+ *
+ * The volume is split into bricks at multiple resolutions. Only the bricks needed for the current
+ * point of view are loaded, in a background thread, and stored in a fixed-size pool of bricks on
+ * the GPU, which allows for displaying volumes larger than the GPU memory.
+ *
+ * @param batch the batch
+ * @param format the format of the voxels
+ * @param shape the shape of the volume (width, height, depth), in voxels
+ * @param brick_size the size of the bricks, in voxels (0 for the default, 32)
+ * @param capacity the maximum number of bricks stored on the GPU
+ * @param flags the flags
+ * @returns the bricks
+ */
+DVZ_EXPORT DvzBricks* dvz_bricks(
+    DvzBatch* batch, DvzFormat format, uvec3 shape, uint32_t brick_size, uint32_t capacity,
+    int flags);
+
+
+
+/**
+ * Set the callback function used to load the bricks.
+ *
+ * The callback is called from a background thread. It must fill `out` with the voxels of the
+ * region `offset`, `shape` of the volume at the given level, subsampled by a factor 2^level, with
+ * the x axis varying fastest.
+ *
+ * @param bricks the bricks
+ * @param callback the callback
+ * @param user_data the user data passed to the callback
+ */
+DVZ_EXPORT void
+dvz_bricks_callback(DvzBricks* bricks, DvzBricksCallback callback, void* user_data);
+
+
+
+/**
+ * Load the bricks from a raw binary file mapped in memory.
+ *
+ * The file contains the full-resolution volume with the x axis varying fastest. Lower
+ * resolution bricks are obtained by subsampling.
+ *
+ * @param bricks the bricks
+ * @param filename the path to the file
+ * @param offset the offset of the first voxel in the file, in bytes
+ */
+DVZ_EXPORT void dvz_bricks_file(DvzBricks* bricks, const char* filename, DvzSize offset);
+
+
+
+/**
+ * Update the bricks for a given point of view.
+ *
+ * This function should be called at every frame. It selects the level of detail of each region
+ * of the volume, requests the missing bricks to the loader thread, and uploads the bricks that
+ * have been loaded since the last call.
+ *
+ * @param bricks the bricks
+ * @param eye the position of the camera, in normalized volume coordinates (between 0 and 1)
+ * @param detail the distance, in bricks, below which a brick is refined (2 is a good default)
+ * @returns the number of bricks that are still being loaded
+ */
+DVZ_EXPORT uint32_t dvz_bricks_update(DvzBricks* bricks, vec3 eye, float detail);
+
+
+
+/**
+ * Destroy the bricks.
+ *
+ * @param bricks the bricks
+ */
+DVZ_EXPORT void dvz_bricks_destroy(DvzBricks* bricks);
+
+
+
+/*************************************************************************************************/
+/*  Tiles                                                                                        */
+/*************************************************************************************************/
+
+/**
+ * Create a tiled multiresolution image, streamed to the GPU on demand.
+ *
+ * The image is split into square tiles at multiple resolutions (an image pyramid). Only the tiles
+ * visible in the current view, at the resolution matching the zoom level, are loaded in a
+ * background thread and stored in a fixed-size tile cache on the GPU, which allows for displaying
+ * gigapixel images.
+ *
+ * @param batch the batch
+ * @param format the format of the pixels
+ * @param width the width of the image at full resolution, in pixels
+ * @param height the height of the image at full resolution, in pixels
+ * @param tile_size the size of the tiles, in pixels (0 for the default, 256)
+ * @param capacity the maximum number of tiles stored on the GPU
+ * @param flags the flags
+ * @returns the tiles
+ */
+DVZ_EXPORT DvzTiles* dvz_tiles(
+    DvzBatch* batch, DvzFormat format, uint32_t width, uint32_t height, uint32_t tile_size,
+    uint32_t capacity, int flags);
+
+
+
+/**
+ * Set the callback function used to load the tiles.
+ *
+ * The callback is called from a background thread. It must fill `out` with the T x T pixels of
+ * the tile (x, y) of the image downsampled by a factor 2^level, with the first row at the top and
+ * the x axis varying fastest. Pixels beyond the border of the image are ignored.
+ *
+ * @param tiles the tiles
+ * @param callback the callback
+ * @param user_data the user data passed to the callback
+ */
+DVZ_EXPORT void dvz_tiles_callback(DvzTiles* tiles, DvzTilesCallback callback, void* user_data);
+
+
+
+/**
+ * Set the position of the image, in normalized device coordinates.
+ *
+ * @param tiles the tiles
+ * @param xlim the left and right coordinates of the image (-1, +1 by default)
+ * @param ylim the bottom and top coordinates of the image (-1, +1 by default)
+ */
+DVZ_EXPORT void dvz_tiles_bounds(DvzTiles* tiles, vec2 xlim, vec2 ylim);
+
+
+
+/**
+ * Update the tiles for the current view of a panzoom.
+ *
+ * This function should be called at every frame. It selects the level of the pyramid matching
+ * the zoom level and the tiles visible in the view, requests the missing tiles to the loader
+ * thread, and uploads the tiles that have been loaded since the last call. The lower resolution
+ * tiles already loaded are displayed until the higher resolution tiles arrive.
+ *
+ * @param tiles the tiles
+ * @param pz the panzoom
+ * @returns the number of tiles that are still being loaded
+ */
+DVZ_EXPORT uint32_t dvz_tiles_update(DvzTiles* tiles, DvzPanzoom* pz);
+
+
+
+/**
+ * Destroy the tiles.
+ *
+ * @param tiles the tiles
+ */
+DVZ_EXPORT void dvz_tiles_destroy(DvzTiles* tiles);
+
+
+
 /*************************************************************************************************/
 /*  Colormap functions                                                                           */
 /*************************************************************************************************/
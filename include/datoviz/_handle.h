@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Dense handles                                                                                */
+/*************************************************************************************************/
+
+/*
+A dense handle is a DvzId that encodes an object type, a slot index and a generation:
+
+    bit 63      1 (dense handle tag)
+    bits 56-62  object type
+    bits 32-55  generation, incremented every time the slot is freed
+    bits 0-31   slot index, reused after the object is freed
+
+It can be resolved in O(1) with a per-type slot array, and a stale handle to a freed slot is
+detected with the generation. Random IDs always have the top bit cleared, so that both kinds of
+IDs can coexist in the same DvzMap.
+*/
+
+#ifndef DVZ_HEADER_HANDLE
+#define DVZ_HEADER_HANDLE
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "_macros.h"
+#include "datoviz_math.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_HANDLE_DENSE       0x8000000000000000ULL
+#define DVZ_HANDLE_RANDOM_MASK 0x7FFFFFFFFFFFFFFFULL
+#define DVZ_HANDLE_MAX_TYPES   128
+#define DVZ_HANDLE_GENERATIONS 0x01000000
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzHandles DvzHandles;
+
+
+
+/*************************************************************************************************/
+/*  Handle encoding                                                                              */
+/*************************************************************************************************/
+
+static inline DvzId dvz_handle(uint32_t type, uint32_t index, uint32_t generation)
+{
+    ASSERT(type < DVZ_HANDLE_MAX_TYPES);
+    ASSERT(generation < DVZ_HANDLE_GENERATIONS);
+    return DVZ_HANDLE_DENSE | ((uint64_t)type << 56) | ((uint64_t)generation << 32) |
+           (uint64_t)index;
+}
+
+
+
+static inline bool dvz_handle_is_dense(DvzId id) { return (id & DVZ_HANDLE_DENSE) != 0; }
+
+
+
+static inline uint32_t dvz_handle_type(DvzId id) { return (uint32_t)((id >> 56) & 0x7F); }
+
+
+
+static inline uint32_t dvz_handle_generation(DvzId id)
+{
+    return (uint32_t)((id >> 32) & (DVZ_HANDLE_GENERATIONS - 1));
+}
+
+
+
+static inline uint32_t dvz_handle_index(DvzId id) { return (uint32_t)(id & 0xFFFFFFFF); }
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Handle allocator                                                                             */
+/*************************************************************************************************/
+
+/**
+ * Create a thread-safe dense handle allocator.
+ *
+ * @returns the allocator
+ */
+DvzHandles* dvz_handles(void);
+
+
+
+/**
+ * Allocate a new dense handle, reusing a freed slot if there is one.
+ *
+ * @param handles the allocator
+ * @param type the object type, must be lower than DVZ_HANDLE_MAX_TYPES
+ * @returns the handle
+ */
+DvzId dvz_handles_alloc(DvzHandles* handles, uint32_t type);
+
+
+
+/**
+ * Free a dense handle, its slot will be reused with a new generation.
+ *
+ * @param handles the allocator
+ * @param id the handle
+ */
+void dvz_handles_free(DvzHandles* handles, DvzId id);
+
+
+
+/**
+ * Destroy a dense handle allocator.
+ *
+ * @param handles the allocator
+ */
+void dvz_handles_destroy(DvzHandles* handles);
+
+
+
+/**
+ * Return the process-wide dense handle allocator, created on first use.
+ *
+ * It is never destroyed, so that a handle is never reissued while a renderer may still hold the
+ * object it refers to. The handles are freed by the renderer when it processes their deletion.
+ *
+ * @returns the allocator
+ */
+DvzHandles* dvz_handles_global(void);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Hash utilities                                                                               */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_HASH
+#define DVZ_HEADER_HASH
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "_macros.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_HASH_SEED  0xcbf29ce484222325ULL // FNV-1a 64-bit offset basis
+#define DVZ_HASH_PRIME 0x00000100000001b3ULL // FNV-1a 64-bit prime
+
+
+
+/*************************************************************************************************/
+/*  Hash functions                                                                               */
+/*************************************************************************************************/
+
+/**
+ * Hash a buffer with the 64-bit FNV-1a function.
+ *
+ * Successive buffers can be hashed together by passing the previous hash as the seed.
+ *
+ * @param seed the initial value, DVZ_HASH_SEED or a previous hash
+ * @param size the size of the buffer, in bytes
+ * @param data the buffer
+ * @returns the hash
+ */
+static inline uint64_t dvz_hash(uint64_t seed, size_t size, const void* data)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= (uint64_t)bytes[i];
+        hash *= DVZ_HASH_PRIME;
+    }
+    return hash;
+}
+
+
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Trace events                                                                                 */
+/*************************************************************************************************/
+
+/*
+Trace recorder writing Chrome trace-event JSON files, that can be opened in ui.perfetto.dev or
+chrome://tracing.
+
+Every thread appends its events to its own buffer, without any lock: recording costs a relaxed
+atomic load when tracing is disabled, and a clock read and a few stores when it is enabled. The
+buffers are only merged when writing the JSON file.
+
+The category, name and argument name strings are stored as pointers and must therefore have a
+static lifetime (string literals).
+
+Set the DVZ_TRACE=path.json environment variable to record a trace during the lifetime of an app.
+*/
+
+#ifndef DVZ_HEADER_TRACE
+#define DVZ_HEADER_TRACE
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "_macros.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_TRACE_CHUNK_SIZE 4096 // number of events per chunk
+#define DVZ_TRACE_MAX_CHUNKS 1024 // maximum number of chunks per thread, then events are dropped
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Trace functions                                                                              */
+/*************************************************************************************************/
+
+/**
+ * Start recording trace events.
+ */
+DVZ_EXPORT void dvz_trace_start(void);
+
+
+
+/**
+ * Stop recording trace events. The recorded events are kept until dvz_trace_clear().
+ */
+DVZ_EXPORT void dvz_trace_stop(void);
+
+
+
+/**
+ * Return whether trace events are being recorded.
+ *
+ * @returns whether tracing is enabled
+ */
+DVZ_EXPORT bool dvz_trace_enabled(void);
+
+
+
+/**
+ * Name the calling thread in the trace.
+ *
+ * @param name the thread name, with a static lifetime
+ */
+DVZ_EXPORT void dvz_trace_thread(const char* name);
+
+
+
+/**
+ * Begin a span on the calling thread.
+ *
+ * @param cat the category
+ * @param name the span name
+ */
+DVZ_EXPORT void dvz_trace_begin(const char* cat, const char* name);
+
+
+
+/**
+ * Begin a span on the calling thread, with two integer arguments.
+ *
+ * @param cat the category
+ * @param name the span name
+ * @param key0 the name of the first argument
+ * @param val0 the value of the first argument
+ * @param key1 the name of the second argument, or NULL
+ * @param val1 the value of the second argument
+ */
+DVZ_EXPORT void dvz_trace_begin_args(
+    const char* cat, const char* name, const char* key0, int64_t val0, const char* key1,
+    int64_t val1);
+
+
+
+/**
+ * End the last span begun on the calling thread.
+ */
+DVZ_EXPORT void dvz_trace_end(void);
+
+
+
+/**
+ * Record an instant event on the calling thread.
+ *
+ * @param cat the category
+ * @param name the event name
+ */
+DVZ_EXPORT void dvz_trace_instant(const char* cat, const char* name);
+
+
+
+/**
+ * Return the number of recorded events, across all threads.
+ *
+ * @returns the number of events
+ */
+DVZ_EXPORT uint64_t dvz_trace_count(void);
+
+
+
+/**
+ * Write the recorded events to a Chrome trace-event JSON file.
+ *
+ * @param path the file path
+ * @returns 0 if the file was successfully written
+ */
+DVZ_EXPORT int dvz_trace_write(const char* path);
+
+
+
+/**
+ * Discard all recorded events.
+ *
+ * This function must be called when tracing is stopped. The buffers of the running threads are
+ * emptied and reused, the buffers of the threads that have exited are freed.
+ */
+DVZ_EXPORT void dvz_trace_clear(void);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -34,6 +34,21 @@
 /*************************************************************************************************/
 
 typedef struct DvzAlloc DvzAlloc;
+typedef struct DvzAllocMove DvzAllocMove;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// One step of a relocation plan: move an allocated item from one offset to another.
+struct DvzAllocMove
+{
+    DvzSize src;
+    DvzSize dst;
+    DvzSize size;
+};
 
 
 
@@ -90,6 +105,31 @@ DvzAlloc* dvz_alloc(DvzSize size, DvzSize alignment);
  */
 DvzSize dvz_alloc_new(DvzAlloc* alloc, DvzSize req_size, DvzSize* resized);
 
+/**
+ * Resize an allocated item in place.
+ *
+ * Shrinking always succeeds. Growing succeeds only if the item is followed by enough free space.
+ *
+ * @param alloc the DvzAlloc pointer
+ * @param offset the offset of the allocated item
+ * @param req_size the new requested size for the item
+ * @returns whether the item could be resized without moving
+ */
+bool dvz_alloc_extend(DvzAlloc* alloc, DvzSize offset, DvzSize req_size);
+
+/**
+ * Return the capacity to reserve for an item that is resized.
+ *
+ * The capacity grows geometrically (at least doubling), so that repeatedly growing an item by a
+ * small amount only reallocates it a logarithmic number of times. The capacity is kept while the
+ * requested size stays above a quarter of it, and halves below.
+ *
+ * @param capacity the current capacity (0 if none)
+ * @param req_size the requested size
+ * @returns the new capacity, which is larger than or equal to the requested size
+ */
+DvzSize dvz_alloc_capacity(DvzSize capacity, DvzSize req_size);
+
 /**
  * Remove an allocated item.
  *
@@ -123,6 +163,42 @@ void dvz_alloc_size(DvzAlloc* alloc, DvzSize* out_alloc, DvzSize* out_total);
  */
 void dvz_alloc_stats(DvzAlloc* alloc);
 
+/**
+ * Pack all allocated items at the beginning of the virtual buffer.
+ *
+ * The items keep their relative order, and the free space is merged into a single block at the
+ * end of the virtual buffer. The total size is unchanged (see `dvz_alloc_trim()`). The returned
+ * relocation plan is sorted by increasing source offset, and every move goes toward a lower
+ * offset, so the moves can be applied in order in place.
+ *
+ * @param alloc the DvzAlloc pointer
+ * @param[out] out_moves the relocation plan, to be freed by the caller (NULL if nothing moved)
+ * @returns the number of moves in the relocation plan
+ */
+uint32_t dvz_alloc_compact(DvzAlloc* alloc, DvzAllocMove** out_moves);
+
+/**
+ * Shrink the virtual buffer by dropping the free space after the last allocated item.
+ *
+ * The new total size is the smallest `min_size * 2^k` that holds all allocated items, so that
+ * the virtual buffer keeps growing by doubling afterwards. Allocated items never move.
+ *
+ * @param alloc the DvzAlloc pointer
+ * @param min_size the minimum total size (typically the initial size)
+ * @returns the new total size
+ */
+DvzSize dvz_alloc_trim(DvzAlloc* alloc, DvzSize min_size);
+
+/**
+ * Return the new offset of a location after a relocation plan has been applied.
+ *
+ * @param count the number of moves in the relocation plan
+ * @param moves the relocation plan
+ * @param offset an offset within the virtual buffer before the relocation
+ * @returns the offset after the relocation (unchanged if it was not within a moved item)
+ */
+DvzSize dvz_alloc_relocated(uint32_t count, DvzAllocMove* moves, DvzSize offset);
+
 /**
  * Clear all allocations.
  *
@@ -19,6 +19,9 @@
 
 #include "_enums.h"
 #include "_time_utils.h"
+#include "gpu_timer.h"
+#include "oit.h"
+#include "pick.h"
 #include "surface.h"
 #include "vklite.h"
 
@@ -28,9 +31,6 @@
 /*  Constants                                                                                    */
 /*************************************************************************************************/
 
-// #define DVZ_PICK_IMAGE_FORMAT    VK_FORMAT_R32G32B32A32_SINT
-// #define DVZ_PICK_STAGING_SIZE    8
-
 #define DVZ_MIN_SWAPCHAIN_IMAGE_COUNT 3
 #define DVZ_SEMAPHORE_IMG_AVAILABLE   0
 #define DVZ_SEMAPHORE_RENDER_FINISHED 1
@@ -76,9 +76,14 @@ struct DvzRender
     DvzImages depth;
     DvzImages staging;
 
-    // TODO: picking, screencast
-    // DvzImages pick_image;
-    // DvzImages pick_staging;
+    // Only used with DVZ_CANVAS_FLAGS_PICK.
+    DvzPicker picker;
+
+    // Only used with DVZ_CANVAS_FLAGS_OIT.
+    DvzOit oit;
+
+    // Only used with DVZ_CANVAS_FLAGS_PROFILE.
+    DvzGpuTimer timer;
 
     // DvzBuffer screencast_staging;
     // DvzImages* screencast_img;
@@ -209,6 +214,20 @@ void dvz_canvas_begin(DvzCanvas* canvas, DvzCommands* cmds, uint32_t idx);
 
 
 
+/**
+ * Begin the renderpass of the canvas in a command buffer that has already begun.
+ *
+ * Commands that must be outside of the renderpass, like compute dispatches, can be recorded
+ * between dvz_cmd_begin() and this function.
+ *
+ * @param canvas the canvas
+ * @param cmds the commands instance
+ * @param idx the command buffer index with the commands instance
+ */
+void dvz_canvas_begin_renderpass(DvzCanvas* canvas, DvzCommands* cmds, uint32_t idx);
+
+
+
 /**
  * Set the viewport when filling a command buffer.
  *
@@ -223,6 +242,22 @@ void dvz_canvas_viewport( //
 
 
 
+/**
+ * Write a GPU timestamp beginning or ending a span when filling a command buffer.
+ *
+ * This function does nothing if the canvas was not created with DVZ_CANVAS_FLAGS_PROFILE.
+ *
+ * @param canvas the canvas
+ * @param cmds the commands instance
+ * @param idx the command buffer index with the commands instance
+ * @param id the span id
+ * @param end whether to end the span, or to begin it
+ */
+void dvz_canvas_timestamp(
+    DvzCanvas* canvas, DvzCommands* cmds, uint32_t idx, DvzId id, bool end);
+
+
+
 /**
  * Stop rendering to the canvas in a command buffer.
  *
@@ -257,6 +292,33 @@ void dvz_canvas_timestamps(
 
 
 
+/**
+ * Collect the GPU durations of the previous submission of a command buffer, without waiting.
+ *
+ * To be called just before submitting the command buffer.
+ *
+ * @param canvas the canvas
+ * @param idx the command buffer index
+ */
+void dvz_canvas_gpu_collect(DvzCanvas* canvas, uint32_t idx);
+
+
+
+/**
+ * Return the last collected GPU durations of the spans of a canvas, typically one per view and
+ * one per visual draw. The durations lag a few frames behind.
+ *
+ * @param canvas the canvas
+ * @param count the size of the output arrays
+ * @param[out] ids the span ids, a buffer holding at least `count` values
+ * @param[out] nanoseconds the GPU durations, a buffer holding at least `count` values
+ * @returns the number of spans written in the output arrays
+ */
+uint32_t
+dvz_canvas_gpu_times(DvzCanvas* canvas, uint32_t count, DvzId* ids, uint64_t* nanoseconds);
+
+
+
 /**
  * Destroy a canvas.
  *
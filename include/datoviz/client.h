@@ -32,6 +32,7 @@
 /*************************************************************************************************/
 
 #define DVZ_CLIENT_MAX_CALLBACKS 16
+#define DVZ_CLIENT_WAIT_TIMEOUT  0.1 // in seconds, maximum blocking time in on-demand mode
 
 
 
@@ -146,6 +147,18 @@ struct DvzClient
 
     DvzClock clock;
 
+    // On-demand rendering.
+    bool on_demand;      // only send FRAME events to the windows that need to be redrawn
+    bool redraw_all;     // whether all windows need to be redrawn at the next frame
+    double wait_timeout; // maximum time to block on backend events when idle, in seconds
+    double wake_time;    // clock time of the next scheduled redraw, negative if none
+
+    // Coalescing of the mouse move, drag and wheel events.
+    bool coalesce;          // whether consecutive events of a window are merged before dispatch
+    bool has_pending;       // whether an event is held back
+    DvzClientEvent pending; // held back event, enqueued before the events are processed
+    DvzMutex pending_lock;  // guards the held back event, as events may come from any thread
+
     // Windows.
     DvzContainer windows;
     DvzMap* map;
@@ -194,6 +207,63 @@ DvzWindow* dvz_client_window(DvzClient* client, DvzId id);
 
 
 
+/**
+ * Enable or disable on-demand rendering.
+ *
+ * In on-demand mode, a window only receives a FRAME event when it needs to be redrawn: after it
+ * has been created, after an input or resize event, or when dvz_client_redraw() has been called.
+ * When no window needs to be redrawn and no event is pending, dvz_client_frame() blocks on the
+ * backend events (with a timeout) instead of busy-looping.
+ *
+ * @param client the client
+ * @param on_demand whether to enable on-demand rendering
+ */
+void dvz_client_on_demand(DvzClient* client, bool on_demand);
+
+
+
+/**
+ * Request a new FRAME event for a window, in on-demand mode.
+ *
+ * This function must be called from the thread running the event loop.
+ *
+ * @param client the client
+ * @param window_id the window id, or DVZ_ID_NONE to redraw all windows
+ */
+void dvz_client_redraw(DvzClient* client, DvzId window_id);
+
+
+
+/**
+ * Schedule a FRAME event for all windows at a given time, in on-demand mode.
+ *
+ * The event loop does not block on the backend events past that time. Only the earliest
+ * scheduled time is kept. This function must be called from the thread running the event loop.
+ *
+ * @param client the client
+ * @param time the time, in seconds, on the client clock (the time of the FRAME events)
+ */
+void dvz_client_redraw_at(DvzClient* client, double time);
+
+
+
+/**
+ * Enable or disable the coalescing of the mouse events.
+ *
+ * When enabled (the default), consecutive mouse move, drag and wheel events of a window are
+ * merged into a single event before they reach the callbacks, so that they are processed at most
+ * once per frame (see dvz_mouse_merge()). The merged wheel event has the sum of the wheel
+ * directions. The other events, and their order, are not affected.
+ *
+ * This function must be called from the thread running the event loop.
+ *
+ * @param client the client
+ * @param coalesce whether to coalesce the mouse events
+ */
+void dvz_client_coalesce(DvzClient* client, bool coalesce);
+
+
+
 int dvz_client_frame(DvzClient* client);
 
 
@@ -90,6 +90,60 @@ void dvz_datalloc_dealloc(
 
 
 
+/**
+ * Try to resize an allocation in place on a shared buffer.
+ *
+ * @param datalloc the datalloc
+ * @param type the buffer type
+ * @param mappable whether the shared buffer is mappable
+ * @param offset the offset of the allocation
+ * @param req_size the new size of the allocation
+ * @returns whether the allocation could be resized without moving
+ */
+bool dvz_datalloc_extend(
+    DvzDatAlloc* datalloc, DvzBufferType type, bool mappable, DvzSize offset, DvzSize req_size);
+
+
+
+/**
+ * Defragment a shared buffer and shrink it to fit its dats.
+ *
+ * The dats allocated on the shared buffer are packed at the beginning of a new, smaller buffer
+ * with GPU-side copies (hard sync), and their buffer regions are updated. The GPU must be idle.
+ * The Vulkan buffer handle changes, and the dat offsets may change: the descriptors and the
+ * command buffers that refer to the buffer must be updated by the caller (see
+ * `dvz_renderer_compact()`).
+ *
+ * @param datalloc the datalloc
+ * @param res the resources
+ * @param type the buffer type
+ * @param mappable whether the shared buffer is mappable
+ * @param[out] out_moves if not NULL, the relocation plan, to be freed by the caller
+ * @returns the number of dats that moved
+ */
+uint32_t dvz_datalloc_compact(
+    DvzDatAlloc* datalloc, DvzResources* res, DvzBufferType type, bool mappable,
+    DvzAllocMove** out_moves);
+
+
+
+/**
+ * Shrink a shared buffer by releasing the free space after its last dat.
+ *
+ * The dats keep their offsets, but the Vulkan buffer handle changes if the buffer shrinks, so
+ * the descriptors and the command buffers that refer to the buffer must be updated by the caller.
+ *
+ * @param datalloc the datalloc
+ * @param res the resources
+ * @param type the buffer type
+ * @param mappable whether the shared buffer is mappable
+ * @returns the new buffer size
+ */
+DvzSize
+dvz_datalloc_trim(DvzDatAlloc* datalloc, DvzResources* res, DvzBufferType type, bool mappable);
+
+
+
 void dvz_datalloc_monitoring(DvzDatAlloc* datalloc, DvzAllocMonitor* out);
 
 
@@ -100,6 +100,63 @@ int dvz_write_bytes(const char* filename, const char* mode, DvzSize size, const
 
 
 
+/*************************************************************************************************/
+/*  Cache directory                                                                              */
+/*************************************************************************************************/
+
+/**
+ * Return the path of a file in the user cache directory, creating the directory if needed.
+ *
+ * The directory is `DVZ_CACHE_DIR` if this environment variable is set, or `datoviz` within the
+ * user cache directory otherwise (`XDG_CACHE_HOME`, `~/.cache`, or `%LOCALAPPDATA%` on Windows).
+ * All on-disk caches are disabled when the `DVZ_NO_CACHE` environment variable is set.
+ *
+ * @param name the file name within the cache directory
+ * @param[out] path the file path
+ * @param size the size of the path buffer
+ * @returns 0 if the path is available, 1 if the cache is disabled or unavailable
+ */
+int dvz_cache_path(const char* name, char* path, size_t size);
+
+
+
+/**
+ * Return the path of the shared library (or executable) that contains a given symbol.
+ *
+ * @param symbol address of a function or variable defined in the library
+ * @param[out] path the library path
+ * @param size the size of the path buffer
+ * @returns 0 if the path is available, 1 otherwise
+ */
+int dvz_library_path(const void* symbol, char* path, size_t size);
+
+
+
+/*************************************************************************************************/
+/*  Memory-mapped files                                                                          */
+/*************************************************************************************************/
+
+/**
+ * Map a file in memory, in read-only mode.
+ *
+ * @param filename path of the file to map
+ * @param[out] size of the file
+ * @returns pointer to the mapped file contents, or NULL if the file could not be mapped
+ */
+void* dvz_mmap_file(const char* filename, DvzSize* size);
+
+
+
+/**
+ * Unmap a file mapped with `dvz_mmap_file()`.
+ *
+ * @param ptr pointer returned by `dvz_mmap_file()`
+ * @param size size of the file
+ */
+void dvz_munmap_file(void* ptr, DvzSize size);
+
+
+
 /*************************************************************************************************/
 /*  Image file I/O utils                                                                         */
 /*************************************************************************************************/
@@ -24,6 +24,7 @@
 #include <GLFW/glfw3.h>
 #endif
 
+#include "_time_utils.h"
 #include "window.h"
 
 
@@ -202,10 +203,33 @@ static void backend_wait(DvzBackend backend)
 
 
 
+// Block until an event arrives or the timeout (in seconds) expires. Backends without an event
+// queue just sleep for the duration of the timeout.
+static void backend_wait_timeout(DvzBackend backend, double timeout)
+{
+    ASSERT(backend != DVZ_BACKEND_NONE);
+    ASSERT(timeout >= 0);
+
+    switch (backend)
+    {
+    case DVZ_BACKEND_GLFW:
+    {
+#if HAS_GLFW
+        glfwWaitEventsTimeout(timeout);
+#endif
+        break;
+    }
+    default:
+        dvz_sleep_us((int)(timeout * 1e6));
+        break;
+    }
+}
+
+
+
 static void backend_window_clear_callbacks(DvzBackend backend, void* bwin)
 {
     ASSERT(backend != DVZ_BACKEND_NONE);
-    ANN(bwin);
 
     log_trace("removing window input callbacks");
     switch (backend)
@@ -213,6 +237,7 @@ static void backend_window_clear_callbacks(DvzBackend backend, void* bwin)
     case DVZ_BACKEND_GLFW:
     {
 #if HAS_GLFW
+        ANN(bwin);
         GLFWwindow* window = (GLFWwindow*)bwin;
 
         glfwSetWindowFocusCallback(window, NULL);
@@ -237,7 +262,6 @@ static void backend_window_clear_callbacks(DvzBackend backend, void* bwin)
 static void backend_window_destroy(DvzBackend backend, void* bwin)
 {
     ASSERT(backend != DVZ_BACKEND_NONE);
-    ANN(bwin);
 
     // NOTE TODO: need to vkDeviceWaitIdle(device) on all devices before calling this
     log_trace("starting destruction of backend window...");
@@ -246,6 +270,7 @@ static void backend_window_destroy(DvzBackend backend, void* bwin)
     case DVZ_BACKEND_GLFW:
     {
 #if HAS_GLFW
+        ANN(bwin);
         // NOTE: this call leads to a crash with GLFW when input events (eg mouse) are still in the
         // queue while the window is being destroyed.
         // glfwPollEvents();
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  GPU timer                                                                                    */
+/*************************************************************************************************/
+
+/*
+GPU timestamps bracketing spans of a canvas command buffers, typically one span per view and one
+span per visual draw.
+
+Canvases created with DVZ_CANVAS_FLAGS_PROFILE own a timestamp query pool with a fixed range of
+queries per command buffer. The range is reset at the beginning of the command buffer, and each
+span writes one timestamp when it begins and one when it ends. Since the command buffers are
+recorded once and submitted many times, the results are read just before a command buffer is
+submitted again, without waiting: they refer to the previous submission of that command buffer,
+that is, a few frames behind.
+*/
+
+#ifndef DVZ_HEADER_GPU_TIMER
+#define DVZ_HEADER_GPU_TIMER
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "datoviz_types.h"
+#include "vklite.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_GPU_TIMER_MAX_SPANS 128 // maximum number of spans per command buffer
+#define DVZ_GPU_TIMER_MAX_DEPTH 8   // maximum nesting depth of the spans
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzGpuTimer DvzGpuTimer;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzGpuTimer
+{
+    DvzQueries queries; // two timestamps per span, DVZ_GPU_TIMER_MAX_SPANS spans per cmd buffer
+    double period;      // number of nanoseconds per timestamp tick
+
+    // Span ids recorded in each command buffer.
+    uint32_t recorded_count[DVZ_MAX_SWAPCHAIN_IMAGES];
+    DvzId recorded[DVZ_MAX_SWAPCHAIN_IMAGES][DVZ_GPU_TIMER_MAX_SPANS];
+
+    // Span ids of the last submission of each command buffer, whose timestamps are in the pool.
+    uint32_t submitted_count[DVZ_MAX_SWAPCHAIN_IMAGES];
+    DvzId submitted[DVZ_MAX_SWAPCHAIN_IMAGES][DVZ_GPU_TIMER_MAX_SPANS];
+
+    // Spans being recorded, innermost last.
+    uint32_t depth;
+    uint32_t stack[DVZ_GPU_TIMER_MAX_DEPTH];
+    uint32_t skipped; // spans nested too deeply, which are not timed
+
+    // Last collected durations.
+    uint32_t count;
+    DvzId ids[DVZ_GPU_TIMER_MAX_SPANS];
+    uint64_t durations[DVZ_GPU_TIMER_MAX_SPANS]; // in nanoseconds
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Create the timestamp queries of a canvas.
+ *
+ * If the GPU does not support timestamps on its graphics queue, the timer is left uncreated and
+ * the other functions do nothing.
+ *
+ * @param gpu the GPU
+ * @param timer the GPU timer
+ */
+void dvz_gpu_timer(DvzGpu* gpu, DvzGpuTimer* timer);
+
+
+
+/**
+ * Reset the timestamps of a command buffer, to be called before beginning the renderpass.
+ *
+ * @param timer the GPU timer
+ * @param cmds the command buffers
+ * @param idx the command buffer index
+ */
+void dvz_gpu_timer_begin(DvzGpuTimer* timer, DvzCommands* cmds, uint32_t idx);
+
+
+
+/**
+ * Write the timestamp of the beginning or the end of a span.
+ *
+ * Spans may be nested. A span ends the last span begun with the same id.
+ *
+ * @param timer the GPU timer
+ * @param cmds the command buffers
+ * @param idx the command buffer index
+ * @param id the span id, for example the id of a graphics pipeline
+ * @param end whether to end the span, or to begin it
+ */
+void dvz_gpu_timer_span(DvzGpuTimer* timer, DvzCommands* cmds, uint32_t idx, DvzId id, bool end);
+
+
+
+/**
+ * End the spans left open in a command buffer, to be called before ending the command buffer.
+ *
+ * @param timer the GPU timer
+ * @param cmds the command buffers
+ * @param idx the command buffer index
+ */
+void dvz_gpu_timer_end(DvzGpuTimer* timer, DvzCommands* cmds, uint32_t idx);
+
+
+
+/**
+ * Collect the durations of the previous submission of a command buffer, without waiting.
+ *
+ * To be called just before submitting the command buffer. The last collected durations are kept
+ * if the GPU has not finished executing the previous submission.
+ *
+ * @param timer the GPU timer
+ * @param idx the command buffer index
+ */
+void dvz_gpu_timer_collect(DvzGpuTimer* timer, uint32_t idx);
+
+
+
+/**
+ * Return the last collected span durations.
+ *
+ * @param timer the GPU timer
+ * @param count the size of the output arrays
+ * @param[out] ids the span ids, a buffer holding at least `count` values
+ * @param[out] nanoseconds the span durations, a buffer holding at least `count` values
+ * @returns the number of spans written in the output arrays
+ */
+uint32_t
+dvz_gpu_timer_results(DvzGpuTimer* timer, uint32_t count, DvzId* ids, uint64_t* nanoseconds);
+
+
+
+/**
+ * Destroy the timestamp queries of a canvas.
+ *
+ * @param timer the GPU timer
+ */
+void dvz_gpu_timer_destroy(DvzGpuTimer* timer);
+
+
+
+EXTERN_C_OFF
+
+#endif
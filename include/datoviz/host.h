@@ -20,6 +20,7 @@
 #include <vulkan/vulkan.h>
 
 #include "_enums.h"
+#include "_mutex.h"
 #include "_obj.h"
 #include "_time_utils.h"
 
@@ -31,6 +32,9 @@
 
 typedef struct DvzHost DvzHost;
 
+// Forward declarations.
+typedef struct DvzCompiler DvzCompiler;
+
 
 
 /*************************************************************************************************/
@@ -56,6 +60,10 @@ struct DvzHost
 
     // Containers.
     DvzContainer gpus;
+
+    // GLSL compiler with its SPIR-V cache, created on first use under the compiler lock.
+    DvzCompiler* compiler;
+    DvzMutex compiler_lock;
 };
 
 
@@ -86,6 +86,21 @@ void dvz_mouse_callback(
 
 
 
+/**
+ * Merge a mouse event into the previous one, when both can be coalesced.
+ *
+ * Consecutive MOVE and DRAG events with the same button and modifiers are merged into the most
+ * recent one, keeping the last position of the first DRAG event. Consecutive WHEEL events with the
+ * same modifiers are merged by accumulating their directions.
+ *
+ * @param prev the previous event, updated in place
+ * @param ev the next event
+ * @returns whether the event was merged into the previous one
+ */
+bool dvz_mouse_merge(DvzMouseEvent* prev, DvzMouseEvent* ev);
+
+
+
 EXTERN_C_OFF
 
 #endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Order-independent transparency                                                               */
+/*************************************************************************************************/
+
+/*
+Weighted blended order-independent transparency (McGuire and Bavoil, 2013).
+
+Canvases created with DVZ_CANVAS_FLAGS_OIT use a renderpass with two subpasses. In the first one,
+visuals with the DVZ_BLEND_OIT blend type write their translucent fragments into two additional
+attachments instead of the color attachment: a weighted sum of the premultiplied colors (accum,
+additive blending) and the product of the fragment transparencies (reveal, multiplicative
+blending). Their depth test still applies against the opaque fragments, but they do not write
+depth. The second subpass composites the two attachments onto the color attachment with a
+fullscreen triangle, so that translucent scenes render correctly without sorting on the CPU.
+*/
+
+#ifndef DVZ_HEADER_OIT
+#define DVZ_HEADER_OIT
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "datoviz_types.h"
+#include "vklite.h"
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzOit DvzOit;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzOit
+{
+    DvzImages accum;  // weighted sum of the premultiplied colors, one image per framebuffer
+    DvzImages reveal; // product of the fragment transparencies, one image per framebuffer
+
+    DvzGraphics graphics;       // composite pipeline, in the second subpass
+    DvzDescriptors descriptors; // accum and reveal input attachments, one set per framebuffer
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Create the order-independent transparency attachments and composite pipeline of a canvas.
+ *
+ * @param gpu the GPU
+ * @param oit the OIT resources
+ * @param renderpass the canvas renderpass, created with DVZ_RENDERPASS_FLAGS_OIT
+ * @param img_count the number of framebuffers of the canvas
+ * @param width the framebuffer width
+ * @param height the framebuffer height
+ */
+void dvz_oit(
+    DvzGpu* gpu, DvzOit* oit, DvzRenderpass* renderpass, uint32_t img_count, uint32_t width,
+    uint32_t height);
+
+
+
+/**
+ * Resize the order-independent transparency attachments.
+ *
+ * @param oit the OIT resources
+ * @param width the new framebuffer width
+ * @param height the new framebuffer height
+ */
+void dvz_oit_resize(DvzOit* oit, uint32_t width, uint32_t height);
+
+
+
+/**
+ * Record the composite subpass, to be called just before ending the renderpass.
+ *
+ * @param oit the OIT resources
+ * @param cmds the command buffers
+ * @param idx the command buffer index
+ * @param width the framebuffer width
+ * @param height the framebuffer height
+ */
+void dvz_oit_composite(
+    DvzOit* oit, DvzCommands* cmds, uint32_t idx, uint32_t width, uint32_t height);
+
+
+
+/**
+ * Destroy the order-independent transparency resources of a canvas.
+ *
+ * @param oit the OIT resources
+ */
+void dvz_oit_destroy(DvzOit* oit);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Picking                                                                                      */
+/*************************************************************************************************/
+
+/*
+Canvases created with DVZ_CANVAS_FLAGS_PICK have an additional integer color attachment. Visuals
+created with DVZ_VISUAL_FLAGS_PICK write (visual pick id, item index) into it, the other visuals
+leave it cleared to zero.
+
+Picking is asynchronous: dvz_canvas_pick() copies the small region around the requested position
+from the pick attachment of the last rendered frame to a host-visible staging image, on the
+render queue so that the copy is ordered against the frames rendering into the same attachment,
+and dvz_canvas_picked() polls for the result without ever waiting on the GPU.
+*/
+
+#ifndef DVZ_HEADER_PICK
+#define DVZ_HEADER_PICK
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_enums.h"
+#include "datoviz_types.h"
+#include "vklite.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_PICK_MAX_RADIUS   16
+#define DVZ_PICK_STAGING_SIZE (2 * DVZ_PICK_MAX_RADIUS + 1)
+
+
+
+/*************************************************************************************************/
+/*  Enums                                                                                        */
+/*************************************************************************************************/
+
+typedef enum
+{
+    DVZ_PICK_STATUS_IDLE,      // no pick in progress
+    DVZ_PICK_STATUS_REQUESTED, // waiting for the last frame to finish rendering
+    DVZ_PICK_STATUS_PENDING,   // the copy has been submitted to the render queue
+} DvzPickStatus;
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzPicker DvzPicker;
+
+// Forward declarations.
+typedef struct DvzCanvas DvzCanvas;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzPicker
+{
+    DvzImages image;   // pick attachment, one image per framebuffer
+    DvzImages staging; // host-visible copy of the region around the picked position
+    DvzCommands cmds;  // transfer commands, one command buffer per pick image
+    DvzSubmit submit;
+    DvzFences fence;
+    DvzPickStatus status;
+
+    int32_t x, y;    // last requested position
+    uint32_t radius; // last requested radius
+    bool queued;     // whether a request arrived while a copy was pending
+
+    uint32_t img_idx;       // index of the pick image being copied
+    ivec2 center;           // position of the submitted request
+    uint32_t center_radius; // radius of the submitted request
+    ivec2 offset;           // top-left corner of the copied region in the pick image
+    uvec2 shape;            // size of the copied region
+    ivec4* data;            // CPU copy of the staging image
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Picker                                                                                       */
+/*************************************************************************************************/
+
+/**
+ * Create the pick images of a canvas.
+ *
+ * @param gpu the GPU
+ * @param picker the picker
+ * @param img_count the number of framebuffers of the canvas
+ * @param width the framebuffer width
+ * @param height the framebuffer height
+ */
+void dvz_picker(
+    DvzGpu* gpu, DvzPicker* picker, uint32_t img_count, uint32_t width, uint32_t height);
+
+
+
+/**
+ * Resize the pick images, cancelling any pick in progress.
+ *
+ * @param picker the picker
+ * @param width the new framebuffer width
+ * @param height the new framebuffer height
+ */
+void dvz_picker_resize(DvzPicker* picker, uint32_t width, uint32_t height);
+
+
+
+/**
+ * Destroy the pick images of a canvas.
+ *
+ * @param picker the picker
+ */
+void dvz_picker_destroy(DvzPicker* picker);
+
+
+
+/*************************************************************************************************/
+/*  Canvas picking                                                                               */
+/*************************************************************************************************/
+
+/**
+ * Request the visual item closest to a position, within a radius.
+ *
+ * This function never waits on the GPU. The result is retrieved with dvz_canvas_picked(). A new
+ * request replaces the previous one if it has not been submitted yet.
+ *
+ * @param canvas the canvas, created with DVZ_CANVAS_FLAGS_PICK
+ * @param x the x framebuffer coordinate
+ * @param y the y framebuffer coordinate
+ * @param radius the search radius, in framebuffer pixels, at most DVZ_PICK_MAX_RADIUS
+ */
+void dvz_canvas_pick(DvzCanvas* canvas, int32_t x, int32_t y, uint32_t radius);
+
+
+
+/**
+ * Poll the result of the last pick request.
+ *
+ * @param canvas the canvas
+ * @param[out] pick the result, with a zero visual id if nothing was found within the radius
+ * @returns whether the result is available
+ */
+bool dvz_canvas_picked(DvzCanvas* canvas, DvzPick* pick);
+
+
+
+/**
+ * Find the closest non-empty pixel of a pick image region.
+ *
+ * @param width the region width
+ * @param height the region height
+ * @param data the region pixels, as (visual id, item index, 0, 0)
+ * @param x the x coordinate of the center, relative to the region
+ * @param y the y coordinate of the center, relative to the region
+ * @param radius the search radius
+ * @param[out] pick the closest hit, with coordinates relative to the region
+ * @returns whether a non-empty pixel was found within the radius
+ */
+bool dvz_pick_closest(
+    uint32_t width, uint32_t height, ivec4* data, int32_t x, int32_t y, uint32_t radius,
+    DvzPick* pick);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -124,7 +124,9 @@ DvzGraphics* dvz_pipe_graphics(DvzPipe* pipe);
  * Setup a compute pipe.
  *
  * @param pipe the pipe
- * @param compute the compute
+ * @param shader_path the path to the .spv shader file, or NULL if the shader is set later with
+ *      dvz_compute_code() or dvz_compute_spirv()
+ * @returns the compute
  */
 DvzCompute* dvz_pipe_compute(DvzPipe* pipe, const char* shader_path);
 
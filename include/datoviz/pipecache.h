@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Pipe cache                                                                                   */
+/*************************************************************************************************/
+
+/*
+Shares identical Vulkan objects between graphics pipes: shader modules are keyed by their SPIR-V
+code, and pipelines by a serialization of their whole state. The keys are looked up by hash and
+compared in full, so that a hash collision never returns a different object. Each entry is
+reference-counted, and the caller destroys the Vulkan object when the last reference is released.
+*/
+
+#ifndef DVZ_HEADER_PIPECACHE
+#define DVZ_HEADER_PIPECACHE
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "_macros.h"
+
+
+
+/*************************************************************************************************/
+/*  Enums                                                                                        */
+/*************************************************************************************************/
+
+typedef enum
+{
+    DVZ_PIPECACHE_MODULE,   // VkShaderModule, keyed by the SPIR-V code
+    DVZ_PIPECACHE_PIPELINE, // VkPipeline, keyed by the serialized pipeline state
+    DVZ_PIPECACHE_COUNT,
+} DvzPipeCacheType;
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzPipeCache DvzPipeCache;
+typedef struct DvzPipeCacheStats DvzPipeCacheStats;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzPipeCacheStats
+{
+    uint64_t count;  // number of objects in the cache
+    uint64_t refs;   // total number of references to these objects
+    uint64_t hits;   // number of lookups that returned an existing object
+    uint64_t misses; // number of lookups that did not
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Create a pipe cache.
+ *
+ * @returns the pipe cache
+ */
+DvzPipeCache* dvz_pipecache(void);
+
+
+
+/**
+ * Look up an object in the cache, and add a reference to it if it exists.
+ *
+ * @param cache the pipe cache
+ * @param type the object type
+ * @param size the size of the key, in bytes
+ * @param key the key describing the object contents
+ * @returns the Vulkan handle of the object, or 0 if it is not in the cache
+ */
+uint64_t
+dvz_pipecache_get(DvzPipeCache* cache, DvzPipeCacheType type, size_t size, const void* key);
+
+
+
+/**
+ * Add a newly-created object to the cache, with a single reference.
+ *
+ * @param cache the pipe cache
+ * @param type the object type
+ * @param size the size of the key, in bytes
+ * @param key the key describing the object contents, copied in the cache
+ * @param handle the Vulkan handle of the object
+ */
+void dvz_pipecache_put(
+    DvzPipeCache* cache, DvzPipeCacheType type, size_t size, const void* key, uint64_t handle);
+
+
+
+/**
+ * Release a reference to an object.
+ *
+ * The caller must destroy the Vulkan object if this function returns 0 (last reference) or -1
+ * (the object was not created through the cache).
+ *
+ * @param cache the pipe cache
+ * @param type the object type
+ * @param handle the Vulkan handle of the object
+ * @returns the number of remaining references, or -1 if the object is not in the cache
+ */
+int64_t dvz_pipecache_release(DvzPipeCache* cache, DvzPipeCacheType type, uint64_t handle);
+
+
+
+/**
+ * Return the statistics of the cache for a given object type.
+ *
+ * @param cache the pipe cache
+ * @param type the object type
+ * @returns the statistics
+ */
+DvzPipeCacheStats dvz_pipecache_stats(DvzPipeCache* cache, DvzPipeCacheType type);
+
+
+
+/**
+ * Destroy a pipe cache.
+ *
+ * All objects must have been released before.
+ *
+ * @param cache the pipe cache
+ */
+void dvz_pipecache_destroy(DvzPipeCache* cache);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -18,6 +18,7 @@
 /*************************************************************************************************/
 
 #include "pipe.h"
+#include "pipecache.h"
 #include "scene/graphics.h"
 
 
@@ -60,6 +61,7 @@ struct DvzPipelib
     DvzContainer graphics;
     DvzContainer computes;
     DvzContainer shaders;
+    DvzPipeCache* cache; // shader modules and pipelines shared between the graphics
 };
 
 
@@ -106,6 +108,17 @@ DvzPipe* dvz_pipelib_compute_file(DvzPipelib* lib, const char* shader_path);
 
 
 
+/**
+ * Create a new compute from a compute shader of the pipelib.
+ *
+ * @param lib the pipelib instance
+ * @param shader the compute shader (GLSL or SPIR-V)
+ * @returns the pipe
+ */
+DvzPipe* dvz_pipelib_compute(DvzPipelib* lib, DvzShader* shader);
+
+
+
 /**
  * Create a new shader.
  *
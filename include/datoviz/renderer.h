@@ -56,8 +56,9 @@ struct DvzRenderer
     DvzPipelib* pipelib;     // GLSL programs: the "how"
     DvzWorkspace* workspace; // boards and canvases: the "where"
     DvzContainer shaders;
-    DvzMap* map;       // mapping between uuid and <type, objects>
-    DvzRouter* router; // mapping between pairs (action, obj_type) and functions
+    DvzMap* map;              // mapping between uuid and <type, objects>
+    DvzRouter* router;        // mapping between pairs (action, obj_type) and functions
+    DvzCommands cmds_compute; // lazily allocated on the compute queue for compute dispatches
 };
 
 
@@ -172,6 +173,32 @@ uint8_t* dvz_renderer_image(DvzRenderer* rd, DvzId canvas_id, DvzSize* size, uin
 
 
 
+/**
+ * Poll the result of the last pick request of a canvas, without waiting on the GPU.
+ *
+ * @param rd the renderer
+ * @param canvas_id the id of the canvas
+ * @param[out] pick the closest visual item, with a zero visual id if there was none
+ * @returns whether the result is available
+ */
+bool dvz_renderer_pick(DvzRenderer* rd, DvzId canvas_id, DvzPick* pick);
+
+
+
+/**
+ * Defragment the shared GPU buffers and shrink them to fit their dats.
+ *
+ * This is a slow operation (hard GPU sync) meant to be called occasionally, for example after
+ * many visuals have been deleted. The dats are packed with GPU-side copies, the descriptors of
+ * the pipes are updated, and the command buffers are recorded again.
+ *
+ * @param rd the renderer
+ * @returns the total size of the shared buffers after compaction
+ */
+DvzSize dvz_renderer_compact(DvzRenderer* rd);
+
+
+
 /**
  * Destroy a renderer.
  *
@@ -31,6 +31,9 @@
 
 #define DVZ_BUFFER_DEFAULT_SIZE (1 * 1024 * 1024)
 
+// Number of full-size staging copies of a streaming tex.
+#define DVZ_TEX_STREAMING_RING 3
+
 
 
 /*************************************************************************************************/
@@ -86,6 +89,13 @@ struct DvzTex
 
     DvzDat* stg; // used for persistent staging, resized when the tex is resized
 
+    // Streaming texs: persistently-mapped staging ring, each upload is written to the next
+    // segment and copied to the image at the next frame.
+    DvzDat* ring;
+    uint32_t ring_head;    // next segment to write to
+    uint32_t ring_used;    // segments written since the pending copies were last processed
+    uint64_t ring_flushes; // value of DvzTransfers.flushes when ring_used was reset
+
     // HACK: pointer to use the DvzTex as an image in Dear ImGui.
     VkDescriptorSet _imgui_texid;
 };
@@ -217,7 +227,9 @@ DvzDat* dvz_dat(DvzContext* ctx, DvzBufferType type, DvzSize size, int flags);
  * Resize a dat.
  *
  * !!! note
- *     Not implemented yet: deciding whether the existing data should be kept or not upon resizing.
+ *     The existing data is only kept if the dat was created with `DVZ_DAT_FLAGS_KEEP_ON_RESIZE`.
+ *     In that case, the contents are copied on the GPU, and the dat reserves some capacity (see
+ *     `dvz_alloc_capacity()`) so that repeatedly growing it only reallocates it rarely.
  *
  * !!! important
  *     Must be called from the main thread.
@@ -126,6 +126,57 @@ DvzTexture* dvz_atlas_texture(DvzAtlas* atlas, DvzBatch* batch);
 
 
 
+/*************************************************************************************************/
+/*  Dynamic atlas                                                                                */
+/*************************************************************************************************/
+
+/**
+ * Switch the atlas to dynamic mode, where glyphs are generated on demand.
+ *
+ * The glyphs of an existing atlas (generated or imported) are kept in place.
+ *
+ * @param atlas the atlas
+ */
+void dvz_atlas_dynamic(DvzAtlas* atlas);
+
+
+
+/**
+ * Generate and pack the glyphs of a dynamic atlas that are not there yet, growing it if needed.
+ *
+ * @param atlas the atlas
+ * @param count the number of code points
+ * @param codepoints the Unicode code points
+ * @returns the number of glyphs that were inserted
+ */
+uint32_t dvz_atlas_insert(DvzAtlas* atlas, uint32_t count, uint32_t* codepoints);
+
+
+
+/**
+ * Upload the regions of a dynamic atlas that changed since the last upload to its texture.
+ *
+ * The texture is the one last returned by `dvz_atlas_texture()`.
+ *
+ * @param atlas the atlas
+ * @returns 1 if the texture was resized (normalized texture coordinates computed before then are
+ * stale, the glyph visuals store theirs in pixels and are not affected), 0 otherwise, -1 if the
+ * atlas has no texture
+ */
+int dvz_atlas_upload(DvzAtlas* atlas);
+
+
+
+/**
+ * Return whether the atlas is dynamic.
+ *
+ * @param atlas the atlas
+ * @returns whether the atlas is dynamic
+ */
+bool dvz_atlas_is_dynamic(DvzAtlas* atlas);
+
+
+
 /*************************************************************************************************/
 /*  File util functions                                                                          */
 /*************************************************************************************************/
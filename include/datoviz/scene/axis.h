@@ -24,6 +24,15 @@
 
 
 
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_AXIS_LABEL_SIZE  32  // maximum size of a cached tick label, with the trailing zero
+#define DVZ_AXIS_LABEL_CACHE 256 // maximum number of tick label layouts in the cache
+
+
+
 /*************************************************************************************************/
 /*  Typedefs                                                                                     */
 /*************************************************************************************************/
@@ -31,6 +40,9 @@
 typedef struct DvzAxis DvzAxis;
 typedef struct DvzAxisSpec DvzAxisSpec;
 typedef struct DvzLayout DvzLayout;
+typedef struct DvzAxisLabel DvzAxisLabel;
+typedef struct DvzAxisSlot DvzAxisSlot;
+typedef struct DvzAxisGlyphs DvzAxisGlyphs;
 
 // Forward declarations.
 typedef struct DvzVisual DvzVisual;
@@ -77,6 +89,53 @@ struct DvzLayout
 
 
 
+// Cached layout of a tick label.
+struct DvzAxisLabel
+{
+    char text[DVZ_AXIS_LABEL_SIZE];
+    uint32_t glyph_count;
+    vec4* xywh;
+    vec4* texcoords;   // normalized, only valid for the atlas shape below
+    uvec2 atlas_shape; // shape of the atlas when the layout was computed
+    uint64_t last_used;
+};
+
+
+
+// Range of glyphs of the tick label visual, holding one tick label.
+struct DvzAxisSlot
+{
+    char text[DVZ_AXIS_LABEL_SIZE]; // empty if the slot is hidden
+    vec3 pos;
+    uint32_t first;
+    uint32_t capacity;
+    bool used; // whether the slot holds one of the current tick labels
+};
+
+
+
+// Tick label glyphs: LRU cache of label layouts, and glyph slots reused across tick updates.
+struct DvzAxisGlyphs
+{
+    DvzAxisLabel labels[DVZ_AXIS_LABEL_CACHE];
+    uint32_t label_count;
+    uint64_t clock; // incremented at every cache lookup, for the LRU eviction
+
+    DvzAxisSlot* slots;
+    uint32_t slot_count;
+    uint32_t glyph_count; // number of glyphs allocated in the visual
+    vec2 offset;          // offset and anchor the slots were written with
+    vec2 anchor;
+
+    // Statistics.
+    uint64_t hits;    // labels whose layout was found in the cache
+    uint64_t misses;  // labels that had to be laid out
+    uint64_t reused;  // labels kept in place across tick updates
+    uint64_t written; // labels written to the visual
+};
+
+
+
 struct DvzAxis
 {
     DvzAxisSpec spec;
@@ -92,6 +151,7 @@ struct DvzAxis
     DvzVisual* spine;   // spine
 
     DvzTicks* ticks;
+    DvzAxisGlyphs tick_glyphs;
     DvzPanel* panel; // HACK: avoid putting an axis several times to a given panel
 
     DvzDim dim;
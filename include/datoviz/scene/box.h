@@ -177,6 +177,22 @@ void dvz_box_inverse(DvzBox source, DvzBox target, vec3 pos, dvec3* out);
 
 
 
+/**
+ * Return whether a box intersects the viewport once transformed by an MVP.
+ *
+ * The test is conservative: the box is culled only if its eight corners are all outside of the
+ * same clipping plane, in clip coordinates and with the margins of the viewport.
+ *
+ * @param box the box, in the coordinate system of the positions passed to the MVP
+ * @param mvp the MVP
+ * @param viewport the viewport
+ * @param margin a margin around the box, in pixels, for the extent of the items (marker size...)
+ * @returns whether the box may be visible
+ */
+bool dvz_box_visible(DvzBox box, DvzMVP* mvp, DvzViewport* viewport, float margin);
+
+
+
 /**
  * Display information about a box.
  */
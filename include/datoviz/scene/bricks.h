@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Bricks                                                                                        */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_BRICKS
+#define DVZ_HEADER_BRICKS
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_enums.h"
+#include "_obj.h"
+#include "datoviz_types.h"
+#include "pool.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_BRICKS_MAX_LEVELS   16 // NOTE: the level is encoded in 4 bits in the indirection
+#define DVZ_BRICKS_MAX_PENDING  64 // maximum number of bricks being loaded at the same time
+#define DVZ_BRICKS_MAX_POOL     2048
+#define DVZ_BRICKS_APRON        1 // number of border voxels stored around each brick in the pool
+#define DVZ_BRICKS_DEFAULT_SIZE 32
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzBricks DvzBricks;
+
+// Forward declarations.
+typedef struct DvzBatch DvzBatch;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzBricks
+{
+    DvzObject obj;
+    DvzBatch* batch;
+
+    DvzFormat format;
+    DvzSize item_size;
+    uvec3 shape;         // volume shape at level 0, in voxels
+    uint32_t brick_size; // B, brick size in voxels without the apron
+    int flags;
+
+    // Multiresolution: level L is the volume subsampled by a factor 2^L, the last level has a
+    // single brick.
+    uint32_t level_count;
+    uvec3 grids[DVZ_BRICKS_MAX_LEVELS];      // number of bricks along each axis, per level
+    uint32_t offsets[DVZ_BRICKS_MAX_LEVELS]; // index of the first brick of each level
+    uint32_t brick_count;                    // total number of bricks, across all levels
+
+    // Brick pool: the bricks are empty when all their voxels are zero.
+    uvec3 pool;        // shape of the pool, in bricks
+    uint32_t capacity; // number of slots in the pool
+    DvzPool* cache;    // state and slot of each brick, and brick loader thread
+
+    // Bricks selected for display at the last update.
+    uint32_t* selection;
+    uint32_t selection_count;
+
+    // Indirection table: for each level-0 brick, the finest resident brick covering it.
+    float* indirection;
+    bool dirty;
+
+    // GPU objects.
+    DvzId atlas_tex;
+    DvzId atlas_sampler;
+    DvzId indirection_tex;
+    DvzId indirection_sampler;
+
+    // Brick source.
+    DvzBricksCallback callback;
+    void* user_data;
+    void* mmap;
+    DvzSize mmap_size;
+    DvzSize mmap_offset;
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Create the brick pool and the indirection textures, if they are not already created.
+ *
+ * @param bricks the bricks
+ */
+void dvz_bricks_create(DvzBricks* bricks);
+
+
+
+/**
+ * Return the index of a brick.
+ *
+ * @param bricks the bricks
+ * @param level the level
+ * @param ijk the brick coordinates within the level
+ * @returns the brick index
+ */
+uint32_t dvz_bricks_index(DvzBricks* bricks, uint32_t level, uvec3 ijk);
+
+
+
+/**
+ * Load a brick synchronously, with its apron, from the file or callback.
+ *
+ * @param bricks the bricks
+ * @param level the level
+ * @param ijk the brick coordinates within the level
+ * @param[out] out buffer with (B+2)^3 items
+ * @returns whether all voxels of the brick are zero
+ */
+bool dvz_bricks_fetch(DvzBricks* bricks, uint32_t level, uvec3 ijk, uint8_t* out);
+
+
+
+EXTERN_C_OFF
+
+#endif
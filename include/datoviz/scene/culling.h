@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Culling                                                                                       */
+/*************************************************************************************************/
+
+/*
+GPU-driven culling of the items of point-like visuals (markers, spheres, glyphs).
+
+A compute kernel (`src/scene/glsl/kernel_cull.comp`) tests each item against the viewport, using
+the same MVP and viewport dats as the graphics pipe, and an optional minimum item size. It writes
+the vertex indices of the visible items into a compacted index dat, and their count into a
+DvzDrawIndexedIndirectCommand, so that the visual is drawn with an indexed indirect draw that
+only processes the visible items.
+
+The kernel is recorded in the command buffers of the canvas, before its renderpass, so that it
+runs at every frame with the current MVP and viewport, without waiting for the frames in flight.
+
+The position of an item is the vec3 attribute of its first vertex, the vertex indices of an item
+are its first vertex plus a fixed pattern (for example 0, 1, 2, 0, 2, 3 for the quads of the
+glyphs). Each workgroup compacts its items in order and reserves its range of the output with a
+single atomic operation, so the order of the items is preserved within a workgroup but not
+across workgroups.
+
+The CPU reference implementation dvz_culling_items() has the same semantics and preserves the
+order of the items.
+
+Bindings of the kernel:
+
+binding | type    | contents
+------- | ------- | ------------------------------------------------
+0       | uniform | DvzCullingParams
+1       | uniform | DvzMVP
+2       | uniform | DvzViewport
+3       | storage | vertices, read as floats
+4       | storage | compacted indices, DvzIndex
+5       | storage | DvzDrawIndexedIndirectCommand, its count reset before each dispatch
+*/
+
+#ifndef DVZ_HEADER_CULLING
+#define DVZ_HEADER_CULLING
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_enums.h"
+#include "datoviz_types.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_CULLING_MAX_INDICES 8 // maximum number of vertex indices per item
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzCulling DvzCulling;
+typedef struct DvzCullingParams DvzCullingParams;
+
+// Forward declarations.
+typedef struct DvzBatch DvzBatch;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// NOTE: must match the params block of the kernel_cull.comp shader (std140).
+struct DvzCullingParams
+{
+    uint32_t first;        // first item
+    uint32_t count;        // number of items
+    uint32_t stride;       // vertex stride, in floats
+    uint32_t pos_offset;   // offset of the vec3 position in the vertex, in floats
+    int32_t size_offset;   // offset of the float item size (pixels) in the vertex, -1 if none
+    uint32_t vertex_count; // number of vertices per item
+    uint32_t index_count;  // number of vertex indices per item, at most DVZ_CULLING_MAX_INDICES
+    float margin;          // margin around the viewport, in pixels
+    float min_size;        // items with a smaller size are culled, 0 to disable
+    uint32_t _pad[3];
+    uint32_t pattern[DVZ_CULLING_MAX_INDICES]; // vertex indices of an item, from its first vertex
+};
+
+
+
+struct DvzCulling
+{
+    DvzBatch* batch;
+    DvzId shader;
+    DvzId compute;
+    DvzId params;   // uniform dat with the DvzCullingParams
+    DvzId indices;  // index dat with the compacted indices
+    DvzId indirect; // indirect dat with the DvzDrawIndexedIndirectCommand
+    uint32_t capacity;
+
+    DvzCullingParams p;
+    bool dirty; // whether the bindings and params need to be updated
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  GPU culling                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Create the GPU objects of the culling kernel: its shader, compute pipe, slots and dats.
+ *
+ * @param batch the batch
+ * @returns the culling object
+ */
+DvzCulling* dvz_culling(DvzBatch* batch);
+
+
+
+/**
+ * Bind the MVP, viewport and vertex dats of the culled visual.
+ *
+ * @param culling the culling object
+ * @param mvp the uniform dat with the DvzMVP
+ * @param viewport the uniform dat with the DvzViewport
+ * @param vertex the vertex dat with the positions
+ */
+void dvz_culling_bind(DvzCulling* culling, DvzId mvp, DvzId viewport, DvzId vertex);
+
+
+
+/**
+ * Make sure the compacted index dat can hold the indices of a number of items.
+ *
+ * @param culling the culling object
+ * @param item_count the number of items
+ */
+void dvz_culling_alloc(DvzCulling* culling, uint32_t item_count);
+
+
+
+/**
+ * Upload the culling params.
+ *
+ * @param culling the culling object, with the params in culling->p
+ */
+void dvz_culling_update(DvzCulling* culling);
+
+
+
+/**
+ * Record the dispatch of the culling kernel in the command buffers of a canvas.
+ *
+ * @param culling the culling object
+ * @param canvas_id the id of the canvas
+ */
+void dvz_culling_record(DvzCulling* culling, DvzId canvas_id);
+
+
+
+/**
+ * Destroy the culling object and delete its GPU objects.
+ *
+ * @param culling the culling object
+ */
+void dvz_culling_destroy(DvzCulling* culling);
+
+
+
+/*************************************************************************************************/
+/*  CPU reference                                                                                */
+/*************************************************************************************************/
+
+/**
+ * Return whether an item is visible.
+ *
+ * @param params the culling params
+ * @param mvp the MVP
+ * @param viewport the viewport
+ * @param vertex the first vertex of the item
+ * @returns whether the item is visible
+ */
+bool dvz_culling_visible(
+    DvzCullingParams* params, DvzMVP* mvp, DvzViewport* viewport, const float* vertex);
+
+
+
+/**
+ * Write the vertex indices of the visible items, in order.
+ *
+ * @param params the culling params
+ * @param mvp the MVP
+ * @param viewport the viewport
+ * @param vertices the vertices, params->stride floats per vertex
+ * @param[out] indices the compacted indices, params->count * params->index_count items at most
+ * @returns the number of indices written
+ */
+uint32_t dvz_culling_items(
+    DvzCullingParams* params, DvzMVP* mvp, DvzViewport* viewport, const float* vertices,
+    DvzIndex* indices);
+
+
+
+EXTERN_C_OFF
+
+#endif
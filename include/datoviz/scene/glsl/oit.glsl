@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+// Weighted blended order-independent transparency (DVZ_BLEND_OIT, McGuire and Bavoil 2013): on
+// canvases created with DVZ_CANVAS_FLAGS_OIT, the fragment shader also writes the weighted
+// premultiplied color into the accum attachment, and its alpha into the reveal attachment. The
+// composite subpass of the canvas renderpass resolves them onto the color attachment.
+
+#define DVZ_SPECIALIZATION_OIT 20
+
+layout(constant_id = DVZ_SPECIALIZATION_OIT) const int OIT = 0;
+
+layout(location = 2) out vec4 out_accum;
+layout(location = 3) out float out_reveal;
+
+// NOTE: must be called once the final color is known, at the end of the fragment shader.
+void oit_write(vec4 color)
+{
+    if (OIT == 0)
+        return;
+    float a = color.a;
+    // Depth weight, favoring the closest fragments, and avoiding the float16 range limits.
+    float z = gl_FragCoord.z;
+    float w = pow(min(1.0, a * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - z * 0.9, 3.0);
+    w = clamp(w, 1e-2, 3e3);
+    out_accum = vec4(color.rgb * a, a) * w;
+    out_reveal = a;
+}
@@ -8,5 +8,6 @@ layout(std140, binding = USER_BINDING) uniform GlyphParams
 {
     vec2 size; // glyph size in pixels
     vec4 bgcolor;
+    int pixel_texcoords; // whether the texture coordinates are in pixels rather than normalized
 }
 params;
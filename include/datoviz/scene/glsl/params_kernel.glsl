@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+// Common layout of the compute kernels of the scene (see scene/kernels.h): one-dimensional
+// workgroups, and the DvzKernelParams uniform at binding 0.
+
+#define KERNEL_GROUP_SIZE 256 // DVZ_KERNEL_GROUP_SIZE
+
+#define KERNEL_PASS_CLEAR      0
+#define KERNEL_PASS_ACCUMULATE 1
+#define KERNEL_PASS_FINALIZE   2
+
+layout(local_size_x = KERNEL_GROUP_SIZE, local_size_y = 1, local_size_z = 1) in;
+
+layout(std140, binding = 0) uniform KernelParams
+{
+    uint count;
+    uint count2;
+    uint pass;
+    int closed;
+    vec2 range;
+}
+params;
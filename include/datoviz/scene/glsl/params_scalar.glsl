@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+// Scalar color mode (DVZ_VISUAL_FLAGS_SCALAR): the color attribute holds a single float, read as
+// (value, 0, 0, 1), and mapped to a color with a colormap. SCALAR_BINDING must be defined, and
+// colormaps.glsl included, before including this file.
+//
+// The colormap params are only declared in the shader variants compiled with SCALAR_COLOR
+// defined (<name>_scalar.vert.spv), so that the default shaders do not need the params slot.
+
+#ifdef SCALAR_COLOR
+
+layout(std140, binding = SCALAR_BINDING) uniform ScalarParams
+{
+    vec2 range; // vmin, vmax
+    int cmap;
+}
+scalar;
+
+vec4 scalar_color(vec4 color)
+{
+    float d = scalar.range.y - scalar.range.x;
+    float x = d != 0 ? (color.x - scalar.range.x) / d : 0;
+    return colormap(scalar.cmap, x);
+}
+
+#else
+
+vec4 scalar_color(vec4 color) { return color; }
+
+#endif
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+// Picking (DVZ_VISUAL_FLAGS_PICK): the fragment shader writes (visual pick id, item index) into
+// the pick attachment of the canvas. PICK_LOCATION must be defined before including this file,
+// as well as PICK_VERTEX in the vertex shader, which passes the item index with pick_item.
+
+#define DVZ_SPECIALIZATION_PICK 19
+
+#ifdef PICK_VERTEX
+
+layout(location = PICK_LOCATION) flat out int pick_item;
+
+#else
+
+layout(constant_id = DVZ_SPECIALIZATION_PICK) const int PICK_ID = 0;
+
+layout(location = PICK_LOCATION) flat in int pick_item;
+layout(location = 1) out ivec4 out_pick;
+
+// NOTE: must be called before any early return of the fragment shader.
+void pick_write() { out_pick = ivec4(PICK_ID, pick_item, 0, 0); }
+
+#endif
@@ -14,6 +14,9 @@
 #define VOLUME_DIR_FRONT_BACK 0
 #define VOLUME_DIR_BACK_FRONT 1
 
+#define VOLUME_STORAGE_DENSE   0
+#define VOLUME_STORAGE_BRICKED 1
+
 
 vec4 fetch_color(ivec2 modes, sampler3D tex_density, vec3 uvw, vec4 transfer)
 {
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Kernels                                                                                       */
+/*************************************************************************************************/
+
+/*
+Compute kernels for the heaviest baking steps of the scene: path neighbour expansion, vertex
+normals, min/max reduction and histogramming.
+
+Each kernel has a GPU implementation, a compute shader in `src/scene/glsl/kernel_*.comp` run
+through the compute requests of the protocol, and a CPU reference implementation with the exact
+same semantics, used when no GPU is available and to test the GPU kernels.
+
+All kernels are one-dimensional, with DVZ_KERNEL_GROUP_SIZE invocations per workgroup. Binding 0
+is a uniform buffer with the DvzKernelParams of the dispatch, the other bindings are storage
+buffers (the path offsets are the cumulative path lengths, path_count + 1 items starting at 0):
+
+kernel          | binding 1                  | binding 2             | binding 3
+--------------- | -------------------------- | --------------------- | ------------------------
+path neighbours | positions, 3 floats/point  | path offsets, uint    | p0, p1, p2, p3 arrays
+normals         | positions, 3 floats/vertex | indices, uint         | normals, 3 floats/vertex
+min/max         | values, float              | partials, vec2/group  |
+histogram       | values, float              | bins, uint            |
+
+The normals and histogram kernels are multipass (see DvzKernelPass): they accumulate with
+integer atomics in their output buffer, so their result does not depend on the execution order.
+*/
+
+#ifndef DVZ_HEADER_KERNELS
+#define DVZ_HEADER_KERNELS
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_enums.h"
+#include "datoviz_types.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_KERNEL_GROUP_SIZE 256 // must match local_size_x in the kernel shaders
+
+// Fixed-point scale of the normals accumulated with integer atomics: a vertex can be shared by
+// up to 2^31 / DVZ_KERNEL_NORMAL_SCALE faces.
+#define DVZ_KERNEL_NORMAL_SCALE 65536.0f
+
+
+
+/*************************************************************************************************/
+/*  Enums                                                                                        */
+/*************************************************************************************************/
+
+typedef enum
+{
+    DVZ_KERNEL_NONE,
+    DVZ_KERNEL_PATH,      // path neighbour expansion
+    DVZ_KERNEL_NORMALS,   // vertex normals
+    DVZ_KERNEL_MIN_MAX,   // per-workgroup min/max reduction
+    DVZ_KERNEL_HISTOGRAM, // histogram with a fixed range
+    DVZ_KERNEL_COUNT,
+} DvzKernelType;
+
+
+
+typedef enum
+{
+    DVZ_KERNEL_PASS_CLEAR,      // reset the accumulation buffer
+    DVZ_KERNEL_PASS_ACCUMULATE, // accumulate, one invocation per face (normals) or value
+    DVZ_KERNEL_PASS_FINALIZE,   // normalize the accumulated normals in place
+} DvzKernelPass;
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzKernel DvzKernel;
+typedef struct DvzKernelParams DvzKernelParams;
+
+// Forward declarations.
+typedef struct DvzBatch DvzBatch;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// NOTE: must match the params block of the kernel shaders (std140).
+struct DvzKernelParams
+{
+    uint32_t count;  // number of points, vertices or values
+    uint32_t count2; // number of paths (path), indices (normals) or bins (histogram)
+    uint32_t pass;   // DvzKernelPass, for the multipass kernels
+    int32_t closed;  // whether the paths are closed (path)
+    vec2 range;      // value range of the bins (histogram)
+};
+
+
+
+struct DvzKernel
+{
+    DvzBatch* batch;
+    DvzKernelType type;
+    DvzId shader;
+    DvzId compute;
+    DvzId params; // uniform dat with the DvzKernelParams
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  GPU kernels                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Create a GPU kernel: its shader, its compute pipe, its slots and its params dat.
+ *
+ * @param batch the batch
+ * @param type the kernel type
+ * @returns the kernel
+ */
+DvzKernel dvz_kernel(DvzBatch* batch, DvzKernelType type);
+
+
+
+/**
+ * Bind a storage dat to a binding of the kernel.
+ *
+ * @param kernel the kernel
+ * @param slot_idx the binding index, from 1 (see the table at the top of this file)
+ * @param dat the storage dat
+ */
+void dvz_kernel_bind(DvzKernel* kernel, uint32_t slot_idx, DvzId dat);
+
+
+
+/**
+ * Upload the params and dispatch the kernel over a number of items.
+ *
+ * @param kernel the kernel
+ * @param params the kernel params
+ * @param item_count the number of invocations (points, faces, values or bins)
+ */
+void dvz_kernel_run(DvzKernel* kernel, DvzKernelParams* params, uint32_t item_count);
+
+
+
+/**
+ * Return the number of workgroups covering a number of items.
+ *
+ * @param item_count the number of items
+ * @returns the number of workgroups
+ */
+uint32_t dvz_kernel_group_count(uint32_t item_count);
+
+
+
+/**
+ * Delete the GPU objects of a kernel.
+ *
+ * @param kernel the kernel
+ */
+void dvz_kernel_destroy(DvzKernel* kernel);
+
+
+
+/*************************************************************************************************/
+/*  CPU reference kernels                                                                        */
+/*************************************************************************************************/
+
+/**
+ * Expand the points of a set of paths into their four neighbours (previous, current, next,
+ * next-next), as required by the path visual.
+ *
+ * @param point_count the total number of points
+ * @param positions the point positions
+ * @param path_count the number of paths
+ * @param path_lengths the number of points of each path
+ * @param closed whether the paths are closed
+ * @param[out] p0 the previous points, point_count items
+ * @param[out] p1 the current points, point_count items
+ * @param[out] p2 the next points, point_count items
+ * @param[out] p3 the next-next points, point_count items
+ */
+void dvz_kernel_path(
+    uint32_t point_count, const vec3* positions, uint32_t path_count,
+    const uint32_t* path_lengths, bool closed, vec3* p0, vec3* p1, vec3* p2, vec3* p3);
+
+
+
+/**
+ * Compute the vertex normals of a triangle mesh, as the normalized sum of the unit normals of
+ * the adjacent faces, accumulated in fixed point like the GPU kernel.
+ *
+ * @param vertex_count the number of vertices
+ * @param positions the vertex positions
+ * @param index_count the number of indices, a multiple of 3
+ * @param indices the indices
+ * @param[out] normals the vertex normals
+ */
+void dvz_kernel_normals(
+    uint32_t vertex_count, const vec3* positions, uint32_t index_count, const DvzIndex* indices,
+    vec3* normals);
+
+
+
+/**
+ * Compute the min and max of each workgroup of values, ignoring NaN values.
+ *
+ * A workgroup without any valid value has a min of +inf and a max of -inf.
+ *
+ * @param count the number of values
+ * @param values the values
+ * @param[out] partials the min and max of each group, dvz_kernel_group_count(count) items
+ */
+void dvz_kernel_min_max(uint32_t count, const float* values, vec2* partials);
+
+
+
+/**
+ * Reduce the partial min/max of the workgroups.
+ *
+ * @param group_count the number of workgroups
+ * @param partials the min and max of each group
+ * @param[out] min_max the min and max of all values, (+inf, -inf) if there is no valid value
+ */
+void dvz_kernel_min_max_reduce(uint32_t group_count, const vec2* partials, vec2 min_max);
+
+
+
+/**
+ * Count the values in regularly-spaced bins.
+ *
+ * The values outside of the range and the NaN values are ignored, the max value of the range
+ * falls in the last bin.
+ *
+ * @param count the number of values
+ * @param values the values
+ * @param range the min and max of the bins
+ * @param bin_count the number of bins
+ * @param[out] bins the number of values in each bin
+ */
+void dvz_kernel_histogram(
+    uint32_t count, const float* values, vec2 range, uint32_t bin_count, uint32_t* bins);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Pool                                                                                          */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_POOL
+#define DVZ_HEADER_POOL
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_atomic.h"
+#include "_enums.h"
+#include "datoviz_types.h"
+
+
+
+/*************************************************************************************************/
+/*  Enums                                                                                        */
+/*************************************************************************************************/
+
+typedef enum
+{
+    DVZ_POOL_STATE_UNLOADED,
+    DVZ_POOL_STATE_PENDING,  // requested to the loader thread
+    DVZ_POOL_STATE_RESIDENT, // stored in a slot of the pool
+    DVZ_POOL_STATE_EMPTY,    // loaded, without content to store in the pool
+} DvzPoolState;
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzPool DvzPool;
+typedef struct DvzPoolSlot DvzPoolSlot;
+typedef struct DvzPoolLoad DvzPoolLoad;
+typedef struct DvzPoolCandidate DvzPoolCandidate;
+
+// Forward declarations.
+typedef struct DvzThread DvzThread;
+typedef struct DvzFifo DvzFifo;
+
+// Called by the loader thread to fill the data of an item, return whether the item is empty.
+typedef bool (*DvzPoolFetch)(void* owner, uint32_t item, uint8_t* data);
+
+// Called by the main thread to upload the data of an item to a slot of the pool.
+typedef void (*DvzPoolUpload)(void* owner, uint32_t slot, uint8_t* data);
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzPoolSlot
+{
+    int64_t item;       // item index, or -1 if the slot is free
+    uint64_t last_used; // last frame at which the item was needed, for LRU eviction
+    bool pinned;        // the coarsest item is never evicted
+};
+
+
+
+struct DvzPoolLoad
+{
+    uint32_t item;
+    DvzAtomic cancelled; // set by the main thread when the item is no longer needed
+    bool empty;
+    uint8_t* data; // item data, NULL if the load was cancelled
+};
+
+
+
+struct DvzPoolCandidate
+{
+    double key;
+    uint32_t item;
+};
+
+
+
+struct DvzPool
+{
+    uint32_t item_count;
+    uint8_t* states;  // DvzPoolState, per item
+    int32_t* slots;   // slot of each item, -1 if not resident
+    uint64_t* stamps; // last frame at which the item was needed, for cancellation
+
+    uint32_t capacity; // number of slots
+    DvzPoolSlot* entries;
+    uint64_t frame;
+
+    // Loader.
+    DvzSize load_size; // size of the data of an item
+    DvzPoolFetch fetch;
+    DvzPoolUpload upload;
+    void* owner;
+    uint32_t max_pending;
+    DvzThread* thread;
+    DvzFifo* requests; // main thread -> loader thread
+    DvzFifo* loaded;   // loader thread -> main thread
+    DvzPoolLoad** inflight;
+    uint32_t pending;
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Number of elements along one axis at a given level of a multiresolution pyramid.
+ *
+ * @param n the number of elements at level 0
+ * @param level the level, each level halving the resolution
+ * @returns the number of elements
+ */
+static inline uint32_t dvz_pool_level_size(uint32_t n, uint32_t level)
+{
+    return MAX(1, (uint32_t)(((uint64_t)n + (1ull << level) - 1) >> level));
+}
+
+
+
+/**
+ * Create a pool of slots caching a set of items, loaded asynchronously by a loader thread.
+ *
+ * The last item is the coarsest one: it is pinned in the pool once loaded.
+ *
+ * @param item_count the number of items
+ * @param capacity the number of slots
+ * @param max_pending the maximum number of items being loaded at the same time
+ * @returns the pool
+ */
+DvzPool* dvz_pool(uint32_t item_count, uint32_t capacity, uint32_t max_pending);
+
+
+
+/**
+ * Set the loader of a pool. Must be called before the loader thread starts.
+ *
+ * @param pool the pool
+ * @param size the size of the data of an item
+ * @param fetch the function filling the data of an item, called by the loader thread
+ * @param upload the function uploading the data of an item to a slot, called by the main thread
+ * @param owner the object passed to the functions
+ */
+void dvz_pool_loader(
+    DvzPool* pool, DvzSize size, DvzPoolFetch fetch, DvzPoolUpload upload, void* owner);
+
+
+
+/**
+ * Start the loader thread if it is not already started.
+ *
+ * @param pool the pool
+ */
+void dvz_pool_start(DvzPool* pool);
+
+
+
+/**
+ * Mark an item as needed at the current frame if it is resident.
+ *
+ * @param pool the pool
+ * @param item the item
+ * @returns whether the item is resident
+ */
+bool dvz_pool_touch(DvzPool* pool, uint32_t item);
+
+
+
+/**
+ * Request the unloaded candidates to the loader thread, sorted by increasing key, within the
+ * maximum number of pending items.
+ *
+ * @param pool the pool
+ * @param count the number of candidates
+ * @param candidates the candidates, sorted in place
+ */
+void dvz_pool_request(DvzPool* pool, uint32_t count, DvzPoolCandidate* candidates);
+
+
+
+/**
+ * Cancel the requested items not needed at the current frame (see `stamps`), or resume them if
+ * they are needed again before the loader thread reaches them.
+ *
+ * @param pool the pool
+ */
+void dvz_pool_cancel(DvzPool* pool);
+
+
+
+/**
+ * Store the items loaded by the loader thread in the pool, evicting the least recently used
+ * items not needed at the current frame.
+ *
+ * @param pool the pool
+ * @returns whether some items were loaded
+ */
+bool dvz_pool_receive(DvzPool* pool);
+
+
+
+/**
+ * Return whether no item is being loaded, and the given items are loaded.
+ *
+ * @param pool the pool
+ * @param count the number of items
+ * @param items the items
+ * @returns whether the items are loaded
+ */
+bool dvz_pool_ready(DvzPool* pool, uint32_t count, uint32_t* items);
+
+
+
+/**
+ * Sort candidates by increasing key.
+ *
+ * @param count the number of candidates
+ * @param candidates the candidates
+ */
+void dvz_pool_sort(uint32_t count, DvzPoolCandidate* candidates);
+
+
+
+/**
+ * Destroy a pool, stopping its loader thread and discarding the pending requests.
+ *
+ * @param pool the pool
+ */
+void dvz_pool_destroy(DvzPool* pool);
+
+
+
+EXTERN_C_OFF
+
+#endif
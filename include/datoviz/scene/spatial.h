@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Spatial index                                                                                */
+/*************************************************************************************************/
+
+/*
+CPU spatial index over the positions of a visual, for hover and selection queries when GPU
+picking is not available.
+
+DVZ_SPATIAL_POINTS: uniform 2D grid over the xy positions, stored as sorted cell lists. In-place
+position updates are patched incrementally: points that leave their cell are moved to a small
+overflow list, and the grid is rebuilt lazily once that list becomes too large.
+
+DVZ_SPATIAL_MESH: bounding volume hierarchy over the triangles. In-place position updates refit
+the node bounds, index updates trigger a rebuild.
+
+Builds are multithreaded and happen lazily at the first query after a change. Distances are
+computed after scaling each axis by a per-query factor, which makes it possible to query in NDC
+with a diagonal affine transformation (panzoom, ortho). The index is not thread-safe.
+*/
+
+#ifndef DVZ_HEADER_SPATIAL
+#define DVZ_HEADER_SPATIAL
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "datoviz_enums.h"
+#include "datoviz_math.h"
+#include "datoviz_types.h"
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzSpatial DvzSpatial;
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Create a spatial index.
+ *
+ * @param type the index type
+ * @returns the spatial index
+ */
+DvzSpatial* dvz_spatial(DvzSpatialType type);
+
+
+
+/**
+ * Set the positions of a range of points (or mesh vertices).
+ *
+ * @param spatial the spatial index
+ * @param first the index of the first position to update
+ * @param count the number of positions to update
+ * @param dims the number of components per position, 2 or 3 (z is then 0)
+ * @param data the positions
+ */
+void dvz_spatial_positions(
+    DvzSpatial* spatial, uint32_t first, uint32_t count, uint32_t dims, const float* data);
+
+
+
+/**
+ * Set a range of mesh indices, three per triangle.
+ *
+ * @param spatial the spatial index
+ * @param first the index of the first index to update
+ * @param count the number of indices to update
+ * @param data the indices
+ */
+void dvz_spatial_indices(
+    DvzSpatial* spatial, uint32_t first, uint32_t count, const DvzIndex* data);
+
+
+
+/**
+ * Resize the spatial index.
+ *
+ * @param spatial the spatial index
+ * @param count the number of positions
+ * @param index_count the number of indices, 0 for a non-indexed mesh
+ */
+void dvz_spatial_resize(DvzSpatial* spatial, uint32_t count, uint32_t index_count);
+
+
+
+/**
+ * Bring the spatial index up to date, otherwise done lazily at the next query.
+ *
+ * @param spatial the spatial index
+ */
+void dvz_spatial_build(DvzSpatial* spatial);
+
+
+
+/**
+ * Find the closest point (or triangle) to a position.
+ *
+ * @param spatial the spatial index
+ * @param pos the position, the z coordinate is ignored for points
+ * @param scale the factor applied to each axis before computing distances
+ * @param max_distance the maximum scaled distance, use INFINITY for no limit
+ * @param[out] item the index of the closest point (or triangle)
+ * @param[out] distance the scaled distance to the closest point (or triangle), may be NULL
+ * @returns whether an item was found within the maximum distance
+ */
+bool dvz_spatial_nearest(
+    DvzSpatial* spatial, vec3 pos, vec3 scale, float max_distance, uint32_t* item,
+    float* distance);
+
+
+
+/**
+ * Find the points (or the triangles whose centroid is) within a box.
+ *
+ * @param spatial the spatial index
+ * @param p0 one corner of the box, the z coordinate is ignored for points
+ * @param p1 the opposite corner of the box
+ * @param max_count the maximum number of items to write
+ * @param[out] items the selected items, may be NULL if max_count is 0
+ * @returns the total number of items within the box, possibly larger than max_count
+ */
+uint32_t
+dvz_spatial_box(DvzSpatial* spatial, vec3 p0, vec3 p1, uint32_t max_count, uint32_t* items);
+
+
+
+/**
+ * Destroy a spatial index.
+ *
+ * @param spatial the spatial index
+ */
+void dvz_spatial_destroy(DvzSpatial* spatial);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -33,6 +33,13 @@
 
 #define FIELD(t, f) offsetof(t, f), fsizeof(t, f)
 
+// Size of the bricks of the occupancy grid computed for volume textures, in voxels.
+// NOTE: must match BRICK_SIZE in graphics_volume.frag.
+#define DVZ_TEXTURE_BRICK_SIZE 16
+
+// Size of the blocks compared between two frames of a streamed texture, in pixels.
+#define DVZ_TEXTURE_STREAM_BLOCK 32
+
 
 
 /*************************************************************************************************/
@@ -63,9 +70,44 @@ struct DvzTexture
     DvzId tex;
     DvzId sampler;
 
+    // Occupancy grid of volume textures: maximum normalized value in each brick of voxels.
+    uvec3 brick_shape;
+    float* brick_max;
+    DvzId brick_tex;
+    DvzId brick_sampler;
+
+    // Last frame of a streamed texture, to detect the changed regions.
+    uint8_t* frame;
+
     int flags;
 };
 
 
 
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Texture occupancy                                                                            */
+/*************************************************************************************************/
+
+/**
+ * Create and upload the brick occupancy texture of a 3D texture (used for empty-space skipping).
+ *
+ * The occupancy texture is a R32_SFLOAT 3D texture with one texel per brick of
+ * DVZ_TEXTURE_BRICK_SIZE^3 voxels, containing an upper bound of the normalized voxel values in
+ * the brick and its one-voxel neighborhood. It is kept up to date by dvz_texture_data().
+ *
+ * The occupancy is only computed for textures created with DVZ_TEX_FLAGS_OCCUPANCY, or bound
+ * to a volume with this function. Bricks of data uploaded before are considered as occupied.
+ *
+ * @param texture the 3D texture
+ */
+void dvz_texture_occupancy(DvzTexture* texture);
+
+
+
+EXTERN_C_OFF
+
+
+
 #endif
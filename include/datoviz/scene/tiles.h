@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Tiles                                                                                         */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TILES
+#define DVZ_HEADER_TILES
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_enums.h"
+#include "_obj.h"
+#include "datoviz_types.h"
+#include "pool.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_TILES_MAX_LEVELS   32
+#define DVZ_TILES_MAX_PENDING  32 // maximum number of tiles being loaded at the same time
+#define DVZ_TILES_MAX_POOL     8192
+#define DVZ_TILES_DEFAULT_SIZE 256
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzTiles DvzTiles;
+
+// Forward declarations.
+typedef struct DvzBatch DvzBatch;
+typedef struct DvzBox DvzBox;
+typedef struct DvzVisual DvzVisual;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzTiles
+{
+    DvzObject obj;
+    DvzBatch* batch;
+
+    DvzFormat format;
+    DvzSize item_size;
+    uvec2 shape;        // image shape at level 0, in pixels
+    uint32_t tile_size; // T, tile size in pixels
+    int flags;
+
+    // Position of the image in normalized device coordinates.
+    vec2 xlim;
+    vec2 ylim;
+
+    // Pyramid: level L is the image downsampled by a factor 2^L, the last level has a single
+    // tile.
+    uint32_t level_count;
+    uvec2 grids[DVZ_TILES_MAX_LEVELS];      // number of tiles along each axis, per level
+    uint32_t offsets[DVZ_TILES_MAX_LEVELS]; // index of the first tile of each level
+    uint32_t tile_count;                    // total number of tiles, across all levels
+
+    // Tile cache.
+    uvec2 pool;        // shape of the cache texture, in tiles
+    uint32_t capacity; // number of slots in the cache
+    DvzPool* cache;    // state and slot of each tile, and tile loader thread
+    bool dirty;
+
+    // Tiles visible at the last update, and tiles drawn instead (resident parents of the tiles
+    // being loaded), sorted from the lowest to the highest resolution.
+    uint32_t level;
+    uint32_t* visible;
+    uint32_t visible_count;
+    uint32_t* drawn;
+    uint32_t drawn_count;
+
+    // GPU objects.
+    DvzId atlas_tex;
+    DvzId atlas_sampler;
+    DvzVisual* visual;
+
+    // Tile source.
+    DvzTilesCallback callback;
+    void* user_data;
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Create the tile cache texture, if it is not already created.
+ *
+ * @param tiles the tiles
+ */
+void dvz_tiles_create(DvzTiles* tiles);
+
+
+
+/**
+ * Return the index of a tile.
+ *
+ * @param tiles the tiles
+ * @param level the level
+ * @param x the tile column within the level
+ * @param y the tile row within the level
+ * @returns the tile index
+ */
+uint32_t dvz_tiles_index(DvzTiles* tiles, uint32_t level, uint32_t x, uint32_t y);
+
+
+
+/**
+ * Select the level and the visible tiles for a given extent of the image.
+ *
+ * @param tiles the tiles
+ * @param extent the visible extent, in normalized device coordinates
+ * @param viewport the viewport size, in pixels
+ * @returns the selected level
+ */
+uint32_t dvz_tiles_select(DvzTiles* tiles, DvzBox* extent, vec2 viewport);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -18,8 +18,10 @@
 /*************************************************************************************************/
 
 #include "../_atomic.h"
+#include "../fileio.h"
 #include "_enums.h"
 #include "_obj.h"
+#include "box.h"
 #include "datoviz.h"
 #include "datoviz_types.h"
 #include "mvp.h"
@@ -40,6 +42,12 @@
 #define DVZ_PUSH_SCALE_OFFSET 0
 #define DVZ_PUSH_SCALE_SIZE   sizeof(float)
 
+// Specialization constant of the visual pick id, enabled with DVZ_VISUAL_FLAGS_PICK.
+#define DVZ_SPECIALIZATION_PICK 19
+
+// Specialization constant of the order-independent transparency, enabled with DVZ_BLEND_OIT.
+#define DVZ_SPECIALIZATION_OIT 20
+
 
 
 /*************************************************************************************************/
@@ -48,12 +56,15 @@
 
 typedef struct DvzVisual DvzVisual;
 typedef struct DvzVisualAttr DvzVisualAttr;
+typedef struct DvzScalarParams DvzScalarParams;
 
 // Forward declarations.
 typedef struct DvzBatch DvzBatch;
 typedef struct DvzBaker DvzBaker;
 typedef struct DvzView DvzView;
 typedef struct DvzTransform DvzTransform;
+typedef struct DvzSpatial DvzSpatial;
+typedef struct DvzCulling DvzCulling;
 
 // Visual draw callback function.
 typedef void (*DvzVisualCallback)(
@@ -98,11 +109,20 @@ struct DvzVisualAttr
 
 
 
+struct DvzScalarParams
+{
+    vec2 range; // vmin, vmax
+    int32_t cmap;
+};
+
+
+
 struct DvzVisual
 {
     DvzObject obj;
     DvzBatch* batch;
     DvzView* view;
+    DvzTransform* transform; // transform of the view the visual was added to
     int flags;
     DvzAtomic status;
     void* user_data;
@@ -116,6 +136,11 @@ struct DvzVisual
     // Bindings
     DvzParams* params[DVZ_MAX_BINDINGS]; // dats
     DvzId texs[DVZ_MAX_BINDINGS];        // texs
+    uint32_t scalar_slot;                // slot of the colormap params, 0 if not supported
+    uint32_t pick_id;                    // id written into the pick attachment, 0 if disabled
+    DvzSpatial* spatial;                 // CPU spatial index of the positions, may be NULL
+    DvzCulling* culling;                 // GPU culling of the items, may be NULL
+    uint32_t size_attr;                  // float attribute with the item size in pixels, or 0
 
     // Data.
     uint32_t item_count;
@@ -131,6 +156,13 @@ struct DvzVisual
     uint32_t instance_count;
     bool is_visible;
 
+    // CPU culling with the bounding box of the positions.
+    bool bounds_enabled; // whether the visual is skipped when its box is outside of the view
+    bool bounds_auto;    // whether the box is extended as positions are set
+    DvzBox bounds;       // bounding box of the positions
+    float bounds_margin; // margin around the box, in pixels
+    bool is_culled;      // whether the visual was skipped by the last viewset build
+
     // Visual draw callback.
     DvzVisualCallback callback;
 };
@@ -213,6 +245,28 @@ void dvz_visual_record(DvzVisual* visual, DvzId canvas);
 
 
 
+/**
+ * Update the bindings and params of the GPU culling of the visual if its data changed.
+ *
+ * The culling kernel itself is dispatched at every frame, in the command buffer recorded by
+ * dvz_visual_record().
+ *
+ * @param visual the visual
+ */
+void dvz_visual_culling_update(DvzVisual* visual);
+
+
+
+/**
+ * Return whether the bounding box of a visual is entirely outside of its view.
+ *
+ * @param visual the visual
+ * @returns whether the visual can be skipped, always false if the CPU culling is disabled
+ */
+bool dvz_visual_culled(DvzVisual* visual);
+
+
+
 /**
  *
  */
@@ -330,6 +384,59 @@ static void _common_setup(DvzVisual* visual)
 
 
 
+// Load the shaders of a visual. With DVZ_VISUAL_FLAGS_SCALAR, the vertex shader is the variant
+// compiled with SCALAR_COLOR, which declares the colormap params set up by _scalar_setup().
+static void _scalar_shader(DvzVisual* visual, const char* name)
+{
+    ANN(visual);
+    ANN(name);
+    ASSERT(strlen(name) < 50);
+
+    if ((visual->flags & DVZ_VISUAL_FLAGS_SCALAR) == 0)
+    {
+        dvz_visual_shader(visual, name);
+        return;
+    }
+
+    unsigned long size = 0;
+    char rname[64] = {0};
+
+    snprintf(rname, 60, "%s_scalar_vert", name);
+    unsigned char* buffer = dvz_resource_shader(rname, &size);
+    dvz_visual_spirv(visual, DVZ_SHADER_VERTEX, size, buffer);
+
+    snprintf(rname, 60, "%s_frag", name);
+    buffer = dvz_resource_shader(rname, &size);
+    dvz_visual_spirv(visual, DVZ_SHADER_FRAGMENT, size, buffer);
+}
+
+
+
+// NOTE: only called with DVZ_VISUAL_FLAGS_SCALAR, as the default shaders have no colormap params.
+// The color attribute holds a single float that the shader reads as (value, 0, 0, 1) and maps to
+// a color with the colormap and the range.
+static void _scalar_setup(DvzVisual* visual, uint32_t attr_idx, uint32_t slot_idx)
+{
+    ANN(visual);
+    ASSERT((visual->flags & DVZ_VISUAL_FLAGS_SCALAR) != 0);
+    ASSERT(attr_idx < DVZ_MAX_VERTEX_ATTRS);
+    ASSERT(1 < slot_idx && slot_idx < DVZ_MAX_BINDINGS);
+
+    visual->scalar_slot = slot_idx;
+    dvz_visual_slot(visual, slot_idx, DVZ_SLOT_DAT);
+
+    DvzParams* params = dvz_visual_params(visual, slot_idx, sizeof(DvzScalarParams));
+    dvz_params_attr(params, 0, FIELD(DvzScalarParams, range));
+    dvz_params_attr(params, 1, FIELD(DvzScalarParams, cmap));
+    dvz_visual_param(visual, slot_idx, 0, (vec2){0, 1});
+    dvz_visual_param(visual, slot_idx, 1, (int32_t[]){DVZ_CMAP_VIRIDIS});
+
+    visual->attrs[attr_idx].item_size = sizeof(float);
+    visual->attrs[attr_idx].format = DVZ_FORMAT_R32_SFLOAT;
+}
+
+
+
 EXTERN_C_OFF
 
 #endif
@@ -65,10 +65,49 @@ struct DvzGlyphVertex
 
 struct DvzGlyphParams
 {
-    vec2 size;    /* glyph size in pixels */
-    vec4 bgcolor; /* background color for glyph antialiasing*/
+    vec2 size;           /* glyph size in pixels */
+    vec4 bgcolor;        /* background color for glyph antialiasing*/
+    int pixel_texcoords; /* whether the texture coordinates are in pixels (atlas fonts) */
 };
 
 
 
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Compute the layout of an ASCII string with the font of a glyph visual.
+ *
+ * @param visual the glyph visual, with a font set by `dvz_glyph_atlas_font()`
+ * @param string the string
+ * @param[out] out_xywh the box of each glyph, relative to the origin of the string
+ * @param[out] out_texcoords the normalized texture coordinates of each glyph in the atlas
+ */
+void dvz_glyph_layout(DvzVisual* visual, const char* string, vec4* out_xywh, vec4* out_texcoords);
+
+
+
+/**
+ * Set all attributes of a range of glyphs holding a single string laid out beforehand.
+ *
+ * The glyphs after the first `count` ones in the range are hidden.
+ *
+ * @param glyph the glyph visual
+ * @param first the index of the first glyph of the range
+ * @param capacity the number of glyphs in the range
+ * @param count the number of glyphs of the string, lower than or equal to capacity
+ * @param xywh the box of each glyph, as returned by `dvz_glyph_layout()`
+ * @param texcoords the texture coordinates of each glyph, as returned by `dvz_glyph_layout()`
+ * @param position the position of the string
+ * @param color the color of the string
+ * @param offset the offset of the string, in pixels
+ * @param anchor the anchor of the string
+ */
+void dvz_glyph_range(
+    DvzVisual* glyph, uint32_t first, uint32_t capacity, uint32_t count, vec4* xywh,
+    vec4* texcoords, vec3 position, DvzColor color, vec2 offset, vec2 anchor);
+
+
+
 #endif
@@ -52,6 +52,14 @@ typedef struct DvzShape DvzShape;
 #define VOLUME_DIR_FRONT_BACK 0
 #define VOLUME_DIR_BACK_FRONT 1
 
+#define VOLUME_STORAGE_DENSE   0
+#define VOLUME_STORAGE_BRICKED 1
+
+// Default ray marching parameters.
+#define VOLUME_DEFAULT_STEP        1.0  // in voxels
+#define VOLUME_DEFAULT_TERMINATION 0.99 // accumulated alpha above which the ray stops
+#define VOLUME_DEFAULT_EMPTY       0.0  // maximum alpha of a brick considered as empty
+
 
 
 /*************************************************************************************************/
@@ -74,6 +82,8 @@ struct DvzVolumeParams
     vec4 uvw1;         /* texture coordinates of the 2 corner points */
     vec4 transfer;     /* transfer function */
     ivec4 permutation; /* (0,1,2,-1) by default, last is face on which to disable ray casting */
+    vec4 raymarch;     /* step (in voxels), termination alpha, empty brick alpha, unused */
+    ivec4 bricks;      /* bricked volumes only: volume shape (in voxels), brick size */
 };
 
 
@@ -96,9 +106,14 @@ static void volume_specialization(DvzVisual* visual)
     if ((flags & DVZ_VOLUME_FLAGS_BACK_FRONT) != 0)
         volume_dir = VOLUME_DIR_BACK_FRONT;
 
+    int volume_storage = VOLUME_STORAGE_DENSE;
+    if ((flags & DVZ_VOLUME_FLAGS_BRICKED) != 0)
+        volume_storage = VOLUME_STORAGE_BRICKED;
+
     dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 0, sizeof(int), &volume_type);
     dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 1, sizeof(int), &volume_color);
     dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 2, sizeof(int), &volume_dir);
+    dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 3, sizeof(int), &volume_storage);
 }
 
 
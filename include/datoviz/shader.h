@@ -17,6 +17,7 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include "_mutex.h"
 #include "common.h"
 #include <vulkan/vulkan.h>
 
@@ -28,6 +29,10 @@
 
 typedef struct DvzGpu DvzGpu;
 typedef struct DvzShader DvzShader;
+typedef struct DvzCompiler DvzCompiler;
+
+// Forward declarations.
+typedef struct DvzMap DvzMap;
 
 
 
@@ -49,14 +54,119 @@ struct DvzShader
 
 
 
+// NOTE: the SPIR-V cache is keyed by a hash of the GLSL code, the shader stage, the compiler
+// options and the shaderc version. Compiled shaders are kept in memory for the lifetime of the
+// compiler, and saved in the user cache directory (see dvz_cache_path()).
+struct DvzCompiler
+{
+    DvzObject obj;
+    DvzMutex lock; // protects the map and the counters, compilation itself runs unlocked
+
+    void* compiler; // shaderc_compiler_t, shared by all compilations
+    void* options;  // shaderc_compile_options_t, read-only after creation
+    uint64_t seed;  // hash of the compiler options and version
+
+    DvzMap* spirvs; // hash -> SPIR-V code
+    uint32_t hits;  // in-memory cache hits
+    uint32_t loads; // on-disk cache hits
+    uint32_t compilations;
+};
+
+
+
+EXTERN_C_ON
+
 /*************************************************************************************************/
 /*  Compilation                                                                                  */
 /*************************************************************************************************/
 
+/**
+ * Create a GLSL to SPIR-V compiler with a SPIR-V cache.
+ *
+ * @returns the compiler
+ */
+DvzCompiler* dvz_compiler(void);
+
+
+
+/**
+ * Compile GLSL code into SPIR-V, or return the cached SPIR-V code if it was compiled before.
+ *
+ * This function is thread-safe. The returned buffer is owned by the compiler.
+ *
+ * @param compiler the compiler
+ * @param code the GLSL code
+ * @param stage the shader stage
+ * @param[out] size the size of the SPIR-V code, in bytes
+ * @returns the SPIR-V code, or NULL if the compilation failed
+ */
+uint32_t* dvz_compiler_spirv(
+    DvzCompiler* compiler, const char* code, VkShaderStageFlagBits stage, DvzSize* size);
+
+
+
+/**
+ * Compile several GLSL shaders in parallel into the SPIR-V cache.
+ *
+ * The number of worker threads is given by DVZ_NUM_THREADS, or half the number of processors.
+ *
+ * @param compiler the compiler
+ * @param count the number of shaders
+ * @param codes the GLSL code of each shader
+ * @param stages the stage of each shader
+ */
+void dvz_compiler_batch(
+    DvzCompiler* compiler, uint32_t count, const char** codes, VkShaderStageFlagBits* stages);
+
+
+
+/**
+ * Destroy a compiler and its in-memory SPIR-V cache.
+ *
+ * @param compiler the compiler
+ */
+void dvz_compiler_destroy(DvzCompiler* compiler);
+
+
+
+/**
+ * Return the host compiler of a GPU, creating it on first use.
+ *
+ * This function is thread-safe.
+ *
+ * @param gpu the GPU
+ * @returns the host compiler
+ */
+DvzCompiler* dvz_host_compiler(DvzGpu* gpu);
+
+
+
+/**
+ * Compile GLSL code into a shader module, using the host compiler and its SPIR-V cache.
+ *
+ * @param gpu the GPU
+ * @param code the GLSL code
+ * @param stage the shader stage
+ * @returns the shader module
+ */
 VkShaderModule dvz_compile_glsl(DvzGpu* gpu, const char* code, VkShaderStageFlagBits stage);
 
 
 
+/**
+ * Compile GLSL code into SPIR-V, using the host compiler and its SPIR-V cache.
+ *
+ * @param gpu the GPU
+ * @param code the GLSL code
+ * @param stage the shader stage
+ * @param[out] size the size of the SPIR-V code, in bytes
+ * @returns the SPIR-V code, owned by the compiler, or NULL if the compilation failed
+ */
+uint32_t*
+dvz_compile_spirv(DvzGpu* gpu, const char* code, VkShaderStageFlagBits stage, DvzSize* size);
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -69,4 +179,6 @@ void dvz_shader_destroy(DvzShader* shader);
 
 
 
+EXTERN_C_OFF
+
 #endif
@@ -133,6 +133,16 @@ bool dvz_timer_running(DvzTimerItem* item);
 
 
 
+// Whether at least one timer item is running and has not reached its maximum count.
+bool dvz_timer_active(DvzTimer* timer);
+
+
+
+// Time of the next firing of the running timer items, or a negative value if there is none.
+double dvz_timer_next(DvzTimer* timer);
+
+
+
 void dvz_timer_tick(DvzTimer* timer, double time);
 
 
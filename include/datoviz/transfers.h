@@ -58,6 +58,7 @@ typedef enum
     DVZ_TRANSFER_IMAGE_COPY,
     DVZ_TRANSFER_IMAGE_BUFFER,
     DVZ_TRANSFER_BUFFER_IMAGE,
+    DVZ_TRANSFER_STREAM_IMAGE, // buffer to image copy recorded in the stream command buffer
 
     DVZ_TRANSFER_DOWNLOAD_DONE, // download is only possible from a buffer, not a texture
     DVZ_TRANSFER_UPLOAD_DONE,
@@ -203,6 +204,12 @@ struct DvzTransfers
     DvzThread* thread; // transfer thread
 
     DvzTransferDups dups;
+    uint64_t flushes; // number of times the pending copies have been processed
+
+    // Copies of the streaming texs, recorded in a single command buffer per flush.
+    DvzCommands stream_cmds;
+    DvzFences stream_fences; // signaled once the copies of the last flush are done
+    bool stream_recording;   // true while copies are being recorded in stream_cmds
 };
 
 
@@ -256,6 +263,35 @@ void dvz_transfers_frame(DvzTransfers* transfers, uint32_t img_idx);
 
 
 
+/**
+ * Process the pending copies (staging buffers to GPU buffers and images) immediately.
+ *
+ * This is done at every frame by `dvz_transfers_frame()`, and must be done explicitly before
+ * rendering offscreen, so that the asynchronous tex uploads are visible.
+ *
+ * The copies of the streaming texs are recorded in a single command buffer, submitted to the
+ * render queue without waiting: the image barriers order them with the previous and next
+ * render submissions.
+ *
+ * @param transfers the DvzTransfers pointer
+ */
+void dvz_transfers_flush(DvzTransfers* transfers);
+
+
+
+/**
+ * Return whether some transfers still need to be processed by `dvz_transfers_frame()`.
+ *
+ * This is the case when copies or dup transfers are pending, or when dup transfers have not yet
+ * been applied to all swapchain images.
+ *
+ * @param transfers the DvzTransfers pointer
+ * @returns whether transfers are pending
+ */
+bool dvz_transfers_pending(DvzTransfers* transfers);
+
+
+
 /**
  * Destroy a transfers object.
  *
@@ -52,12 +52,21 @@ MUTE_OFF
 #define DVZ_MAX_BARRIERS_PER_SET            8
 #define DVZ_MAX_SEMAPHORES_PER_SUBMIT       8
 #define DVZ_MAX_SHADERS_PER_GRAPHICS        6
+#define DVZ_MAX_GRAPHICS_VARIANTS           8
 #define DVZ_MAX_ATTACHMENTS_PER_RENDERPASS  8
 #define DVZ_MAX_SUBPASSES_PER_RENDERPASS    8
 #define DVZ_MAX_DEPENDENCIES_PER_RENDERPASS 8
 #define DVZ_MAX_FRAMES_IN_FLIGHT            2
 #define DVZ_MAX_SPECIALIZATION_CONSTANTS    8
 
+// Format of the pick attachment: (visual id, item index, 0, 0), 0 = no visual.
+#define DVZ_PICK_IMAGE_FORMAT VK_FORMAT_R32G32B32A32_SINT
+
+// Formats of the order-independent transparency attachments: weighted premultiplied color sum,
+// and revealage (product of the fragment transparencies).
+#define DVZ_OIT_ACCUM_FORMAT  VK_FORMAT_R16G16B16A16_SFLOAT
+#define DVZ_OIT_REVEAL_FORMAT VK_FORMAT_R16_SFLOAT
+
 
 
 /*************************************************************************************************/
@@ -85,6 +94,7 @@ typedef struct DvzBarrierImage DvzBarrierImage;
 typedef struct DvzBarrier DvzBarrier;
 typedef struct DvzSemaphores DvzSemaphores;
 typedef struct DvzFences DvzFences;
+typedef struct DvzQueries DvzQueries;
 typedef struct DvzRenderpass DvzRenderpass;
 typedef struct DvzRenderpassAttachment DvzRenderpassAttachment;
 typedef struct DvzRenderpassSubpass DvzRenderpassSubpass;
@@ -95,6 +105,7 @@ typedef struct DvzSubmit DvzSubmit;
 
 // Forward declarations.
 typedef struct DvzHost DvzHost;
+typedef struct DvzPipeCache DvzPipeCache;
 
 
 
@@ -132,10 +143,24 @@ typedef enum
     DVZ_RENDERPASS_ATTACHMENT_COLOR,
     DVZ_RENDERPASS_ATTACHMENT_DEPTH,
     DVZ_RENDERPASS_ATTACHMENT_PICK,
+    DVZ_RENDERPASS_ATTACHMENT_ACCUM,
+    DVZ_RENDERPASS_ATTACHMENT_REVEAL,
 } DvzRenderpassAttachmentType;
 
 
 
+// Optional attachments of the GPU renderpasses.
+typedef enum
+{
+    DVZ_RENDERPASS_FLAGS_NONE = 0x00,
+    DVZ_RENDERPASS_FLAGS_PICK = 0x01, // integer pick attachment
+    DVZ_RENDERPASS_FLAGS_OIT = 0x02,  // order-independent transparency attachments and subpass
+} DvzRenderpassFlags;
+
+#define DVZ_RENDERPASS_FLAGS_COUNT 4
+
+
+
 /*************************************************************************************************/
 /*  Renderpass structs                                                                           */
 /*************************************************************************************************/
@@ -158,7 +183,10 @@ struct DvzRenderpassAttachment
 struct DvzRenderpassSubpass
 {
     uint32_t attachment_count;
-    uint32_t attachments[DVZ_MAX_ATTACHMENTS_PER_RENDERPASS];
+    uint32_t attachments[DVZ_MAX_ATTACHMENTS_PER_RENDERPASS]; // may be VK_ATTACHMENT_UNUSED
+
+    uint32_t input_count;
+    uint32_t inputs[DVZ_MAX_ATTACHMENTS_PER_RENDERPASS];
 };
 
 
@@ -295,6 +323,12 @@ struct DvzGpu
 
     DvzCommands cmd; // Command buffer for transfers.
 
+    // Pipeline cache, loaded from and saved to the user cache directory.
+    VkPipelineCache pipeline_cache;
+    DvzSize pipeline_cache_loaded; // size of the cache data loaded at creation, 0 if none
+    uint32_t pipeline_count;       // number of graphics and compute pipelines created
+    double pipeline_time;          // total pipeline creation time, in seconds
+
     // Renderpasses.
     // DvzRenderpass renderpass; // default renderpass
 };
@@ -464,6 +498,8 @@ struct DvzCompute
 
     char shader_path[1024];
     const char* shader_code;
+    VkDeviceSize shader_size;
+    const uint32_t* shader_buffer;
 
     VkPipeline pipeline;
     DvzSlots dslots;
@@ -517,6 +553,13 @@ struct DvzGraphics
     VkPipeline pipeline;
     DvzSlots dslots;
 
+    // Pipelines for other renderpasses that only differ by their pick and OIT attachments. They
+    // are kept until the graphics is destroyed, as command buffers in flight may use them.
+    uint32_t variant_count;
+    DvzRenderpass* variant_renderpasses[DVZ_MAX_GRAPHICS_VARIANTS];
+    VkPipeline variant_pipelines[DVZ_MAX_GRAPHICS_VARIANTS];
+    int32_t variant; // pipeline bound by dvz_cmd_bind_graphics(), -1 for the main one
+
     uint32_t vertex_binding_count;
     DvzVertexBinding vertex_bindings[DVZ_MAX_VERTEX_BINDINGS];
 
@@ -529,6 +572,8 @@ struct DvzGraphics
 
     uint32_t spec_const_count;
     DvzSpecializationConstants spec_consts[DVZ_MAX_SHADERS_PER_GRAPHICS];
+
+    DvzPipeCache* cache; // optional, to share shader modules and pipelines with other graphics
 };
 
 
@@ -574,6 +619,11 @@ struct DvzBarrier
     VkPipelineStageFlagBits src_stage;
     VkPipelineStageFlagBits dst_stage;
 
+    // Global memory barrier, covering all resources.
+    bool memory_barrier;
+    VkAccessFlags memory_src_access;
+    VkAccessFlags memory_dst_access;
+
     uint32_t buffer_barrier_count;
     DvzBarrierBuffer buffer_barriers[DVZ_MAX_BARRIERS_PER_SET];
 
@@ -605,6 +655,18 @@ struct DvzSemaphores
 
 
 
+struct DvzQueries
+{
+    DvzObject obj;
+    DvzGpu* gpu;
+
+    VkQueryType type;
+    uint32_t count;
+    VkQueryPool pool;
+};
+
+
+
 struct DvzFramebuffers
 {
     DvzObject obj;
@@ -698,6 +760,35 @@ void dvz_gpu_external(DvzGpu* gpu, VkExternalMemoryHandleTypeFlagsKHR flags);
  */
 DvzRenderpass dvz_gpu_renderpass(DvzGpu* gpu, cvec4 clear_color, VkImageLayout layout);
 
+/**
+ * Make a renderpass for a GPU, with an additional integer pick attachment.
+ *
+ * The pick attachment (index 2, after the color and depth attachments) is cleared to zero and
+ * ends up in the VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL layout so that it can be read back.
+ *
+ * @param gpu the GPU
+ * @param clear_color the clear color
+ * @param layout the Vulkan image layout of the color attachment
+ * @returns a renderpass structure
+ */
+DvzRenderpass dvz_gpu_renderpass_pick(DvzGpu* gpu, cvec4 clear_color, VkImageLayout layout);
+
+/**
+ * Make a renderpass for a GPU, with optional additional attachments.
+ *
+ * With DVZ_RENDERPASS_FLAGS_OIT, the renderpass has two subpasses. The first one has the color
+ * attachments (color, pick or unused, accum, reveal), at fragment shader output locations 0 to 3,
+ * the second one composites the accum and reveal input attachments into the color attachment.
+ *
+ * @param gpu the GPU
+ * @param clear_color the clear color
+ * @param layout the Vulkan image layout of the color attachment
+ * @param flags the renderpass flags
+ * @returns a renderpass structure
+ */
+DvzRenderpass
+dvz_gpu_renderpass_flags(DvzGpu* gpu, cvec4 clear_color, VkImageLayout layout, int flags);
+
 /**
  * Request some features before creating the GPU instance.
  *
@@ -745,6 +836,17 @@ void dvz_queue_wait(DvzGpu* gpu, uint32_t queue_idx);
  */
 void dvz_gpu_wait(DvzGpu* gpu);
 
+/**
+ * Save the pipeline cache of a GPU to the user cache directory.
+ *
+ * This is done automatically when the GPU is destroyed. The file name depends on the device and
+ * on the driver, and the `DVZ_NO_CACHE` environment variable disables the cache.
+ *
+ * @param gpu the GPU
+ * @returns 0 if the cache was saved, 1 otherwise
+ */
+int dvz_gpu_save_cache(DvzGpu* gpu);
+
 /**
  * Destroy the resources associated to a GPU.
  *
@@ -994,6 +1096,22 @@ void dvz_buffer_create(DvzBuffer* buffer);
  */
 void dvz_buffer_resize(DvzBuffer* buffer, VkDeviceSize size);
 
+/**
+ * Recreate a buffer with a new size, keeping only some regions of its contents.
+ *
+ * The regions are copied on the GPU from the old buffer to the new one (hard sync), so the
+ * destination regions may overlap the source regions. The size may be smaller than the current
+ * size. The Vulkan buffer handle changes: descriptors referring to the buffer must be updated.
+ *
+ * @param buffer the buffer
+ * @param size the new buffer size, in bytes
+ * @param region_count the number of regions to keep
+ * @param regions the regions to copy, with source offsets in the old buffer and destination
+ *      offsets in the new buffer
+ */
+void dvz_buffer_repack(
+    DvzBuffer* buffer, VkDeviceSize size, uint32_t region_count, VkBufferCopy* regions);
+
 /**
  * Memory-map a buffer.
  *
@@ -1439,6 +1557,15 @@ void dvz_descriptors_buffer(DvzDescriptors* descriptors, uint32_t idx, DvzBuffer
 void dvz_descriptors_texture(
     DvzDescriptors* descriptors, uint32_t idx, DvzImages* img, DvzSampler* sampler);
 
+/**
+ * Bind an input attachment to a slot.
+ *
+ * @param descriptors the descriptors
+ * @param idx the slot index
+ * @param img the attachment images, one per descriptor set
+ */
+void dvz_descriptors_attachment(DvzDescriptors* descriptors, uint32_t idx, DvzImages* img);
+
 /**
  * Update the descriptors after the buffers/textures have been set up.
  *
@@ -1483,6 +1610,15 @@ void dvz_compute_create(DvzCompute* compute);
  */
 void dvz_compute_code(DvzCompute* compute, const char* code);
 
+/**
+ * Set the SPIR-V bytecode directly.
+ *
+ * @param compute the compute pipeline
+ * @param size the size of the SPIR-V buffer, in bytes
+ * @param buffer the SPIR-V bytecode, which must remain alive until the compute is created
+ */
+void dvz_compute_spirv(DvzCompute* compute, VkDeviceSize size, const uint32_t* buffer);
+
 /**
  * Declare a slot for the compute pipeline.
  *
@@ -1641,9 +1777,10 @@ void dvz_graphics_depth_test(DvzGraphics* graphics, DvzDepthTest depth_test);
  * Set whether the graphics pipeline supports picking.
  *
  * !!! note
- *     Picking support is currently all or nothing: all graphics of a canvas must either support
- *     picking or not. In addition, the canvas must have been created with the
- *     DVZ_CANVAS_FLAGS_PICK flag.
+ *     Picking support is all or nothing: all graphics of a canvas must either support picking or
+ *     not. The recorder takes care of this automatically with dvz_graphics_variant(), based on
+ *     the renderpass of the canvas. Only graphics created with DVZ_GRAPHICS_FLAGS_PICK write into
+ *     the pick attachment, the others leave it untouched.
  *
  * @param graphics the graphics pipeline
  * @param support_pick whether the graphics pipeline supports picking
@@ -1681,6 +1818,19 @@ void dvz_graphics_front_face(DvzGraphics* graphics, VkFrontFace front_face);
  */
 void dvz_graphics_create(DvzGraphics* graphics);
 
+/**
+ * Select the pipeline bound by dvz_cmd_bind_graphics(), for a given renderpass.
+ *
+ * The main pipeline is used if the renderpass is compatible with the one of the graphics.
+ * Otherwise, a variant of the pipeline is created for this renderpass, with the same state, the
+ * first time it is needed. The variants are only destroyed with the graphics, never while command
+ * buffers may still use them.
+ *
+ * @param graphics the created graphics pipeline
+ * @param renderpass the renderpass the commands are recorded into
+ */
+void dvz_graphics_variant(DvzGraphics* graphics, DvzRenderpass* renderpass);
+
 /**
  * Set a descriptor slot for a graphics pipeline.
  *
@@ -1745,6 +1895,15 @@ DvzBarrier dvz_barrier(DvzGpu* gpu);
 void dvz_barrier_stages(
     DvzBarrier* barrier, VkPipelineStageFlags src_stage, VkPipelineStageFlags dst_stage);
 
+/**
+ * Add a global memory barrier, covering all buffers and images.
+ *
+ * @param barrier the barrier
+ * @param src_access the source access flags
+ * @param dst_access the destination access flags
+ */
+void dvz_barrier_memory(DvzBarrier* barrier, VkAccessFlags src_access, VkAccessFlags dst_access);
+
 /**
  * Set the barrier buffer.
  *
@@ -1906,6 +2065,42 @@ void dvz_fences_destroy(DvzFences* fences);
 
 
 
+/*************************************************************************************************/
+/*  Queries                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Create a query pool.
+ *
+ * The queries must be reset with dvz_cmd_reset_queries() before being written.
+ *
+ * @param gpu the GPU
+ * @param type the query type, for example VK_QUERY_TYPE_TIMESTAMP
+ * @param count the number of queries in the pool
+ * @returns the queries
+ */
+DvzQueries dvz_queries(DvzGpu* gpu, VkQueryType type, uint32_t count);
+
+/**
+ * Retrieve the results of consecutive queries, without waiting for the GPU.
+ *
+ * @param queries the queries
+ * @param first the first query
+ * @param count the number of queries
+ * @param[out] values the query results, a buffer holding at least `count` uint64_t values
+ * @returns whether all of the queries were available, otherwise `values` is left unchanged
+ */
+bool dvz_queries_results(DvzQueries* queries, uint32_t first, uint32_t count, uint64_t* values);
+
+/**
+ * Destroy a query pool.
+ *
+ * @param queries the queries
+ */
+void dvz_queries_destroy(DvzQueries* queries);
+
+
+
 /*************************************************************************************************/
 /*  Renderpass                                                                                   */
 /*************************************************************************************************/
@@ -1972,6 +2167,16 @@ void dvz_renderpass_attachment_ops(
 void dvz_renderpass_subpass_attachment(
     DvzRenderpass* renderpass, uint32_t subpass_idx, uint32_t attachment_idx);
 
+/**
+ * Set a subpass input attachment.
+ *
+ * @param renderpass the render pass
+ * @param subpass_idx the subpass index
+ * @param attachment_idx the attachment index
+ */
+void dvz_renderpass_subpass_input(
+    DvzRenderpass* renderpass, uint32_t subpass_idx, uint32_t attachment_idx);
+
 /**
  * Set a subpass dependency.
  *
@@ -2146,6 +2351,39 @@ void dvz_cmd_begin_renderpass(
  */
 void dvz_cmd_end_renderpass(DvzCommands* cmds, uint32_t idx);
 
+/**
+ * Move on to the next subpass of the current render pass.
+ *
+ * @param cmds the set of command buffers to record
+ * @param idx the index of the command buffer to record
+ */
+void dvz_cmd_next_subpass(DvzCommands* cmds, uint32_t idx);
+
+/**
+ * Reset consecutive queries. Must be recorded outside of a render pass.
+ *
+ * @param cmds the set of command buffers to record
+ * @param idx the index of the command buffer to record
+ * @param queries the queries
+ * @param first the first query to reset
+ * @param count the number of queries to reset
+ */
+void dvz_cmd_reset_queries(
+    DvzCommands* cmds, uint32_t idx, DvzQueries* queries, uint32_t first, uint32_t count);
+
+/**
+ * Write a GPU timestamp once all previous commands have reached a given pipeline stage.
+ *
+ * @param cmds the set of command buffers to record
+ * @param idx the index of the command buffer to record
+ * @param queries the timestamp queries
+ * @param query the query to write
+ * @param stage the pipeline stage
+ */
+void dvz_cmd_timestamp(
+    DvzCommands* cmds, uint32_t idx, DvzQueries* queries, uint32_t query,
+    VkPipelineStageFlagBits stage);
+
 /**
  * Launch a compute task.
  *
@@ -2321,6 +2559,20 @@ void dvz_cmd_draw_indirect(
 void dvz_cmd_draw_indexed_indirect(
     DvzCommands* cmds, uint32_t idx, DvzBufferRegions indirect, uint32_t draw_count);
 
+/**
+ * Fill a region of a GPU buffer with a 32-bit value.
+ *
+ * @param cmds the set of command buffers to record
+ * @param idx the index of the command buffer to record
+ * @param buffer the buffer
+ * @param offset the offset in the buffer, in bytes, a multiple of 4
+ * @param size the size of the region to fill, in bytes, a multiple of 4
+ * @param value the value
+ */
+void dvz_cmd_fill_buffer(
+    DvzCommands* cmds, uint32_t idx, DvzBuffer* buffer, VkDeviceSize offset, VkDeviceSize size,
+    uint32_t value);
+
 /**
  * Copy a GPU buffer to another.
  *
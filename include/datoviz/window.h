@@ -60,6 +60,7 @@ struct DvzWindow
     uint32_t framebuffer_width, framebuffer_height; // framebuffer size
     DvzGuiWindow* gui_window;
     bool is_captured; // false by default (Datoviz interactivity), true when ImGui processes events
+    bool redraw;      // on-demand rendering: whether the window needs a new frame
 
     bool is_fullscreen;
     uint32_t _width, _height;      // Window size and position before fullscreen.
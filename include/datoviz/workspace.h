@@ -62,6 +62,11 @@ struct DvzWorkspace
     DvzRenderpass renderpass_offscreen;
     DvzRenderpass renderpass_desktop;
     DvzRenderpass renderpass_overlay; // if overlay, same renderpass between offscreen and desktop
+
+    // Same as above, with additional attachments (DVZ_CANVAS_FLAGS_PICK, DVZ_CANVAS_FLAGS_OIT),
+    // indexed by DvzRenderpassFlags. The first item (no additional attachment) is not used.
+    DvzRenderpass renderpass_ext_offscreen[DVZ_RENDERPASS_FLAGS_COUNT];
+    DvzRenderpass renderpass_ext_desktop[DVZ_RENDERPASS_FLAGS_COUNT];
 };
 
 
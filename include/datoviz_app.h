@@ -212,6 +212,24 @@ DVZ_EXPORT void dvz_app_timestamps(
 
 
 
+/**
+ * Return the GPU durations of the views and visual draws of a canvas, a few frames behind.
+ *
+ * The canvas must have been created with DVZ_CANVAS_FLAGS_PROFILE. Views are identified by the
+ * id of their viewport dat, visuals by the id of their graphics pipeline.
+ *
+ * @param app the app
+ * @param canvas_id the ID of the canvas
+ * @param count the size of the output arrays
+ * @param[out] ids (array) a buffer holding at least `count` DvzId values
+ * @param[out] nanoseconds (array) a buffer holding at least `count` uint64_t values
+ * @returns the number of spans written in the output arrays
+ */
+DVZ_EXPORT uint32_t dvz_app_gpu_times(
+    DvzApp* app, DvzId canvas_id, uint32_t count, DvzId* ids, uint64_t* nanoseconds);
+
+
+
 /**
  * Wait until the GPU has finished processing.
  *
@@ -32,6 +32,7 @@ typedef enum
 {
     DVZ_APP_FLAGS_NONE = 0x000000,
     DVZ_APP_FLAGS_OFFSCREEN = 0x008000, // INTERNAL: also passed as CanvasFlags in visual_test.h
+    DVZ_APP_FLAGS_ON_DEMAND = 0x010000, // only redraw the canvases when something has changed
 
     // NOTE: must match DVZ_RENDERER_FLAGS_WHITE_BACKGROUND
     DVZ_APP_FLAGS_WHITE_BACKGROUND = 0x100000,
@@ -51,6 +52,8 @@ typedef enum
     DVZ_CANVAS_FLAGS_VSYNC = 0x0010,
     DVZ_CANVAS_FLAGS_PICK = 0x0020,
     DVZ_CANVAS_FLAGS_PUSH_SCALE = 0x0040, // HACK: shaders expect a push constant with scaling
+    DVZ_CANVAS_FLAGS_OIT = 0x0080,        // weighted blended order-independent transparency
+    DVZ_CANVAS_FLAGS_PROFILE = 0x0100,    // GPU timestamps per view and per visual draw
 } DvzCanvasFlags;
 
 
@@ -229,6 +232,8 @@ typedef enum
     DVZ_VISUAL_FLAGS_DEFAULT = 0x000000,
     DVZ_VISUAL_FLAGS_INDEXED = 0x010000,
     DVZ_VISUAL_FLAGS_INDIRECT = 0x020000,
+    DVZ_VISUAL_FLAGS_SCALAR = 0x040000, // one float per item, mapped to a color on the GPU
+    DVZ_VISUAL_FLAGS_PICK = 0x080000,   // write (visual, item) into the canvas pick attachment
 
     DVZ_VISUAL_FLAGS_FIXED_X = 0x001000,
     DVZ_VISUAL_FLAGS_FIXED_Y = 0x002000,
@@ -289,6 +294,8 @@ typedef enum
 {
     DVZ_TEX_FLAGS_NONE = 0x0000,               // default
     DVZ_TEX_FLAGS_PERSISTENT_STAGING = 0x2000, // (or recreate the staging buffer every time)
+    DVZ_TEX_FLAGS_STREAMING = 0x4000, // mapped staging ring, uploads do not wait for the GPU
+    DVZ_TEX_FLAGS_OCCUPANCY = 0x8000, // 3D: brick occupancy of the uploads, for volume rendering
 } DvzTexFlags;
 
 
@@ -350,6 +357,8 @@ typedef enum
     DVZ_RECORDER_VIEWPORT,
     DVZ_RECORDER_PUSH,
     DVZ_RECORDER_END,
+    DVZ_RECORDER_TIMESTAMP,
+    DVZ_RECORDER_DISPATCH,
     DVZ_RECORDER_COUNT, // Number of different recorder types
 } DvzRecorderCommandType;
 
@@ -370,6 +379,7 @@ typedef enum
     DVZ_REQUEST_ACTION_DOWNLOAD,
     DVZ_REQUEST_ACTION_SET,
     DVZ_REQUEST_ACTION_GET,
+    DVZ_REQUEST_ACTION_DISPATCH,
 } DvzRequestAction;
 
 
@@ -402,6 +412,7 @@ typedef enum
     DVZ_REQUEST_OBJECT_BACKGROUND,
 
     DVZ_REQUEST_OBJECT_RECORD, // use recorder.h
+    DVZ_REQUEST_OBJECT_PICK,
 } DvzRequestObject;
 
 
@@ -840,6 +851,7 @@ typedef enum
     DVZ_VOLUME_FLAGS_RGBA = 0x0001,
     DVZ_VOLUME_FLAGS_COLORMAP = 0x0002,
     DVZ_VOLUME_FLAGS_BACK_FRONT = 0x0004,
+    DVZ_VOLUME_FLAGS_BRICKED = 0x0008,
 } DvzVolumeFlags;
 
 
@@ -903,6 +915,16 @@ typedef enum
 
 
 
+// Spatial index type.
+typedef enum
+{
+    DVZ_SPATIAL_NONE,
+    DVZ_SPATIAL_POINTS, // uniform 2D grid over the positions (points, markers)
+    DVZ_SPATIAL_MESH,   // bounding volume hierarchy over the triangles (meshes)
+} DvzSpatialType;
+
+
+
 // NOTE: must correspond to values in common.glsl
 typedef enum
 {
@@ -345,6 +345,24 @@ dvz_resize_canvas(DvzBatch* batch, DvzId canvas, uint32_t width, uint32_t height
 
 
 
+/**
+ * Create a request to pick the visual item closest to a position in a canvas.
+ *
+ * The canvas must have been created with DVZ_CANVAS_FLAGS_PICK. The pick attachment of the last
+ * rendered frame is read back asynchronously, the result is retrieved with dvz_renderer_pick().
+ *
+ * @param batch the batch
+ * @param canvas the canvas id
+ * @param x the x framebuffer coordinate
+ * @param y the y framebuffer coordinate
+ * @param radius the search radius, in framebuffer pixels
+ * @returns the request
+ */
+DVZ_EXPORT DvzRequest
+dvz_pick(DvzBatch* batch, DvzId canvas, int32_t x, int32_t y, uint32_t radius);
+
+
+
 /**
  * Create a request for a canvas deletion.
  *
@@ -536,6 +554,19 @@ DVZ_EXPORT DvzRequest dvz_create_spirv(
 
 
 
+/**
+ * Create a request for shader deletion.
+ *
+ * The shader must not be used by any graphics or compute pipe that has not been deleted.
+ *
+ * @param batch the batch
+ * @param id the shader id
+ * @returns the request
+ */
+DVZ_EXPORT DvzRequest dvz_delete_shader(DvzBatch* batch, DvzId id);
+
+
+
 /*************************************************************************************************/
 /*  Graphics                                                                                     */
 /*************************************************************************************************/
@@ -741,6 +772,52 @@ DVZ_EXPORT DvzRequest dvz_delete_graphics(DvzBatch* batch, DvzId id);
 
 
 
+/*************************************************************************************************/
+/*  Computes                                                                                     */
+/*************************************************************************************************/
+
+/**
+ * Create a request for a compute pipe creation.
+ *
+ * The slots and push constants of the compute pipe are declared with dvz_set_slot() and
+ * dvz_set_push(), and its dats are bound with dvz_bind_dat(), passing the compute id instead of
+ * a graphics id.
+ *
+ * @param batch the batch
+ * @param shader the id of the compute shader
+ * @param flags the compute creation flags
+ * @returns the request, containing a newly-generated id for the compute pipe to be created
+ */
+DVZ_EXPORT DvzRequest dvz_create_compute(DvzBatch* batch, DvzId shader, int flags);
+
+
+
+/**
+ * Create a request for dispatching a compute pipe.
+ *
+ * The renderer runs the compute synchronously: the bound dats can be downloaded or used by
+ * graphics pipes in the next requests.
+ *
+ * @param batch the batch
+ * @param compute the id of the compute pipe
+ * @param group_count the number of workgroups along the three dimensions
+ * @returns the request
+ */
+DVZ_EXPORT DvzRequest dvz_dispatch_compute(DvzBatch* batch, DvzId compute, uvec3 group_count);
+
+
+
+/**
+ * Create a request for compute deletion.
+ *
+ * @param batch the batch
+ * @param id the compute id
+ * @returns the request
+ */
+DVZ_EXPORT DvzRequest dvz_delete_compute(DvzBatch* batch, DvzId id);
+
+
+
 /*************************************************************************************************/
 /*  Bindings                                                                                     */
 /*************************************************************************************************/
@@ -920,6 +997,42 @@ DVZ_EXPORT DvzRequest dvz_record_push(
 
 
 
+/**
+ * Create a request for writing a GPU timestamp while recording a command buffer.
+ *
+ * The timestamps bracket spans whose GPU durations can be retrieved on canvases created with
+ * DVZ_CANVAS_FLAGS_PROFILE, and are ignored on other canvases.
+ *
+ * @param batch the batch
+ * @param canvas_id the id of the canvas
+ * @param id the span id, for example the id of a graphics pipeline
+ * @param end whether the timestamp ends the span, or begins it
+ * @returns the request
+ */
+DVZ_EXPORT DvzRequest dvz_record_timestamp(DvzBatch* batch, DvzId canvas_id, DvzId id, bool end);
+
+
+
+/**
+ * Create a request for a compute dispatch while recording a command buffer.
+ *
+ * The dispatch is recorded in the command buffer of the canvas before its renderpass begins, so
+ * that the kernel runs at every frame without synchronizing the queues. If an indirect dat is
+ * given, the count of its first draw command is reset before the dispatch, and the draws after
+ * the dispatch read the indirect and index buffers written by the kernel.
+ *
+ * @param batch the batch
+ * @param canvas_id the id of the canvas
+ * @param compute the id of the compute pipe
+ * @param group_count the number of workgroups in each dimension
+ * @param indirect the id of the indirect dat written by the kernel, or 0
+ * @returns the request
+ */
+DVZ_EXPORT DvzRequest dvz_record_dispatch(
+    DvzBatch* batch, DvzId canvas_id, DvzId compute, uvec3 group_count, DvzId indirect);
+
+
+
 /**
  * Create a request for ending recording of command buffer.
  *
@@ -60,6 +60,8 @@ typedef struct DvzRequestShader DvzRequestShader;
 typedef struct DvzRequestDatUpload DvzRequestDatUpload;
 typedef struct DvzRequestTexUpload DvzRequestTexUpload;
 typedef struct DvzRequestGraphics DvzRequestGraphics;
+typedef struct DvzRequestCompute DvzRequestCompute;
+typedef struct DvzRequestDispatch DvzRequestDispatch;
 typedef struct DvzRequestPrimitive DvzRequestPrimitive;
 typedef struct DvzRequestBlend DvzRequestBlend;
 typedef struct DvzRequestMask DvzRequestMask;
@@ -78,12 +80,16 @@ typedef struct DvzRequestBindIndex DvzRequestBindIndex;
 typedef struct DvzRequestBindDat DvzRequestBindDat;
 typedef struct DvzRequestBindTex DvzRequestBindTex;
 typedef struct DvzRequestRecord DvzRequestRecord;
+typedef struct DvzRequestPick DvzRequestPick;
 typedef struct DvzRequest DvzRequest;
 typedef union DvzRequestContent DvzRequestContent;
 
 typedef struct DvzRequester DvzRequester;
 typedef struct DvzBatch DvzBatch;
 
+// Picking.
+typedef struct DvzPick DvzPick;
+
 // Qt.
 typedef struct DvzQtApp DvzQtApp;
 typedef struct QApplication QApplication;
@@ -96,6 +102,8 @@ typedef struct DvzRecorderDraw DvzRecorderDraw;
 typedef struct DvzRecorderDrawIndexed DvzRecorderDrawIndexed;
 typedef struct DvzRecorderDrawIndirect DvzRecorderDrawIndirect;
 typedef struct DvzRecorderDrawIndexedIndirect DvzRecorderDrawIndexedIndirect;
+typedef struct DvzRecorderTimestamp DvzRecorderTimestamp;
+typedef struct DvzRecorderDispatch DvzRecorderDispatch;
 typedef union DvzRecorderUnion DvzRecorderUnion;
 typedef struct DvzRecorderCommand DvzRecorderCommand;
 
@@ -104,8 +112,10 @@ typedef struct DvzTimerItem DvzTimerItem;
 typedef struct DvzGuiWindow DvzGuiWindow;
 typedef struct DvzApp DvzApp;
 typedef struct DvzAtlas DvzAtlas;
+typedef struct DvzBricks DvzBricks;
 typedef struct DvzFont DvzFont;
 typedef struct DvzList DvzList;
+typedef struct DvzTiles DvzTiles;
 typedef struct DvzFifo DvzFifo;
 
 // Callback types.
@@ -115,6 +125,10 @@ typedef void (*DvzAppKeyboardCallback)(DvzApp* app, DvzId window_id, DvzKeyboard
 typedef void (*DvzAppFrameCallback)(DvzApp* app, DvzId window_id, DvzFrameEvent* ev);
 typedef void (*DvzAppTimerCallback)(DvzApp* app, DvzId window_id, DvzTimerEvent* ev);
 typedef void (*DvzAppResizeCallback)(DvzApp* app, DvzId window_id, DvzWindowEvent* ev);
+typedef void (*DvzBricksCallback)(
+    DvzBricks* bricks, uint32_t level, uvec3 offset, uvec3 shape, void* out, void* user_data);
+typedef void (*DvzTilesCallback)(
+    DvzTiles* tiles, uint32_t level, uint32_t x, uint32_t y, void* out, void* user_data);
 
 
 
@@ -348,6 +362,19 @@ struct DvzRecorderDrawIndexedIndirect
     uint32_t draw_count;
 };
 
+struct DvzRecorderTimestamp
+{
+    DvzId id; // span id
+    bool end; // whether the timestamp ends the span, or begins it
+};
+
+struct DvzRecorderDispatch
+{
+    DvzId pipe_id;
+    uvec3 group_count;
+    DvzId dat_indirect_id; // indirect draw command written by the kernel, may be 0
+};
+
 union DvzRecorderUnion
 {
     // Viewport.
@@ -367,6 +394,12 @@ union DvzRecorderUnion
 
     // Indexed indirect draw.
     DvzRecorderDrawIndexedIndirect draw_indexed_indirect;
+
+    // GPU timestamp.
+    DvzRecorderTimestamp timestamp;
+
+    // Compute dispatch.
+    DvzRecorderDispatch dispatch;
 };
 
 struct DvzRecorderCommand
@@ -447,6 +480,16 @@ struct DvzRequestGraphics
     DvzGraphicsType type;
 };
 
+struct DvzRequestCompute
+{
+    DvzId shader; // compute shader, created with dvz_create_glsl() or dvz_create_spirv()
+};
+
+struct DvzRequestDispatch
+{
+    uvec3 group_count; // number of workgroups along x, y, z
+};
+
 struct DvzRequestPrimitive
 {
     DvzPrimitiveTopology primitive;
@@ -556,6 +599,13 @@ struct DvzRequestRecord
     DvzRecorderCommand command;
 };
 
+struct DvzRequestPick
+{
+    int32_t x; // framebuffer coordinates of the picked position
+    int32_t y;
+    uint32_t radius; // search radius, in framebuffer pixels
+};
+
 
 
 union DvzRequestContent
@@ -584,6 +634,12 @@ union DvzRequestContent
     // Graphics.
     DvzRequestGraphics graphics;
 
+    // Compute.
+    DvzRequestCompute compute;
+
+    // Dispatch a compute.
+    DvzRequestDispatch dispatch;
+
     // Set primitive.
     DvzRequestPrimitive set_primitive;
 
@@ -637,6 +693,9 @@ union DvzRequestContent
 
     // Record a command.
     DvzRequestRecord record;
+
+    // Pick the item under a position.
+    DvzRequestPick pick;
 };
 
 
@@ -682,4 +741,14 @@ struct DvzRequester
 
 
 
+struct DvzPick
+{
+    uint32_t visual; // pick id of the closest visual, 0 if nothing was hit
+    uint32_t item;   // item index within that visual
+    int32_t x;       // framebuffer coordinates of the closest hit
+    int32_t y;
+};
+
+
+
 #endif
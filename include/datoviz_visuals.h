@@ -38,9 +38,11 @@
 typedef struct DvzApp DvzApp;
 typedef struct DvzAtlas DvzAtlas;
 typedef struct DvzBatch DvzBatch;
+typedef struct DvzBricks DvzBricks;
 typedef struct DvzShape DvzShape;
 typedef struct DvzTex DvzTex;
 typedef struct DvzTexture DvzTexture;
+typedef struct DvzTiles DvzTiles;
 typedef struct DvzVisual DvzVisual;
 
 
@@ -92,6 +94,23 @@ dvz_basic_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor* val
 
 
 
+/**
+ * Set the vertex scalar values, mapped to colors on the GPU.
+ *
+ * The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+ * range are set with `dvz_visual_colormap()`.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to update
+ * @param count the number of items to update
+ * @param values the scalar values of the items to update
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void
+dvz_basic_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags);
+
+
+
 /**
  * Set the vertex group index.
  *
@@ -182,6 +201,23 @@ dvz_pixel_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor* val
 
 
 
+/**
+ * Set the pixel scalar values, mapped to colors on the GPU.
+ *
+ * The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+ * range are set with `dvz_visual_colormap()`.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to update
+ * @param count the number of items to update
+ * @param values the scalar values of the items to update
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void
+dvz_pixel_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags);
+
+
+
 /**
  * Set the pixel size.
  *
@@ -259,6 +295,23 @@ dvz_point_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor* val
 
 
 
+/**
+ * Set the point scalar values, mapped to colors on the GPU.
+ *
+ * The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+ * range are set with `dvz_visual_colormap()`.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to update
+ * @param count the number of items to update
+ * @param values the scalar values of the items to update
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void
+dvz_point_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags);
+
+
+
 /**
  * Allocate memory for a visual.
  *
@@ -372,6 +425,23 @@ dvz_marker_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor* va
 
 
 
+/**
+ * Set the marker scalar values, mapped to colors on the GPU.
+ *
+ * The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+ * range are set with `dvz_visual_colormap()`.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to update
+ * @param count the number of items to update
+ * @param values the scalar values of the items to update
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void
+dvz_marker_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags);
+
+
+
 /**
  * Set the marker edge color.
  *
@@ -561,6 +631,23 @@ dvz_path_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor* valu
 
 
 
+/**
+ * Set the path scalar values, mapped to colors on the GPU.
+ *
+ * The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+ * range are set with `dvz_visual_colormap()`.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to update
+ * @param count the number of items to update
+ * @param values the scalar values of the items to update
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void
+dvz_path_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags);
+
+
+
 /**
  * Set the path line width (may be variable along a path).
  *
@@ -715,6 +802,9 @@ dvz_glyph_shift(DvzVisual* visual, uint32_t first, uint32_t count, vec2* values,
 /**
  * Set the glyph texture coordinates.
  *
+ * The coordinates are normalized. With an atlas font, they are relative to the current atlas
+ * shape, and this function must be called after `dvz_glyph_atlas_font()`.
+ *
  * @param visual the visual
  * @param first the index of the first item to update
  * @param count the number of items to update
@@ -1086,6 +1176,20 @@ DVZ_EXPORT void dvz_image_texture(DvzVisual* visual, DvzTexture* texture);
 
 
 
+/**
+ * Display a tiled multiresolution image in an image visual.
+ *
+ * The visual must have been created with the `DVZ_IMAGE_FLAGS_SIZE_NDC` and
+ * `DVZ_IMAGE_FLAGS_RESCALE` flags. Each item of the visual is a tile, and the items are updated
+ * by `dvz_tiles_update()`.
+ *
+ * @param visual the visual
+ * @param tiles the tiles
+ */
+DVZ_EXPORT void dvz_image_tiles(DvzVisual* visual, DvzTiles* tiles);
+
+
+
 /**
  * Set the edge color.
  *
@@ -1291,6 +1395,23 @@ dvz_mesh_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor* valu
 
 
 
+/**
+ * Set the mesh scalar values, mapped to colors on the GPU.
+ *
+ * The visual must be created with the `DVZ_VISUAL_FLAGS_SCALAR` flag, and the colormap and the
+ * range are set with `dvz_visual_colormap()`.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to update
+ * @param count the number of items to update
+ * @param values the scalar values of the items to update
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void
+dvz_mesh_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags);
+
+
+
 /**
  * Set the mesh texture coordinates.
  *
@@ -1668,6 +1789,9 @@ DVZ_EXPORT DvzVisual* dvz_volume(DvzBatch* batch, int flags);
 /**
  * Assign a 3D texture to a volume visual.
  *
+ * Create the texture with DVZ_TEX_FLAGS_OCCUPANCY so that the empty bricks of its initial data
+ * are skipped during ray marching.
+ *
  * @param visual the visual
  * @param texture the 3D texture
  */
@@ -1728,6 +1852,39 @@ DVZ_EXPORT void dvz_volume_transfer(DvzVisual* visual, vec4 transfer);
 
 
 
+/**
+ * Set the ray marching step size, as a fraction of the voxel size of the volume texture.
+ *
+ * @param visual the visual
+ * @param step the step size in voxels (1 by default)
+ */
+DVZ_EXPORT void dvz_volume_step(DvzVisual* visual, float step);
+
+
+
+/**
+ * Set the ray marching thresholds.
+ *
+ * @param visual the visual
+ * @param termination the accumulated alpha above which a ray stops (0.99 by default)
+ * @param empty the maximum alpha of the bricks of voxels skipped by the rays (0 by default)
+ */
+DVZ_EXPORT void dvz_volume_threshold(DvzVisual* visual, float termination, float empty);
+
+
+
+/**
+ * Assign a bricked volume to a volume visual.
+ *
+ * The visual must have been created with the `DVZ_VOLUME_FLAGS_BRICKED` flag.
+ *
+ * @param visual the visual
+ * @param bricks the bricked volume
+ */
+DVZ_EXPORT void dvz_volume_bricks(DvzVisual* visual, DvzBricks* bricks);
+
+
+
 /*************************************************************************************************/
 /*  Slice                                                                                        */
 /*************************************************************************************************/
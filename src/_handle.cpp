@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Dense handles                                                                                */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_handle.h"
+#include "_log.h"
+#include "_mutex.h"
+
+#include <vector>
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzHandleType
+{
+    std::vector<uint32_t> generations; // current generation of each slot
+    std::vector<uint32_t> free;        // freed slots, reused in LIFO order
+};
+
+
+
+extern "C" struct DvzHandles
+{
+    DvzHandleType types[DVZ_HANDLE_MAX_TYPES];
+    DvzMutex mutex;
+};
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzHandles* dvz_handles(void)
+{
+    log_trace("create handle allocator");
+    DvzHandles* handles = new DvzHandles();
+    handles->mutex = dvz_mutex();
+    return handles;
+}
+
+
+
+DvzId dvz_handles_alloc(DvzHandles* handles, uint32_t type)
+{
+    ANN(handles);
+    ASSERT(type < DVZ_HANDLE_MAX_TYPES);
+
+    dvz_mutex_lock(&handles->mutex);
+    DvzHandleType& ht = handles->types[type];
+    uint32_t index = 0;
+    if (!ht.free.empty())
+    {
+        index = ht.free.back();
+        ht.free.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)ht.generations.size();
+        ht.generations.push_back(0);
+    }
+    DvzId id = dvz_handle(type, index, ht.generations[index]);
+    dvz_mutex_unlock(&handles->mutex);
+
+    return id;
+}
+
+
+
+void dvz_handles_free(DvzHandles* handles, DvzId id)
+{
+    ANN(handles);
+    if (!dvz_handle_is_dense(id))
+        return;
+
+    uint32_t index = dvz_handle_index(id);
+    uint32_t generation = dvz_handle_generation(id);
+
+    dvz_mutex_lock(&handles->mutex);
+    DvzHandleType& ht = handles->types[dvz_handle_type(id)];
+    if (index >= ht.generations.size() || ht.generations[index] != generation)
+    {
+        log_warn("trying to free stale or unknown handle 0x%" PRIx64, id);
+    }
+    else
+    {
+        // NOTE: the generation wraps around after 2^24 reuses of the same slot.
+        ht.generations[index] = (generation + 1) % DVZ_HANDLE_GENERATIONS;
+        ht.free.push_back(index);
+    }
+    dvz_mutex_unlock(&handles->mutex);
+}
+
+
+
+void dvz_handles_destroy(DvzHandles* handles)
+{
+    if (handles == NULL)
+        return;
+    log_trace("delete handle allocator");
+    dvz_mutex_destroy(&handles->mutex);
+    delete handles;
+}
+
+
+
+DvzHandles* dvz_handles_global(void)
+{
+    // NOTE: thread-safe initialization of function-local statics.
+    static DvzHandles* handles = dvz_handles();
+    return handles;
+}
@@ -3,11 +3,13 @@
 /*************************************************************************************************/
 
 #include "_map.h"
+#include "_handle.h"
 #include "_log.h"
 
 #include <map>
 #include <numeric>
 #include <utility>
+#include <vector>
 
 
 
@@ -15,11 +17,25 @@
 /*  Structs                                                                                      */
 /*************************************************************************************************/
 
+struct DvzMapSlot
+{
+    bool used;
+    uint32_t generation;
+    int type;
+    void* value;
+};
+
+
+
 extern "C" struct DvzMap
 {
-    std::map<DvzId, std::pair<int, void*>> _map;
+    std::map<DvzId, std::pair<int, void*>> _map; // random IDs
     // DvzPrng* prng;
     // DvzId last_id;
+
+    // Dense handles: one slot array per handle type, indexed by the handle index.
+    std::vector<DvzMapSlot> _slots[DVZ_HANDLE_MAX_TYPES];
+    uint64_t _dense_count;
 };
 
 
@@ -49,6 +65,22 @@ Range<It> reverse(ORange&& originalRange)
 
 
 
+// Return the slot of a dense handle, or NULL if the handle is stale or unknown.
+static DvzMapSlot* _dense_slot(DvzMap* map, DvzId key)
+{
+    ASSERT(dvz_handle_is_dense(key));
+    std::vector<DvzMapSlot>& slots = map->_slots[dvz_handle_type(key)];
+    uint32_t index = dvz_handle_index(key);
+    if (index >= slots.size())
+        return NULL;
+    DvzMapSlot* slot = &slots[index];
+    if (!slot->used || slot->generation != dvz_handle_generation(key))
+        return NULL;
+    return slot;
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -68,6 +100,8 @@ bool dvz_map_exists(DvzMap* map, DvzId key)
     ANN(map);
     ASSERT(key != DVZ_ID_NONE);
 
+    if (dvz_handle_is_dense(key))
+        return _dense_slot(map, key) != NULL;
     return map->_map.count(key) > 0;
 }
 
@@ -79,6 +113,22 @@ void dvz_map_add(DvzMap* map, DvzId key, int type, void* value)
     ASSERT(key > 0);
     ANN(value);
 
+    if (dvz_handle_is_dense(key))
+    {
+        std::vector<DvzMapSlot>& slots = map->_slots[dvz_handle_type(key)];
+        uint32_t index = dvz_handle_index(key);
+        if (index >= slots.size())
+            slots.resize(index + 1, DvzMapSlot{false, 0, 0, NULL});
+        if (slots[index].used)
+        {
+            log_warn("handle 0x%" PRIx64 " already exists (type %d)", key, type);
+            return;
+        }
+        slots[index] = DvzMapSlot{true, dvz_handle_generation(key), type, value};
+        map->_dense_count++;
+        return;
+    }
+
     if (map->_map.count(key) > 0)
     {
         log_warn("key 0x%" PRIx64 " already exists (type %d)", key, type);
@@ -97,6 +147,17 @@ void dvz_map_remove(DvzMap* map, DvzId key)
     ANN(map);
     ASSERT(key != DVZ_ID_NONE);
 
+    if (dvz_handle_is_dense(key))
+    {
+        DvzMapSlot* slot = _dense_slot(map, key);
+        if (slot != NULL)
+        {
+            *slot = DvzMapSlot{false, 0, 0, NULL};
+            map->_dense_count--;
+        }
+        return;
+    }
+
     if (dvz_map_exists(map, key))
         map->_map.erase(key);
 }
@@ -112,10 +173,14 @@ void* dvz_map_get(DvzMap* map, DvzId key)
         return NULL;
     }
 
-    if (dvz_map_exists(map, key))
-        return map->_map[key].second;
-    else
-        return NULL;
+    if (dvz_handle_is_dense(key))
+    {
+        DvzMapSlot* slot = _dense_slot(map, key);
+        return slot != NULL ? slot->value : NULL;
+    }
+
+    auto it = map->_map.find(key);
+    return it != map->_map.end() ? it->second.second : NULL;
 }
 
 
@@ -125,10 +190,14 @@ int dvz_map_type(DvzMap* map, DvzId key)
     ANN(map);
     ASSERT(key != DVZ_ID_NONE);
 
-    if (dvz_map_exists(map, key))
-        return map->_map[key].first;
-    else
-        return 0;
+    if (dvz_handle_is_dense(key))
+    {
+        DvzMapSlot* slot = _dense_slot(map, key);
+        return slot != NULL ? slot->type : 0;
+    }
+
+    auto it = map->_map.find(key);
+    return it != map->_map.end() ? it->second.first : 0;
 }
 
 
@@ -138,7 +207,7 @@ uint64_t dvz_map_count(DvzMap* map, int type)
     ANN(map);
 
     if (type == 0)
-        return map->_map.size();
+        return map->_map.size() + map->_dense_count;
     else
     {
         uint64_t count = 0;
@@ -147,6 +216,10 @@ uint64_t dvz_map_count(DvzMap* map, int type)
             if (pair.first == type)
                 count++;
         }
+        for (const auto& slots : map->_slots)
+            for (const auto& slot : slots)
+                if (slot.used && slot.type == type)
+                    count++;
         return count;
     }
 }
@@ -162,6 +235,10 @@ void* dvz_map_first(DvzMap* map, int type)
         if (type == 0 || pair.first == type)
             return pair.second;
     }
+    for (const auto& slots : map->_slots)
+        for (const auto& slot : slots)
+            if (slot.used && (type == 0 || slot.type == type))
+                return slot.value;
     log_trace("no item with type %d found in map", type);
     return NULL;
 }
@@ -171,6 +248,10 @@ void* dvz_map_first(DvzMap* map, int type)
 void* dvz_map_last(DvzMap* map, int type)
 {
     ANN(map);
+    for (const auto& slots : reverse(map->_slots))
+        for (const auto& slot : reverse(slots))
+            if (slot.used && (type == 0 || slot.type == type))
+                return slot.value;
     for (const auto& [id, pair] : reverse(map->_map))
     {
         if (type == 0 || pair.first == type)
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Trace events                                                                                 */
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_trace.h"
+#include "_log.h"
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzTraceEvent
+{
+    const char* cat;
+    const char* name;
+    const char* keys[2];
+    int64_t vals[2];
+    uint64_t ts; // nanoseconds since the trace epoch
+    char phase;  // 'B' (begin), 'E' (end), 'i' (instant)
+};
+
+
+
+// NOTE: only the owning thread writes into its buffer. The writer publishes the events with a
+// release store of the count, the JSON export reads them after an acquire load. A buffer lives
+// as long as its thread, it is only freed by dvz_trace_clear() once the thread has exited.
+struct DvzTraceBuffer
+{
+    uint32_t tid;
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> count;
+    uint64_t dropped;
+    bool exited; // protected by the trace lock
+    DvzTraceEvent* chunks[DVZ_TRACE_MAX_CHUNKS];
+};
+
+
+
+// Mark the buffer of a thread as exited when the thread ends.
+struct DvzTraceLocal
+{
+    DvzTraceBuffer* buffer;
+    ~DvzTraceLocal();
+};
+
+
+
+/*************************************************************************************************/
+/*  Globals                                                                                      */
+/*************************************************************************************************/
+
+static std::atomic<bool> TRACE_ENABLED{false};
+
+// NOTE: the lock is only taken the first time a thread records an event, when a thread exits,
+// and when exporting.
+static std::mutex TRACE_LOCK;
+static std::vector<DvzTraceBuffer*> TRACE_BUFFERS;
+static uint32_t TRACE_NEXT_TID = 1;
+
+static const std::chrono::steady_clock::time_point TRACE_EPOCH = std::chrono::steady_clock::now();
+
+static thread_local DvzTraceLocal TRACE_LOCAL;
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static inline uint64_t _trace_now(void)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - TRACE_EPOCH)
+        .count();
+}
+
+
+
+static void _trace_free(DvzTraceBuffer* buffer)
+{
+    for (uint32_t i = 0; i < DVZ_TRACE_MAX_CHUNKS; i++)
+        free(buffer->chunks[i]);
+    delete buffer;
+}
+
+
+
+DvzTraceLocal::~DvzTraceLocal()
+{
+    if (buffer == nullptr)
+        return;
+    std::lock_guard<std::mutex> guard(TRACE_LOCK);
+    buffer->exited = true;
+    buffer = nullptr;
+}
+
+
+
+// Return the buffer of the calling thread, registering it if needed.
+static DvzTraceBuffer* _trace_buffer(void)
+{
+    if (TRACE_LOCAL.buffer != nullptr)
+        return TRACE_LOCAL.buffer;
+
+    DvzTraceBuffer* buffer = new DvzTraceBuffer();
+    buffer->name = nullptr;
+    buffer->count = 0;
+    buffer->dropped = 0;
+    buffer->exited = false;
+    for (uint32_t i = 0; i < DVZ_TRACE_MAX_CHUNKS; i++)
+        buffer->chunks[i] = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(TRACE_LOCK);
+        buffer->tid = TRACE_NEXT_TID++;
+        TRACE_BUFFERS.push_back(buffer);
+    }
+
+    TRACE_LOCAL.buffer = buffer;
+    return buffer;
+}
+
+
+
+static void _trace_event(
+    char phase, const char* cat, const char* name, const char* key0, int64_t val0,
+    const char* key1, int64_t val1)
+{
+    if (!TRACE_ENABLED.load(std::memory_order_relaxed))
+        return;
+
+    DvzTraceBuffer* buffer = _trace_buffer();
+    uint64_t count = buffer->count.load(std::memory_order_relaxed);
+    uint64_t chunk = count / DVZ_TRACE_CHUNK_SIZE;
+    if (chunk >= DVZ_TRACE_MAX_CHUNKS)
+    {
+        buffer->dropped++;
+        return;
+    }
+    if (buffer->chunks[chunk] == nullptr)
+        buffer->chunks[chunk] =
+            (DvzTraceEvent*)calloc(DVZ_TRACE_CHUNK_SIZE, sizeof(DvzTraceEvent));
+
+    DvzTraceEvent* ev = &buffer->chunks[chunk][count % DVZ_TRACE_CHUNK_SIZE];
+    ev->phase = phase;
+    ev->cat = cat;
+    ev->name = name;
+    ev->keys[0] = key0;
+    ev->vals[0] = val0;
+    ev->keys[1] = key1;
+    ev->vals[1] = val1;
+    ev->ts = _trace_now();
+
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+
+
+static void _trace_string(FILE* f, const char* s)
+{
+    fputc('"', f);
+    for (; s != nullptr && *s != 0; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+
+
+static void _trace_write_event(FILE* f, uint32_t tid, DvzTraceEvent* ev)
+{
+    fprintf(
+        f, "{\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", ev->phase, tid,
+        (double)ev->ts / 1000.0);
+    if (ev->phase == 'E')
+    {
+        fputs("}", f);
+        return;
+    }
+
+    fputs(",\"cat\":", f);
+    _trace_string(f, ev->cat);
+    fputs(",\"name\":", f);
+    _trace_string(f, ev->name);
+    if (ev->phase == 'i')
+        fputs(",\"s\":\"t\"", f);
+
+    if (ev->keys[0] != nullptr)
+    {
+        fputs(",\"args\":{", f);
+        for (uint32_t k = 0; k < 2 && ev->keys[k] != nullptr; k++)
+        {
+            if (k > 0)
+                fputc(',', f);
+            _trace_string(f, ev->keys[k]);
+            fprintf(f, ":%lld", (long long)ev->vals[k]);
+        }
+        fputc('}', f);
+    }
+    fputs("}", f);
+}
+
+
+
+/*************************************************************************************************/
+/*  Trace functions                                                                              */
+/*************************************************************************************************/
+
+void dvz_trace_start(void)
+{
+    log_debug("start recording trace events");
+    TRACE_ENABLED.store(true, std::memory_order_release);
+}
+
+
+
+void dvz_trace_stop(void)
+{
+    log_debug("stop recording trace events");
+    TRACE_ENABLED.store(false, std::memory_order_release);
+}
+
+
+
+bool dvz_trace_enabled(void) { return TRACE_ENABLED.load(std::memory_order_relaxed); }
+
+
+
+void dvz_trace_thread(const char* name)
+{
+    if (!TRACE_ENABLED.load(std::memory_order_relaxed))
+        return;
+    _trace_buffer()->name.store(name, std::memory_order_release);
+}
+
+
+
+void dvz_trace_begin(const char* cat, const char* name)
+{
+    _trace_event('B', cat, name, nullptr, 0, nullptr, 0);
+}
+
+
+
+void dvz_trace_begin_args(
+    const char* cat, const char* name, const char* key0, int64_t val0, const char* key1,
+    int64_t val1)
+{
+    _trace_event('B', cat, name, key0, val0, key1, val1);
+}
+
+
+
+void dvz_trace_end(void) { _trace_event('E', nullptr, nullptr, nullptr, 0, nullptr, 0); }
+
+
+
+void dvz_trace_instant(const char* cat, const char* name)
+{
+    _trace_event('i', cat, name, nullptr, 0, nullptr, 0);
+}
+
+
+
+uint64_t dvz_trace_count(void)
+{
+    std::lock_guard<std::mutex> guard(TRACE_LOCK);
+    uint64_t count = 0;
+    for (DvzTraceBuffer* buffer : TRACE_BUFFERS)
+        count += buffer->count.load(std::memory_order_acquire);
+    return count;
+}
+
+
+
+int dvz_trace_write(const char* path)
+{
+    ANN(path);
+
+    FILE* f = fopen(path, "w");
+    if (f == nullptr)
+    {
+        log_error("unable to write the trace to %s", path);
+        return 1;
+    }
+
+    std::lock_guard<std::mutex> guard(TRACE_LOCK);
+    uint64_t total = 0;
+    bool first = true;
+    fputs("{\"traceEvents\":[\n", f);
+    for (DvzTraceBuffer* buffer : TRACE_BUFFERS)
+    {
+        // Thread name metadata.
+        const char* name = buffer->name.load(std::memory_order_acquire);
+        if (name != nullptr)
+        {
+            fprintf(
+                f, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{",
+                first ? "" : ",\n", buffer->tid);
+            fputs("\"name\":", f);
+            _trace_string(f, name);
+            fputs("}}", f);
+            first = false;
+        }
+
+        // NOTE: only the events published before this point are exported.
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        for (uint64_t i = 0; i < count; i++)
+        {
+            if (!first)
+                fputs(",\n", f);
+            _trace_write_event(
+                f, buffer->tid,
+                &buffer->chunks[i / DVZ_TRACE_CHUNK_SIZE][i % DVZ_TRACE_CHUNK_SIZE]);
+            first = false;
+        }
+        total += count;
+        if (buffer->dropped > 0)
+            log_warn(
+                "%" PRIu64 " trace events were dropped on thread %u", buffer->dropped,
+                buffer->tid);
+    }
+    fputs("\n],\"displayTimeUnit\":\"ms\"}\n", f);
+    fclose(f);
+
+    log_info("wrote %" PRIu64 " trace events to %s", total, path);
+    return 0;
+}
+
+
+
+void dvz_trace_clear(void)
+{
+    ASSERT(!TRACE_ENABLED.load(std::memory_order_acquire));
+
+    // NOTE: live threads keep a pointer to their buffer, so only the buffers of the exited threads
+    // are freed. The other buffers are emptied and keep their memory for the next recording.
+    std::lock_guard<std::mutex> guard(TRACE_LOCK);
+    std::vector<DvzTraceBuffer*> live;
+    for (DvzTraceBuffer* buffer : TRACE_BUFFERS)
+    {
+        if (buffer->exited)
+        {
+            _trace_free(buffer);
+            continue;
+        }
+        buffer->count.store(0, std::memory_order_release);
+        buffer->dropped = 0;
+        live.push_back(buffer);
+    }
+    TRACE_BUFFERS.swap(live);
+}
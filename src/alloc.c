@@ -115,6 +115,87 @@ DvzSize dvz_alloc_new(DvzAlloc* alloc, DvzSize req_size, DvzSize* resized)
 
 
 
+bool dvz_alloc_extend(DvzAlloc* alloc, DvzSize offset, DvzSize req_size)
+{
+    ANN(alloc);
+    ASSERT(req_size > 0);
+
+    DvzSize aligned_size = _align(req_size, alloc->alignment);
+    ASSERT(aligned_size > 0);
+
+    Block* current = alloc->blocks;
+    while (current != NULL && current->offset != offset)
+        current = current->next;
+    if (current == NULL || current->free)
+    {
+        log_error("no allocated item at offset %" PRIu64, offset);
+        return false;
+    }
+
+    // Merge the free blocks that follow the item (the blocks appended when the virtual buffer
+    // grows are not merged).
+    Block* next = current->next;
+    while (next != NULL && next->free && next->next != NULL && next->next->free)
+    {
+        Block* after = next->next;
+        next->size += after->size;
+        next->next = after->next;
+        FREE(after);
+    }
+
+    if (aligned_size > current->size)
+    {
+        // Grow into the next free block.
+        DvzSize extra = aligned_size - current->size;
+        if (next == NULL || !next->free || next->size < extra)
+            return false;
+        if (next->size == extra)
+        {
+            current->next = next->next;
+            FREE(next);
+        }
+        else
+        {
+            next->offset += extra;
+            next->size -= extra;
+        }
+        alloc->allocated_size += extra;
+    }
+    else if (aligned_size < current->size)
+    {
+        // Give the end of the item back to the next free block.
+        DvzSize extra = current->size - aligned_size;
+        if (next != NULL && next->free)
+        {
+            next->offset -= extra;
+            next->size += extra;
+        }
+        else
+        {
+            Block* new_block = create_block(current->offset + aligned_size, extra, 1);
+            new_block->next = next;
+            current->next = new_block;
+        }
+        ASSERT(alloc->allocated_size >= extra);
+        alloc->allocated_size -= extra;
+    }
+    current->size = aligned_size;
+    return true;
+}
+
+
+
+DvzSize dvz_alloc_capacity(DvzSize capacity, DvzSize req_size)
+{
+    if (req_size > capacity)
+        return MAX(req_size, 2 * capacity);
+    if (req_size > capacity / 4)
+        return capacity;
+    return MAX(req_size, capacity / 2);
+}
+
+
+
 void dvz_alloc_free(DvzAlloc* alloc, DvzSize offset)
 {
     ANN(alloc);
@@ -198,6 +279,153 @@ void dvz_alloc_stats(DvzAlloc* alloc)
 
 
 
+uint32_t dvz_alloc_compact(DvzAlloc* alloc, DvzAllocMove** out_moves)
+{
+    ANN(alloc);
+    ANN(out_moves);
+    *out_moves = NULL;
+
+    // First pass: count the allocated items that will move.
+    uint32_t count = 0;
+    DvzSize cursor = 0;
+    Block* current = alloc->blocks;
+    while (current != NULL)
+    {
+        if (!current->free)
+        {
+            if (current->offset != cursor)
+                count++;
+            cursor += current->size;
+        }
+        current = current->next;
+    }
+    ASSERT(cursor == alloc->allocated_size);
+
+    DvzAllocMove* moves = NULL;
+    if (count > 0)
+    {
+        moves = (DvzAllocMove*)calloc(count, sizeof(DvzAllocMove));
+        ANN(moves);
+    }
+
+    // Second pass: pack the allocated items, free the free blocks, and record the moves.
+    uint32_t k = 0;
+    cursor = 0;
+    Block* head = NULL;
+    Block* last = NULL;
+    current = alloc->blocks;
+    while (current != NULL)
+    {
+        Block* next = current->next;
+        if (current->free)
+        {
+            FREE(current);
+        }
+        else
+        {
+            if (current->offset != cursor)
+            {
+                ASSERT(k < count);
+                ASSERT(cursor < current->offset);
+                moves[k++] = (DvzAllocMove){current->offset, cursor, current->size};
+                current->offset = cursor;
+            }
+            cursor += current->size;
+
+            current->next = NULL;
+            if (last != NULL)
+                last->next = current;
+            else
+                head = current;
+            last = current;
+        }
+        current = next;
+    }
+    ASSERT(k == count);
+
+    // All of the free space goes to a single block at the end.
+    if (cursor < alloc->total_size)
+    {
+        Block* free_block = create_block(cursor, alloc->total_size - cursor, 1);
+        if (last != NULL)
+            last->next = free_block;
+        else
+            head = free_block;
+    }
+    ANN(head);
+    alloc->blocks = head;
+
+    *out_moves = moves;
+    return count;
+}
+
+
+
+DvzSize dvz_alloc_trim(DvzAlloc* alloc, DvzSize min_size)
+{
+    ANN(alloc);
+    ASSERT(min_size > 0);
+
+    // End of the last allocated item.
+    DvzSize end = 0;
+    Block* current = alloc->blocks;
+    while (current != NULL)
+    {
+        if (!current->free)
+            end = current->offset + current->size;
+        current = current->next;
+    }
+
+    DvzSize new_size = min_size;
+    while (new_size < end)
+        new_size *= 2;
+    if (new_size >= alloc->total_size)
+        return alloc->total_size;
+
+    // Drop or truncate the free blocks that go beyond the new size.
+    Block* prev = NULL;
+    current = alloc->blocks;
+    while (current != NULL)
+    {
+        Block* next = current->next;
+        if (current->offset >= new_size)
+        {
+            ASSERT(current->free);
+            ANN(prev);
+            prev->next = next;
+            FREE(current);
+            current = next;
+            continue;
+        }
+        if (current->offset + current->size > new_size)
+        {
+            ASSERT(current->free);
+            current->size = new_size - current->offset;
+        }
+        prev = current;
+        current = next;
+    }
+
+    log_debug("trim alloc to %s", pretty_size(new_size));
+    alloc->total_size = new_size;
+    return new_size;
+}
+
+
+
+DvzSize dvz_alloc_relocated(uint32_t count, DvzAllocMove* moves, DvzSize offset)
+{
+    ASSERT(count == 0 || moves != NULL);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (moves[i].src <= offset && offset < moves[i].src + moves[i].size)
+            return moves[i].dst + (offset - moves[i].src);
+    }
+    return offset;
+}
+
+
+
 void dvz_alloc_clear(DvzAlloc* alloc)
 {
     ANN(alloc);
@@ -14,6 +14,7 @@
 /*************************************************************************************************/
 
 #include "app.h"
+#include "_trace.h"
 #include "board.h"
 #include "client.h"
 #include "datoviz.h"
@@ -51,6 +52,12 @@ static void _on_frame(DvzApp* app, DvzId window_id, DvzFrameEvent* ev)
     // The timer callbacks are called here.
     dvz_timer_tick(app->timer, ev->time);
 
+    // In on-demand mode, the timers are only ticked here: schedule a FRAME event for the next
+    // firing, the event loop waits on the backend events until then.
+    double next = dvz_timer_next(app->timer);
+    if (next >= 0)
+        dvz_client_redraw_at(app->client, next);
+
     // FPS tick, whether the FPS is displayed or not.
     dvz_fps_tick(&app->prt->fps);
 }
@@ -184,6 +191,13 @@ DvzApp* dvz_app(int flags)
     // Set number of threads from DVZ_NUM_THREADS env variable.
     dvz_threads_default();
 
+    // Record a trace of the request pipeline if the DVZ_TRACE env variable is set.
+    if (trace_path() != NULL)
+    {
+        dvz_trace_start();
+        dvz_trace_thread("main");
+    }
+
     DvzApp* app = (DvzApp*)calloc(1, sizeof(DvzApp));
 
     DvzBackend backend = BACKEND;
@@ -213,6 +227,10 @@ DvzApp* dvz_app(int flags)
         app->prt = dvz_presenter(app->rd, app->client, DVZ_CANVAS_FLAGS_IMGUI);
         ANN(app->prt);
 
+        // On-demand rendering: idle canvases are not redrawn.
+        if ((flags & DVZ_APP_FLAGS_ON_DEMAND) != 0)
+            dvz_client_on_demand(app->client, true);
+
         // Target FPS.
         char* env = getenv("DVZ_MAX_FPS");
         int32_t target_fps = env != NULL ? atoi(env) : DVZ_DEFAULT_MAX_FPS;
@@ -398,6 +416,9 @@ DvzTimerItem* dvz_app_timer(DvzApp* app, double delay, double period, uint64_t m
     DvzTimerItem* item = dvz_timer_new(app->timer, delay, period, max_count);
     dvz_timer_callback(app->timer, item, _timer_callback, app);
 
+    // In on-demand mode, a FRAME event is needed to start ticking the timer.
+    dvz_client_redraw(app->client, DVZ_ID_NONE);
+
     return item;
 }
 
@@ -632,6 +653,21 @@ void dvz_app_timestamps(
 
 
 
+uint32_t dvz_app_gpu_times(
+    DvzApp* app, DvzId canvas_id, uint32_t count, DvzId* ids, uint64_t* nanoseconds)
+{
+    ANN(app);
+    ANN(ids);
+    ANN(nanoseconds);
+
+    DvzRenderer* rd = app->rd;
+    ANN(rd);
+
+    return dvz_canvas_gpu_times(dvz_renderer_canvas(rd, canvas_id), count, ids, nanoseconds);
+}
+
+
+
 void dvz_app_wait(DvzApp* app)
 {
     ANN(app);
@@ -676,6 +712,15 @@ void dvz_app_destroy(DvzApp* app)
     dvz_gpu_destroy(app->gpu);
     dvz_host_destroy(app->host);
 
+    // Write the trace, once all threads have been joined.
+    char* trace = trace_path();
+    if (trace != NULL)
+    {
+        dvz_trace_stop();
+        dvz_trace_write(trace);
+        dvz_trace_clear();
+    }
+
     // Free the callback payloads.
     void* payload = NULL;
     for (uint32_t i = 0; i < app->payloads->count; i++)
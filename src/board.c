@@ -46,6 +46,10 @@ dvz_board(DvzGpu* gpu, DvzRenderpass* renderpass, uint32_t width, uint32_t heigh
 
     board.cmds = dvz_commands(gpu, DVZ_DEFAULT_QUEUE_RENDER, 1);
 
+    // NOTE: the GPU timer does not depend on the board size, so it is not recreated with it.
+    if ((flags & DVZ_CANVAS_FLAGS_PROFILE) != 0)
+        dvz_gpu_timer(gpu, &board.render.timer);
+
     dvz_obj_init(&board.obj);
     return board;
 }
@@ -83,10 +87,26 @@ void dvz_board_create(DvzCanvas* board)
     // Make staging image.
     make_staging(gpu, &board->render.staging, board->format, board->width, board->height);
 
+    // Make the pick image.
+    DvzImages* pick = NULL;
+    if ((board->flags & DVZ_CANVAS_FLAGS_PICK) != 0)
+    {
+        dvz_picker(gpu, &board->render.picker, 1, board->width, board->height);
+        pick = &board->render.picker.image;
+    }
+
+    // Make the order-independent transparency attachments.
+    DvzOit* oit = NULL;
+    if ((board->flags & DVZ_CANVAS_FLAGS_OIT) != 0)
+    {
+        oit = &board->render.oit;
+        dvz_oit(gpu, oit, board->render.renderpass, 1, board->width, board->height);
+    }
+
     // Make framebuffers.
     make_framebuffers(
         gpu, &board->render.framebuffers, board->render.renderpass, //
-        &board->render.images, &board->render.depth);
+        &board->render.images, &board->render.depth, pick, oit);
 
     dvz_obj_created(&board->obj);
     log_trace("board created");
@@ -107,6 +127,10 @@ void dvz_board_recreate(DvzCanvas* board)
     dvz_images_destroy(&board->render.depth);
     dvz_images_destroy(&board->render.staging);
     dvz_framebuffers_destroy(&board->render.framebuffers);
+    if ((board->flags & DVZ_CANVAS_FLAGS_PICK) != 0)
+        dvz_picker_destroy(&board->render.picker);
+    if ((board->flags & DVZ_CANVAS_FLAGS_OIT) != 0)
+        dvz_oit_destroy(&board->render.oit);
 
     dvz_board_create(board);
 }
@@ -247,6 +271,12 @@ void dvz_board_destroy(DvzCanvas* board)
     dvz_images_destroy(&board->render.depth);
     dvz_images_destroy(&board->render.staging);
     dvz_framebuffers_destroy(&board->render.framebuffers);
+    if ((board->flags & DVZ_CANVAS_FLAGS_PICK) != 0)
+        dvz_picker_destroy(&board->render.picker);
+    if ((board->flags & DVZ_CANVAS_FLAGS_OIT) != 0)
+        dvz_oit_destroy(&board->render.oit);
+    if ((board->flags & DVZ_CANVAS_FLAGS_PROFILE) != 0)
+        dvz_gpu_timer_destroy(&board->render.timer);
 
     dvz_board_free(board);
     dvz_obj_destroyed(&board->obj);
@@ -107,10 +107,26 @@ void dvz_canvas_create(DvzCanvas* canvas, DvzSurface surface)
     canvas->size = width * height * 3;
     canvas->rgb = (uint8_t*)calloc(canvas->size, 1);
 
+    // Make the pick images.
+    DvzImages* pick = NULL;
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PICK) != 0)
+    {
+        dvz_picker(gpu, &canvas->render.picker, img_count, width, height);
+        pick = &canvas->render.picker.image;
+    }
+
+    // Make the order-independent transparency attachments.
+    DvzOit* oit = NULL;
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_OIT) != 0)
+    {
+        oit = &canvas->render.oit;
+        dvz_oit(gpu, oit, canvas->render.renderpass, img_count, width, height);
+    }
+
     // Make framebuffers.
     make_framebuffers(
         gpu, &canvas->render.framebuffers, canvas->render.renderpass, //
-        canvas->render.swapchain.images, &canvas->render.depth);
+        canvas->render.swapchain.images, &canvas->render.depth, pick, oit);
 
     // Make synchronization objects.
     make_sync(gpu, &canvas->sync, img_count);
@@ -123,6 +139,10 @@ void dvz_canvas_create(DvzCanvas* canvas, DvzSurface surface)
     // Default submit object.
     canvas->render.submit = dvz_submit(canvas->gpu);
 
+    // GPU timestamps.
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PROFILE) != 0)
+        dvz_gpu_timer(gpu, &canvas->render.timer);
+
     dvz_obj_created(&canvas->obj);
     log_trace("canvas created with size %dx%d)", width, height);
 }
@@ -181,6 +201,14 @@ void dvz_canvas_recreate(DvzCanvas* canvas)
     dvz_images_size(&canvas->render.depth, shape);
     dvz_images_create(&canvas->render.depth);
 
+    // Resize the pick images.
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PICK) != 0)
+        dvz_picker_resize(&canvas->render.picker, width, height);
+
+    // Resize the order-independent transparency attachments.
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_OIT) != 0)
+        dvz_oit_resize(&canvas->render.oit, width, height);
+
     // Recreate the framebuffers with the new size.
     for (uint32_t i = 0; i < framebuffers->attachment_count; i++)
     {
@@ -213,9 +241,19 @@ void dvz_canvas_refill(DvzCanvas* canvas, DvzCanvasRefill refill, void* user_dat
 void dvz_canvas_begin(DvzCanvas* canvas, DvzCommands* cmds, uint32_t idx)
 {
     ANN(canvas);
-    DvzGpu* gpu = canvas->gpu;
-    ANN(gpu);
     dvz_cmd_begin(cmds, idx);
+    dvz_canvas_begin_renderpass(canvas, cmds, idx);
+}
+
+
+
+void dvz_canvas_begin_renderpass(DvzCanvas* canvas, DvzCommands* cmds, uint32_t idx)
+{
+    ANN(canvas);
+    ANN(cmds);
+    // NOTE: the timestamp queries must be reset outside of the renderpass.
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PROFILE) != 0)
+        dvz_gpu_timer_begin(&canvas->render.timer, cmds, idx);
     dvz_cmd_begin_renderpass(cmds, idx, canvas->render.renderpass, &canvas->render.framebuffers);
 }
 
@@ -247,10 +285,26 @@ void dvz_canvas_viewport(
 
 
 
+void dvz_canvas_timestamp(
+    DvzCanvas* canvas, DvzCommands* cmds, uint32_t idx, DvzId id, bool end)
+{
+    ANN(canvas);
+    ANN(cmds);
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PROFILE) != 0)
+        dvz_gpu_timer_span(&canvas->render.timer, cmds, idx, id, end);
+}
+
+
+
 void dvz_canvas_end(DvzCanvas* canvas, DvzCommands* cmds, uint32_t idx)
 {
     ANN(canvas);
     ANN(cmds);
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PROFILE) != 0)
+        dvz_gpu_timer_end(&canvas->render.timer, cmds, idx);
+    // NOTE: the composite subpass of the OIT renderpass must be recorded before the end.
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_OIT) != 0)
+        dvz_oit_composite(&canvas->render.oit, cmds, idx, canvas->width, canvas->height);
     dvz_cmd_end_renderpass(cmds, idx);
     dvz_cmd_end(cmds, idx);
 }
@@ -349,6 +403,35 @@ void dvz_canvas_timestamps(
 
 
 
+void dvz_canvas_gpu_collect(DvzCanvas* canvas, uint32_t idx)
+{
+    ANN(canvas);
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PROFILE) != 0)
+        dvz_gpu_timer_collect(&canvas->render.timer, idx);
+}
+
+
+
+uint32_t dvz_canvas_gpu_times(DvzCanvas* canvas, uint32_t count, DvzId* ids, uint64_t* nanoseconds)
+{
+    ANN(canvas);
+    ANN(ids);
+    ANN(nanoseconds);
+    if (canvas->obj.status == DVZ_OBJECT_STATUS_DESTROYED)
+    {
+        log_warn("impossible to recover the GPU times of a destroyed canvas");
+        return 0;
+    }
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PROFILE) == 0)
+    {
+        log_warn("GPU times are only recorded on canvases created with DVZ_CANVAS_FLAGS_PROFILE");
+        return 0;
+    }
+    return dvz_gpu_timer_results(&canvas->render.timer, count, ids, nanoseconds);
+}
+
+
+
 void dvz_canvas_destroy(DvzCanvas* canvas)
 {
     if (canvas == NULL || canvas->obj.status != DVZ_OBJECT_STATUS_CREATED)
@@ -380,6 +463,12 @@ void dvz_canvas_destroy(DvzCanvas* canvas)
     dvz_images_destroy(canvas->render.swapchain.images);
     dvz_images_destroy(&canvas->render.depth);
     dvz_images_destroy(&canvas->render.staging);
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PICK) != 0)
+        dvz_picker_destroy(&canvas->render.picker);
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_OIT) != 0)
+        dvz_oit_destroy(&canvas->render.oit);
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PROFILE) != 0)
+        dvz_gpu_timer_destroy(&canvas->render.timer);
 
     // Destroy the image buffer.
     FREE(canvas->rgb);
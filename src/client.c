@@ -13,6 +13,7 @@
 #include "common.h"
 #include "fifo.h"
 #include "glfw_utils.h"
+#include "mouse.h"
 #include "window.h"
 
 
@@ -76,6 +77,83 @@ static inline bool _should_close(DvzWindow* window)
 
 
 
+// Input and resize events trigger a redraw of their window, in on-demand mode.
+static void _redraw_callback(DvzDeq* deq, void* item, void* user_data)
+{
+    ANN(deq);
+
+    DvzClient* client = (DvzClient*)user_data;
+    ANN(client);
+
+    DvzClientEvent* ev = (DvzClientEvent*)item;
+    ANN(ev);
+
+    dvz_client_redraw(client, ev->window_id);
+}
+
+
+
+// Whether a client event can be merged with the next ones (mouse move, drag, wheel).
+static inline bool _is_coalesced(DvzClientEvent* ev)
+{
+    ANN(ev);
+    if (ev->type != DVZ_CLIENT_EVENT_MOUSE)
+        return false;
+    DvzMouseEventType type = ev->content.m.type;
+    return type == DVZ_MOUSE_EVENT_MOVE || type == DVZ_MOUSE_EVENT_DRAG ||
+           type == DVZ_MOUSE_EVENT_WHEEL;
+}
+
+
+
+// Enqueue the held back event, if any. The pending lock must be held by the caller.
+static void _flush_pending_locked(DvzClient* client)
+{
+    ANN(client);
+    if (!client->has_pending)
+        return;
+    client->has_pending = false;
+    dvz_deq_enqueue(client->deq, 0, (int)client->pending.type, &client->pending);
+}
+
+
+
+// Enqueue the held back event, if any.
+static void _flush_pending(DvzClient* client)
+{
+    ANN(client);
+    dvz_mutex_lock(&client->pending_lock);
+    _flush_pending_locked(client);
+    dvz_mutex_unlock(&client->pending_lock);
+}
+
+
+
+// Whether a window needs to be redrawn or an event is pending, in on-demand mode.
+static bool _needs_frame(DvzClient* client)
+{
+    ANN(client);
+    dvz_mutex_lock(&client->pending_lock);
+    bool has_pending = client->has_pending;
+    dvz_mutex_unlock(&client->pending_lock);
+    if (client->redraw_all || has_pending || dvz_fifo_size(client->deq->queues[0]) > 0)
+        return true;
+
+    DvzContainerIterator iter = dvz_container_iterator(&client->windows);
+    DvzWindow* window = NULL;
+    while (iter.item != NULL)
+    {
+        window = (DvzWindow*)iter.item;
+        ANN(window);
+        if (dvz_obj_is_created(&window->obj) && window->redraw)
+            return true;
+        dvz_container_iter(&iter);
+    }
+    return false;
+}
+
+
+
 /*************************************************************************************************/
 /*  Client functions                                                                             */
 /*************************************************************************************************/
@@ -89,6 +167,10 @@ DvzClient* dvz_client(DvzBackend backend)
     client->map = dvz_map();
     client->clock = dvz_clock();
     client->to_stop = dvz_atomic();
+    client->wait_timeout = DVZ_CLIENT_WAIT_TIMEOUT;
+    client->wake_time = -1;
+    client->coalesce = true;
+    client->pending_lock = dvz_mutex();
 
     // Create the window container.
     client->windows =
@@ -111,6 +193,12 @@ DvzClient* dvz_client(DvzBackend backend)
         client->deq, 0, (int)DVZ_CLIENT_EVENT_WINDOW_DELETE, _callback_window_delete, client);
     dvz_deq_order(client->deq, (int)DVZ_CLIENT_EVENT_WINDOW_DELETE, DVZ_DEQ_ORDER_REVERSE);
 
+    // Redraw callbacks, used in on-demand mode.
+    dvz_deq_callback(client->deq, 0, (int)DVZ_CLIENT_EVENT_MOUSE, _redraw_callback, client);
+    dvz_deq_callback(client->deq, 0, (int)DVZ_CLIENT_EVENT_KEYBOARD, _redraw_callback, client);
+    dvz_deq_callback(
+        client->deq, 0, (int)DVZ_CLIENT_EVENT_WINDOW_RESIZE, _redraw_callback, client);
+
     // Ty default, the client registers a callback to request_close, that just destroys the window.
 
     // dvz_deq_callback(
@@ -128,7 +216,31 @@ DvzClient* dvz_client(DvzBackend backend)
 void dvz_client_event(DvzClient* client, DvzClientEvent ev)
 {
     ANN(client);
+
+    // NOTE: a coalesced event is held back until the next event, which it may absorb, or until
+    // the events are processed. The order of the events is preserved. Events may be emitted
+    // from other threads than the event loop, so the held back event is guarded by a lock.
+    dvz_mutex_lock(&client->pending_lock);
+    if (client->coalesce && _is_coalesced(&ev))
+    {
+        if (client->has_pending && client->pending.window_id == ev.window_id &&
+            dvz_mouse_merge(&client->pending.content.m, &ev.content.m))
+        {
+            client->pending.content_scale = ev.content_scale;
+        }
+        else
+        {
+            _flush_pending_locked(client);
+            client->pending = ev;
+            client->has_pending = true;
+        }
+        dvz_mutex_unlock(&client->pending_lock);
+        return;
+    }
+
+    _flush_pending_locked(client);
     dvz_deq_enqueue(client->deq, 0, (int)ev.type, &ev);
+    dvz_mutex_unlock(&client->pending_lock);
 }
 
 
@@ -159,17 +271,82 @@ void dvz_client_callback(
 void dvz_client_process(DvzClient* client)
 {
     ANN(client);
+    _flush_pending(client);
     dvz_deq_dequeue_batch(client->deq, 0);
 }
 
 
 
+void dvz_client_on_demand(DvzClient* client, bool on_demand)
+{
+    ANN(client);
+    log_debug("%s on-demand rendering", on_demand ? "enable" : "disable");
+    client->on_demand = on_demand;
+    client->redraw_all = true;
+}
+
+
+
+void dvz_client_coalesce(DvzClient* client, bool coalesce)
+{
+    ANN(client);
+    log_debug("%s mouse event coalescing", coalesce ? "enable" : "disable");
+    dvz_mutex_lock(&client->pending_lock);
+    if (!coalesce)
+        _flush_pending_locked(client);
+    client->coalesce = coalesce;
+    dvz_mutex_unlock(&client->pending_lock);
+}
+
+
+
+void dvz_client_redraw(DvzClient* client, DvzId window_id)
+{
+    ANN(client);
+    if (window_id == DVZ_ID_NONE)
+    {
+        client->redraw_all = true;
+        return;
+    }
+    DvzWindow* window = dvz_client_window(client, window_id);
+    if (window != NULL)
+        window->redraw = true;
+}
+
+
+
+void dvz_client_redraw_at(DvzClient* client, double time)
+{
+    ANN(client);
+    if (client->wake_time < 0 || time < client->wake_time)
+        client->wake_time = time;
+}
+
+
+
 int dvz_client_frame(DvzClient* client)
 {
     ANN(client);
 
-    // Poll backend events (mouse, keyboard...).
-    backend_poll_events(client->backend);
+    // Poll backend events (mouse, keyboard...). In on-demand mode, when there is nothing to
+    // redraw, block until a backend event arrives or a redraw is scheduled instead of
+    // busy-looping.
+    if (client->on_demand && !_needs_frame(client))
+    {
+        double timeout = client->wait_timeout;
+        if (client->wake_time >= 0)
+            timeout = CLIP(client->wake_time - dvz_clock_get(&client->clock), 0, timeout);
+        backend_wait_timeout(client->backend, timeout);
+    }
+    else
+        backend_poll_events(client->backend);
+
+    // Scheduled redraw.
+    if (client->wake_time >= 0 && dvz_clock_get(&client->clock) >= client->wake_time)
+    {
+        client->wake_time = -1;
+        client->redraw_all = true;
+    }
 
     // Dequeue and process events.
     dvz_client_process(client);
@@ -211,18 +388,25 @@ int dvz_client_frame(DvzClient* client)
             continue;
         }
 
-        // Enqueue a FRAME event on active windows.
-        frame_ev.window_id = window2id(window);
-        frame_ev.content.f.frame_idx = client->frame_idx;
-        frame_ev.content.f.time = dvz_clock_get(&client->clock);
-        frame_ev.content.f.interval = dvz_clock_interval(&client->clock);
-        dvz_clock_tick(&client->clock);
-        dvz_client_event(client, frame_ev);
+        // Enqueue a FRAME event on active windows. In on-demand mode, only the windows that
+        // need to be redrawn receive one.
+        if (!client->on_demand || client->redraw_all || window->redraw)
+        {
+            frame_ev.window_id = window2id(window);
+            frame_ev.content.f.frame_idx = client->frame_idx;
+            frame_ev.content.f.time = dvz_clock_get(&client->clock);
+            frame_ev.content.f.interval = dvz_clock_interval(&client->clock);
+            dvz_clock_tick(&client->clock);
+            dvz_client_event(client, frame_ev);
+            window->redraw = false;
+        }
 
         // Count the number of active windows.
         count++;
         dvz_container_iter(&iter);
     }
+    // NOTE: the FRAME callbacks below may request another redraw.
+    client->redraw_all = false;
 
     // Dequeue and process events, again (after sending the FRAME event to the active windows).
     dvz_client_process(client);
@@ -397,6 +581,7 @@ void dvz_client_destroy(DvzClient* client)
     // NOTE: the host is responsible for terminating the backend.
     // backend_terminate(client->backend);
 
+    dvz_mutex_destroy(&client->pending_lock);
     dvz_atomic_destroy(client->to_stop);
     FREE(client);
     log_trace("client destroyed");
@@ -93,6 +93,94 @@ void dvz_datalloc_dealloc(DvzDatAlloc* datalloc, DvzBufferType type, bool mappab
 
 
 
+bool dvz_datalloc_extend(
+    DvzDatAlloc* datalloc, DvzBufferType type, bool mappable, DvzSize offset, DvzSize req_size)
+{
+    ANN(datalloc);
+    ASSERT(req_size > 0);
+    CHECK_BUFFER_TYPE
+
+    DvzAlloc** alloc = _get_alloc(datalloc, type, mappable);
+    return dvz_alloc_extend(*alloc, offset, req_size);
+}
+
+
+
+uint32_t dvz_datalloc_compact(
+    DvzDatAlloc* datalloc, DvzResources* res, DvzBufferType type, bool mappable,
+    DvzAllocMove** out_moves)
+{
+    ANN(datalloc);
+    ANN(res);
+    CHECK_BUFFER_TYPE
+
+    if (out_moves != NULL)
+        *out_moves = NULL;
+
+    DvzAlloc** alloc = _get_alloc(datalloc, type, mappable);
+    DvzBuffer* buffer = _find_shared_buffer(res, type, mappable);
+    if (buffer == NULL || *alloc == NULL)
+        return 0;
+
+    // Compute the relocation plan and the new buffer size.
+    DvzAllocMove* moves = NULL;
+    uint32_t count = dvz_alloc_compact(*alloc, &moves);
+    DvzSize size = dvz_alloc_trim(*alloc, DVZ_BUFFER_DEFAULT_SIZE);
+    if (count == 0 && size == buffer->size)
+    {
+        log_trace("no need to compact buffer type %d (mappable: %d)", type, mappable);
+        return 0;
+    }
+
+    log_info(
+        "compacting buffer %u type %d (mappable: %d) to %s, moving %d dats", //
+        (uint64_t)buffer->buffer, type, mappable, pretty_size(size), count);
+
+    // Recreate the buffer, copying the live dats to their new location on the GPU.
+    uint32_t region_count = 0;
+    VkBufferCopy* regions = _repack_regions(*alloc, count, moves, &region_count);
+    dvz_buffer_repack(buffer, size, region_count, regions);
+    FREE(regions);
+
+    // Update the buffer regions of the dats.
+    _relocate_dats(res, buffer, count, moves);
+
+    if (out_moves != NULL)
+        *out_moves = moves;
+    else
+        FREE(moves);
+    return count;
+}
+
+
+
+DvzSize
+dvz_datalloc_trim(DvzDatAlloc* datalloc, DvzResources* res, DvzBufferType type, bool mappable)
+{
+    ANN(datalloc);
+    ANN(res);
+    CHECK_BUFFER_TYPE
+
+    DvzAlloc** alloc = _get_alloc(datalloc, type, mappable);
+    DvzBuffer* buffer = _get_shared_buffer(res, type, mappable);
+    ANN(buffer);
+
+    DvzSize size = dvz_alloc_trim(*alloc, DVZ_BUFFER_DEFAULT_SIZE);
+    if (size < buffer->size)
+    {
+        log_info(
+            "trimming buffer %u type %d (mappable: %d) to %s", //
+            (uint64_t)buffer->buffer, type, mappable, pretty_size(size));
+
+        // NOTE: all dats are before the new end of the buffer, they keep their offsets.
+        VkBufferCopy region = {0, 0, size};
+        dvz_buffer_repack(buffer, size, 1, &region);
+    }
+    return size;
+}
+
+
+
 void dvz_datalloc_stats(DvzDatAlloc* datalloc)
 {
     ANN(datalloc);
@@ -61,5 +61,79 @@ static DvzAlloc* _make_allocator(
 }
 
 
+/*************************************************************************************************/
+/*  Compaction utils                                                                             */
+/*************************************************************************************************/
+
+// Return the GPU copy regions that implement a relocation plan when recreating the buffer. The
+// items before the first move did not move and are copied as a single region, and consecutive
+// moves of contiguous items are merged. The returned array must be freed by the caller.
+static VkBufferCopy*
+_repack_regions(DvzAlloc* alloc, uint32_t count, DvzAllocMove* moves, uint32_t* out_count)
+{
+    ANN(alloc);
+    ANN(out_count);
+    ASSERT(count == 0 || moves != NULL);
+
+    // NOTE: after compaction, the allocated items are packed, so the unmoved items form a
+    // contiguous prefix of the buffer.
+    DvzSize prefix = 0;
+    if (count > 0)
+        prefix = moves[0].dst;
+    else
+        dvz_alloc_size(alloc, &prefix, NULL);
+
+    VkBufferCopy* regions = (VkBufferCopy*)calloc(count + 1, sizeof(VkBufferCopy));
+    ANN(regions);
+    uint32_t n = 0;
+    if (prefix > 0)
+        regions[n++] = (VkBufferCopy){0, 0, prefix};
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        VkBufferCopy* last = n > 0 ? &regions[n - 1] : NULL;
+        if (last != NULL && last->srcOffset + last->size == moves[i].src &&
+            last->dstOffset + last->size == moves[i].dst)
+        {
+            last->size += moves[i].size;
+        }
+        else
+        {
+            regions[n++] = (VkBufferCopy){moves[i].src, moves[i].dst, moves[i].size};
+        }
+    }
+
+    *out_count = n;
+    return regions;
+}
+
+
+
+// Update the buffer regions of all shared dats allocated on a buffer after a relocation.
+static void
+_relocate_dats(DvzResources* res, DvzBuffer* buffer, uint32_t count, DvzAllocMove* moves)
+{
+    ANN(res);
+    ANN(buffer);
+    if (count == 0)
+        return;
+
+    DvzContainerIterator iter = dvz_container_iterator(&res->dats);
+    DvzDat* dat = NULL;
+    while (iter.item != NULL)
+    {
+        dat = (DvzDat*)iter.item;
+        ANN(dat);
+        if (dvz_obj_is_created(&dat->obj) && !_dat_is_standalone(dat) &&
+            dat->br.buffer == buffer)
+        {
+            for (uint32_t i = 0; i < dat->br.count; i++)
+                dat->br.offsets[i] = dvz_alloc_relocated(count, moves, dat->br.offsets[i]);
+        }
+        dvz_container_iter(&iter);
+    }
+}
+
+
 
 #endif
@@ -43,4 +43,13 @@ static inline char* capture_png(bool* offscreen)
 
 
 
+// Path of the Chrome trace-event JSON file to write, when tracing with DVZ_TRACE=path.json.
+static inline char* trace_path(void)
+{
+    char* path = getenv("DVZ_TRACE");
+    return path != NULL && strlen(path) > 0 ? path : NULL;
+}
+
+
+
 #endif
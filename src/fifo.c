@@ -16,6 +16,7 @@
 
 #include "fifo.h"
 #include "_map.h"
+#include "_trace.h"
 
 
 
@@ -668,6 +669,7 @@ DvzDeqItem dvz_deq_dequeue_return(DvzDeq* deq, uint32_t proc_idx, bool wait)
 
     // Here, we know there is at least one item to dequeue because one of the queues is non-empty.
     log_trace("finished waiting dequeue");
+    dvz_trace_begin_args("deq", "dequeue", "proc", proc_idx, NULL, 0);
 
     // Go through the passed queue indices.
     uint32_t deq_idx = 0;
@@ -699,12 +701,16 @@ DvzDeqItem dvz_deq_dequeue_return(DvzDeq* deq, uint32_t proc_idx, bool wait)
     // IMPORTANT: we must unlock BEFORE calling the callbacks if we want to permit callbacks to
     // enqueue new tasks.
     dvz_mutex_unlock(&proc->lock);
+    dvz_trace_end();
 
     // Then, call the typed callbacks.
     if (item_s.item != NULL)
     {
         dvz_atomic_set(proc->is_processing, 1);
+        dvz_trace_begin_args(
+            "deq", "process", "queue", item_s.deq_idx, "type", (int64_t)item_s.type);
         _deq_callbacks(deq, &item_s);
+        dvz_trace_end();
     }
 
     dvz_atomic_set(proc->is_processing, 0);
@@ -6,12 +6,24 @@
 #include "common.h"
 #include "fpng.h"
 #include <errno.h>
+#include <filesystem>
 #include <sys/stat.h>
 
 #if HAS_ZLIB
 #include <zlib.h>
 #endif
 
+#if OS_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 
 
 /*************************************************************************************************/
@@ -279,6 +291,170 @@ int dvz_write_bytes(const char* filename, const char* mode, DvzSize size, const
 
 
 
+/*************************************************************************************************/
+/*  Cache directory                                                                              */
+/*************************************************************************************************/
+
+int dvz_cache_path(const char* name, char* path, size_t size)
+{
+    ANN(name);
+    ANN(path);
+    ASSERT(size > 0);
+    path[0] = 0;
+
+    if (checkenv("DVZ_NO_CACHE"))
+        return 1;
+
+    std::filesystem::path dir;
+    const char* env = getenv("DVZ_CACHE_DIR");
+    if (env != NULL && strlen(env) > 0)
+        dir = env;
+    else
+    {
+#if OS_WINDOWS
+        env = getenv("LOCALAPPDATA");
+        if (env == NULL || strlen(env) == 0)
+            return 1;
+        dir = std::filesystem::path(env) / "datoviz";
+#else
+        env = getenv("XDG_CACHE_HOME");
+        if (env != NULL && strlen(env) > 0)
+            dir = std::filesystem::path(env) / "datoviz";
+        else if ((env = getenv("HOME")) != NULL && strlen(env) > 0)
+            dir = std::filesystem::path(env) / ".cache" / "datoviz";
+        else
+            return 1;
+#endif
+    }
+
+    std::error_code err;
+    std::filesystem::create_directories(dir, err);
+    if (err)
+    {
+        log_warn("unable to create the cache directory %s", dir.string().c_str());
+        return 1;
+    }
+
+    std::string full = (dir / name).string();
+    if (full.size() >= size)
+        return 1;
+    snprintf(path, size, "%s", full.c_str());
+    return 0;
+}
+
+
+
+int dvz_library_path(const void* symbol, char* path, size_t size)
+{
+    ANN(symbol);
+    ANN(path);
+    ASSERT(size > 0);
+    path[0] = 0;
+
+#if OS_WINDOWS
+    HMODULE module = NULL;
+    if (!GetModuleHandleExA(
+            GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            (LPCSTR)symbol, &module))
+        return 1;
+    DWORD n = GetModuleFileNameA(module, path, (DWORD)size);
+    if (n == 0 || n >= size)
+    {
+        path[0] = 0;
+        return 1;
+    }
+#else
+    Dl_info info = {};
+    if (dladdr(symbol, &info) == 0 || info.dli_fname == NULL)
+        return 1;
+    if (strlen(info.dli_fname) >= size)
+        return 1;
+    snprintf(path, size, "%s", info.dli_fname);
+#endif
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/*  Memory-mapped files                                                                          */
+/*************************************************************************************************/
+
+void* dvz_mmap_file(const char* filename, DvzSize* size)
+{
+    ANN(filename);
+    void* ptr = NULL;
+    DvzSize length = 0;
+
+#if OS_WINDOWS
+    HANDLE file = CreateFileA(
+        filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        log_error("could not open %s", filename);
+        return NULL;
+    }
+    LARGE_INTEGER file_size = {0};
+    GetFileSizeEx(file, &file_size);
+    length = (DvzSize)file_size.QuadPart;
+
+    HANDLE mapping = length > 0 ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    if (mapping != NULL)
+    {
+        ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        // NOTE: the view keeps a reference to the mapping, which can be closed right away.
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        log_error("could not open %s", filename);
+        return NULL;
+    }
+    struct stat st{};
+    fstat(fd, &st);
+    length = (DvzSize)st.st_size;
+
+    if (length > 0)
+    {
+        ptr = mmap(NULL, (size_t)length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED)
+            ptr = NULL;
+    }
+    // NOTE: the mapping remains valid after the file descriptor is closed.
+    close(fd);
+#endif
+
+    if (ptr == NULL)
+    {
+        log_error("could not map %s in memory", filename);
+        return NULL;
+    }
+
+    log_trace("mapped %s in memory (%s)", filename, pretty_size(length));
+    if (size != NULL)
+        *size = length;
+    return ptr;
+}
+
+
+
+void dvz_munmap_file(void* ptr, DvzSize size)
+{
+    if (ptr == NULL)
+        return;
+
+#if OS_WINDOWS
+    UnmapViewOfFile(ptr);
+#else
+    munmap(ptr, (size_t)size);
+#endif
+}
+
+
+
 /*************************************************************************************************/
 /*  Image file I/O utils                                                                         */
 /*************************************************************************************************/
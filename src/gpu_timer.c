@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  GPU timer                                                                                    */
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "gpu_timer.h"
+#include "common.h"
+#include "datoviz_defaults.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+#define SKIPPED_SPAN UINT32_MAX
+
+
+
+static inline bool _has_timer(DvzGpuTimer* timer)
+{
+    ANN(timer);
+    return dvz_obj_is_created(&timer->queries.obj);
+}
+
+
+
+// Index of the timestamp query at the beginning of a span, the next one is at its end.
+static inline uint32_t _query(uint32_t idx, uint32_t span)
+{
+    ASSERT(idx < DVZ_MAX_SWAPCHAIN_IMAGES);
+    ASSERT(span < DVZ_GPU_TIMER_MAX_SPANS);
+    return 2 * (idx * DVZ_GPU_TIMER_MAX_SPANS + span);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+void dvz_gpu_timer(DvzGpu* gpu, DvzGpuTimer* timer)
+{
+    ANN(gpu);
+    ANN(timer);
+
+    if (!gpu->device_properties.limits.timestampComputeAndGraphics)
+    {
+        log_warn("the GPU does not support timestamps, GPU timings will not be available");
+        return;
+    }
+    log_trace("create GPU timer");
+
+    timer->period = (double)gpu->device_properties.limits.timestampPeriod;
+    timer->queries = dvz_queries(
+        gpu, VK_QUERY_TYPE_TIMESTAMP, 2 * DVZ_GPU_TIMER_MAX_SPANS * DVZ_MAX_SWAPCHAIN_IMAGES);
+
+    // NOTE: reset all queries once, so that their results can be polled before the command
+    // buffers are first submitted.
+    DvzCommands cmds = dvz_commands(gpu, DVZ_DEFAULT_QUEUE_RENDER, 1);
+    dvz_cmd_begin(&cmds, 0);
+    dvz_cmd_reset_queries(&cmds, 0, &timer->queries, 0, timer->queries.count);
+    dvz_cmd_end(&cmds, 0);
+    dvz_cmd_submit_sync(&cmds, 0);
+    dvz_commands_destroy(&cmds);
+}
+
+
+
+void dvz_gpu_timer_begin(DvzGpuTimer* timer, DvzCommands* cmds, uint32_t idx)
+{
+    ANN(timer);
+    ANN(cmds);
+    if (!_has_timer(timer))
+        return;
+    ASSERT(idx < DVZ_MAX_SWAPCHAIN_IMAGES);
+
+    dvz_cmd_reset_queries(cmds, idx, &timer->queries, _query(idx, 0), 2 * DVZ_GPU_TIMER_MAX_SPANS);
+    timer->recorded_count[idx] = 0;
+    timer->depth = 0;
+    timer->skipped = 0;
+}
+
+
+
+void dvz_gpu_timer_span(DvzGpuTimer* timer, DvzCommands* cmds, uint32_t idx, DvzId id, bool end)
+{
+    ANN(timer);
+    ANN(cmds);
+    if (!_has_timer(timer))
+        return;
+    ASSERT(idx < DVZ_MAX_SWAPCHAIN_IMAGES);
+
+    if (!end)
+    {
+        if (timer->depth >= DVZ_GPU_TIMER_MAX_DEPTH)
+        {
+            log_warn("GPU timer spans nested too deeply, skipping span 0x%" PRIx64, id);
+            timer->skipped++;
+            return;
+        }
+
+        uint32_t span = SKIPPED_SPAN;
+        if (timer->recorded_count[idx] < DVZ_GPU_TIMER_MAX_SPANS)
+        {
+            span = timer->recorded_count[idx]++;
+            timer->recorded[idx][span] = id;
+            dvz_cmd_timestamp(
+                cmds, idx, &timer->queries, _query(idx, span), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+        }
+        else
+        {
+            log_warn("too many GPU timer spans, skipping span 0x%" PRIx64, id);
+        }
+        timer->stack[timer->depth++] = span;
+        return;
+    }
+
+    // End of a span.
+    if (timer->skipped > 0)
+    {
+        timer->skipped--;
+        return;
+    }
+    if (timer->depth == 0)
+    {
+        log_warn("ending GPU timer span 0x%" PRIx64 " which has not begun", id);
+        return;
+    }
+
+    uint32_t span = timer->stack[--timer->depth];
+    if (span == SKIPPED_SPAN)
+        return;
+    if (timer->recorded[idx][span] != id)
+    {
+        log_warn(
+            "ending GPU timer span 0x%" PRIx64 " while span 0x%" PRIx64 " is the innermost", id,
+            timer->recorded[idx][span]);
+    }
+    dvz_cmd_timestamp(
+        cmds, idx, &timer->queries, _query(idx, span) + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+}
+
+
+
+void dvz_gpu_timer_end(DvzGpuTimer* timer, DvzCommands* cmds, uint32_t idx)
+{
+    ANN(timer);
+    ANN(cmds);
+    if (!_has_timer(timer))
+        return;
+
+    if (timer->depth > 0)
+        log_warn("%d GPU timer span(s) were not ended", timer->depth);
+    // NOTE: all queries of the recorded spans must be written for their results to be available.
+    while (timer->depth > 0)
+    {
+        uint32_t span = timer->stack[--timer->depth];
+        if (span != SKIPPED_SPAN)
+            dvz_cmd_timestamp(
+                cmds, idx, &timer->queries, _query(idx, span) + 1,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    }
+    timer->skipped = 0;
+}
+
+
+
+void dvz_gpu_timer_collect(DvzGpuTimer* timer, uint32_t idx)
+{
+    ANN(timer);
+    if (!_has_timer(timer))
+        return;
+    ASSERT(idx < DVZ_MAX_SWAPCHAIN_IMAGES);
+
+    uint32_t count = timer->submitted_count[idx];
+    uint64_t values[2 * DVZ_GPU_TIMER_MAX_SPANS] = {0};
+    if (count > 0 && dvz_queries_results(&timer->queries, _query(idx, 0), 2 * count, values))
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint64_t t0 = values[2 * i + 0];
+            uint64_t t1 = values[2 * i + 1];
+            timer->ids[i] = timer->submitted[idx][i];
+            timer->durations[i] = t1 > t0 ? (uint64_t)((t1 - t0) * timer->period) : 0;
+        }
+        timer->count = count;
+    }
+
+    // The command buffer is about to be submitted with the spans it was last recorded with.
+    timer->submitted_count[idx] = timer->recorded_count[idx];
+    memcpy(
+        timer->submitted[idx], timer->recorded[idx], timer->recorded_count[idx] * sizeof(DvzId));
+}
+
+
+
+uint32_t
+dvz_gpu_timer_results(DvzGpuTimer* timer, uint32_t count, DvzId* ids, uint64_t* nanoseconds)
+{
+    ANN(timer);
+    ANN(ids);
+    ANN(nanoseconds);
+
+    count = MIN(count, timer->count);
+    memcpy(ids, timer->ids, count * sizeof(DvzId));
+    memcpy(nanoseconds, timer->durations, count * sizeof(uint64_t));
+    return count;
+}
+
+
+
+void dvz_gpu_timer_destroy(DvzGpuTimer* timer)
+{
+    ANN(timer);
+    if (!_has_timer(timer))
+        return;
+    log_trace("destroy GPU timer");
+    dvz_queries_destroy(&timer->queries);
+}
@@ -89,7 +89,7 @@ static void _imgui_init(DvzGpu* gpu, uint32_t queue_idx, DvzRenderpass* renderpa
 
     ASSERT(renderpass->renderpass != VK_NULL_HANDLE);
     init_info.RenderPass = renderpass->renderpass;
-    // init_info.PipelineCache = gpu->pipeline_cache;
+    init_info.PipelineCache = gpu->pipeline_cache;
     // init_info.Allocator = gpu->allocator;
 
     // TODO: better selection of image count (from Vulkan instead of hard-coded)
@@ -13,6 +13,7 @@
 
 #include "common.h"
 #include "host.h"
+#include "shader.h"
 #include "vklite.h"
 #include "vkutils.h"
 
@@ -65,6 +66,7 @@ DvzHost* dvz_host(DvzBackend backend)
     ANN(host);
     dvz_obj_init(&host->obj);
     host->obj.type = DVZ_OBJECT_TYPE_HOST;
+    dvz_mutex_init(&host->compiler_lock);
 
 #if SWIFTSHADER
     if (backend != DVZ_BACKEND_OFFSCREEN)
@@ -176,6 +178,10 @@ int dvz_host_destroy(DvzHost* host)
     CONTAINER_DESTROY_ITEMS(DvzGpu, host->gpus, dvz_gpu_destroy)
     dvz_container_destroy(&host->gpus);
 
+    dvz_compiler_destroy(host->compiler);
+    host->compiler = NULL;
+    dvz_mutex_destroy(&host->compiler_lock);
+
     // Destroy the debug messenger.
     if (host->debug_messenger)
     {
@@ -355,6 +355,47 @@ void dvz_mouse_callback(
 
 
 
+bool dvz_mouse_merge(DvzMouseEvent* prev, DvzMouseEvent* ev)
+{
+    ANN(prev);
+    ANN(ev);
+
+    if (prev->type != ev->type || prev->mods != ev->mods)
+        return false;
+
+    switch (ev->type)
+    {
+
+    case DVZ_MOUSE_EVENT_MOVE:
+        if (prev->button != ev->button)
+            return false;
+        glm_vec2_copy(ev->pos, prev->pos);
+        break;
+
+    case DVZ_MOUSE_EVENT_DRAG:
+        if (prev->button != ev->button)
+            return false;
+        // NOTE: the merged event goes from the last position of the first event to the current
+        // position of the last event.
+        glm_vec2_copy(ev->pos, prev->pos);
+        glm_vec2_copy(ev->content.d.shift, prev->content.d.shift);
+        break;
+
+    case DVZ_MOUSE_EVENT_WHEEL:
+        glm_vec2_add(prev->content.w.dir, ev->content.w.dir, prev->content.w.dir);
+        glm_vec2_copy(ev->pos, prev->pos);
+        break;
+
+    default:
+        return false;
+    }
+
+    prev->content_scale = ev->content_scale;
+    return true;
+}
+
+
+
 void dvz_mouse_event(DvzMouse* mouse, DvzMouseEvent* ev)
 {
     ANN(mouse);
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Order-independent transparency                                                               */
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "oit.h"
+#include "common.h"
+#include "datoviz_defaults.h"
+#include "fileio.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static void _oit_images(DvzImages* images, VkFormat format, uint32_t width, uint32_t height)
+{
+    ANN(images);
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    dvz_images_format(images, format);
+    uvec3 size = {width, height, 1};
+    dvz_images_size(images, size);
+    dvz_images_tiling(images, VK_IMAGE_TILING_OPTIMAL);
+    // NOTE: the attachments never leave the renderpass, where they are written by the first
+    // subpass and read by the composite subpass.
+    dvz_images_usage(
+        images, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT);
+    dvz_images_memory(images, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    dvz_images_aspect(images, VK_IMAGE_ASPECT_COLOR_BIT);
+    // Layout of the attachments when they are read as input attachments.
+    dvz_images_layout(images, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    dvz_images_queue_access(images, DVZ_DEFAULT_QUEUE_RENDER);
+    dvz_images_create(images);
+}
+
+
+
+static void _oit_shader(DvzGraphics* graphics, VkShaderStageFlagBits stage, const char* name)
+{
+    ANN(graphics);
+    ANN(name);
+
+    unsigned long size = 0;
+    unsigned char* buffer = dvz_resource_shader(name, &size);
+    ANN(buffer);
+    ASSERT(size > 0);
+    ASSERT(size % 4 == 0);
+
+    uint32_t* code = (uint32_t*)calloc(size, 1);
+    memcpy(code, buffer, size);
+    dvz_graphics_shader_spirv(graphics, stage, size, code);
+    FREE(code);
+}
+
+
+
+static void _oit_descriptors(DvzOit* oit)
+{
+    ANN(oit);
+    dvz_descriptors_attachment(&oit->descriptors, 0, &oit->accum);
+    dvz_descriptors_attachment(&oit->descriptors, 1, &oit->reveal);
+    dvz_descriptors_update(&oit->descriptors);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+void dvz_oit(
+    DvzGpu* gpu, DvzOit* oit, DvzRenderpass* renderpass, uint32_t img_count, uint32_t width,
+    uint32_t height)
+{
+    ANN(gpu);
+    ANN(oit);
+    ANN(renderpass);
+    ASSERT(renderpass->subpass_count == 2);
+    ASSERT(img_count > 0);
+    log_trace("create order-independent transparency resources");
+
+    // Accum and reveal attachments.
+    oit->accum = dvz_images(gpu, VK_IMAGE_TYPE_2D, img_count);
+    _oit_images(&oit->accum, DVZ_OIT_ACCUM_FORMAT, width, height);
+
+    oit->reveal = dvz_images(gpu, VK_IMAGE_TYPE_2D, img_count);
+    _oit_images(&oit->reveal, DVZ_OIT_REVEAL_FORMAT, width, height);
+
+    // Composite pipeline: fullscreen triangle blended onto the color attachment.
+    DvzGraphics* graphics = &oit->graphics;
+    *graphics = dvz_graphics(gpu);
+    dvz_graphics_renderpass(graphics, renderpass, 1);
+    dvz_graphics_primitive(graphics, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+    dvz_graphics_blend(graphics, DVZ_BLEND_STANDARD);
+    dvz_graphics_depth_test(graphics, DVZ_DEPTH_TEST_DISABLE);
+    _oit_shader(graphics, VK_SHADER_STAGE_VERTEX_BIT, "oit_composite_vert");
+    _oit_shader(graphics, VK_SHADER_STAGE_FRAGMENT_BIT, "oit_composite_frag");
+    dvz_graphics_slot(graphics, 0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT); // accum
+    dvz_graphics_slot(graphics, 1, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT); // reveal
+    dvz_graphics_create(graphics);
+
+    oit->descriptors = dvz_descriptors(&graphics->dslots, img_count);
+    _oit_descriptors(oit);
+}
+
+
+
+void dvz_oit_resize(DvzOit* oit, uint32_t width, uint32_t height)
+{
+    ANN(oit);
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    // NOTE: the image views are recreated, so the descriptors need to be updated.
+    dvz_images_resize(&oit->accum, (uvec3){width, height, 1});
+    dvz_images_resize(&oit->reveal, (uvec3){width, height, 1});
+    _oit_descriptors(oit);
+}
+
+
+
+void dvz_oit_composite(
+    DvzOit* oit, DvzCommands* cmds, uint32_t idx, uint32_t width, uint32_t height)
+{
+    ANN(oit);
+    ANN(cmds);
+
+    dvz_cmd_next_subpass(cmds, idx);
+    dvz_cmd_viewport(cmds, idx, (VkViewport){0, 0, (float)width, (float)height, 0, 1});
+    dvz_cmd_bind_graphics(cmds, idx, &oit->graphics);
+    dvz_cmd_bind_descriptors(cmds, idx, &oit->descriptors, 0);
+    dvz_cmd_draw(cmds, idx, 0, 3, 0, 1);
+}
+
+
+
+void dvz_oit_destroy(DvzOit* oit)
+{
+    ANN(oit);
+    log_trace("destroy order-independent transparency resources");
+
+    dvz_descriptors_destroy(&oit->descriptors);
+    dvz_graphics_destroy(&oit->graphics);
+    dvz_images_destroy(&oit->accum);
+    dvz_images_destroy(&oit->reveal);
+}
@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Picking                                                                                      */
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "pick.h"
+#include "canvas.h"
+#include "common.h"
+#include "datoviz_defaults.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static void _pick_images(DvzPicker* picker, uint32_t width, uint32_t height)
+{
+    ANN(picker);
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    DvzImages* images = &picker->image;
+    dvz_images_format(images, DVZ_PICK_IMAGE_FORMAT);
+    uvec3 size = {width, height, 1};
+    dvz_images_size(images, size);
+    dvz_images_tiling(images, VK_IMAGE_TILING_OPTIMAL);
+    dvz_images_usage(
+        images, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+    dvz_images_memory(images, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    dvz_images_aspect(images, VK_IMAGE_ASPECT_COLOR_BIT);
+    dvz_images_layout(images, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    dvz_images_queue_access(images, DVZ_DEFAULT_QUEUE_RENDER);
+    dvz_images_create(images);
+}
+
+
+
+// Return whether the pick image of the last submitted frame can be read, without waiting.
+static bool _last_frame_done(DvzCanvas* canvas, uint32_t* img_idx)
+{
+    ANN(canvas);
+    ANN(img_idx);
+
+    // NOTE: boards are rendered synchronously.
+    if (canvas->obj.type == DVZ_OBJECT_TYPE_BOARD)
+    {
+        *img_idx = 0;
+        return true;
+    }
+
+    DvzFences* fences = &canvas->sync.fences_render_finished;
+    ASSERT(fences->count > 0);
+    uint32_t last = (canvas->cur_frame + fences->count - 1) % fences->count;
+    if (!dvz_fences_ready(fences, last))
+        return false;
+
+    // NOTE: the swapchain image index is only updated when the next frame acquires an image.
+    *img_idx = canvas->render.swapchain.img_idx;
+    return true;
+}
+
+
+
+// Record and submit the copy of the region around the requested position.
+static bool _pick_submit(DvzCanvas* canvas)
+{
+    ANN(canvas);
+    DvzPicker* picker = &canvas->render.picker;
+    ASSERT(picker->status == DVZ_PICK_STATUS_REQUESTED);
+
+    uint32_t img_idx = 0;
+    if (!_last_frame_done(canvas, &img_idx))
+        return false;
+
+    int32_t r = (int32_t)picker->radius;
+    int32_t w = (int32_t)picker->image.shape[0];
+    int32_t h = (int32_t)picker->image.shape[1];
+
+    int32_t x0 = CLIP(picker->x - r, 0, w);
+    int32_t y0 = CLIP(picker->y - r, 0, h);
+    int32_t x1 = CLIP(picker->x + r + 1, 0, w);
+    int32_t y1 = CLIP(picker->y + r + 1, 0, h);
+
+    picker->img_idx = img_idx;
+    picker->center[0] = picker->x;
+    picker->center[1] = picker->y;
+    picker->center_radius = picker->radius;
+    picker->offset[0] = x0;
+    picker->offset[1] = y0;
+    picker->shape[0] = (uint32_t)MAX(x1 - x0, 0);
+    picker->shape[1] = (uint32_t)MAX(y1 - y0, 0);
+    picker->status = DVZ_PICK_STATUS_PENDING;
+
+    // NOTE: nothing to copy if the position is outside of the canvas.
+    if (picker->shape[0] == 0 || picker->shape[1] == 0)
+        return true;
+
+    DvzCommands* cmds = &picker->cmds;
+    dvz_cmd_reset(cmds, img_idx);
+    dvz_cmd_begin(cmds, img_idx);
+
+    // Make the pick attachment writes of the last frame visible to the copy.
+    DvzBarrier src_barrier = dvz_barrier(canvas->gpu);
+    dvz_barrier_stages(
+        &src_barrier, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT);
+    dvz_barrier_images(&src_barrier, &picker->image);
+    dvz_barrier_images_layout(
+        &src_barrier, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    dvz_barrier_images_access(
+        &src_barrier, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+    dvz_cmd_barrier(cmds, img_idx, &src_barrier);
+
+    DvzBarrier barrier = dvz_barrier(canvas->gpu);
+    dvz_barrier_stages(&barrier, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    dvz_barrier_images(&barrier, &picker->staging);
+    dvz_barrier_images_layout(
+        &barrier, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    dvz_barrier_images_access(&barrier, 0, VK_ACCESS_TRANSFER_WRITE_BIT);
+    dvz_cmd_barrier(cmds, img_idx, &barrier);
+
+    // Copy the region of the pick image to the top-left corner of the staging image.
+    dvz_cmd_copy_image_region(
+        cmds, img_idx, &picker->image, (ivec3){x0, y0, 0}, &picker->staging, (ivec3){0, 0, 0},
+        (uvec3){picker->shape[0], picker->shape[1], 1});
+
+    dvz_barrier_images_layout(
+        &barrier, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+    dvz_barrier_images_access(&barrier, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT);
+    dvz_cmd_barrier(cmds, img_idx, &barrier);
+
+    // The next frame rendering into the same pick attachment must wait for the copy to finish
+    // reading it (write-after-read, an execution dependency is enough).
+    dvz_barrier_stages(
+        &src_barrier, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+    dvz_barrier_images_access(&src_barrier, 0, 0);
+    dvz_cmd_barrier(cmds, img_idx, &src_barrier);
+
+    dvz_cmd_end(cmds, img_idx);
+
+    // NOTE: the copy is submitted to the render queue, so that submission order and the barriers
+    // above order it after the last frame and before the next one. The fence is always signaled
+    // at this point, as the previous copy has been read.
+    dvz_submit_send(&picker->submit, img_idx, &picker->fence, 0);
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Picker                                                                                       */
+/*************************************************************************************************/
+
+void dvz_picker(
+    DvzGpu* gpu, DvzPicker* picker, uint32_t img_count, uint32_t width, uint32_t height)
+{
+    ANN(gpu);
+    ANN(picker);
+    ASSERT(img_count > 0);
+    log_trace("create picker with %d pick images", img_count);
+
+    memset(picker, 0, sizeof(DvzPicker));
+
+    // One pick image per framebuffer.
+    picker->image = dvz_images(gpu, VK_IMAGE_TYPE_2D, img_count);
+    _pick_images(picker, width, height);
+
+    // Small host-visible staging image for the region around the picked position.
+    picker->staging = dvz_images(gpu, VK_IMAGE_TYPE_2D, 1);
+    dvz_images_format(&picker->staging, DVZ_PICK_IMAGE_FORMAT);
+    dvz_images_size(&picker->staging, (uvec3){DVZ_PICK_STAGING_SIZE, DVZ_PICK_STAGING_SIZE, 1});
+    dvz_images_tiling(&picker->staging, VK_IMAGE_TILING_LINEAR);
+    dvz_images_usage(&picker->staging, VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    dvz_images_layout(&picker->staging, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    dvz_images_queue_access(&picker->staging, DVZ_DEFAULT_QUEUE_RENDER);
+    dvz_images_vma_usage(&picker->staging, VMA_MEMORY_USAGE_CPU_ONLY);
+    dvz_images_create(&picker->staging);
+
+    picker->data = (ivec4*)calloc(DVZ_PICK_STAGING_SIZE * DVZ_PICK_STAGING_SIZE, sizeof(ivec4));
+
+    // Copy commands on the render queue, one command buffer per pick image.
+    picker->cmds = dvz_commands(gpu, DVZ_DEFAULT_QUEUE_RENDER, img_count);
+    picker->submit = dvz_submit(gpu);
+    dvz_submit_commands(&picker->submit, &picker->cmds);
+    picker->fence = dvz_fences(gpu, 1, true);
+
+    picker->status = DVZ_PICK_STATUS_IDLE;
+}
+
+
+
+void dvz_picker_resize(DvzPicker* picker, uint32_t width, uint32_t height)
+{
+    ANN(picker);
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    // NOTE: the caller waits for the GPU before resizing the framebuffers, so that no copy is
+    // pending at this point.
+    dvz_images_resize(&picker->image, (uvec3){width, height, 1});
+    picker->status = DVZ_PICK_STATUS_IDLE;
+    picker->queued = false;
+}
+
+
+
+void dvz_picker_destroy(DvzPicker* picker)
+{
+    ANN(picker);
+    log_trace("destroy picker");
+
+    dvz_fences_destroy(&picker->fence);
+    dvz_commands_destroy(&picker->cmds);
+    dvz_images_destroy(&picker->staging);
+    dvz_images_destroy(&picker->image);
+    FREE(picker->data);
+}
+
+
+
+/*************************************************************************************************/
+/*  Canvas picking                                                                               */
+/*************************************************************************************************/
+
+void dvz_canvas_pick(DvzCanvas* canvas, int32_t x, int32_t y, uint32_t radius)
+{
+    ANN(canvas);
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PICK) == 0)
+    {
+        log_error("picking requires a canvas created with DVZ_CANVAS_FLAGS_PICK");
+        return;
+    }
+    if (radius > DVZ_PICK_MAX_RADIUS)
+    {
+        log_warn("pick radius %d is larger than the maximum %d", radius, DVZ_PICK_MAX_RADIUS);
+        radius = DVZ_PICK_MAX_RADIUS;
+    }
+
+    DvzPicker* picker = &canvas->render.picker;
+    picker->x = x;
+    picker->y = y;
+    picker->radius = radius;
+
+    // NOTE: a copy is in flight, the new request will be submitted once it has been read.
+    if (picker->status == DVZ_PICK_STATUS_PENDING)
+    {
+        picker->queued = true;
+        return;
+    }
+
+    picker->status = DVZ_PICK_STATUS_REQUESTED;
+    _pick_submit(canvas);
+}
+
+
+
+bool dvz_canvas_picked(DvzCanvas* canvas, DvzPick* pick)
+{
+    ANN(canvas);
+    ANN(pick);
+    if ((canvas->flags & DVZ_CANVAS_FLAGS_PICK) == 0)
+        return false;
+
+    DvzPicker* picker = &canvas->render.picker;
+    if (picker->status == DVZ_PICK_STATUS_REQUESTED && !_pick_submit(canvas))
+        return false;
+    if (picker->status != DVZ_PICK_STATUS_PENDING)
+        return false;
+
+    uint32_t w = picker->shape[0];
+    uint32_t h = picker->shape[1];
+    memset(pick, 0, sizeof(DvzPick));
+
+    if (w > 0 && h > 0)
+    {
+        if (!dvz_fences_ready(&picker->fence, 0))
+            return false;
+
+        // Download the staging image and pack the copied region.
+        dvz_images_download(&picker->staging, 0, sizeof(int32_t), false, true, picker->data);
+        for (uint32_t j = 1; j < h; j++)
+        {
+            memmove(
+                picker->data[j * w], picker->data[j * DVZ_PICK_STAGING_SIZE],
+                w * sizeof(ivec4));
+        }
+
+        int32_t x = picker->center[0] - picker->offset[0];
+        int32_t y = picker->center[1] - picker->offset[1];
+        if (dvz_pick_closest(w, h, picker->data, x, y, picker->center_radius, pick))
+        {
+            pick->x += picker->offset[0];
+            pick->y += picker->offset[1];
+        }
+    }
+    picker->status = DVZ_PICK_STATUS_IDLE;
+
+    // Submit the request that arrived while the copy was pending.
+    if (picker->queued)
+    {
+        picker->queued = false;
+        picker->status = DVZ_PICK_STATUS_REQUESTED;
+        _pick_submit(canvas);
+    }
+
+    return true;
+}
+
+
+
+bool dvz_pick_closest(
+    uint32_t width, uint32_t height, ivec4* data, int32_t x, int32_t y, uint32_t radius,
+    DvzPick* pick)
+{
+    ANN(data);
+    ANN(pick);
+
+    memset(pick, 0, sizeof(DvzPick));
+
+    int32_t r = (int32_t)radius;
+    int32_t best = r * r + 1;
+    int32_t x0 = MAX(x - r, 0), x1 = MIN(x + r, (int32_t)width - 1);
+    int32_t y0 = MAX(y - r, 0), y1 = MIN(y + r, (int32_t)height - 1);
+
+    for (int32_t j = y0; j <= y1; j++)
+    {
+        for (int32_t i = x0; i <= x1; i++)
+        {
+            int32_t* px = data[(uint32_t)j * width + (uint32_t)i];
+            if (px[0] == 0)
+                continue;
+            int32_t d = (i - x) * (i - x) + (j - y) * (j - y);
+            if (d < best)
+            {
+                best = d;
+                pick->visual = (uint32_t)px[0];
+                pick->item = (uint32_t)px[1];
+                pick->x = i;
+                pick->y = j;
+            }
+        }
+    }
+
+    return pick->visual != 0;
+}
@@ -92,7 +92,6 @@ DvzGraphics* dvz_pipe_graphics(DvzPipe* pipe)
 DvzCompute* dvz_pipe_compute(DvzPipe* pipe, const char* shader_path)
 {
     ANN(pipe);
-    ANN(shader_path);
 
     pipe->type = DVZ_PIPE_COMPUTE;
 
@@ -210,12 +209,13 @@ void dvz_pipe_create(DvzPipe* pipe)
     // Compute pipe.
     else if (pipe->type == DVZ_PIPE_COMPUTE)
     {
-        if (dvz_obj_is_created(&pipe->u.graphics.obj))
+        if (dvz_obj_is_created(&pipe->u.compute.obj))
         {
             log_debug(
                 "requesting pipe creation for an already-existing pipe, destroying it first");
-            dvz_graphics_destroy(&pipe->u.graphics);
+            dvz_compute_destroy(&pipe->u.compute);
         }
+        dvz_compute_descriptors(&pipe->u.compute, &pipe->descriptors);
         dvz_compute_create(&pipe->u.compute);
     }
 
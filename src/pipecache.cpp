@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Pipe cache                                                                                   */
+/*************************************************************************************************/
+
+#include "pipecache.h"
+#include "_hash.h"
+#include "_log.h"
+
+#include <string>
+#include <unordered_map>
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// NOTE: the keys are byte blobs stored in a std::string, hashed with FNV-1a. The map compares
+// the full keys on lookup, so that two different keys with the same hash are distinct entries.
+struct DvzPipeCacheHash
+{
+    size_t operator()(const std::string& key) const
+    {
+        return (size_t)dvz_hash(DVZ_HASH_SEED, key.size(), key.data());
+    }
+};
+
+
+
+struct DvzPipeCacheEntry
+{
+    uint64_t handle;
+    uint64_t refs;
+};
+
+
+
+struct DvzPipeCacheTable
+{
+    std::unordered_map<std::string, DvzPipeCacheEntry, DvzPipeCacheHash> entries; // key -> entry
+    std::unordered_map<uint64_t, std::string> keys;                               // handle -> key
+    uint64_t hits;
+    uint64_t misses;
+};
+
+
+
+extern "C" struct DvzPipeCache
+{
+    DvzPipeCacheTable tables[DVZ_PIPECACHE_COUNT];
+};
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzPipeCache* dvz_pipecache(void)
+{
+    DvzPipeCache* cache = new DvzPipeCache();
+    return cache;
+}
+
+
+
+uint64_t
+dvz_pipecache_get(DvzPipeCache* cache, DvzPipeCacheType type, size_t size, const void* key)
+{
+    ANN(cache);
+    ANN(key);
+    ASSERT(type < DVZ_PIPECACHE_COUNT);
+    DvzPipeCacheTable& table = cache->tables[type];
+
+    auto it = table.entries.find(std::string((const char*)key, size));
+    if (it == table.entries.end())
+    {
+        table.misses++;
+        return 0;
+    }
+    table.hits++;
+    it->second.refs++;
+    log_trace(
+        "pipe cache hit for object type %d, %" PRIu64 " references", type, it->second.refs);
+    return it->second.handle;
+}
+
+
+
+void dvz_pipecache_put(
+    DvzPipeCache* cache, DvzPipeCacheType type, size_t size, const void* key, uint64_t handle)
+{
+    ANN(cache);
+    ANN(key);
+    ASSERT(type < DVZ_PIPECACHE_COUNT);
+    ASSERT(handle != 0);
+    DvzPipeCacheTable& table = cache->tables[type];
+
+    std::string blob((const char*)key, size);
+    if (table.entries.count(blob) > 0)
+    {
+        log_warn("object of type %d already exists in the pipe cache", type);
+        return;
+    }
+    table.entries[blob] = DvzPipeCacheEntry{handle, 1};
+    table.keys[handle] = blob;
+}
+
+
+
+int64_t dvz_pipecache_release(DvzPipeCache* cache, DvzPipeCacheType type, uint64_t handle)
+{
+    ANN(cache);
+    ASSERT(type < DVZ_PIPECACHE_COUNT);
+    DvzPipeCacheTable& table = cache->tables[type];
+
+    auto it = table.keys.find(handle);
+    if (it == table.keys.end())
+        return -1;
+
+    auto entry_it = table.entries.find(it->second);
+    ASSERT(entry_it != table.entries.end());
+    DvzPipeCacheEntry& entry = entry_it->second;
+    ASSERT(entry.refs > 0);
+    entry.refs--;
+    if (entry.refs > 0)
+        return (int64_t)entry.refs;
+
+    // Last reference: remove the object from the cache, the caller destroys it.
+    table.entries.erase(entry_it);
+    table.keys.erase(it);
+    return 0;
+}
+
+
+
+DvzPipeCacheStats dvz_pipecache_stats(DvzPipeCache* cache, DvzPipeCacheType type)
+{
+    ANN(cache);
+    ASSERT(type < DVZ_PIPECACHE_COUNT);
+    DvzPipeCacheTable& table = cache->tables[type];
+
+    DvzPipeCacheStats stats{};
+    stats.count = table.entries.size();
+    for (const auto& [key, entry] : table.entries)
+        stats.refs += entry.refs;
+    stats.hits = table.hits;
+    stats.misses = table.misses;
+    return stats;
+}
+
+
+
+void dvz_pipecache_destroy(DvzPipeCache* cache)
+{
+    if (cache == NULL)
+        return;
+
+    for (uint32_t i = 0; i < DVZ_PIPECACHE_COUNT; i++)
+    {
+        DvzPipeCacheStats stats = dvz_pipecache_stats(cache, (DvzPipeCacheType)i);
+        log_debug(
+            "pipe cache for object type %d: %" PRIu64 " hit(s), %" PRIu64 " miss(es)", i,
+            stats.hits, stats.misses);
+        if (stats.count > 0)
+            log_warn(
+                "%" PRIu64 " object(s) of type %d still in the pipe cache upon destruction",
+                stats.count, i);
+    }
+    delete cache;
+}
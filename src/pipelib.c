@@ -81,6 +81,8 @@ DvzPipelib* dvz_pipelib(DvzContext* ctx)
     lib->shaders =
         dvz_container(DVZ_CONTAINER_DEFAULT_COUNT, sizeof(DvzShader), DVZ_OBJECT_TYPE_SHADER);
 
+    lib->cache = dvz_pipecache();
+
     dvz_obj_created(&lib->obj);
     log_trace("pipelib created");
     return lib;
@@ -111,6 +113,7 @@ DvzPipe* dvz_pipelib_graphics(
     // Initialize the graphics pipeline.
     DvzGraphics* graphics = dvz_pipe_graphics(pipe);
     ANN(graphics);
+    graphics->cache = lib->cache;
     dvz_graphics_builtin(renderpass, graphics, type, flags);
 
     // Create the first common uniform dat: MVP.
@@ -144,8 +147,52 @@ DvzPipe* dvz_pipelib_graphics(
 DvzPipe* dvz_pipelib_compute_file(DvzPipelib* lib, const char* shader_path)
 {
     ANN(lib);
-    // TODO: compute shader
-    return NULL;
+    ANN(shader_path);
+
+    DvzGpu* gpu = lib->gpu;
+    ANN(gpu);
+    ASSERT(dvz_obj_is_created(&gpu->obj));
+
+    // Allocate a DvzPipe pointer.
+    DvzPipe* pipe = (DvzPipe*)dvz_container_alloc(&lib->computes);
+
+    // Initialize the pipe.
+    *pipe = dvz_pipe(gpu);
+    dvz_pipe_compute(pipe, shader_path);
+
+    // NOTE: like graphics pipes, compute pipes are lazily created once their slots are declared.
+    return pipe;
+}
+
+
+
+DvzPipe* dvz_pipelib_compute(DvzPipelib* lib, DvzShader* shader)
+{
+    ANN(lib);
+    ANN(shader);
+    ASSERT(shader->type == DVZ_SHADER_COMPUTE);
+
+    DvzGpu* gpu = lib->gpu;
+    ANN(gpu);
+    ASSERT(dvz_obj_is_created(&gpu->obj));
+
+    // Allocate a DvzPipe pointer.
+    DvzPipe* pipe = (DvzPipe*)dvz_container_alloc(&lib->computes);
+
+    // Initialize the pipe.
+    *pipe = dvz_pipe(gpu);
+    DvzCompute* compute = dvz_pipe_compute(pipe, NULL);
+    ANN(compute);
+
+    // NOTE: the shader is owned by the pipelib and outlives the compute.
+    if (shader->format == DVZ_SHADER_GLSL)
+        dvz_compute_code(compute, shader->code);
+    else if (shader->format == DVZ_SHADER_SPIRV)
+        dvz_compute_spirv(compute, shader->size, shader->buffer);
+    else
+        log_error("unknown shader format %d", shader->format);
+
+    return pipe;
 }
 
 
@@ -181,6 +228,9 @@ void dvz_pipelib_destroy(DvzPipelib* lib)
     CONTAINER_DESTROY_ITEMS(DvzShader, lib->shaders, dvz_shader_destroy)
     dvz_container_destroy(&lib->shaders);
 
+    // NOTE: must be destroyed after the graphics, which release the shared objects.
+    dvz_pipecache_destroy(lib->cache);
+
     dvz_obj_destroyed(&lib->obj);
     FREE(lib);
 }
@@ -10,6 +10,7 @@
 
 #include "presenter.h"
 #include "_list.h"
+#include "_trace.h"
 #include "_map.h"
 #include "canvas.h"
 #include "canvas_utils.h"
@@ -360,6 +361,9 @@ static void _requester_callback(DvzClient* client, DvzClientEvent ev)
     // if (has_record_request)
     //     prt->awaiting_submit = false;
 
+    // In on-demand mode, the processed requests may change what is displayed in any canvas.
+    dvz_client_redraw(client, DVZ_ID_NONE);
+
     // Finally, we destroy the batch.
     dvz_batch_destroy(batch);
 }
@@ -520,6 +524,7 @@ void dvz_presenter_frame(DvzPresenter* prt, DvzId window_id)
 
     uint64_t frame_idx = client->frame_idx;
     log_trace("frame %d, window 0x%" PRIx64, frame_idx, window_id);
+    dvz_trace_begin_args("presenter", "frame", "frame", (int64_t)frame_idx, NULL, 0);
 
     // Swapchain logic.
 
@@ -539,6 +544,7 @@ void dvz_presenter_frame(DvzPresenter* prt, DvzId window_id)
 
     // Wait for fence.
     // dvz_fences_wait(fences, canvas->cur_frame);
+    dvz_trace_begin("presenter", "acquire");
     dvz_fences_wait(fences, (canvas->cur_frame + 1) % DVZ_MAX_FRAMES_IN_FLIGHT);
 
     // We acquire the next swapchain image.
@@ -549,6 +555,7 @@ void dvz_presenter_frame(DvzPresenter* prt, DvzId window_id)
     // if (!prt->awaiting_submit)
     // {
     dvz_swapchain_acquire(swapchain, sem_img_available, canvas->cur_frame, NULL, 0);
+    dvz_trace_end();
     //     prt->awaiting_submit = true;
     // }
     // else
@@ -561,6 +568,7 @@ void dvz_presenter_frame(DvzPresenter* prt, DvzId window_id)
     if (swapchain->obj.status == DVZ_OBJECT_STATUS_INVALID)
     {
         dvz_gpu_wait(gpu);
+        dvz_trace_end();
         return;
     }
     // Handle resizing.
@@ -608,10 +616,12 @@ void dvz_presenter_frame(DvzPresenter* prt, DvzId window_id)
         // Need to refill the command buffers.
         // Ensure we reset the refill flag to force reloading.
         dvz_recorder_set_dirty(recorder);
+        dvz_trace_begin("presenter", "record");
         for (uint32_t i = 0; i < cmds->count; i++)
         {
             _record_command(rd, canvas, i);
         }
+        dvz_trace_end();
         // prt->awaiting_submit = false;
     }
 
@@ -629,12 +639,18 @@ void dvz_presenter_frame(DvzPresenter* prt, DvzId window_id)
         // previously (caching system built into the recorder).
         if (dvz_recorder_is_dirty(recorder, swapchain->img_idx))
         {
+            dvz_trace_begin("presenter", "record");
             _record_command(rd, canvas, swapchain->img_idx);
+            dvz_trace_end();
         }
 
         // Reset the Submit instance before adding the command buffers.
+        dvz_trace_begin("presenter", "submit");
         dvz_submit_reset(submit);
 
+        // Collect the GPU timestamps of the previous submission of this command buffer.
+        dvz_canvas_gpu_collect(canvas, swapchain->img_idx);
+
         // First, we submit the cmds on that image
         dvz_submit_commands(submit, cmds);
 
@@ -651,9 +667,12 @@ void dvz_presenter_frame(DvzPresenter* prt, DvzId window_id)
         // Once the render is finished, we signal another semaphore.
         dvz_submit_signal_semaphores(submit, sem_render_finished, canvas->cur_frame);
         dvz_submit_send(submit, swapchain->img_idx, fences, canvas->cur_frame);
+        dvz_trace_end();
 
         // Once the image is rendered, we present the swapchain image.
+        dvz_trace_begin("presenter", "present");
         dvz_swapchain_present(swapchain, 1, sem_render_finished, canvas->cur_frame);
+        dvz_trace_end();
 
         // Mark the fact that the submission has been done.
         // prt->awaiting_submit = false;
@@ -667,10 +686,20 @@ void dvz_presenter_frame(DvzPresenter* prt, DvzId window_id)
     // dvz_queue_wait(gpu, DVZ_DEFAULT_QUEUE_PRESENT);
 
     // Transfers.
+    dvz_trace_begin("presenter", "transfers");
     dvz_transfers_frame(&ctx->transfers, swapchain->img_idx);
+    dvz_trace_end();
+
+    // In on-demand mode, keep redrawing the window until the pending transfers are done (for
+    // example, dup transfers that need to be applied to every swapchain image).
+    if (dvz_transfers_pending(&ctx->transfers))
+        dvz_client_redraw(client, window_id);
 
     // UPFILL: when there is a command refill + data uploads in the same batch, register
     // the cmd buf at the moment when the GPU-blocking upload really occurs
+
+    // End of the frame span.
+    dvz_trace_end();
 }
 
 
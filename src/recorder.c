@@ -9,8 +9,10 @@
 /*************************************************************************************************/
 
 #include "recorder.h"
+#include "_trace.h"
 #include "canvas.h"
 #include "renderer.h"
+#include "resources.h"
 
 // HACK: we need the scale push constant offset common to all visuals.
 #include "scene/visual.h"
@@ -32,6 +34,7 @@
 #define GET_PIPE(pipe_id)                                                                         \
     DvzPipe* pipe = dvz_renderer_pipe(rd, pipe_id);                                               \
     ANN(pipe);                                                                                    \
+    _pipe_renderpass(pipe, canvas);                                                               \
     if (!dvz_pipe_complete(pipe))                                                                 \
     {                                                                                             \
         log_error("cannot draw pipe with incomplete descriptor bindings");                        \
@@ -50,6 +53,21 @@
 
 
 
+// Picking and order-independent transparency support is all or nothing within a canvas: the
+// graphics pipeline bound must be compatible with the renderpass of the canvas it is recorded
+// into, with or without the pick and OIT attachments. The pipeline of a pipe is never recreated
+// here, as command buffers in flight may still use it: a variant is created instead.
+static void _pipe_renderpass(DvzPipe* pipe, DvzCanvas* canvas)
+{
+    ANN(pipe);
+    ANN(canvas);
+    if (pipe->type != DVZ_PIPE_GRAPHICS || !dvz_obj_is_created(&pipe->u.graphics.obj))
+        return;
+    dvz_graphics_variant(&pipe->u.graphics, canvas->render.renderpass);
+}
+
+
+
 static void _process_begin(
     DvzRecorder* recorder, DvzRenderer* rd, DvzCommands* cmds, uint32_t img_idx, //
     DvzRecorderCommand* record, void* user_data)
@@ -58,7 +76,83 @@ static void _process_begin(
 
     dvz_cmd_reset(cmds, img_idx);
     log_debug("recorder: begin (#%d)", img_idx);
-    dvz_canvas_begin(canvas, cmds, img_idx);
+    dvz_cmd_begin(cmds, img_idx);
+
+    // NOTE: the compute dispatches until the end command are hoisted here, as they must be
+    // recorded outside of the renderpass, before the draws that use their results.
+    DvzRecorderCallback cb = recorder->callbacks[DVZ_RECORDER_DISPATCH];
+    void* cb_user_data = recorder->callback_user_data[DVZ_RECORDER_DISPATCH];
+    DvzRecorderCommand* last = &recorder->commands[recorder->count];
+    for (DvzRecorderCommand* rc = record + 1; rc < last && rc->type != DVZ_RECORDER_END; rc++)
+    {
+        if (rc->type == DVZ_RECORDER_DISPATCH && cb != NULL)
+            cb(recorder, rd, cmds, img_idx, rc, cb_user_data);
+    }
+
+    dvz_canvas_begin_renderpass(canvas, cmds, img_idx);
+}
+
+static void _process_dispatch(
+    DvzRecorder* recorder, DvzRenderer* rd, DvzCommands* cmds, uint32_t img_idx, //
+    DvzRecorderCommand* record, void* user_data)
+{
+    GET_CANVAS
+
+    DvzRecorderDispatch* d = &record->contents.dispatch;
+    log_debug(
+        "recorder: dispatch compute 0x%" PRIx64 " with %dx%dx%d workgroups (#%d)", d->pipe_id,
+        d->group_count[0], d->group_count[1], d->group_count[2], img_idx);
+
+    DvzPipe* pipe = dvz_renderer_pipe(rd, d->pipe_id);
+    ANN(pipe);
+    if (pipe->type != DVZ_PIPE_COMPUTE || !dvz_pipe_complete(pipe))
+    {
+        log_error("cannot dispatch compute pipe with incomplete descriptor bindings");
+        return;
+    }
+    DvzDat* indirect = NULL;
+    if (d->dat_indirect_id != DVZ_ID_NONE)
+    {
+        indirect = dvz_renderer_dat(rd, d->dat_indirect_id);
+        ANN(indirect);
+    }
+
+    // The kernel must not write the buffers read by the draws of the previous frames.
+    DvzBarrier barrier = dvz_barrier(canvas->gpu);
+    dvz_barrier_stages(
+        &barrier, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    dvz_cmd_barrier(cmds, img_idx, &barrier);
+
+    // Reset the count of the indirect draw command, which the kernel accumulates.
+    if (indirect != NULL)
+    {
+        DvzBufferRegions* br = &indirect->br;
+        dvz_cmd_fill_buffer(
+            cmds, img_idx, br->buffer, br->offsets[MIN(img_idx, br->count - 1)], 4, 0);
+
+        barrier = dvz_barrier(canvas->gpu);
+        dvz_barrier_stages(
+            &barrier, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        dvz_barrier_memory(
+            &barrier, VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+        dvz_cmd_barrier(cmds, img_idx, &barrier);
+    }
+
+    dvz_pipe_run(pipe, cmds, img_idx, d->group_count);
+
+    // The draws read the indirect and index buffers written by the kernel.
+    barrier = dvz_barrier(canvas->gpu);
+    dvz_barrier_stages(
+        &barrier, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+    dvz_barrier_memory(
+        &barrier, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+    dvz_cmd_barrier(cmds, img_idx, &barrier);
 }
 
 static void _process_viewport(
@@ -202,6 +296,19 @@ static void _process_draw_indexed_indirect(
     dvz_pipe_draw_indexed_indirect(pipe, cmds, img_idx, dat_indirect, draw_count);
 }
 
+static void _process_timestamp(
+    DvzRecorder* recorder, DvzRenderer* rd, DvzCommands* cmds, uint32_t img_idx, //
+    DvzRecorderCommand* record, void* user_data)
+{
+    GET_CANVAS
+
+    DvzRecorderTimestamp* ts = &record->contents.timestamp;
+    log_debug(
+        "recorder: timestamp %s span 0x%" PRIx64 " (#%d)", ts->end ? "end" : "begin", ts->id,
+        img_idx);
+    dvz_canvas_timestamp(canvas, cmds, img_idx, ts->id, ts->end);
+}
+
 static void _process_end(
     DvzRecorder* recorder, DvzRenderer* rd, DvzCommands* cmds, uint32_t img_idx, //
     DvzRecorderCommand* record, void* user_data)
@@ -247,6 +354,8 @@ DvzRecorder* dvz_recorder(int flags)
         recorder, DVZ_RECORDER_DRAW_INDEXED_INDIRECT, _process_draw_indexed_indirect, NULL);
     dvz_recorder_register(recorder, DVZ_RECORDER_VIEWPORT, _process_viewport, NULL);
     dvz_recorder_register(recorder, DVZ_RECORDER_PUSH, _process_push, NULL);
+    dvz_recorder_register(recorder, DVZ_RECORDER_TIMESTAMP, _process_timestamp, NULL);
+    dvz_recorder_register(recorder, DVZ_RECORDER_DISPATCH, _process_dispatch, NULL);
     dvz_recorder_register(recorder, DVZ_RECORDER_END, _process_end, NULL);
 
     return recorder;
@@ -306,6 +415,7 @@ void dvz_recorder_set(DvzRecorder* recorder, DvzRenderer* rd, DvzCommands* cmds,
     // this function updates the command buffer for the given swapchain image index, only if needed
     if (_has_cache(recorder) && !recorder->dirty[img_idx])
         return;
+    dvz_trace_begin_args("recorder", "set", "img", img_idx, "commands", recorder->count);
 
     // Go through all record commands and update the command buffer
     for (uint32_t i = 0; i < recorder->count; i++)
@@ -319,6 +429,10 @@ void dvz_recorder_set(DvzRecorder* recorder, DvzRenderer* rd, DvzCommands* cmds,
             continue;
         }
 
+        // NOTE: the compute dispatches are recorded by the begin command, see _process_begin().
+        if (record->type == DVZ_RECORDER_DISPATCH)
+            continue;
+
         // This index is used to fetch the right callback (only one per record type).
         ASSERT(cb_idx < DVZ_RECORDER_COUNT);
         DvzRecorderCallback cb = recorder->callbacks[cb_idx];
@@ -337,7 +451,7 @@ void dvz_recorder_set(DvzRecorder* recorder, DvzRenderer* rd, DvzCommands* cmds,
     }
 
     recorder->dirty[img_idx] = false;
-
+    dvz_trace_end();
 
     // HACK: push constant data value once all command buffers have been recorded.
     bool zeros[DVZ_MAX_SWAPCHAIN_IMAGES] = {0};
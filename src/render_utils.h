@@ -18,6 +18,7 @@
 /*************************************************************************************************/
 
 #include "datoviz_defaults.h"
+#include "oit.h"
 #include "resources_utils.h"
 #include "surface.h"
 #include "vklite.h"
@@ -166,7 +167,7 @@ make_staging(DvzGpu* gpu, DvzImages* staging, DvzFormat format, uint32_t width,
 
 static void make_framebuffers(
     DvzGpu* gpu, DvzFramebuffers* framebuffers, DvzRenderpass* renderpass, //
-    DvzImages* images, DvzImages* depth)
+    DvzImages* images, DvzImages* depth, DvzImages* pick, DvzOit* oit)
 {
     ANN(gpu);
     ANN(framebuffers);
@@ -178,6 +179,17 @@ static void make_framebuffers(
     *framebuffers = dvz_framebuffers(gpu);
     dvz_framebuffers_attachment(framebuffers, 0, images);
     dvz_framebuffers_attachment(framebuffers, 1, depth);
+    // NOTE: the attachment indices follow the renderpass, see dvz_gpu_renderpass_flags().
+    uint32_t idx = 2;
+    // NOTE: the pick image is only passed with canvases created with DVZ_CANVAS_FLAGS_PICK.
+    if (pick != NULL)
+        dvz_framebuffers_attachment(framebuffers, idx++, pick);
+    // NOTE: the OIT attachments are only passed with canvases created with DVZ_CANVAS_FLAGS_OIT.
+    if (oit != NULL)
+    {
+        dvz_framebuffers_attachment(framebuffers, idx++, &oit->accum);
+        dvz_framebuffers_attachment(framebuffers, idx++, &oit->reveal);
+    }
     dvz_framebuffers_create(framebuffers, renderpass);
 }
 
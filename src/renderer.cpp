@@ -3,13 +3,17 @@
 /*************************************************************************************************/
 
 #include <map>
+#include <vector>
 
+#include "_handle.h"
 #include "_log.h"
 #include "_map.h"
+#include "_trace.h"
 #include "board.h"
 #include "canvas.h"
 #include "context.h"
 #include "datoviz_enums.h"
+#include "host.h"
 #include "pipe.h"
 #include "pipelib.h"
 #include "recorder.h"
@@ -154,7 +158,12 @@ static void* _canvas_update(DvzRenderer* rd, DvzRequest req, void* user_data)
 
     GET_ID(DvzCanvas, canvas, req.id)
 
+    // Process the pending asynchronous tex uploads before rendering.
+    dvz_transfers_flush(&rd->ctx->transfers);
+    dvz_canvas_gpu_collect(canvas, 0);
     dvz_cmd_submit_sync(&canvas->cmds, DVZ_DEFAULT_QUEUE_RENDER);
+    // NOTE: the submission is synchronous, so the GPU timestamps are already available.
+    dvz_canvas_gpu_collect(canvas, 0);
 
     return NULL;
 }
@@ -184,6 +193,21 @@ static void* _canvas_resize(DvzRenderer* rd, DvzRequest req, void* user_data)
 
 
 
+static void* _canvas_pick(DvzRenderer* rd, DvzRequest req, void* user_data)
+{
+    ANN(rd);
+    ASSERT(req.id != 0);
+
+    GET_ID(DvzCanvas, canvas, req.id)
+
+    // NOTE: this only submits the copy of the pick region, see dvz_renderer_pick().
+    dvz_canvas_pick(canvas, req.content.pick.x, req.content.pick.y, req.content.pick.radius);
+
+    return NULL;
+}
+
+
+
 static void* _canvas_delete(DvzRenderer* rd, DvzRequest req, void* user_data)
 {
     ANN(rd);
@@ -240,6 +264,20 @@ static void* _shader_create(DvzRenderer* rd, DvzRequest req, void* user_data)
 
 
 
+static void* _shader_delete(DvzRenderer* rd, DvzRequest req, void* user_data)
+{
+    ANN(rd);
+    ASSERT(req.id != 0);
+    log_trace("delete shader");
+
+    GET_ID(DvzShader, shader, req.id)
+
+    dvz_shader_destroy(shader);
+    return NULL;
+}
+
+
+
 /*************************************************************************************************/
 /*  Graphics                                                                                     */
 /*************************************************************************************************/
@@ -301,6 +339,40 @@ static inline DvzGraphics* _get_graphics(DvzRenderer* rd, DvzRequest req, void*
 
 
 
+// Helper function to retrieve the DvzCompute* pointer of compute creation request.
+static inline DvzCompute* _get_compute(DvzRenderer* rd, DvzRequest req, void* user_data)
+{
+    ANN(rd);
+    ASSERT(req.id != 0);
+
+    // Get the compute pipe.
+    GET_ID(DvzPipe, pipe, req.id)
+
+    // Same as for graphics: a modified compute pipe needs to be recreated.
+    if (dvz_obj_is_created(&pipe->obj))
+    {
+        pipe->obj.status = DVZ_OBJECT_STATUS_NEED_RECREATE;
+    }
+
+    ASSERT(pipe->type == DVZ_PIPE_COMPUTE);
+    DvzCompute* compute = &pipe->u.compute;
+
+    return compute;
+}
+
+
+
+// Whether the pipe targeted by a request is a compute pipe (slots and push constants are shared
+// between graphics and compute requests).
+static inline bool _is_compute(DvzRenderer* rd, DvzRequest req)
+{
+    ANN(rd);
+    DvzPipe* pipe = (DvzPipe*)dvz_map_get(rd->map, req.id);
+    return pipe != NULL && pipe->type == DVZ_PIPE_COMPUTE;
+}
+
+
+
 static void* _graphics_primitive(DvzRenderer* rd, DvzRequest req, void* user_data)
 {
     DvzGraphics* graphics = _get_graphics(rd, req, user_data);
@@ -455,8 +527,16 @@ static void* _graphics_vertex_attr(DvzRenderer* rd, DvzRequest req, void* user_d
 
 static void* _graphics_slot(DvzRenderer* rd, DvzRequest req, void* user_data)
 {
-    DvzGraphics* graphics = _get_graphics(rd, req, user_data);
     ASSERT(req.type == DVZ_REQUEST_OBJECT_SLOT);
+    if (_is_compute(rd, req))
+    {
+        DvzCompute* compute = _get_compute(rd, req, user_data);
+        dvz_compute_slot(
+            compute, req.content.set_slot.slot_idx, (VkDescriptorType)req.content.set_slot.type);
+        return NULL;
+    }
+
+    DvzGraphics* graphics = _get_graphics(rd, req, user_data);
 
     // NOTE: we assume VkDescriptorType and DvzDescriptorType match.
     dvz_graphics_slot(
@@ -469,10 +549,17 @@ static void* _graphics_slot(DvzRenderer* rd, DvzRequest req, void* user_data)
 
 static void* _graphics_push(DvzRenderer* rd, DvzRequest req, void* user_data)
 {
-    DvzGraphics* graphics = _get_graphics(rd, req, user_data);
     ASSERT(req.type == DVZ_REQUEST_OBJECT_PUSH);
 
     VkShaderStageFlagBits stages = (VkShaderStageFlagBits)req.content.set_push.shader_stages;
+    if (_is_compute(rd, req))
+    {
+        DvzCompute* compute = _get_compute(rd, req, user_data);
+        dvz_compute_push(compute, stages, req.content.set_push.offset, req.content.set_push.size);
+        return NULL;
+    }
+
+    DvzGraphics* graphics = _get_graphics(rd, req, user_data);
     dvz_graphics_push(graphics, stages, req.content.set_push.offset, req.content.set_push.size);
 
     return NULL;
@@ -518,6 +605,78 @@ static void* _graphics_delete(DvzRenderer* rd, DvzRequest req, void* user_data)
 /*  Computes                                                                                     */
 /*************************************************************************************************/
 
+static void* _compute_create(DvzRenderer* rd, DvzRequest req, void* user_data)
+{
+    ANN(rd);
+
+    // Get the compute shader.
+    GET_ID(DvzShader, shader, req.content.compute.shader)
+    if (shader->type != DVZ_SHADER_COMPUTE)
+    {
+        log_error("shader 0x%" PRIx64 " is not a compute shader", req.content.compute.shader);
+        return NULL;
+    }
+
+    // Create the pipe.
+    log_trace("create pipelib compute");
+    DvzPipe* pipe = dvz_pipelib_compute(rd->pipelib, shader);
+    ANN(pipe);
+    pipe->flags = req.flags;
+    SET_ID(pipe)
+
+    return (void*)pipe;
+}
+
+
+
+static void* _compute_dispatch(DvzRenderer* rd, DvzRequest req, void* user_data)
+{
+    ANN(rd);
+    ASSERT(req.id != 0);
+
+    DvzGpu* gpu = rd->gpu;
+    ANN(gpu);
+
+    // Get the compute pipe.
+    GET_ID(DvzPipe, pipe, req.id)
+    ASSERT(pipe->type == DVZ_PIPE_COMPUTE);
+
+    if (!dvz_pipe_complete(pipe))
+    {
+        log_error("cannot dispatch compute 0x%" PRIx64 ": some slots are not bound", req.id);
+        return NULL;
+    }
+
+    // Lazily create or recreate the compute pipeline.
+    pipe = dvz_renderer_pipe(rd, req.id);
+    ANN(pipe);
+
+    // Make sure the pending uploads to the bound dats have been done.
+    dvz_transfers_flush(&rd->ctx->transfers);
+
+    // Lazily allocate the compute command buffer.
+    DvzCommands* cmds = &rd->cmds_compute;
+    if (cmds->count == 0)
+        *cmds = dvz_commands(gpu, DVZ_DEFAULT_QUEUE_COMPUTE, 1);
+
+    log_debug(
+        "dispatch compute 0x%" PRIx64 " with %dx%dx%d workgroups", req.id,
+        req.content.dispatch.group_count[0], req.content.dispatch.group_count[1],
+        req.content.dispatch.group_count[2]);
+
+    dvz_cmd_reset(cmds, 0);
+    dvz_cmd_begin(cmds, 0);
+    dvz_pipe_run(pipe, cmds, 0, req.content.dispatch.group_count);
+    dvz_cmd_end(cmds, 0);
+
+    // NOTE: the dispatch is synchronous so that the next requests (downloads, draws) see the
+    // results of the compute.
+    dvz_cmd_submit_sync(cmds, 0);
+
+    return NULL;
+}
+
+
 
 
 /*************************************************************************************************/
@@ -657,8 +816,19 @@ static void* _dat_upload(DvzRenderer* rd, DvzRequest req, void* user_data)
     ANN(req.content.dat_upload.data);
     ASSERT(req.content.dat_upload.size > 0);
 
+    // Dats that keep their data when resized grow to hold data appended after their end.
+    if (_dat_keep_on_resize(dat))
+    {
+        DvzSize end = req.content.dat_upload.offset + req.content.dat_upload.size;
+        if (end > dat->size)
+        {
+            log_debug("appending data to dat, resizing it to %s", pretty_size(end));
+            dvz_dat_resize(dat, end);
+        }
+    }
+
     // Make sure the target dat is large enough to hold the uploaded data.
-    if (req.content.dat_upload.size > dat->br.aligned_size)
+    else if (req.content.dat_upload.size > dat->br.aligned_size)
     {
         log_debug(
             "data to upload is larger (%s) than the dat size (%s), resizing it",
@@ -773,17 +943,21 @@ static void* _tex_upload(DvzRenderer* rd, DvzRequest req, void* user_data)
 
     log_trace("uploading %s to tex", pretty_size(req.content.tex_upload.size));
 
+    // Streaming texs copy the data to their staging ring right away, and the copy to the image is
+    // done at the next frame.
+    bool wait = (tex->flags & DVZ_TEX_FLAGS_STREAMING) == 0;
     dvz_tex_upload(
         tex,                           //
         req.content.tex_upload.offset, //
         req.content.tex_upload.shape,  //
         req.content.tex_upload.size,   //
         req.content.tex_upload.data,   //
-        true);                         // TODO: do not wait? try false
+        wait);
 
     // We free the copy of the data that had been done by the requester in dvz_upload_dat().
+    // NOTE: this is safe without waiting, as streaming texs copy the data to their staging ring
+    // before dvz_tex_upload() returns.
     FREE(req.content.tex_upload.data);
-    // TODO: if we do not wait, the freeing must wait until the transfer is done.
 
     return NULL;
 }
@@ -968,6 +1142,7 @@ static void _setup_router(DvzRenderer* rd)
         rd, DVZ_REQUEST_ACTION_RESIZE, DVZ_REQUEST_OBJECT_CANVAS, _canvas_resize, NULL);
     dvz_renderer_register(
         rd, DVZ_REQUEST_ACTION_SET, DVZ_REQUEST_OBJECT_BACKGROUND, _canvas_background, NULL);
+    dvz_renderer_register(rd, DVZ_REQUEST_ACTION_GET, DVZ_REQUEST_OBJECT_PICK, _canvas_pick, NULL);
 
     dvz_renderer_register(
         rd, DVZ_REQUEST_ACTION_DELETE, DVZ_REQUEST_OBJECT_CANVAS, _canvas_delete, NULL);
@@ -1008,6 +1183,8 @@ static void _setup_router(DvzRenderer* rd)
     // Shaders.
     dvz_renderer_register(
         rd, DVZ_REQUEST_ACTION_CREATE, DVZ_REQUEST_OBJECT_SHADER, _shader_create, NULL);
+    dvz_renderer_register(
+        rd, DVZ_REQUEST_ACTION_DELETE, DVZ_REQUEST_OBJECT_SHADER, _shader_delete, NULL);
 
     // Bindings.
     dvz_renderer_register(
@@ -1019,7 +1196,13 @@ static void _setup_router(DvzRenderer* rd)
     dvz_renderer_register(
         rd, DVZ_REQUEST_ACTION_BIND, DVZ_REQUEST_OBJECT_TEX, _graphics_bind_tex, NULL);
 
-    // TODO: computes.
+    // Computes.
+    dvz_renderer_register(
+        rd, DVZ_REQUEST_ACTION_CREATE, DVZ_REQUEST_OBJECT_COMPUTE, _compute_create, NULL);
+    dvz_renderer_register(
+        rd, DVZ_REQUEST_ACTION_DISPATCH, DVZ_REQUEST_OBJECT_COMPUTE, _compute_dispatch, NULL);
+    dvz_renderer_register(
+        rd, DVZ_REQUEST_ACTION_DELETE, DVZ_REQUEST_OBJECT_COMPUTE, _graphics_delete, NULL);
 
     // Dat.
     dvz_renderer_register(
@@ -1096,6 +1279,10 @@ static void _update_mapping(DvzRenderer* rd, DvzRequest req, void* obj)
         // Remove the id from the mapping.
         dvz_map_remove(rd->map, req.id);
 
+        // The object is gone, its dense handle can now be reused.
+        if (dvz_handle_is_dense(req.id))
+            dvz_handles_free(dvz_handles_global(), req.id);
+
         break;
 
     default:
@@ -1150,12 +1337,14 @@ void dvz_renderer_request(DvzRenderer* rd, DvzRequest req)
     // dvz_request_print(&req, 0);
 
     void* user_data = rd->router->user_data[key];
+    dvz_trace_begin_args("renderer", "request", "action", req.action, "type", req.type);
 
     // Call the renderer callback.
     void* obj = cb(rd, req, user_data);
 
     // Register the pointer in the map table, associated with its id.
     _update_mapping(rd, req, obj);
+    dvz_trace_end();
 }
 
 
@@ -1167,6 +1356,28 @@ void dvz_renderer_requests(DvzRenderer* rd, uint32_t count, DvzRequest* reqs)
         return;
     ASSERT(count > 0);
     ANN(reqs);
+
+    // Compile the GLSL shaders of the batch in parallel into the SPIR-V cache, the requests below
+    // then only pick the compiled code from the cache.
+    std::vector<const char*> codes;
+    std::vector<VkShaderStageFlagBits> stages;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (reqs[i].action == DVZ_REQUEST_ACTION_CREATE &&
+            reqs[i].type == DVZ_REQUEST_OBJECT_SHADER &&
+            reqs[i].content.shader.format == DVZ_SHADER_GLSL &&
+            reqs[i].content.shader.code != NULL)
+        {
+            codes.push_back(reqs[i].content.shader.code);
+            stages.push_back((VkShaderStageFlagBits)reqs[i].content.shader.type);
+        }
+    }
+    if (codes.size() > 1)
+    {
+        dvz_compiler_batch(
+            dvz_host_compiler(rd->gpu), (uint32_t)codes.size(), codes.data(), stages.data());
+    }
+
     for (uint32_t i = 0; i < count; i++)
     {
         dvz_renderer_request(rd, reqs[i]);
@@ -1212,6 +1423,19 @@ DvzTex* dvz_renderer_tex(DvzRenderer* rd, DvzId id)
 
 
 
+bool dvz_renderer_pick(DvzRenderer* rd, DvzId canvas_id, DvzPick* pick)
+{
+    ANN(rd);
+    ANN(pick);
+
+    DvzCanvas* canvas = (DvzCanvas*)dvz_map_get(rd->map, canvas_id);
+    ANN(canvas);
+
+    return dvz_canvas_picked(canvas, pick);
+}
+
+
+
 DvzPipe* dvz_renderer_pipe(DvzRenderer* rd, DvzId id)
 {
     ANN(rd);
@@ -1295,6 +1519,129 @@ uint8_t* dvz_renderer_image(DvzRenderer* rd, DvzId canvas_id, DvzSize* size, uin
 
 
 
+// Update the descriptors of the pipes that refer to a shared buffer that has been compacted.
+static void
+_rebind_pipes(DvzContainer* pipes, DvzBuffer* buffer, uint32_t count, DvzAllocMove* moves)
+{
+    ANN(pipes);
+    ANN(buffer);
+
+    DvzContainerIterator iter = dvz_container_iterator(pipes);
+    DvzPipe* pipe = NULL;
+    while (iter.item != NULL)
+    {
+        pipe = (DvzPipe*)iter.item;
+        ANN(pipe);
+
+        bool rebind = false;
+        for (uint32_t idx = 0; idx < DVZ_MAX_BINDINGS; idx++)
+        {
+            DvzBufferRegions* br = &pipe->descriptors.br[idx];
+            if (!pipe->descriptors_set[idx] || br->buffer != buffer)
+                continue;
+            for (uint32_t i = 0; i < br->count; i++)
+                br->offsets[i] = dvz_alloc_relocated(count, moves, br->offsets[i]);
+            rebind = true;
+        }
+
+        // NOTE: the Vulkan buffer handle has changed, so the descriptors must be updated even if
+        // no dat has moved.
+        if (rebind && dvz_pipe_complete(pipe))
+            dvz_descriptors_update(&pipe->descriptors);
+
+        dvz_container_iter(&iter);
+    }
+}
+
+
+
+// Make sure the command buffers of the canvases and boards are recorded again.
+static void _rerecord_canvases(DvzRenderer* rd)
+{
+    ANN(rd);
+    if (rd->workspace == NULL)
+        return;
+
+    DvzContainerIterator iter = dvz_container_iterator(&rd->workspace->canvases);
+    DvzCanvas* canvas = NULL;
+    while (iter.item != NULL)
+    {
+        canvas = (DvzCanvas*)iter.item;
+        ANN(canvas);
+        // The presenter will record the command buffers again in the event loop.
+        if (canvas->recorder != NULL)
+            dvz_recorder_set_dirty(canvas->recorder);
+        dvz_container_iter(&iter);
+    }
+
+    iter = dvz_container_iterator(&rd->workspace->boards);
+    while (iter.item != NULL)
+    {
+        canvas = (DvzCanvas*)iter.item;
+        ANN(canvas);
+        // Boards are recorded directly.
+        if (canvas->recorder != NULL && dvz_recorder_size(canvas->recorder) > 0)
+        {
+            dvz_recorder_set_dirty(canvas->recorder);
+            dvz_recorder_set(canvas->recorder, rd, &canvas->cmds, 0);
+        }
+        dvz_container_iter(&iter);
+    }
+}
+
+
+
+DvzSize dvz_renderer_compact(DvzRenderer* rd)
+{
+    ANN(rd);
+    ANN(rd->ctx);
+    ANN(rd->pipelib);
+    dvz_trace_begin("renderer", "compact");
+
+    DvzResources* res = &rd->ctx->res;
+    DvzDatAlloc* datalloc = &rd->ctx->datalloc;
+
+    // The dats must not be in use while they are moved.
+    dvz_transfers_flush(&rd->ctx->transfers);
+    dvz_gpu_wait(rd->gpu);
+
+    DvzSize total = 0;
+    bool changed = false;
+    DvzAllocMove* moves = NULL;
+    uint32_t count = 0;
+
+    // NOTE: the staging buffer is skipped as it may hold pending transfers.
+    for (uint32_t i = 2; i <= DVZ_BUFFER_TYPE_COUNT; i++)
+    {
+        for (uint32_t mappable = 0; mappable <= 1; mappable++)
+        {
+            // NOTE: compaction must not create the shared buffers that do not exist yet.
+            DvzBuffer* buffer = _find_shared_buffer(res, (DvzBufferType)i, (bool)mappable);
+            if (buffer == NULL)
+                continue;
+            VkBuffer handle = buffer->buffer;
+
+            count = dvz_datalloc_compact(datalloc, res, (DvzBufferType)i, (bool)mappable, &moves);
+            if (buffer->buffer != handle)
+            {
+                _rebind_pipes(&rd->pipelib->graphics, buffer, count, moves);
+                _rebind_pipes(&rd->pipelib->computes, buffer, count, moves);
+                changed = true;
+            }
+            FREE(moves);
+            total += buffer->size;
+        }
+    }
+
+    if (changed)
+        _rerecord_canvases(rd);
+
+    dvz_trace_end();
+    return total;
+}
+
+
+
 void dvz_renderer_destroy(DvzRenderer* rd)
 {
     ANN(rd);
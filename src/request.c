@@ -9,9 +9,11 @@
 /*************************************************************************************************/
 
 #include "_debug.h"
+#include "_handle.h"
 #include "_list.h"
 #include "_pointer.h"
 #include "_prng.h"
+#include "_trace.h"
 #include "datoviz_math.h"
 #include "datoviz_protocol.h"
 #include "env_utils.h"
@@ -62,6 +64,35 @@
 // Global PRNG for all requests.
 static DvzPrng* PRNG;
 
+// Process-wide dense handle allocator, only used when DVZ_DENSE_IDS is set.
+static DvzHandles* HANDLES;
+
+
+
+static void _init_ids(void)
+{
+    if (!PRNG)
+        PRNG = dvz_prng();
+
+    // NOTE: dense handles are resolved in O(1) by the renderer, but they are only unique within
+    // the current process. Random IDs remain the default for cross-process scenarios.
+    if (!HANDLES && checkenv("DVZ_DENSE_IDS"))
+    {
+        log_debug("using dense handles for object IDs");
+        HANDLES = dvz_handles_global();
+    }
+}
+
+
+
+static DvzId _new_id(DvzRequestObject type)
+{
+    if (HANDLES != NULL)
+        return dvz_handles_alloc(HANDLES, (uint32_t)(type % DVZ_HANDLE_MAX_TYPES));
+    // NOTE: the top bit is reserved for dense handles.
+    return dvz_prng_uuid(PRNG) & DVZ_HANDLE_RANDOM_MASK;
+}
+
 
 
 static DvzRequest _request(void)
@@ -254,6 +285,21 @@ static void _print_set_background(DvzRequest* req)
         req->content.canvas.background[3]);
 }
 
+static void _print_pick(DvzRequest* req)
+{
+    log_trace("print_pick");
+    ANN(req);
+    printf(
+        "- action: get\n"
+        "  type: pick\n"
+        "  id: 0x%" PRIx64 "\n"
+        "  content:\n"
+        "    x: %d\n"
+        "    y: %d\n"
+        "    radius: %d\n",
+        req->id, req->content.pick.x, req->content.pick.y, req->content.pick.radius);
+}
+
 static void _print_delete_canvas(DvzRequest* req)
 {
     log_trace("print_delete_canvas");
@@ -483,6 +529,17 @@ static void _print_create_shader(DvzRequest* req, int flags)
         FREE(encoded);
 }
 
+static void _print_delete_shader(DvzRequest* req)
+{
+    log_trace("print_delete_shader");
+    ANN(req);
+    printf(
+        "- action: delete\n"
+        "  type: shader\n"
+        "  id: 0x%" PRIx64 "\n",
+        req->id);
+}
+
 
 
 static void _print_create_graphics(DvzRequest* req)
@@ -513,6 +570,48 @@ static void _print_delete_graphics(DvzRequest* req)
 
 
 
+static void _print_create_compute(DvzRequest* req)
+{
+    log_trace("print_create_compute");
+    ANN(req);
+    printf(
+        "- action: create\n"
+        "  type: compute\n"
+        "  desc: %s\n"
+        "  id: 0x%" PRIx64 "\n"
+        "  flags: %d\n"
+        "  content:\n"
+        "    shader: 0x%" PRIx64 "\n",
+        req->desc ? req->desc : "", req->id, req->flags, req->content.compute.shader);
+}
+
+static void _print_dispatch_compute(DvzRequest* req)
+{
+    log_trace("print_dispatch_compute");
+    ANN(req);
+    printf(
+        "- action: dispatch\n"
+        "  type: compute\n"
+        "  id: 0x%" PRIx64 "\n"
+        "  content:\n"
+        "    group_count: [%d, %d, %d]\n",
+        req->id, req->content.dispatch.group_count[0], req->content.dispatch.group_count[1],
+        req->content.dispatch.group_count[2]);
+}
+
+static void _print_delete_compute(DvzRequest* req)
+{
+    log_trace("print_delete_compute");
+    ANN(req);
+    printf(
+        "- action: delete\n"
+        "  type: compute\n"
+        "  id: 0x%" PRIx64 "\n",
+        req->id);
+}
+
+
+
 static void _print_bind_vertex(DvzRequest* req)
 {
     log_trace("print_bind_vertex");
@@ -947,6 +1046,44 @@ static void _print_record_draw_indexed_indirect(DvzRequest* req)
 
 
 
+static void _print_record_timestamp(DvzRequest* req)
+{
+    log_trace("print_record_timestamp");
+    ANN(req);
+
+    printf(
+        "- action: record\n"
+        "  type: timestamp\n"
+        "  id: 0x%" PRIx64 "\n"
+        "  content:\n"
+        "    span: 0x%" PRIx64 "\n"
+        "    end: %d\n",
+        req->id, //
+        req->content.record.command.contents.timestamp.id,
+        req->content.record.command.contents.timestamp.end);
+}
+
+
+
+static void _print_record_dispatch(DvzRequest* req)
+{
+    log_trace("print_record_dispatch");
+    ANN(req);
+
+    DvzRecorderDispatch* dispatch = &req->content.record.command.contents.dispatch;
+    printf(
+        "- action: record\n"
+        "  type: dispatch\n"
+        "  id: 0x%" PRIx64 "\n"
+        "  content:\n"
+        "    compute: 0x%" PRIx64 "\n"
+        "    group_count: [%d, %d, %d]\n"
+        "    indirect: 0x%" PRIx64 "\n",
+        req->id, //
+        dispatch->pipe_id, dispatch->group_count[0], dispatch->group_count[1],
+        dispatch->group_count[2], dispatch->dat_indirect_id);
+}
+
 static void _print_record_end(DvzRequest* req)
 {
     log_trace("print_record_end");
@@ -968,6 +1105,7 @@ void dvz_request_print(DvzRequest* req, int flags)
     IF_REQ(UPDATE, CANVAS) _print_update_canvas(req);
     IF_REQ(RESIZE, CANVAS) _print_resize_canvas(req);
     IF_REQ(SET, BACKGROUND) _print_set_background(req);
+    IF_REQ(GET, PICK) _print_pick(req);
     IF_REQ(DELETE, CANVAS) _print_delete_canvas(req);
 
     IF_REQ(CREATE, DAT) _print_create_dat(req);
@@ -980,9 +1118,14 @@ void dvz_request_print(DvzRequest* req, int flags)
 
     IF_REQ(CREATE, SAMPLER) _print_create_sampler(req);
     IF_REQ(CREATE, SHADER) _print_create_shader(req, flags);
+    IF_REQ(DELETE, SHADER) _print_delete_shader(req);
 
     IF_REQ(CREATE, GRAPHICS) _print_create_graphics(req);
 
+    IF_REQ(CREATE, COMPUTE) _print_create_compute(req);
+    IF_REQ(DISPATCH, COMPUTE) _print_dispatch_compute(req);
+    IF_REQ(DELETE, COMPUTE) _print_delete_compute(req);
+
 
     IF_REQ(BIND, VERTEX) _print_bind_vertex(req);
     IF_REQ(BIND, INDEX) _print_bind_index(req);
@@ -1019,6 +1162,10 @@ void dvz_request_print(DvzRequest* req, int flags)
             _print_record_draw_indirect(req);
         if (req->content.record.command.type == DVZ_RECORDER_DRAW_INDEXED_INDIRECT)
             _print_record_draw_indexed_indirect(req);
+        if (req->content.record.command.type == DVZ_RECORDER_TIMESTAMP)
+            _print_record_timestamp(req);
+        if (req->content.record.command.type == DVZ_RECORDER_DISPATCH)
+            _print_record_dispatch(req);
         if (req->content.record.command.type == DVZ_RECORDER_END)
             _print_record_end(req);
     }
@@ -1036,9 +1183,8 @@ DvzRequester* dvz_requester(void)
 {
     log_trace("create requester");
 
-    // Initialize the global PRNG.
-    if (!PRNG)
-        PRNG = dvz_prng();
+    // Initialize the global ID generators.
+    _init_ids();
 
     DvzRequester* rqr = (DvzRequester*)calloc(1, sizeof(DvzRequester));
 
@@ -1061,8 +1207,12 @@ void dvz_requester_destroy(DvzRequester* rqr)
     dvz_fifo_destroy(rqr->fifo);
     FREE(rqr);
 
-    // Destroy the global PRNG.
+    // Destroy the global ID generator.
+    // NOTE: the dense handle allocator lives for the whole process, as the renderer may still
+    // hold objects with handles it allocated. The handles are freed when their deletion is
+    // processed by the renderer, not when the delete request is created.
     dvz_prng_destroy(PRNG);
+    PRNG = NULL;
 
     log_trace("requester destroyed");
 }
@@ -1075,9 +1225,8 @@ void dvz_requester_destroy(DvzRequester* rqr)
 
 DvzBatch* dvz_batch(void)
 {
-    // Initialize the global PRNG.
-    if (!PRNG)
-        PRNG = dvz_prng();
+    // Initialize the global ID generators.
+    _init_ids();
 
     DvzBatch* batch = (DvzBatch*)calloc(1, sizeof(DvzBatch));
     batch->capacity = DVZ_BATCH_DEFAULT_CAPACITY;
@@ -1380,8 +1529,10 @@ void dvz_requester_commit(DvzRequester* rqr, DvzBatch* batch)
     ANN(rqr);
     ANN(batch);
 
+    dvz_trace_begin_args("requester", "commit", "count", batch->count, NULL, 0);
     DvzBatch* batch_cpy = (DvzBatch*)_cpy(sizeof(DvzBatch), batch);
     dvz_fifo_enqueue(rqr->fifo, batch_cpy);
+    dvz_trace_end();
 }
 
 
@@ -1398,11 +1549,13 @@ DvzBatch* dvz_requester_flush(DvzRequester* rqr, uint32_t* count)
     ASSERT(size < (int)UINT16_MAX);
     *count = (uint32_t)size;
 
+    dvz_trace_begin_args("requester", "flush", "batches", size, NULL, 0);
     DvzBatch* batches = (DvzBatch*)calloc(*count, sizeof(DvzBatch));
     for (uint32_t i = 0; i < *count; i++)
     {
         memcpy(&batches[i], dvz_fifo_dequeue(rqr->fifo, false), sizeof(DvzBatch));
     }
+    dvz_trace_end();
     return batches;
 }
 
@@ -1427,7 +1580,7 @@ dvz_create_canvas(DvzBatch* batch, uint32_t width, uint32_t height, cvec4 backgr
     char* capture = capture_png(&offscreen);
 
     CREATE_REQUEST(CREATE, CANVAS);
-    req.id = dvz_prng_uuid(PRNG);
+    req.id = _new_id(req.type);
     req.flags = flags;
     req.content.canvas.is_offscreen = offscreen; // true for boards
 
@@ -1482,6 +1635,22 @@ DvzRequest dvz_resize_canvas(DvzBatch* batch, DvzId canvas, uint32_t width, uint
 
 
 
+DvzRequest dvz_pick(DvzBatch* batch, DvzId canvas, int32_t x, int32_t y, uint32_t radius)
+{
+    CREATE_REQUEST(GET, PICK);
+    req.id = canvas;
+    req.content.pick.x = x;
+    req.content.pick.y = y;
+    req.content.pick.radius = radius;
+
+    IF_VERBOSE
+    _print_pick(&req);
+
+    RETURN_REQUEST
+}
+
+
+
 DvzRequest dvz_set_background(DvzBatch* batch, DvzId id, cvec4 background)
 {
     CREATE_REQUEST(SET, BACKGROUND);
@@ -1516,7 +1685,7 @@ DvzRequest dvz_delete_canvas(DvzBatch* batch, DvzId id)
 DvzRequest dvz_create_dat(DvzBatch* batch, DvzBufferType type, DvzSize size, int flags)
 {
     CREATE_REQUEST(CREATE, DAT);
-    req.id = dvz_prng_uuid(PRNG);
+    req.id = _new_id(req.type);
     req.flags = flags;
     req.content.dat.type = type;
     req.content.dat.size = size;
@@ -1598,7 +1767,7 @@ DvzRequest
 dvz_create_tex(DvzBatch* batch, DvzTexDims dims, DvzFormat format, uvec3 shape, int flags)
 {
     CREATE_REQUEST(CREATE, TEX);
-    req.id = dvz_prng_uuid(PRNG);
+    req.id = _new_id(req.type);
     req.flags = flags;
     req.content.tex.dims = dims;
     memcpy(req.content.tex.shape, shape, sizeof(uvec3));
@@ -1675,7 +1844,7 @@ DvzRequest dvz_delete_tex(DvzBatch* batch, DvzId id)
 DvzRequest dvz_create_sampler(DvzBatch* batch, DvzFilter filter, DvzSamplerAddressMode mode)
 {
     CREATE_REQUEST(CREATE, SAMPLER);
-    req.id = dvz_prng_uuid(PRNG);
+    req.id = _new_id(req.type);
     req.content.sampler.filter = filter;
     req.content.sampler.mode = mode;
 
@@ -1711,7 +1880,7 @@ DvzRequest dvz_create_glsl(DvzBatch* batch, DvzShaderType shader_type, const cha
     ANN(code);
 
     CREATE_REQUEST(CREATE, SHADER);
-    req.id = dvz_prng_uuid(PRNG);
+    req.id = _new_id(req.type);
     req.content.shader.format = DVZ_SHADER_GLSL;
     req.content.shader.type = shader_type;
     DvzSize size = strnlen(code, 1048576) + 1; // NOTE: null-terminated string
@@ -1732,7 +1901,7 @@ DvzRequest dvz_create_spirv(
     ASSERT(size > 0);
 
     CREATE_REQUEST(CREATE, SHADER);
-    req.id = dvz_prng_uuid(PRNG);
+    req.id = _new_id(req.type);
     req.content.shader.format = DVZ_SHADER_SPIRV;
     req.content.shader.type = shader_type;
     req.content.shader.size = size;
@@ -1745,6 +1914,21 @@ DvzRequest dvz_create_spirv(
 
 
 
+DvzRequest dvz_delete_shader(DvzBatch* batch, DvzId id)
+{
+    ASSERT(id != DVZ_ID_NONE);
+
+    CREATE_REQUEST(DELETE, SHADER);
+    req.id = id;
+
+    IF_VERBOSE
+    _print_delete_shader(&req);
+
+    RETURN_REQUEST
+}
+
+
+
 /*************************************************************************************************/
 /*  Graphics                                                                                     */
 /*************************************************************************************************/
@@ -1752,7 +1936,7 @@ DvzRequest dvz_create_spirv(
 DvzRequest dvz_create_graphics(DvzBatch* batch, DvzGraphicsType type, int flags)
 {
     CREATE_REQUEST(CREATE, GRAPHICS);
-    req.id = dvz_prng_uuid(PRNG);
+    req.id = _new_id(req.type);
     req.flags = flags;
     req.content.graphics.type = type;
 
@@ -2009,6 +2193,61 @@ DvzRequest dvz_delete_graphics(DvzBatch* batch, DvzId id)
 
 
 
+/*************************************************************************************************/
+/*  Computes                                                                                     */
+/*************************************************************************************************/
+
+DvzRequest dvz_create_compute(DvzBatch* batch, DvzId shader, int flags)
+{
+    ASSERT(shader != DVZ_ID_NONE);
+
+    CREATE_REQUEST(CREATE, COMPUTE);
+    req.id = _new_id(req.type);
+    req.flags = flags;
+    req.content.compute.shader = shader;
+
+    IF_VERBOSE
+    _print_create_compute(&req);
+
+    RETURN_REQUEST
+}
+
+
+
+DvzRequest dvz_dispatch_compute(DvzBatch* batch, DvzId compute, uvec3 group_count)
+{
+    ASSERT(compute != DVZ_ID_NONE);
+    ASSERT(group_count[0] > 0);
+    ASSERT(group_count[1] > 0);
+    ASSERT(group_count[2] > 0);
+
+    CREATE_REQUEST(DISPATCH, COMPUTE);
+    req.id = compute;
+    memcpy(req.content.dispatch.group_count, group_count, sizeof(uvec3));
+
+    IF_VERBOSE
+    _print_dispatch_compute(&req);
+
+    RETURN_REQUEST
+}
+
+
+
+DvzRequest dvz_delete_compute(DvzBatch* batch, DvzId id)
+{
+    ASSERT(id != DVZ_ID_NONE);
+
+    CREATE_REQUEST(DELETE, COMPUTE);
+    req.id = id;
+
+    IF_VERBOSE
+    _print_delete_compute(&req);
+
+    RETURN_REQUEST
+}
+
+
+
 /*************************************************************************************************/
 /*  Bindings                                                                                     */
 /*************************************************************************************************/
@@ -2256,6 +2495,48 @@ DvzRequest dvz_record_draw_indexed_indirect(
 
 
 
+DvzRequest dvz_record_timestamp(DvzBatch* batch, DvzId canvas_id, DvzId id, bool end)
+{
+    ASSERT(canvas_id != DVZ_ID_NONE);
+
+    CREATE_REQUEST(RECORD, RECORD);
+    req.id = canvas_id;
+    req.content.record.command.type = DVZ_RECORDER_TIMESTAMP;
+    req.content.record.command.contents.timestamp.id = id;
+    req.content.record.command.contents.timestamp.end = end;
+
+    IF_VERBOSE
+    _print_record_timestamp(&req);
+
+    RETURN_REQUEST
+}
+
+
+
+DvzRequest dvz_record_dispatch(
+    DvzBatch* batch, DvzId canvas_id, DvzId compute, uvec3 group_count, DvzId indirect)
+{
+    ASSERT(canvas_id != DVZ_ID_NONE);
+    ASSERT(compute != DVZ_ID_NONE);
+    ASSERT(group_count[0] > 0);
+    ASSERT(group_count[1] > 0);
+    ASSERT(group_count[2] > 0);
+
+    CREATE_REQUEST(RECORD, RECORD);
+    req.id = canvas_id;
+    req.content.record.command.type = DVZ_RECORDER_DISPATCH;
+    req.content.record.command.contents.dispatch.pipe_id = compute;
+    memcpy(req.content.record.command.contents.dispatch.group_count, group_count, sizeof(uvec3));
+    req.content.record.command.contents.dispatch.dat_indirect_id = indirect;
+
+    IF_VERBOSE
+    _print_record_dispatch(&req);
+
+    RETURN_REQUEST
+}
+
+
+
 DvzRequest dvz_record_end(DvzBatch* batch, DvzId canvas_id)
 {
     ASSERT(canvas_id != DVZ_ID_NONE);
@@ -81,6 +81,64 @@ static void _wait_dup(DvzTransfers* transfers, DvzDat* dat)
 
 
 
+/*************************************************************************************************/
+/*  Streaming utils                                                                              */
+/*************************************************************************************************/
+
+// Write a tex upload in the next segment of the staging ring, and enqueue the copy to the image
+// without waiting: the copy is done by the event loop at the next frame.
+static void _tex_stream(
+    DvzTransfers* transfers, DvzTex* tex, uvec3 offset, uvec3 shape, DvzSize size, void* data)
+{
+    ANN(transfers);
+    ANN(tex);
+    ANN(tex->ring);
+    ANN(data);
+
+    DvzDat* ring = tex->ring;
+    DvzBuffer* buffer = ring->br.buffer;
+    ANN(buffer);
+    ANN(buffer->mmap);
+
+    DvzSize segment = ring->size / DVZ_TEX_STREAMING_RING;
+    if (size > segment)
+    {
+        log_error("tex upload larger than the tex (%s)", pretty_size(size));
+        return;
+    }
+
+    // All segments are waiting to be copied: process the pending copies now rather than
+    // overwriting them. This only happens with several uploads per frame.
+    if (tex->ring_flushes == transfers->flushes && tex->ring_used >= DVZ_TEX_STREAMING_RING)
+    {
+        log_debug("staging ring of the streaming tex is full, processing the pending copies");
+        dvz_transfers_flush(transfers);
+    }
+
+    // The segments written before the last processing of the pending copies are free again, once
+    // the GPU is done with these copies (usually the case at the next frame).
+    if (tex->ring_flushes != transfers->flushes)
+    {
+        _stream_wait(transfers);
+        tex->ring_used = 0;
+        tex->ring_flushes = transfers->flushes;
+    }
+
+    DvzSize stg_offset = tex->ring_head * segment;
+    memcpy((uint8_t*)buffer->mmap + ring->br.offsets[0] + stg_offset, data, size);
+
+    for (uint32_t i = 0; i < 3; i++)
+        shape[i] = shape[i] > 0 ? shape[i] : tex->shape[i];
+    DvzDeqItem* item = _create_buffer_image_copy(
+        DVZ_TRANSFER_STREAM_IMAGE, ring->br, stg_offset, size, tex->img, offset, shape);
+    dvz_deq_enqueue_submit(transfers->deq, item, false);
+
+    tex->ring_head = (tex->ring_head + 1) % DVZ_TEX_STREAMING_RING;
+    tex->ring_used++;
+}
+
+
+
 /*************************************************************************************************/
 /*  Resources                                                                                    */
 /*************************************************************************************************/
@@ -225,6 +283,14 @@ void dvz_dat_resize(DvzDat* dat, DvzSize new_size)
     ANN(dat);
     ANN(dat->br.buffer);
 
+    // Keep the existing data, with a reserved capacity so that repeated growth is amortized.
+    if (_dat_keep_on_resize(dat))
+    {
+        log_debug("resize dat to size %s, keeping its data", pretty_size(new_size));
+        _dat_resize_keep(dat, new_size);
+        return;
+    }
+
     if (new_size == dat->br.size)
     {
         return;
@@ -384,6 +450,10 @@ DvzTex* dvz_tex(DvzContext* ctx, DvzTexDims dims, uvec3 shape, DvzFormat format,
     // TODO: GPU sync before?
     _tex_alloc(res, tex, dims, format, shape);
 
+    // Streaming texs have their own staging ring.
+    if (_tex_streaming(tex))
+        _tex_ring_alloc(ctx, tex);
+
     dvz_obj_created(&tex->obj);
     return tex;
 }
@@ -395,6 +465,13 @@ void dvz_tex_resize(DvzTex* tex, uvec3 new_shape)
     ANN(tex);
     ANN(tex->img);
 
+    // The pending copies of streaming texs must be done before the image is resized.
+    if (tex->ring != NULL)
+    {
+        dvz_transfers_flush(&tex->ctx->transfers);
+        _stream_wait(&tex->ctx->transfers);
+    }
+
     // TODO: GPU sync before?
     dvz_images_resize(tex->img, new_shape);
 
@@ -406,6 +483,14 @@ void dvz_tex_resize(DvzTex* tex, uvec3 new_shape)
         dvz_dat_resize(tex->stg, new_size);
 
     memcpy(tex->shape, new_shape, sizeof(uvec3));
+
+    // Reallocate the staging ring of streaming texs.
+    if (tex->ring != NULL)
+    {
+        dvz_dat_destroy(tex->ring);
+        tex->ring = NULL;
+        _tex_ring_alloc(tex->ctx, tex);
+    }
 }
 
 
@@ -421,6 +506,17 @@ void dvz_tex_upload(DvzTex* tex, uvec3 offset, uvec3 shape, DvzSize size, void*
     DvzTransfers* transfers = &ctx->transfers;
     ANN(transfers);
 
+    if (tex->ring != NULL)
+    {
+        _tex_stream(transfers, tex, offset, shape, size, data);
+        if (wait)
+        {
+            dvz_transfers_flush(transfers);
+            _stream_wait(transfers);
+        }
+        return;
+    }
+
     // Get the associated staging buffer.
     DvzDat* stg = _tex_staging(ctx, tex, size);
     ANN(stg);
@@ -483,6 +579,13 @@ void dvz_tex_destroy(DvzTex* tex)
 {
     ANN(tex);
 
+    // The pending copies of streaming texs must not refer to the destroyed image and ring.
+    if (tex->ring != NULL)
+    {
+        dvz_transfers_flush(&tex->ctx->transfers);
+        _stream_wait(&tex->ctx->transfers);
+    }
+
     // Deallocate the tex.
     _tex_dealloc(tex);
 
@@ -490,5 +593,9 @@ void dvz_tex_destroy(DvzTex* tex)
     if (tex->stg != NULL)
         dvz_dat_destroy(tex->stg);
 
+    // Destroy the staging ring.
+    if (tex->ring != NULL)
+        dvz_dat_destroy(tex->ring);
+
     dvz_obj_destroyed(&tex->obj);
 }
@@ -79,8 +79,9 @@ static inline VkBufferUsageFlags _find_buffer_usage(DvzBufferType type)
         break;
 
     case DVZ_BUFFER_TYPE_INDEX:
-        usage = TRANSFERABLE | //
-                VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+        usage = TRANSFERABLE |                     //
+                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | //
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
         break;
 
     case DVZ_BUFFER_TYPE_STORAGE:
@@ -94,8 +95,9 @@ static inline VkBufferUsageFlags _find_buffer_usage(DvzBufferType type)
         break;
 
     case DVZ_BUFFER_TYPE_INDIRECT:
-        usage = TRANSFERABLE | //
-                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        usage = TRANSFERABLE |                        //
+                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | //
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
         break;
 
     default:
@@ -594,6 +596,71 @@ static void _dat_dealloc(DvzDat* dat)
 
 
 
+// Resize a dat while keeping its contents. The dat capacity grows geometrically, the allocation
+// is resized in place when possible, otherwise the contents are copied on the GPU to a new
+// allocation.
+static void _dat_resize_keep(DvzDat* dat, DvzSize new_size)
+{
+    ANN(dat);
+    ANN(dat->res);
+    ANN(dat->br.buffer);
+
+    // Resize the persistent staging dat if there is one.
+    if (dat->stg != NULL)
+    {
+        log_debug("resize the staging buffer too");
+        dvz_dat_resize(dat->stg, new_size);
+    }
+
+    DvzBufferRegions old = dat->br;
+    DvzSize capacity = dvz_alloc_capacity(old.size, new_size);
+    DvzSize kept = MIN(dat->size, new_size);
+    dat->size = new_size;
+    if (capacity == old.size)
+    {
+        log_trace("resize dat within its capacity %s", pretty_size(capacity));
+        return;
+    }
+
+    bool shared = !_dat_is_standalone(dat);
+    bool mappable = !_dat_has_staging(dat);
+    DvzBufferType type = old.buffer->type;
+
+    // Try to resize the allocation in place (only with a single copy in a shared buffer).
+    if (shared && old.count == 1)
+    {
+        DvzSize alignment = 0;
+        DvzSize tot_size = _total_aligned_size(old.buffer, 1, capacity, &alignment);
+        if (dvz_datalloc_extend(dat->datalloc, type, mappable, old.offsets[0], tot_size))
+        {
+            log_debug("resize dat in place to capacity %s", pretty_size(capacity));
+            dat->br = dvz_buffer_regions(old.buffer, 1, old.offsets[0], capacity, alignment);
+            return;
+        }
+    }
+
+    // Allocate the new region before releasing the old one, so that they do not overlap.
+    // NOTE: if the shared buffer is resized here, its contents and offsets are kept.
+    log_debug("reallocate dat with capacity %s", pretty_size(capacity));
+    _dat_alloc(dat->res, dat, type, old.count, capacity);
+
+    // Copy the contents of all copies with a single GPU copy command.
+    if (kept > 0 && _is_dat_valid(dat))
+    {
+        log_debug("copy %s to the reallocated dat", pretty_size(kept));
+        dvz_buffer_regions_copy(&old, UINT32_MAX, 0, &dat->br, UINT32_MAX, 0, kept);
+        dvz_queue_wait(old.buffer->gpu, old.buffer->gpu->cmd.queue_idx);
+    }
+
+    // Release the old region.
+    if (shared)
+        dvz_datalloc_dealloc(dat->datalloc, type, mappable, old.offsets[0]);
+    else
+        dvz_buffer_destroy(old.buffer);
+}
+
+
+
 /*************************************************************************************************/
 /*  Tex utils                                                                                    */
 /*************************************************************************************************/
@@ -606,6 +673,14 @@ static inline bool _tex_persistent_staging(DvzTex* tex)
 
 
 
+static inline bool _tex_streaming(DvzTex* tex)
+{
+    ANN(tex);
+    return (tex->flags & DVZ_TEX_FLAGS_STREAMING) != 0;
+}
+
+
+
 static DvzDat* _tex_staging(DvzContext* ctx, DvzTex* tex, DvzSize size)
 {
     ANN(ctx);
@@ -721,6 +796,34 @@ static inline DvzSize _tex_size(DvzFormat format, uvec3 shape)
 
 
 
+// Allocate the staging ring of a streaming tex, with one full-size segment per copy, and map it
+// once for all.
+static void _tex_ring_alloc(DvzContext* ctx, DvzTex* tex)
+{
+    ANN(ctx);
+    ANN(tex);
+    ASSERT(tex->ring == NULL);
+
+    DvzSize segment = _align(_tex_size(tex->format, tex->shape), 16);
+    log_debug(
+        "allocate staging ring with %d segments of %s for tex", DVZ_TEX_STREAMING_RING,
+        pretty_size(segment));
+    tex->ring = dvz_dat(
+        ctx, DVZ_BUFFER_TYPE_STAGING, DVZ_TEX_STREAMING_RING * segment,
+        DVZ_DAT_FLAGS_STANDALONE | DVZ_DAT_FLAGS_MAPPABLE);
+    ANN(tex->ring);
+
+    DvzBuffer* buffer = tex->ring->br.buffer;
+    ANN(buffer);
+    if (buffer->mmap == NULL)
+        buffer->mmap = dvz_buffer_map(buffer, 0, VK_WHOLE_SIZE);
+
+    tex->ring_head = 0;
+    tex->ring_used = 0;
+}
+
+
+
 static void _tex_dealloc(DvzTex* tex)
 {
     ANN(tex);
@@ -7,7 +7,10 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include <algorithm>
 #include <fstream>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #if HAS_MSDF
@@ -27,14 +30,17 @@ using namespace msdf_atlas;
 
 // HACK: need to put the macros definitions after msdf-atlas-gen because we redefine the
 // BLACK, WHITE, GRAY constants
+#include "_hash.h"
 #include "_macros.h"
 #include "_pointer.h"
+#include "_time_utils.h"
 #include "datoviz.h"
 #include "datoviz_protocol.h"
 #include "fileio.h"
 #include "scene/atlas.h"
 #include "scene/font.h"
 #include "scene/sdf.h"
+#include "scene/texture.h"
 
 
 
@@ -43,6 +49,17 @@ using namespace msdf_atlas;
 /*************************************************************************************************/
 
 #define MINIMUM_SCALE 64.0
+#define PIXEL_RANGE   4.0
+#define MITER_LIMIT   1.0
+
+// Version of the cached atlas files, to increment when the serialization format changes.
+#define ATLAS_CACHE_VERSION 1
+
+// Dynamic atlas.
+#define DYNAMIC_SIZE     512   // initial width and height of an empty dynamic atlas
+#define DYNAMIC_MAX_SIZE 16384 // maximum width and height of a dynamic atlas
+#define DYNAMIC_SPACING  1     // empty pixels between glyphs, to prevent bleeding
+#define DYNAMIC_THREADS  8     // maximum number of threads generating glyphs
 
 
 
@@ -50,6 +67,22 @@ using namespace msdf_atlas;
 /*  Structs                                                                                      */
 /*************************************************************************************************/
 
+// Rectangle of a glyph in a dynamic atlas, in pixels, with the origin at the top-left corner.
+struct DvzAtlasRect
+{
+    uint32_t x, y, w, h;
+};
+
+
+
+// Skyline node: the span [x, x + w) is occupied from the top of the atlas down to y.
+struct DvzSkylineNode
+{
+    uint32_t x, y, w;
+};
+
+
+
 extern "C" struct DvzAtlas
 {
     unsigned long ttf_size;
@@ -72,17 +105,40 @@ extern "C" struct DvzAtlas
     uint32_t width;
     uint32_t height;
     uint8_t* rgb;
+
+    // Dynamic atlas: glyphs are generated on demand and packed into the free space.
+    bool dynamic;
+    std::vector<DvzSkylineNode> skyline;
+    std::unordered_map<uint32_t, DvzAtlasRect> rects; // codepoint -> rectangle
+    uvec4 dirty;        // x0, y0, x1, y1 of the region modified since the last upload
+    bool grown;         // whether the atlas has grown since the last upload
+    DvzTexture* texture; // last texture created with dvz_atlas_texture()
 };
 
 
 
+/*************************************************************************************************/
+/*  Forward declarations                                                                         */
+/*************************************************************************************************/
+
+#if HAS_MSDF
+static void _atlas_cache_path(DvzAtlas* atlas, char* path, size_t size);
+
+static int _atlas_cache_load(DvzAtlas* atlas, const char* path);
+
+static void _atlas_cache_save(DvzAtlas* atlas, const char* path);
+#endif
+
+
+
 /*************************************************************************************************/
 /*  Atlas functions                                                                              */
 /*************************************************************************************************/
 
 DvzAtlas* dvz_atlas(unsigned long ttf_size, unsigned char* ttf_bytes)
 {
-    DvzAtlas* atlas = (DvzAtlas*)calloc(1, sizeof(DvzAtlas));
+    // NOTE: the struct has C++ members so it must be value-initialized with new.
+    DvzAtlas* atlas = new DvzAtlas();
     ANN(atlas);
 
     atlas->ttf_size = ttf_size;
@@ -164,6 +220,18 @@ int dvz_atlas_glyph(DvzAtlas* atlas, uint32_t codepoint, vec4 out_coords)
     int x, y, w, h;
     bool found = false;
 
+    if (atlas->dynamic)
+    {
+        auto it = atlas->rects.find(codepoint);
+        if (it == atlas->rects.end())
+            return 1;
+        out_coords[0] = (float)it->second.x;
+        out_coords[1] = (float)it->second.y;
+        out_coords[2] = (float)it->second.w;
+        out_coords[3] = (float)it->second.h;
+        return 0;
+    }
+
 #if HAS_MSDF
     for (const GlyphGeometry& glyph : atlas->glyphs)
     {
@@ -245,6 +313,19 @@ void dvz_atlas_load(DvzAtlas* atlas)
 int dvz_atlas_generate(DvzAtlas* atlas)
 {
     ANN(atlas);
+
+#if HAS_MSDF
+    // Try to load the atlas from the cache, keyed on the font and the generation parameters.
+    DvzClock clock = dvz_clock();
+    char path[1024] = {0};
+    _atlas_cache_path(atlas, path, sizeof(path));
+    if (path[0] != 0 && _atlas_cache_load(atlas, path) == 0)
+    {
+        log_debug("font atlas loaded from the cache in %.1f ms", dvz_clock_get(&clock) * 1000);
+        return 0;
+    }
+#endif
+
     log_debug("starting atlas generation");
 
     dvz_atlas_load(atlas);
@@ -266,8 +347,8 @@ int dvz_atlas_generate(DvzAtlas* atlas)
     packer.setMinimumScale(MINIMUM_SCALE);
 
     // packer.setPadding(5.0);
-    packer.setPixelRange(4.0);
-    packer.setMiterLimit(1.0);
+    packer.setPixelRange(PIXEL_RANGE);
+    packer.setMiterLimit(MITER_LIMIT);
 
     // Compute atlas layout - pack glyphs
     packer.pack(atlas->glyphs.data(), atlas->glyphs.size());
@@ -332,6 +413,9 @@ int dvz_atlas_generate(DvzAtlas* atlas)
         }
     }
 
+    log_debug("font atlas generated in %.1f ms", dvz_clock_get(&clock) * 1000);
+    if (path[0] != 0)
+        _atlas_cache_save(atlas, path);
 #endif
     return 0;
 }
@@ -413,6 +497,12 @@ DvzTexture* dvz_atlas_texture(DvzAtlas* atlas, DvzBatch* batch)
         DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER, atlas->width, atlas->height, rgba, 0);
     FREE(rgba);
 
+    // The texture is now up to date, subsequent changes of a dynamic atlas are uploaded by
+    // dvz_atlas_upload().
+    atlas->texture = texture;
+    atlas->grown = false;
+    memset(atlas->dirty, 0, sizeof(atlas->dirty));
+
     return texture;
 }
 
@@ -436,7 +526,367 @@ void dvz_atlas_destroy(DvzAtlas* atlas)
     deinitializeFreetype(atlas->ft);
 #endif
 
-    FREE(atlas);
+    delete atlas;
+}
+
+
+
+/*************************************************************************************************/
+/*  Dynamic atlas                                                                                */
+/*************************************************************************************************/
+
+static void _dirty_rect(DvzAtlas* atlas, uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+{
+    ANN(atlas);
+    if (w == 0 || h == 0)
+        return;
+    if (atlas->dirty[2] == 0) // empty dirty region
+    {
+        atlas->dirty[0] = x;
+        atlas->dirty[1] = y;
+        atlas->dirty[2] = x + w;
+        atlas->dirty[3] = y + h;
+    }
+    else
+    {
+        atlas->dirty[0] = MIN(atlas->dirty[0], x);
+        atlas->dirty[1] = MIN(atlas->dirty[1], y);
+        atlas->dirty[2] = MAX(atlas->dirty[2], x + w);
+        atlas->dirty[3] = MAX(atlas->dirty[3], y + h);
+    }
+}
+
+
+
+// Return the top y coordinate of a w x h rectangle placed at the left of the skyline node i, or
+// UINT32_MAX if it does not fit.
+static uint32_t _skyline_fit(DvzAtlas* atlas, uint32_t i, uint32_t w, uint32_t h)
+{
+    ANN(atlas);
+    const std::vector<DvzSkylineNode>& nodes = atlas->skyline;
+    uint32_t x = nodes[i].x;
+    if (x + w > atlas->width)
+        return UINT32_MAX;
+
+    uint32_t y = 0;
+    uint32_t remaining = w;
+    for (; i < nodes.size() && remaining > 0; i++)
+    {
+        y = MAX(y, nodes[i].y);
+        if (y + h > atlas->height)
+            return UINT32_MAX;
+        remaining = nodes[i].w >= remaining ? 0 : remaining - nodes[i].w;
+    }
+    return y;
+}
+
+
+
+// Find a position for a w x h rectangle with the bottom-left heuristic (lowest top edge first,
+// then leftmost), and update the skyline. Return false if the atlas is full.
+static bool
+_skyline_pack(DvzAtlas* atlas, uint32_t w, uint32_t h, uint32_t* out_x, uint32_t* out_y)
+{
+    ANN(atlas);
+    std::vector<DvzSkylineNode>& nodes = atlas->skyline;
+
+    uint32_t best = UINT32_MAX, best_y = UINT32_MAX, y = 0;
+    for (uint32_t i = 0; i < nodes.size(); i++)
+    {
+        y = _skyline_fit(atlas, i, w, h);
+        if (y < best_y)
+        {
+            best = i;
+            best_y = y;
+        }
+    }
+    if (best == UINT32_MAX)
+        return false;
+
+    uint32_t x = nodes[best].x;
+    *out_x = x;
+    *out_y = best_y;
+
+    // Insert the new node and shrink or remove the nodes it covers.
+    nodes.insert(nodes.begin() + best, DvzSkylineNode{x, best_y + h, w});
+    for (uint32_t i = best + 1; i < nodes.size();)
+    {
+        uint32_t end = nodes[i - 1].x + nodes[i - 1].w;
+        if (nodes[i].x >= end)
+            break;
+        uint32_t shrink = end - nodes[i].x;
+        if (shrink < nodes[i].w)
+        {
+            nodes[i].x += shrink;
+            nodes[i].w -= shrink;
+            break;
+        }
+        nodes.erase(nodes.begin() + i);
+    }
+
+    // Merge adjacent nodes at the same height.
+    for (uint32_t i = 0; i + 1 < nodes.size();)
+    {
+        if (nodes[i].y == nodes[i + 1].y)
+        {
+            nodes[i].w += nodes[i + 1].w;
+            nodes.erase(nodes.begin() + i + 1);
+        }
+        else
+            i++;
+    }
+    return true;
+}
+
+
+
+// Double the width or the height of the atlas bitmap, keeping the existing glyphs in place.
+static bool _atlas_grow(DvzAtlas* atlas)
+{
+    ANN(atlas);
+    uint32_t w = atlas->width, h = atlas->height;
+
+    // Grow the smallest dimension, preferring the height as the rows do not move in memory.
+    bool wider = w < h;
+    uint32_t new_w = wider ? 2 * w : w;
+    uint32_t new_h = wider ? h : 2 * h;
+    if (new_w > DYNAMIC_MAX_SIZE || new_h > DYNAMIC_MAX_SIZE)
+    {
+        log_error("unable to grow the dynamic atlas beyond %dx%d", w, h);
+        return false;
+    }
+    log_debug("growing the dynamic atlas from %dx%d to %dx%d", w, h, new_w, new_h);
+
+    uint8_t* rgb = (uint8_t*)calloc(new_w * new_h * 3, sizeof(uint8_t));
+    ANN(rgb);
+    if (atlas->rgb != NULL)
+    {
+        for (uint32_t y = 0; y < h; y++)
+            memcpy(&rgb[3 * y * new_w], &atlas->rgb[3 * y * w], 3 * w);
+        FREE(atlas->rgb);
+    }
+    atlas->rgb = rgb;
+
+    if (wider)
+        atlas->skyline.push_back(DvzSkylineNode{w, 0, new_w - w});
+    atlas->width = new_w;
+    atlas->height = new_h;
+    atlas->grown = true;
+    return true;
+}
+
+
+
+#if HAS_MSDF
+// Generate the MSDF of a glyph and copy it into the atlas bitmap, flipped vertically as in
+// dvz_atlas_generate().
+static void _atlas_render(DvzAtlas* atlas, const GlyphGeometry* glyph, const DvzAtlasRect* rect)
+{
+    ANN(atlas);
+    ANN(glyph);
+    ANN(rect);
+
+    Bitmap<float, 3> bitmap((int)rect->w, (int)rect->h);
+    BitmapRef<float, 3> ref = bitmap;
+    msdfGenerator(ref, *glyph, GeneratorAttributes());
+
+    uint32_t x, y, u, j;
+    for (y = 0; y < rect->h; y++)
+    {
+        for (x = 0; x < rect->w; x++)
+        {
+            const float* pixel = bitmap((int)x, (int)y);
+            j = 3 * ((rect->y + rect->h - 1 - y) * atlas->width + rect->x + x);
+            for (u = 0; u < 3; u++)
+                atlas->rgb[j + u] = pixelFloatToByte(pixel[u]);
+        }
+    }
+}
+#endif
+
+
+
+void dvz_atlas_dynamic(DvzAtlas* atlas)
+{
+    ANN(atlas);
+    if (atlas->dynamic)
+        return;
+    atlas->dynamic = true;
+
+    if (atlas->rgb == NULL)
+    {
+        // Empty atlas.
+        atlas->width = atlas->height = DYNAMIC_SIZE;
+        atlas->rgb = (uint8_t*)calloc(atlas->width * atlas->height * 3, sizeof(uint8_t));
+        ANN(atlas->rgb);
+        atlas->skyline.push_back(DvzSkylineNode{0, 0, atlas->width});
+        return;
+    }
+
+    // Existing atlas (generated or imported): keep its glyphs where they are, and consider the
+    // whole bitmap as occupied so that new glyphs go into the rows added by the first growth.
+#if HAS_MSDF
+    for (const GlyphGeometry& glyph : atlas->glyphs)
+    {
+        uint32_t cp = (uint32_t)glyph.getCodepoint();
+        int x = 0, y = 0, w = 0, h = 0;
+        glyph.getBoxRect(x, y, w, h);
+        atlas->rects[cp] = DvzAtlasRect{
+            (uint32_t)x, (uint32_t)((int)atlas->height - h - y), (uint32_t)w, (uint32_t)h};
+    }
+#endif
+    atlas->skyline.push_back(DvzSkylineNode{0, atlas->height, atlas->width});
+}
+
+
+
+uint32_t dvz_atlas_insert(DvzAtlas* atlas, uint32_t count, uint32_t* codepoints)
+{
+    ANN(atlas);
+    ANN(codepoints);
+    if (!atlas->dynamic)
+    {
+        log_error("glyphs can only be inserted into a dynamic atlas, call dvz_atlas_dynamic()");
+        return 0;
+    }
+
+#if HAS_MSDF
+    // Load the geometry of the missing glyphs, at the same scale as dvz_atlas_generate().
+    std::vector<GlyphGeometry> glyphs;
+    std::vector<uint32_t> seen;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t cp = codepoints[i];
+        if (atlas->rects.count(cp) > 0 || std::find(seen.begin(), seen.end(), cp) != seen.end())
+            continue;
+        seen.push_back(cp);
+
+        GlyphGeometry glyph;
+        if (!glyph.load(atlas->font, 1.0, (unicode_t)cp))
+        {
+            log_warn("code point %d not found in the font", cp);
+            continue;
+        }
+        glyph.edgeColoring(&edgeColoringInkTrap, 3.0, 0);
+        glyph.wrapBox(MINIMUM_SCALE, PIXEL_RANGE / MINIMUM_SCALE, MITER_LIMIT);
+        glyphs.push_back(glyph);
+    }
+    if (glyphs.empty())
+        return 0;
+
+    // Pack the tallest glyphs first, growing the atlas when it is full.
+    std::vector<uint32_t> order(glyphs.size());
+    for (uint32_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&glyphs](uint32_t a, uint32_t b) {
+        int wa = 0, ha = 0, wb = 0, hb = 0;
+        glyphs[a].getBoxSize(wa, ha);
+        glyphs[b].getBoxSize(wb, hb);
+        return ha > hb;
+    });
+
+    std::vector<DvzAtlasRect> rects(glyphs.size());
+    uint32_t x = 0, y = 0;
+    for (uint32_t i : order)
+    {
+        int w = 0, h = 0;
+        glyphs[i].getBoxSize(w, h);
+        rects[i] = DvzAtlasRect{0, 0, (uint32_t)w, (uint32_t)h};
+        if (glyphs[i].isWhitespace() || w == 0 || h == 0)
+            continue;
+
+        while (!_skyline_pack(
+            atlas, rects[i].w + DYNAMIC_SPACING, rects[i].h + DYNAMIC_SPACING, &x, &y))
+        {
+            if (!_atlas_grow(atlas))
+                return 0;
+        }
+        rects[i].x = x;
+        rects[i].y = y;
+    }
+
+    // Generate the new glyphs in parallel, each thread writes into its own rectangles.
+    uint32_t n = (uint32_t)glyphs.size();
+    uint32_t thread_count = MIN(n, DYNAMIC_THREADS);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back([atlas, &glyphs, &rects, n, t, thread_count]() {
+            for (uint32_t i = t; i < n; i += thread_count)
+                if (rects[i].w > 0 && rects[i].h > 0)
+                    _atlas_render(atlas, &glyphs[i], &rects[i]);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        atlas->rects[(uint32_t)glyphs[i].getCodepoint()] = rects[i];
+        _dirty_rect(atlas, rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+    }
+    log_debug("inserted %d glyph(s) into the dynamic atlas", n);
+    return n;
+#else
+    return 0;
+#endif
+}
+
+
+
+int dvz_atlas_upload(DvzAtlas* atlas)
+{
+    ANN(atlas);
+    DvzTexture* texture = atlas->texture;
+    if (texture == NULL)
+    {
+        log_error("the atlas texture must be created with dvz_atlas_texture() before upload");
+        return -1;
+    }
+    ANN(atlas->rgb);
+
+    int resized = 0;
+    uint32_t x0 = atlas->dirty[0], y0 = atlas->dirty[1];
+    uint32_t x1 = atlas->dirty[2], y1 = atlas->dirty[3];
+
+    if (atlas->grown)
+    {
+        // The texture is resized without preserving its contents, upload the whole bitmap.
+        uvec3 shape = {atlas->width, atlas->height, 1};
+        dvz_resize_tex(texture->batch, texture->tex, shape);
+        dvz_texture_shape(texture, atlas->width, atlas->height, 1);
+        x0 = y0 = 0;
+        x1 = atlas->width;
+        y1 = atlas->height;
+        resized = 1;
+    }
+    else if (x1 <= x0 || y1 <= y0)
+    {
+        return 0;
+    }
+
+    // Convert the dirty rectangle to RGBA.
+    uint32_t w = x1 - x0, h = y1 - y0;
+    DvzSize size = w * h * 4;
+    uint8_t* rgba = (uint8_t*)calloc(size, sizeof(uint8_t));
+    ANN(rgba);
+    for (uint32_t y = 0; y < h; y++)
+        dvz_rgb_to_rgba_char(w, &atlas->rgb[3 * ((y0 + y) * atlas->width + x0)], &rgba[4 * y * w]);
+    log_trace("upload rectangle (%d, %d, %d, %d) of the dynamic atlas", x0, y0, w, h);
+    dvz_texture_data(texture, x0, y0, 0, w, h, 1, size, rgba);
+    FREE(rgba);
+
+    atlas->grown = false;
+    memset(atlas->dirty, 0, sizeof(atlas->dirty));
+    return resized;
+}
+
+
+
+bool dvz_atlas_is_dynamic(DvzAtlas* atlas)
+{
+    ANN(atlas);
+    return atlas->dynamic;
 }
 
 
@@ -539,7 +989,7 @@ deserializeDvzAtlas(DvzAtlas& atlas, unsigned long atlas_size, unsigned char* at
     if (atlas.codepoints_count > 0)
     {
         log_trace("reading %d code points", atlas.codepoints_count);
-        atlas.codepoints = new uint32_t[atlas.codepoints_count];
+        atlas.codepoints = (uint32_t*)calloc(atlas.codepoints_count, sizeof(uint32_t));
         for (uint32_t i = 0; i < atlas.codepoints_count; ++i)
         {
             readBytes(&atlas.codepoints[i], sizeof(uint32_t));
@@ -552,6 +1002,11 @@ deserializeDvzAtlas(DvzAtlas& atlas, unsigned long atlas_size, unsigned char* at
     for (uint32_t i = 0; i < glyphs_count; ++i)
     {
         readBytes(&atlas.glyphs[i], sizeof(GlyphGeometry));
+
+        // NOTE: the serialized shape holds pointers of the process that exported the atlas, the
+        // vector is reset in place so that it is never dereferenced nor freed.
+        Shape& shape = const_cast<Shape&>(atlas.glyphs[i].getShape());
+        new (&shape.contours) std::vector<Contour>();
     }
 
     // Deserialize the atlas bitmap dimensions.
@@ -567,7 +1022,7 @@ deserializeDvzAtlas(DvzAtlas& atlas, unsigned long atlas_size, unsigned char* at
         throw std::runtime_error("Buffer overflow detected");
     }
     log_trace("reading %d pixels", bitmap_size);
-    atlas.rgb = new uint8_t[bitmap_size];
+    atlas.rgb = (uint8_t*)malloc(bitmap_size);
     readBytes(atlas.rgb, bitmap_size);
 
     log_debug("done deserialization of font atlas");
@@ -584,6 +1039,124 @@ deserializeDvzAtlas(DvzAtlas& atlas, unsigned long atlas_size, unsigned char* at
 
 #endif
 
+
+
+/*************************************************************************************************/
+/*  Atlas cache                                                                                  */
+/*************************************************************************************************/
+
+#if HAS_MSDF
+static void _atlas_cache_path(DvzAtlas* atlas, char* path, size_t size)
+{
+    ANN(atlas);
+    ANN(path);
+    path[0] = 0;
+    if (atlas->ttf_bytes == NULL || atlas->ttf_size == 0)
+        return;
+
+    // NOTE: the glyphs are serialized as raw bytes, so the struct size is part of the key.
+    uint32_t version = ATLAS_CACHE_VERSION;
+    uint32_t glyph_size = (uint32_t)sizeof(GlyphGeometry);
+    double params[3] = {MINIMUM_SCALE, PIXEL_RANGE, MITER_LIMIT};
+
+    uint64_t h = DVZ_HASH_SEED;
+    h = dvz_hash(h, sizeof(version), &version);
+    h = dvz_hash(h, sizeof(glyph_size), &glyph_size);
+    h = dvz_hash(h, sizeof(params), params);
+    h = dvz_hash(h, atlas->ttf_size, atlas->ttf_bytes);
+    h = dvz_hash(h, sizeof(atlas->codepoints_count), &atlas->codepoints_count);
+    if (atlas->codepoints_count > 0)
+        h = dvz_hash(h, atlas->codepoints_count * sizeof(uint32_t), atlas->codepoints);
+
+    char name[64] = {0};
+    snprintf(name, sizeof(name), "atlas_%016" PRIx64 ".bin", h);
+    if (dvz_cache_path(name, path, size) != 0)
+        path[0] = 0;
+}
+
+
+
+// Load a cached atlas, return 0 on success.
+static int _atlas_cache_load(DvzAtlas* atlas, const char* path)
+{
+    ANN(atlas);
+    ANN(path);
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return 1;
+    fclose(f);
+
+    DvzSize size = 0;
+    void* ptr = dvz_mmap_file(path, &size);
+    if (ptr == NULL)
+        return 1;
+
+    // The cached atlas replaces the specified charset, which is identical.
+    uint32_t* codepoints = atlas->codepoints;
+    uint32_t codepoints_count = atlas->codepoints_count;
+    int res = 0;
+    try
+    {
+        deserializeDvzAtlas(*atlas, (unsigned long)size, (unsigned char*)ptr);
+    }
+    catch (const std::exception& e)
+    {
+        log_debug("discarding invalid cached font atlas %s (%s)", path, e.what());
+        res = 1;
+    }
+    dvz_munmap_file(ptr, size);
+
+    if (res != 0 || atlas->codepoints_count != codepoints_count)
+    {
+        if (atlas->codepoints != codepoints)
+            FREE(atlas->codepoints);
+        if (atlas->rgb != NULL)
+            FREE(atlas->rgb);
+        atlas->glyphs.clear();
+        atlas->codepoints = codepoints;
+        atlas->codepoints_count = codepoints_count;
+        atlas->width = atlas->height = 0;
+        return 1;
+    }
+    if (atlas->codepoints != codepoints)
+        FREE(codepoints);
+    log_trace("loaded cached font atlas %s", path);
+    return 0;
+}
+
+
+
+static void _atlas_cache_save(DvzAtlas* atlas, const char* path)
+{
+    ANN(atlas);
+    ANN(path);
+
+    // Atomic rename so that a concurrent process never reads a partially-written file.
+    char tmp[1040] = {0};
+    snprintf(tmp, sizeof(tmp), "%s.%" PRIx64 ".tmp", path, (uint64_t)(uintptr_t)atlas);
+    try
+    {
+        serializeDvzAtlas(*atlas, tmp);
+    }
+    catch (const std::exception& e)
+    {
+        log_warn("unable to save the font atlas to the cache (%s)", e.what());
+        remove(tmp);
+        return;
+    }
+    if (rename(tmp, path) != 0)
+    {
+        log_warn("unable to save the font atlas to the cache");
+        remove(tmp);
+        return;
+    }
+    log_trace("saved font atlas to the cache in %s", path);
+}
+#endif
+
+
+
 void dvz_atlas_export(const char* font_name, const char* output_file, DvzAtlasFont* af)
 {
     ANN(font_name);
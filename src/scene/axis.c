@@ -19,9 +19,11 @@
 #include "_macros.h"
 #include "datoviz.h"
 #include "datoviz_types.h"
+#include "scene/atlas.h"
 #include "scene/ref.h"
 #include "scene/ticks.h"
 #include "scene/visual.h"
+#include "scene/visuals/glyph.h"
 
 
 
@@ -381,6 +383,278 @@ static void spine_position(DvzVisual* spine, DvzDim dim, float pos)
 
 
 
+/*************************************************************************************************/
+/*  Tick label glyphs                                                                            */
+/*************************************************************************************************/
+
+// Shape of the atlas of the tick label glyph visual.
+static void _atlas_shape(DvzAxis* axis, uvec2 shape)
+{
+    ANN(axis);
+    ANN(axis->glyph);
+    DvzAtlasFont* af = (DvzAtlasFont*)axis->glyph->user_data;
+    ANN(af);
+    ANN(af->atlas);
+
+    uvec3 shape3 = {0};
+    dvz_atlas_shape(af->atlas, shape3);
+    shape[0] = shape3[0];
+    shape[1] = shape3[1];
+}
+
+
+
+// Return the layout of a tick label, from the LRU cache or computed and put in the cache.
+// NOTE: the cache is keyed on the label text and the atlas shape, as the normalized texture
+// coordinates change when a dynamic atlas grows.
+static DvzAxisLabel* _label_layout(DvzAxis* axis, const char* text)
+{
+    ANN(axis);
+    ANN(text);
+    DvzAxisGlyphs* g = &axis->tick_glyphs;
+    g->clock++;
+
+    uvec2 shape = {0};
+    _atlas_shape(axis, shape);
+
+    // A label laid out with another atlas shape is stale, its entry is recomputed in place.
+    DvzAxisLabel* label = NULL;
+    for (uint32_t i = 0; i < g->label_count; i++)
+    {
+        if (strcmp(g->labels[i].text, text) != 0)
+            continue;
+        if (g->labels[i].atlas_shape[0] == shape[0] && g->labels[i].atlas_shape[1] == shape[1])
+        {
+            g->labels[i].last_used = g->clock;
+            g->hits++;
+            return &g->labels[i];
+        }
+        label = &g->labels[i];
+        FREE(label->xywh);
+        FREE(label->texcoords);
+        break;
+    }
+    g->misses++;
+
+    // Take a new entry, or evict the least recently used one.
+    if (label == NULL && g->label_count < DVZ_AXIS_LABEL_CACHE)
+    {
+        label = &g->labels[g->label_count++];
+    }
+    else if (label == NULL)
+    {
+        label = &g->labels[0];
+        for (uint32_t i = 1; i < g->label_count; i++)
+            if (g->labels[i].last_used < label->last_used)
+                label = &g->labels[i];
+        FREE(label->xywh);
+        FREE(label->texcoords);
+    }
+
+    uint32_t n = strnlen(text, DVZ_AXIS_LABEL_SIZE);
+    ASSERT(n < DVZ_AXIS_LABEL_SIZE);
+    memcpy(label->text, text, n + 1);
+    label->glyph_count = n;
+    label->last_used = g->clock;
+    label->xywh = (vec4*)calloc(MAX(n, 1), sizeof(vec4));
+    label->texcoords = (vec4*)calloc(MAX(n, 1), sizeof(vec4));
+    if (n > 0)
+        dvz_glyph_layout(axis->glyph, text, label->xywh, label->texcoords);
+
+    // NOTE: the layout may have grown a dynamic atlas, in which case the other cached labels
+    // become stale.
+    _atlas_shape(axis, label->atlas_shape);
+    return label;
+}
+
+
+
+// Write a tick label into a slot of the glyph visual, or hide the slot if text is NULL.
+static void _slot_write(DvzAxis* axis, DvzAxisSlot* slot, const char* text, vec3 pos)
+{
+    ANN(axis);
+    ANN(slot);
+    ASSERT(slot->capacity > 0);
+
+    if (text == NULL)
+    {
+        slot->text[0] = 0;
+        dvz_glyph_range(
+            axis->glyph, slot->first, slot->capacity, 0, NULL, NULL, pos, FOREGROUND,
+            axis->spec.offset, axis->spec.anchor);
+        return;
+    }
+
+    DvzAxisLabel* label = _label_layout(axis, text);
+    ANN(label);
+    ASSERT(label->glyph_count <= slot->capacity);
+    memcpy(slot->text, label->text, sizeof(slot->text));
+    glm_vec3_copy(pos, slot->pos);
+    dvz_glyph_range(
+        axis->glyph, slot->first, slot->capacity, label->glyph_count, label->xywh,
+        label->texcoords, pos, FOREGROUND, axis->spec.offset, axis->spec.anchor);
+    axis->tick_glyphs.written++;
+}
+
+
+
+static void _glyphs_reset(DvzAxis* axis)
+{
+    ANN(axis);
+    DvzAxisGlyphs* g = &axis->tick_glyphs;
+    FREE(g->slots);
+    g->slot_count = 0;
+    g->glyph_count = 0;
+}
+
+
+
+// Update the tick label glyph visual: the labels that persist across tick changes keep their
+// glyphs, so that only the glyphs of the new labels are uploaded.
+static void _glyphs_update(DvzAxis* axis, uint32_t tick_count, char** labels, vec3* positions)
+{
+    ANN(axis);
+    ANN(labels);
+    ANN(positions);
+    DvzAxisGlyphs* g = &axis->tick_glyphs;
+
+    // Labels that are too long for the cache: lay out all labels from scratch.
+    for (uint32_t i = 0; i < tick_count; i++)
+    {
+        if (strnlen(labels[i], DVZ_AXIS_LABEL_SIZE) >= DVZ_AXIS_LABEL_SIZE)
+        {
+            _glyphs_reset(axis);
+            dvz_axis_glyph(axis, tick_count, labels, positions);
+            return;
+        }
+    }
+
+    // The slots were written with another offset or anchor: rewrite everything.
+    bool rewrite = false;
+    if (!glm_vec2_eqv(g->offset, axis->spec.offset) || !glm_vec2_eqv(g->anchor, axis->spec.anchor))
+    {
+        g->slot_count = 0;
+        rewrite = true;
+        glm_vec2_copy(axis->spec.offset, g->offset);
+        glm_vec2_copy(axis->spec.anchor, g->anchor);
+    }
+
+    // Keep the slots holding a label at the same position.
+    for (uint32_t j = 0; j < g->slot_count; j++)
+        g->slots[j].used = false;
+    uint32_t* assigned = (uint32_t*)calloc(tick_count, sizeof(uint32_t)); // slot index + 1
+    for (uint32_t i = 0; i < tick_count; i++)
+    {
+        for (uint32_t j = 0; j < g->slot_count; j++)
+        {
+            DvzAxisSlot* slot = &g->slots[j];
+            if (!slot->used && slot->text[0] != 0 && strcmp(slot->text, labels[i]) == 0 &&
+                glm_vec3_eqv(slot->pos, positions[i]))
+            {
+                slot->used = true;
+                assigned[i] = j + 1;
+                g->reused++;
+                break;
+            }
+        }
+    }
+
+    // Put the new labels into free slots that are large enough, or into new slots.
+    uint32_t end = g->slot_count > 0 ? g->slots[g->slot_count - 1].first +
+                                           g->slots[g->slot_count - 1].capacity
+                                     : 0;
+    for (uint32_t i = 0; i < tick_count; i++)
+    {
+        if (assigned[i] != 0)
+            continue;
+        uint32_t n = strlen(labels[i]);
+        for (uint32_t j = 0; j < g->slot_count; j++)
+        {
+            if (!g->slots[j].used && g->slots[j].capacity >= n)
+            {
+                g->slots[j].used = true;
+                assigned[i] = j + 1;
+                break;
+            }
+        }
+        if (assigned[i] != 0)
+            continue;
+
+        REALLOC(g->slots, (g->slot_count + 1) * sizeof(DvzAxisSlot));
+        DvzAxisSlot* slot = &g->slots[g->slot_count++];
+        memset(slot, 0, sizeof(DvzAxisSlot));
+        slot->first = end;
+        slot->capacity = MAX(n, 1);
+        slot->used = true;
+        end += slot->capacity;
+        assigned[i] = g->slot_count;
+    }
+
+    // Grow the visual if needed. The GPU buffer is resized without preserving its contents, so
+    // all slots are rewritten.
+    if (end > g->glyph_count)
+    {
+        g->glyph_count = MAX(end, MAX(2 * g->glyph_count, 64));
+        dvz_glyph_alloc(axis->glyph, g->glyph_count);
+        rewrite = true;
+    }
+
+    // Write the new labels, and the kept ones if everything must be rewritten.
+    for (uint32_t i = 0; i < tick_count; i++)
+    {
+        DvzAxisSlot* slot = &g->slots[assigned[i] - 1];
+        bool kept = slot->text[0] != 0 && strcmp(slot->text, labels[i]) == 0 &&
+                    glm_vec3_eqv(slot->pos, positions[i]);
+        if (!kept || rewrite)
+            _slot_write(axis, slot, labels[i], positions[i]);
+    }
+
+    // Hide the slots that are not used anymore, and the glyphs after the last slot.
+    for (uint32_t j = 0; j < g->slot_count; j++)
+    {
+        if (!g->slots[j].used && (g->slots[j].text[0] != 0 || rewrite))
+            _slot_write(axis, &g->slots[j], NULL, g->slots[j].pos);
+    }
+    if (rewrite && end < g->glyph_count)
+    {
+        DvzAxisSlot tail = {.first = end, .capacity = g->glyph_count - end};
+        _slot_write(axis, &tail, NULL, (vec3){0});
+    }
+
+    // Set the groups as in dvz_axis_glyph(): one group per slot, and one for the hidden glyphs
+    // after the last slot.
+    uint32_t group_count = g->slot_count + (end < g->glyph_count ? 1 : 0);
+    if (group_count > 0)
+    {
+        uint32_t* group_sizes = (uint32_t*)calloc(group_count, sizeof(uint32_t));
+        for (uint32_t j = 0; j < g->slot_count; j++)
+            group_sizes[j] = g->slots[j].capacity;
+        if (end < g->glyph_count)
+            group_sizes[g->slot_count] = g->glyph_count - end;
+        dvz_visual_groups(axis->glyph, group_count, group_sizes);
+        FREE(group_sizes);
+    }
+
+    FREE(assigned);
+}
+
+
+
+static void _glyphs_destroy(DvzAxis* axis)
+{
+    ANN(axis);
+    DvzAxisGlyphs* g = &axis->tick_glyphs;
+    for (uint32_t i = 0; i < g->label_count; i++)
+    {
+        FREE(g->labels[i].xywh);
+        FREE(g->labels[i].texcoords);
+    }
+    g->label_count = 0;
+    _glyphs_reset(axis);
+}
+
+
+
 /*************************************************************************************************/
 /*  Axis                                                                                         */
 /*************************************************************************************************/
@@ -620,8 +894,8 @@ bool dvz_axis_update(DvzAxis* axis, DvzRef* ref, double dmin, double dmax)
         positions[i][fixed_dim] = axis->spec.pos;
     }
 
-    // Now update the glyph visual.
-    dvz_axis_glyph(axis, tick_count, labels, positions);
+    // Now update the glyph visual, reusing the glyphs of the labels that have not changed.
+    _glyphs_update(axis, tick_count, labels, positions);
 
     // Update the segment visual.
     dvz_axis_segment(axis, tick_count, positions);
@@ -739,6 +1013,7 @@ void dvz_axis_panel(DvzAxis* axis, DvzPanel* panel)
 void dvz_axis_destroy(DvzAxis* axis)
 {
     ANN(axis);
+    _glyphs_destroy(axis);
     FREE(axis);
 }
 
@@ -68,6 +68,9 @@ static void _create_vertex_binding(DvzBaker* baker, uint32_t binding_idx, uint32
     int dual_flags = ((baker->flags & DVZ_BAKER_FLAGS_VERTEX_MAPPABLE) == 0)
                          ? DVZ_DAT_FLAGS_PERSISTENT_STAGING
                          : DVZ_DAT_FLAGS_MAPPABLE;
+    // NOTE: keep the data on the GPU when the visual is resized, so that only the new or
+    // modified items need to be uploaded.
+    dual_flags |= DVZ_DAT_FLAGS_KEEP_ON_RESIZE;
     bv->dual = dvz_dual_vertex(baker->batch, vertex_count, bv->stride, dual_flags);
     // NOTE; mark the dual as needing to be destroyed by the library
     bv->dual.need_destroy = true;
@@ -89,6 +92,7 @@ static void _create_index(DvzBaker* baker, uint32_t index_count)
     int dual_flags = ((baker->flags & DVZ_BAKER_FLAGS_INDEX_MAPPABLE) == 0)
                          ? DVZ_DAT_FLAGS_PERSISTENT_STAGING
                          : DVZ_DAT_FLAGS_MAPPABLE;
+    dual_flags |= DVZ_DAT_FLAGS_KEEP_ON_RESIZE;
     baker->index = dvz_dual_index(baker->batch, index_count, dual_flags);
     // NOTE; mark the dual as needing to be destroyed by the library
     baker->index.need_destroy = true;
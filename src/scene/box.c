@@ -18,6 +18,7 @@
 #include "datoviz_math.h"
 
 #include "scene/box.h"
+#include "scene/mvp.h"
 
 
 
@@ -302,6 +303,72 @@ void dvz_box_inverse(DvzBox source, DvzBox target, vec3 pos, dvec3* out)
 
 
 
+// NOTE: same margins transform as in transform_margins() in common.glsl.
+bool dvz_box_visible(DvzBox box, DvzMVP* mvp, DvzViewport* viewport, float margin)
+{
+    ANN(mvp);
+    ANN(viewport);
+
+    // An empty box has no visible part.
+    if (!(box.xmin <= box.xmax && box.ymin <= box.ymax && box.zmin <= box.zmax))
+        return false;
+
+    // Margins of the viewport, and margin around the box in NDC.
+    float w = viewport->size_framebuffer[0];
+    float h = viewport->size_framebuffer[1];
+    float mt = viewport->margins[0];
+    float mr = viewport->margins[1];
+    float mb = viewport->margins[2];
+    float ml = viewport->margins[3];
+    float ax = 1, bx = 0, rx = 0;
+    float ay = 1, by = 0, ry = 0;
+    if (w > 0)
+    {
+        ax = 1 - (ml + mr) / w;
+        bx = (ml - mr) / w;
+        rx = 2 * margin / w;
+    }
+    if (h > 0)
+    {
+        ay = 1 - (mb + mt) / h;
+        by = (mb - mt) / h;
+        ry = 2 * margin / h;
+    }
+
+    // Number of corners outside of each clipping plane: left, right, bottom, top, near, far.
+    // NOTE: each plane is a half-space in homogeneous coordinates, so that the test remains
+    // correct for the corners behind the camera.
+    uint32_t outside[6] = {0};
+    vec4 corner = {0}, tr = {0};
+    float x = 0, y = 0;
+    for (uint32_t k = 0; k < 8; k++)
+    {
+        corner[0] = (float)((k & 1) ? box.xmax : box.xmin);
+        corner[1] = (float)((k & 2) ? box.ymax : box.ymin);
+        corner[2] = (float)((k & 4) ? box.zmax : box.zmin);
+        corner[3] = 1;
+        dvz_mvp_apply(mvp, corner, tr);
+
+        x = ax * tr[0] + bx;
+        y = ay * tr[1] + by;
+        outside[0] += x < -(1 + rx) * tr[3];
+        outside[1] += x > +(1 + rx) * tr[3];
+        outside[2] += y < -(1 + ry) * tr[3];
+        outside[3] += y > +(1 + ry) * tr[3];
+        outside[4] += tr[2] < -tr[3];
+        outside[5] += tr[2] > +tr[3];
+    }
+
+    for (uint32_t p = 0; p < 6; p++)
+    {
+        if (outside[p] == 8)
+            return false;
+    }
+    return true;
+}
+
+
+
 void dvz_box_print(DvzBox box)
 {
     printf(
@@ -0,0 +1,706 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Bricks                                                                                       */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/bricks.h"
+#include "../resources_utils.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "fileio.h"
+#include "scene/pool.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+// Size of a brick in the pool, including the apron.
+static inline uint32_t _padded_size(DvzBricks* bricks)
+{
+    ANN(bricks);
+    return bricks->brick_size + 2 * DVZ_BRICKS_APRON;
+}
+
+
+
+static inline uint32_t _grid_count(uvec3 grid) { return grid[0] * grid[1] * grid[2]; }
+
+
+
+// Clamp a voxel coordinate to a region, and return it relative to the region.
+static inline uint32_t _voxel_clip(int64_t v, uint32_t offset, uint32_t shape)
+{
+    return (uint32_t)(CLIP(v, (int64_t)offset, (int64_t)offset + shape - 1) - offset);
+}
+
+
+
+static void _brick_decode(DvzBricks* bricks, uint32_t brick, uint32_t* level, uvec3 ijk)
+{
+    ANN(bricks);
+    ASSERT(brick < bricks->brick_count);
+
+    uint32_t l = bricks->level_count - 1;
+    while (l > 0 && brick < bricks->offsets[l])
+        l--;
+
+    uint32_t idx = brick - bricks->offsets[l];
+    uint32_t* g = bricks->grids[l];
+    ijk[0] = idx % g[0];
+    ijk[1] = (idx / g[0]) % g[1];
+    ijk[2] = idx / (g[0] * g[1]);
+    *level = l;
+}
+
+
+
+// Distance between the eye and a brick, in normalized volume coordinates.
+static float _brick_distance(DvzBricks* bricks, uint32_t level, uvec3 ijk, vec3 eye)
+{
+    ANN(bricks);
+    float size = (float)((uint64_t)bricks->brick_size << level);
+    float d2 = 0, lo = 0, hi = 0, e = 0;
+    for (uint32_t c = 0; c < 3; c++)
+    {
+        lo = ijk[c] * size / bricks->shape[c];
+        hi = MIN((ijk[c] + 1) * size / bricks->shape[c], 1);
+        e = MAX(MAX(lo - eye[c], eye[c] - hi), 0);
+        d2 += e * e;
+    }
+    return sqrtf(d2);
+}
+
+
+
+// Largest extent of a brick at a given level, in normalized volume coordinates.
+static float _brick_extent(DvzBricks* bricks, uint32_t level)
+{
+    ANN(bricks);
+    float size = (float)((uint64_t)bricks->brick_size << level);
+    float extent = 0;
+    for (uint32_t c = 0; c < 3; c++)
+        extent = MAX(extent, size / bricks->shape[c]);
+    return MIN(extent, 1);
+}
+
+
+
+// Indices of the (up to 8) bricks at level-1 covering a brick.
+static uint32_t _brick_children(DvzBricks* bricks, uint32_t level, uvec3 ijk, uint32_t* out)
+{
+    ANN(bricks);
+    ANN(out);
+    ASSERT(level > 0);
+
+    uint32_t* g = bricks->grids[level - 1];
+    uint32_t n = 0;
+    uvec3 c = {0};
+    for (uint32_t dz = 0; dz < 2; dz++)
+    {
+        c[2] = 2 * ijk[2] + dz;
+        for (uint32_t dy = 0; dy < 2; dy++)
+        {
+            c[1] = 2 * ijk[1] + dy;
+            for (uint32_t dx = 0; dx < 2; dx++)
+            {
+                c[0] = 2 * ijk[0] + dx;
+                if (c[0] < g[0] && c[1] < g[1] && c[2] < g[2])
+                    out[n++] = dvz_bricks_index(bricks, level - 1, c);
+            }
+        }
+    }
+    return n;
+}
+
+
+
+// Read a region of the memory-mapped volume at a given level, by subsampling the
+// full-resolution volume.
+static void _read_mmap(DvzBricks* bricks, uint32_t level, uvec3 offset, uvec3 shape, uint8_t* out)
+{
+    ANN(bricks);
+    ANN(bricks->mmap);
+    ANN(out);
+
+    const uint8_t* src = (const uint8_t*)bricks->mmap + bricks->mmap_offset;
+    DvzSize item_size = bricks->item_size;
+    DvzSize w = bricks->shape[0];
+    DvzSize h = bricks->shape[1];
+    uint32_t f = 1u << level;
+
+    DvzSize x = 0, y = 0, z = 0;
+    for (uint32_t k = 0; k < shape[2]; k++)
+    {
+        z = MIN((DvzSize)(offset[2] + k) * f, bricks->shape[2] - 1);
+        for (uint32_t j = 0; j < shape[1]; j++)
+        {
+            y = MIN((DvzSize)(offset[1] + j) * f, h - 1);
+            if (f == 1)
+            {
+                memcpy(out, &src[((z * h + y) * w + offset[0]) * item_size], shape[0] * item_size);
+                out += shape[0] * item_size;
+                continue;
+            }
+            for (uint32_t i = 0; i < shape[0]; i++)
+            {
+                x = MIN((DvzSize)(offset[0] + i) * f, w - 1);
+                memcpy(out, &src[((z * h + y) * w + x) * item_size], item_size);
+                out += item_size;
+            }
+        }
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Brick pool                                                                                   */
+/*************************************************************************************************/
+
+static void _slot_upload(void* owner, uint32_t slot, uint8_t* data)
+{
+    DvzBricks* bricks = (DvzBricks*)owner;
+    ANN(bricks);
+    ANN(data);
+
+    uint32_t p = _padded_size(bricks);
+    uint32_t* pool = bricks->pool;
+    uvec3 offset = {
+        (slot % pool[0]) * p,
+        ((slot / pool[0]) % pool[1]) * p,
+        (slot / (pool[0] * pool[1])) * p,
+    };
+    uvec3 shape = {p, p, p};
+    DvzSize size = (DvzSize)p * p * p * bricks->item_size;
+    dvz_upload_tex(bricks->batch, bricks->atlas_tex, offset, shape, size, data, 0);
+}
+
+
+
+// Mark a brick as needed at the current frame. If it is not resident, the finest resident
+// brick covering it is kept instead, so that it can be displayed until the brick is loaded.
+static void _brick_touch(DvzBricks* bricks, uint32_t brick)
+{
+    ANN(bricks);
+
+    uint32_t level = 0;
+    uvec3 ijk = {0};
+    _brick_decode(bricks, brick, &level, ijk);
+
+    while (!dvz_pool_touch(bricks->cache, brick))
+    {
+        if (level + 1 >= bricks->level_count)
+            return;
+        level++;
+        ijk[0] /= 2;
+        ijk[1] /= 2;
+        ijk[2] /= 2;
+        brick = dvz_bricks_index(bricks, level, ijk);
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Brick loader                                                                                 */
+/*************************************************************************************************/
+
+// Called by the loader thread of the pool.
+static bool _brick_load(void* owner, uint32_t brick, uint8_t* data)
+{
+    DvzBricks* bricks = (DvzBricks*)owner;
+    ANN(bricks);
+
+    uint32_t level = 0;
+    uvec3 ijk = {0};
+    _brick_decode(bricks, brick, &level, ijk);
+    return dvz_bricks_fetch(bricks, level, ijk, data);
+}
+
+
+
+/*************************************************************************************************/
+/*  Level of detail                                                                              */
+/*************************************************************************************************/
+
+// Select the bricks to display: starting from the root brick, the bricks close to the eye are
+// replaced by their children, nearest first, as long as there is room in the pool. The budget
+// is half the pool so that the coarser bricks displayed while loading always fit too.
+static void _bricks_select(DvzBricks* bricks, vec3 eye, float detail)
+{
+    ANN(bricks);
+
+    uint32_t budget = MAX(1, (bricks->capacity - 1) / 2);
+    uint32_t n = budget + 8;
+    uint32_t* sel = bricks->selection;
+    uint32_t* next = (uint32_t*)calloc(n, sizeof(uint32_t));
+    bool* refine = (bool*)calloc(n, sizeof(bool));
+    DvzPoolCandidate* candidates = (DvzPoolCandidate*)calloc(n, sizeof(DvzPoolCandidate));
+
+    uint32_t top = bricks->level_count - 1;
+    uint32_t count = 1;
+    sel[0] = dvz_bricks_index(bricks, top, (uvec3){0, 0, 0});
+
+    uint32_t children[8] = {0};
+    uint32_t level = 0, total = 0, m = 0, nc = 0;
+    uvec3 ijk = {0};
+    float distance = 0;
+    for (uint32_t l = top; l > 0; l--)
+    {
+        // Bricks of the current level close enough to the eye.
+        nc = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            _brick_decode(bricks, sel[i], &level, ijk);
+            if (level != l)
+                continue;
+            distance = _brick_distance(bricks, level, ijk, eye);
+            // NOTE: the candidates refer to the index of the brick in the selection.
+            if (distance < detail * _brick_extent(bricks, level))
+                candidates[nc++] = (DvzPoolCandidate){distance, i};
+        }
+        if (nc == 0)
+            break;
+        dvz_pool_sort(nc, candidates);
+
+        // Refine the nearest bricks first, within the budget.
+        memset(refine, 0, n * sizeof(bool));
+        total = count;
+        for (uint32_t c = 0; c < nc; c++)
+        {
+            _brick_decode(bricks, sel[candidates[c].item], &level, ijk);
+            m = _brick_children(bricks, level, ijk, children);
+            if (total + m - 1 > budget)
+                break;
+            total += m - 1;
+            refine[candidates[c].item] = true;
+        }
+
+        m = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (!refine[i])
+            {
+                next[m++] = sel[i];
+                continue;
+            }
+            _brick_decode(bricks, sel[i], &level, ijk);
+            m += _brick_children(bricks, level, ijk, &next[m]);
+        }
+        ASSERT(m == total);
+        memcpy(sel, next, m * sizeof(uint32_t));
+        count = m;
+    }
+    bricks->selection_count = count;
+
+    FREE(next);
+    FREE(refine);
+    FREE(candidates);
+}
+
+
+
+// Request the selected bricks that are not loaded yet, nearest first.
+static void _bricks_request(DvzBricks* bricks, vec3 eye)
+{
+    ANN(bricks);
+
+    uint32_t count = bricks->selection_count;
+    DvzPoolCandidate* candidates = (DvzPoolCandidate*)calloc(count, sizeof(DvzPoolCandidate));
+    uint8_t* states = bricks->cache->states;
+
+    uint32_t level = 0, nc = 0, brick = 0;
+    uvec3 ijk = {0};
+    for (uint32_t i = 0; i < count; i++)
+    {
+        brick = bricks->selection[i];
+
+        // Always load the coarser bricks first, so that something is displayed everywhere.
+        _brick_decode(bricks, brick, &level, ijk);
+        while (level + 1 < bricks->level_count)
+        {
+            uvec3 parent = {ijk[0] / 2, ijk[1] / 2, ijk[2] / 2};
+            uint32_t pbrick = dvz_bricks_index(bricks, level + 1, parent);
+            if (states[pbrick] != DVZ_POOL_STATE_UNLOADED)
+                break;
+            brick = pbrick;
+            level++;
+            memcpy(ijk, parent, sizeof(uvec3));
+        }
+
+        if (states[brick] != DVZ_POOL_STATE_UNLOADED)
+            continue;
+
+        // NOTE: distances are below 2 in normalized coordinates, so that the bricks are sorted
+        // by decreasing level first, and by increasing distance within a level.
+        candidates[nc++] = (DvzPoolCandidate){
+            _brick_distance(bricks, level, ijk, eye) - 2.0 * level, brick};
+    }
+    dvz_pool_request(bricks->cache, nc, candidates);
+
+    FREE(candidates);
+}
+
+
+
+// Rebuild the indirection table, from the coarsest level to level 0: each brick points to
+// itself if it is resident, or to the brick its parent points to otherwise.
+static void _bricks_indirection(DvzBricks* bricks)
+{
+    ANN(bricks);
+    ANN(bricks->indirection);
+    DvzPool* cache = bricks->cache;
+    ANN(cache);
+
+    uint32_t n0 = _grid_count(bricks->grids[0]);
+    float* cur = (float*)calloc(n0, sizeof(float));
+    float* parent = (float*)calloc(n0, sizeof(float));
+    float* tmp = NULL;
+
+    uint32_t top = bricks->level_count - 1;
+    uint32_t brick = 0;
+    uint32_t *g = NULL, *gp = NULL;
+    float v = 0;
+    for (int32_t level = (int32_t)top; level >= 0; level--)
+    {
+        g = bricks->grids[level];
+        gp = bricks->grids[MIN((uint32_t)level + 1, top)];
+        for (uint32_t k = 0; k < g[2]; k++)
+        {
+            for (uint32_t j = 0; j < g[1]; j++)
+            {
+                for (uint32_t i = 0; i < g[0]; i++)
+                {
+                    brick = dvz_bricks_index(bricks, (uint32_t)level, (uvec3){i, j, k});
+                    switch (cache->states[brick])
+                    {
+                    case DVZ_POOL_STATE_RESIDENT:
+                        // NOTE: the slot and the level are packed in a float, exact up to 2^24.
+                        v = (float)(cache->slots[brick] * DVZ_BRICKS_MAX_LEVELS + level);
+                        break;
+                    case DVZ_POOL_STATE_EMPTY:
+                        v = -1;
+                        break;
+                    default:
+                        v = (uint32_t)level == top
+                                ? -1
+                                : parent[((k / 2) * gp[1] + (j / 2)) * gp[0] + (i / 2)];
+                        break;
+                    }
+                    cur[(k * g[1] + j) * g[0] + i] = v;
+                }
+            }
+        }
+        tmp = parent;
+        parent = cur;
+        cur = tmp;
+    }
+
+    memcpy(bricks->indirection, parent, n0 * sizeof(float));
+    FREE(cur);
+    FREE(parent);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzBricks* dvz_bricks(
+    DvzBatch* batch, DvzFormat format, uvec3 shape, uint32_t brick_size, uint32_t capacity,
+    int flags)
+{
+    ANN(batch);
+    ASSERT(shape[0] > 0);
+    ASSERT(shape[1] > 0);
+    ASSERT(shape[2] > 0);
+    ASSERT(capacity > 0);
+
+    DvzBricks* bricks = (DvzBricks*)calloc(1, sizeof(DvzBricks));
+    bricks->batch = batch;
+    bricks->format = format;
+    bricks->item_size = _format_size(format);
+    ASSERT(bricks->item_size > 0);
+    memcpy(bricks->shape, shape, sizeof(uvec3));
+    bricks->brick_size = brick_size > 0 ? brick_size : DVZ_BRICKS_DEFAULT_SIZE;
+    bricks->flags = flags;
+
+    // Levels of detail, until the whole volume fits in a single brick.
+    uint32_t b = bricks->brick_size;
+    uint32_t level = 0;
+    uint32_t* g = NULL;
+    while (true)
+    {
+        ASSERT(level < DVZ_BRICKS_MAX_LEVELS);
+        g = bricks->grids[level];
+        for (uint32_t c = 0; c < 3; c++)
+            g[c] = (dvz_pool_level_size(shape[c], level) + b - 1) / b;
+        bricks->offsets[level] = bricks->brick_count;
+        bricks->brick_count += _grid_count(g);
+        if (_grid_count(g) == 1)
+            break;
+        level++;
+    }
+    bricks->level_count = level + 1;
+
+    // Brick pool, as close as possible to a cube.
+    uint32_t p = (uint32_t)ceil(cbrt((double)capacity));
+    bricks->pool[0] = p;
+    bricks->pool[1] = p;
+    bricks->pool[2] = (capacity + p * p - 1) / (p * p);
+    ASSERT(p * _padded_size(bricks) <= DVZ_BRICKS_MAX_POOL);
+    ASSERT((uint64_t)capacity * DVZ_BRICKS_MAX_LEVELS < (1 << 24));
+    bricks->capacity = capacity;
+
+    // Brick slots in the pool, and loader thread.
+    uint32_t pad = _padded_size(bricks);
+    bricks->cache = dvz_pool(bricks->brick_count, capacity, DVZ_BRICKS_MAX_PENDING);
+    dvz_pool_loader(
+        bricks->cache, (DvzSize)pad * pad * pad * bricks->item_size, _brick_load, _slot_upload,
+        bricks);
+
+    bricks->selection = (uint32_t*)calloc(capacity + 8, sizeof(uint32_t));
+
+    uint32_t n0 = _grid_count(bricks->grids[0]);
+    bricks->indirection = (float*)calloc(n0, sizeof(float));
+    for (uint32_t i = 0; i < n0; i++)
+        bricks->indirection[i] = -1;
+
+    log_debug(
+        "create bricked volume %dx%dx%d with %d levels, %d bricks, pool of %d bricks of %d^3",
+        shape[0], shape[1], shape[2], bricks->level_count, bricks->brick_count, capacity, b);
+
+    dvz_obj_init(&bricks->obj);
+    return bricks;
+}
+
+
+
+void dvz_bricks_callback(DvzBricks* bricks, DvzBricksCallback callback, void* user_data)
+{
+    ANN(bricks);
+    ANN(callback);
+    // NOTE: the loader thread reads these fields without locking.
+    ASSERT(bricks->cache->thread == NULL);
+
+    bricks->callback = callback;
+    bricks->user_data = user_data;
+}
+
+
+
+void dvz_bricks_file(DvzBricks* bricks, const char* filename, DvzSize offset)
+{
+    ANN(bricks);
+    ANN(filename);
+    ASSERT(bricks->cache->thread == NULL);
+
+    DvzSize size = 0;
+    void* ptr = dvz_mmap_file(filename, &size);
+    if (ptr == NULL)
+        return;
+
+    DvzSize expected = offset + (DvzSize)bricks->shape[0] * bricks->shape[1] * bricks->shape[2] *
+                                    bricks->item_size;
+    if (size < expected)
+    {
+        log_error(
+            "file %s is too small for the volume (%s instead of %s)", filename, pretty_size(size),
+            pretty_size(expected));
+        dvz_munmap_file(ptr, size);
+        return;
+    }
+
+    if (bricks->mmap != NULL)
+        dvz_munmap_file(bricks->mmap, bricks->mmap_size);
+    bricks->mmap = ptr;
+    bricks->mmap_size = size;
+    bricks->mmap_offset = offset;
+}
+
+
+
+void dvz_bricks_create(DvzBricks* bricks)
+{
+    ANN(bricks);
+    ANN(bricks->batch);
+    if (dvz_obj_is_created(&bricks->obj))
+        return;
+
+    uint32_t p = _padded_size(bricks);
+    uvec3 atlas = {bricks->pool[0] * p, bricks->pool[1] * p, bricks->pool[2] * p};
+
+    DvzRequest req = dvz_create_tex(bricks->batch, DVZ_TEX_3D, bricks->format, atlas, 0);
+    bricks->atlas_tex = req.id;
+
+    req = dvz_create_sampler(
+        bricks->batch, DVZ_FILTER_LINEAR, DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+    bricks->atlas_sampler = req.id;
+
+    req = dvz_create_tex(bricks->batch, DVZ_TEX_3D, DVZ_FORMAT_R32_SFLOAT, bricks->grids[0], 0);
+    bricks->indirection_tex = req.id;
+
+    req = dvz_create_sampler(
+        bricks->batch, DVZ_FILTER_NEAREST, DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+    bricks->indirection_sampler = req.id;
+
+    bricks->dirty = true;
+    dvz_obj_created(&bricks->obj);
+}
+
+
+
+uint32_t dvz_bricks_index(DvzBricks* bricks, uint32_t level, uvec3 ijk)
+{
+    ANN(bricks);
+    ASSERT(level < bricks->level_count);
+
+    uint32_t* g = bricks->grids[level];
+    ASSERT(ijk[0] < g[0]);
+    ASSERT(ijk[1] < g[1]);
+    ASSERT(ijk[2] < g[2]);
+    return bricks->offsets[level] + (ijk[2] * g[1] + ijk[1]) * g[0] + ijk[0];
+}
+
+
+
+bool dvz_bricks_fetch(DvzBricks* bricks, uint32_t level, uvec3 ijk, uint8_t* out)
+{
+    ANN(bricks);
+    ANN(out);
+    ASSERT(level < bricks->level_count);
+
+    int64_t b = bricks->brick_size;
+    int64_t a = DVZ_BRICKS_APRON;
+    uint32_t p = _padded_size(bricks);
+    DvzSize item_size = bricks->item_size;
+
+    // Region covered by the brick and its apron, clipped to the volume at that level.
+    uvec3 offset = {0};
+    uvec3 shape = {0};
+    int64_t lo = 0, hi = 0;
+    for (uint32_t c = 0; c < 3; c++)
+    {
+        lo = MAX((int64_t)ijk[c] * b - a, 0);
+        hi = MIN(
+            ((int64_t)ijk[c] + 1) * b + a, (int64_t)dvz_pool_level_size(bricks->shape[c], level));
+        ASSERT(lo < hi);
+        offset[c] = (uint32_t)lo;
+        shape[c] = (uint32_t)(hi - lo);
+    }
+
+    DvzSize size = (DvzSize)shape[0] * shape[1] * shape[2] * item_size;
+    uint8_t* region = (uint8_t*)calloc(size, 1);
+    if (bricks->mmap != NULL)
+        _read_mmap(bricks, level, offset, shape, region);
+    else if (bricks->callback != NULL)
+        bricks->callback(bricks, level, offset, shape, region, bricks->user_data);
+    else
+        log_warn("no file or callback to load the bricks from");
+
+    bool empty = true;
+    for (DvzSize i = 0; i < size && empty; i++)
+        empty = region[i] == 0;
+
+    // Copy the region in the brick, replicating the voxels on the border of the volume.
+    uint32_t x = 0, y = 0, z = 0;
+    for (uint32_t k = 0; k < p; k++)
+    {
+        z = _voxel_clip((int64_t)ijk[2] * b - a + k, offset[2], shape[2]);
+        for (uint32_t j = 0; j < p; j++)
+        {
+            y = _voxel_clip((int64_t)ijk[1] * b - a + j, offset[1], shape[1]);
+            for (uint32_t i = 0; i < p; i++)
+            {
+                x = _voxel_clip((int64_t)ijk[0] * b - a + i, offset[0], shape[0]);
+                memcpy(
+                    &out[(((DvzSize)k * p + j) * p + i) * item_size],
+                    &region[(((DvzSize)z * shape[1] + y) * shape[0] + x) * item_size], item_size);
+            }
+        }
+    }
+
+    FREE(region);
+    return empty;
+}
+
+
+
+uint32_t dvz_bricks_update(DvzBricks* bricks, vec3 eye, float detail)
+{
+    ANN(bricks);
+    if (bricks->mmap == NULL && bricks->callback == NULL)
+    {
+        log_warn("no file or callback to load the bricks from");
+        return 0;
+    }
+    if (detail <= 0)
+        detail = 2;
+
+    dvz_bricks_create(bricks);
+    dvz_pool_start(bricks->cache);
+    bricks->cache->frame++;
+
+    // Level of detail selection, and LRU update of the bricks needed at this frame.
+    _bricks_select(bricks, eye, detail);
+    for (uint32_t i = 0; i < bricks->selection_count; i++)
+        _brick_touch(bricks, bricks->selection[i]);
+
+    // Store the bricks loaded since the last update, and request the missing ones.
+    if (dvz_pool_receive(bricks->cache))
+        bricks->dirty = true;
+    _bricks_request(bricks, eye);
+
+    if (bricks->dirty)
+    {
+        _bricks_indirection(bricks);
+        dvz_upload_tex(
+            bricks->batch, bricks->indirection_tex, DVZ_ZERO_OFFSET, bricks->grids[0],
+            _grid_count(bricks->grids[0]) * sizeof(float), bricks->indirection, 0);
+        bricks->dirty = false;
+    }
+
+    return bricks->cache->pending;
+}
+
+
+
+void dvz_bricks_destroy(DvzBricks* bricks)
+{
+    ANN(bricks);
+
+    // Stop the loader thread, discarding the pending requests.
+    dvz_pool_destroy(bricks->cache);
+
+    if (dvz_obj_is_created(&bricks->obj))
+    {
+        ANN(bricks->batch);
+        log_trace("destroy bricks");
+        dvz_delete_tex(bricks->batch, bricks->atlas_tex);
+        dvz_delete_sampler(bricks->batch, bricks->atlas_sampler);
+        dvz_delete_tex(bricks->batch, bricks->indirection_tex);
+        dvz_delete_sampler(bricks->batch, bricks->indirection_sampler);
+        dvz_obj_destroyed(&bricks->obj);
+    }
+
+    if (bricks->mmap != NULL)
+        dvz_munmap_file(bricks->mmap, bricks->mmap_size);
+
+    FREE(bricks->selection);
+    FREE(bricks->indirection);
+    FREE(bricks);
+}
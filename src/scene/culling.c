@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Culling                                                                                      */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+
+#include "scene/culling.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "fileio.h"
+#include "scene/dual.h"
+#include "scene/kernels.h"
+#include "scene/mvp.h"
+
+
+
+/*************************************************************************************************/
+/*  GPU culling                                                                                  */
+/*************************************************************************************************/
+
+DvzCulling* dvz_culling(DvzBatch* batch)
+{
+    ANN(batch);
+
+    DvzCulling* culling = (DvzCulling*)calloc(1, sizeof(DvzCulling));
+    ANN(culling);
+    culling->batch = batch;
+    culling->dirty = true;
+
+    // Compute shader, embedded as SPIR-V in the library.
+    unsigned long size = 0;
+    unsigned char* buffer = dvz_resource_shader("kernel_cull_comp", &size);
+    ANN(buffer);
+    ASSERT(size > 0);
+    culling->shader = dvz_create_spirv(batch, DVZ_SHADER_COMPUTE, size, buffer).id;
+
+    // Compute pipe.
+    culling->compute = dvz_create_compute(batch, culling->shader, 0).id;
+    for (uint32_t i = 0; i <= 2; i++)
+        dvz_set_slot(batch, culling->compute, i, DVZ_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    for (uint32_t i = 3; i <= 5; i++)
+        dvz_set_slot(batch, culling->compute, i, DVZ_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    // Params.
+    DvzSize params_size = sizeof(DvzCullingParams);
+    culling->params =
+        dvz_create_dat(batch, DVZ_BUFFER_TYPE_UNIFORM, params_size, DVZ_DAT_FLAGS_MAPPABLE).id;
+    dvz_batch_desc(batch, "culling params");
+    dvz_bind_dat(batch, culling->compute, 0, culling->params, 0);
+
+    // Indirect draw command, written by the kernel.
+    // NOTE: standalone dats so that they can be bound as storage buffers at offset 0.
+    DvzSize cmd_size = sizeof(DvzDrawIndexedIndirectCommand);
+    culling->indirect =
+        dvz_create_dat(batch, DVZ_BUFFER_TYPE_INDIRECT, cmd_size, DVZ_DAT_FLAGS_STANDALONE).id;
+    dvz_batch_desc(batch, "culling indirect");
+    dvz_bind_dat(batch, culling->compute, 5, culling->indirect, 0);
+
+    // NOTE: the kernel accumulates the number of indices of the visible items into the indirect
+    // draw command, whose count is reset before each dispatch.
+    DvzDrawIndexedIndirectCommand cmd = {.instanceCount = 1};
+    dvz_upload_dat(batch, culling->indirect, 0, sizeof(cmd), &cmd, 0);
+
+    return culling;
+}
+
+
+
+void dvz_culling_bind(DvzCulling* culling, DvzId mvp, DvzId viewport, DvzId vertex)
+{
+    ANN(culling);
+    ANN(culling->batch);
+
+    dvz_bind_dat(culling->batch, culling->compute, 1, mvp, 0);
+    dvz_bind_dat(culling->batch, culling->compute, 2, viewport, 0);
+    dvz_bind_dat(culling->batch, culling->compute, 3, vertex, 0);
+    culling->dirty = true;
+}
+
+
+
+void dvz_culling_alloc(DvzCulling* culling, uint32_t item_count)
+{
+    ANN(culling);
+    ANN(culling->batch);
+    ASSERT(item_count > 0);
+    ASSERT(0 < culling->p.index_count && culling->p.index_count <= DVZ_CULLING_MAX_INDICES);
+
+    if (item_count <= culling->capacity)
+        return;
+
+    DvzSize size = item_count * culling->p.index_count * sizeof(DvzIndex);
+    if (culling->indices == DVZ_ID_NONE)
+    {
+        culling->indices =
+            dvz_create_dat(culling->batch, DVZ_BUFFER_TYPE_INDEX, size, DVZ_DAT_FLAGS_STANDALONE)
+                .id;
+        dvz_batch_desc(culling->batch, "culling indices");
+    }
+    else
+    {
+        dvz_resize_dat(culling->batch, culling->indices, size);
+    }
+    // NOTE: the descriptor must be updated after a resize.
+    dvz_bind_dat(culling->batch, culling->compute, 4, culling->indices, 0);
+
+    culling->capacity = item_count;
+    culling->dirty = true;
+}
+
+
+
+void dvz_culling_update(DvzCulling* culling)
+{
+    ANN(culling);
+    ANN(culling->batch);
+    ASSERT(culling->p.count <= culling->capacity);
+
+    dvz_upload_dat(
+        culling->batch, culling->params, 0, sizeof(DvzCullingParams), &culling->p, 0);
+    culling->dirty = false;
+}
+
+
+
+void dvz_culling_record(DvzCulling* culling, DvzId canvas_id)
+{
+    ANN(culling);
+    ANN(culling->batch);
+
+    if (culling->p.count == 0)
+        return;
+    dvz_record_dispatch(
+        culling->batch, canvas_id, culling->compute,
+        (uvec3){dvz_kernel_group_count(culling->p.count), 1, 1}, culling->indirect);
+}
+
+
+
+void dvz_culling_destroy(DvzCulling* culling)
+{
+    if (culling == NULL)
+        return;
+    ANN(culling->batch);
+
+    dvz_delete_compute(culling->batch, culling->compute);
+    dvz_delete_dat(culling->batch, culling->params);
+    dvz_delete_dat(culling->batch, culling->indirect);
+    if (culling->indices != DVZ_ID_NONE)
+        dvz_delete_dat(culling->batch, culling->indices);
+    FREE(culling);
+}
+
+
+
+/*************************************************************************************************/
+/*  CPU reference                                                                                */
+/*************************************************************************************************/
+
+// NOTE: same arithmetic as in the kernel_cull.comp shader.
+bool dvz_culling_visible(
+    DvzCullingParams* params, DvzMVP* mvp, DvzViewport* viewport, const float* vertex)
+{
+    ANN(params);
+    ANN(mvp);
+    ANN(viewport);
+    ANN(vertex);
+
+    // Item size.
+    float size = 0;
+    if (params->size_offset >= 0)
+    {
+        size = vertex[params->size_offset];
+        if (params->min_size > 0 && !(size >= params->min_size))
+            return false;
+    }
+
+    // Clip coordinates.
+    const float* pos = &vertex[params->pos_offset];
+    vec4 tr = {0};
+    dvz_mvp_apply(mvp, (vec4){pos[0], pos[1], pos[2], 1}, tr);
+    if (!(tr[3] > 0))
+        return false; // behind the camera
+    if (!(-tr[3] <= tr[2] && tr[2] <= tr[3]))
+        return false; // outside of the depth range
+
+    // Margins, as in transform_margins() in common.glsl.
+    float w = viewport->size_framebuffer[0];
+    float h = viewport->size_framebuffer[1];
+    float mt = viewport->margins[0];
+    float mr = viewport->margins[1];
+    float mb = viewport->margins[2];
+    float ml = viewport->margins[3];
+    float rx = 0, ry = 0;
+    if (w > 0)
+    {
+        tr[0] = (1 - (ml + mr) / w) * tr[0] + (ml - mr) / w;
+        rx = (size + 2 * params->margin) / w;
+    }
+    if (h > 0)
+    {
+        tr[1] = (1 - (mb + mt) / h) * tr[1] + (mb - mt) / h;
+        ry = (size + 2 * params->margin) / h;
+    }
+
+    // The item is visible if its extent intersects the viewport, in NDC.
+    float x = tr[0] / tr[3];
+    float y = tr[1] / tr[3];
+    return fabsf(x) <= 1 + rx && fabsf(y) <= 1 + ry;
+}
+
+
+
+uint32_t dvz_culling_items(
+    DvzCullingParams* params, DvzMVP* mvp, DvzViewport* viewport, const float* vertices,
+    DvzIndex* indices)
+{
+    ANN(params);
+    ANN(vertices);
+    ANN(indices);
+    ASSERT(params->index_count <= DVZ_CULLING_MAX_INDICES);
+
+    uint32_t n = 0;
+    for (uint32_t i = params->first; i < params->first + params->count; i++)
+    {
+        uint32_t vertex = i * params->vertex_count;
+        if (!dvz_culling_visible(params, mvp, viewport, &vertices[vertex * params->stride]))
+            continue;
+        for (uint32_t j = 0; j < params->index_count; j++)
+            indices[n++] = vertex + params->pattern[j];
+    }
+    return n;
+}
@@ -509,7 +509,7 @@ void dvz_demo(void)
 
         texture = dvz_texture_3D(
             batch, DVZ_FORMAT_R8G8B8A8_UNORM, DVZ_FILTER_NEAREST, DVZ_SAMPLER_ADDRESS_MODE_REPEAT,
-            va, vb, vc, tex_data, 0);
+            va, vb, vc, tex_data, DVZ_TEX_FLAGS_OCCUPANCY);
         dvz_volume_texture(volume, texture);
         FREE(tex_data);
     }
@@ -116,8 +116,12 @@ void dvz_dual_resize(DvzDual* dual, uint32_t count)
     ANN(dual->array);
     ASSERT(count > 0);
 
-    // NOTE: for now, we do not make use of count
-    dvz_dual_clear(dual);
+    // Only keep the dirty items that are still within the array.
+    // NOTE: the dats created by the baker keep their data on the GPU when resized, so the clean
+    // items do not need to be uploaded again.
+    dual->dirty_last = MIN(dual->dirty_last, count);
+    if (dual->dirty_first >= dual->dirty_last)
+        dvz_dual_clear(dual);
 
     // Send a dat update command.
     dvz_resize_dat(dual->batch, dual->dat, count * dual->array->item_size);
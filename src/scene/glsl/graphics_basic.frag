@@ -8,6 +8,11 @@
 #include "common.glsl"
 #define EPS 1e-4
 
+#define PICK_LOCATION 2
+#include "pick.glsl"
+
+#include "oit.glsl"
+
 layout(location = 0) in vec4 in_color;
 layout(location = 1) in float in_group;
 layout(location = 0) out vec4 out_color;
@@ -15,6 +20,7 @@ layout(location = 0) out vec4 out_color;
 void main()
 {
     CLIP;
+    pick_write();
 
     // Discard fragments between vertices of different groups.
     float m = in_group;
@@ -23,4 +29,5 @@ void main()
         discard;
 
     out_color = in_color;
+    oit_write(out_color);
 }
@@ -6,6 +6,14 @@
 
 #version 450
 #include "common.glsl"
+#include "colormaps.glsl"
+
+#define SCALAR_BINDING (USER_BINDING + 1)
+#include "params_scalar.glsl"
+
+#define PICK_VERTEX
+#define PICK_LOCATION 2
+#include "pick.glsl"
 
 layout(std140, binding = USER_BINDING) uniform BasicParams { float size; /* point size */ }
 params;
@@ -20,7 +28,8 @@ layout(location = 1) out float out_group;
 void main()
 {
     gl_Position = transform(pos);
-    out_color = color;
+    out_color = scalar_color(color);
     out_group = group;
+    pick_item = gl_VertexIndex;
     gl_PointSize = params.size;
 }
@@ -29,7 +29,10 @@ void main()
     // out_color = vec4(in_uv, 1, 1);
 
     // from https://github.com/Chlumsky/msdfgen#using-a-multi-channel-distance-field
-    vec3 msd = texture(tex, in_uv).rgb;
+    // NOTE: with an atlas font, the texture coordinates are in pixels so that they remain valid
+    // when a dynamic atlas grows.
+    vec2 uv = params.pixel_texcoords != 0 ? in_uv / vec2(textureSize(tex, 0)) : in_uv;
+    vec3 msd = texture(tex, uv).rgb;
     float sd = median(msd.r, msd.g, msd.b);
     if (sd < .05)
         discard;
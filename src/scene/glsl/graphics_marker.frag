@@ -9,6 +9,9 @@
 #include "common.glsl"
 #include "markers.glsl"
 
+#define PICK_LOCATION 3
+#include "pick.glsl"
+
 // NOTE: the values below must correspond to _enums.h
 
 // Marker mode.
@@ -179,6 +182,7 @@ float median(float r, float g, float b) { return max(min(r, g), min(max(r, g), b
 void main()
 {
     CLIP;
+    pick_write();
 
     float a = angle;
     float c = cos(angle);
@@ -7,6 +7,14 @@
 #version 450
 #include "common.glsl"
 #include "constants.glsl"
+#include "colormaps.glsl"
+
+#define SCALAR_BINDING (USER_BINDING + 2)
+#include "params_scalar.glsl"
+
+#define PICK_VERTEX
+#define PICK_LOCATION 3
+#include "pick.glsl"
 
 layout(location = 0) in vec3 pos;
 layout(location = 1) in float size;
@@ -21,9 +29,10 @@ void main()
 {
     gl_Position = transform(pos);
 
-    out_color = color;
+    out_color = scalar_color(color);
     out_size = size;
     out_angle = angle;
+    pick_item = gl_VertexIndex;
 
     gl_PointSize = size * (abs(cos(angle)) + abs(sin(angle)));
 }
@@ -9,6 +9,7 @@
 #include "constants.glsl"
 // #include "params_mesh.glsl"
 #include "lighting.glsl"
+#include "oit.glsl"
 
 // mvp --> slot 0
 // viewport --> slot 1
@@ -256,4 +257,5 @@ void main()
     }
 
     out_color.a = in_uvcolor.a;
+    oit_write(out_color);
 }
@@ -6,6 +6,10 @@
 
 #version 450
 #include "common.glsl"
+#include "colormaps.glsl"
+
+#define SCALAR_BINDING (USER_BINDING + 4)
+#include "params_scalar.glsl"
 
 
 // Attributes.
@@ -46,7 +50,7 @@ void main()
     out_cam_pos = inverse(mvp.view) * vec4(0, 0, 0, 1);
 
     out_normal = ((transpose(inverse(mvp.model)) * vec4(normal, 1.0))).xyz;
-    out_uvcolor = uvcolor;
+    out_uvcolor = scalar_color(uvcolor);
 
     // // DEBUG
     // if ((mvp.model * vec4(pos, 1)).z < 0)
@@ -10,6 +10,10 @@
 
 #version 450
 #include "common.glsl"
+#include "colormaps.glsl"
+
+#define SCALAR_BINDING (USER_BINDING + 1)
+#include "params_scalar.glsl"
 
 layout(std140, binding = USER_BINDING) uniform Params
 {
@@ -83,7 +87,7 @@ void main()
     vec2 p3 = p3_.xy / p3_.w;
     float z = p1_.z / p1_.w;
 
-    out_color = color;
+    out_color = scalar_color(color);
     out_linewidth = linewidth;
 
     float miter_limit = params.miter_limit;
@@ -8,6 +8,11 @@
 #include "antialias.glsl"
 #include "common.glsl"
 
+#define PICK_LOCATION 2
+#include "pick.glsl"
+
+#include "oit.glsl"
+
 layout(location = 0) in vec4 in_color;
 layout(location = 1) in float in_size;
 
@@ -18,10 +23,13 @@ float marker_disc(vec2 P, float size) { return length(P) - size / 2; }
 void main()
 {
     CLIP;
+    pick_write();
 
     vec2 P = gl_PointCoord.xy - vec2(0.5, 0.5);
     float distance = marker_disc(P * (in_size + 1), in_size);
     out_color = filled(distance, 0, in_color);
     if (out_color.a < .05)
         discard;
+
+    oit_write(out_color);
 }
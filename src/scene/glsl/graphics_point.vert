@@ -6,6 +6,14 @@
 
 #version 450
 #include "common.glsl"
+#include "colormaps.glsl"
+
+#define SCALAR_BINDING (USER_BINDING)
+#include "params_scalar.glsl"
+
+#define PICK_VERTEX
+#define PICK_LOCATION 2
+#include "pick.glsl"
 
 layout(location = 0) in vec3 pos;
 layout(location = 1) in float size;
@@ -18,8 +26,9 @@ void main()
 {
     gl_Position = transform(pos);
 
-    out_color = color;
+    out_color = scalar_color(color);
     out_size = size;
+    pick_item = gl_VertexIndex;
 
     gl_PointSize = size;
 }
@@ -10,8 +10,10 @@
 #include "utils_volume.glsl"
 
 // Constants.
-#define STEP_SIZE 0.005
-#define MAX_ITER  10 / STEP_SIZE
+#define REF_STEP_SIZE 0.005 // reference step size used for the opacity correction
+#define MIN_STEP_SIZE 0.0001
+#define MAX_ITER      8192
+#define BRICK_SIZE    16 // DVZ_TEXTURE_BRICK_SIZE, size of the bricks of the occupancy grid
 
 // Volume type specialization constant.
 layout(constant_id = 0) const int VOLUME_TYPE = VOLUME_TYPE_SCALAR;
@@ -22,6 +24,9 @@ layout(constant_id = 1) const int VOLUME_COLOR = VOLUME_COLOR_DIRECT;
 // Volume front to back or back to front.
 layout(constant_id = 2) const int VOLUME_DIR = VOLUME_DIR_FRONT_BACK;
 
+// Volume stored in a single 3D texture, or in a pool of bricks streamed on demand.
+layout(constant_id = 3) const int VOLUME_STORAGE = VOLUME_STORAGE_DENSE;
+
 // Uniform variables.
 layout(std140, binding = USER_BINDING) uniform Params
 {
@@ -32,12 +37,18 @@ layout(std140, binding = USER_BINDING) uniform Params
     vec4 uvw1;         /* texture coordinates of the 2 corner points */
     vec4 transfer;     /* transfer function */
     ivec4 permutation; /* (0,1,2,-1) by default */
+    vec4 raymarch;     /* step (in voxels), termination alpha, empty brick alpha, unused */
+    ivec4 bricks;      /* bricked volumes only: volume shape (in voxels), brick size */
 }
 params;
 
-// Texture.
+// Texture, or brick pool for bricked volumes.
 layout(binding = (USER_BINDING + 1)) uniform sampler3D tex_density; // 3D vol with vox R density
 
+// Brick occupancy: upper bound of the voxel values in each brick of the volume. For bricked
+// volumes, indirection table with the pool slot and level of the brick to sample, or -1 if empty.
+layout(binding = (USER_BINDING + 2)) uniform sampler3D tex_occupancy;
+
 // Varying variables.
 layout(location = 0) in vec3 in_pos;
 layout(location = 1) in vec3 in_ray;
@@ -60,6 +71,73 @@ bool intersect_box(vec3 origin, vec3 dir, vec3 box_min, vec3 box_max, out float
     return t0 <= t1;
 }
 
+// Texture coordinates of a position within the bounding box.
+vec3 tex_coords(vec3 pos, vec3 b0, vec3 d)
+{
+    // Normalize 3D pos within cube in [0,1]^3
+    vec3 uvw = (pos - b0) * d;
+    uvw.y = 1 - uvw.y;
+
+    // Now, normalize between uvw0 and uvw1.
+    uvw = params.uvw0.xyz + uvw * (params.uvw1 - params.uvw0).xyz;
+
+    // Texture coordinate index permutation.
+    return vec3(uvw[params.permutation.x], uvw[params.permutation.y], uvw[params.permutation.z]);
+}
+
+// Ray marching step size, derived from the size of a voxel in the bounding box.
+float step_size(vec3 b0, vec3 b1)
+{
+    vec3 dims = VOLUME_STORAGE == VOLUME_STORAGE_BRICKED ? vec3(params.bricks.xyz)
+                                                         : vec3(textureSize(tex_density, 0));
+    vec3 extent = abs(b1 - b0);
+    vec3 duvw = max(abs((params.uvw1 - params.uvw0).xyz), vec3(1e-6));
+    float voxel = extent[params.permutation.x] / (dims.x * duvw[params.permutation.x]);
+    voxel = min(voxel, extent[params.permutation.y] / (dims.y * duvw[params.permutation.y]));
+    voxel = min(voxel, extent[params.permutation.z] / (dims.z * duvw[params.permutation.z]));
+    return max(voxel * params.raymarch.x, MIN_STEP_SIZE);
+}
+
+// Number of steps needed to exit the current brick, given the position and the step in the
+// brick grid coordinates.
+int brick_exit(vec3 g, vec3 gstep)
+{
+    vec3 f = floor(g);
+    float t = 1e9;
+    for (int k = 0; k < 3; k++)
+    {
+        if (gstep[k] > 0)
+            t = min(t, (f[k] + 1 - g[k]) / gstep[k]);
+        else if (gstep[k] < 0)
+            t = min(t, (g[k] - f[k]) / -gstep[k]);
+    }
+    return max(1, int(ceil(t)));
+}
+
+// Bricked volumes: fetch the color from the brick pool, given the indirection table entry
+// encoding the pool slot and the level of the brick (slot * 16 + level).
+vec4 fetch_brick(ivec2 modes, vec3 uvw, float entry)
+{
+    if ((min(min(uvw.x, uvw.y), uvw.z) <= 0) || (max(max(uvw.x, uvw.y), uvw.z) >= 1))
+        return vec4(0);
+
+    int e = int(entry + 0.5);
+    int level = e & 15;
+    int slot = e >> 4;
+
+    int bs = params.bricks.w;
+    ivec3 atlas = textureSize(tex_density, 0);
+    ivec3 pool = atlas / (bs + 2);
+    ivec3 s = ivec3(slot % pool.x, (slot / pool.x) % pool.y, slot / (pool.x * pool.y));
+
+    // Voxel coordinates at the level of the brick, and within the brick (with a 1-voxel apron).
+    vec3 v = uvw * vec3(params.bricks.xyz) / float(1 << level);
+    vec3 local = v - vec3((ivec3(v) / bs) * bs);
+    vec3 a = (vec3(s * (bs + 2)) + 1.0 + local) / vec3(atlas);
+
+    return fetch_color(modes, tex_density, a, params.transfer);
+}
+
 // Entry-point.
 void main()
 {
@@ -84,7 +162,8 @@ void main()
     vec3 ray_stop = o + u * t1;
 
     vec3 pos = ray_start;
-    vec3 dl = -normalize(ray_start - ray_stop) * STEP_SIZE;
+    float step = step_size(b0, b1);
+    vec3 dl = -normalize(ray_start - ray_stop) * step;
 
     // Direction: back to front or front to back.
     if (VOLUME_DIR == VOLUME_DIR_BACK_FRONT)
@@ -93,8 +172,21 @@ void main()
         dl = -dl;
     }
 
+    // The opacity of each sample is scaled with the step size so that the appearance of the
+    // volume does not depend on the texture resolution.
+    float alpha_scale = step / REF_STEP_SIZE;
+
+    // Step in the brick grid coordinates, constant along the ray. The last brick of a dimension
+    // may be partial, so the grid coordinates are derived from the volume shape in voxels.
+    vec3 bricks = vec3(textureSize(tex_occupancy, 0));
+    vec3 gscale = VOLUME_STORAGE == VOLUME_STORAGE_BRICKED
+                      ? vec3(params.bricks.xyz) / float(max(params.bricks.w, 1))
+                      : vec3(textureSize(tex_density, 0)) / float(BRICK_SIZE);
+    vec3 gstep = (tex_coords(pos + dl, b0, d) - tex_coords(pos, b0, d)) * gscale;
+    bool empty = false;
+    vec3 g = vec3(0);
+
     float travel = distance(ray_start, ray_stop);
-    float max_intensity = 0.0;
     vec3 uvw = vec3(0);
 
     vec3 rgbVoxel = vec3(0);
@@ -102,28 +194,40 @@ void main()
     float intensity = 0;
     float alpha = 0;
     float alphaAcc = 0;
+    float occupancy = 0;
     vec4 fetched = vec4(0);
     ivec2 modes = ivec2(VOLUME_TYPE, VOLUME_COLOR);
+    int n = 0;
 
-    for (int i = 0; i < MAX_ITER && travel > 0.0; ++i, pos += dl, travel -= STEP_SIZE)
+    for (int i = 0; i < MAX_ITER && travel > 0.0;)
     {
-        // Normalize 3D pos within cube in [0,1]^3
-        uvw = (pos - b0) * d;
-        uvw.y = 1 - uvw.y;
+        uvw = tex_coords(pos, b0, d);
 
-        // Now, normalize between uvw0 and uvw1.
-        uvw = params.uvw0.xyz + uvw * (params.uvw1 - params.uvw0).xyz;
-
-        // Texture coordinate index permutation.
-        uvw =
-            vec3(uvw[params.permutation.x], uvw[params.permutation.y], uvw[params.permutation.z]);
+        // Empty-space skipping: jump to the next brick if the current one is empty.
+        g = uvw * gscale;
+        occupancy = texelFetch(tex_occupancy, clamp(ivec3(g), ivec3(0), ivec3(bricks) - 1), 0).r;
+        if (VOLUME_STORAGE == VOLUME_STORAGE_BRICKED)
+            empty = occupancy < 0;
+        else
+            empty = min(occupancy, 1) * params.transfer.x <= params.raymarch.z;
+        if (empty)
+        {
+            n = brick_exit(g, gstep);
+            i += n;
+            pos += float(n) * dl;
+            travel -= float(n) * step;
+            continue;
+        }
 
         // Fetch the color from the 3D texture.
-        fetched = fetch_color(modes, tex_density, uvw, params.transfer);
+        if (VOLUME_STORAGE == VOLUME_STORAGE_BRICKED)
+            fetched = fetch_brick(modes, uvw, occupancy);
+        else
+            fetched = fetch_color(modes, tex_density, uvw, params.transfer);
 
         rgbVoxel = fetched.rgb;
         intensity = fetched.a;
-        alpha = intensity;
+        alpha = min(intensity * alpha_scale, 1);
 
         // Disable ray marching on a sliced face, indicated by the last argument in permutation,
         // which is just an index between 0 and 5 identifying the face of the bounding box that
@@ -137,8 +241,14 @@ void main()
 
         rgbAcc = (1 - alpha) * rgbAcc + alpha * rgbVoxel;
         alphaAcc += alpha;
-        if (alphaAcc >= 1)
+
+        // Early ray termination.
+        if (alphaAcc >= params.raymarch.y)
             break;
+
+        i++;
+        pos += dl;
+        travel -= step;
     }
 
     gl_FragDepth = pos.z;
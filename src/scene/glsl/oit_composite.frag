@@ -0,0 +1,24 @@
+/*
+* Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+* Licensed under the MIT license. See LICENSE file in the project root for details.
+* SPDX-License-Identifier: MIT
+*/
+
+#version 450
+
+layout(input_attachment_index = 0, binding = 0) uniform subpassInput accum;
+layout(input_attachment_index = 1, binding = 1) uniform subpassInput reveal;
+
+layout(location = 0) out vec4 out_color;
+
+void main()
+{
+    // Product of (1 - alpha) of all translucent fragments, 1 if there are none.
+    float revealage = subpassLoad(reveal).r;
+    if (revealage >= 1.0)
+        discard;
+
+    vec4 acc = subpassLoad(accum);
+    // NOTE: blended onto the opaque fragments with the standard blending.
+    out_color = vec4(acc.rgb / max(acc.a, 1e-5), 1.0 - revealage);
+}
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Kernels                                                                                      */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+
+#include "scene/kernels.h"
+#include "_cglm.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "fileio.h"
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+static const char* _kernel_shader(DvzKernelType type)
+{
+    switch (type)
+    {
+    case DVZ_KERNEL_PATH:
+        return "kernel_path_comp";
+    case DVZ_KERNEL_NORMALS:
+        return "kernel_normals_comp";
+    case DVZ_KERNEL_MIN_MAX:
+        return "kernel_min_max_comp";
+    case DVZ_KERNEL_HISTOGRAM:
+        return "kernel_histogram_comp";
+    default:
+        log_error("unknown kernel type %d", type);
+        return NULL;
+    }
+}
+
+
+
+// Number of storage buffers of a kernel, bound from binding 1.
+static uint32_t _kernel_storage_count(DvzKernelType type)
+{
+    switch (type)
+    {
+    case DVZ_KERNEL_PATH:
+    case DVZ_KERNEL_NORMALS:
+        return 3;
+    case DVZ_KERNEL_MIN_MAX:
+    case DVZ_KERNEL_HISTOGRAM:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+
+
+// NOTE: same neighbour indexing as in the kernel_path.comp shader.
+static inline uint32_t _path_neighbor(int32_t i, int32_t l, bool closed)
+{
+    ASSERT(l > 0);
+    if (closed)
+        return (uint32_t)(((i % l) + l) % l);
+    return (uint32_t)CLIP(i, 0, l - 1);
+}
+
+
+
+/*************************************************************************************************/
+/*  GPU kernels                                                                                  */
+/*************************************************************************************************/
+
+DvzKernel dvz_kernel(DvzBatch* batch, DvzKernelType type)
+{
+    ANN(batch);
+    ASSERT(DVZ_KERNEL_NONE < type && type < DVZ_KERNEL_COUNT);
+
+    DvzKernel kernel = {0};
+    kernel.batch = batch;
+    kernel.type = type;
+
+    // Compute shader, embedded as SPIR-V in the library.
+    unsigned long size = 0;
+    unsigned char* buffer = dvz_resource_shader(_kernel_shader(type), &size);
+    ANN(buffer);
+    ASSERT(size > 0);
+    kernel.shader = dvz_create_spirv(batch, DVZ_SHADER_COMPUTE, size, buffer).id;
+
+    // Compute pipe.
+    kernel.compute = dvz_create_compute(batch, kernel.shader, 0).id;
+    dvz_set_slot(batch, kernel.compute, 0, DVZ_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    for (uint32_t i = 1; i <= _kernel_storage_count(type); i++)
+        dvz_set_slot(batch, kernel.compute, i, DVZ_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    // Params.
+    DvzSize params_size = sizeof(DvzKernelParams);
+    kernel.params =
+        dvz_create_dat(batch, DVZ_BUFFER_TYPE_UNIFORM, params_size, DVZ_DAT_FLAGS_MAPPABLE).id;
+    dvz_batch_desc(batch, "kernel params");
+    dvz_bind_dat(batch, kernel.compute, 0, kernel.params, 0);
+
+    return kernel;
+}
+
+
+
+void dvz_kernel_bind(DvzKernel* kernel, uint32_t slot_idx, DvzId dat)
+{
+    ANN(kernel);
+    ANN(kernel->batch);
+    ASSERT(1 <= slot_idx && slot_idx <= _kernel_storage_count(kernel->type));
+    dvz_bind_dat(kernel->batch, kernel->compute, slot_idx, dat, 0);
+}
+
+
+
+void dvz_kernel_run(DvzKernel* kernel, DvzKernelParams* params, uint32_t item_count)
+{
+    ANN(kernel);
+    ANN(kernel->batch);
+    ANN(params);
+    ASSERT(item_count > 0);
+
+    // NOTE: the renderer processes the requests in order and the dispatch is synchronous, so the
+    // same params dat can be reused by the successive passes of a batch.
+    dvz_upload_dat(kernel->batch, kernel->params, 0, sizeof(DvzKernelParams), params, 0);
+    dvz_dispatch_compute(
+        kernel->batch, kernel->compute, (uvec3){dvz_kernel_group_count(item_count), 1, 1});
+}
+
+
+
+uint32_t dvz_kernel_group_count(uint32_t item_count)
+{
+    return (item_count + DVZ_KERNEL_GROUP_SIZE - 1) / DVZ_KERNEL_GROUP_SIZE;
+}
+
+
+
+void dvz_kernel_destroy(DvzKernel* kernel)
+{
+    ANN(kernel);
+    ANN(kernel->batch);
+
+    if (kernel->compute != DVZ_ID_NONE)
+        dvz_delete_compute(kernel->batch, kernel->compute);
+    if (kernel->params != DVZ_ID_NONE)
+        dvz_delete_dat(kernel->batch, kernel->params);
+    if (kernel->shader != DVZ_ID_NONE)
+        dvz_delete_shader(kernel->batch, kernel->shader);
+    kernel->compute = DVZ_ID_NONE;
+    kernel->params = DVZ_ID_NONE;
+    kernel->shader = DVZ_ID_NONE;
+}
+
+
+
+/*************************************************************************************************/
+/*  CPU reference kernels                                                                        */
+/*************************************************************************************************/
+
+void dvz_kernel_path(
+    uint32_t point_count, const vec3* positions, uint32_t path_count,
+    const uint32_t* path_lengths, bool closed, vec3* p0, vec3* p1, vec3* p2, vec3* p3)
+{
+    ANN(positions);
+    ANN(path_lengths);
+    ANN(p0);
+    ANN(p1);
+    ANN(p2);
+    ANN(p3);
+
+    uint32_t k = 0;
+    for (uint32_t j = 0; j < path_count; j++)
+    {
+        int32_t l = (int32_t)path_lengths[j];
+        const vec3* path = &positions[k];
+        for (int32_t i = 0; i < l; i++)
+        {
+            ASSERT(k < point_count);
+            _vec3_copy(path[_path_neighbor(i - 1, l, closed)], p0[k]);
+            _vec3_copy(path[_path_neighbor(i + 0, l, closed)], p1[k]);
+            _vec3_copy(path[_path_neighbor(i + 1, l, closed)], p2[k]);
+            _vec3_copy(path[_path_neighbor(i + 2, l, closed)], p3[k]);
+            k++;
+        }
+    }
+    ASSERT(k == point_count);
+}
+
+
+
+void dvz_kernel_normals(
+    uint32_t vertex_count, const vec3* positions, uint32_t index_count, const DvzIndex* indices,
+    vec3* normals)
+{
+    ANN(positions);
+    ANN(indices);
+    ANN(normals);
+    ASSERT(index_count % 3 == 0);
+
+    // Fixed-point accumulation of the face normals, as with the atomics of the GPU kernel.
+    int32_t* acc = (int32_t*)calloc(3 * vertex_count, sizeof(int32_t));
+    ANN(acc);
+
+    vec3 p0 = {0}, p1 = {0}, p2 = {0};
+    vec3 u = {0}, v = {0}, n = {0};
+    float norm = 0;
+    for (uint32_t f = 0; f < index_count / 3; f++)
+    {
+        DvzIndex i0 = indices[3 * f + 0];
+        DvzIndex i1 = indices[3 * f + 1];
+        DvzIndex i2 = indices[3 * f + 2];
+        ASSERT(i0 < vertex_count);
+        ASSERT(i1 < vertex_count);
+        ASSERT(i2 < vertex_count);
+
+        _vec3_copy(positions[i0], p0);
+        _vec3_copy(positions[i1], p1);
+        _vec3_copy(positions[i2], p2);
+        glm_vec3_sub(p1, p0, u);
+        glm_vec3_sub(p2, p0, v);
+        glm_vec3_cross(u, v, n);
+        norm = glm_vec3_norm(n);
+        if (norm <= 0)
+            continue; // degenerate face
+
+        for (uint32_t c = 0; c < 3; c++)
+        {
+            int32_t q = (int32_t)roundf(n[c] / norm * DVZ_KERNEL_NORMAL_SCALE);
+            acc[3 * i0 + c] += q;
+            acc[3 * i1 + c] += q;
+            acc[3 * i2 + c] += q;
+        }
+    }
+
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        for (uint32_t c = 0; c < 3; c++)
+            normals[i][c] = acc[3 * i + c] / DVZ_KERNEL_NORMAL_SCALE;
+        norm = glm_vec3_norm(normals[i]);
+        if (norm > 0)
+            glm_vec3_divs(normals[i], norm, normals[i]);
+    }
+
+    FREE(acc);
+}
+
+
+
+void dvz_kernel_min_max(uint32_t count, const float* values, vec2* partials)
+{
+    ANN(values);
+    ANN(partials);
+
+    uint32_t group_count = dvz_kernel_group_count(count);
+    for (uint32_t g = 0; g < group_count; g++)
+    {
+        float vmin = INFINITY, vmax = -INFINITY;
+        uint32_t end = MIN((g + 1) * DVZ_KERNEL_GROUP_SIZE, count);
+        for (uint32_t i = g * DVZ_KERNEL_GROUP_SIZE; i < end; i++)
+        {
+            if (isnan(values[i]))
+                continue;
+            vmin = MIN(vmin, values[i]);
+            vmax = MAX(vmax, values[i]);
+        }
+        partials[g][0] = vmin;
+        partials[g][1] = vmax;
+    }
+}
+
+
+
+void dvz_kernel_min_max_reduce(uint32_t group_count, const vec2* partials, vec2 min_max)
+{
+    ANN(partials);
+
+    min_max[0] = INFINITY;
+    min_max[1] = -INFINITY;
+    for (uint32_t g = 0; g < group_count; g++)
+    {
+        min_max[0] = MIN(min_max[0], partials[g][0]);
+        min_max[1] = MAX(min_max[1], partials[g][1]);
+    }
+}
+
+
+
+void dvz_kernel_histogram(
+    uint32_t count, const float* values, vec2 range, uint32_t bin_count, uint32_t* bins)
+{
+    ANN(values);
+    ANN(bins);
+    ASSERT(bin_count > 0);
+
+    memset(bins, 0, bin_count * sizeof(uint32_t));
+    if (!(range[0] < range[1]))
+    {
+        log_warn("empty histogram range [%g, %g]", range[0], range[1]);
+        return;
+    }
+
+    // NOTE: same single-precision arithmetic as in the kernel_histogram.comp shader.
+    float scale = (float)bin_count / (range[1] - range[0]);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float x = values[i];
+        if (!(range[0] <= x && x <= range[1]))
+            continue; // outside of the range, or NaN
+        uint32_t b = MIN((uint32_t)((x - range[0]) * scale), bin_count - 1);
+        bins[b]++;
+    }
+}
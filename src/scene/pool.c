@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Pool                                                                                         */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/pool.h"
+#include "_thread_utils.h"
+#include "fifo.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static int _compare_candidates(const void* a, const void* b)
+{
+    double ka = ((const DvzPoolCandidate*)a)->key;
+    double kb = ((const DvzPoolCandidate*)b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+
+
+// Find a free slot, or evict the least recently used item not needed at the current frame.
+// Return -1 if all slots are needed.
+static int32_t _slot_alloc(DvzPool* pool)
+{
+    ANN(pool);
+
+    int32_t lru = -1;
+    uint64_t oldest = UINT64_MAX;
+    DvzPoolSlot* slot = NULL;
+    for (uint32_t s = 0; s < pool->capacity; s++)
+    {
+        slot = &pool->entries[s];
+        if (slot->item < 0)
+            return (int32_t)s;
+        if (slot->pinned || slot->last_used >= pool->frame)
+            continue;
+        if (slot->last_used < oldest)
+        {
+            oldest = slot->last_used;
+            lru = (int32_t)s;
+        }
+    }
+
+    if (lru >= 0)
+    {
+        slot = &pool->entries[lru];
+        log_trace("evict item %" PRId64 " from slot %d", slot->item, lru);
+        pool->states[slot->item] = DVZ_POOL_STATE_UNLOADED;
+        pool->slots[slot->item] = -1;
+        slot->item = -1;
+    }
+    return lru;
+}
+
+
+
+/*************************************************************************************************/
+/*  Loader                                                                                       */
+/*************************************************************************************************/
+
+static void* _loader_thread(void* user_data)
+{
+    DvzPool* pool = (DvzPool*)user_data;
+    ANN(pool);
+    ANN(pool->fetch);
+
+    DvzPoolLoad* load = NULL;
+    while (true)
+    {
+        // A NULL item stops the thread.
+        load = (DvzPoolLoad*)dvz_fifo_dequeue(pool->requests, true);
+        if (load == NULL)
+            break;
+
+        // Skip the items that are no longer needed after waiting in the queue.
+        if (dvz_atomic_get(load->cancelled) == 0)
+        {
+            load->data = (uint8_t*)calloc(pool->load_size, 1);
+            load->empty = pool->fetch(pool->owner, load->item, load->data);
+        }
+        dvz_fifo_enqueue(pool->loaded, load);
+    }
+    log_trace("pool loader thread stopped");
+    return NULL;
+}
+
+
+
+static void _load_destroy(DvzPoolLoad* load)
+{
+    ANN(load);
+    dvz_atomic_destroy(load->cancelled);
+    FREE(load->data);
+    FREE(load);
+}
+
+
+
+static void _load_request(DvzPool* pool, uint32_t item)
+{
+    ANN(pool);
+    ASSERT(pool->states[item] == DVZ_POOL_STATE_UNLOADED);
+    ASSERT(pool->pending < pool->max_pending);
+
+    DvzPoolLoad* load = (DvzPoolLoad*)calloc(1, sizeof(DvzPoolLoad));
+    load->item = item;
+    load->cancelled = dvz_atomic();
+
+    for (uint32_t i = 0; i < pool->max_pending; i++)
+    {
+        if (pool->inflight[i] == NULL)
+        {
+            pool->inflight[i] = load;
+            break;
+        }
+    }
+
+    pool->states[item] = DVZ_POOL_STATE_PENDING;
+    pool->pending++;
+    dvz_fifo_enqueue(pool->requests, load);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzPool* dvz_pool(uint32_t item_count, uint32_t capacity, uint32_t max_pending)
+{
+    ASSERT(item_count > 0);
+    ASSERT(capacity > 0);
+    ASSERT(max_pending > 0);
+
+    DvzPool* pool = (DvzPool*)calloc(1, sizeof(DvzPool));
+    pool->item_count = item_count;
+    pool->states = (uint8_t*)calloc(item_count, sizeof(uint8_t));
+    pool->stamps = (uint64_t*)calloc(item_count, sizeof(uint64_t));
+    pool->slots = (int32_t*)calloc(item_count, sizeof(int32_t));
+    for (uint32_t i = 0; i < item_count; i++)
+        pool->slots[i] = -1;
+
+    pool->capacity = capacity;
+    pool->entries = (DvzPoolSlot*)calloc(capacity, sizeof(DvzPoolSlot));
+    for (uint32_t s = 0; s < capacity; s++)
+        pool->entries[s].item = -1;
+
+    pool->max_pending = max_pending;
+    pool->inflight = (DvzPoolLoad**)calloc(max_pending, sizeof(DvzPoolLoad*));
+    pool->requests = dvz_fifo((int32_t)max_pending);
+    pool->loaded = dvz_fifo((int32_t)max_pending);
+
+    return pool;
+}
+
+
+
+void dvz_pool_loader(
+    DvzPool* pool, DvzSize size, DvzPoolFetch fetch, DvzPoolUpload upload, void* owner)
+{
+    ANN(pool);
+    ANN(fetch);
+    ANN(upload);
+    ASSERT(size > 0);
+    // NOTE: the loader thread reads these fields without locking.
+    ASSERT(pool->thread == NULL);
+
+    pool->load_size = size;
+    pool->fetch = fetch;
+    pool->upload = upload;
+    pool->owner = owner;
+}
+
+
+
+void dvz_pool_start(DvzPool* pool)
+{
+    ANN(pool);
+    if (pool->thread != NULL)
+        return;
+    log_debug("start the pool loader thread");
+    pool->thread = dvz_thread(_loader_thread, pool);
+}
+
+
+
+bool dvz_pool_touch(DvzPool* pool, uint32_t item)
+{
+    ANN(pool);
+    ASSERT(item < pool->item_count);
+
+    if (pool->states[item] != DVZ_POOL_STATE_RESIDENT)
+        return false;
+    ASSERT(pool->slots[item] >= 0);
+    pool->entries[pool->slots[item]].last_used = pool->frame;
+    return true;
+}
+
+
+
+void dvz_pool_request(DvzPool* pool, uint32_t count, DvzPoolCandidate* candidates)
+{
+    ANN(pool);
+    if (count == 0)
+        return;
+    ANN(candidates);
+
+    dvz_pool_sort(count, candidates);
+    for (uint32_t c = 0; c < count && pool->pending < pool->max_pending; c++)
+    {
+        // NOTE: several candidates may refer to the same item.
+        if (pool->states[candidates[c].item] == DVZ_POOL_STATE_UNLOADED)
+            _load_request(pool, candidates[c].item);
+    }
+}
+
+
+
+void dvz_pool_cancel(DvzPool* pool)
+{
+    ANN(pool);
+
+    DvzPoolLoad* load = NULL;
+    for (uint32_t i = 0; i < pool->max_pending; i++)
+    {
+        load = pool->inflight[i];
+        if (load != NULL)
+            dvz_atomic_set(load->cancelled, pool->stamps[load->item] < pool->frame);
+    }
+}
+
+
+
+bool dvz_pool_receive(DvzPool* pool)
+{
+    ANN(pool);
+
+    bool changed = false;
+    DvzPoolLoad* load = NULL;
+    int32_t slot = -1;
+    while ((load = (DvzPoolLoad*)dvz_fifo_dequeue(pool->loaded, false)) != NULL)
+    {
+        ASSERT(pool->pending > 0);
+        pool->pending--;
+        ASSERT(pool->states[load->item] == DVZ_POOL_STATE_PENDING);
+        for (uint32_t i = 0; i < pool->max_pending; i++)
+        {
+            if (pool->inflight[i] == load)
+                pool->inflight[i] = NULL;
+        }
+
+        if (load->data == NULL)
+        {
+            // The load was cancelled: the item will be requested again if it is needed.
+            pool->states[load->item] = DVZ_POOL_STATE_UNLOADED;
+        }
+        else if (load->empty)
+        {
+            pool->states[load->item] = DVZ_POOL_STATE_EMPTY;
+            changed = true;
+        }
+        else if ((slot = _slot_alloc(pool)) < 0)
+        {
+            // The pool is full of needed items: the item will be requested again later.
+            log_trace("pool full, dropping item %d", load->item);
+            pool->states[load->item] = DVZ_POOL_STATE_UNLOADED;
+        }
+        else
+        {
+            pool->upload(pool->owner, (uint32_t)slot, load->data);
+            pool->entries[slot].item = load->item;
+            pool->entries[slot].last_used = pool->frame;
+            pool->entries[slot].pinned = load->item == pool->item_count - 1;
+            pool->slots[load->item] = slot;
+            pool->states[load->item] = DVZ_POOL_STATE_RESIDENT;
+            changed = true;
+        }
+
+        _load_destroy(load);
+    }
+    return changed;
+}
+
+
+
+bool dvz_pool_ready(DvzPool* pool, uint32_t count, uint32_t* items)
+{
+    ANN(pool);
+    if (pool->pending > 0)
+        return false;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (pool->states[items[i]] < DVZ_POOL_STATE_RESIDENT)
+            return false;
+    }
+    return true;
+}
+
+
+
+void dvz_pool_sort(uint32_t count, DvzPoolCandidate* candidates)
+{
+    if (count == 0)
+        return;
+    ANN(candidates);
+    qsort(candidates, count, sizeof(DvzPoolCandidate), _compare_candidates);
+}
+
+
+
+void dvz_pool_destroy(DvzPool* pool)
+{
+    ANN(pool);
+
+    // Stop the loader thread, discarding the pending requests.
+    if (pool->thread != NULL)
+    {
+        dvz_fifo_enqueue_first(pool->requests, NULL);
+        dvz_thread_join(pool->thread);
+    }
+
+    DvzPoolLoad* load = NULL;
+    while ((load = (DvzPoolLoad*)dvz_fifo_dequeue(pool->requests, false)) != NULL)
+        _load_destroy(load);
+    while ((load = (DvzPoolLoad*)dvz_fifo_dequeue(pool->loaded, false)) != NULL)
+        _load_destroy(load);
+    dvz_fifo_destroy(pool->requests);
+    dvz_fifo_destroy(pool->loaded);
+
+    FREE(pool->states);
+    FREE(pool->stamps);
+    FREE(pool->slots);
+    FREE(pool->entries);
+    FREE(pool->inflight);
+    FREE(pool);
+}
@@ -1394,6 +1394,14 @@ static void _scene_build(DvzScene* scene)
                         status = DVZ_BUILD_DIRTY;
                         break;
                     }
+
+                    // The visual entered or left the view since the last build.
+                    if (view->is_visible && visual->is_visible &&
+                        visual->is_culled != dvz_visual_culled(visual))
+                    {
+                        status = DVZ_BUILD_DIRTY;
+                        break;
+                    }
                 }
             }
         }
@@ -1429,6 +1437,9 @@ static void _scene_build(DvzScene* scene)
 
                 // This will only update the visual if it needs to be updated.
                 dvz_visual_update(visual);
+
+                // This will only update the GPU culling params if the data changed.
+                dvz_visual_culling_update(visual);
             }
         }
     }
@@ -0,0 +1,930 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Spatial index                                                                                */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "_log.h"
+#include "_macros.h"
+#include "scene/spatial.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define SPATIAL_POINTS_PER_CELL 2         // target average number of points per grid cell
+#define SPATIAL_MAX_CELLS       (1 << 22) // maximum number of grid cells
+#define SPATIAL_MIN_MOVED       4096      // points allowed out of their cell before a rebuild
+#define SPATIAL_LEAF_SIZE       4         // maximum number of triangles per BVH leaf
+#define SPATIAL_MAX_THREADS     16        // maximum number of build threads
+#define SPATIAL_PARALLEL_MIN    65536     // minimum number of items for a parallel build
+#define SPATIAL_NONE            UINT32_MAX
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzSpatialNode
+{
+    float lo[3], hi[3];
+    uint32_t first; // first primitive for a leaf, left child for an internal node
+    uint32_t count; // number of primitives, 0 for an internal node
+};
+
+
+
+extern "C" struct DvzSpatial
+{
+    DvzSpatialType type;
+    std::vector<float> pos; // 3 floats per position
+    bool dirty;             // whether a full rebuild is needed
+    bool refit;             // whether the BVH bounds need to be recomputed
+
+    // Grid (points).
+    float x0, y0, cw, ch;
+    uint32_t nx, ny;
+    std::vector<uint32_t> cell_start; // first item of each cell in cell_items, ncells + 1
+    std::vector<uint32_t> cell_items; // point indices sorted by cell at build time
+    std::vector<uint32_t> cur_cell;   // current cell of each point
+    std::vector<uint32_t> home_cell;  // cell of each point at build time
+    std::vector<uint32_t> moved;      // points whose current cell differs from the home cell
+    std::vector<uint8_t> is_moved;
+
+    // BVH (meshes).
+    std::vector<DvzIndex> indices;
+    std::vector<float> centroids; // 3 floats per triangle
+    std::vector<uint32_t> prims;  // triangle indices sorted by leaf
+    std::vector<DvzSpatialNode> nodes;
+    uint32_t node_count;
+};
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static uint32_t _thread_count(uint32_t n)
+{
+    if (n < SPATIAL_PARALLEL_MIN)
+        return 1;
+    uint32_t hw = std::thread::hardware_concurrency();
+    return CLIP(hw, 1u, (uint32_t)SPATIAL_MAX_THREADS);
+}
+
+
+
+// Call f(begin, end, thread_idx) on contiguous chunks of [0, n) in parallel.
+template <typename F> static void _parallel(uint32_t n, uint32_t thread_count, F f)
+{
+    if (thread_count <= 1)
+    {
+        f(0u, n, 0u);
+        return;
+    }
+    uint32_t chunk = (n + thread_count - 1) / thread_count;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < thread_count; t++)
+    {
+        uint32_t begin = MIN(t * chunk, n);
+        uint32_t end = MIN(begin + chunk, n);
+        threads.emplace_back([=, &f]() { f(begin, end, t); });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+
+
+static inline float _sq(float x) { return x * x; }
+
+
+
+static inline float _dist2(const float* a, const float* b, const float* scale)
+{
+    return _sq((a[0] - b[0]) * scale[0]) + _sq((a[1] - b[1]) * scale[1]) +
+           _sq((a[2] - b[2]) * scale[2]);
+}
+
+
+
+// Scaled squared distance between a point and an axis-aligned box.
+static inline float _box_dist2(const float* p, const float* lo, const float* hi, const float* s)
+{
+    float d = 0;
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        float e = MAX(MAX(lo[k] - p[k], p[k] - hi[k]), 0.0f);
+        d += _sq(e * s[k]);
+    }
+    return d;
+}
+
+
+
+/*************************************************************************************************/
+/*  Grid                                                                                         */
+/*************************************************************************************************/
+
+static inline uint32_t _grid_clamp(float v, float v0, float step, uint32_t n)
+{
+    float f = (v - v0) / step;
+    // NOTE: NaN positions end up in the first cell.
+    if (!(f > 0))
+        return 0;
+    if (f >= (float)n)
+        return n - 1;
+    return (uint32_t)f;
+}
+
+
+
+static inline uint32_t _grid_cell(DvzSpatial* sp, const float* p)
+{
+    uint32_t cx = _grid_clamp(p[0], sp->x0, sp->cw, sp->nx);
+    uint32_t cy = _grid_clamp(p[1], sp->y0, sp->ch, sp->ny);
+    return cy * sp->nx + cx;
+}
+
+
+
+static void _grid_build(DvzSpatial* sp)
+{
+    uint32_t n = (uint32_t)(sp->pos.size() / 3);
+    uint32_t tc = _thread_count(n);
+    const float* pos = sp->pos.data();
+
+    // Bounds of the xy positions.
+    std::vector<float> bounds(4 * tc);
+    for (uint32_t t = 0; t < tc; t++)
+    {
+        bounds[4 * t + 0] = bounds[4 * t + 1] = +INFINITY;
+        bounds[4 * t + 2] = bounds[4 * t + 3] = -INFINITY;
+    }
+    _parallel(n, tc, [&](uint32_t begin, uint32_t end, uint32_t t) {
+        float* b = &bounds[4 * t];
+        for (uint32_t i = begin; i < end; i++)
+        {
+            b[0] = MIN(b[0], pos[3 * i + 0]);
+            b[1] = MIN(b[1], pos[3 * i + 1]);
+            b[2] = MAX(b[2], pos[3 * i + 0]);
+            b[3] = MAX(b[3], pos[3 * i + 1]);
+        }
+    });
+    float xmin = +INFINITY, ymin = +INFINITY, xmax = -INFINITY, ymax = -INFINITY;
+    for (uint32_t t = 0; t < tc; t++)
+    {
+        xmin = MIN(xmin, bounds[4 * t + 0]);
+        ymin = MIN(ymin, bounds[4 * t + 1]);
+        xmax = MAX(xmax, bounds[4 * t + 2]);
+        ymax = MAX(ymax, bounds[4 * t + 3]);
+    }
+    if (!(xmin <= xmax) || !(ymin <= ymax))
+    {
+        xmin = ymin = 0;
+        xmax = ymax = 1;
+    }
+
+    // Grid shape, with roughly square cells.
+    uint32_t cells = CLIP(n / SPATIAL_POINTS_PER_CELL, 1u, (uint32_t)SPATIAL_MAX_CELLS);
+    float w = xmax - xmin, h = ymax - ymin;
+    if (w > 0 && h > 0)
+    {
+        sp->nx = CLIP((uint32_t)std::sqrt((double)cells * w / h), 1u, cells);
+        sp->ny = CLIP(cells / sp->nx, 1u, cells);
+    }
+    else
+    {
+        sp->nx = w > 0 ? cells : 1;
+        sp->ny = h > 0 ? cells : 1;
+    }
+    sp->x0 = xmin;
+    sp->y0 = ymin;
+    sp->cw = w > 0 ? w / sp->nx : 1;
+    sp->ch = h > 0 ? h / sp->ny : 1;
+    uint32_t ncells = sp->nx * sp->ny;
+
+    // Cell of each point, and cell counts.
+    sp->cur_cell.resize(n);
+    std::unique_ptr<std::atomic<uint32_t>[]> counts(new std::atomic<uint32_t>[ncells]);
+    for (uint32_t c = 0; c < ncells; c++)
+        counts[c].store(0, std::memory_order_relaxed);
+    _parallel(n, tc, [&](uint32_t begin, uint32_t end, uint32_t t) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            uint32_t c = _grid_cell(sp, &pos[3 * i]);
+            sp->cur_cell[i] = c;
+            counts[c].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // Prefix sum, then scatter the points into their cells.
+    sp->cell_start.resize(ncells + 1);
+    sp->cell_start[0] = 0;
+    for (uint32_t c = 0; c < ncells; c++)
+    {
+        sp->cell_start[c + 1] = sp->cell_start[c] + counts[c].load(std::memory_order_relaxed);
+        counts[c].store(sp->cell_start[c], std::memory_order_relaxed);
+    }
+    sp->cell_items.resize(n);
+    _parallel(n, tc, [&](uint32_t begin, uint32_t end, uint32_t t) {
+        for (uint32_t i = begin; i < end; i++)
+            sp->cell_items[counts[sp->cur_cell[i]].fetch_add(1, std::memory_order_relaxed)] = i;
+    });
+
+    sp->home_cell = sp->cur_cell;
+    sp->moved.clear();
+    sp->is_moved.assign(n, 0);
+    log_debug("built spatial grid %dx%d over %d points with %d thread(s)", sp->nx, sp->ny, n, tc);
+}
+
+
+
+static void _grid_update(DvzSpatial* sp, uint32_t first, uint32_t count)
+{
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        uint32_t c = _grid_cell(sp, &sp->pos[3 * i]);
+        sp->cur_cell[i] = c;
+        if (c != sp->home_cell[i] && !sp->is_moved[i])
+        {
+            sp->is_moved[i] = 1;
+            sp->moved.push_back(i);
+        }
+    }
+
+    uint32_t n = (uint32_t)sp->home_cell.size();
+    if (sp->moved.size() > MAX((uint32_t)SPATIAL_MIN_MOVED, n / 256))
+        sp->dirty = true;
+}
+
+
+
+// Whether a point is stored in its grid cell, otherwise it is in the moved list.
+static inline bool _grid_home(DvzSpatial* sp, uint32_t i)
+{
+    return sp->cur_cell[i] == sp->home_cell[i];
+}
+
+
+
+static bool _grid_nearest(
+    DvzSpatial* sp, const float* q, const float* s, float max_distance, uint32_t* item,
+    float* best)
+{
+    float p[3] = {q[0], q[1], 0};
+    float s2[3] = {s[0], s[1], 0};
+    const float* pos = sp->pos.data();
+    *best = _sq(max_distance);
+    bool found = false;
+
+    auto check = [&](uint32_t i) {
+        float d = _dist2(p, &pos[3 * i], s2);
+        if (d <= *best)
+        {
+            *best = d;
+            *item = i;
+            found = true;
+        }
+    };
+
+    // Points that have left their cell.
+    for (uint32_t i : sp->moved)
+        if (!_grid_home(sp, i))
+            check(i);
+
+    // Lower bound of the distance between the query and the grid.
+    float lo[3] = {sp->x0, sp->y0, 0};
+    float hi[3] = {sp->x0 + sp->cw * sp->nx, sp->y0 + sp->ch * sp->ny, 0};
+    float d0 = std::sqrt(_box_dist2(p, lo, hi, s2));
+    float step = MIN(sp->cw * s[0], sp->ch * s[1]);
+
+    // Visit the cells ring by ring around the query.
+    int32_t qx = (int32_t)_grid_clamp(p[0], sp->x0, sp->cw, sp->nx);
+    int32_t qy = (int32_t)_grid_clamp(p[1], sp->y0, sp->ch, sp->ny);
+    int32_t nx = (int32_t)sp->nx, ny = (int32_t)sp->ny;
+
+    auto visit = [&](int32_t cx, int32_t cy) {
+        if (cx < 0 || cx >= nx)
+            return;
+        uint32_t c = (uint32_t)(cy * nx + cx);
+        for (uint32_t j = sp->cell_start[c]; j < sp->cell_start[c + 1]; j++)
+        {
+            uint32_t i = sp->cell_items[j];
+            if (_grid_home(sp, i))
+                check(i);
+        }
+    };
+
+    for (int32_t k = 0;; k++)
+    {
+        float bound = MAX(d0, (k - 1) * step);
+        if (k > 0 && _sq(bound) > *best)
+            break;
+
+        for (int32_t cy = MAX(qy - k, 0); cy <= MIN(qy + k, ny - 1); cy++)
+        {
+            // Full row at the top and bottom of the ring, the two extreme cells otherwise.
+            if (cy == qy - k || cy == qy + k)
+            {
+                for (int32_t cx = MAX(qx - k, 0); cx <= MIN(qx + k, nx - 1); cx++)
+                    visit(cx, cy);
+            }
+            else
+            {
+                visit(qx - k, cy);
+                visit(qx + k, cy);
+            }
+        }
+
+        // Stop when the ring covers the whole grid.
+        if (qx - k <= 0 && qy - k <= 0 && qx + k >= nx - 1 && qy + k >= ny - 1)
+            break;
+    }
+    return found;
+}
+
+
+
+static uint32_t
+_grid_box(DvzSpatial* sp, const float* lo, const float* hi, uint32_t max_count, uint32_t* items)
+{
+    const float* pos = sp->pos.data();
+    uint32_t total = 0;
+
+    auto check = [&](uint32_t i) {
+        const float* p = &pos[3 * i];
+        if (p[0] < lo[0] || p[0] > hi[0] || p[1] < lo[1] || p[1] > hi[1])
+            return;
+        if (total < max_count)
+            items[total] = i;
+        total++;
+    };
+
+    uint32_t cx0 = _grid_clamp(lo[0], sp->x0, sp->cw, sp->nx);
+    uint32_t cx1 = _grid_clamp(hi[0], sp->x0, sp->cw, sp->nx);
+    uint32_t cy0 = _grid_clamp(lo[1], sp->y0, sp->ch, sp->ny);
+    uint32_t cy1 = _grid_clamp(hi[1], sp->y0, sp->ch, sp->ny);
+    for (uint32_t cy = cy0; cy <= cy1; cy++)
+    {
+        for (uint32_t cx = cx0; cx <= cx1; cx++)
+        {
+            uint32_t c = cy * sp->nx + cx;
+            for (uint32_t j = sp->cell_start[c]; j < sp->cell_start[c + 1]; j++)
+            {
+                uint32_t i = sp->cell_items[j];
+                if (_grid_home(sp, i))
+                    check(i);
+            }
+        }
+    }
+
+    for (uint32_t i : sp->moved)
+        if (!_grid_home(sp, i))
+            check(i);
+
+    return total;
+}
+
+
+
+/*************************************************************************************************/
+/*  BVH                                                                                          */
+/*************************************************************************************************/
+
+static inline uint32_t _tri_count(DvzSpatial* sp)
+{
+    return (uint32_t)(sp->indices.empty() ? sp->pos.size() / 9 : sp->indices.size() / 3);
+}
+
+
+
+// Return the three vertices of a triangle, or false if it has an invalid index.
+static inline bool _tri(DvzSpatial* sp, uint32_t t, const float** v)
+{
+    uint32_t n = (uint32_t)(sp->pos.size() / 3);
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        uint32_t i = sp->indices.empty() ? 3 * t + k : sp->indices[3 * t + k];
+        if (i >= n)
+            return false;
+        v[k] = &sp->pos[3 * i];
+    }
+    return true;
+}
+
+
+
+static void _tri_bounds(DvzSpatial* sp, uint32_t t, float* lo, float* hi)
+{
+    const float* v[3] = {0};
+    if (!_tri(sp, t, v))
+    {
+        lo[0] = lo[1] = lo[2] = +INFINITY;
+        hi[0] = hi[1] = hi[2] = -INFINITY;
+        return;
+    }
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        lo[k] = MIN(MIN(v[0][k], v[1][k]), v[2][k]);
+        hi[k] = MAX(MAX(v[0][k], v[1][k]), v[2][k]);
+    }
+}
+
+
+
+static void _node_bounds(DvzSpatial* sp, DvzSpatialNode* node)
+{
+    node->lo[0] = node->lo[1] = node->lo[2] = +INFINITY;
+    node->hi[0] = node->hi[1] = node->hi[2] = -INFINITY;
+    float lo[3], hi[3];
+    if (node->count > 0)
+    {
+        for (uint32_t j = node->first; j < node->first + node->count; j++)
+        {
+            _tri_bounds(sp, sp->prims[j], lo, hi);
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                node->lo[k] = MIN(node->lo[k], lo[k]);
+                node->hi[k] = MAX(node->hi[k], hi[k]);
+            }
+        }
+    }
+    else
+    {
+        for (uint32_t c = node->first; c < node->first + 2; c++)
+        {
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                node->lo[k] = MIN(node->lo[k], sp->nodes[c].lo[k]);
+                node->hi[k] = MAX(node->hi[k], sp->nodes[c].hi[k]);
+            }
+        }
+    }
+}
+
+
+
+static void _bvh_split(
+    DvzSpatial* sp, std::atomic<uint32_t>* next, uint32_t node_idx, uint32_t first,
+    uint32_t count, uint32_t depth)
+{
+    DvzSpatialNode* node = &sp->nodes[node_idx];
+    node->first = first;
+    node->count = count;
+    if (count <= SPATIAL_LEAF_SIZE)
+    {
+        _node_bounds(sp, node);
+        return;
+    }
+
+    // Split along the longest axis of the centroid bounds, at the median.
+    float lo[3] = {+INFINITY, +INFINITY, +INFINITY};
+    float hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+    for (uint32_t j = first; j < first + count; j++)
+    {
+        const float* c = &sp->centroids[3 * sp->prims[j]];
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            lo[k] = MIN(lo[k], c[k]);
+            hi[k] = MAX(hi[k], c[k]);
+        }
+    }
+    uint32_t axis = 0;
+    for (uint32_t k = 1; k < 3; k++)
+        if (hi[k] - lo[k] > hi[axis] - lo[axis])
+            axis = k;
+
+    uint32_t half = count / 2;
+    const float* centroids = sp->centroids.data();
+    std::nth_element(
+        sp->prims.begin() + first, sp->prims.begin() + first + half,
+        sp->prims.begin() + first + count, [centroids, axis](uint32_t a, uint32_t b) {
+            return centroids[3 * a + axis] < centroids[3 * b + axis];
+        });
+
+    // NOTE: children are always allocated after their parent, so that the bounds can be refit
+    // by iterating over the nodes in reverse order.
+    uint32_t left = next->fetch_add(2);
+    node->first = left;
+    node->count = 0;
+
+    // The top levels are built in parallel.
+    if (depth > 0 && count >= SPATIAL_PARALLEL_MIN / 4)
+    {
+        std::thread thread(_bvh_split, sp, next, left, first, half, depth - 1);
+        _bvh_split(sp, next, left + 1, first + half, count - half, depth - 1);
+        thread.join();
+    }
+    else
+    {
+        _bvh_split(sp, next, left, first, half, 0);
+        _bvh_split(sp, next, left + 1, first + half, count - half, 0);
+    }
+    _node_bounds(sp, &sp->nodes[node_idx]);
+}
+
+
+
+static void _bvh_centroids(DvzSpatial* sp, uint32_t tc)
+{
+    uint32_t n = _tri_count(sp);
+    sp->centroids.resize(3 * n);
+    _parallel(n, tc, [&](uint32_t begin, uint32_t end, uint32_t t) {
+        const float* v[3] = {0};
+        for (uint32_t i = begin; i < end; i++)
+        {
+            float* c = &sp->centroids[3 * i];
+            if (!_tri(sp, i, v))
+            {
+                c[0] = c[1] = c[2] = NAN;
+                continue;
+            }
+            for (uint32_t k = 0; k < 3; k++)
+                c[k] = (v[0][k] + v[1][k] + v[2][k]) / 3.0f;
+        }
+    });
+}
+
+
+
+static void _bvh_build(DvzSpatial* sp)
+{
+    uint32_t n = _tri_count(sp);
+    uint32_t tc = _thread_count(n);
+    _bvh_centroids(sp, tc);
+
+    sp->prims.resize(n);
+    for (uint32_t i = 0; i < n; i++)
+        sp->prims[i] = i;
+    sp->nodes.resize(MAX(2 * n, 1u));
+    if (n == 0)
+    {
+        sp->node_count = 0;
+        return;
+    }
+
+    uint32_t depth = 0;
+    while ((1u << depth) < tc)
+        depth++;
+    std::atomic<uint32_t> next(1);
+    _bvh_split(sp, &next, 0, 0, n, depth);
+    sp->node_count = next.load();
+    log_debug(
+        "built spatial BVH with %d nodes over %d triangles with %d thread(s)", sp->node_count, n,
+        tc);
+}
+
+
+
+static void _bvh_refit(DvzSpatial* sp)
+{
+    uint32_t n = _tri_count(sp);
+    _bvh_centroids(sp, _thread_count(n));
+    for (uint32_t i = sp->node_count; i > 0; i--)
+        _node_bounds(sp, &sp->nodes[i - 1]);
+}
+
+
+
+static inline float _dot(const float* a, const float* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+
+
+static inline void _sub(const float* a, const float* b, float* out)
+{
+    out[0] = a[0] - b[0];
+    out[1] = a[1] - b[1];
+    out[2] = a[2] - b[2];
+}
+
+
+
+static inline void _cross(const float* a, const float* b, float* out)
+{
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+
+
+static float _segment_dist2(const float* p, const float* a, const float* b)
+{
+    float ab[3], ap[3];
+    _sub(b, a, ab);
+    _sub(p, a, ap);
+    float l = _dot(ab, ab);
+    float t = l > 0 ? CLIP(_dot(ap, ab) / l, 0.0f, 1.0f) : 0.0f;
+    float d[3] = {ap[0] - t * ab[0], ap[1] - t * ab[1], ap[2] - t * ab[2]};
+    return _dot(d, d);
+}
+
+
+
+// Squared distance between a point and a triangle, all already scaled.
+static float _tri_dist2(const float* p, const float* a, const float* b, const float* c)
+{
+    float ab[3], bc[3], ca[3], n[3];
+    _sub(b, a, ab);
+    _sub(c, b, bc);
+    _sub(a, c, ca);
+    _cross(ab, bc, n);
+    float nn = _dot(n, n);
+
+    // Inside the prism of the triangle: distance to the plane.
+    if (nn > 0)
+    {
+        float ap[3], bp[3], cp[3], e[3];
+        _sub(p, a, ap);
+        _sub(p, b, bp);
+        _sub(p, c, cp);
+        _cross(ab, ap, e);
+        bool inside = _dot(e, n) >= 0;
+        _cross(bc, bp, e);
+        inside = inside && _dot(e, n) >= 0;
+        _cross(ca, cp, e);
+        inside = inside && _dot(e, n) >= 0;
+        if (inside)
+            return _sq(_dot(ap, n)) / nn;
+    }
+
+    // Otherwise, distance to the closest edge.
+    return MIN(MIN(_segment_dist2(p, a, b), _segment_dist2(p, b, c)), _segment_dist2(p, c, a));
+}
+
+
+
+static bool _bvh_nearest(
+    DvzSpatial* sp, const float* q, const float* s, float max_distance, uint32_t* item,
+    float* best)
+{
+    *best = _sq(max_distance);
+    if (sp->node_count == 0)
+        return false;
+
+    float p[3] = {q[0] * s[0], q[1] * s[1], q[2] * s[2]};
+    bool found = false;
+
+    std::vector<uint32_t> stack;
+    stack.push_back(0);
+    while (!stack.empty())
+    {
+        DvzSpatialNode* node = &sp->nodes[stack.back()];
+        stack.pop_back();
+        if (_box_dist2(q, node->lo, node->hi, s) > *best)
+            continue;
+
+        if (node->count > 0)
+        {
+            const float* v[3] = {0};
+            for (uint32_t j = node->first; j < node->first + node->count; j++)
+            {
+                uint32_t t = sp->prims[j];
+                if (!_tri(sp, t, v))
+                    continue;
+                float a[3], b[3], c[3];
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    a[k] = v[0][k] * s[k];
+                    b[k] = v[1][k] * s[k];
+                    c[k] = v[2][k] * s[k];
+                }
+                float d = _tri_dist2(p, a, b, c);
+                if (d <= *best)
+                {
+                    *best = d;
+                    *item = t;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        // Visit the closest child first.
+        uint32_t l = node->first, r = node->first + 1;
+        float dl = _box_dist2(q, sp->nodes[l].lo, sp->nodes[l].hi, s);
+        float dr = _box_dist2(q, sp->nodes[r].lo, sp->nodes[r].hi, s);
+        if (dl < dr)
+            std::swap(l, r);
+        stack.push_back(l);
+        stack.push_back(r);
+    }
+    return found;
+}
+
+
+
+static uint32_t
+_bvh_box(DvzSpatial* sp, const float* lo, const float* hi, uint32_t max_count, uint32_t* items)
+{
+    if (sp->node_count == 0)
+        return 0;
+
+    uint32_t total = 0;
+    std::vector<uint32_t> stack;
+    stack.push_back(0);
+    while (!stack.empty())
+    {
+        DvzSpatialNode* node = &sp->nodes[stack.back()];
+        stack.pop_back();
+        bool overlap = true;
+        for (uint32_t k = 0; k < 3; k++)
+            overlap = overlap && node->lo[k] <= hi[k] && node->hi[k] >= lo[k];
+        if (!overlap)
+            continue;
+
+        if (node->count == 0)
+        {
+            stack.push_back(node->first);
+            stack.push_back(node->first + 1);
+            continue;
+        }
+        for (uint32_t j = node->first; j < node->first + node->count; j++)
+        {
+            uint32_t t = sp->prims[j];
+            const float* c = &sp->centroids[3 * t];
+            bool inside = true;
+            for (uint32_t k = 0; k < 3; k++)
+                inside = inside && c[k] >= lo[k] && c[k] <= hi[k];
+            if (!inside)
+                continue;
+            if (total < max_count)
+                items[total] = t;
+            total++;
+        }
+    }
+    return total;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzSpatial* dvz_spatial(DvzSpatialType type)
+{
+    ASSERT(type == DVZ_SPATIAL_POINTS || type == DVZ_SPATIAL_MESH);
+    log_trace("create spatial index");
+    DvzSpatial* spatial = new DvzSpatial();
+    spatial->type = type;
+    spatial->dirty = true;
+    return spatial;
+}
+
+
+
+void dvz_spatial_positions(
+    DvzSpatial* spatial, uint32_t first, uint32_t count, uint32_t dims, const float* data)
+{
+    ANN(spatial);
+    ANN(data);
+    ASSERT(dims == 2 || dims == 3);
+
+    if (3 * (first + count) > spatial->pos.size())
+    {
+        spatial->pos.resize(3 * (first + count));
+        spatial->dirty = true;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float* p = &spatial->pos[3 * (first + i)];
+        p[0] = data[dims * i + 0];
+        p[1] = data[dims * i + 1];
+        p[2] = dims == 3 ? data[dims * i + 2] : 0;
+    }
+
+    // NOTE: in-place updates of an up-to-date index are patched instead of rebuilt.
+    if (spatial->dirty)
+        return;
+    if (spatial->type == DVZ_SPATIAL_POINTS)
+        _grid_update(spatial, first, count);
+    else
+        spatial->refit = true;
+}
+
+
+
+void dvz_spatial_indices(
+    DvzSpatial* spatial, uint32_t first, uint32_t count, const DvzIndex* data)
+{
+    ANN(spatial);
+    ANN(data);
+    if (spatial->type != DVZ_SPATIAL_MESH)
+    {
+        log_warn("indices are ignored by a point spatial index");
+        return;
+    }
+
+    if (first + count > spatial->indices.size())
+        spatial->indices.resize(first + count);
+    std::copy(data, data + count, spatial->indices.begin() + first);
+    spatial->dirty = true;
+}
+
+
+
+void dvz_spatial_resize(DvzSpatial* spatial, uint32_t count, uint32_t index_count)
+{
+    ANN(spatial);
+    if (spatial->pos.size() == 3 * count && spatial->indices.size() == index_count)
+        return;
+    spatial->pos.resize(3 * count);
+    if (spatial->type == DVZ_SPATIAL_MESH)
+        spatial->indices.resize(index_count);
+    spatial->dirty = true;
+}
+
+
+
+void dvz_spatial_build(DvzSpatial* spatial)
+{
+    ANN(spatial);
+    if (spatial->dirty)
+    {
+        if (spatial->type == DVZ_SPATIAL_POINTS)
+            _grid_build(spatial);
+        else
+            _bvh_build(spatial);
+        spatial->dirty = false;
+        spatial->refit = false;
+    }
+    else if (spatial->refit)
+    {
+        _bvh_refit(spatial);
+        spatial->refit = false;
+    }
+}
+
+
+
+bool dvz_spatial_nearest(
+    DvzSpatial* spatial, vec3 pos, vec3 scale, float max_distance, uint32_t* item,
+    float* distance)
+{
+    ANN(spatial);
+    ANN(item);
+    dvz_spatial_build(spatial);
+
+    float best = 0;
+    bool found = spatial->type == DVZ_SPATIAL_POINTS
+                     ? _grid_nearest(spatial, pos, scale, max_distance, item, &best)
+                     : _bvh_nearest(spatial, pos, scale, max_distance, item, &best);
+    if (found && distance != NULL)
+        *distance = std::sqrt(best);
+    return found;
+}
+
+
+
+uint32_t
+dvz_spatial_box(DvzSpatial* spatial, vec3 p0, vec3 p1, uint32_t max_count, uint32_t* items)
+{
+    ANN(spatial);
+    ASSERT(max_count == 0 || items != NULL);
+    dvz_spatial_build(spatial);
+
+    float lo[3], hi[3];
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        lo[k] = MIN(p0[k], p1[k]);
+        hi[k] = MAX(p0[k], p1[k]);
+    }
+    return spatial->type == DVZ_SPATIAL_POINTS ? _grid_box(spatial, lo, hi, max_count, items)
+                                               : _bvh_box(spatial, lo, hi, max_count, items);
+}
+
+
+
+void dvz_spatial_destroy(DvzSpatial* spatial)
+{
+    if (spatial == NULL)
+        return;
+    log_trace("destroy spatial index");
+    delete spatial;
+}
@@ -28,6 +28,376 @@
 /*  Utils                                                                                        */
 /*************************************************************************************************/
 
+// Whether the occupancy grid can be computed for a given texture format.
+static inline bool _bricks_supported(DvzFormat format)
+{
+    switch (format)
+    {
+    case DVZ_FORMAT_R8_UNORM:
+    case DVZ_FORMAT_R8_SNORM:
+    case DVZ_FORMAT_R16_UNORM:
+    case DVZ_FORMAT_R16_SNORM:
+    case DVZ_FORMAT_R32_SFLOAT:
+    case DVZ_FORMAT_R8G8B8A8_UNORM:
+    case DVZ_FORMAT_B8G8R8A8_UNORM:
+    case DVZ_FORMAT_R32G32B32A32_SFLOAT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+
+// Maximum normalized value of a row of n contiguous voxels. The red channel is used for
+// single-channel formats, the alpha channel for RGBA formats (as in the volume shader).
+static float _row_max(DvzFormat format, void* data, DvzSize idx, uint32_t n)
+{
+    ANN(data);
+    float m = 0;
+    switch (format)
+    {
+    case DVZ_FORMAT_R8_UNORM:
+    {
+        uint8_t* p = &((uint8_t*)data)[idx];
+        uint8_t v = 0;
+        for (uint32_t i = 0; i < n; i++)
+            v = MAX(v, p[i]);
+        m = v / 255.0f;
+        break;
+    }
+    case DVZ_FORMAT_R8_SNORM:
+    {
+        int8_t* p = &((int8_t*)data)[idx];
+        int8_t v = 0;
+        for (uint32_t i = 0; i < n; i++)
+            v = MAX(v, p[i]);
+        m = v / 127.0f;
+        break;
+    }
+    case DVZ_FORMAT_R16_UNORM:
+    {
+        uint16_t* p = &((uint16_t*)data)[idx];
+        uint16_t v = 0;
+        for (uint32_t i = 0; i < n; i++)
+            v = MAX(v, p[i]);
+        m = v / 65535.0f;
+        break;
+    }
+    case DVZ_FORMAT_R16_SNORM:
+    {
+        int16_t* p = &((int16_t*)data)[idx];
+        int16_t v = 0;
+        for (uint32_t i = 0; i < n; i++)
+            v = MAX(v, p[i]);
+        m = v / 32767.0f;
+        break;
+    }
+    case DVZ_FORMAT_R32_SFLOAT:
+    {
+        float* p = &((float*)data)[idx];
+        for (uint32_t i = 0; i < n; i++)
+            m = MAX(m, p[i]);
+        break;
+    }
+    case DVZ_FORMAT_R8G8B8A8_UNORM:
+    case DVZ_FORMAT_B8G8R8A8_UNORM:
+    {
+        uint8_t* p = &((uint8_t*)data)[4 * idx];
+        uint8_t v = 0;
+        for (uint32_t i = 0; i < n; i++)
+            v = MAX(v, p[4 * i + 3]);
+        m = v / 255.0f;
+        break;
+    }
+    case DVZ_FORMAT_R32G32B32A32_SFLOAT:
+    {
+        float* p = &((float*)data)[4 * idx];
+        for (uint32_t i = 0; i < n; i++)
+            m = MAX(m, p[4 * i + 3]);
+        break;
+    }
+    default:
+        m = 1;
+        break;
+    }
+    return CLIP(m, 0, 1);
+}
+
+
+
+static inline uint32_t _brick_count(DvzTexture* texture)
+{
+    ANN(texture);
+    return texture->brick_shape[0] * texture->brick_shape[1] * texture->brick_shape[2];
+}
+
+
+
+static void _bricks_init(DvzTexture* texture)
+{
+    ANN(texture);
+    if (texture->brick_max != NULL)
+        return;
+
+    const uint32_t b = DVZ_TEXTURE_BRICK_SIZE;
+    for (uint32_t i = 0; i < 3; i++)
+        texture->brick_shape[i] = (MAX(texture->shape[i], 1) + b - 1) / b;
+
+    // The content of the bricks that have not been uploaded yet is unknown, so they are occupied.
+    uint32_t count = _brick_count(texture);
+    texture->brick_max = (float*)calloc(count, sizeof(float));
+    for (uint32_t i = 0; i < count; i++)
+        texture->brick_max[i] = 1;
+}
+
+
+
+// Range [lo, hi) of the bricks intersecting a box of voxels.
+static void _bricks_range(DvzTexture* texture, uvec3 offset, uvec3 shape, uvec3 lo, uvec3 hi)
+{
+    ANN(texture);
+
+    const uint32_t b = DVZ_TEXTURE_BRICK_SIZE;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        lo[i] = MIN(offset[i] / b, texture->brick_shape[i] - 1);
+        hi[i] = MIN((offset[i] + MAX(shape[i], 1) + b - 1) / b, texture->brick_shape[i]);
+        hi[i] = MAX(hi[i], lo[i] + 1);
+    }
+}
+
+
+
+// Whether a brick is entirely covered by a box of voxels along one axis.
+static inline bool
+_brick_covered(DvzTexture* texture, uint32_t axis, uint32_t brick, uvec3 offset, uvec3 shape)
+{
+    ANN(texture);
+
+    const uint32_t b = DVZ_TEXTURE_BRICK_SIZE;
+    uint32_t start = brick * b;
+    uint32_t end = MIN(start + b, MAX(texture->shape[axis], 1));
+    return offset[axis] <= start && end <= offset[axis] + MAX(shape[axis], 1);
+}
+
+
+
+// Update the per-brick maximum with a (possibly partial) texture upload. The bricks entirely
+// covered by the upload are recomputed from the new data. For bricks that are only partially
+// covered, the new maximum is the max of the old and new values, which remains an upper bound of
+// the brick content. The range [lo, hi) of the updated bricks is returned.
+static void
+_bricks_update(DvzTexture* texture, uvec3 offset, uvec3 shape, void* data, uvec3 lo, uvec3 hi)
+{
+    ANN(texture);
+    ANN(data);
+
+    _bricks_init(texture);
+    ANN(texture->brick_max);
+    _bricks_range(texture, offset, shape, lo, hi);
+
+    uint32_t bw = texture->brick_shape[0];
+    uint32_t bh = texture->brick_shape[1];
+
+    // Unsupported formats: the bricks are left as occupied.
+    if (!_bricks_supported(texture->format))
+        return;
+
+    // Reset the fully covered bricks.
+    for (uint32_t bz = lo[2]; bz < hi[2]; bz++)
+    {
+        if (!_brick_covered(texture, 2, bz, offset, shape))
+            continue;
+        for (uint32_t by = lo[1]; by < hi[1]; by++)
+        {
+            if (!_brick_covered(texture, 1, by, offset, shape))
+                continue;
+            for (uint32_t bx = lo[0]; bx < hi[0]; bx++)
+            {
+                if (_brick_covered(texture, 0, bx, offset, shape))
+                    texture->brick_max[(bz * bh + by) * bw + bx] = 0;
+            }
+        }
+    }
+
+    const uint32_t b = DVZ_TEXTURE_BRICK_SIZE;
+    uint32_t bd = texture->brick_shape[2];
+
+    uint32_t nx = shape[0];
+    uint32_t ny = shape[1];
+    uint32_t nz = shape[2];
+
+    DvzSize idx = 0;
+    uint32_t bx = 0, by = 0, bz = 0, x = 0, n = 0;
+    float* m = NULL;
+    for (uint32_t k = 0; k < nz; k++)
+    {
+        bz = MIN((offset[2] + k) / b, bd - 1);
+        for (uint32_t j = 0; j < ny; j++)
+        {
+            by = MIN((offset[1] + j) / b, bh - 1);
+            idx = ((DvzSize)k * ny + j) * nx;
+            x = 0;
+            while (x < nx)
+            {
+                bx = MIN((offset[0] + x) / b, bw - 1);
+                // Number of voxels of the current row within the current brick.
+                n = MIN(nx - x, (bx + 1) * b - (offset[0] + x));
+                n = MAX(n, 1);
+                m = &texture->brick_max[(bz * bh + by) * bw + bx];
+                *m = MAX(*m, _row_max(texture->format, data, idx + x, n));
+                x += n;
+            }
+        }
+    }
+}
+
+
+
+// Dilate the range [lo, hi) of the occupancy grid by one brick so that the linear interpolation
+// of voxels at the border of neighboring bricks is accounted for. The output contains the dilated
+// values of the bricks in [lo, hi) only. The caller must FREE the output.
+static float* _bricks_dilate(DvzTexture* texture, uvec3 lo, uvec3 hi)
+{
+    ANN(texture);
+    ANN(texture->brick_max);
+
+    int32_t w = (int32_t)texture->brick_shape[0];
+    int32_t h = (int32_t)texture->brick_shape[1];
+    int32_t d = (int32_t)texture->brick_shape[2];
+
+    uint32_t ow = hi[0] - lo[0];
+    uint32_t oh = hi[1] - lo[1];
+    uint32_t od = hi[2] - lo[2];
+
+    float* out = (float*)calloc(ow * oh * od, sizeof(float));
+    float m = 0;
+    int32_t u = 0, v = 0, t = 0;
+    for (int32_t k = (int32_t)lo[2]; k < (int32_t)hi[2]; k++)
+    {
+        for (int32_t j = (int32_t)lo[1]; j < (int32_t)hi[1]; j++)
+        {
+            for (int32_t i = (int32_t)lo[0]; i < (int32_t)hi[0]; i++)
+            {
+                m = 0;
+                for (int32_t dk = -1; dk <= 1; dk++)
+                {
+                    t = CLIP(k + dk, 0, d - 1);
+                    for (int32_t dj = -1; dj <= 1; dj++)
+                    {
+                        v = CLIP(j + dj, 0, h - 1);
+                        for (int32_t di = -1; di <= 1; di++)
+                        {
+                            u = CLIP(i + di, 0, w - 1);
+                            m = MAX(m, texture->brick_max[(t * h + v) * w + u]);
+                        }
+                    }
+                }
+                out[((k - lo[2]) * oh + (j - lo[1])) * ow + (i - lo[0])] = m;
+            }
+        }
+    }
+    return out;
+}
+
+
+
+// Upload the occupancy of the bricks in [lo, hi), and of their neighbors which depend on them
+// through the dilation.
+static void _bricks_upload(DvzTexture* texture, uvec3 lo, uvec3 hi)
+{
+    ANN(texture);
+    if (texture->brick_tex == DVZ_ID_NONE)
+        return;
+    ANN(texture->batch);
+
+    uvec3 dlo = {0}, dhi = {0}, shape = {0};
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        dlo[i] = lo[i] > 0 ? lo[i] - 1 : 0;
+        dhi[i] = MIN(hi[i] + 1, texture->brick_shape[i]);
+        shape[i] = dhi[i] - dlo[i];
+    }
+
+    float* occupancy = _bricks_dilate(texture, dlo, dhi);
+    DvzSize size = shape[0] * shape[1] * shape[2] * sizeof(float);
+    dvz_upload_tex(texture->batch, texture->brick_tex, dlo, shape, size, occupancy, 0);
+    FREE(occupancy);
+}
+
+
+
+
+
+/*************************************************************************************************/
+/*  Streaming                                                                                    */
+/*************************************************************************************************/
+
+// Range of columns [x0, x1) of the blocks that changed in a band of rows of a streamed texture.
+static void _stream_band(DvzTexture* texture, void* data, uint32_t y, uint32_t* x0, uint32_t* x1)
+{
+    ANN(texture);
+    ANN(texture->frame);
+    ANN(data);
+
+    const uint32_t b = DVZ_TEXTURE_STREAM_BLOCK;
+    uint32_t w = texture->shape[0];
+    uint32_t h = texture->shape[1];
+    DvzSize item_size = _format_size(texture->format);
+    DvzSize row = w * item_size;
+    uint32_t y1 = MIN(y + b, h);
+
+    *x0 = w;
+    *x1 = 0;
+    uint32_t n = 0;
+    DvzSize idx = 0;
+    for (uint32_t x = 0; x < w; x += b)
+    {
+        n = MIN(b, w - x);
+        for (uint32_t j = y; j < y1; j++)
+        {
+            idx = j * row + x * item_size;
+            if (memcmp(&((uint8_t*)data)[idx], &texture->frame[idx], n * item_size) != 0)
+            {
+                *x0 = MIN(*x0, x);
+                *x1 = x + n;
+                break;
+            }
+        }
+    }
+}
+
+
+
+// Upload a rectangle of a streamed texture, and keep a copy of it for the next frame.
+static DvzSize _stream_rect(
+    DvzTexture* texture, void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    ANN(texture);
+    ANN(texture->frame);
+    ANN(data);
+
+    DvzSize item_size = _format_size(texture->format);
+    DvzSize row = texture->shape[0] * item_size;
+    DvzSize rect_row = width * item_size;
+    DvzSize size = rect_row * height;
+
+    uint8_t* rect = (uint8_t*)malloc(size);
+    DvzSize idx = 0;
+    for (uint32_t j = 0; j < height; j++)
+    {
+        idx = (y + j) * row + x * item_size;
+        memcpy(&rect[j * rect_row], &((uint8_t*)data)[idx], rect_row);
+        memcpy(&texture->frame[idx], &((uint8_t*)data)[idx], rect_row);
+    }
+
+    log_trace("stream rectangle (%d, %d, %d, %d) of texture", x, y, width, height);
+    dvz_texture_data(texture, x, y, 0, width, height, 1, size, rect);
+    FREE(rect);
+    return size;
+}
+
 
 
 /*************************************************************************************************/
@@ -100,6 +470,70 @@ void dvz_texture_data(
     uvec3 offset = {xoffset, yoffset, zoffset};
     uvec3 shape = {width, height, depth};
     dvz_upload_tex(texture->batch, texture->tex, offset, shape, size, data, 0);
+
+    // Keep the occupancy grid of volume textures up to date.
+    if (texture->dims == DVZ_TEX_3D && (texture->flags & DVZ_TEX_FLAGS_OCCUPANCY) != 0)
+    {
+        uvec3 lo = {0}, hi = {0};
+        _bricks_update(texture, offset, shape, data, lo, hi);
+        _bricks_upload(texture, lo, hi);
+    }
+}
+
+
+
+DvzSize dvz_texture_stream(DvzTexture* texture, void* data)
+{
+    ANN(texture);
+    ANN(data);
+    if (texture->dims != DVZ_TEX_2D)
+    {
+        log_error("only 2D textures can be streamed");
+        return 0;
+    }
+
+    uint32_t w = texture->shape[0];
+    uint32_t h = texture->shape[1];
+    DvzSize item_size = _format_size(texture->format);
+    DvzSize row = w * item_size;
+    ASSERT(row > 0);
+    ASSERT(h > 0);
+
+    // First frame: upload everything.
+    if (texture->frame == NULL)
+    {
+        texture->frame = (uint8_t*)malloc(row * h);
+        memcpy(texture->frame, data, row * h);
+        dvz_texture_data(texture, 0, 0, 0, w, h, 1, row * h, data);
+        return row * h;
+    }
+
+    uint32_t x0 = 0, x1 = 0;
+    DvzSize uploaded = 0;
+    for (uint32_t y = 0; y < h;)
+    {
+        _stream_band(texture, data, y, &x0, &x1);
+        if (x0 >= x1)
+        {
+            y += DVZ_TEXTURE_STREAM_BLOCK;
+            continue;
+        }
+
+        // Extend the rectangle to the next bands changed in the same columns.
+        uint32_t y1 = MIN(y + DVZ_TEXTURE_STREAM_BLOCK, h);
+        uint32_t nx0 = 0, nx1 = 0;
+        while (y1 < h)
+        {
+            _stream_band(texture, data, y1, &nx0, &nx1);
+            if (nx0 != x0 || nx1 != x1)
+                break;
+            y1 = MIN(y1 + DVZ_TEXTURE_STREAM_BLOCK, h);
+        }
+
+        uploaded += _stream_rect(texture, data, x0, y, x1 - x0, y1 - y);
+        y = y1;
+    }
+    return uploaded;
 }
 
 
@@ -124,6 +558,32 @@ void dvz_texture_create(DvzTexture* texture)
 
 
 
+void dvz_texture_occupancy(DvzTexture* texture)
+{
+    ANN(texture);
+    ANN(texture->batch);
+    ASSERT(texture->dims == DVZ_TEX_3D);
+
+    // The next uploads update the occupancy grid.
+    texture->flags |= DVZ_TEX_FLAGS_OCCUPANCY;
+    if (texture->brick_tex != DVZ_ID_NONE)
+        return;
+
+    _bricks_init(texture);
+
+    DvzRequest req = dvz_create_tex(
+        texture->batch, DVZ_TEX_3D, DVZ_FORMAT_R32_SFLOAT, texture->brick_shape, 0);
+    texture->brick_tex = req.id;
+
+    req = dvz_create_sampler(
+        texture->batch, DVZ_FILTER_NEAREST, DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+    texture->brick_sampler = req.id;
+
+    _bricks_upload(texture, DVZ_ZERO_OFFSET, texture->brick_shape);
+}
+
+
+
 DvzTexture* dvz_texture_1D(
     DvzBatch* batch, DvzFormat format, DvzFilter filter, DvzSamplerAddressMode address_mode,
     uint32_t width, void* data, int flags)
@@ -211,8 +671,16 @@ void dvz_texture_destroy(DvzTexture* texture)
         dvz_delete_tex(texture->batch, texture->tex);
         dvz_delete_sampler(texture->batch, texture->sampler);
 
+        if (texture->brick_tex != DVZ_ID_NONE)
+        {
+            dvz_delete_tex(texture->batch, texture->brick_tex);
+            dvz_delete_sampler(texture->batch, texture->brick_sampler);
+        }
+
         dvz_obj_destroyed(&texture->obj);
     }
 
+    FREE(texture->brick_max);
+    FREE(texture->frame);
     FREE(texture);
 }
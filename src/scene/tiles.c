@@ -0,0 +1,577 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Tiles                                                                                        */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/tiles.h"
+#include "../resources_utils.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "datoviz_visuals.h"
+#include "scene/box.h"
+#include "scene/panzoom.h"
+#include "scene/pool.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static void _tile_decode(DvzTiles* tiles, uint32_t tile, uint32_t* level, uint32_t* x, uint32_t* y)
+{
+    ANN(tiles);
+    ASSERT(tile < tiles->tile_count);
+
+    uint32_t l = tiles->level_count - 1;
+    while (l > 0 && tile < tiles->offsets[l])
+        l--;
+
+    uint32_t idx = tile - tiles->offsets[l];
+    *level = l;
+    *x = idx % tiles->grids[l][0];
+    *y = idx / tiles->grids[l][0];
+}
+
+
+
+static inline uint32_t _tile_parent(DvzTiles* tiles, uint32_t tile)
+{
+    ANN(tiles);
+    uint32_t level = 0, x = 0, y = 0;
+    _tile_decode(tiles, tile, &level, &x, &y);
+    ASSERT(level + 1 < tiles->level_count);
+    return dvz_tiles_index(tiles, level + 1, x / 2, y / 2);
+}
+
+
+
+// Number of valid pixels of a tile, along each axis.
+static void _tile_pixels(DvzTiles* tiles, uint32_t level, uint32_t x, uint32_t y, uvec2 out)
+{
+    ANN(tiles);
+    uint32_t t = tiles->tile_size;
+    out[0] = MIN(t, dvz_pool_level_size(tiles->shape[0], level) - x * t);
+    out[1] = MIN(t, dvz_pool_level_size(tiles->shape[1], level) - y * t);
+}
+
+
+
+// Rectangle covered by a tile, in normalized device coordinates (left, top, right, bottom).
+static void _tile_rect(DvzTiles* tiles, uint32_t level, uint32_t x, uint32_t y, dvec4 out)
+{
+    ANN(tiles);
+    double w = tiles->shape[0];
+    double h = tiles->shape[1];
+    double size = (double)((uint64_t)tiles->tile_size << level);
+    double dx = tiles->xlim[1] - tiles->xlim[0];
+    double dy = tiles->ylim[1] - tiles->ylim[0];
+
+    out[0] = tiles->xlim[0] + dx * MIN(x * size, w) / w;
+    out[2] = tiles->xlim[0] + dx * MIN((x + 1) * size, w) / w;
+    // NOTE: the first row of the image is at the top.
+    out[1] = tiles->ylim[1] - dy * MIN(y * size, h) / h;
+    out[3] = tiles->ylim[1] - dy * MIN((y + 1) * size, h) / h;
+}
+
+
+
+static int _compare_desc(const void* a, const void* b)
+{
+    uint32_t ia = *(const uint32_t*)a;
+    uint32_t ib = *(const uint32_t*)b;
+    return (ia < ib) - (ia > ib);
+}
+
+
+
+/*************************************************************************************************/
+/*  Tile cache                                                                                   */
+/*************************************************************************************************/
+
+static void _slot_upload(void* owner, uint32_t slot, uint8_t* data)
+{
+    DvzTiles* tiles = (DvzTiles*)owner;
+    ANN(tiles);
+    ANN(data);
+
+    uint32_t t = tiles->tile_size;
+    uvec3 offset = {(slot % tiles->pool[0]) * t, (slot / tiles->pool[0]) * t, 0};
+    uvec3 shape = {t, t, 1};
+    DvzSize size = (DvzSize)t * t * tiles->item_size;
+    dvz_upload_tex(tiles->batch, tiles->atlas_tex, offset, shape, size, data, 0);
+}
+
+
+
+// Mark a tile as needed at the current frame, or the finest resident tile covering it if it is
+// not resident, so that it can be displayed until the tile is loaded. Return the tile to draw,
+// or -1 if no tile covering it is resident yet.
+static int64_t _tile_touch(DvzTiles* tiles, uint32_t tile)
+{
+    ANN(tiles);
+
+    uint32_t top = tiles->offsets[tiles->level_count - 1];
+    while (true)
+    {
+        if (dvz_pool_touch(tiles->cache, tile))
+            return tile;
+        if (tile == top)
+            return -1;
+        tile = _tile_parent(tiles, tile);
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Tile loader                                                                                  */
+/*************************************************************************************************/
+
+// Called by the loader thread of the pool.
+static bool _tile_load(void* owner, uint32_t tile, uint8_t* data)
+{
+    DvzTiles* tiles = (DvzTiles*)owner;
+    ANN(tiles);
+    ANN(tiles->callback);
+
+    uint32_t level = 0, x = 0, y = 0;
+    _tile_decode(tiles, tile, &level, &x, &y);
+    tiles->callback(tiles, level, x, y, data, tiles->user_data);
+    return false;
+}
+
+
+
+/*************************************************************************************************/
+/*  Level of detail                                                                              */
+/*************************************************************************************************/
+
+// Range of tiles of a level intersecting the visible extent. Return false if the extent does not
+// intersect the image.
+static bool _tiles_range(DvzTiles* tiles, DvzBox* extent, uint32_t level, uvec4 out)
+{
+    ANN(tiles);
+    ANN(extent);
+
+    double x0 = tiles->xlim[0], x1 = tiles->xlim[1];
+    double y0 = tiles->ylim[0], y1 = tiles->ylim[1];
+    double xmin = MAX(extent->xmin, x0), xmax = MIN(extent->xmax, x1);
+    double ymin = MAX(extent->ymin, y0), ymax = MIN(extent->ymax, y1);
+    if (xmin >= xmax || ymin >= ymax)
+        return false;
+
+    // Tile size in normalized device coordinates.
+    double size = (double)((uint64_t)tiles->tile_size << level);
+    double tw = size * (x1 - x0) / tiles->shape[0];
+    double th = size * (y1 - y0) / tiles->shape[1];
+
+    uint32_t* g = tiles->grids[level];
+    out[0] = MIN((uint32_t)floor((xmin - x0) / tw), g[0] - 1);
+    out[1] = MIN((uint32_t)floor((y1 - ymax) / th), g[1] - 1);
+    out[2] = MIN((uint32_t)floor((xmax - x0) / tw), g[0] - 1);
+    out[3] = MIN((uint32_t)floor((y1 - ymin) / th), g[1] - 1);
+    return true;
+}
+
+
+
+// Request the visible tiles that are not loaded yet, the coarser tiles first so that something
+// is displayed everywhere, and the tiles closest to the center of the view first within a level.
+static void _tiles_request(DvzTiles* tiles, DvzBox* extent)
+{
+    ANN(tiles);
+    ANN(extent);
+
+    uint32_t count = tiles->visible_count;
+    DvzPoolCandidate* candidates = (DvzPoolCandidate*)calloc(count, sizeof(DvzPoolCandidate));
+    uint8_t* states = tiles->cache->states;
+
+    double cx = .5 * (extent->xmin + extent->xmax);
+    double cy = .5 * (extent->ymin + extent->ymax);
+    uint32_t top = tiles->offsets[tiles->level_count - 1];
+    uint32_t tile = 0, parent = 0, level = 0, x = 0, y = 0, nc = 0;
+    dvec4 rect = {0};
+    double dx = 0, dy = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        tile = tiles->visible[i];
+        while (tile != top)
+        {
+            parent = _tile_parent(tiles, tile);
+            if (states[parent] != DVZ_POOL_STATE_UNLOADED)
+                break;
+            tile = parent;
+        }
+        if (states[tile] != DVZ_POOL_STATE_UNLOADED)
+            continue;
+
+        _tile_decode(tiles, tile, &level, &x, &y);
+        _tile_rect(tiles, level, x, y, rect);
+        dx = .5 * (rect[0] + rect[2]) - cx;
+        dy = .5 * (rect[1] + rect[3]) - cy;
+        // NOTE: the tiles are sorted by decreasing level first, and by increasing distance
+        // within a level.
+        candidates[nc++] = (DvzPoolCandidate){sqrt(dx * dx + dy * dy) - 1e6 * level, tile};
+    }
+    dvz_pool_request(tiles->cache, nc, candidates);
+
+    FREE(candidates);
+}
+
+
+
+// Tiles to draw: the resident visible tiles, and the finest resident tile covering each visible
+// tile that is not resident yet, from the lowest to the highest resolution. Return whether the
+// list changed since the last update.
+static bool _tiles_drawn(DvzTiles* tiles)
+{
+    ANN(tiles);
+
+    uint32_t* drawn = (uint32_t*)calloc(tiles->capacity, sizeof(uint32_t));
+    uint32_t count = 0;
+    int64_t tile = 0;
+    for (uint32_t i = 0; i < tiles->visible_count; i++)
+    {
+        tile = _tile_touch(tiles, tiles->visible[i]);
+        if (tile >= 0)
+            drawn[count++] = (uint32_t)tile;
+    }
+
+    // NOTE: the coarser levels have larger tile indices.
+    qsort(drawn, count, sizeof(uint32_t), _compare_desc);
+    uint32_t m = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (m == 0 || drawn[m - 1] != drawn[i])
+            drawn[m++] = drawn[i];
+    }
+
+    bool changed =
+        m != tiles->drawn_count || memcmp(drawn, tiles->drawn, m * sizeof(uint32_t)) != 0;
+    memcpy(tiles->drawn, drawn, m * sizeof(uint32_t));
+    tiles->drawn_count = m;
+    FREE(drawn);
+    return changed;
+}
+
+
+
+// Update the items of the image visual, one per drawn tile, the unused items having a zero size.
+static void _tiles_visual(DvzTiles* tiles)
+{
+    ANN(tiles);
+    DvzVisual* visual = tiles->visual;
+    if (visual == NULL)
+        return;
+
+    uint32_t n = tiles->capacity;
+    vec3* pos = (vec3*)calloc(n, sizeof(vec3));
+    vec2* size = (vec2*)calloc(n, sizeof(vec2));
+    vec4* texcoords = (vec4*)calloc(n, sizeof(vec4));
+
+    double aw = tiles->pool[0] * tiles->tile_size;
+    double ah = tiles->pool[1] * tiles->tile_size;
+    uint32_t tile = 0, level = 0, x = 0, y = 0, slot = 0;
+    uvec2 pixels = {0};
+    dvec4 rect = {0};
+    double u = 0, v = 0;
+    for (uint32_t i = 0; i < tiles->drawn_count; i++)
+    {
+        tile = tiles->drawn[i];
+        ASSERT(tiles->cache->slots[tile] >= 0);
+        slot = (uint32_t)tiles->cache->slots[tile];
+        _tile_decode(tiles, tile, &level, &x, &y);
+        _tile_pixels(tiles, level, x, y, pixels);
+        _tile_rect(tiles, level, x, y, rect);
+
+        pos[i][0] = (float)(.5 * (rect[0] + rect[2]));
+        pos[i][1] = (float)(.5 * (rect[1] + rect[3]));
+        size[i][0] = (float)(rect[2] - rect[0]);
+        size[i][1] = (float)(rect[1] - rect[3]);
+
+        // NOTE: the texture coordinates are inset by half a texel so that the linear filtering
+        // does not bleed on the neighboring tiles of the cache.
+        u = (slot % tiles->pool[0]) * tiles->tile_size;
+        v = (slot / tiles->pool[0]) * tiles->tile_size;
+        texcoords[i][0] = (float)((u + .5) / aw);
+        texcoords[i][1] = (float)((v + .5) / ah);
+        texcoords[i][2] = (float)((u + pixels[0] - .5) / aw);
+        texcoords[i][3] = (float)((v + pixels[1] - .5) / ah);
+    }
+
+    dvz_image_position(visual, 0, n, pos, 0);
+    dvz_image_size(visual, 0, n, size, 0);
+    dvz_image_texcoords(visual, 0, n, texcoords, 0);
+
+    FREE(pos);
+    FREE(size);
+    FREE(texcoords);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzTiles* dvz_tiles(
+    DvzBatch* batch, DvzFormat format, uint32_t width, uint32_t height, uint32_t tile_size,
+    uint32_t capacity, int flags)
+{
+    ANN(batch);
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+    ASSERT(capacity > 0);
+
+    DvzTiles* tiles = (DvzTiles*)calloc(1, sizeof(DvzTiles));
+    tiles->batch = batch;
+    tiles->format = format;
+    tiles->item_size = _format_size(format);
+    ASSERT(tiles->item_size > 0);
+    tiles->shape[0] = width;
+    tiles->shape[1] = height;
+    tiles->tile_size = tile_size > 0 ? tile_size : DVZ_TILES_DEFAULT_SIZE;
+    tiles->flags = flags;
+    tiles->xlim[0] = tiles->ylim[0] = -1;
+    tiles->xlim[1] = tiles->ylim[1] = +1;
+
+    // Levels of the pyramid, until the whole image fits in a single tile.
+    uint32_t t = tiles->tile_size;
+    uint32_t level = 0;
+    uint32_t* g = NULL;
+    while (true)
+    {
+        ASSERT(level < DVZ_TILES_MAX_LEVELS);
+        g = tiles->grids[level];
+        g[0] = (dvz_pool_level_size(width, level) + t - 1) / t;
+        g[1] = (dvz_pool_level_size(height, level) + t - 1) / t;
+        tiles->offsets[level] = tiles->tile_count;
+        tiles->tile_count += g[0] * g[1];
+        if (g[0] * g[1] == 1)
+            break;
+        level++;
+    }
+    tiles->level_count = level + 1;
+
+    // Tile cache, as close as possible to a square.
+    uint32_t p = (uint32_t)ceil(sqrt((double)capacity));
+    tiles->pool[0] = p;
+    tiles->pool[1] = (capacity + p - 1) / p;
+    ASSERT(p * t <= DVZ_TILES_MAX_POOL);
+    tiles->capacity = capacity;
+
+    // Tile slots in the cache, and loader thread.
+    tiles->cache = dvz_pool(tiles->tile_count, capacity, DVZ_TILES_MAX_PENDING);
+    dvz_pool_loader(
+        tiles->cache, (DvzSize)t * t * tiles->item_size, _tile_load, _slot_upload, tiles);
+
+    tiles->visible = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+    tiles->drawn = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+
+    log_debug(
+        "create tiled image %dx%d with %d levels, %d tiles, cache of %d tiles of %dx%d", width,
+        height, tiles->level_count, tiles->tile_count, capacity, t, t);
+
+    dvz_obj_init(&tiles->obj);
+    return tiles;
+}
+
+
+
+void dvz_tiles_callback(DvzTiles* tiles, DvzTilesCallback callback, void* user_data)
+{
+    ANN(tiles);
+    ANN(callback);
+    // NOTE: the loader thread reads these fields without locking.
+    ASSERT(tiles->cache->thread == NULL);
+
+    tiles->callback = callback;
+    tiles->user_data = user_data;
+}
+
+
+
+void dvz_tiles_bounds(DvzTiles* tiles, vec2 xlim, vec2 ylim)
+{
+    ANN(tiles);
+    ASSERT(xlim[0] < xlim[1]);
+    ASSERT(ylim[0] < ylim[1]);
+
+    memcpy(tiles->xlim, xlim, sizeof(vec2));
+    memcpy(tiles->ylim, ylim, sizeof(vec2));
+    tiles->dirty = true;
+}
+
+
+
+void dvz_tiles_create(DvzTiles* tiles)
+{
+    ANN(tiles);
+    ANN(tiles->batch);
+    if (dvz_obj_is_created(&tiles->obj))
+        return;
+
+    uint32_t t = tiles->tile_size;
+    uvec3 atlas = {tiles->pool[0] * t, tiles->pool[1] * t, 1};
+
+    DvzRequest req = dvz_create_tex(tiles->batch, DVZ_TEX_2D, tiles->format, atlas, 0);
+    tiles->atlas_tex = req.id;
+
+    req = dvz_create_sampler(
+        tiles->batch, DVZ_FILTER_LINEAR, DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+    tiles->atlas_sampler = req.id;
+
+    dvz_obj_created(&tiles->obj);
+}
+
+
+
+uint32_t dvz_tiles_index(DvzTiles* tiles, uint32_t level, uint32_t x, uint32_t y)
+{
+    ANN(tiles);
+    ASSERT(level < tiles->level_count);
+
+    uint32_t* g = tiles->grids[level];
+    ASSERT(x < g[0]);
+    ASSERT(y < g[1]);
+    return tiles->offsets[level] + y * g[0] + x;
+}
+
+
+
+uint32_t dvz_tiles_select(DvzTiles* tiles, DvzBox* extent, vec2 viewport)
+{
+    ANN(tiles);
+    ANN(extent);
+    ASSERT(viewport[0] > 0);
+    ASSERT(viewport[1] > 0);
+
+    // Number of image pixels per screen pixel, at full resolution.
+    double sx = ((extent->xmax - extent->xmin) / viewport[0]) /
+                ((tiles->xlim[1] - tiles->xlim[0]) / tiles->shape[0]);
+    double sy = ((extent->ymax - extent->ymin) / viewport[1]) /
+                ((tiles->ylim[1] - tiles->ylim[0]) / tiles->shape[1]);
+    double s = MAX(sx, sy);
+
+    uint32_t top = tiles->level_count - 1;
+    uint32_t level = s > 1 ? (uint32_t)MIN(floor(log2(s)), (double)top) : 0;
+
+    // Use a coarser level if there are too many visible tiles. The budget is half the cache so
+    // that the coarser tiles displayed while loading always fit too.
+    uint32_t budget = MAX(1, (tiles->capacity - 1) / 2);
+    uvec4 range = {0};
+    uint32_t count = 0;
+    while (true)
+    {
+        count = 0;
+        if (_tiles_range(tiles, extent, level, range))
+            count = (range[2] - range[0] + 1) * (range[3] - range[1] + 1);
+        if (count <= budget || level == top)
+            break;
+        level++;
+    }
+
+    count = 0;
+    if (_tiles_range(tiles, extent, level, range))
+    {
+        for (uint32_t y = range[1]; y <= range[3]; y++)
+            for (uint32_t x = range[0]; x <= range[2]; x++)
+                tiles->visible[count++] = dvz_tiles_index(tiles, level, x, y);
+    }
+    tiles->visible_count = count;
+    tiles->level = level;
+    return level;
+}
+
+
+
+uint32_t dvz_tiles_update(DvzTiles* tiles, DvzPanzoom* pz)
+{
+    ANN(tiles);
+    ANN(pz);
+    if (tiles->callback == NULL)
+    {
+        log_warn("no callback to load the tiles from");
+        return 0;
+    }
+
+    DvzPool* cache = tiles->cache;
+    ANN(cache);
+
+    dvz_tiles_create(tiles);
+    dvz_pool_start(cache);
+    cache->frame++;
+
+    // Level and visible tiles for the current view.
+    DvzBox extent = {0};
+    dvz_panzoom_extent(pz, &extent);
+    dvz_tiles_select(tiles, &extent, pz->viewport_size);
+
+    // The visible tiles and their ancestors are needed at this frame, the other requested tiles
+    // are cancelled.
+    uint32_t top = tiles->offsets[tiles->level_count - 1];
+    uint32_t tile = 0;
+    for (uint32_t i = 0; i < tiles->visible_count; i++)
+    {
+        tile = tiles->visible[i];
+        while (cache->stamps[tile] < cache->frame)
+        {
+            cache->stamps[tile] = cache->frame;
+            if (tile == top)
+                break;
+            tile = _tile_parent(tiles, tile);
+        }
+    }
+    dvz_pool_cancel(cache);
+
+    // LRU update of the tiles drawn at this frame, before storing the new tiles in the cache.
+    for (uint32_t i = 0; i < tiles->visible_count; i++)
+        _tile_touch(tiles, tiles->visible[i]);
+    if (dvz_pool_receive(cache))
+        tiles->dirty = true;
+    _tiles_request(tiles, &extent);
+
+    // Update the visual if the new tiles replace the tiles previously drawn.
+    if (_tiles_drawn(tiles) || tiles->dirty)
+    {
+        _tiles_visual(tiles);
+        tiles->dirty = false;
+    }
+
+    return cache->pending;
+}
+
+
+
+void dvz_tiles_destroy(DvzTiles* tiles)
+{
+    ANN(tiles);
+
+    // Stop the loader thread, discarding the pending requests.
+    dvz_pool_destroy(tiles->cache);
+
+    if (dvz_obj_is_created(&tiles->obj))
+    {
+        ANN(tiles->batch);
+        log_trace("destroy tiles");
+        dvz_delete_tex(tiles->batch, tiles->atlas_tex);
+        dvz_delete_sampler(tiles->batch, tiles->atlas_sampler);
+        dvz_obj_destroyed(&tiles->obj);
+    }
+
+    FREE(tiles->visible);
+    FREE(tiles->drawn);
+    FREE(tiles);
+}
@@ -186,6 +186,10 @@ void dvz_viewset_build(DvzViewset* viewset)
         // Set the current viewport, corresponding to the current view.
         dvz_record_viewport(batch, canvas_id, view->offset, view->shape);
 
+        // NOTE: the GPU time spans are identified by the viewport dat id for the views, and by
+        // the graphics pipeline id for the visuals.
+        dvz_record_timestamp(batch, canvas_id, view->dual.dat, false);
+
         // For each visual in the view
         count = dvz_list_count(view->visuals);
         for (uint64_t j = 0; j < count; j++)
@@ -199,9 +203,21 @@ void dvz_viewset_build(DvzViewset* viewset)
                 continue;
             }
 
+            // Skip the visuals whose bounding box is entirely outside of the view.
+            visual->is_culled = dvz_visual_culled(visual);
+            if (visual->is_culled)
+            {
+                log_debug("skipping visual outside of the view");
+                continue;
+            }
+
             // Call the visual draw callback with the parameters stored in the visual.
+            dvz_record_timestamp(batch, canvas_id, visual->graphics_id, false);
             dvz_visual_record(visual, canvas_id);
+            dvz_record_timestamp(batch, canvas_id, visual->graphics_id, true);
         }
+
+        dvz_record_timestamp(batch, canvas_id, view->dual.dat, true);
     }
 
     dvz_record_end(batch, canvas_id);
@@ -267,6 +283,7 @@ void dvz_view_add(
     visual->first_instance = first_instance;
     visual->instance_count = instance_count;
     visual->view = view;
+    visual->transform = transform;
 
     dvz_list_append(view->visuals, (DvzListItem){.p = visual});
 
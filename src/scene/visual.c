@@ -21,9 +21,14 @@
 #include "fileio.h"
 #include "scene/array.h"
 #include "scene/baker.h"
+#include "scene/culling.h"
 #include "scene/dual.h"
 #include "scene/graphics.h"
+#include "scene/mvp.h"
 #include "scene/params.h"
+#include "scene/spatial.h"
+#include "scene/transform.h"
+#include "scene/viewset.h"
 
 
 
@@ -31,10 +36,129 @@
 /*  Utils                                                                                        */
 /*************************************************************************************************/
 
+// Pick ids are unique across all visuals, 0 means no visual in the pick attachment.
+static uint32_t PICK_ID = 0;
+
+
+
 static void _set_visual_dirty(DvzVisual* visual)
 {
     ANN(visual);
     dvz_atomic_set(visual->status, (int32_t)DVZ_BUILD_DIRTY);
+
+    // The bindings and params of the GPU culling must be updated after a data update.
+    if (visual->culling != NULL)
+        visual->culling->dirty = true;
+}
+
+
+
+// Set the range of items culled by the GPU culling kernel.
+static void _culling_range(DvzVisual* visual)
+{
+    ANN(visual);
+    DvzCulling* culling = visual->culling;
+    ANN(culling);
+    if (culling->p.first == visual->draw_first && culling->p.count == visual->draw_count)
+        return;
+    culling->p.first = visual->draw_first;
+    culling->p.count = visual->draw_count;
+    culling->dirty = true;
+}
+
+
+
+static void _spatial_positions(DvzVisual* visual, uint32_t first, uint32_t count, void* data)
+{
+    ANN(visual);
+    DvzFormat format = visual->attrs[0].format;
+    if (format == DVZ_FORMAT_R32G32B32_SFLOAT)
+        dvz_spatial_positions(visual->spatial, first, count, 3, (const float*)data);
+    else if (format == DVZ_FORMAT_R32G32_SFLOAT)
+        dvz_spatial_positions(visual->spatial, first, count, 2, (const float*)data);
+    else
+        log_warn("unsupported position format %d for the visual spatial index", format);
+}
+
+
+
+// Extend the bounding box of the visual with positions, separated by a given stride in bytes.
+static void _bounds_extend(DvzVisual* visual, uint32_t count, DvzSize stride, const void* data)
+{
+    ANN(visual);
+    ANN(data);
+    DvzFormat format = visual->attrs[0].format;
+    uint32_t dims = format == DVZ_FORMAT_R32G32B32_SFLOAT ? 3
+                    : format == DVZ_FORMAT_R32G32_SFLOAT  ? 2
+                                                          : 0;
+    if (dims == 0)
+    {
+        log_warn("unsupported position format %d for the visual bounding box", format);
+        return;
+    }
+
+    DvzBox* box = &visual->bounds;
+    const float* pos = NULL;
+    float z = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pos = (const float*)((const uint8_t*)data + i * stride);
+        z = dims == 3 ? pos[2] : 0;
+        if (isnan(pos[0]) || isnan(pos[1]) || isnan(z))
+            continue;
+        box->xmin = MIN(box->xmin, pos[0]);
+        box->xmax = MAX(box->xmax, pos[0]);
+        box->ymin = MIN(box->ymin, pos[1]);
+        box->ymax = MAX(box->ymax, pos[1]);
+        box->zmin = MIN(box->zmin, z);
+        box->zmax = MAX(box->zmax, z);
+    }
+}
+
+
+
+// Recompute the bounding box of the visual from the positions stored in the baker.
+static void _bounds_compute(DvzVisual* visual)
+{
+    ANN(visual);
+    ANN(visual->baker);
+    visual->bounds = dvz_box(+INFINITY, -INFINITY, +INFINITY, -INFINITY, +INFINITY, -INFINITY);
+
+    DvzBakerAttr* attr = &visual->baker->vertex_attrs[0];
+    DvzBakerVertex* binding = &visual->baker->vertex_bindings[attr->binding_idx];
+    DvzArray* array = binding->dual.array;
+    if (array == NULL || array->item_count == 0)
+        return;
+    _bounds_extend(
+        visual, array->item_count, binding->stride,
+        (const uint8_t*)dvz_array_item(array, 0) + attr->offset);
+}
+
+
+
+// Return the data position and the axis scaling corresponding to an NDC position, assuming the
+// MVP is a diagonal affine transformation in the xy plane (panzoom, ortho).
+static void _spatial_ndc(DvzMVP* mvp, vec3 ndc, vec3 pos, vec3 scale)
+{
+    ANN(mvp);
+    vec4 o = {0}, ex = {0}, ey = {0};
+    dvz_mvp_apply(mvp, (vec4){0, 0, 0, 1}, o);
+    dvz_mvp_apply(mvp, (vec4){1, 0, 0, 1}, ex);
+    dvz_mvp_apply(mvp, (vec4){0, 1, 0, 1}, ey);
+    float eps = 1e-6;
+    if (fabsf(ex[1] - o[1]) > eps || fabsf(ey[0] - o[0]) > eps || //
+        fabsf(o[3] - 1) > eps || fabsf(ex[3] - 1) > eps)
+    {
+        log_warn("the visual spatial index only supports panzoom-like MVP transformations");
+    }
+
+    float sx = ex[0] - o[0], sy = ey[1] - o[1];
+    pos[0] = sx != 0 ? (ndc[0] - o[0]) / sx : 0;
+    pos[1] = sy != 0 ? (ndc[1] - o[1]) / sy : 0;
+    pos[2] = 0;
+    scale[0] = fabsf(sx);
+    scale[1] = fabsf(sy);
+    scale[2] = 0;
 }
 
 
@@ -59,9 +183,21 @@ DvzVisual* dvz_visual(DvzBatch* batch, DvzPrimitiveTopology primitive, int flags
     visual->baker = dvz_baker(batch, flags & 0xF00000);
 
     // Create the graphics object.
-    DvzRequest req = dvz_create_graphics(batch, DVZ_GRAPHICS_CUSTOM, 0);
+    bool pick = (flags & DVZ_VISUAL_FLAGS_PICK) != 0;
+    DvzRequest req =
+        dvz_create_graphics(batch, DVZ_GRAPHICS_CUSTOM, pick ? DVZ_GRAPHICS_FLAGS_PICK : 0);
     visual->graphics_id = req.id;
     visual->is_visible = true;
+    visual->bounds_auto = true;
+
+    // Pick id, passed to the fragment shader.
+    if (pick)
+    {
+        visual->pick_id = ++PICK_ID;
+        int pick_id = (int)visual->pick_id;
+        dvz_visual_specialization(
+            visual, DVZ_SHADER_FRAGMENT, DVZ_SPECIALIZATION_PICK, sizeof(int), &pick_id);
+    }
 
     // Default fixed function pipeline states:
 
@@ -139,6 +275,12 @@ void dvz_visual_destroy(DvzVisual* visual)
         }
     }
 
+    dvz_spatial_destroy(visual->spatial);
+    dvz_culling_destroy(visual->culling);
+
+    // Destroy the baker and its vertex arrays.
+    dvz_baker_destroy(visual->baker);
+
     dvz_atomic_destroy(visual->status);
     FREE(visual);
 }
@@ -167,6 +309,12 @@ void dvz_visual_blend(DvzVisual* visual, DvzBlendType blend_type)
     ANN(batch);
 
     dvz_set_blend(batch, visual->graphics_id, blend_type);
+
+    // NOTE: the shaders that support it also write into the order-independent transparency
+    // attachments, only used on canvases created with DVZ_CANVAS_FLAGS_OIT.
+    int oit = blend_type == DVZ_BLEND_OIT;
+    dvz_visual_specialization(
+        visual, DVZ_SHADER_FRAGMENT, DVZ_SPECIALIZATION_OIT, sizeof(int), &oit);
 }
 
 
@@ -281,6 +429,28 @@ void dvz_visual_clip(DvzVisual* visual, DvzViewportClip clip)
 
 
 
+void dvz_visual_colormap(DvzVisual* visual, DvzColormap cmap, float vmin, float vmax)
+{
+    ANN(visual);
+    if ((visual->flags & DVZ_VISUAL_FLAGS_SCALAR) == 0)
+    {
+        log_error("the visual must be created with the DVZ_VISUAL_FLAGS_SCALAR flag if the "
+                  "colormap is to be used");
+        return;
+    }
+    if (visual->scalar_slot == 0)
+    {
+        log_error("this visual does not support the scalar color mode");
+        return;
+    }
+
+    // NOTE: only the small params uniform is updated, the scalar values stay on the GPU.
+    dvz_visual_param(visual, visual->scalar_slot, 0, (vec2){vmin, vmax});
+    dvz_visual_param(visual, visual->scalar_slot, 1, (int32_t[]){(int32_t)cmap});
+}
+
+
+
 /*************************************************************************************************/
 /*  Visual declaration                                                                           */
 /*************************************************************************************************/
@@ -347,6 +517,12 @@ void dvz_visual_resize(
     // Resize the baker, resize the underlying arrays, emit the dat resize commands.
     dvz_baker_resize(visual->baker, vertex_count, index_count);
 
+    if (visual->spatial != NULL)
+        dvz_spatial_resize(visual->spatial, item_count, index_count);
+
+    if (visual->culling != NULL)
+        dvz_culling_alloc(visual->culling, item_count);
+
     _set_visual_dirty(visual);
 }
 
@@ -776,6 +952,15 @@ void dvz_visual_data(
         dvz_baker_data(baker, attr_idx, first, count, data);
     }
 
+    // Spatial index of the positions.
+    if (visual->spatial != NULL && attr_idx == 0)
+        _spatial_positions(visual, first, count, data);
+
+    // Bounding box of the positions, only extended so that it remains conservative when
+    // positions are overwritten.
+    if (visual->bounds_enabled && visual->bounds_auto && attr_idx == 0)
+        _bounds_extend(visual, count, visual->attrs[0].item_size, data);
+
     _set_visual_dirty(visual);
 }
 
@@ -814,6 +999,9 @@ void dvz_visual_index(DvzVisual* visual, uint32_t first, uint32_t count, DvzInde
     log_debug("visual data for index (%d->%d)", first, count);
     dvz_baker_index(baker, first, count, data);
 
+    if (visual->spatial != NULL)
+        dvz_spatial_indices(visual->spatial, first, count, data);
+
     _set_visual_dirty(visual);
 }
 
@@ -909,6 +1097,17 @@ void dvz_visual_record(DvzVisual* visual, DvzId canvas)
     ANN(visual);
     ASSERT(visual->draw_count > 0);
 
+    // With GPU culling, the draw command is written by the culling kernel, which is dispatched
+    // in the same command buffer before the renderpass.
+    if (visual->culling != NULL)
+    {
+        _culling_range(visual);
+        dvz_culling_record(visual->culling, canvas);
+        dvz_record_draw_indexed_indirect(
+            visual->batch, canvas, visual->graphics_id, visual->culling->indirect, 1);
+        return;
+    }
+
     // Call the draw callback if there is one.
     if (visual->callback != NULL)
     {
@@ -928,6 +1127,47 @@ void dvz_visual_record(DvzVisual* visual, DvzId canvas)
 
 
 
+void dvz_visual_culling_update(DvzVisual* visual)
+{
+    ANN(visual);
+
+    DvzCulling* culling = visual->culling;
+    if (culling == NULL || !visual->is_visible)
+        return;
+    if (visual->transform == NULL || visual->view == NULL)
+    {
+        log_trace("skip the GPU culling of a visual that was not added to a view");
+        return;
+    }
+
+    // NOTE: the kernel reads the MVP and viewport dats at every frame, the params only need to
+    // be uploaded when the data or the range of items changed.
+    _culling_range(visual);
+    if (!culling->dirty)
+        return;
+    dvz_culling_bind(
+        culling, visual->transform->dual.dat, visual->view->dual.dat,
+        visual->baker->vertex_bindings[0].dual.dat);
+    dvz_culling_update(culling);
+}
+
+
+
+bool dvz_visual_culled(DvzVisual* visual)
+{
+    ANN(visual);
+    if (!visual->bounds_enabled || visual->transform == NULL || visual->view == NULL)
+        return false;
+
+    DvzMVP* mvp = dvz_transform_mvp(visual->transform);
+    DvzViewport* viewport = (DvzViewport*)dvz_array_item(visual->view->dual.array, 0);
+    ANN(mvp);
+    ANN(viewport);
+    return !dvz_box_visible(visual->bounds, mvp, viewport, visual->bounds_margin);
+}
+
+
+
 void dvz_visual_callback(DvzVisual* visual, DvzVisualCallback callback)
 {
     ANN(visual);
@@ -951,3 +1191,181 @@ void dvz_visual_show(DvzVisual* visual, bool is_visible)
     }
     visual->is_visible = is_visible;
 }
+
+
+
+uint32_t dvz_visual_pick_id(DvzVisual* visual)
+{
+    ANN(visual);
+    return visual->pick_id;
+}
+
+
+
+void dvz_visual_spatial(DvzVisual* visual, DvzSpatialType type)
+{
+    ANN(visual);
+    dvz_spatial_destroy(visual->spatial);
+    visual->spatial = type != DVZ_SPATIAL_NONE ? dvz_spatial(type) : NULL;
+}
+
+
+
+bool dvz_visual_nearest(
+    DvzVisual* visual, DvzMVP* mvp, vec3 pos, float max_distance, uint32_t* item)
+{
+    ANN(visual);
+    ANN(item);
+    if (visual->spatial == NULL)
+    {
+        log_error("the visual spatial index must be enabled with dvz_visual_spatial()");
+        return false;
+    }
+
+    vec3 query = {pos[0], pos[1], pos[2]};
+    vec3 scale = {1, 1, 1};
+    if (mvp != NULL)
+        _spatial_ndc(mvp, pos, query, scale);
+    return dvz_spatial_nearest(visual->spatial, query, scale, max_distance, item, NULL);
+}
+
+
+
+uint32_t dvz_visual_select(
+    DvzVisual* visual, DvzMVP* mvp, vec3 p0, vec3 p1, uint32_t max_count, uint32_t* items)
+{
+    ANN(visual);
+    if (visual->spatial == NULL)
+    {
+        log_error("the visual spatial index must be enabled with dvz_visual_spatial()");
+        return 0;
+    }
+
+    vec3 q0 = {p0[0], p0[1], p0[2]};
+    vec3 q1 = {p1[0], p1[1], p1[2]};
+    if (mvp != NULL)
+    {
+        vec3 scale = {0};
+        _spatial_ndc(mvp, p0, q0, scale);
+        _spatial_ndc(mvp, p1, q1, scale);
+        q0[2] = -INFINITY;
+        q1[2] = +INFINITY;
+    }
+    return dvz_spatial_box(visual->spatial, q0, q1, max_count, items);
+}
+
+
+
+void dvz_visual_culling(DvzVisual* visual, bool enabled, float margin, float min_size)
+{
+    ANN(visual);
+    DvzBatch* batch = visual->batch;
+    ANN(batch);
+    DvzBaker* baker = visual->baker;
+    ANN(baker);
+
+    if (!enabled)
+    {
+        if (visual->culling == NULL)
+            return;
+        dvz_culling_destroy(visual->culling);
+        visual->culling = NULL;
+
+        // Restore the index buffer of the visual.
+        if (baker->index.dat != DVZ_ID_NONE)
+            dvz_bind_index(batch, visual->graphics_id, baker->index.dat, 0);
+        _set_visual_dirty(visual);
+        return;
+    }
+
+    // Check that the item layout is supported.
+    if (!dvz_obj_is_created(&visual->obj) || visual->item_count == 0)
+    {
+        log_error("the visual must be allocated before enabling the GPU culling");
+        return;
+    }
+    if ((visual->flags & DVZ_VISUAL_FLAGS_INDIRECT) != 0)
+    {
+        log_error("the GPU culling is not supported for indirect visuals");
+        return;
+    }
+    DvzVisualAttr* pos = &visual->attrs[0];
+    DvzSize stride = baker->vertex_bindings[0].stride;
+    if (pos->format != DVZ_FORMAT_R32G32B32_SFLOAT || pos->binding_idx != 0 ||
+        baker->vertex_bindings[0].shared || stride % sizeof(float) != 0)
+    {
+        log_error("the GPU culling requires vec3 positions in the first vertex binding");
+        return;
+    }
+    bool indexed = baker->index.dat != DVZ_ID_NONE;
+    uint32_t vertex_count = visual->vertex_count / visual->item_count;
+    uint32_t index_count = indexed ? visual->index_count / visual->item_count : vertex_count;
+    if (vertex_count == 0 || index_count == 0 || index_count > DVZ_CULLING_MAX_INDICES)
+    {
+        log_error("the GPU culling requires the same small number of vertices for all items");
+        return;
+    }
+
+    if (visual->culling == NULL)
+        visual->culling = dvz_culling(batch);
+    DvzCulling* culling = visual->culling;
+
+    DvzCullingParams* p = &culling->p;
+    p->stride = (uint32_t)(stride / sizeof(float));
+    p->pos_offset = (uint32_t)(pos->offset / sizeof(float));
+    p->size_offset = -1;
+    if (visual->size_attr > 0)
+    {
+        DvzVisualAttr* size = &visual->attrs[visual->size_attr];
+        ASSERT(size->format == DVZ_FORMAT_R32_SFLOAT);
+        ASSERT(size->binding_idx == 0);
+        p->size_offset = (int32_t)(size->offset / sizeof(float));
+    }
+    p->vertex_count = vertex_count;
+    p->index_count = index_count;
+    p->margin = margin;
+    p->min_size = min_size;
+
+    // The vertex indices of an item, relative to its first vertex, are those of the first item.
+    for (uint32_t j = 0; j < index_count; j++)
+        p->pattern[j] = indexed ? *(DvzIndex*)dvz_array_item(baker->index.array, j) : j;
+
+    // The visual is now drawn with the compacted indices.
+    dvz_culling_alloc(culling, visual->item_count);
+    dvz_bind_index(batch, visual->graphics_id, culling->indices, 0);
+    _set_visual_dirty(visual);
+}
+
+
+
+void dvz_visual_bounds(DvzVisual* visual, bool enabled, float margin)
+{
+    ANN(visual);
+
+    // The bounding box is not maintained while the culling is disabled.
+    if (enabled && !visual->bounds_enabled && visual->bounds_auto)
+        _bounds_compute(visual);
+    visual->bounds_enabled = enabled;
+    visual->bounds_margin = margin;
+    visual->is_culled = false;
+    _set_visual_dirty(visual);
+}
+
+
+
+void dvz_visual_box(DvzVisual* visual, DvzBox* box)
+{
+    ANN(visual);
+
+    if (box != NULL)
+    {
+        visual->bounds = *box;
+        visual->bounds_auto = false;
+    }
+    else
+    {
+        visual->bounds_auto = true;
+        _bounds_compute(visual);
+    }
+    _set_visual_dirty(visual);
+}
@@ -45,7 +45,7 @@ DvzVisual* dvz_basic(DvzBatch* batch, DvzPrimitiveTopology topology, int flags)
     ANN(visual);
 
     // Visual shaders.
-    dvz_visual_shader(visual, "graphics_basic");
+    _scalar_shader(visual, "graphics_basic");
 
     // Vertex attributes.
     dvz_visual_attr(visual, 0, FIELD(DvzBasicVertex, pos), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
@@ -58,6 +58,8 @@ DvzVisual* dvz_basic(DvzBatch* batch, DvzPrimitiveTopology topology, int flags)
     // Slots.
     _common_setup(visual);
     dvz_visual_slot(visual, 2, DVZ_SLOT_DAT);
+    if ((flags & DVZ_VISUAL_FLAGS_SCALAR) != 0)
+        _scalar_setup(visual, 1, 3);
 
     // Params.
     DvzParams* params = dvz_visual_params(visual, 2, sizeof(DvzBasicParams));
@@ -102,6 +104,14 @@ void dvz_basic_color(
 
 
 
+void dvz_basic_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
+{
+    ANN(visual);
+    dvz_visual_data(visual, 1, first, count, (void*)values);
+}
+
+
+
 void dvz_basic_group(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
 {
     ANN(visual);
@@ -135,7 +145,7 @@ DvzVisual* dvz_basic_shape(DvzBatch* batch, DvzShape* shape, int flags)
 
     dvz_visual_alloc(visual, vertex_count, vertex_count, index_count);
     dvz_basic_position(visual, 0, vertex_count, shape->pos, 0);
-    if (shape->color != NULL)
+    if (shape->color != NULL && (flags & DVZ_VISUAL_FLAGS_SCALAR) == 0)
     {
         dvz_basic_color(visual, 0, vertex_count, shape->color, 0);
     }
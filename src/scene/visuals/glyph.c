@@ -53,6 +53,47 @@ static void _visual_callback(
 
 
 
+// Compute the normalized texture coordinates of glyphs in the atlas.
+static void
+_atlas_texcoords(DvzAtlasFont* af, uint32_t count, uint32_t* codepoints, vec4* texcoords)
+{
+    ANN(af);
+    ANN(af->atlas);
+    ANN(codepoints);
+    ANN(texcoords);
+    ASSERT(count > 0);
+
+    // Dynamic atlas: generate the missing glyphs and upload them before computing the texture
+    // coordinates, which depend on the atlas shape if it had to grow.
+    if (dvz_atlas_is_dynamic(af->atlas) && dvz_atlas_insert(af->atlas, count, codepoints) > 0)
+        dvz_atlas_upload(af->atlas);
+
+    uvec3 shape = {0};
+    dvz_atlas_shape(af->atlas, shape);
+    float w = shape[0];
+    float h = shape[1];
+
+    dvz_atlas_glyphs(af->atlas, count, codepoints, texcoords);
+
+    // HACK: remove the padding around the glyphs in the atlas, because the freetype
+    // positioning implementation assumes no padding, whereas the atlas requires them to
+    // prevent edge effects in the fragment shader.
+    float padw = 1.25;
+    float padh = 1.5;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // Now, we need to divide the texcoords (in pixels) by the atlas shape, to get uv
+        // normalized coordinates.
+        texcoords[i][0] = (texcoords[i][0] + padw) / w;
+        texcoords[i][1] = (texcoords[i][1] + padh) / h;
+        texcoords[i][2] = (texcoords[i][2] - 2 * padw) / w;
+        texcoords[i][3] = (texcoords[i][3] - 2 * padh) / h;
+    }
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -95,6 +136,7 @@ DvzVisual* dvz_glyph(DvzBatch* batch, int flags)
     DvzParams* params = dvz_visual_params(visual, 2, sizeof(DvzGlyphParams));
     dvz_params_attr(params, 0, FIELD(DvzGlyphParams, size));
     dvz_params_attr(params, 1, FIELD(DvzGlyphParams, bgcolor));
+    dvz_params_attr(params, 2, FIELD(DvzGlyphParams, pixel_texcoords));
 
     // Default texture to avoid Vulkan warning with unbound texture slot.
     dvz_visual_tex(
@@ -182,14 +224,27 @@ void dvz_glyph_texcoords(
     ANN(visual);
     // coords is u0,v0,w,h ; need to upload 4 vec2 corresponding to each corner
 
+    // With an atlas font, the texture coordinates are converted to pixels with the current atlas
+    // shape: they then remain valid when a dynamic atlas grows, even for the glyphs of the other
+    // visuals sharing the atlas.
+    float w = 1, h = 1;
+    DvzAtlasFont* af = (DvzAtlasFont*)visual->user_data;
+    if (af != NULL && af->atlas != NULL)
+    {
+        uvec3 shape = {0};
+        dvz_atlas_shape(af->atlas, shape);
+        w = shape[0];
+        h = shape[1];
+    }
+
     vec2* uv = (vec2*)calloc(4 * count, sizeof(vec2));
     float u0, v0, u1, v1; // top left, bottom right
     for (uint32_t i = 0; i < count; i++)
     {
-        u0 = coords[i][0];
-        v0 = coords[i][1];
-        u1 = u0 + coords[i][2];
-        v1 = v0 + coords[i][3];
+        u0 = coords[i][0] * w;
+        v0 = coords[i][1] * h;
+        u1 = u0 + coords[i][2] * w;
+        v1 = v0 + coords[i][3] * h;
         // log_error("%.3f %.3f %.3f %.3f", u0, v0, u1, v1);
         // ASSERT(u0 <= u1);
         // ASSERT(v0 <= v1);
@@ -292,6 +347,10 @@ void dvz_glyph_atlas_font(DvzVisual* visual, DvzAtlasFont* af)
 
     // Bind the texture to the glyph visual.
     dvz_glyph_texture(visual, texture);
+
+    // The texture coordinates are now stored in pixels, see dvz_glyph_texcoords().
+    int pixel_texcoords = 1;
+    dvz_visual_param(visual, 2, 2, &pixel_texcoords);
 }
 
 
@@ -311,32 +370,9 @@ void dvz_glyph_unicode(DvzVisual* visual, uint32_t count, uint32_t* codepoints)
     ANN(af);
     ANN(af->atlas);
 
-    uvec3 shape = {0};
-    dvz_atlas_shape(af->atlas, shape);
-    float w = shape[0];
-    float h = shape[1];
-
     vec4* texcoords = (vec4*)calloc(count, sizeof(vec4));
-    dvz_atlas_glyphs(af->atlas, count, codepoints, texcoords);
-
-    // HACK: remove the padding around the glyphs in the atlas, because the freetype
-    // positioning implementation assumes no padding, whereas the atlas requires them to
-    // prevent edge effects in the fragment shader.
-    float padw = 1.25;
-    float padh = 1.5;
-
-    for (uint32_t i = 0; i < count; i++)
-    {
-        // Now, we need to divide the texcoords (in pixels) by the atlas shape, to get uv
-        // normalized coordinates.
-        texcoords[i][0] = (texcoords[i][0] + padw) / w;
-        texcoords[i][1] = (texcoords[i][1] + padh) / h;
-        texcoords[i][2] = (texcoords[i][2] - 2 * padw) / w;
-        texcoords[i][3] = (texcoords[i][3] - 2 * padh) / h;
-    }
-
+    _atlas_texcoords(af, count, codepoints, texcoords);
     dvz_glyph_texcoords(visual, 0, count, texcoords, 0);
-
     FREE(texcoords);
 }
 
@@ -648,3 +684,96 @@ void dvz_glyph_strings(
     FREE(string_offsets);
     FREE(string_sizes);
 }
+
+
+
+void dvz_glyph_layout(DvzVisual* visual, const char* string, vec4* out_xywh, vec4* out_texcoords)
+{
+    ANN(visual);
+    ANN(string);
+    ANN(out_xywh);
+    ANN(out_texcoords);
+
+    DvzAtlasFont* af = (DvzAtlasFont*)visual->user_data;
+    if (af == NULL)
+    {
+        log_error("please call dvz_glyph_atlas_font() first");
+        return;
+    }
+    ANN(af);
+
+    uint32_t count = strnlen(string, 4096);
+    if (count == 0)
+        return;
+
+    // Glyph boxes, relative to the origin of the string as in dvz_glyph_strings().
+    dvz_font_ascii(af->font, string, out_xywh);
+    float x0 = out_xywh[0][0];
+    for (uint32_t i = 0; i < count; i++)
+        out_xywh[i][0] -= x0;
+
+    uint32_t* codepoints = (uint32_t*)calloc(count, sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++)
+        codepoints[i] = (uint32_t)string[i];
+    _atlas_texcoords(af, count, codepoints, out_texcoords);
+    FREE(codepoints);
+}
+
+
+
+void dvz_glyph_range(
+    DvzVisual* glyph, uint32_t first, uint32_t capacity, uint32_t count, vec4* xywh,
+    vec4* texcoords, vec3 position, DvzColor color, vec2 offset, vec2 anchor)
+{
+    ANN(glyph);
+    ASSERT(capacity > 0);
+    ASSERT(count <= capacity);
+    ASSERT(count == 0 || (xywh != NULL && texcoords != NULL));
+
+    vec3* pos = (vec3*)calloc(capacity, sizeof(vec3));
+    vec2* size = (vec2*)calloc(capacity, sizeof(vec2));
+    vec2* shift = (vec2*)calloc(capacity, sizeof(vec2));
+    vec2* anchors = (vec2*)calloc(capacity, sizeof(vec2));
+    vec2* group_shape = (vec2*)calloc(capacity, sizeof(vec2));
+    vec4* uv = (vec4*)calloc(capacity, sizeof(vec4));
+    DvzColor* colors = (DvzColor*)calloc(capacity, sizeof(DvzColor));
+
+    // Width of the string: offset of the last glyph + its width, height: max of the heights.
+    vec2 shape = {0};
+    if (count > 0)
+        shape[0] = xywh[count - 1][0] + xywh[count - 1][2];
+    for (uint32_t i = 0; i < count; i++)
+        shape[1] = MAX(shape[1], xywh[i][3]);
+
+    // NOTE: the glyphs after count are hidden with a zero size and a transparent color.
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        glm_vec3_copy(position, pos[i]);
+        glm_vec2_copy(anchor, anchors[i]);
+        glm_vec2_copy(shape, group_shape[i]);
+        if (i >= count)
+            continue;
+        size[i][0] = xywh[i][2];
+        size[i][1] = xywh[i][3];
+        shift[i][0] = xywh[i][0] + offset[0];
+        shift[i][1] = xywh[i][1] + offset[1];
+        glm_vec4_copy(texcoords[i], uv[i]);
+        memcpy(colors[i], color, sizeof(DvzColor));
+    }
+
+    dvz_glyph_position(glyph, first, capacity, pos, 0);
+    dvz_glyph_size(glyph, first, capacity, size, 0);
+    dvz_glyph_shift(glyph, first, capacity, shift, 0);
+    dvz_glyph_anchor(glyph, first, capacity, anchors, 0);
+    dvz_glyph_group_size(glyph, first, capacity, group_shape, 0);
+    dvz_glyph_texcoords(glyph, first, capacity, uv, 0);
+    dvz_glyph_color(glyph, first, capacity, colors, 0);
+
+    FREE(pos);
+    FREE(size);
+    FREE(shift);
+    FREE(anchors);
+    FREE(group_shape);
+    FREE(uv);
+    FREE(colors);
+}
@@ -23,6 +23,7 @@
 #include "fileio.h"
 #include "scene/graphics.h"
 #include "scene/texture.h"
+#include "scene/tiles.h"
 #include "scene/viewset.h"
 #include "scene/visual.h"
 
@@ -257,3 +258,33 @@ void dvz_image_texture(DvzVisual* visual, DvzTexture* texture)
     dvz_texture_create(texture); // only create it if it is not already created
     dvz_visual_tex(visual, 3, texture->tex, texture->sampler, DVZ_ZERO_OFFSET);
 }
+
+
+
+void dvz_image_tiles(DvzVisual* visual, DvzTiles* tiles)
+{
+    ANN(visual);
+    ANN(tiles);
+    int flags = DVZ_IMAGE_FLAGS_SIZE_NDC | DVZ_IMAGE_FLAGS_RESCALE;
+    if ((visual->flags & flags) != flags)
+    {
+        log_warn("The image visual must be created with the DVZ_IMAGE_FLAGS_SIZE_NDC and "
+                 "DVZ_IMAGE_FLAGS_RESCALE flags to display tiles");
+        return;
+    }
+
+    // One item per slot of the tile cache, the unused items having a zero size.
+    uint32_t n = tiles->capacity;
+    dvz_image_alloc(visual, n);
+
+    vec2* zeros = (vec2*)calloc(n, sizeof(vec2));
+    dvz_image_size(visual, 0, n, zeros, 0);
+    dvz_image_anchor(visual, 0, n, zeros, 0);
+    FREE(zeros);
+
+    dvz_tiles_create(tiles); // only create it if it is not already created
+    dvz_visual_tex(visual, 3, tiles->atlas_tex, tiles->atlas_sampler, DVZ_ZERO_OFFSET);
+
+    tiles->visual = visual;
+    tiles->dirty = true;
+}
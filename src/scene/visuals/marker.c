@@ -51,7 +51,7 @@ DvzVisual* dvz_marker(DvzBatch* batch, int flags)
     ANN(visual);
 
     // Visual shaders.
-    dvz_visual_shader(visual, "graphics_marker");
+    _scalar_shader(visual, "graphics_marker");
 
     // Vertex attributes.
     dvz_visual_attr(visual, 0, FIELD(DvzMarkerVertex, pos), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
@@ -62,10 +62,15 @@ DvzVisual* dvz_marker(DvzBatch* batch, int flags)
     // Vertex stride.
     dvz_visual_stride(visual, 0, sizeof(DvzMarkerVertex));
 
+    // Size in pixels, used by the GPU culling.
+    visual->size_attr = 1;
+
     // Uniforms.
     _common_setup(visual);
     dvz_visual_slot(visual, 2, DVZ_SLOT_DAT);
     dvz_visual_slot(visual, 3, DVZ_SLOT_TEX);
+    if ((flags & DVZ_VISUAL_FLAGS_SCALAR) != 0)
+        _scalar_setup(visual, 3, 4);
 
     // Params.
     DvzParams* params = dvz_visual_params(visual, 2, sizeof(DvzMarkerParams));
@@ -165,6 +170,14 @@ void dvz_marker_color(
 
 
 
+void dvz_marker_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
+{
+    ANN(visual);
+    dvz_visual_data(visual, 3, first, count, (void*)values);
+}
+
+
+
 void dvz_marker_edgecolor(DvzVisual* visual, DvzColor color)
 {
     ANN(visual);
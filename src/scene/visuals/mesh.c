@@ -42,6 +42,7 @@
 #define MESH_SLOT_MATERIAL 3
 #define MESH_SLOT_CONTOUR  4
 #define MESH_SLOT_TEX      5
+#define MESH_SLOT_SCALAR   6
 
 
 
@@ -97,8 +98,15 @@ DvzVisual* dvz_mesh(DvzBatch* batch, int flags)
     log_trace("create mesh visual, texture: %d, lighting: %d, contour: %d, isoline: %d",
               textured, lighting, contour, isoline);
 
+    // Scalar color mode, only for color meshes.
+    if (textured && (flags & DVZ_VISUAL_FLAGS_SCALAR))
+    {
+        log_warn("the scalar color mode is not supported with textured meshes");
+        visual->flags &= ~DVZ_VISUAL_FLAGS_SCALAR;
+    }
+
     // Visual shaders.
-    dvz_visual_shader(visual, "graphics_mesh");
+    _scalar_shader(visual, "graphics_mesh");
 
     // Enable depth test.
     dvz_visual_depth(visual, DVZ_DEPTH_TEST_ENABLE);
@@ -163,6 +171,9 @@ DvzVisual* dvz_mesh(DvzBatch* batch, int flags)
     dvz_visual_slot(visual, MESH_SLOT_CONTOUR, DVZ_SLOT_DAT);
     dvz_visual_slot(visual, MESH_SLOT_TEX, DVZ_SLOT_TEX);
 
+    if ((visual->flags & DVZ_VISUAL_FLAGS_SCALAR) != 0)
+        _scalar_setup(visual, 2, MESH_SLOT_SCALAR);
+
     // Lights.
     DvzParams* light_params = dvz_visual_params(visual, MESH_SLOT_LIGHT, sizeof(DvzMeshLight));
     dvz_params_attr(light_params, DVZ_LIGHT_PARAMS_POS, FIELD(DvzMeshLight, pos));
@@ -279,6 +290,19 @@ void dvz_mesh_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor*
 
 
 
+void dvz_mesh_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
+{
+    ANN(visual);
+    if (visual->flags & DVZ_MESH_FLAGS_TEXTURED)
+    {
+        log_error("cannot use dvz_mesh_scalar() with a textured mesh");
+        return;
+    }
+    dvz_visual_data(visual, 2, first, count, (void*)values);
+}
+
+
+
 void dvz_mesh_texcoords(DvzVisual* visual, uint32_t first, uint32_t count, vec4* values, int flags)
 {
     ANN(visual);
@@ -498,7 +522,7 @@ void dvz_mesh_reshape(DvzVisual* visual, DvzShape* shape)
         dvz_mesh_normal(visual, 0, vertex_count, shape->normal, 0);
     }
 
-    if (shape->color && !(visual->flags & DVZ_MESH_FLAGS_TEXTURED))
+    if (shape->color && !(visual->flags & (DVZ_MESH_FLAGS_TEXTURED | DVZ_VISUAL_FLAGS_SCALAR)))
     {
         dvz_mesh_color(visual, 0, vertex_count, shape->color, 0);
     }
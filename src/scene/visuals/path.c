@@ -20,6 +20,7 @@
 #include "datoviz_types.h"
 #include "fileio.h"
 #include "scene/graphics.h"
+#include "scene/kernels.h"
 #include "scene/viewset.h"
 #include "scene/visual.h"
 
@@ -94,7 +95,7 @@ DvzVisual* dvz_path(DvzBatch* batch, int flags)
     ANN(visual);
 
     // Visual shaders.
-    dvz_visual_shader(visual, "graphics_path");
+    _scalar_shader(visual, "graphics_path");
 
     // Vertex stride.
     dvz_visual_stride(visual, 0, sizeof(DvzPathVertex));
@@ -112,6 +113,8 @@ DvzVisual* dvz_path(DvzBatch* batch, int flags)
     // Uniforms.
     _common_setup(visual);
     dvz_visual_slot(visual, 2, DVZ_SLOT_DAT);
+    if ((flags & DVZ_VISUAL_FLAGS_SCALAR) != 0)
+        _scalar_setup(visual, 4, 3);
 
     // Visual draw callback.
     dvz_visual_callback(visual, _visual_callback);
@@ -168,58 +171,16 @@ void dvz_path_position(
 
     // Compute the total number of vertices, which is the sum of all path lengths.
     uint32_t total_length = 0;
-    int32_t l = 0;
     for (uint32_t i = 0; i < path_count; i++)
-    {
-        l = (int32_t)path_lengths[i];
-        total_length += (uint32_t)l;
-    }
+        total_length += path_lengths[i];
 
-    uint32_t k = 0;
-    uint32_t src_offset = 0;
-    int32_t i0 = 0, i1 = 0, i2 = 0, i3 = 0;
+    // Expand each point into its four neighbours, see also the kernel_path GPU kernel.
     vec3* p0 = (vec3*)calloc(total_length, sizeof(vec3));
     vec3* p1 = (vec3*)calloc(total_length, sizeof(vec3));
     vec3* p2 = (vec3*)calloc(total_length, sizeof(vec3));
     vec3* p3 = (vec3*)calloc(total_length, sizeof(vec3));
-    for (uint32_t j = 0; j < path_count; j++)
-    {
-        l = (int32_t)path_lengths[j];
-        for (int32_t i = 0; i < l; i++)
-        {
-            i0 = i - 1;
-            i1 = i + 0;
-            i2 = i + 1;
-            i3 = i + 2;
-
-            if (!closed)
-            {
-                i0 = MAX(i0, 0);
-                i2 = MIN(i2, l - 1);
-                i3 = MIN(i3, l - 1);
-            }
-            else
-            {
-                i0 = i0 < 0 ? i0 + l : i0;
-                i2 = i2 >= l ? i2 - l : i2;
-                i3 = i3 >= l ? i3 - l : i3;
-            }
-
-            ASSERT(0 <= i0 && i0 < l);
-            ASSERT(0 <= i1 && i1 < l);
-            ASSERT(0 <= i2 && i2 < l);
-            ASSERT(0 <= i3 && i3 < l);
-
-            _vec3_copy(positions[src_offset + (uint32_t)i0], p0[k]);
-            _vec3_copy(positions[src_offset + (uint32_t)i1], p1[k]);
-            _vec3_copy(positions[src_offset + (uint32_t)i2], p2[k]);
-            _vec3_copy(positions[src_offset + (uint32_t)i3], p3[k]);
-
-            k++;
-        }
-        src_offset += (uint32_t)l;
-    }
-    ASSERT(k == total_length);
+    dvz_kernel_path(
+        total_length, (const vec3*)positions, path_count, path_lengths, closed, p0, p1, p2, p3);
 
     // NOTE: we did not use REPEAT attr flag for position as we do the repeat manually with a
     // shift.
@@ -246,6 +207,16 @@ void dvz_path_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor*
 
 
 
+void dvz_path_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
+{
+    ANN(visual);
+    void* reps = repeat_and_shift(sizeof(float), count, values);
+    dvz_visual_data(visual, 4, 4 * first, 4 * count, (void*)reps);
+    FREE(reps);
+}
+
+
+
 void dvz_path_linewidth(
     DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
 {
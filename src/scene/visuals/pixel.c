@@ -67,6 +67,13 @@ void dvz_pixel_color(DvzVisual* pixel, uint32_t first, uint32_t count, DvzColor*
 
 
 
+void dvz_pixel_scalar(DvzVisual* pixel, uint32_t first, uint32_t count, float* values, int flags)
+{
+    dvz_basic_scalar(pixel, first, count, values, flags);
+}
+
+
+
 void dvz_pixel_size(DvzVisual* pixel, float size)
 {
     dvz_basic_size(pixel, size); //
@@ -49,7 +49,7 @@ DvzVisual* dvz_point(DvzBatch* batch, int flags)
     ANN(visual);
 
     // Visual shaders.
-    dvz_visual_shader(visual, "graphics_point");
+    _scalar_shader(visual, "graphics_point");
 
     // Vertex attributes.
     dvz_visual_attr(visual, 0, FIELD(DvzPointVertex, pos), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
@@ -61,6 +61,8 @@ DvzVisual* dvz_point(DvzBatch* batch, int flags)
 
     // Uniforms.
     _common_setup(visual);
+    if ((flags & DVZ_VISUAL_FLAGS_SCALAR) != 0)
+        _scalar_setup(visual, 2, 2);
 
     return visual;
 }
@@ -103,3 +105,11 @@ void dvz_point_color(
     ANN(visual);
     dvz_visual_data(visual, 2, first, count, (void*)values);
 }
+
+
+
+void dvz_point_scalar(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
+{
+    ANN(visual);
+    dvz_visual_data(visual, 2, first, count, (void*)values);
+}
@@ -97,6 +97,10 @@ DvzVisual* dvz_sphere(DvzBatch* batch, int flags)
     // Vertex stride.
     dvz_visual_stride(visual, 0, sizeof(DvzSphereVertex));
 
+    // Size in pixels, used by the GPU culling (otherwise, the size is in data units).
+    if (size_pixels)
+        visual->size_attr = 2;
+
     // Slots.
     _common_setup(visual);
     dvz_visual_slot(visual, SPHERE_SLOT_LIGHT, DVZ_SLOT_DAT);
@@ -20,6 +20,7 @@
 #include "datoviz_protocol.h"
 #include "datoviz_types.h"
 #include "fileio.h"
+#include "scene/bricks.h"
 #include "scene/graphics.h"
 #include "scene/texture.h"
 #include "scene/viewset.h"
@@ -72,6 +73,7 @@ DvzVisual* dvz_volume(DvzBatch* batch, int flags)
     _common_setup(visual);
     dvz_visual_slot(visual, 2, DVZ_SLOT_DAT);
     dvz_visual_slot(visual, 3, DVZ_SLOT_TEX);
+    dvz_visual_slot(visual, 4, DVZ_SLOT_TEX); // brick occupancy, or indirection if bricked
 
     // Params.
     DvzParams* params = dvz_visual_params(visual, 2, sizeof(DvzVolumeParams));
@@ -83,6 +85,8 @@ DvzVisual* dvz_volume(DvzBatch* batch, int flags)
     dvz_params_attr(params, 4, FIELD(DvzVolumeParams, uvw1));
     dvz_params_attr(params, 5, FIELD(DvzVolumeParams, transfer));
     dvz_params_attr(params, 6, FIELD(DvzVolumeParams, permutation));
+    dvz_params_attr(params, 7, FIELD(DvzVolumeParams, raymarch));
+    dvz_params_attr(params, 8, FIELD(DvzVolumeParams, bricks));
 
     float v = .5;
     dvz_visual_param(visual, 2, 0, (vec2){-v, +v});       // xlim
@@ -92,6 +96,10 @@ DvzVisual* dvz_volume(DvzBatch* batch, int flags)
     dvz_visual_param(visual, 2, 4, (vec4){1, 1, 1, 0});   // uvw1
     dvz_visual_param(visual, 2, 5, (vec4){1, 0, 0, 0});   // transfer
     dvz_visual_param(visual, 2, 6, (ivec4){0, 1, 2, -1}); // permutation
+    dvz_visual_param(
+        visual, 2, 7,
+        (vec4){VOLUME_DEFAULT_STEP, VOLUME_DEFAULT_TERMINATION, VOLUME_DEFAULT_EMPTY, 0});
+    dvz_visual_param(visual, 2, 8, (ivec4){0, 0, 0, 0}); // bricks
 
     // Visual draw callback.
     dvz_visual_callback(visual, _visual_callback);
@@ -108,6 +116,32 @@ void dvz_volume_texture(DvzVisual* visual, DvzTexture* texture)
 
     dvz_texture_create(texture); // only create it if it is not already created
     dvz_visual_tex(visual, 3, texture->tex, texture->sampler, DVZ_ZERO_OFFSET);
+
+    // Brick occupancy grid, computed on the CPU when the volume data is uploaded (from now on,
+    // or from the creation of the texture with DVZ_TEX_FLAGS_OCCUPANCY), and used by the shader
+    // to skip empty bricks.
+    dvz_texture_occupancy(texture);
+    dvz_visual_tex(visual, 4, texture->brick_tex, texture->brick_sampler, DVZ_ZERO_OFFSET);
+}
+
+
+
+void dvz_volume_bricks(DvzVisual* visual, DvzBricks* bricks)
+{
+    ANN(visual);
+    ANN(bricks);
+    ASSERT((visual->flags & DVZ_VOLUME_FLAGS_BRICKED) != 0);
+
+    // The brick pool replaces the 3D texture, and the indirection table the occupancy grid.
+    dvz_bricks_create(bricks);
+    dvz_visual_tex(visual, 3, bricks->atlas_tex, bricks->atlas_sampler, DVZ_ZERO_OFFSET);
+    dvz_visual_tex(
+        visual, 4, bricks->indirection_tex, bricks->indirection_sampler, DVZ_ZERO_OFFSET);
+
+    ivec4 params = {
+        (int)bricks->shape[0], (int)bricks->shape[1], (int)bricks->shape[2],
+        (int)bricks->brick_size};
+    dvz_visual_param(visual, 2, 8, params);
 }
 
 
@@ -211,6 +245,27 @@ void dvz_volume_transfer(DvzVisual* visual, vec4 transfer)
 
 
 
+void dvz_volume_step(DvzVisual* visual, float step)
+{
+    ANN(visual);
+    ASSERT(step > 0);
+
+    float* p = _get_param(visual, 2, 7);
+    dvz_visual_param(visual, 2, 7, (vec4){step, p[1], p[2], p[3]});
+}
+
+
+
+void dvz_volume_threshold(DvzVisual* visual, float termination, float empty)
+{
+    ANN(visual);
+
+    float* p = _get_param(visual, 2, 7);
+    dvz_visual_param(visual, 2, 7, (vec4){p[0], termination, empty, p[3]});
+}
+
+
+
 void dvz_volume_permutation(DvzVisual* visual, ivec3 ijk)
 {
     ANN(visual);
@@ -125,7 +125,8 @@ uint8_t* dvz_server_grab(DvzServer* server, DvzId canvas_id, int flags)
     ANN(canvas);
     ASSERT(dvz_obj_is_created(&canvas->obj));
 
-    // Trigger an update.
+    // Trigger an update, after processing the pending asynchronous tex uploads.
+    dvz_transfers_flush(&rd->ctx->transfers);
     dvz_cmd_submit_sync(&canvas->cmds, DVZ_DEFAULT_QUEUE_RENDER);
 
     // Grab the image.
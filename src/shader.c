@@ -14,12 +14,21 @@
 /*************************************************************************************************/
 
 #include "shader.h"
+#include "_handle.h"
+#include "_hash.h"
+#include "_map.h"
 #include "_pointer.h"
+#include "_thread_utils.h"
+#include "datoviz_math.h"
+#include "fileio.h"
+#include "host.h"
 #include "vklite.h"
 
 #define BEGIN_IGNORE_STRICT_PROTOTYPES _Pragma("GCC diagnostic ignored \"-Wstrict-prototypes\"")
 #define END_IGNORE_STRICT_PROTOTYPES   _Pragma("GCC diagnostic pop")
 
+#include <sys/stat.h>
+
 #if HAS_SHADERC
 #include <shaderc/shaderc.h>
 #endif
@@ -27,19 +36,265 @@
 
 
 /*************************************************************************************************/
-/*  Compilation                                                                                  */
+/*  Constants                                                                                    */
 /*************************************************************************************************/
 
-VkShaderModule dvz_compile_glsl(DvzGpu* gpu, const char* code, VkShaderStageFlagBits stage)
+#define SPIRV_MAGIC 0x07230203
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzSpirv DvzSpirv;
+typedef struct DvzCompileBatch DvzCompileBatch;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzSpirv
+{
+    uint64_t hash;
+    DvzSize size;
+    uint32_t* code;
+};
+
+
+
+struct DvzCompileBatch
+{
+    DvzCompiler* compiler;
+    uint32_t count;
+    const char** codes;
+    VkShaderStageFlagBits* stages;
+    uint32_t next; // index of the next shader to compile, protected by the compiler lock
+};
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static uint64_t _spirv_hash(DvzCompiler* compiler, const char* code, VkShaderStageFlagBits stage)
+{
+    ANN(compiler);
+    ANN(code);
+    uint64_t h = dvz_hash(compiler->seed, strlen(code), code);
+    // NOTE: the hash is used as a DvzMap key, where the top bit is reserved for dense handles.
+    return dvz_hash(h, sizeof(stage), &stage) & DVZ_HANDLE_RANDOM_MASK;
+}
+
+
+
+static void _spirv_path(uint64_t hash, char* path, size_t size)
 {
-    VkShaderModule module = {0};
+    char name[64] = {0};
+    snprintf(name, sizeof(name), "spirv_%016" PRIx64 ".spv", hash);
+    if (dvz_cache_path(name, path, size) != 0)
+        path[0] = 0;
+}
+
+
+
+// Return the cached SPIR-V code, from memory or from disk, or NULL.
+static DvzSpirv* _spirv_get(DvzCompiler* compiler, uint64_t hash)
+{
+    ANN(compiler);
+
+    dvz_mutex_lock(&compiler->lock);
+    DvzSpirv* spirv = (DvzSpirv*)dvz_map_get(compiler->spirvs, hash);
+    if (spirv != NULL)
+        compiler->hits++;
+    dvz_mutex_unlock(&compiler->lock);
+    if (spirv != NULL)
+        return spirv;
+
+    char path[1024] = {0};
+    FILE* f = NULL;
+    _spirv_path(hash, path, sizeof(path));
+    if (path[0] == 0 || (f = fopen(path, "rb")) == NULL)
+        return NULL;
+    fclose(f);
+
+    DvzSize size = 0;
+    uint32_t* code = (uint32_t*)dvz_read_file(path, &size);
+    if (code == NULL || size < 4 || size % 4 != 0 || code[0] != SPIRV_MAGIC)
+    {
+        log_debug("discarding invalid cached SPIR-V file %s", path);
+        FREE(code);
+        return NULL;
+    }
+    log_trace("loaded cached SPIR-V file %s", path);
+
+    spirv = (DvzSpirv*)calloc(1, sizeof(DvzSpirv));
+    ANN(spirv);
+    spirv->hash = hash;
+    spirv->size = size;
+    spirv->code = code;
+
+    dvz_mutex_lock(&compiler->lock);
+    compiler->loads++;
+    // Another thread may have added the same code in the meantime.
+    DvzSpirv* existing = (DvzSpirv*)dvz_map_get(compiler->spirvs, hash);
+    if (existing == NULL)
+        dvz_map_add(compiler->spirvs, hash, 0, spirv);
+    dvz_mutex_unlock(&compiler->lock);
+    if (existing != NULL)
+    {
+        FREE(spirv->code);
+        FREE(spirv);
+        spirv = existing;
+    }
+    return spirv;
+}
+
+
+
+// Add compiled SPIR-V code to the cache, and save it to disk.
+static DvzSpirv* _spirv_put(DvzCompiler* compiler, uint64_t hash, DvzSize size, const char* bytes)
+{
+    ANN(compiler);
+    ANN(bytes);
+    ASSERT(size > 0);
+
+    DvzSpirv* spirv = (DvzSpirv*)calloc(1, sizeof(DvzSpirv));
+    ANN(spirv);
+    spirv->hash = hash;
+    spirv->size = size;
+    // NOTE: copy the bytes to an aligned buffer, the shaderc result is a char buffer.
+    spirv->code = (uint32_t*)malloc(size);
+    ANN(spirv->code);
+    memcpy(spirv->code, bytes, size);
+
+    // Save the SPIR-V code to disk, with an atomic rename so that a concurrent process never
+    // reads a partially-written file.
+    char path[1024] = {0};
+    _spirv_path(hash, path, sizeof(path));
+    if (path[0] != 0)
+    {
+        char tmp[1040] = {0};
+        snprintf(tmp, sizeof(tmp), "%s.%" PRIx64 ".tmp", path, (uint64_t)(uintptr_t)spirv);
+        if (dvz_write_bytes(tmp, "wb", size, (const uint8_t*)spirv->code) != 0 ||
+            rename(tmp, path) != 0)
+        {
+            log_debug("unable to save the SPIR-V cache file %s", path);
+            remove(tmp);
+        }
+    }
+
+    dvz_mutex_lock(&compiler->lock);
+    compiler->compilations++;
+    DvzSpirv* existing = (DvzSpirv*)dvz_map_get(compiler->spirvs, hash);
+    if (existing == NULL)
+        dvz_map_add(compiler->spirvs, hash, 0, spirv);
+    dvz_mutex_unlock(&compiler->lock);
+    if (existing != NULL)
+    {
+        FREE(spirv->code);
+        FREE(spirv);
+        spirv = existing;
+    }
+    return spirv;
+}
+
+
+
+static void* _batch_thread(void* user_data)
+{
+    DvzCompileBatch* batch = (DvzCompileBatch*)user_data;
+    ANN(batch);
+    DvzCompiler* compiler = batch->compiler;
+    ANN(compiler);
+
+    DvzSize size = 0;
+    uint32_t idx = 0;
+    while (true)
+    {
+        dvz_mutex_lock(&compiler->lock);
+        idx = batch->next++;
+        dvz_mutex_unlock(&compiler->lock);
+        if (idx >= batch->count)
+            break;
+        dvz_compiler_spirv(compiler, batch->codes[idx], batch->stages[idx], &size);
+    }
+    return NULL;
+}
+
+
 
 #if HAS_SHADERC
-    VkDevice device = gpu->device;
-    ASSERT(device != VK_NULL_HANDLE);
+static uint64_t _library_seed(uint64_t seed)
+{
+    // NOTE: shaderc does not expose its version, the path, size and modification time of the
+    // loaded library identify it instead.
+    char path[1024] = {0};
+    struct stat st = {0};
+    if (dvz_library_path((const void*)shaderc_compiler_initialize, path, sizeof(path)) != 0 ||
+        stat(path, &st) != 0)
+    {
+        log_debug("unable to identify the shaderc library, the SPIR-V cache may be stale");
+        return seed;
+    }
+    int64_t lib_size = (int64_t)st.st_size;
+    int64_t lib_mtime = (int64_t)st.st_mtime;
+    seed = dvz_hash(seed, strlen(path), path);
+    seed = dvz_hash(seed, sizeof(lib_size), &lib_size);
+    seed = dvz_hash(seed, sizeof(lib_mtime), &lib_mtime);
+    return seed;
+}
+#endif
 
-    log_info("starting compilation of GLSL shader into SPIR-V");
 
+
+/*************************************************************************************************/
+/*  Compiler                                                                                     */
+/*************************************************************************************************/
+
+DvzCompiler* dvz_compiler(void)
+{
+    DvzCompiler* compiler = (DvzCompiler*)calloc(1, sizeof(DvzCompiler));
+    ANN(compiler);
+    dvz_obj_init(&compiler->obj);
+
+    dvz_mutex_init(&compiler->lock);
+    compiler->spirvs = dvz_map();
+    compiler->seed = DVZ_HASH_SEED;
+
+#if HAS_SHADERC
+    compiler->compiler = shaderc_compiler_initialize();
+    compiler->options = shaderc_compile_options_initialize();
+
+    // NOTE: the options are the shaderc defaults. The SPIR-V version does not change with most
+    // compiler upgrades, so the seed also covers the shaderc library file itself.
+    unsigned int version = 0, revision = 0;
+    shaderc_get_spv_version(&version, &revision);
+    const char* options = "shaderc;vulkan;default";
+    compiler->seed = dvz_hash(compiler->seed, strlen(options), options);
+    compiler->seed = dvz_hash(compiler->seed, sizeof(version), &version);
+    compiler->seed = dvz_hash(compiler->seed, sizeof(revision), &revision);
+    compiler->seed = _library_seed(compiler->seed);
+#endif
+
+    dvz_obj_created(&compiler->obj);
+    return compiler;
+}
+
+
+
+uint32_t* dvz_compiler_spirv(
+    DvzCompiler* compiler, const char* code, VkShaderStageFlagBits stage, DvzSize* size)
+{
+    ANN(compiler);
+    ANN(code);
+    ANN(size);
+    *size = 0;
+
+#if HAS_SHADERC
     shaderc_shader_kind shader_kind;
     switch (stage)
     {
@@ -53,37 +308,147 @@ VkShaderModule dvz_compile_glsl(DvzGpu* gpu, const char* code, VkShaderStageFlag
         shader_kind = shaderc_compute_shader;
         break;
     default:
-        return VK_NULL_HANDLE;
+        return NULL;
     }
 
-    shaderc_compiler_t compiler = shaderc_compiler_initialize();
-    shaderc_compile_options_t options = shaderc_compile_options_initialize();
+    uint64_t hash = _spirv_hash(compiler, code, stage);
+    DvzSpirv* spirv = _spirv_get(compiler, hash);
+    if (spirv != NULL)
+    {
+        *size = spirv->size;
+        return spirv->code;
+    }
 
+    log_debug("starting compilation of GLSL shader into SPIR-V");
+
+    // NOTE: a shaderc compiler may be used concurrently from several threads.
     shaderc_compilation_result_t result = shaderc_compile_into_spv(
-        compiler, code, strlen(code), shader_kind, "shader.glsl", "main", options);
+        (shaderc_compiler_t)compiler->compiler, code, strlen(code), shader_kind, "shader.glsl",
+        "main", (shaderc_compile_options_t)compiler->options);
 
     if (shaderc_result_get_compilation_status(result) != shaderc_compilation_status_success)
     {
-        log_error("error compiling the shader code: >>>%s<<<", code);
-        shaderc_compiler_release(compiler);
-        shaderc_compile_options_release(options);
+        log_error(
+            "error compiling the shader code: %s\n>>>%s<<<",
+            shaderc_result_get_error_message(result), code);
         shaderc_result_release(result);
-        return VK_NULL_HANDLE;
+        return NULL;
     }
 
-    size_t size = shaderc_result_get_length(result);
+    spirv = _spirv_put(
+        compiler, hash, shaderc_result_get_length(result), shaderc_result_get_bytes(result));
+    shaderc_result_release(result);
+
+    *size = spirv->size;
+    return spirv->code;
+
+#else
+    log_error("unable to compile shader to SPIRV, Datoviz was not built with shaderc support");
+    return NULL;
+#endif
+}
+
+
+
+void dvz_compiler_batch(
+    DvzCompiler* compiler, uint32_t count, const char** codes, VkShaderStageFlagBits* stages)
+{
+    ANN(compiler);
+    if (count == 0)
+        return;
+    ANN(codes);
+    ANN(stages);
+
+    int n = checkenv("DVZ_NUM_THREADS") ? getenvint("DVZ_NUM_THREADS") : dvz_num_procs() / 2;
+    uint32_t thread_count = CLIP((uint32_t)MAX(n, 1), 1, count);
+    log_debug("compiling %d shaders with %d thread(s)", count, thread_count);
+
+    DvzCompileBatch batch = {
+        .compiler = compiler, .count = count, .codes = codes, .stages = stages, .next = 0};
+
+    DvzThread** threads = (DvzThread**)calloc(thread_count, sizeof(DvzThread*));
+    ANN(threads);
+    for (uint32_t i = 0; i < thread_count; i++)
+        threads[i] = dvz_thread(_batch_thread, &batch);
+    for (uint32_t i = 0; i < thread_count; i++)
+        dvz_thread_join(threads[i]);
+    FREE(threads);
+}
+
+
+
+void dvz_compiler_destroy(DvzCompiler* compiler)
+{
+    if (compiler == NULL)
+        return;
+
+    log_debug(
+        "SPIR-V cache: %d memory hit(s), %d disk hit(s), %d compilation(s)", compiler->hits,
+        compiler->loads, compiler->compilations);
 
-    // NOTE: fixing this warning on macOS:
-    // cast from 'const char *' to 'const uint32_t *' (aka 'const unsigned int *') increases
-    // required alignment from 1 to 4 [-Wcast-align]
-    // const uint32_t* spirv_code = (const uint32_t*)shaderc_result_get_bytes(result);
-    const char* bytes = shaderc_result_get_bytes(result);
-    uint32_t* spirv_code = malloc(size);
-    if (spirv_code != NULL)
+    DvzSpirv* spirv = NULL;
+    while ((spirv = (DvzSpirv*)dvz_map_first(compiler->spirvs, 0)) != NULL)
     {
-        memcpy(spirv_code, bytes, size);
+        dvz_map_remove(compiler->spirvs, spirv->hash);
+        FREE(spirv->code);
+        FREE(spirv);
     }
+    dvz_map_destroy(compiler->spirvs);
 
+#if HAS_SHADERC
+    shaderc_compile_options_release((shaderc_compile_options_t)compiler->options);
+    shaderc_compiler_release((shaderc_compiler_t)compiler->compiler);
+#endif
+
+    dvz_mutex_destroy(&compiler->lock);
+    dvz_obj_destroyed(&compiler->obj);
+    FREE(compiler);
+}
+
+
+
+/*************************************************************************************************/
+/*  Compilation                                                                                  */
+/*************************************************************************************************/
+
+DvzCompiler* dvz_host_compiler(DvzGpu* gpu)
+{
+    ANN(gpu);
+    ANN(gpu->host);
+    // NOTE: created lazily as most applications never compile GLSL at runtime. Shaders may be
+    // compiled from several threads, so the creation is done under the host compiler lock.
+    DvzHost* host = gpu->host;
+    dvz_mutex_lock(&host->compiler_lock);
+    if (host->compiler == NULL)
+        host->compiler = dvz_compiler();
+    DvzCompiler* compiler = host->compiler;
+    dvz_mutex_unlock(&host->compiler_lock);
+    return compiler;
+}
+
+
+
+uint32_t*
+dvz_compile_spirv(DvzGpu* gpu, const char* code, VkShaderStageFlagBits stage, DvzSize* size)
+{
+    ANN(gpu);
+    return dvz_compiler_spirv(dvz_host_compiler(gpu), code, stage, size);
+}
+
+
+
+VkShaderModule dvz_compile_glsl(DvzGpu* gpu, const char* code, VkShaderStageFlagBits stage)
+{
+    ANN(gpu);
+    VkDevice device = gpu->device;
+    ASSERT(device != VK_NULL_HANDLE);
+
+    DvzSize size = 0;
+    uint32_t* spirv_code = dvz_compile_spirv(gpu, code, stage, &size);
+    if (spirv_code == NULL)
+        return VK_NULL_HANDLE;
+
+    VkShaderModule module = VK_NULL_HANDLE;
     VkShaderModuleCreateInfo create_info = {0};
     create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     create_info.codeSize = size;
@@ -92,20 +457,9 @@ VkShaderModule dvz_compile_glsl(DvzGpu* gpu, const char* code, VkShaderStageFlag
     if (vkCreateShaderModule(device, &create_info, NULL, &module) != VK_SUCCESS)
     {
         log_error("error creating the shader module");
-        shaderc_compiler_release(compiler);
-        shaderc_compile_options_release(options);
-        shaderc_result_release(result);
         return VK_NULL_HANDLE;
     }
 
-    shaderc_compiler_release(compiler);
-    shaderc_compile_options_release(options);
-    shaderc_result_release(result);
-
-#else
-    log_error("unable to compile shader to SPIRV, Datoviz was not built with shaderc support");
-#endif
-
     return module;
 }
 
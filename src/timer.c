@@ -187,6 +187,50 @@ bool dvz_timer_running(DvzTimerItem* item)
 
 
 
+bool dvz_timer_active(DvzTimer* timer)
+{
+    ANN(timer);
+    uint64_t n = dvz_list_count(timer->items);
+    DvzTimerItem* item = NULL;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        item = (DvzTimerItem*)dvz_list_get(timer->items, i).p;
+        ANN(item);
+        if (item->is_running && (item->max_count == 0 || item->count < item->max_count))
+            return true;
+    }
+    return false;
+}
+
+
+
+double dvz_timer_next(DvzTimer* timer)
+{
+    ANN(timer);
+    double next = -1;
+    uint64_t n = dvz_list_count(timer->items);
+    DvzTimerItem* item = NULL;
+    double t = 0;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        item = (DvzTimerItem*)dvz_list_get(timer->items, i).p;
+        ANN(item);
+        if (!item->is_running || (item->max_count > 0 && item->count >= item->max_count))
+            continue;
+
+        // First firing at the start time, then at the next multiple of the period, as in
+        // _timer_item_firing().
+        t = item->start_time;
+        if (item->last_fire >= 0)
+            t += (floor((item->last_fire - item->start_time) / item->period) + 1) * item->period;
+        if (next < 0 || t < next)
+            next = t;
+    }
+    return next;
+}
+
+
+
 void dvz_timer_tick(DvzTimer* timer, double time)
 {
     // Determine which timers are firing now.
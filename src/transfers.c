@@ -16,6 +16,7 @@
 
 // #include "../include/datoviz/canvas.h"
 #include "transfers.h"
+#include "_trace.h"
 #include "fifo.h"
 #include "host.h"
 #include "resources_utils.h"
@@ -33,6 +34,8 @@ static void* _thread_transfers(void* user_data)
 {
     DvzTransfers* transfers = (DvzTransfers*)user_data;
     ANN(transfers);
+    // NOTE: the deq records the dequeue and process spans of every item.
+    dvz_trace_thread("transfers");
     dvz_deq_dequeue_loop(transfers->deq, DVZ_TRANSFER_PROC_UD);
     return NULL;
 }
@@ -113,6 +116,11 @@ static void _create_transfers(DvzTransfers* transfers)
         DVZ_TRANSFER_BUFFER_IMAGE,             //
         _process_buffer_image, transfers);
 
+    dvz_deq_callback(
+        transfers->deq, DVZ_TRANSFER_DEQ_COPY, //
+        DVZ_TRANSFER_STREAM_IMAGE,             //
+        _process_stream_image, transfers);
+
     // Transfer thread.
     transfers->thread = dvz_thread(_thread_transfers, transfers);
 
@@ -232,8 +240,9 @@ void dvz_transfers_frame(DvzTransfers* transfers, uint32_t img_idx)
 
     // Dequeue all pending copies (which are either buffer copies, or direct mappable).
     // This is NOT used for transfer dups, which are enqueued in a different queue/proc (DUP).
-    // NOTE: this call *blocks* the GPU until the copies are complete.
-    dvz_deq_dequeue_batch(transfers->deq, DVZ_TRANSFER_PROC_CPY);
+    // NOTE: this call *blocks* the GPU until the copies are complete, except for the copies of
+    // the streaming texs which are submitted without waiting.
+    dvz_transfers_flush(transfers);
 
     // Dequeue the pending EV items, mostly used for UPLOAD_DONE events (temporary staging dat
     // deallocation).
@@ -265,6 +274,29 @@ void dvz_transfers_frame(DvzTransfers* transfers, uint32_t img_idx)
 
 
 
+void dvz_transfers_flush(DvzTransfers* transfers)
+{
+    ANN(transfers);
+    dvz_deq_dequeue_batch(transfers->deq, DVZ_TRANSFER_PROC_CPY);
+    _stream_submit(transfers);
+    transfers->flushes++;
+}
+
+
+
+bool dvz_transfers_pending(DvzTransfers* transfers)
+{
+    ANN(transfers);
+    DvzDeq* deq = transfers->deq;
+    ANN(deq);
+    return !_dups_empty(&transfers->dups) ||
+           dvz_fifo_size(deq->queues[DVZ_TRANSFER_DEQ_COPY]) > 0 ||
+           dvz_fifo_size(deq->queues[DVZ_TRANSFER_DEQ_EV]) > 0 ||
+           dvz_fifo_size(deq->queues[DVZ_TRANSFER_DEQ_DUP]) > 0;
+}
+
+
+
 void dvz_transfers_destroy(DvzTransfers* transfers)
 {
     if (transfers == NULL)
@@ -288,6 +320,14 @@ void dvz_transfers_destroy(DvzTransfers* transfers)
     // Destroy the deq.
     dvz_deq_destroy(transfers->deq);
 
+    // Destroy the stream command buffer once its last copies are done.
+    if (dvz_obj_is_created(&transfers->stream_fences.obj))
+    {
+        _stream_wait(transfers);
+        dvz_commands_destroy(&transfers->stream_cmds);
+        dvz_fences_destroy(&transfers->stream_fences);
+    }
+
     // Mark the object as destroyed.
     dvz_obj_destroyed(&transfers->obj);
 }
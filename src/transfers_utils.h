@@ -81,7 +81,9 @@ static DvzDeqItem* _create_buffer_image_copy(
     DvzImages* img, uvec3 img_offset, uvec3 shape          //
 )
 {
-    ASSERT(type == DVZ_TRANSFER_IMAGE_BUFFER || type == DVZ_TRANSFER_BUFFER_IMAGE);
+    ASSERT(
+        type == DVZ_TRANSFER_IMAGE_BUFFER || type == DVZ_TRANSFER_BUFFER_IMAGE ||
+        type == DVZ_TRANSFER_STREAM_IMAGE);
     ANN(br.buffer);
     ASSERT(size > 0);
 
@@ -673,6 +675,111 @@ static void _process_buffer_image(DvzDeq* deq, void* item, void* user_data)
 
 
 
+/*************************************************************************************************/
+/*  Streaming image copies                                                                       */
+/*************************************************************************************************/
+
+// Wait until the copies of the last flush are done, so that their staging segments and command
+// buffer can be reused.
+static void _stream_wait(DvzTransfers* transfers)
+{
+    ANN(transfers);
+    if (dvz_obj_is_created(&transfers->stream_fences.obj))
+        dvz_fences_wait(&transfers->stream_fences, 0);
+}
+
+
+
+// Start recording the streaming copies of the current flush if needed.
+static DvzCommands* _stream_begin(DvzTransfers* transfers)
+{
+    ANN(transfers);
+    DvzCommands* cmds = &transfers->stream_cmds;
+    if (transfers->stream_recording)
+        return cmds;
+
+    // NOTE: the copies go to the render queue, so that they are ordered with the render
+    // submissions by the image barriers, without semaphores.
+    if (!dvz_obj_is_created(&transfers->stream_fences.obj))
+    {
+        *cmds = dvz_commands(transfers->gpu, DVZ_DEFAULT_QUEUE_RENDER, 1);
+        transfers->stream_fences = dvz_fences(transfers->gpu, 1, true);
+    }
+
+    _stream_wait(transfers);
+    dvz_cmd_reset(cmds, 0);
+    dvz_cmd_begin(cmds, 0);
+    transfers->stream_recording = true;
+    return cmds;
+}
+
+
+
+// Submit the streaming copies recorded during the current flush, without waiting.
+static void _stream_submit(DvzTransfers* transfers)
+{
+    ANN(transfers);
+    if (!transfers->stream_recording)
+        return;
+
+    DvzCommands* cmds = &transfers->stream_cmds;
+    dvz_cmd_end(cmds, 0);
+
+    DvzSubmit submit = dvz_submit(transfers->gpu);
+    dvz_submit_commands(&submit, cmds);
+    dvz_submit_send(&submit, 0, &transfers->stream_fences, 0);
+    transfers->stream_recording = false;
+}
+
+
+
+static void _process_stream_image(DvzDeq* deq, void* item, void* user_data)
+{
+    DvzTransferBufferImage* tr = (DvzTransferBufferImage*)item;
+    ANN(tr);
+    log_trace("record copy buffer to streaming image");
+
+    DvzImages* img = tr->img;
+    ANN(img);
+    ANN(tr->br.buffer);
+
+    DvzTransfers* transfers = (DvzTransfers*)user_data;
+    ANN(transfers);
+
+    ASSERT(tr->shape[0] > 0);
+    ASSERT(tr->shape[1] > 0);
+    ASSERT(tr->shape[2] > 0);
+
+    DvzCommands* cmds = _stream_begin(transfers);
+    const VkPipelineStageFlags shader_stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    // Wait for the shaders reading the image and for the previous copies. The image keeps its
+    // content outside of the copied rectangle.
+    DvzBarrier barrier = dvz_barrier(transfers->gpu);
+    dvz_barrier_stages(
+        &barrier, shader_stages | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    dvz_barrier_images(&barrier, img);
+    dvz_barrier_images_layout(&barrier, img->layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    dvz_barrier_images_access(
+        &barrier, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT);
+    dvz_cmd_barrier(cmds, 0, &barrier);
+
+    dvz_cmd_copy_buffer_to_image(
+        cmds, 0, tr->br.buffer, tr->br.offsets[0] + tr->buf_offset, img, tr->img_offset,
+        tr->shape);
+
+    // Make the copy visible to the shaders of the next render submissions.
+    dvz_barrier_stages(&barrier, VK_PIPELINE_STAGE_TRANSFER_BIT, shader_stages);
+    dvz_barrier_images_layout(&barrier, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, img->layout);
+    dvz_barrier_images_access(&barrier, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    dvz_cmd_barrier(cmds, 0, &barrier);
+}
+
+
+
 /*************************************************************************************************/
 /*  Image transfer task processing                                                             */
 /*************************************************************************************************/
@@ -10,9 +10,11 @@
 
 #include "vklite.h"
 #include "_pointer.h"
+#include "_time_utils.h"
 #include "common.h"
 #include "datoviz_defaults.h"
 #include "host.h"
+#include "pipecache.h"
 #include "shader.h"
 #include "vklite_utils.h"
 #include "vkutils.h"
@@ -125,7 +127,28 @@ DvzRenderpass dvz_gpu_renderpass(DvzGpu* gpu, cvec4 clear_color, VkImageLayout l
 {
     ANN(gpu);
     DvzRenderpass renderpass = {0};
-    make_renderpass(gpu, &renderpass, DVZ_DEFAULT_FORMAT, layout, get_clear_color(clear_color));
+    make_renderpass(
+        gpu, &renderpass, DVZ_DEFAULT_FORMAT, layout, get_clear_color(clear_color),
+        DVZ_RENDERPASS_FLAGS_NONE);
+    return renderpass;
+}
+
+
+
+DvzRenderpass dvz_gpu_renderpass_pick(DvzGpu* gpu, cvec4 clear_color, VkImageLayout layout)
+{
+    return dvz_gpu_renderpass_flags(gpu, clear_color, layout, DVZ_RENDERPASS_FLAGS_PICK);
+}
+
+
+
+DvzRenderpass
+dvz_gpu_renderpass_flags(DvzGpu* gpu, cvec4 clear_color, VkImageLayout layout, int flags)
+{
+    ANN(gpu);
+    DvzRenderpass renderpass = {0};
+    make_renderpass(
+        gpu, &renderpass, DVZ_DEFAULT_FORMAT, layout, get_clear_color(clear_color), flags);
     return renderpass;
 }
 
@@ -220,6 +243,11 @@ void dvz_gpu_create(DvzGpu* gpu, VkSurfaceKHR surface)
     // Create descriptor pool.
     create_descriptor_pool(gpu->device, &gpu->dset_pool);
 
+    // Create the pipeline cache, with the data saved by a previous run if any.
+    gpu->pipeline_count = 0;
+    gpu->pipeline_time = 0;
+    create_pipeline_cache(gpu);
+
     // Create allocator.
     VmaAllocatorCreateInfo alloc_info = {0};
     alloc_info.vulkanApiVersion = DVZ_VULKAN_API;
@@ -284,6 +312,45 @@ void dvz_gpu_wait(DvzGpu* gpu)
 
 
 
+int dvz_gpu_save_cache(DvzGpu* gpu)
+{
+    ANN(gpu);
+    if (gpu->pipeline_cache == VK_NULL_HANDLE)
+        return 1;
+
+    char path[1024] = {0};
+    if (pipeline_cache_path(gpu, path, sizeof(path)) != 0)
+        return 1;
+
+    size_t size = 0;
+    vkGetPipelineCacheData(gpu->device, gpu->pipeline_cache, &size, NULL);
+    if (size == 0)
+        return 1;
+    uint8_t* data = (uint8_t*)malloc(size);
+    ANN(data);
+    VkResult res = vkGetPipelineCacheData(gpu->device, gpu->pipeline_cache, &size, data);
+
+    // NOTE: write to a temporary file first so that concurrent processes never read a partially
+    // written cache.
+    char tmp[1040] = {0};
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    int ret = 1;
+    if (res == VK_SUCCESS && dvz_write_bytes(tmp, "wb", (DvzSize)size, data) == 0)
+    {
+        remove(path);
+        ret = rename(tmp, path) == 0 ? 0 : 1;
+    }
+    if (ret == 0)
+        log_debug("saved pipeline cache %s (%s)", path, pretty_size((DvzSize)size));
+    else
+        log_warn("unable to save the pipeline cache to %s", path);
+
+    FREE(data);
+    return ret;
+}
+
+
+
 void dvz_gpu_destroy(DvzGpu* gpu)
 {
     ANN(gpu);
@@ -309,6 +376,18 @@ void dvz_gpu_destroy(DvzGpu* gpu)
         }
     }
 
+    // Save and destroy the pipeline cache.
+    if (gpu->pipeline_cache != VK_NULL_HANDLE)
+    {
+        log_debug(
+            "created %d pipeline(s) in %.1f ms, %s", gpu->pipeline_count,
+            gpu->pipeline_time * 1000,
+            gpu->pipeline_cache_loaded > 0 ? "with the pipeline cache" : "with a cold cache");
+        dvz_gpu_save_cache(gpu);
+        vkDestroyPipelineCache(device, gpu->pipeline_cache, NULL);
+        gpu->pipeline_cache = VK_NULL_HANDLE;
+    }
+
     // Destroy the descriptor pools.
     if (gpu->dset_pool != VK_NULL_HANDLE)
     {
@@ -922,19 +1001,15 @@ void dvz_buffer_create(DvzBuffer* buffer)
 
 
 
-void dvz_buffer_resize(DvzBuffer* buffer, VkDeviceSize size)
+// Replace the Vulkan buffer with a new one with the given size, copying the given regions from
+// the old buffer to the new one on the GPU (hard sync). The DvzBuffer struct is kept.
+static void
+_buffer_replace(DvzBuffer* buffer, VkDeviceSize size, uint32_t count, VkBufferCopy* regions)
 {
     ANN(buffer);
+    ASSERT(size > 0);
+    ASSERT(count == 0 || regions != NULL);
     DvzGpu* gpu = buffer->gpu;
-    if (size <= buffer->size)
-    {
-        log_trace(
-            "skip buffer resizing as the buffer size is large enough:"
-            "(requested %s, is %s already)",
-            pretty_size(buffer->size), pretty_size(size));
-        return;
-    }
-    log_debug("[SLOW] resize buffer to size %s", pretty_size(size));
 
     // Create the new buffer with the new size.
     DvzBuffer new_buffer = dvz_buffer(gpu);
@@ -975,16 +1050,22 @@ void dvz_buffer_resize(DvzBuffer* buffer, VkDeviceSize size)
     // HACK: use queue 0 for transfers (convention)
     // DvzCommands cmds_ = dvz_commands(gpu, 0, 1);
     DvzCommands* cmds = &gpu->cmd;
-    if (proceed)
+    if (proceed && count > 0)
     {
         uint32_t queue_idx = cmds->queue_idx;
         log_debug("copying data from the old buffer to the new one before destroying the old one");
         ASSERT(queue_idx < gpu->queues.queue_count);
-        ASSERT(size >= buffer->size);
 
         dvz_cmd_reset(cmds, 0);
         dvz_cmd_begin(cmds, 0);
-        dvz_cmd_copy_buffer(cmds, 0, buffer, 0, &new_buffer, 0, buffer->size);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ASSERT(regions[i].srcOffset + regions[i].size <= buffer->size);
+            ASSERT(regions[i].dstOffset + regions[i].size <= size);
+            dvz_cmd_copy_buffer(
+                cmds, 0, buffer, regions[i].srcOffset, &new_buffer, regions[i].dstOffset,
+                regions[i].size);
+        }
         dvz_cmd_end(cmds, 0);
 
         VkQueue queue = gpu->queues.queues[queue_idx];
@@ -1018,6 +1099,37 @@ void dvz_buffer_resize(DvzBuffer* buffer, VkDeviceSize size)
 
 
 
+void dvz_buffer_resize(DvzBuffer* buffer, VkDeviceSize size)
+{
+    ANN(buffer);
+    if (size <= buffer->size)
+    {
+        log_trace(
+            "skip buffer resizing as the buffer size is large enough:"
+            "(requested %s, is %s already)",
+            pretty_size(buffer->size), pretty_size(size));
+        return;
+    }
+    log_debug("[SLOW] resize buffer to size %s", pretty_size(size));
+
+    // Keep the whole contents of the buffer.
+    VkBufferCopy region = {0, 0, buffer->size};
+    _buffer_replace(buffer, size, 1, &region);
+}
+
+
+
+void dvz_buffer_repack(
+    DvzBuffer* buffer, VkDeviceSize size, uint32_t region_count, VkBufferCopy* regions)
+{
+    ANN(buffer);
+    ASSERT(size > 0);
+    log_debug("[SLOW] repack %d buffer regions into size %s", region_count, pretty_size(size));
+    _buffer_replace(buffer, size, region_count, regions);
+}
+
+
+
 void* dvz_buffer_map(DvzBuffer* buffer, VkDeviceSize offset, VkDeviceSize size)
 {
     ANN(buffer);
@@ -2438,6 +2550,22 @@ void dvz_descriptors_texture(
 
 
 
+void dvz_descriptors_attachment(DvzDescriptors* descriptors, uint32_t idx, DvzImages* img)
+{
+    ANN(descriptors);
+    ANN(img);
+    ASSERT(img->count == 1 || img->count == descriptors->dset_count);
+
+    log_trace("set descriptors with input attachment for descriptor #%d", idx);
+    descriptors->images[idx] = img;
+    descriptors->samplers[idx] = NULL;
+
+    if (descriptors->obj.status == DVZ_OBJECT_STATUS_CREATED)
+        descriptors->obj.status = DVZ_OBJECT_STATUS_NEED_UPDATE;
+}
+
+
+
 void dvz_descriptors_update(DvzDescriptors* descriptors)
 {
     log_trace("update descriptors");
@@ -2507,6 +2635,17 @@ void dvz_compute_code(DvzCompute* compute, const char* code)
 
 
 
+void dvz_compute_spirv(DvzCompute* compute, VkDeviceSize size, const uint32_t* buffer)
+{
+    ANN(compute);
+    ANN(buffer);
+    ASSERT(size > 0);
+    compute->shader_size = size;
+    compute->shader_buffer = buffer;
+}
+
+
+
 void dvz_compute_slot(DvzCompute* compute, uint32_t idx, VkDescriptorType type)
 {
     ANN(compute);
@@ -2555,6 +2694,11 @@ void dvz_compute_create(DvzCompute* compute)
         compute->shader_module =
             dvz_compile_glsl(compute->gpu, compute->shader_code, VK_SHADER_STAGE_COMPUTE_BIT);
     }
+    else if (compute->shader_buffer != NULL)
+    {
+        compute->shader_module = create_shader_module(
+            compute->gpu->device, compute->shader_size, compute->shader_buffer);
+    }
     else
     {
         compute->shader_module =
@@ -2562,9 +2706,13 @@ void dvz_compute_create(DvzCompute* compute)
     }
     ANN(compute->shader_module);
 
+    DvzGpu* gpu = compute->gpu;
+    DvzClock clock = dvz_clock();
     create_compute_pipeline(
-        compute->gpu->device, compute->shader_module, //
+        gpu->device, gpu->pipeline_cache, compute->shader_module, //
         compute->dslots.pipeline_layout, &compute->pipeline);
+    gpu->pipeline_time += dvz_clock_get(&clock);
+    gpu->pipeline_count++;
 
     dvz_obj_created(&compute->obj);
     log_trace("compute created");
@@ -2619,6 +2767,7 @@ DvzGraphics dvz_graphics(DvzGpu* gpu)
     dvz_obj_init(&graphics.obj);
 
     graphics.dslots = dvz_slots(gpu);
+    graphics.variant = -1;
 
     // By default, mask on all color channels.
     dvz_graphics_mask(&graphics, DVZ_MASK_COLOR_ALL);
@@ -2660,10 +2809,16 @@ void dvz_graphics_shader_glsl(DvzGraphics* graphics, VkShaderStageFlagBits stage
     ANN(graphics->gpu);
     ASSERT(graphics->gpu->device != VK_NULL_HANDLE);
 
-    graphics->shader_stages[graphics->shader_count] = stage;
-    graphics->shader_modules[graphics->shader_count] =
-        dvz_compile_glsl(graphics->gpu, code, stage);
-    graphics->shader_count++;
+    // NOTE: go through the SPIR-V code so that identical shaders share the same module.
+    DvzSize size = 0;
+    uint32_t* spirv = dvz_compile_spirv(graphics->gpu, code, stage, &size);
+    if (spirv == NULL)
+    {
+        graphics->shader_stages[graphics->shader_count] = stage;
+        graphics->shader_modules[graphics->shader_count++] = VK_NULL_HANDLE;
+        return;
+    }
+    dvz_graphics_shader_spirv(graphics, stage, size, spirv);
 }
 
 
@@ -2691,8 +2846,20 @@ void dvz_graphics_shader_spirv(
     ASSERT(graphics->gpu->device != VK_NULL_HANDLE);
 
     graphics->shader_stages[graphics->shader_count] = stage;
-    graphics->shader_modules[graphics->shader_count++] =
-        create_shader_module(graphics->gpu->device, size, buffer);
+
+    // Reuse the shader module of another graphics with the same SPIR-V code.
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (graphics->cache != NULL)
+        module = (VkShaderModule)dvz_pipecache_get(
+            graphics->cache, DVZ_PIPECACHE_MODULE, size, buffer);
+    if (module == VK_NULL_HANDLE)
+    {
+        module = create_shader_module(graphics->gpu->device, size, buffer);
+        if (graphics->cache != NULL)
+            dvz_pipecache_put(
+                graphics->cache, DVZ_PIPECACHE_MODULE, size, buffer, (uint64_t)module);
+    }
+    graphics->shader_modules[graphics->shader_count++] = module;
 }
 
 
@@ -2864,6 +3031,22 @@ void dvz_graphics_create(DvzGraphics* graphics)
     if (!dvz_obj_is_created(&graphics->dslots.obj))
         dvz_slots_create(&graphics->dslots);
 
+    // Reuse the pipeline of another graphics with the same state.
+    GraphicsKey key = {0};
+    if (graphics->cache != NULL)
+    {
+        graphics_key(graphics, &key);
+        graphics->pipeline = (VkPipeline)dvz_pipecache_get(
+            graphics->cache, DVZ_PIPECACHE_PIPELINE, key.size, key.data);
+        if (graphics->pipeline != VK_NULL_HANDLE)
+        {
+            log_trace("reuse existing graphics pipeline");
+            FREE(key.data);
+            dvz_obj_created(&graphics->obj);
+            return;
+        }
+    }
+
     log_trace("starting creation of graphics pipeline...");
 
     VkPipelineVertexInputStateCreateInfo vertex_input_info = {0};
@@ -2974,17 +3157,16 @@ void dvz_graphics_create(DvzGraphics* graphics)
         create_rasterizer(graphics->cull_mode, graphics->front_face);
     VkPipelineMultisampleStateCreateInfo multisampling = create_multisampling();
 
-    // Blend attachments.
-    VkPipelineColorBlendAttachmentState color_attachment = create_color_blend_attachment(
-        graphics->blend_type, (VkColorComponentFlags)graphics->color_mask);
-    VkPipelineColorBlendAttachmentState pick_attachment =
-        create_color_blend_attachment(DVZ_BLEND_DISABLE, DVZ_MASK_COLOR_ALL);
-    VkPipelineColorBlendStateCreateInfo color_blend = create_color_blend(
-        graphics->support_pick ? 2 : 1,
-        (VkPipelineColorBlendAttachmentState[]){color_attachment, pick_attachment});
+    // Blend attachments, one per color attachment of the subpass.
+    VkPipelineColorBlendAttachmentState blend_attachments[DVZ_MAX_ATTACHMENTS_PER_RENDERPASS];
+    uint32_t blend_count = create_blend_attachments(graphics, blend_attachments);
+    VkPipelineColorBlendStateCreateInfo color_blend =
+        create_color_blend(blend_count, blend_attachments);
 
+    // NOTE: translucent fragments must not occlude each other with order-independent
+    // transparency, they are still tested against the depth of the opaque fragments.
     VkPipelineDepthStencilStateCreateInfo depth_stencil =
-        create_depth_stencil((bool)graphics->depth_test);
+        create_depth_stencil((bool)graphics->depth_test, !has_oit(graphics));
     VkPipelineViewportStateCreateInfo viewport_state = create_viewport_state();
     VkPipelineDynamicStateCreateInfo dynamic_state = create_dynamic_states(
         2, (VkDynamicState[]){VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR});
@@ -3009,17 +3191,26 @@ void dvz_graphics_create(DvzGraphics* graphics)
     pipelineInfo.subpass = graphics->subpass;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
+    DvzGpu* gpu = graphics->gpu;
+    DvzClock clock = dvz_clock();
     VK_CHECK_RESULT(vkCreateGraphicsPipelines(
-        graphics->gpu->device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &graphics->pipeline));
+        gpu->device, gpu->pipeline_cache, 1, &pipelineInfo, NULL, &graphics->pipeline));
+    gpu->pipeline_time += dvz_clock_get(&clock);
+    gpu->pipeline_count++;
     if (graphics->pipeline != VK_NULL_HANDLE)
     {
         log_trace("graphics pipeline created");
+        if (graphics->cache != NULL)
+            dvz_pipecache_put(
+                graphics->cache, DVZ_PIPECACHE_PIPELINE, key.size, key.data,
+                (uint64_t)graphics->pipeline);
         dvz_obj_created(&graphics->obj);
     }
     else
     {
         graphics->obj.status = DVZ_OBJECT_STATUS_INVALID;
     }
+    FREE(key.data);
 
     // NOTE: free the specialization constant concatenated array created before pipeline creation.
     for (uint32_t i = 0; i < graphics->shader_count; i++)
@@ -3034,6 +3225,63 @@ void dvz_graphics_create(DvzGraphics* graphics)
 
 
 
+void dvz_graphics_variant(DvzGraphics* graphics, DvzRenderpass* renderpass)
+{
+    ANN(graphics);
+    ANN(graphics->renderpass);
+    ANN(renderpass);
+    ASSERT(dvz_obj_is_created(&graphics->obj));
+
+    graphics->variant = -1;
+    if (renderpass_compatible(graphics->renderpass, renderpass))
+        return;
+
+    for (uint32_t i = 0; i < graphics->variant_count; i++)
+    {
+        if (renderpass_compatible(graphics->variant_renderpasses[i], renderpass))
+        {
+            graphics->variant = (int32_t)i;
+            return;
+        }
+    }
+
+    if (graphics->variant_count >= DVZ_MAX_GRAPHICS_VARIANTS)
+    {
+        log_error("too many graphics pipeline variants, using the main pipeline");
+        return;
+    }
+
+    // NOTE: the variant is created with the same state as the main pipeline, only the renderpass
+    // and the pick support differ. The main pipeline is left untouched.
+    log_debug("create graphics pipeline variant with pick=%d", has_pick(renderpass));
+    DvzRenderpass* main_renderpass = graphics->renderpass;
+    bool main_pick = graphics->support_pick;
+    VkPipeline main_pipeline = graphics->pipeline;
+    DvzObject main_obj = graphics->obj;
+
+    graphics->renderpass = renderpass;
+    graphics->support_pick = has_pick(renderpass);
+    graphics->pipeline = VK_NULL_HANDLE;
+    dvz_graphics_create(graphics);
+    VkPipeline pipeline = graphics->pipeline;
+
+    graphics->renderpass = main_renderpass;
+    graphics->support_pick = main_pick;
+    graphics->pipeline = main_pipeline;
+    graphics->obj = main_obj;
+
+    if (pipeline == VK_NULL_HANDLE)
+    {
+        log_error("could not create the graphics pipeline variant, using the main pipeline");
+        return;
+    }
+    graphics->variant = (int32_t)graphics->variant_count;
+    graphics->variant_renderpasses[graphics->variant_count] = renderpass;
+    graphics->variant_pipelines[graphics->variant_count++] = pipeline;
+}
+
+
+
 void dvz_graphics_destroy(DvzGraphics* graphics)
 {
     ANN(graphics);
@@ -3046,20 +3294,39 @@ void dvz_graphics_destroy(DvzGraphics* graphics)
     ANN(graphics->gpu);
     log_trace("destroy graphics");
 
+    // NOTE: shared objects are only destroyed when their last user releases them.
     VkDevice device = graphics->gpu->device;
     for (uint32_t i = 0; i < graphics->shader_count; i++)
     {
         if (graphics->shader_modules[i] != VK_NULL_HANDLE)
         {
-            vkDestroyShaderModule(device, graphics->shader_modules[i], NULL);
+            if (graphics->cache == NULL ||
+                dvz_pipecache_release(
+                    graphics->cache, DVZ_PIPECACHE_MODULE,
+                    (uint64_t)graphics->shader_modules[i]) <= 0)
+                vkDestroyShaderModule(device, graphics->shader_modules[i], NULL);
             graphics->shader_modules[i] = VK_NULL_HANDLE;
         }
     }
     if (graphics->pipeline != VK_NULL_HANDLE)
     {
-        vkDestroyPipeline(device, graphics->pipeline, NULL);
+        if (graphics->cache == NULL ||
+            dvz_pipecache_release(
+                graphics->cache, DVZ_PIPECACHE_PIPELINE, (uint64_t)graphics->pipeline) <= 0)
+            vkDestroyPipeline(device, graphics->pipeline, NULL);
         graphics->pipeline = VK_NULL_HANDLE;
     }
+    VkPipeline variant = VK_NULL_HANDLE;
+    for (uint32_t i = 0; i < graphics->variant_count; i++)
+    {
+        variant = graphics->variant_pipelines[i];
+        if (graphics->cache == NULL ||
+            dvz_pipecache_release(graphics->cache, DVZ_PIPECACHE_PIPELINE, (uint64_t)variant) <= 0)
+            vkDestroyPipeline(device, variant, NULL);
+        graphics->variant_pipelines[i] = VK_NULL_HANDLE;
+    }
+    graphics->variant_count = 0;
+    graphics->variant = -1;
 
     // Free the copied specialization constants.
     DvzSpecializationConstants* spec_const = NULL;
@@ -3107,6 +3374,16 @@ void dvz_barrier_stages(
 
 
 
+void dvz_barrier_memory(DvzBarrier* barrier, VkAccessFlags src_access, VkAccessFlags dst_access)
+{
+    ANN(barrier);
+    barrier->memory_barrier = true;
+    barrier->memory_src_access = src_access;
+    barrier->memory_dst_access = dst_access;
+}
+
+
+
 void dvz_barrier_buffer(DvzBarrier* barrier, DvzBufferRegions br)
 {
     ANN(barrier);
@@ -3409,6 +3686,87 @@ void dvz_fences_destroy(DvzFences* fences)
 
 
 
+/*************************************************************************************************/
+/*  Queries                                                                                      */
+/*************************************************************************************************/
+
+DvzQueries dvz_queries(DvzGpu* gpu, VkQueryType type, uint32_t count)
+{
+    ANN(gpu);
+    ASSERT(dvz_obj_is_created(&gpu->obj));
+
+    DvzQueries queries = {0};
+
+    ASSERT(count > 0);
+    log_trace("create pool of %d queries", count);
+
+    queries.gpu = gpu;
+    queries.type = type;
+    queries.count = count;
+
+    VkQueryPoolCreateInfo info = {0};
+    info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    info.queryType = type;
+    info.queryCount = count;
+    VK_CHECK_RESULT(vkCreateQueryPool(gpu->device, &info, NULL, &queries.pool));
+
+    dvz_obj_created(&queries.obj);
+    return queries;
+}
+
+
+
+bool dvz_queries_results(DvzQueries* queries, uint32_t first, uint32_t count, uint64_t* values)
+{
+    ANN(queries);
+    ANN(values);
+    ASSERT(queries->pool != VK_NULL_HANDLE);
+    ASSERT(first + count <= queries->count);
+    if (count == 0)
+        return true;
+
+    // NOTE: every result is followed by its availability, so that the call never blocks.
+    uint64_t* results = (uint64_t*)calloc(2 * count, sizeof(uint64_t));
+    ANN(results);
+    VkResult res = vkGetQueryPoolResults(
+        queries->gpu->device, queries->pool, first, count, 2 * count * sizeof(uint64_t), results,
+        2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+    bool available = res == VK_SUCCESS || res == VK_NOT_READY;
+    for (uint32_t i = 0; i < count && available; i++)
+        available = results[2 * i + 1] != 0;
+    if (available)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            values[i] = results[2 * i];
+    }
+
+    FREE(results);
+    return available;
+}
+
+
+
+void dvz_queries_destroy(DvzQueries* queries)
+{
+    ANN(queries);
+    if (!dvz_obj_is_created(&queries->obj))
+    {
+        log_trace("skip destruction of already-destroyed queries");
+        return;
+    }
+
+    log_trace("destroy pool of %d queries", queries->count);
+    if (queries->pool != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(queries->gpu->device, queries->pool, NULL);
+        queries->pool = VK_NULL_HANDLE;
+    }
+    dvz_obj_destroyed(&queries->obj);
+}
+
+
+
 /*************************************************************************************************/
 /*  Renderpass                                                                                   */
 /*************************************************************************************************/
@@ -3481,6 +3839,17 @@ void dvz_renderpass_subpass_attachment(
 
 
 
+void dvz_renderpass_subpass_input(
+    DvzRenderpass* renderpass, uint32_t subpass_idx, uint32_t attachment_idx)
+{
+    ANN(renderpass);
+    renderpass->subpasses[subpass_idx]
+        .inputs[renderpass->subpasses[subpass_idx].input_count++] = attachment_idx;
+    renderpass->subpass_count = MAX(renderpass->subpass_count, subpass_idx + 1);
+}
+
+
+
 void dvz_renderpass_subpass_dependency(
     DvzRenderpass* renderpass, uint32_t dependency_idx, //
     uint32_t src_subpass, uint32_t dst_subpass)
@@ -3538,8 +3907,10 @@ void dvz_renderpass_create(DvzRenderpass* renderpass)
 
     // Subpasses.
     VkSubpassDescription subpasses[DVZ_MAX_SUBPASSES_PER_RENDERPASS] = {0};
-    VkAttachmentReference attachment_refs_matrix[DVZ_MAX_ATTACHMENTS_PER_RENDERPASS]
+    VkAttachmentReference attachment_refs_matrix[DVZ_MAX_SUBPASSES_PER_RENDERPASS]
                                                 [DVZ_MAX_ATTACHMENTS_PER_RENDERPASS] = {0};
+    VkAttachmentReference input_refs_matrix[DVZ_MAX_SUBPASSES_PER_RENDERPASS]
+                                           [DVZ_MAX_ATTACHMENTS_PER_RENDERPASS] = {0};
     uint32_t attachment = 0;
     uint32_t k = 0;
     for (uint32_t i = 0; i < renderpass->subpass_count; i++) // i is the subpass index
@@ -3550,19 +3921,37 @@ void dvz_renderpass_create(DvzRenderpass* renderpass)
         for (uint32_t j = 0; j < renderpass->subpasses[i].attachment_count; j++)
         {
             attachment = renderpass->subpasses[i].attachments[j];
+            // NOTE: unused color attachments keep the fragment shader output locations fixed.
+            if (attachment == VK_ATTACHMENT_UNUSED)
+            {
+                attachment_refs_matrix[i][k++] =
+                    create_attachment_ref(VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED);
+                continue;
+            }
             ASSERT(attachment < renderpass->attachment_count);
             if (renderpass->attachments[attachment].type == DVZ_RENDERPASS_ATTACHMENT_DEPTH)
             {
-                subpasses[i].pDepthStencilAttachment = &attachment_refs[j];
+                subpasses[i].pDepthStencilAttachment = &attachment_refs[attachment];
             }
             else
             {
-                attachment_refs_matrix[i][k++] =
-                    create_attachment_ref(j, renderpass->attachments[i].ref_layout);
+                attachment_refs_matrix[i][k++] = create_attachment_ref(
+                    attachment, renderpass->attachments[attachment].ref_layout);
             }
         }
         subpasses[i].colorAttachmentCount = k;
         subpasses[i].pColorAttachments = attachment_refs_matrix[i];
+
+        // Input attachments, read by the fragment shaders of the subpass.
+        for (uint32_t j = 0; j < renderpass->subpasses[i].input_count; j++)
+        {
+            attachment = renderpass->subpasses[i].inputs[j];
+            ASSERT(attachment < renderpass->attachment_count);
+            input_refs_matrix[i][j] =
+                create_attachment_ref(attachment, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+        subpasses[i].inputAttachmentCount = renderpass->subpasses[i].input_count;
+        subpasses[i].pInputAttachments = input_refs_matrix[i];
     }
 
     // Dependencies.
@@ -3942,6 +4331,45 @@ void dvz_cmd_end_renderpass(DvzCommands* cmds, uint32_t idx)
 
 
 
+void dvz_cmd_next_subpass(DvzCommands* cmds, uint32_t idx)
+{
+    CMD_START
+    vkCmdNextSubpass(cb, VK_SUBPASS_CONTENTS_INLINE);
+    CMD_END
+}
+
+
+
+void dvz_cmd_reset_queries(
+    DvzCommands* cmds, uint32_t idx, DvzQueries* queries, uint32_t first, uint32_t count)
+{
+    ANN(queries);
+    ASSERT(queries->pool != VK_NULL_HANDLE);
+    ASSERT(first + count <= queries->count);
+
+    CMD_START
+    vkCmdResetQueryPool(cb, queries->pool, first, count);
+    CMD_END
+}
+
+
+
+void dvz_cmd_timestamp(
+    DvzCommands* cmds, uint32_t idx, DvzQueries* queries, uint32_t query,
+    VkPipelineStageFlagBits stage)
+{
+    ANN(queries);
+    ASSERT(queries->pool != VK_NULL_HANDLE);
+    ASSERT(queries->type == VK_QUERY_TYPE_TIMESTAMP);
+    ASSERT(query < queries->count);
+
+    CMD_START
+    vkCmdWriteTimestamp(cb, stage, queries->pool, query);
+    CMD_END
+}
+
+
+
 void dvz_cmd_compute(DvzCommands* cmds, uint32_t idx, DvzCompute* compute, uvec3 size)
 {
     ANN(compute->descriptors);
@@ -3954,10 +4382,16 @@ void dvz_cmd_compute(DvzCommands* cmds, uint32_t idx, DvzCompute* compute, uvec3
 
     CMD_START
 
+    // NOTE: when recorded into the command buffers of a canvas, use the descriptor set of the
+    // swapchain image, as for the graphics pipelines.
+    DvzDescriptors* descriptors = compute->descriptors;
+    ASSERT(descriptors->dset_count > 0);
+    uint32_t iclip = MIN(i, descriptors->dset_count - 1);
+
     vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, compute->pipeline);
     vkCmdBindDescriptorSets(
         cb, VK_PIPELINE_BIND_POINT_COMPUTE, compute->dslots.pipeline_layout, 0, 1,
-        compute->descriptors->dsets, 0, 0);
+        &descriptors->dsets[iclip], 0, 0);
     vkCmdDispatch(cb, size[0], size[1], size[2]);
     CMD_END
 }
@@ -4011,8 +4445,9 @@ void dvz_cmd_barrier(DvzCommands* cmds, uint32_t idx, DvzBarrier* barrier)
         image_info = &barrier->image_barriers[j];
 
         image_barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        ASSERT(i < image_info->images->count);
-        image_barrier->image = image_info->images->images[i];
+        // NOTE: a single image is shared by all command buffers (e.g. a staging image).
+        ASSERT(image_info->images->count > 0);
+        image_barrier->image = image_info->images->images[MIN(i, image_info->images->count - 1)];
         image_barrier->oldLayout = image_info->src_layout;
         image_barrier->newLayout = image_info->dst_layout;
 
@@ -4038,10 +4473,17 @@ void dvz_cmd_barrier(DvzCommands* cmds, uint32_t idx, DvzBarrier* barrier)
         image_barrier->subresourceRange.layerCount = 1;
     }
 
+    // Global memory barrier.
+    VkMemoryBarrier memory_barrier = {0};
+    memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memory_barrier.srcAccessMask = barrier->memory_src_access;
+    memory_barrier.dstAccessMask = barrier->memory_dst_access;
+
     vkCmdPipelineBarrier(
-        cb, barrier->src_stage, barrier->dst_stage, 0, 0, NULL, //
-        barrier->buffer_barrier_count, buffer_barriers,         //
-        barrier->image_barrier_count, image_barriers);          //
+        cb, barrier->src_stage, barrier->dst_stage, 0,    //
+        barrier->memory_barrier ? 1 : 0, &memory_barrier, //
+        barrier->buffer_barrier_count, buffer_barriers,   //
+        barrier->image_barrier_count, image_barriers);    //
 
     CMD_END
 }
@@ -4200,7 +4642,10 @@ void dvz_cmd_bind_graphics(DvzCommands* cmds, uint32_t idx, DvzGraphics* graphic
     // CMD_START_CLIP(descriptors->dset_count)
     CMD_START
     if (dvz_obj_is_created(&graphics->obj))
-        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics->pipeline);
+        vkCmdBindPipeline(
+            cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
+            graphics->variant >= 0 ? graphics->variant_pipelines[graphics->variant]
+                                   : graphics->pipeline);
     else
     {
         log_error("could not bind uncreated graphics pipeline when recording the command buffer");
@@ -4323,6 +4768,23 @@ void dvz_cmd_draw_indexed_indirect(
 
 
 
+void dvz_cmd_fill_buffer(
+    DvzCommands* cmds, uint32_t idx, DvzBuffer* buffer, VkDeviceSize offset, VkDeviceSize size,
+    uint32_t value)
+{
+    ANN(cmds);
+    ANN(buffer);
+    ASSERT(size > 0);
+    ASSERT(offset % 4 == 0);
+    ASSERT(size % 4 == 0);
+    ASSERT(offset + size <= buffer->size);
+
+    VkCommandBuffer cb = cmds->cmds[idx];
+    vkCmdFillBuffer(cb, buffer->buffer, offset, size, value);
+}
+
+
+
 void dvz_cmd_copy_buffer(
     DvzCommands* cmds, uint32_t idx,             //
     DvzBuffer* src_buf, VkDeviceSize src_offset, //
@@ -796,7 +796,8 @@ static bool is_descriptor_type_buffer(VkDescriptorType descriptor_type)
 static bool is_descriptor_type_image(VkDescriptorType descriptor_type)
 {
     return descriptor_type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
-           descriptor_type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+           descriptor_type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
+           descriptor_type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
 }
 
 
@@ -845,7 +846,9 @@ static void update_descriptor_set(
             uint32_t idx_clip = MIN(idx, images[i]->count - 1);
             image_infos[i].imageLayout = images[i]->layout;
             image_infos[i].imageView = images[i]->image_views[idx_clip];
-            image_infos[i].sampler = samplers[i]->sampler;
+            // NOTE: input attachments have no sampler.
+            image_infos[i].sampler =
+                samplers[i] != NULL ? samplers[i]->sampler : VK_NULL_HANDLE;
             // }
             // else
             // {
@@ -912,13 +915,203 @@ static VkShaderModule create_shader_module_from_file(VkDevice device, const char
 
 
 
+/*************************************************************************************************/
+/*  Pipeline cache                                                                               */
+/*************************************************************************************************/
+
+// NOTE: the file name contains the pipeline cache UUID, which changes with the driver version, so
+// that a driver update never gets the data of another driver.
+static int pipeline_cache_path(DvzGpu* gpu, char* path, size_t size)
+{
+    ANN(gpu);
+    VkPhysicalDeviceProperties* props = &gpu->device_properties;
+
+    char name[128] = {0};
+    int n = snprintf(name, sizeof(name), "pipelines_%04x_%04x_", props->vendorID, props->deviceID);
+    for (uint32_t i = 0; i < VK_UUID_SIZE; i++)
+        n += snprintf(name + n, sizeof(name) - (size_t)n, "%02x", props->pipelineCacheUUID[i]);
+    snprintf(name + n, sizeof(name) - (size_t)n, ".bin");
+
+    return dvz_cache_path(name, path, size);
+}
+
+
+
+static bool pipeline_cache_valid(VkPhysicalDeviceProperties* props, DvzSize size, void* data)
+{
+    ANN(props);
+    if (data == NULL || size < sizeof(VkPipelineCacheHeaderVersionOne))
+        return false;
+
+    // NOTE: some drivers do not validate the cache data, so we check the header ourselves.
+    VkPipelineCacheHeaderVersionOne header = {0};
+    memcpy(&header, data, sizeof(header));
+    return header.headerSize >= sizeof(header) && header.headerSize <= size &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == props->vendorID && header.deviceID == props->deviceID &&
+           memcmp(header.pipelineCacheUUID, props->pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+
+
+static void create_pipeline_cache(DvzGpu* gpu)
+{
+    ANN(gpu);
+    ASSERT(gpu->device != VK_NULL_HANDLE);
+
+    // Load the cache data saved by a previous run, if any.
+    char path[1024] = {0};
+    void* data = NULL;
+    DvzSize size = 0;
+    FILE* f = NULL;
+    if (pipeline_cache_path(gpu, path, sizeof(path)) == 0 && (f = fopen(path, "rb")) != NULL)
+    {
+        fclose(f);
+        data = dvz_read_file(path, &size);
+        if (!pipeline_cache_valid(&gpu->device_properties, size, data))
+        {
+            log_debug("discarding invalid pipeline cache %s", path);
+            FREE(data);
+            size = 0;
+        }
+    }
+
+    VkPipelineCacheCreateInfo info = {0};
+    info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    info.initialDataSize = (size_t)size;
+    info.pInitialData = data;
+    VkResult res = vkCreatePipelineCache(gpu->device, &info, NULL, &gpu->pipeline_cache);
+    if (res != VK_SUCCESS && data != NULL)
+    {
+        log_warn("unable to use the pipeline cache %s, starting with an empty cache", path);
+        info.initialDataSize = 0;
+        info.pInitialData = NULL;
+        size = 0;
+        res = vkCreatePipelineCache(gpu->device, &info, NULL, &gpu->pipeline_cache);
+    }
+    if (res != VK_SUCCESS)
+    {
+        log_warn("unable to create the pipeline cache");
+        gpu->pipeline_cache = VK_NULL_HANDLE;
+    }
+    else if (size > 0)
+    {
+        log_debug("loaded pipeline cache %s (%s)", path, pretty_size(size));
+    }
+    gpu->pipeline_cache_loaded = size;
+    FREE(data);
+}
+
+
+
+typedef struct GraphicsKey GraphicsKey;
+struct GraphicsKey
+{
+    size_t size;
+    size_t capacity;
+    uint8_t* data;
+};
+
+
+
+static void key_append(GraphicsKey* key, size_t size, const void* data)
+{
+    ANN(key);
+    if (key->size + size > key->capacity)
+    {
+        key->capacity = MAX(256, 2 * (key->size + size));
+        key->data = (uint8_t*)realloc(key->data, key->capacity);
+        ANN(key->data);
+    }
+    memcpy(&key->data[key->size], data, size);
+    key->size += size;
+}
+
+
+
+#define KEY_FIELD(k, x) key_append(k, sizeof(x), &(x))
+
+// NOTE: two graphics with the same key can share the same VkPipeline. The fields are appended one
+// by one to avoid serializing struct padding bytes. The pipeline layout is not in the key, but its
+// descriptor types and push constant ranges are: pipeline layouts created from identical
+// definitions are compatible. The caller must free key->data.
+static void graphics_key(DvzGraphics* graphics, GraphicsKey* key)
+{
+    ANN(graphics);
+    ANN(graphics->renderpass);
+    ANN(key);
+    GraphicsKey* k = key;
+
+    KEY_FIELD(k, graphics->renderpass->renderpass);
+    KEY_FIELD(k, graphics->subpass);
+    KEY_FIELD(k, graphics->support_pick);
+    int pick_write = graphics->flags & DVZ_GRAPHICS_FLAGS_PICK;
+    KEY_FIELD(k, pick_write);
+    KEY_FIELD(k, graphics->topology);
+    KEY_FIELD(k, graphics->blend_type);
+    KEY_FIELD(k, graphics->color_mask);
+    KEY_FIELD(k, graphics->depth_test);
+    KEY_FIELD(k, graphics->polygon_mode);
+    KEY_FIELD(k, graphics->cull_mode);
+    KEY_FIELD(k, graphics->front_face);
+
+    // Vertex input.
+    KEY_FIELD(k, graphics->vertex_binding_count);
+    for (uint32_t i = 0; i < graphics->vertex_binding_count; i++)
+    {
+        KEY_FIELD(k, graphics->vertex_bindings[i].binding);
+        KEY_FIELD(k, graphics->vertex_bindings[i].stride);
+        KEY_FIELD(k, graphics->vertex_bindings[i].input_rate);
+    }
+    KEY_FIELD(k, graphics->vertex_attr_count);
+    for (uint32_t i = 0; i < graphics->vertex_attr_count; i++)
+    {
+        KEY_FIELD(k, graphics->vertex_attrs[i].binding);
+        KEY_FIELD(k, graphics->vertex_attrs[i].location);
+        KEY_FIELD(k, graphics->vertex_attrs[i].format);
+        KEY_FIELD(k, graphics->vertex_attrs[i].offset);
+    }
+
+    // Shaders and specialization constants.
+    DvzSpecializationConstants* spec_consts = NULL;
+    KEY_FIELD(k, graphics->shader_count);
+    for (uint32_t i = 0; i < graphics->shader_count; i++)
+    {
+        KEY_FIELD(k, graphics->shader_stages[i]);
+        KEY_FIELD(k, graphics->shader_modules[i]);
+
+        spec_consts = &graphics->spec_consts[i];
+        KEY_FIELD(k, spec_consts->count);
+        for (uint32_t j = 0; j < spec_consts->count; j++)
+        {
+            KEY_FIELD(k, spec_consts->ids[j]);
+            KEY_FIELD(k, spec_consts->sizes[j]);
+            key_append(k, spec_consts->sizes[j], spec_consts->data[j]);
+        }
+    }
+
+    // Pipeline layout definition.
+    DvzSlots* dslots = &graphics->dslots;
+    KEY_FIELD(k, dslots->slot_count);
+    key_append(k, dslots->slot_count * sizeof(VkDescriptorType), dslots->types);
+    KEY_FIELD(k, dslots->push_count);
+    for (uint32_t i = 0; i < dslots->push_count; i++)
+    {
+        KEY_FIELD(k, dslots->push_offsets[i]);
+        KEY_FIELD(k, dslots->push_sizes[i]);
+        KEY_FIELD(k, dslots->push_stages[i]);
+    }
+}
+
+
+
 /*************************************************************************************************/
 /*  Compute                                                                                      */
 /*************************************************************************************************/
 
 static void create_compute_pipeline(
-    VkDevice device, VkShaderModule shader_module, VkPipelineLayout pipeline_layout,
-    VkPipeline* pipeline)
+    VkDevice device, VkPipelineCache cache, VkShaderModule shader_module,
+    VkPipelineLayout pipeline_layout, VkPipeline* pipeline)
 {
     // Create the shader and pipeline.
     VkComputePipelineCreateInfo pipelineInfo = {0};
@@ -929,8 +1122,7 @@ static void create_compute_pipeline(
     pipelineInfo.stage.pName = "main";
     pipelineInfo.stage.module = shader_module;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-    VK_CHECK_RESULT(
-        vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, pipeline));
+    VK_CHECK_RESULT(vkCreateComputePipelines(device, cache, 1, &pipelineInfo, NULL, pipeline));
 }
 
 
@@ -1034,6 +1226,136 @@ create_color_blend_attachment(DvzBlendType blend_type, VkColorComponentFlags mas
 
 
 
+// Additive blending of the weighted color sum (accum), multiplicative blending of the revealage.
+static VkPipelineColorBlendAttachmentState create_oit_blend_attachment(bool reveal, bool enable)
+{
+    VkPipelineColorBlendAttachmentState attachment = {0};
+    attachment.colorWriteMask = enable ? DVZ_MASK_COLOR_ALL : 0;
+    attachment.blendEnable = VK_TRUE;
+
+    attachment.srcColorBlendFactor = reveal ? VK_BLEND_FACTOR_ZERO : VK_BLEND_FACTOR_ONE;
+    attachment.dstColorBlendFactor =
+        reveal ? VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR : VK_BLEND_FACTOR_ONE;
+    attachment.colorBlendOp = VK_BLEND_OP_ADD;
+
+    attachment.srcAlphaBlendFactor = attachment.srcColorBlendFactor;
+    attachment.dstAlphaBlendFactor = attachment.dstColorBlendFactor;
+    attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    return attachment;
+}
+
+
+
+// Whether two renderpasses have the same attachments, in which case a graphics pipeline created
+// with one of them can be used with the other.
+static bool renderpass_compatible(DvzRenderpass* a, DvzRenderpass* b)
+{
+    ANN(a);
+    ANN(b);
+    if (a == b)
+        return true;
+    if (a->attachment_count != b->attachment_count || a->subpass_count != b->subpass_count)
+        return false;
+    for (uint32_t i = 0; i < a->attachment_count; i++)
+    {
+        if (a->attachments[i].type != b->attachments[i].type ||
+            a->attachments[i].format != b->attachments[i].format)
+            return false;
+    }
+    return true;
+}
+
+
+
+// Whether a renderpass has a pick attachment.
+static bool has_pick(DvzRenderpass* renderpass)
+{
+    ANN(renderpass);
+    for (uint32_t i = 0; i < renderpass->attachment_count; i++)
+    {
+        if (renderpass->attachments[i].type == DVZ_RENDERPASS_ATTACHMENT_PICK)
+            return true;
+    }
+    return false;
+}
+
+
+
+// Whether the graphics pipeline renders into the order-independent transparency attachments.
+static bool has_oit(DvzGraphics* graphics)
+{
+    ANN(graphics);
+    if (graphics->blend_type != DVZ_BLEND_OIT || graphics->renderpass == NULL)
+        return false;
+
+    DvzRenderpass* renderpass = graphics->renderpass;
+    DvzRenderpassSubpass* subpass = &renderpass->subpasses[graphics->subpass];
+    uint32_t attachment = 0;
+    for (uint32_t i = 0; i < subpass->attachment_count; i++)
+    {
+        attachment = subpass->attachments[i];
+        if (attachment != VK_ATTACHMENT_UNUSED &&
+            renderpass->attachments[attachment].type == DVZ_RENDERPASS_ATTACHMENT_ACCUM)
+            return true;
+    }
+    return false;
+}
+
+
+
+// One blend attachment per color attachment of the graphics subpass, in the same order.
+static uint32_t
+create_blend_attachments(DvzGraphics* graphics, VkPipelineColorBlendAttachmentState* attachments)
+{
+    ANN(graphics);
+    ANN(graphics->renderpass);
+    ANN(attachments);
+
+    DvzRenderpass* renderpass = graphics->renderpass;
+    DvzRenderpassSubpass* subpass = &renderpass->subpasses[graphics->subpass];
+    bool oit = has_oit(graphics);
+
+    // NOTE: with order-independent transparency, translucent fragments only go to the accum and
+    // reveal attachments, the composite subpass blends them onto the color attachment.
+    VkColorComponentFlags color_mask = oit ? 0 : (VkColorComponentFlags)graphics->color_mask;
+    // NOTE: graphics that do not output pick values must not write into the pick attachment.
+    VkColorComponentFlags pick_mask =
+        (graphics->flags & DVZ_GRAPHICS_FLAGS_PICK) != 0 ? DVZ_MASK_COLOR_ALL : 0;
+
+    uint32_t count = 0;
+    uint32_t attachment = 0;
+    for (uint32_t i = 0; i < subpass->attachment_count; i++)
+    {
+        attachment = subpass->attachments[i];
+        if (attachment == VK_ATTACHMENT_UNUSED)
+        {
+            attachments[count++] = create_color_blend_attachment(DVZ_BLEND_DISABLE, 0);
+            continue;
+        }
+        switch (renderpass->attachments[attachment].type)
+        {
+        case DVZ_RENDERPASS_ATTACHMENT_DEPTH:
+            break;
+        case DVZ_RENDERPASS_ATTACHMENT_PICK:
+            attachments[count++] = create_color_blend_attachment(DVZ_BLEND_DISABLE, pick_mask);
+            break;
+        case DVZ_RENDERPASS_ATTACHMENT_ACCUM:
+            attachments[count++] = create_oit_blend_attachment(false, oit);
+            break;
+        case DVZ_RENDERPASS_ATTACHMENT_REVEAL:
+            attachments[count++] = create_oit_blend_attachment(true, oit);
+            break;
+        default:
+            attachments[count++] = create_color_blend_attachment(graphics->blend_type, color_mask);
+            break;
+        }
+    }
+    return count;
+}
+
+
+
 static VkPipelineColorBlendStateCreateInfo
 create_color_blend(uint32_t count, VkPipelineColorBlendAttachmentState* attachments)
 {
@@ -1052,15 +1374,14 @@ create_color_blend(uint32_t count, VkPipelineColorBlendAttachmentState* attachme
 
 
 
-static VkPipelineDepthStencilStateCreateInfo create_depth_stencil(bool enable)
+static VkPipelineDepthStencilStateCreateInfo create_depth_stencil(bool enable, bool write)
 {
     VkPipelineDepthStencilStateCreateInfo depth_stencil = {0};
     depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     depth_stencil.depthTestEnable = enable;
     depth_stencil.depthCompareOp = VK_COMPARE_OP_LESS;
 
-    depth_stencil.depthWriteEnable = VK_TRUE;
-    // depth_stencil.depthWriteEnable = VK_FALSE;
+    depth_stencil.depthWriteEnable = write;
     depth_stencil.stencilTestEnable = VK_FALSE;
 
     depth_stencil.depthBoundsTestEnable = VK_FALSE;
@@ -1156,7 +1477,7 @@ static void begin_render_pass(
 
 static void make_renderpass(
     DvzGpu* gpu, DvzRenderpass* renderpass, DvzFormat format, VkImageLayout layout,
-    VkClearColorValue clear_color)
+    VkClearColorValue clear_color, int flags)
 {
     ANN(gpu);
     ANN(renderpass);
@@ -1191,9 +1512,85 @@ static void make_renderpass(
     dvz_renderpass_attachment_ops(
         renderpass, 1, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_DONT_CARE);
 
+    bool pick = (flags & DVZ_RENDERPASS_FLAGS_PICK) != 0;
+    bool oit = (flags & DVZ_RENDERPASS_FLAGS_OIT) != 0;
+    uint32_t idx = 2;
+
+    // Pick attachment, cleared to 0 (no visual) and read back by the picker.
+    uint32_t pick_idx = VK_ATTACHMENT_UNUSED;
+    if (pick)
+    {
+        pick_idx = idx++;
+        dvz_renderpass_clear(renderpass, (VkClearValue){0});
+        dvz_renderpass_attachment(
+            renderpass, pick_idx, //
+            DVZ_RENDERPASS_ATTACHMENT_PICK, DVZ_PICK_IMAGE_FORMAT,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        dvz_renderpass_attachment_layout(
+            renderpass, pick_idx, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        dvz_renderpass_attachment_ops(
+            renderpass, pick_idx, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE);
+    }
+
+    // Order-independent transparency attachments, only used within the renderpass: the accum
+    // attachment is cleared to 0, the reveal attachment to 1 (fully transparent).
+    uint32_t accum_idx = VK_ATTACHMENT_UNUSED;
+    uint32_t reveal_idx = VK_ATTACHMENT_UNUSED;
+    if (oit)
+    {
+        accum_idx = idx++;
+        dvz_renderpass_clear(renderpass, (VkClearValue){0});
+        dvz_renderpass_attachment(
+            renderpass, accum_idx, //
+            DVZ_RENDERPASS_ATTACHMENT_ACCUM, DVZ_OIT_ACCUM_FORMAT,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        dvz_renderpass_attachment_layout(
+            renderpass, accum_idx, VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        dvz_renderpass_attachment_ops(
+            renderpass, accum_idx, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_DONT_CARE);
+
+        reveal_idx = idx++;
+        dvz_renderpass_clear(renderpass, (VkClearValue){.color.float32 = {1, 1, 1, 1}});
+        dvz_renderpass_attachment(
+            renderpass, reveal_idx, //
+            DVZ_RENDERPASS_ATTACHMENT_REVEAL, DVZ_OIT_REVEAL_FORMAT,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        dvz_renderpass_attachment_layout(
+            renderpass, reveal_idx, VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        dvz_renderpass_attachment_ops(
+            renderpass, reveal_idx, VK_ATTACHMENT_LOAD_OP_CLEAR,
+            VK_ATTACHMENT_STORE_OP_DONT_CARE);
+    }
+
     // Subpass.
     dvz_renderpass_subpass_attachment(renderpass, 0, 0);
     dvz_renderpass_subpass_attachment(renderpass, 0, 1);
+    // NOTE: the pick slot is kept (unused) with OIT so that the accum and reveal outputs are
+    // always at the locations 2 and 3.
+    if (pick || oit)
+        dvz_renderpass_subpass_attachment(renderpass, 0, pick_idx);
+    if (oit)
+    {
+        dvz_renderpass_subpass_attachment(renderpass, 0, accum_idx);
+        dvz_renderpass_subpass_attachment(renderpass, 0, reveal_idx);
+
+        // Composite subpass.
+        dvz_renderpass_subpass_attachment(renderpass, 1, 0);
+        dvz_renderpass_subpass_input(renderpass, 1, accum_idx);
+        dvz_renderpass_subpass_input(renderpass, 1, reveal_idx);
+
+        dvz_renderpass_subpass_dependency(renderpass, 0, 0, 1);
+        dvz_renderpass_subpass_dependency_stage(
+            renderpass, 0, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        dvz_renderpass_subpass_dependency_access(
+            renderpass, 0, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+    }
 
     // Create renderpass.
     dvz_renderpass_create(renderpass);
@@ -26,6 +26,40 @@ static bool _has_overlay(int flags) { return (flags & DVZ_WORKSPACE_FLAGS_OVERLA
 
 
 
+// Renderpass flags corresponding to the canvas flags.
+static int _renderpass_flags(int flags)
+{
+    int rp_flags = DVZ_RENDERPASS_FLAGS_NONE;
+    if ((flags & DVZ_CANVAS_FLAGS_PICK) != 0)
+        rp_flags |= DVZ_RENDERPASS_FLAGS_PICK;
+    if ((flags & DVZ_CANVAS_FLAGS_OIT) != 0)
+        rp_flags |= DVZ_RENDERPASS_FLAGS_OIT;
+    return rp_flags;
+}
+
+
+
+// NOTE: the overlay renderpass has no pick or OIT attachment.
+static int _ext_flags(int flags)
+{
+    if (!_has_overlay(flags))
+        return flags;
+    if ((flags & DVZ_CANVAS_FLAGS_PICK) != 0)
+    {
+        log_warn("picking is not supported on canvases with an overlay, disabling it");
+        flags &= ~DVZ_CANVAS_FLAGS_PICK;
+    }
+    if ((flags & DVZ_CANVAS_FLAGS_OIT) != 0)
+    {
+        log_warn("order-independent transparency is not supported on canvases with an overlay, "
+                 "disabling it");
+        flags &= ~DVZ_CANVAS_FLAGS_OIT;
+    }
+    return flags;
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -52,6 +86,9 @@ DvzWorkspace* dvz_workspace(DvzGpu* gpu, int flags)
         dvz_gpu_renderpass(gpu, clear_color, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
     ws->renderpass_offscreen =
         dvz_gpu_renderpass(gpu, clear_color, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    for (int i = 1; i < DVZ_RENDERPASS_FLAGS_COUNT; i++)
+        ws->renderpass_ext_offscreen[i] = dvz_gpu_renderpass_flags(
+            gpu, clear_color, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, i);
 
     // NOTE: we only create the desktop renderpass if we use the glfw backend.
     // This avoids the following validation error:
@@ -67,6 +104,9 @@ DvzWorkspace* dvz_workspace(DvzGpu* gpu, int flags)
     {
         ws->renderpass_desktop =
             dvz_gpu_renderpass(gpu, clear_color, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        for (int i = 1; i < DVZ_RENDERPASS_FLAGS_COUNT; i++)
+            ws->renderpass_ext_desktop[i] = dvz_gpu_renderpass_flags(
+                gpu, clear_color, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, i);
     }
 
     dvz_obj_init(&ws->obj);
@@ -81,9 +121,13 @@ DvzCanvas* dvz_workspace_board(DvzWorkspace* workspace, uint32_t width, uint32_t
     ANN(workspace->gpu);
 
     DvzCanvas* board = (DvzCanvas*)dvz_container_alloc(&workspace->boards);
+    flags = _ext_flags(flags);
 
     DvzRenderpass* renderpass =
         _has_overlay(flags) ? &workspace->renderpass_overlay : &workspace->renderpass_offscreen;
+    int rp_flags = _renderpass_flags(flags);
+    if (rp_flags != DVZ_RENDERPASS_FLAGS_NONE)
+        renderpass = &workspace->renderpass_ext_offscreen[rp_flags];
 
     *board = dvz_board(workspace->gpu, renderpass, width, height, flags);
     // dvz_board_clear_color(board, background);
@@ -99,9 +143,13 @@ dvz_workspace_canvas(DvzWorkspace* workspace, uint32_t width, uint32_t height, i
 {
     ANN(workspace);
     DvzCanvas* canvas = (DvzCanvas*)dvz_container_alloc(&workspace->canvases);
+    flags = _ext_flags(flags);
 
     DvzRenderpass* renderpass =
         _has_overlay(flags) ? &workspace->renderpass_overlay : &workspace->renderpass_desktop;
+    int rp_flags = _renderpass_flags(flags);
+    if (rp_flags != DVZ_RENDERPASS_FLAGS_NONE)
+        renderpass = &workspace->renderpass_ext_desktop[rp_flags];
 
     *canvas = dvz_canvas(workspace->gpu, renderpass, width, height, flags);
 
@@ -129,6 +177,11 @@ void dvz_workspace_destroy(DvzWorkspace* workspace)
     dvz_renderpass_destroy(&workspace->renderpass_overlay);
     dvz_renderpass_destroy(&workspace->renderpass_offscreen);
     dvz_renderpass_destroy(&workspace->renderpass_desktop);
+    for (int i = 1; i < DVZ_RENDERPASS_FLAGS_COUNT; i++)
+    {
+        dvz_renderpass_destroy(&workspace->renderpass_ext_offscreen[i]);
+        dvz_renderpass_destroy(&workspace->renderpass_ext_desktop[i]);
+    }
 
     dvz_obj_destroyed(&workspace->obj);
     FREE(workspace);
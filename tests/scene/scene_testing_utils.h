@@ -19,10 +19,12 @@
 
 #include "../testing_utils.h"
 #include "_map.h"
+#include "_time_utils.h"
 #include "canvas.h"
 #include "datoviz.h"
 #include "datoviz_math.h"
 #include "fileio.h"
+#include "scene/pool.h"
 #include "scene/visuals/image.h"
 #include "scene/visuals/volume.h"
 #include "testing.h"
@@ -144,4 +146,28 @@ static DvzTexture* load_brain_volume(DvzBatch* batch, uvec3 out_shape, bool use_
 
 
 
+/*************************************************************************************************/
+/*  Pool utils                                                                                   */
+/*************************************************************************************************/
+
+// Call an update function until the loader thread of a pool is idle and the given items are
+// loaded. The items and their count may be modified by the update function.
+static int settle_pool(
+    DvzPool* pool, void (*update)(void*), void* user_data, uint32_t* items, uint32_t* count)
+{
+    ANN(pool);
+    ANN(update);
+    ANN(count);
+    for (uint32_t iter = 0; iter < 5000; iter++)
+    {
+        update(user_data);
+        if (dvz_pool_ready(pool, *count, items))
+            return 0;
+        dvz_sleep(1);
+    }
+    return 1;
+}
+
+
+
 #endif
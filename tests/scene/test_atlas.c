@@ -16,6 +16,7 @@
 
 #include "test_atlas.h"
 #include "_cglm.h"
+#include "_time_utils.h"
 #include "scene/atlas.h"
 #include "test.h"
 #include "testing.h"
@@ -107,3 +108,118 @@ int test_atlas_1(TstSuite* suite)
     dvz_atlas_destroy(atlas);
     return 0;
 }
+
+
+
+int test_atlas_2(TstSuite* suite)
+{
+    ANN(suite);
+    unsigned long ttf_size = 0;
+    unsigned char* ttf_bytes = dvz_resource_font("Roboto_Medium", &ttf_size);
+    ASSERT(ttf_size > 0);
+    ANN(ttf_bytes);
+
+    // Empty dynamic atlas.
+    DvzAtlas* atlas = dvz_atlas(ttf_size, ttf_bytes);
+    dvz_atlas_dynamic(atlas);
+    AT(dvz_atlas_is_dynamic(atlas));
+    AT(dvz_atlas_valid(atlas));
+
+    uvec3 shape = {0};
+    dvz_atlas_shape(atlas, shape);
+    uint32_t w0 = shape[0];
+    uint32_t h0 = shape[1];
+
+    // Insert a few glyphs, only once.
+    AT(dvz_atlas_insert(atlas, 3, (uint32_t[]){65, 66, 65}) == 2);
+    AT(dvz_atlas_insert(atlas, 2, (uint32_t[]){65, 66}) == 0);
+
+    vec4 coords = {0};
+    AT(dvz_atlas_glyph(atlas, 65, coords) == 0);
+    AT(coords[2] > 0);
+    AT(coords[3] > 0);
+    AT(dvz_atlas_glyph(atlas, 67, coords) != 0);
+
+    // Insert many glyphs so that the atlas has to grow.
+    const uint32_t n = 95 + 95;
+    uint32_t codepoints[95 + 95] = {0};
+    for (uint32_t i = 0; i < 95; i++)
+    {
+        codepoints[i] = 32 + i;       // ASCII
+        codepoints[95 + i] = 161 + i; // Latin-1
+    }
+    AT(dvz_atlas_insert(atlas, n, codepoints) > 0);
+    dvz_atlas_shape(atlas, shape);
+    AT(shape[0] * shape[1] > w0 * h0);
+
+    // All glyphs are within the atlas and do not overlap.
+    vec4* rects = (vec4*)calloc(n, sizeof(vec4));
+    dvz_atlas_glyphs(atlas, n, codepoints, rects);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        AT(rects[i][0] + rects[i][2] <= shape[0]);
+        AT(rects[i][1] + rects[i][3] <= shape[1]);
+        for (uint32_t j = 0; j < i; j++)
+        {
+            if (rects[i][2] == 0 || rects[j][2] == 0)
+                continue;
+            bool disjoint = rects[i][0] + rects[i][2] <= rects[j][0] ||
+                            rects[j][0] + rects[j][2] <= rects[i][0] ||
+                            rects[i][1] + rects[i][3] <= rects[j][1] ||
+                            rects[j][1] + rects[j][3] <= rects[i][1];
+            AT(disjoint);
+        }
+    }
+    FREE(rects);
+
+    char imgpath[1024] = {0};
+    snprintf(imgpath, sizeof(imgpath), "%s/atlas_dynamic.png", ARTIFACTS_DIR);
+    dvz_atlas_png(atlas, imgpath);
+
+    dvz_atlas_destroy(atlas);
+    return 0;
+}
+
+
+
+int test_atlas_3(TstSuite* suite)
+{
+    ANN(suite);
+    unsigned long ttf_size = 0;
+    unsigned char* ttf_bytes = dvz_resource_font("Roboto_Medium", &ttf_size);
+    ASSERT(ttf_size > 0);
+    ANN(ttf_bytes);
+    uint32_t codepoints[] = {65, 66, 67, 9785};
+
+    // The first generation fills the cache (unless DVZ_NO_CACHE is set).
+    DvzAtlas* atlas = dvz_atlas(ttf_size, ttf_bytes);
+    dvz_atlas_codepoints(atlas, 4, codepoints);
+    DvzClock clock = dvz_clock();
+    dvz_atlas_generate(atlas);
+    double t0 = dvz_clock_get(&clock);
+    AT(dvz_atlas_valid(atlas));
+
+    // The second one loads the same atlas from the cache.
+    DvzAtlas* cached = dvz_atlas(ttf_size, ttf_bytes);
+    dvz_atlas_codepoints(cached, 4, codepoints);
+    clock = dvz_clock();
+    dvz_atlas_generate(cached);
+    double t1 = dvz_clock_get(&clock);
+    AT(dvz_atlas_valid(cached));
+    log_info("atlas generation: %.1f ms, cached: %.1f ms", t0 * 1000, t1 * 1000);
+
+    AT(dvz_atlas_size(atlas) == dvz_atlas_size(cached));
+    AT(memcmp(dvz_atlas_rgb(atlas), dvz_atlas_rgb(cached), dvz_atlas_size(atlas)) == 0);
+
+    vec4 coords = {0}, cached_coords = {0};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        AT(dvz_atlas_glyph(atlas, codepoints[i], coords) == 0);
+        AT(dvz_atlas_glyph(cached, codepoints[i], cached_coords) == 0);
+        AT(memcmp(coords, cached_coords, sizeof(vec4)) == 0);
+    }
+
+    dvz_atlas_destroy(atlas);
+    dvz_atlas_destroy(cached);
+    return 0;
+}
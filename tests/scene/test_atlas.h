@@ -27,6 +27,10 @@
 
 int test_atlas_1(TstSuite*);
 
+int test_atlas_2(TstSuite*);
+
+int test_atlas_3(TstSuite*);
+
 
 
 #endif
@@ -104,3 +104,62 @@ int test_axis_1(TstSuite* suite)
 
     return 0;
 }
+
+
+
+int test_axis_2(TstSuite* suite)
+{
+    ANN(suite);
+
+#if !HAS_MSDF
+    return 1;
+#endif
+    DvzBatch* batch = dvz_batch();
+
+    DvzAtlasFont af = {0};
+    dvz_atlas_font(18, &af);
+
+    DvzRef* ref = dvz_ref(0);
+    dvz_ref_set(ref, DVZ_DIM_X, -5, +5);
+
+    DvzAxis* axis = dvz_axis(batch, &af, DVZ_DIM_X, 0);
+    dvz_axis_size(axis, 600, 18);
+    dvz_axis_horizontal(axis, 0);
+    DvzAxisGlyphs* g = &axis->tick_glyphs;
+
+    // First update: all labels are laid out and written.
+    AT(dvz_axis_update(axis, ref, -5, +5));
+    uint32_t n = g->slot_count;
+    AT(n > 0);
+    AT(g->misses == n);
+    AT(g->written == n);
+    AT(g->reused == 0);
+
+    // One group per slot, covering all allocated glyphs.
+    AT(axis->glyph->group_count >= n);
+    uint32_t total = 0;
+    for (uint32_t j = 0; j < axis->glyph->group_count; j++)
+        total += axis->glyph->group_sizes[j];
+    AT(total == g->glyph_count);
+
+    // Pan by one tick: most labels keep their glyphs, only the new ones are written.
+    double lmin = 0, lmax = 0, lstep = 0;
+    dvz_ticks_range(axis->ticks, &lmin, &lmax, &lstep);
+    AT(lstep > 0);
+    AT(dvz_axis_update(axis, ref, -5 + lstep, +5 + lstep));
+    AT(g->reused > 0);
+    AT(g->written < 2 * n);
+    uint64_t misses = g->misses;
+
+    // Pan back: the labels that went out of view come from the layout cache.
+    AT(dvz_axis_update(axis, ref, -5, +5));
+    AT(g->misses == misses);
+    AT(g->hits > 0);
+
+    dvz_axis_destroy(axis);
+    dvz_ref_destroy(ref);
+    dvz_font_destroy(af.font);
+    dvz_atlas_destroy(af.atlas);
+    dvz_batch_destroy(batch);
+    return 0;
+}
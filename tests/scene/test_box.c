@@ -17,6 +17,10 @@
 #include "test_box.h"
 #include "datoviz.h"
 #include "scene/box.h"
+#include "scene/camera.h"
+#include "scene/mvp.h"
+#include "scene/panzoom.h"
+#include "scene/viewport.h"
 #include "test.h"
 #include "testing.h"
 #include "testing_utils.h"
@@ -161,3 +165,81 @@ int test_box_6(TstSuite* suite)
 
     return 0;
 }
+
+
+
+int test_box_visible(TstSuite* suite)
+{
+    ANN(suite);
+
+    DvzViewport viewport = {0};
+    dvz_viewport_default(WIDTH, HEIGHT, &viewport);
+    DvzMVP mvp = {0};
+    dvz_mvp_default(&mvp);
+
+    DvzBox inside = dvz_box(-.5, .5, -.5, .5, 0, 0);
+    DvzBox right = dvz_box(1.5, 2.5, -.5, .5, 0, 0);
+    DvzBox around = dvz_box(-10, 10, -10, 10, 0, 0);
+    DvzBox empty = dvz_box(+INFINITY, -INFINITY, +INFINITY, -INFINITY, +INFINITY, -INFINITY);
+
+    // Identity MVP.
+    AT(dvz_box_visible(inside, &mvp, &viewport, 0));
+    AT(!dvz_box_visible(right, &mvp, &viewport, 0));
+    AT(dvz_box_visible(around, &mvp, &viewport, 0)); // no corner in the view
+    AT(!dvz_box_visible(empty, &mvp, &viewport, 0));
+
+    // The right box is at 0.5 NDC, that is 200 pixels, from the right border of the view.
+    AT(!dvz_box_visible(right, &mvp, &viewport, 190));
+    AT(dvz_box_visible(right, &mvp, &viewport, 210));
+
+    // Viewport margins: a left margin shifts the data to the right.
+    DvzBox left = dvz_box(-1.2, -1.1, -.5, .5, 0, 0);
+    AT(!dvz_box_visible(left, &mvp, &viewport, 0));
+    dvz_viewport_margins(&viewport, (vec4){0, 0, 0, WIDTH / 4});
+    AT(dvz_box_visible(left, &mvp, &viewport, 0));
+    dvz_viewport_margins(&viewport, (vec4){0, 0, 0, 0});
+
+    // Panzoom.
+    {
+        DvzPanzoom* pz = dvz_panzoom(WIDTH, HEIGHT, 0);
+
+        pz->pan[0] = -2;
+        dvz_panzoom_mvp(pz, &mvp);
+        AT(!dvz_box_visible(inside, &mvp, &viewport, 0));
+        AT(dvz_box_visible(right, &mvp, &viewport, 0));
+
+        // Zoom out: the right box enters the view.
+        pz->pan[0] = 0;
+        pz->zoom[0] = pz->zoom[1] = .25;
+        dvz_panzoom_mvp(pz, &mvp);
+        AT(dvz_box_visible(inside, &mvp, &viewport, 0));
+        AT(dvz_box_visible(right, &mvp, &viewport, 0));
+
+        // Zoom in: the right box leaves the view.
+        pz->zoom[0] = pz->zoom[1] = 4;
+        dvz_panzoom_mvp(pz, &mvp);
+        AT(dvz_box_visible(inside, &mvp, &viewport, 0));
+        AT(!dvz_box_visible(right, &mvp, &viewport, 0));
+
+        dvz_panzoom_destroy(pz);
+    }
+
+    // Perspective camera at (0, 0, 4), looking at the origin.
+    {
+        DvzCamera* camera = dvz_camera(WIDTH, HEIGHT, 0);
+        dvz_mvp_default(&mvp);
+        dvz_camera_mvp(camera, &mvp);
+
+        AT(dvz_box_visible(inside, &mvp, &viewport, 0));
+        AT(!dvz_box_visible(dvz_box(100, 101, -.5, .5, 0, 0), &mvp, &viewport, 0));
+
+        // Behind the camera, beyond the far plane, and across the camera plane.
+        AT(!dvz_box_visible(dvz_box(-.5, .5, -.5, .5, 5, 6), &mvp, &viewport, 0));
+        AT(!dvz_box_visible(dvz_box(-.5, .5, -.5, .5, -200, -150), &mvp, &viewport, 0));
+        AT(dvz_box_visible(dvz_box(-.1, .1, -.1, .1, 3, 5), &mvp, &viewport, 0));
+
+        dvz_camera_destroy(camera);
+    }
+
+    return 0;
+}
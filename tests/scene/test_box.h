@@ -37,6 +37,8 @@ int test_box_5(TstSuite*);
 
 int test_box_6(TstSuite*);
 
+int test_box_visible(TstSuite*);
+
 
 
 #endif
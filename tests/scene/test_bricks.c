@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing bricks                                                                               */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/test_bricks.h"
+#include "_time_utils.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "fileio.h"
+#include "scene/bricks.h"
+#include "scene/scene_testing_utils.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+#define VOLUME_WIDTH  40
+#define VOLUME_HEIGHT 36
+#define VOLUME_DEPTH  20
+
+
+
+// Zero in the first 16 slices, non-zero elsewhere.
+static inline uint8_t _voxel(uint32_t x, uint32_t y, uint32_t z)
+{
+    return z < 16 ? 0 : (uint8_t)(1 + (x + 3 * y + 7 * z) % 250);
+}
+
+
+
+static void _brick_callback(
+    DvzBricks* bricks, uint32_t level, uvec3 offset, uvec3 shape, void* out, void* user_data)
+{
+    ANN(bricks);
+    ANN(out);
+
+    uint32_t* count = (uint32_t*)user_data;
+    if (count != NULL)
+        (*count)++;
+
+    uint8_t* p = (uint8_t*)out;
+    uint32_t f = 1u << level;
+    for (uint32_t k = 0; k < shape[2]; k++)
+        for (uint32_t j = 0; j < shape[1]; j++)
+            for (uint32_t i = 0; i < shape[0]; i++)
+                *p++ = _voxel(
+                    MIN((offset[0] + i) * f, VOLUME_WIDTH - 1),
+                    MIN((offset[1] + j) * f, VOLUME_HEIGHT - 1),
+                    MIN((offset[2] + k) * f, VOLUME_DEPTH - 1));
+}
+
+
+
+typedef struct
+{
+    DvzBricks* bricks;
+    float* eye;
+} _BricksView;
+
+
+
+static void _update(void* user_data)
+{
+    _BricksView* view = (_BricksView*)user_data;
+    ANN(view);
+    dvz_bricks_update(view->bricks, view->eye, 2);
+}
+
+
+
+// Update the bricks until all the selected bricks are loaded.
+static int _settle(DvzBricks* bricks, vec3 eye)
+{
+    ANN(bricks);
+    _BricksView view = {bricks, eye};
+    return settle_pool(
+        bricks->cache, _update, &view, bricks->selection, &bricks->selection_count);
+}
+
+
+
+// Check that each level-0 brick points to a resident brick covering it.
+static int _check_indirection(DvzBricks* bricks)
+{
+    ANN(bricks);
+    uint32_t* g = bricks->grids[0];
+    uint32_t level = 0, slot = 0, brick = 0;
+    int32_t e = 0;
+    for (uint32_t k = 0; k < g[2]; k++)
+    {
+        for (uint32_t j = 0; j < g[1]; j++)
+        {
+            for (uint32_t i = 0; i < g[0]; i++)
+            {
+                e = (int32_t)bricks->indirection[(k * g[1] + j) * g[0] + i];
+                if (e < 0)
+                    continue;
+                level = (uint32_t)e % DVZ_BRICKS_MAX_LEVELS;
+                slot = (uint32_t)e / DVZ_BRICKS_MAX_LEVELS;
+                AT(slot < bricks->capacity);
+                brick = dvz_bricks_index(
+                    bricks, level, (uvec3){i >> level, j >> level, k >> level});
+                AT(bricks->cache->entries[slot].item == brick);
+                AT(bricks->cache->states[brick] == DVZ_POOL_STATE_RESIDENT);
+            }
+        }
+    }
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/*  Bricks tests                                                                                 */
+/*************************************************************************************************/
+
+int test_bricks_1(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+    DvzBricks* bricks = dvz_bricks(
+        batch, DVZ_FORMAT_R8_UNORM, (uvec3){VOLUME_WIDTH, VOLUME_HEIGHT, VOLUME_DEPTH}, 8, 64, 0);
+    const uint32_t p = 8 + 2;
+
+    // Levels of detail.
+    AT(bricks->level_count == 4);
+    AT(bricks->grids[0][0] == 5);
+    AT(bricks->grids[0][1] == 5);
+    AT(bricks->grids[0][2] == 3);
+    AT(bricks->grids[1][0] == 3);
+    AT(bricks->grids[1][1] == 3);
+    AT(bricks->grids[1][2] == 2);
+    AT(bricks->grids[2][0] == 2);
+    AT(bricks->grids[2][1] == 2);
+    AT(bricks->grids[2][2] == 1);
+    AT(bricks->grids[3][0] == 1);
+    AT(bricks->grids[3][1] == 1);
+    AT(bricks->grids[3][2] == 1);
+    AT(bricks->brick_count == 75 + 18 + 4 + 1);
+    AT(dvz_bricks_index(bricks, 3, (uvec3){0, 0, 0}) == bricks->brick_count - 1);
+
+    uint32_t count = 0;
+    dvz_bricks_callback(bricks, _brick_callback, &count);
+
+    // Synchronous loading, with the apron.
+    uint8_t* data = (uint8_t*)calloc(p * p * p, 1);
+    AT(dvz_bricks_fetch(bricks, 0, (uvec3){0, 0, 0}, data));
+    AT(!dvz_bricks_fetch(bricks, 0, (uvec3){1, 2, 1}, data));
+    AT(count == 2);
+    // Voxel (0,0,0) of the brick is the apron voxel (7,15,7) of the volume.
+    AT(data[0] == _voxel(7, 15, 7));
+    AT(data[((1 * p + 1) * p + 1)] == _voxel(8, 16, 8));
+    // The apron is clamped on the border of the volume.
+    AT(!dvz_bricks_fetch(bricks, 0, (uvec3){4, 4, 2}, data));
+    AT(data[((p - 1) * p + p - 1) * p + p - 1] ==
+       _voxel(VOLUME_WIDTH - 1, VOLUME_HEIGHT - 1, VOLUME_DEPTH - 1));
+
+    // Load the bricks close to the origin.
+    AT(_settle(bricks, (vec3){0, 0, 0}) == 0);
+    AT(_check_indirection(bricks) == 0);
+
+    // The root brick is resident and pinned.
+    uint32_t root = bricks->brick_count - 1;
+    AT(bricks->cache->states[root] == DVZ_POOL_STATE_RESIDENT);
+    AT(bricks->cache->entries[bricks->cache->slots[root]].pinned);
+
+    // The finest level is used near the eye, and the corner brick is empty.
+    AT(bricks->cache->states[0] == DVZ_POOL_STATE_EMPTY);
+    AT(bricks->indirection[0] == -1);
+
+    // Move the eye to the opposite corner.
+    AT(_settle(bricks, (vec3){1, 1, 1}) == 0);
+    AT(_check_indirection(bricks) == 0);
+    uint32_t last = dvz_bricks_index(bricks, 0, (uvec3){4, 4, 2});
+    AT(bricks->cache->states[last] == DVZ_POOL_STATE_RESIDENT);
+
+    uint32_t resident = 0;
+    for (uint32_t i = 0; i < bricks->brick_count; i++)
+        resident += bricks->cache->states[i] == DVZ_POOL_STATE_RESIDENT;
+    AT(resident <= bricks->capacity);
+    AT(count >= 2 + resident);
+
+    FREE(data);
+    dvz_bricks_destroy(bricks);
+    dvz_batch_destroy(batch);
+    return 0;
+}
+
+
+
+int test_bricks_2(TstSuite* suite)
+{
+    // Write the volume in a raw file.
+    uint8_t* volume = (uint8_t*)calloc(VOLUME_WIDTH * VOLUME_HEIGHT * VOLUME_DEPTH, 1);
+    for (uint32_t k = 0; k < VOLUME_DEPTH; k++)
+        for (uint32_t j = 0; j < VOLUME_HEIGHT; j++)
+            for (uint32_t i = 0; i < VOLUME_WIDTH; i++)
+                volume[(k * VOLUME_HEIGHT + j) * VOLUME_WIDTH + i] = _voxel(i, j, k);
+
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/bricks.raw", ARTIFACTS_DIR);
+    const DvzSize header = 16;
+    uint8_t zeros[16] = {0};
+    dvz_write_bytes(path, "wb", header, zeros);
+    dvz_write_bytes(path, "ab", VOLUME_WIDTH * VOLUME_HEIGHT * VOLUME_DEPTH, volume);
+
+    DvzBatch* batch = dvz_batch();
+    DvzBricks* from_file = dvz_bricks(
+        batch, DVZ_FORMAT_R8_UNORM, (uvec3){VOLUME_WIDTH, VOLUME_HEIGHT, VOLUME_DEPTH}, 8, 32, 0);
+    dvz_bricks_file(from_file, path, header);
+    AT(from_file->mmap != NULL);
+
+    DvzBricks* from_callback = dvz_bricks(
+        batch, DVZ_FORMAT_R8_UNORM, (uvec3){VOLUME_WIDTH, VOLUME_HEIGHT, VOLUME_DEPTH}, 8, 32, 0);
+    dvz_bricks_callback(from_callback, _brick_callback, NULL);
+
+    // The bricks read from the memory-mapped file match the callback, at all levels.
+    const uint32_t p = 8 + 2;
+    uint8_t* a = (uint8_t*)calloc(p * p * p, 1);
+    uint8_t* b = (uint8_t*)calloc(p * p * p, 1);
+    uint32_t level = 0;
+    uvec3 ijk = {0};
+    for (uint32_t brick = 0; brick < from_file->brick_count; brick++)
+    {
+        level = brick < 75 ? 0 : brick < 93 ? 1 : brick < 97 ? 2 : 3;
+        uint32_t* g = from_file->grids[level];
+        uint32_t idx = brick - from_file->offsets[level];
+        ijk[0] = idx % g[0];
+        ijk[1] = (idx / g[0]) % g[1];
+        ijk[2] = idx / (g[0] * g[1]);
+        AT(dvz_bricks_index(from_file, level, ijk) == brick);
+
+        AT(dvz_bricks_fetch(from_file, level, ijk, a) ==
+           dvz_bricks_fetch(from_callback, level, ijk, b));
+        AT(memcmp(a, b, p * p * p) == 0);
+    }
+
+    // Streaming from the file.
+    AT(_settle(from_file, (vec3){.5, .5, .5}) == 0);
+    AT(_check_indirection(from_file) == 0);
+
+    FREE(a);
+    FREE(b);
+    FREE(volume);
+    dvz_bricks_destroy(from_file);
+    dvz_bricks_destroy(from_callback);
+    dvz_batch_destroy(batch);
+    return 0;
+}
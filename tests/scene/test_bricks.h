@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing bricks                                                                               */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_BRICKS
+#define DVZ_HEADER_TEST_BRICKS
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Bricks tests                                                                                 */
+/*************************************************************************************************/
+
+int test_bricks_1(TstSuite*);
+
+int test_bricks_2(TstSuite*);
+
+
+
+#endif
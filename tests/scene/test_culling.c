@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing culling                                                                              */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/test_culling.h"
+#include "_cglm.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "scene/culling.h"
+#include "scene/viewport.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static bool _check_indices(uint32_t n, DvzIndex* indices, uint32_t expected_n, DvzIndex* expected)
+{
+    if (n != expected_n)
+        return false;
+    for (uint32_t k = 0; k < n; k++)
+        if (indices[k] != expected[k])
+            return false;
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Culling tests                                                                                */
+/*************************************************************************************************/
+
+int test_culling_points(TstSuite* suite)
+{
+    // One vertex per item: position and size in pixels, as with the marker visual.
+    const uint32_t n = 6;
+    float vertices[6][4] = {
+        {0, 0, 0, 10},     // visible
+        {1.05, 0, 0, 10},  // visible thanks to its size
+        {1.2, 0, 0, 10},   // outside of the viewport
+        {0, -1.5, 0, 10},  // outside of the viewport
+        {0, 0, 2, 10},     // outside of the depth range
+        {0.5, 0.5, 0, 1}}; // visible, but small
+
+    DvzCullingParams params = {0};
+    params.count = n;
+    params.stride = 4;
+    params.pos_offset = 0;
+    params.size_offset = 3;
+    params.vertex_count = 1;
+    params.index_count = 1;
+
+    DvzMVP mvp = {0};
+    dvz_mvp_default(&mvp);
+    DvzViewport viewport = {0};
+    dvz_viewport_default(100, 100, &viewport);
+
+    DvzIndex indices[6] = {0};
+    uint32_t k = 0;
+
+    // Default.
+    k = dvz_culling_items(&params, &mvp, &viewport, (float*)vertices, indices);
+    AT(_check_indices(k, indices, 3, (DvzIndex[]){0, 1, 5}));
+
+    // Margin around the viewport.
+    params.margin = 10;
+    k = dvz_culling_items(&params, &mvp, &viewport, (float*)vertices, indices);
+    AT(_check_indices(k, indices, 4, (DvzIndex[]){0, 1, 2, 5}));
+    params.margin = 0;
+
+    // Minimum size.
+    params.min_size = 2;
+    k = dvz_culling_items(&params, &mvp, &viewport, (float*)vertices, indices);
+    AT(_check_indices(k, indices, 2, (DvzIndex[]){0, 1}));
+    params.min_size = 0;
+
+    // Subset of the items.
+    params.first = 1;
+    params.count = 3;
+    k = dvz_culling_items(&params, &mvp, &viewport, (float*)vertices, indices);
+    AT(_check_indices(k, indices, 1, (DvzIndex[]){1}));
+    params.first = 0;
+    params.count = n;
+
+    // Viewport margins: NDC are mapped to the inner region of the viewport.
+    dvz_viewport_margins(&viewport, (vec4){0, 50, 0, 0});
+    k = dvz_culling_items(&params, &mvp, &viewport, (float*)vertices, indices);
+    AT(_check_indices(k, indices, 4, (DvzIndex[]){0, 1, 2, 5}));
+    dvz_viewport_margins(&viewport, (vec4){0, 0, 0, 0});
+
+    // Panzoom-like MVP: zoom x2 around the origin.
+    mvp.view[0][0] = 2;
+    mvp.view[1][1] = 2;
+    k = dvz_culling_items(&params, &mvp, &viewport, (float*)vertices, indices);
+    AT(_check_indices(k, indices, 2, (DvzIndex[]){0, 5}));
+    dvz_mvp_default(&mvp);
+
+    // Perspective-like MVP with w = -z: the items behind the camera are culled.
+    mvp.proj[2][3] = -1;
+    mvp.proj[3][3] = 0;
+    AT(dvz_culling_visible(&params, &mvp, &viewport, (float[]){0, 0, -1, 10}));
+    AT(!dvz_culling_visible(&params, &mvp, &viewport, (float[]){0, 0, +1, 10}));
+
+    return 0;
+}
+
+
+
+int test_culling_quads(TstSuite* suite)
+{
+    // Four vertices and six indices per item, as with the glyph visual.
+    const uint32_t n = 3;
+    float x[3] = {0, 5, -0.5};
+    vec3 vertices[12] = {0};
+    for (uint32_t i = 0; i < n; i++)
+        for (uint32_t j = 0; j < 4; j++)
+            vertices[4 * i + j][0] = x[i];
+
+    DvzCullingParams params = {0};
+    params.count = n;
+    params.stride = 3;
+    params.size_offset = -1;
+    params.vertex_count = 4;
+    params.index_count = 6;
+    uint32_t pattern[6] = {0, 1, 2, 0, 2, 3};
+    memcpy(params.pattern, pattern, sizeof(pattern));
+
+    DvzMVP mvp = {0};
+    dvz_mvp_default(&mvp);
+    DvzViewport viewport = {0};
+    dvz_viewport_default(100, 100, &viewport);
+
+    DvzIndex indices[18] = {0};
+    uint32_t k = dvz_culling_items(&params, &mvp, &viewport, (float*)vertices, indices);
+    AT(_check_indices(k, indices, 12, (DvzIndex[]){0, 1, 2, 0, 2, 3, 8, 9, 10, 8, 10, 11}));
+
+    // The size threshold is ignored without a size attribute.
+    params.min_size = 10;
+    k = dvz_culling_items(&params, &mvp, &viewport, (float*)vertices, indices);
+    AT(k == 12);
+
+    return 0;
+}
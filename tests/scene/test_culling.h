@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing culling                                                                              */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_CULLING
+#define DVZ_HEADER_TEST_CULLING
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Culling tests                                                                                */
+/*************************************************************************************************/
+
+int test_culling_points(TstSuite*);
+
+int test_culling_quads(TstSuite*);
+
+
+
+#endif
@@ -182,3 +182,53 @@ int test_dual_2(TstSuite* suite)
     dvz_batch_destroy(batch);
     return 0;
 }
+
+
+
+int test_dual_resize(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+    DvzArray* array = dvz_array(16, DVZ_DTYPE_CHAR);
+    DvzId dat = 1;
+
+    DvzDual dual = dvz_dual(batch, array, dat);
+
+    char data[32] = {0};
+    for (uint32_t i = 0; i < 32; i++)
+        data[i] = i;
+
+    // The dirty items beyond the new count are dropped.
+    dvz_dual_data(&dual, 4, 8, &data[4]);
+    dvz_array_resize(array, 8);
+    dvz_dual_resize(&dual, 8);
+    AT(dual.dirty_first == 4);
+    AT(dual.dirty_last == 8);
+    dvz_dual_update(&dual);
+
+    AT(batch->count == 2);
+    AT(batch->requests[0].action == DVZ_REQUEST_ACTION_RESIZE);
+    AT(batch->requests[0].content.dat.size == 8);
+    AT(batch->requests[1].action == DVZ_REQUEST_ACTION_UPLOAD);
+    AT(batch->requests[1].content.dat_upload.offset == 4);
+    AT(batch->requests[1].content.dat_upload.size == 4);
+
+    // When growing, only the appended items are uploaded.
+    dvz_array_resize(array, 32);
+    dvz_dual_resize(&dual, 32);
+    AT(dual.dirty_first == UINT32_MAX);
+    dvz_dual_data(&dual, 8, 24, &data[8]);
+    dvz_dual_update(&dual);
+
+    AT(batch->count == 4);
+    AT(batch->requests[2].action == DVZ_REQUEST_ACTION_RESIZE);
+    AT(batch->requests[2].content.dat.size == 32);
+    AT(batch->requests[3].action == DVZ_REQUEST_ACTION_UPLOAD);
+    AT(batch->requests[3].content.dat_upload.offset == 8);
+    AT(batch->requests[3].content.dat_upload.size == 24);
+
+    dvz_array_destroy(array);
+    dvz_dual_destroy(&dual);
+    dvz_batch_destroy(batch);
+
+    return 0;
+}
@@ -29,6 +29,8 @@ int test_dual_1(TstSuite*);
 
 int test_dual_2(TstSuite*);
 
+int test_dual_resize(TstSuite*);
+
 
 
 #endif
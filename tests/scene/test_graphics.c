@@ -106,6 +106,9 @@ int test_graphics_point(TstSuite* suite)
     DvzGraphics* graphics = dvz_pipe_graphics(&pipe);
     dvz_graphics_builtin(&renderpass, graphics, DVZ_GRAPHICS_POINT, 0);
 
+    // The pipeline layout must match the shader: MVP and viewport only.
+    AT(graphics->dslots.slot_count == 2);
+
     const uint32_t n = 50;
 
     // Create the dats.
@@ -121,6 +124,7 @@ int test_graphics_point(TstSuite* suite)
     dvz_pipe_vertex(&pipe, 0, dat_vertex, 0);
     dvz_pipe_dat(&pipe, 0, dat_mvp);
     dvz_pipe_dat(&pipe, 1, dat_viewport);
+    AT(dvz_pipe_complete(&pipe));
     dvz_pipe_create(&pipe);
 
     // Upload the data.
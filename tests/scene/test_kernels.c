@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing kernels                                                                              */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+
+#include "scene/test_kernels.h"
+#include "_cglm.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "renderer.h"
+#include "resources.h"
+#include "scene/kernels.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+// Create a storage dat, and upload its initial data if any.
+static DvzId _storage_dat(DvzBatch* batch, DvzSize size, const void* data)
+{
+    ANN(batch);
+    DvzId dat = dvz_create_dat(batch, DVZ_BUFFER_TYPE_STORAGE, size, 0).id;
+    if (data != NULL)
+        dvz_upload_dat(batch, dat, 0, size, (void*)data, 0);
+    return dat;
+}
+
+
+
+// Process the requests of the batch, and clear it.
+static void _submit(DvzRenderer* rd, DvzBatch* batch)
+{
+    ANN(rd);
+    ANN(batch);
+    dvz_renderer_requests(rd, dvz_batch_size(batch), dvz_batch_requests(batch));
+    dvz_batch_clear(batch);
+}
+
+
+
+static void _download(DvzRenderer* rd, DvzId dat_id, DvzSize size, void* out)
+{
+    ANN(rd);
+    DvzDat* dat = dvz_renderer_dat(rd, dat_id);
+    ANN(dat);
+    dvz_dat_download(dat, 0, size, out, true);
+}
+
+
+
+/*************************************************************************************************/
+/*  Kernels tests                                                                                */
+/*************************************************************************************************/
+
+int test_kernels_path(TstSuite* suite)
+{
+    // Two paths, an open one with 3 points and one with 2 points.
+    const uint32_t n = 5;
+    vec3 pos[5] = {{0, 0, 0}, {1, 0, 0}, {2, 0, 0}, {10, 0, 0}, {11, 0, 0}};
+    uint32_t lengths[2] = {3, 2};
+    vec3 p0[5] = {0}, p1[5] = {0}, p2[5] = {0}, p3[5] = {0};
+
+    // Open paths: the neighbours are clamped to each path.
+    dvz_kernel_path(n, (const vec3*)pos, 2, lengths, false, p0, p1, p2, p3);
+    float e0[5] = {0, 0, 1, 10, 10};
+    float e1[5] = {0, 1, 2, 10, 11};
+    float e2[5] = {1, 2, 2, 11, 11};
+    float e3[5] = {2, 2, 2, 11, 11};
+    for (uint32_t i = 0; i < n; i++)
+    {
+        AT(p0[i][0] == e0[i]);
+        AT(p1[i][0] == e1[i]);
+        AT(p2[i][0] == e2[i]);
+        AT(p3[i][0] == e3[i]);
+    }
+
+    // Closed paths: the neighbours wrap around each path.
+    dvz_kernel_path(n, (const vec3*)pos, 2, lengths, true, p0, p1, p2, p3);
+    float c0[5] = {2, 0, 1, 11, 10};
+    float c2[5] = {1, 2, 0, 11, 10};
+    float c3[5] = {2, 0, 1, 10, 11};
+    for (uint32_t i = 0; i < n; i++)
+    {
+        AT(p0[i][0] == c0[i]);
+        AT(p1[i][0] == e1[i]);
+        AT(p2[i][0] == c2[i]);
+        AT(p3[i][0] == c3[i]);
+    }
+
+    return 0;
+}
+
+
+
+int test_kernels_normals(TstSuite* suite)
+{
+    // Square pyramid: 5 vertices, 6 faces.
+    const uint32_t vertex_count = 5;
+    vec3 pos[5] = {{-1, -1, 0}, {+1, -1, 0}, {+1, +1, 0}, {-1, +1, 0}, {0, 0, 1}};
+    DvzIndex index[18] = {0, 2, 1, 0, 3, 2, 0, 1, 4, 1, 2, 4, 2, 3, 4, 3, 0, 4};
+
+    vec3 normals[5] = {0};
+    dvz_kernel_normals(vertex_count, (const vec3*)pos, 18, index, normals);
+
+    // Compare with the floating-point accumulation of dvz_compute_normals().
+    vec3 expected[5] = {0};
+    dvz_compute_normals(vertex_count, 18, pos, index, expected);
+    for (uint32_t k = 0; k < vertex_count; k++)
+    {
+        ACn(3, normals[k], expected[k], 1e-4);
+        AC(glm_vec3_norm(normals[k]), 1, 1e-5);
+    }
+
+    // The apex normal points up.
+    AC(normals[4][0], 0, 1e-5);
+    AC(normals[4][1], 0, 1e-5);
+    AC(normals[4][2], 1, 1e-5);
+
+    // Degenerate faces are ignored.
+    DvzIndex degenerate[6] = {0, 1, 2, 0, 0, 1};
+    memset(normals, 0, sizeof(normals));
+    dvz_kernel_normals(vertex_count, (const vec3*)pos, 6, degenerate, normals);
+    AC(normals[0][2], 1, 1e-5);
+    AC(normals[3][2], 0, 1e-5); // not used by any face
+
+    return 0;
+}
+
+
+
+int test_kernels_min_max(TstSuite* suite)
+{
+    // Several workgroups, with a partial last group.
+    const uint32_t n = 3 * DVZ_KERNEL_GROUP_SIZE + 17;
+    float* values = (float*)calloc(n, sizeof(float));
+    for (uint32_t i = 0; i < n; i++)
+        values[i] = sinf(i);
+    values[10] = -5;
+    values[n - 1] = 7;
+    values[20] = NAN;
+
+    uint32_t group_count = dvz_kernel_group_count(n);
+    AT(group_count == 4);
+    vec2* partials = (vec2*)calloc(group_count, sizeof(vec2));
+    dvz_kernel_min_max(n, values, partials);
+    AT(partials[0][0] == -5);
+    AT(partials[3][1] == 7);
+
+    vec2 min_max = {0};
+    dvz_kernel_min_max_reduce(group_count, (const vec2*)partials, min_max);
+    AT(min_max[0] == -5);
+    AT(min_max[1] == 7);
+
+    // Only NaN values.
+    for (uint32_t i = 0; i < DVZ_KERNEL_GROUP_SIZE; i++)
+        values[i] = NAN;
+    dvz_kernel_min_max(DVZ_KERNEL_GROUP_SIZE, values, partials);
+    dvz_kernel_min_max_reduce(1, (const vec2*)partials, min_max);
+    AT(min_max[0] > min_max[1]);
+
+    FREE(values);
+    FREE(partials);
+    return 0;
+}
+
+
+
+int test_kernels_histogram(TstSuite* suite)
+{
+    float values[] = {0, 0.1, 0.25, 0.5, 0.74, 0.99, 1, -0.1, 1.1, NAN};
+    const uint32_t n = sizeof(values) / sizeof(float);
+    uint32_t bins[4] = {0};
+
+    dvz_kernel_histogram(n, values, (vec2){0, 1}, 4, bins);
+    AT(bins[0] == 2);
+    AT(bins[1] == 1);
+    AT(bins[2] == 2);
+    AT(bins[3] == 2); // the max value of the range falls in the last bin
+
+    // Empty range.
+    dvz_kernel_histogram(n, values, (vec2){1, 1}, 4, bins);
+    for (uint32_t i = 0; i < 4; i++)
+        AT(bins[i] == 0);
+
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/*  GPU kernels tests                                                                            */
+/*************************************************************************************************/
+
+int test_kernels_path_gpu(TstSuite* suite)
+{
+    DvzGpu* gpu = get_gpu(suite);
+    ANN(gpu);
+    DvzRenderer* rd = dvz_renderer(gpu, 0);
+    DvzBatch* batch = dvz_batch();
+
+    // Three paths, spanning several workgroups.
+    const uint32_t path_count = 3;
+    uint32_t lengths[3] = {3, 2, 300};
+    uint32_t offsets[4] = {0, 3, 5, 305};
+    const uint32_t n = offsets[path_count];
+    vec3* pos = (vec3*)calloc(n, sizeof(vec3));
+    for (uint32_t i = 0; i < n; i++)
+        _vec3_copy((vec3){i, sinf(i), cosf(i)}, pos[i]);
+
+    DvzKernel kernel = dvz_kernel(batch, DVZ_KERNEL_PATH);
+    DvzId dat_pos = _storage_dat(batch, n * sizeof(vec3), pos);
+    DvzId dat_offsets = _storage_dat(batch, sizeof(offsets), offsets);
+    DvzId dat_out = _storage_dat(batch, 4 * n * sizeof(vec3), NULL);
+    dvz_kernel_bind(&kernel, 1, dat_pos);
+    dvz_kernel_bind(&kernel, 2, dat_offsets);
+    dvz_kernel_bind(&kernel, 3, dat_out);
+
+    // The GPU output is the concatenation of the p0, p1, p2, p3 arrays of the CPU reference.
+    vec3* out = (vec3*)calloc(4 * n, sizeof(vec3));
+    vec3* expected = (vec3*)calloc(4 * n, sizeof(vec3));
+    for (int32_t closed = 0; closed <= 1; closed++)
+    {
+        DvzKernelParams params = {.count = n, .count2 = path_count, .closed = closed};
+        dvz_kernel_run(&kernel, &params, n);
+        _submit(rd, batch);
+        _download(rd, dat_out, 4 * n * sizeof(vec3), out);
+
+        dvz_kernel_path(
+            n, (const vec3*)pos, path_count, lengths, closed, &expected[0], &expected[n],
+            &expected[2 * n], &expected[3 * n]);
+        AT(memcmp(out, expected, 4 * n * sizeof(vec3)) == 0);
+    }
+
+    dvz_kernel_destroy(&kernel);
+    _submit(rd, batch);
+
+    FREE(pos);
+    FREE(out);
+    FREE(expected);
+    dvz_batch_destroy(batch);
+    dvz_renderer_destroy(rd);
+    return 0;
+}
+
+
+
+int test_kernels_normals_gpu(TstSuite* suite)
+{
+    DvzGpu* gpu = get_gpu(suite);
+    ANN(gpu);
+    DvzRenderer* rd = dvz_renderer(gpu, 0);
+    DvzBatch* batch = dvz_batch();
+
+    // Square pyramid with a degenerate face.
+    const uint32_t vertex_count = 5;
+    const uint32_t index_count = 21;
+    vec3 pos[5] = {{-1, -1, 0}, {+1, -1, 0}, {+1, +1, 0}, {-1, +1, 0}, {0, 0, 1}};
+    DvzIndex index[21] = {0, 2, 1, 0, 3, 2, 0, 1, 4, 1, 2, 4, 2, 3, 4, 3, 0, 4, 0, 0, 1};
+
+    DvzKernel kernel = dvz_kernel(batch, DVZ_KERNEL_NORMALS);
+    DvzId dat_pos = _storage_dat(batch, sizeof(pos), pos);
+    DvzId dat_index = _storage_dat(batch, sizeof(index), index);
+    DvzId dat_normals = _storage_dat(batch, sizeof(pos), NULL);
+    dvz_kernel_bind(&kernel, 1, dat_pos);
+    dvz_kernel_bind(&kernel, 2, dat_index);
+    dvz_kernel_bind(&kernel, 3, dat_normals);
+
+    // Clear, accumulate (one invocation per face), finalize.
+    DvzKernelParams params = {.count = vertex_count, .count2 = index_count};
+    params.pass = DVZ_KERNEL_PASS_CLEAR;
+    dvz_kernel_run(&kernel, &params, vertex_count);
+    params.pass = DVZ_KERNEL_PASS_ACCUMULATE;
+    dvz_kernel_run(&kernel, &params, index_count / 3);
+    params.pass = DVZ_KERNEL_PASS_FINALIZE;
+    dvz_kernel_run(&kernel, &params, vertex_count);
+    _submit(rd, batch);
+
+    vec3 normals[5] = {0};
+    _download(rd, dat_normals, sizeof(normals), normals);
+
+    vec3 expected[5] = {0};
+    dvz_kernel_normals(vertex_count, (const vec3*)pos, index_count, index, expected);
+    for (uint32_t k = 0; k < vertex_count; k++)
+        ACn(3, normals[k], expected[k], 1e-4);
+
+    dvz_kernel_destroy(&kernel);
+    _submit(rd, batch);
+
+    dvz_batch_destroy(batch);
+    dvz_renderer_destroy(rd);
+    return 0;
+}
+
+
+
+int test_kernels_min_max_gpu(TstSuite* suite)
+{
+    DvzGpu* gpu = get_gpu(suite);
+    ANN(gpu);
+    DvzRenderer* rd = dvz_renderer(gpu, 0);
+    DvzBatch* batch = dvz_batch();
+
+    // Several workgroups, with a partial last group and a NaN value.
+    const uint32_t n = 3 * DVZ_KERNEL_GROUP_SIZE + 17;
+    float* values = (float*)calloc(n, sizeof(float));
+    for (uint32_t i = 0; i < n; i++)
+        values[i] = sinf(i);
+    values[10] = -5;
+    values[n - 1] = 7;
+    values[20] = NAN;
+    uint32_t group_count = dvz_kernel_group_count(n);
+
+    DvzKernel kernel = dvz_kernel(batch, DVZ_KERNEL_MIN_MAX);
+    DvzId dat_values = _storage_dat(batch, n * sizeof(float), values);
+    DvzId dat_partials = _storage_dat(batch, group_count * sizeof(vec2), NULL);
+    dvz_kernel_bind(&kernel, 1, dat_values);
+    dvz_kernel_bind(&kernel, 2, dat_partials);
+
+    DvzKernelParams params = {.count = n};
+    dvz_kernel_run(&kernel, &params, n);
+    _submit(rd, batch);
+
+    vec2* partials = (vec2*)calloc(group_count, sizeof(vec2));
+    vec2* expected = (vec2*)calloc(group_count, sizeof(vec2));
+    _download(rd, dat_partials, group_count * sizeof(vec2), partials);
+    dvz_kernel_min_max(n, values, expected);
+    AT(memcmp(partials, expected, group_count * sizeof(vec2)) == 0);
+
+    dvz_kernel_destroy(&kernel);
+    _submit(rd, batch);
+
+    FREE(values);
+    FREE(partials);
+    FREE(expected);
+    dvz_batch_destroy(batch);
+    dvz_renderer_destroy(rd);
+    return 0;
+}
+
+
+
+int test_kernels_histogram_gpu(TstSuite* suite)
+{
+    DvzGpu* gpu = get_gpu(suite);
+    ANN(gpu);
+    DvzRenderer* rd = dvz_renderer(gpu, 0);
+    DvzBatch* batch = dvz_batch();
+
+    // NOTE: the values are away from the bin edges, and some are outside of the range or NaN.
+    const uint32_t n = 1000;
+    const uint32_t bin_count = 10;
+    float* values = (float*)calloc(n, sizeof(float));
+    for (uint32_t i = 0; i < n; i++)
+        values[i] = ((i % 97) + .5f) / 97.0f;
+    values[3] = -1;
+    values[4] = 2;
+    values[5] = NAN;
+    vec2 range = {0, 1};
+
+    DvzKernel kernel = dvz_kernel(batch, DVZ_KERNEL_HISTOGRAM);
+    DvzId dat_values = _storage_dat(batch, n * sizeof(float), values);
+    DvzId dat_bins = _storage_dat(batch, bin_count * sizeof(uint32_t), NULL);
+    dvz_kernel_bind(&kernel, 1, dat_values);
+    dvz_kernel_bind(&kernel, 2, dat_bins);
+
+    // Clear (one invocation per bin), accumulate (one invocation per value).
+    DvzKernelParams params = {.count = n, .count2 = bin_count, .range = {range[0], range[1]}};
+    params.pass = DVZ_KERNEL_PASS_CLEAR;
+    dvz_kernel_run(&kernel, &params, bin_count);
+    params.pass = DVZ_KERNEL_PASS_ACCUMULATE;
+    dvz_kernel_run(&kernel, &params, n);
+    _submit(rd, batch);
+
+    uint32_t bins[10] = {0};
+    uint32_t expected[10] = {0};
+    _download(rd, dat_bins, sizeof(bins), bins);
+    dvz_kernel_histogram(n, values, range, bin_count, expected);
+    for (uint32_t i = 0; i < bin_count; i++)
+        AT(bins[i] == expected[i]);
+
+    dvz_kernel_destroy(&kernel);
+    _submit(rd, batch);
+
+    FREE(values);
+    dvz_batch_destroy(batch);
+    dvz_renderer_destroy(rd);
+    return 0;
+}
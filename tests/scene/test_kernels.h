@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing kernels                                                                              */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_KERNELS
+#define DVZ_HEADER_TEST_KERNELS
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Kernels tests                                                                                */
+/*************************************************************************************************/
+
+int test_kernels_path(TstSuite*);
+
+int test_kernels_normals(TstSuite*);
+
+int test_kernels_min_max(TstSuite*);
+
+int test_kernels_histogram(TstSuite*);
+
+int test_kernels_path_gpu(TstSuite*);
+
+int test_kernels_normals_gpu(TstSuite*);
+
+int test_kernels_min_max_gpu(TstSuite*);
+
+int test_kernels_histogram_gpu(TstSuite*);
+
+
+
+#endif
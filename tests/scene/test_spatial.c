@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing spatial                                                                              */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "test_spatial.h"
+#include "datoviz.h"
+#include "scene/spatial.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static uint32_t _brute_nearest(uint32_t n, vec3* pos, vec3 q)
+{
+    uint32_t best = 0;
+    float d = INFINITY;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        float dx = pos[i][0] - q[0], dy = pos[i][1] - q[1];
+        if (dx * dx + dy * dy < d)
+        {
+            d = dx * dx + dy * dy;
+            best = i;
+        }
+    }
+    return best;
+}
+
+
+
+static uint32_t _brute_box(uint32_t n, vec3* pos, vec3 p0, vec3 p1)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; i++)
+        if (pos[i][0] >= p0[0] && pos[i][0] <= p1[0] && pos[i][1] >= p0[1] && pos[i][1] <= p1[1])
+            count++;
+    return count;
+}
+
+
+
+/*************************************************************************************************/
+/*  Spatial tests                                                                                */
+/*************************************************************************************************/
+
+int test_spatial_points(TstSuite* suite)
+{
+    ANN(suite);
+
+    const uint32_t n = 100000;
+    vec3* pos = (vec3*)calloc(n, sizeof(vec3));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        pos[i][0] = dvz_rand_float() * 4 - 2;
+        pos[i][1] = dvz_rand_float() * 2 - 1;
+    }
+
+    DvzSpatial* spatial = dvz_spatial(DVZ_SPATIAL_POINTS);
+    dvz_spatial_positions(spatial, 0, n, 3, (float*)pos);
+
+    // Nearest point, compared to a brute-force search.
+    vec3 scale = {1, 1, 1};
+    uint32_t item = 0;
+    float distance = 0;
+    for (uint32_t k = 0; k < 20; k++)
+    {
+        vec3 q = {dvz_rand_float() * 5 - 2.5, dvz_rand_float() * 3 - 1.5, 0};
+        AT(dvz_spatial_nearest(spatial, q, scale, INFINITY, &item, &distance));
+        AT(item == _brute_nearest(n, pos, q));
+    }
+
+    // Maximum distance.
+    AT(!dvz_spatial_nearest(spatial, (vec3){10, 10, 0}, scale, 1, &item, NULL));
+
+    // Box selection.
+    vec3 p0 = {-.5, -.25, 0}, p1 = {.25, .5, 0};
+    uint32_t expected = _brute_box(n, pos, p0, p1);
+    uint32_t* items = (uint32_t*)calloc(n, sizeof(uint32_t));
+    AT(dvz_spatial_box(spatial, p1, p0, 0, NULL) == expected);
+    AT(dvz_spatial_box(spatial, p0, p1, n, items) == expected);
+    for (uint32_t i = 0; i < expected; i++)
+    {
+        AT(pos[items[i]][0] >= p0[0] && pos[items[i]][0] <= p1[0]);
+        AT(pos[items[i]][1] >= p0[1] && pos[items[i]][1] <= p1[1]);
+    }
+
+    // Incremental update: move a few points, the index is patched.
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        pos[i][0] = -.1 + .001 * i;
+        pos[i][1] = .1;
+    }
+    dvz_spatial_positions(spatial, 0, 100, 3, (float*)pos);
+    AT(dvz_spatial_box(spatial, p0, p1, 0, NULL) == _brute_box(n, pos, p0, p1));
+    AT(dvz_spatial_nearest(spatial, (vec3){-.1, .1, 0}, scale, INFINITY, &item, &distance));
+    AT(item == 0);
+    AC(distance, 0, EPS);
+
+    // Move all points, which triggers a rebuild at the next query.
+    for (uint32_t i = 0; i < n; i++)
+        pos[i][0] += 10;
+    dvz_spatial_positions(spatial, 0, n, 3, (float*)pos);
+    AT(dvz_spatial_box(spatial, p0, p1, 0, NULL) == 0);
+    vec3 q = {10, 0, 0};
+    AT(dvz_spatial_nearest(spatial, q, scale, INFINITY, &item, NULL));
+    AT(item == _brute_nearest(n, pos, q));
+
+    FREE(items);
+    FREE(pos);
+    dvz_spatial_destroy(spatial);
+    return 0;
+}
+
+
+
+int test_spatial_mesh(TstSuite* suite)
+{
+    ANN(suite);
+
+    // A grid of 2x2 quads in the z=0 plane, 2 triangles per quad.
+    const uint32_t m = 64;
+    uint32_t vertex_count = (m + 1) * (m + 1);
+    uint32_t index_count = 6 * m * m;
+    vec3* pos = (vec3*)calloc(vertex_count, sizeof(vec3));
+    DvzIndex* indices = (DvzIndex*)calloc(index_count, sizeof(DvzIndex));
+    for (uint32_t j = 0; j <= m; j++)
+    {
+        for (uint32_t i = 0; i <= m; i++)
+        {
+            pos[j * (m + 1) + i][0] = i;
+            pos[j * (m + 1) + i][1] = j;
+        }
+    }
+    for (uint32_t j = 0; j < m; j++)
+    {
+        for (uint32_t i = 0; i < m; i++)
+        {
+            DvzIndex* idx = &indices[6 * (j * m + i)];
+            DvzIndex a = j * (m + 1) + i;
+            idx[0] = a;
+            idx[1] = a + 1;
+            idx[2] = a + m + 1;
+            idx[3] = a + 1;
+            idx[4] = a + m + 2;
+            idx[5] = a + m + 1;
+        }
+    }
+
+    DvzSpatial* spatial = dvz_spatial(DVZ_SPATIAL_MESH);
+    dvz_spatial_positions(spatial, 0, vertex_count, 3, (float*)pos);
+    dvz_spatial_indices(spatial, 0, index_count, indices);
+
+    // The triangle below a point of the quad (3, 5) is its first triangle.
+    vec3 scale = {1, 1, 1};
+    uint32_t item = 0;
+    float distance = 0;
+    AT(dvz_spatial_nearest(spatial, (vec3){3.1, 5.1, 1}, scale, INFINITY, &item, &distance));
+    AT(item == 2 * (5 * m + 3));
+    AC(distance, 1, EPS);
+
+    // Ignoring z, with a zero scale.
+    scale[2] = 0;
+    AT(dvz_spatial_nearest(spatial, (vec3){3.9, 5.9, 1}, scale, INFINITY, &item, &distance));
+    AT(item == 2 * (5 * m + 3) + 1);
+    AC(distance, 0, EPS);
+
+    // Outside of the mesh.
+    AT(!dvz_spatial_nearest(spatial, (vec3){-2, -2, 0}, scale, 1, &item, NULL));
+    AT(dvz_spatial_nearest(spatial, (vec3){-2, -2, 0}, scale, 3, &item, &distance));
+    AT(item == 0);
+    AC(distance, sqrt(8), EPS);
+
+    // Box selection of the triangle centroids.
+    AT(dvz_spatial_box(spatial, (vec3){0, 0, -1}, (vec3){2, 2, 1}, 0, NULL) == 8);
+
+    // Refit after moving the mesh.
+    for (uint32_t i = 0; i < vertex_count; i++)
+        pos[i][2] = 10;
+    dvz_spatial_positions(spatial, 0, vertex_count, 3, (float*)pos);
+    AT(dvz_spatial_box(spatial, (vec3){0, 0, -1}, (vec3){2, 2, 1}, 0, NULL) == 0);
+    AT(dvz_spatial_box(spatial, (vec3){0, 0, 9}, (vec3){2, 2, 11}, 0, NULL) == 8);
+
+    FREE(pos);
+    FREE(indices);
+    dvz_spatial_destroy(spatial);
+    return 0;
+}
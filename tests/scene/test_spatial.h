@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing spatial                                                                              */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_SPATIAL
+#define DVZ_HEADER_TEST_SPATIAL
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Spatial tests                                                                                */
+/*************************************************************************************************/
+
+int test_spatial_points(TstSuite*);
+
+int test_spatial_mesh(TstSuite*);
+
+
+
+#endif
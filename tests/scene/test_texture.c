@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing texture                                                                              */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/test_texture.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "scene/texture.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Texture tests                                                                                */
+/*************************************************************************************************/
+
+int test_texture_bricks(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+
+    // 3D texture with 3x2x1 bricks.
+    const uint32_t b = DVZ_TEXTURE_BRICK_SIZE;
+    const uint32_t w = 3 * b - 4, h = 2 * b, d = b;
+    uint8_t* data = (uint8_t*)calloc(w * h * d, sizeof(uint8_t));
+
+    // A single non-zero voxel in the center of the first brick.
+    data[(b / 2 * h + b / 2) * w + b / 2] = 255;
+
+    // The occupancy is not computed for the other 3D textures.
+    DvzTexture* texture = dvz_texture_3D(
+        batch, DVZ_FORMAT_R8_UNORM, DVZ_FILTER_LINEAR, DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, w,
+        h, d, data, 0);
+    AT(texture->brick_max == NULL);
+    dvz_texture_destroy(texture);
+
+    texture = dvz_texture_3D(
+        batch, DVZ_FORMAT_R8_UNORM, DVZ_FILTER_LINEAR, DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, w,
+        h, d, data, DVZ_TEX_FLAGS_OCCUPANCY);
+    AT(texture->brick_shape[0] == 3);
+    AT(texture->brick_shape[1] == 2);
+    AT(texture->brick_shape[2] == 1);
+    AT(texture->brick_max[0] == 1);
+    for (uint32_t i = 1; i < 6; i++)
+        AT(texture->brick_max[i] == 0);
+
+    // The occupancy texture is created and uploaded on demand.
+    AT(texture->brick_tex == DVZ_ID_NONE);
+    uint32_t count = batch->count;
+    dvz_texture_occupancy(texture);
+    AT(texture->brick_tex != DVZ_ID_NONE);
+    AT(batch->count == count + 3); // create tex, create sampler, upload
+
+    DvzRequest* req = &batch->requests[batch->count - 1];
+    AT(req->action == DVZ_REQUEST_ACTION_UPLOAD);
+    AT(req->id == texture->brick_tex);
+
+    // The uploaded occupancy is dilated by one brick.
+    float* occupancy = (float*)req->content.tex_upload.data;
+    ANN(occupancy);
+    AT(occupancy[0] == 1); // (0, 0)
+    AT(occupancy[1] == 1); // (1, 0)
+    AT(occupancy[2] == 0); // (2, 0)
+    AT(occupancy[3] == 1); // (0, 1)
+    AT(occupancy[4] == 1); // (1, 1)
+    AT(occupancy[5] == 0); // (2, 1)
+
+    // Partial update in the last brick: the grid is updated and uploaded again.
+    uint8_t value[4] = {0, 128, 0, 0};
+    dvz_texture_data(texture, w - 4, h - 1, d - 1, 4, 1, 1, 4, value);
+    AC(texture->brick_max[5], 128 / 255.0, 1e-6);
+    AT(texture->brick_max[0] == 1);
+    AT(batch->count == count + 5); // upload the texture and the occupancy
+
+    // Only the updated brick and its neighbors are uploaded.
+    req = &batch->requests[batch->count - 1];
+    AT(req->id == texture->brick_tex);
+    AT(req->content.tex_upload.offset[0] == 1);
+    AT(req->content.tex_upload.offset[1] == 0);
+    AT(req->content.tex_upload.offset[2] == 0);
+    AT(req->content.tex_upload.shape[0] == 2);
+    AT(req->content.tex_upload.shape[1] == 2);
+    AT(req->content.tex_upload.shape[2] == 1);
+    occupancy = (float*)req->content.tex_upload.data;
+    AT(occupancy[0] == 1);               // (1, 0)
+    AC(occupancy[1], 128 / 255.0, 1e-6); // (2, 0)
+    AT(occupancy[2] == 1);               // (1, 1)
+    AC(occupancy[3], 128 / 255.0, 1e-6); // (2, 1)
+
+    // A full update of the last brick recomputes its maximum.
+    uint8_t* zeros = (uint8_t*)calloc((w - 2 * b) * b * d, sizeof(uint8_t));
+    dvz_texture_data(texture, 2 * b, b, 0, w - 2 * b, b, d, (w - 2 * b) * b * d, zeros);
+    AT(texture->brick_max[5] == 0);
+    FREE(zeros);
+
+    dvz_texture_destroy(texture);
+    FREE(data);
+    dvz_batch_destroy(batch);
+    return 0;
+}
+
+
+
+int test_texture_occupancy(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+
+    // 3D texture with 2x1x1 bricks, uploaded before the occupancy is enabled.
+    const uint32_t b = DVZ_TEXTURE_BRICK_SIZE;
+    const uint32_t w = 2 * b, h = b, d = b;
+    uint8_t* data = (uint8_t*)calloc(w * h * d, sizeof(uint8_t));
+    DvzTexture* texture = dvz_texture_3D(
+        batch, DVZ_FORMAT_R8_UNORM, DVZ_FILTER_LINEAR, DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, w,
+        h, d, data, 0);
+    AT(texture->brick_max == NULL);
+
+    // The content of the bricks is unknown, so they are all occupied.
+    dvz_texture_occupancy(texture);
+    AT(texture->brick_max[0] == 1);
+    AT(texture->brick_max[1] == 1);
+    DvzRequest* req = &batch->requests[batch->count - 1];
+    AT(req->id == texture->brick_tex);
+    float* occupancy = (float*)req->content.tex_upload.data;
+    AT(occupancy[0] == 1);
+    AT(occupancy[1] == 1);
+
+    // A partial upload covering a part of the first brick only: it remains occupied.
+    dvz_texture_data(texture, 0, 0, 0, b, b, 1, b * b, data);
+    AT(texture->brick_max[0] == 1);
+    AT(texture->brick_max[1] == 1);
+
+    // A partial upload covering the first brick entirely: it becomes empty.
+    dvz_texture_data(texture, 0, 0, 0, b, b, b, b * b * b, data);
+    AT(texture->brick_max[0] == 0);
+    AT(texture->brick_max[1] == 1);
+
+    // The occupancy is dilated, so the first brick is still drawn next to the second one.
+    req = &batch->requests[batch->count - 1];
+    AT(req->id == texture->brick_tex);
+    AT(req->content.tex_upload.shape[0] == 2);
+    occupancy = (float*)req->content.tex_upload.data;
+    AT(occupancy[0] == 1);
+    AT(occupancy[1] == 1);
+
+    dvz_texture_destroy(texture);
+    FREE(data);
+    dvz_batch_destroy(batch);
+    return 0;
+}
+
+
+
+int test_texture_stream(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+
+    // 2D texture with 4x3 blocks, the last ones being incomplete.
+    const uint32_t b = DVZ_TEXTURE_STREAM_BLOCK;
+    const uint32_t w = 3 * b + 4, h = 2 * b + 6;
+    const DvzSize row = w * 4;
+    uint8_t* data = (uint8_t*)calloc(h * row, sizeof(uint8_t));
+
+    DvzTexture* texture = dvz_texture_2D(
+        batch, DVZ_FORMAT_R8G8B8A8_UNORM, DVZ_FILTER_LINEAR,
+        DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, w, h, NULL, DVZ_TEX_FLAGS_STREAMING);
+
+    // The first frame is uploaded entirely.
+    AT(dvz_texture_stream(texture, data) == h * row);
+    AT(batch->count == 3); // create tex, create sampler, upload
+    AT(batch->requests[0].flags == DVZ_TEX_FLAGS_STREAMING);
+
+    // Nothing changed.
+    AT(dvz_texture_stream(texture, data) == 0);
+    AT(batch->count == 3);
+
+    // Two pixels in the same block column, in two consecutive bands: a single rectangle.
+    data[10 * row + (b + 8) * 4] = 255;
+    data[(b + 8) * row + (b + 1) * 4 + 3] = 255;
+    AT(dvz_texture_stream(texture, data) == b * 2 * b * 4);
+    AT(batch->count == 4);
+    DvzRequest* req = &batch->requests[batch->count - 1];
+    AT(req->action == DVZ_REQUEST_ACTION_UPLOAD);
+    AT(req->id == texture->tex);
+    AT(req->content.tex_upload.offset[0] == b);
+    AT(req->content.tex_upload.offset[1] == 0);
+    AT(req->content.tex_upload.shape[0] == b);
+    AT(req->content.tex_upload.shape[1] == 2 * b);
+    uint8_t* uploaded = (uint8_t*)req->content.tex_upload.data;
+    AT(uploaded[10 * b * 4 + 8 * 4] == 255);
+
+    // The last pixel, and a pixel in the first band: two rectangles.
+    data[(h - 1) * row + (w - 1) * 4] = 1;
+    data[0] = 1;
+    AT(dvz_texture_stream(texture, data) == b * b * 4 + 4 * 6 * 4);
+    AT(batch->count == 6);
+    req = &batch->requests[batch->count - 1];
+    AT(req->content.tex_upload.offset[0] == 3 * b);
+    AT(req->content.tex_upload.offset[1] == 2 * b);
+    AT(req->content.tex_upload.shape[0] == 4);
+    AT(req->content.tex_upload.shape[1] == 6);
+
+    // The last frame is kept up to date.
+    AT(dvz_texture_stream(texture, data) == 0);
+    AT(memcmp(texture->frame, data, h * row) == 0);
+
+    dvz_texture_destroy(texture);
+    FREE(data);
+    dvz_batch_destroy(batch);
+    return 0;
+}
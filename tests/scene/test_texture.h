@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing texture                                                                              */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_TEXTURE
+#define DVZ_HEADER_TEST_TEXTURE
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Texture tests                                                                                */
+/*************************************************************************************************/
+
+int test_texture_bricks(TstSuite*);
+
+int test_texture_occupancy(TstSuite*);
+
+int test_texture_stream(TstSuite*);
+
+
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing tiles                                                                                */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/test_tiles.h"
+#include "_time_utils.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "scene/box.h"
+#include "scene/panzoom.h"
+#include "scene/scene_testing_utils.h"
+#include "scene/tiles.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+#define IMAGE_WIDTH  1000
+#define IMAGE_HEIGHT 600
+#define TILE         64
+
+
+
+static void _tile_callback(
+    DvzTiles* tiles, uint32_t level, uint32_t x, uint32_t y, void* out, void* user_data)
+{
+    ANN(tiles);
+    ANN(out);
+
+    uint32_t* count = (uint32_t*)user_data;
+    if (count != NULL)
+        (*count)++;
+
+    memset(out, (int)(level + 1), TILE * TILE);
+}
+
+
+
+typedef struct
+{
+    DvzTiles* tiles;
+    DvzPanzoom* pz;
+} _TilesView;
+
+
+
+static void _update(void* user_data)
+{
+    _TilesView* view = (_TilesView*)user_data;
+    ANN(view);
+    dvz_tiles_update(view->tiles, view->pz);
+}
+
+
+
+// Update the tiles until all the visible tiles are loaded.
+static int _settle(DvzTiles* tiles, DvzPanzoom* pz)
+{
+    ANN(tiles);
+    _TilesView view = {tiles, pz};
+    return settle_pool(tiles->cache, _update, &view, tiles->visible, &tiles->visible_count);
+}
+
+
+
+// Check that the drawn tiles are resident and sorted from the lowest to the highest resolution.
+static int _check_drawn(DvzTiles* tiles)
+{
+    ANN(tiles);
+    uint32_t tile = 0;
+    for (uint32_t i = 0; i < tiles->drawn_count; i++)
+    {
+        tile = tiles->drawn[i];
+        AT(tiles->cache->states[tile] == DVZ_POOL_STATE_RESIDENT);
+        AT(tiles->cache->slots[tile] >= 0);
+        AT(tiles->cache->entries[tiles->cache->slots[tile]].item == tile);
+        if (i > 0)
+            AT(tile < tiles->drawn[i - 1]);
+    }
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/*  Tiles tests                                                                                  */
+/*************************************************************************************************/
+
+int test_tiles_1(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+    DvzTiles* tiles =
+        dvz_tiles(batch, DVZ_FORMAT_R8_UNORM, IMAGE_WIDTH, IMAGE_HEIGHT, TILE, 64, 0);
+
+    // Levels of the pyramid.
+    AT(tiles->level_count == 5);
+    AT(tiles->grids[0][0] == 16);
+    AT(tiles->grids[0][1] == 10);
+    AT(tiles->grids[1][0] == 8);
+    AT(tiles->grids[1][1] == 5);
+    AT(tiles->grids[2][0] == 4);
+    AT(tiles->grids[2][1] == 3);
+    AT(tiles->grids[3][0] == 2);
+    AT(tiles->grids[3][1] == 2);
+    AT(tiles->grids[4][0] == 1);
+    AT(tiles->grids[4][1] == 1);
+    AT(tiles->tile_count == 160 + 40 + 12 + 4 + 1);
+    AT(dvz_tiles_index(tiles, 4, 0, 0) == tiles->tile_count - 1);
+    AT(dvz_tiles_index(tiles, 1, 3, 2) == 160 + 2 * 8 + 3);
+
+    // Tile cache.
+    AT(tiles->pool[0] == 8);
+    AT(tiles->pool[1] == 8);
+
+    // Full view: the finest levels have too many tiles.
+    DvzBox box = dvz_box(-1, +1, -1, +1, -1, +1);
+    AT(dvz_tiles_select(tiles, &box, (vec2){800, 600}) == 2);
+    AT(tiles->visible_count == 12);
+    AT(tiles->visible[0] == tiles->offsets[2]);
+
+    // Zoom on the top left corner.
+    box = dvz_box(-1, -.9, .9, 1, -1, +1);
+    AT(dvz_tiles_select(tiles, &box, (vec2){800, 600}) == 0);
+    AT(tiles->visible_count == 1);
+    AT(tiles->visible[0] == 0);
+
+    // Small viewport on the bottom right corner: a coarser level is enough.
+    box = dvz_box(.8, 1, -1, -.8, -1, +1);
+    AT(dvz_tiles_select(tiles, &box, (vec2){10, 5}) == 3);
+    AT(tiles->visible_count == 1);
+    AT(tiles->visible[0] == dvz_tiles_index(tiles, 3, 1, 1));
+
+    // Outside of the image.
+    box = dvz_box(2, 3, 2, 3, -1, +1);
+    dvz_tiles_select(tiles, &box, (vec2){800, 600});
+    AT(tiles->visible_count == 0);
+
+    // Image bounds.
+    dvz_tiles_bounds(tiles, (vec2){0, 1}, (vec2){0, 1});
+    box = dvz_box(-1, +1, -1, +1, -1, +1);
+    AT(dvz_tiles_select(tiles, &box, (vec2){800, 600}) == 2);
+    AT(tiles->visible_count == 12);
+
+    dvz_tiles_destroy(tiles);
+    dvz_batch_destroy(batch);
+    return 0;
+}
+
+
+
+int test_tiles_2(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+    DvzTiles* tiles =
+        dvz_tiles(batch, DVZ_FORMAT_R8_UNORM, IMAGE_WIDTH, IMAGE_HEIGHT, TILE, 64, 0);
+    uint32_t count = 0;
+    dvz_tiles_callback(tiles, _tile_callback, &count);
+
+    DvzPanzoom* pz = dvz_panzoom(800, 600, 0);
+
+    // Load the whole image at level 2.
+    AT(_settle(tiles, pz) == 0);
+    AT(tiles->level == 2);
+    AT(tiles->drawn_count == 12);
+    AT(_check_drawn(tiles) == 0);
+
+    // The lowest resolution tile is resident and pinned.
+    uint32_t root = tiles->tile_count - 1;
+    AT(tiles->cache->states[root] == DVZ_POOL_STATE_RESIDENT);
+    AT(tiles->cache->entries[tiles->cache->slots[root]].pinned);
+
+    // Zoom on the top left corner: the parent tile is drawn until the tile is loaded.
+    DvzBox box = dvz_box(-1, -.9, .9, 1, -1, +1);
+    dvz_panzoom_set(pz, &box);
+    AT(dvz_tiles_update(tiles, pz) > 0);
+    AT(tiles->level == 0);
+    AT(tiles->visible_count == 1);
+    AT(tiles->drawn_count == 1);
+    AT(tiles->drawn[0] == tiles->offsets[2]);
+
+    AT(_settle(tiles, pz) == 0);
+    AT(tiles->drawn_count == 1);
+    AT(tiles->drawn[0] == 0);
+    AT(_check_drawn(tiles) == 0);
+
+    // Going back to the full view does not reload the tiles.
+    uint32_t loaded = count;
+    dvz_panzoom_reset(pz);
+    AT(_settle(tiles, pz) == 0);
+    AT(tiles->drawn_count == 12);
+    AT(count == loaded);
+
+    uint32_t resident = 0;
+    for (uint32_t i = 0; i < tiles->tile_count; i++)
+        resident += tiles->cache->states[i] == DVZ_POOL_STATE_RESIDENT;
+    AT(resident <= tiles->capacity);
+
+    dvz_panzoom_destroy(pz);
+    dvz_tiles_destroy(tiles);
+    dvz_batch_destroy(batch);
+    return 0;
+}
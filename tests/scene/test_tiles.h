@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing tiles                                                                                */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_TILES
+#define DVZ_HEADER_TEST_TILES
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Tiles tests                                                                                  */
+/*************************************************************************************************/
+
+int test_tiles_1(TstSuite*);
+
+int test_tiles_2(TstSuite*);
+
+
+
+#endif
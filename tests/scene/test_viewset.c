@@ -81,6 +81,70 @@ int test_viewset_1(TstSuite* suite)
 
 
 
+int test_viewset_culling(TstSuite* suite)
+{
+    ANN(suite);
+    DvzBatch* batch = dvz_batch();
+
+    // Create a visual with a bounding box.
+    DvzVisual* visual = dvz_visual(batch, DVZ_PRIMITIVE_TOPOLOGY_POINT_LIST, 0);
+    dvz_visual_attr(visual, 0, 0, sizeof(vec3), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
+    dvz_visual_bounds(visual, true, 0);
+    dvz_visual_alloc(visual, 2, 2, 0);
+
+    // The bounding box is extended as positions are set.
+    vec3 pos[] = {{1.5, 0, 0}, {2, .5, 0}};
+    dvz_visual_data(visual, 0, 0, 2, pos);
+    AC(visual->bounds.xmin, 1.5, EPS);
+    AC(visual->bounds.xmax, 2, EPS);
+    AC(visual->bounds.ymin, 0, EPS);
+    AC(visual->bounds.ymax, .5, EPS);
+
+    // Create a viewset and a view.
+    DvzId canvas_id = 1;
+    DvzViewset* viewset = dvz_viewset(batch, canvas_id);
+    DvzView* view = dvz_view(viewset, (vec2){0, 0}, (vec2){WIDTH, HEIGHT});
+    DvzTransform* tr = dvz_transform(batch, 0);
+    dvz_view_add(view, visual, 0, 2, 0, 1, tr, 0);
+
+    // The visual is outside of the view with the identity MVP.
+    AT(dvz_visual_culled(visual));
+    dvz_viewset_build(viewset);
+    AT(visual->is_culled);
+
+    // Pan to the right: the visual enters the view.
+    DvzMVP mvp = {0};
+    dvz_mvp_default(&mvp);
+    glm_translate_make(mvp.view, (vec3){-1.5, 0, 0});
+    dvz_transform_set(tr, &mvp);
+    AT(!dvz_visual_culled(visual));
+    dvz_viewset_build(viewset);
+    AT(!visual->is_culled);
+
+    // Explicit bounding box.
+    DvzBox box = dvz_box(10, 11, 10, 11, 0, 0);
+    dvz_visual_box(visual, &box);
+    AT(dvz_visual_culled(visual));
+
+    // No culling when disabled.
+    dvz_visual_bounds(visual, false, 0);
+    AT(!dvz_visual_culled(visual));
+
+    // Bounding box computed from the positions again.
+    dvz_visual_bounds(visual, true, 0);
+    dvz_visual_box(visual, NULL);
+    AC(visual->bounds.xmin, 1.5, EPS);
+    AT(!dvz_visual_culled(visual));
+
+    dvz_transform_destroy(tr);
+    dvz_view_destroy(view);
+    dvz_viewset_destroy(viewset);
+    dvz_batch_destroy(batch);
+    return 0;
+}
+
+
+
 int test_viewset_mouse(TstSuite* suite)
 {
     float eps = 1e-6;
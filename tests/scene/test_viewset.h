@@ -26,6 +26,7 @@
 /*************************************************************************************************/
 
 int test_viewset_1(TstSuite*);
+int test_viewset_culling(TstSuite*);
 
 int test_viewset_mouse(TstSuite*);
 
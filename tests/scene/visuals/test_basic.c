@@ -41,6 +41,7 @@ int test_basic_1(TstSuite* suite)
 
     // Create the visual.
     DvzVisual* visual = dvz_basic(vt.batch, DVZ_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, 0);
+    AT(visual->scalar_slot == 0); // no colormap params without DVZ_VISUAL_FLAGS_SCALAR
 
     // Visual allocation.
     dvz_basic_alloc(visual, n);
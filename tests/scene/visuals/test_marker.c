@@ -44,6 +44,7 @@ int test_marker_code(TstSuite* suite)
 
     // Create the visual.
     DvzVisual* visual = dvz_marker(vt.batch, 0);
+    AT(visual->scalar_slot == 0); // no colormap params without DVZ_VISUAL_FLAGS_SCALAR
     dvz_marker_aspect(visual, DVZ_MARKER_ASPECT_OUTLINE);
     dvz_marker_shape(visual, DVZ_MARKER_SHAPE_HEART);
 
@@ -48,6 +48,7 @@ int test_path_1(TstSuite* suite)
 
     // Create the visual.
     DvzVisual* visual = dvz_path(vt.batch, 0);
+    AT(visual->scalar_slot == 0); // no colormap params without DVZ_VISUAL_FLAGS_SCALAR
 
     // Visual allocation.
     dvz_path_alloc(visual, total_length);
@@ -39,8 +39,10 @@ int test_point_1(TstSuite* suite)
     // Number of items.
     const uint32_t n = 10000;
 
-    // Create the visual.
+    // Create the visual: no colormap params without DVZ_VISUAL_FLAGS_SCALAR.
     DvzVisual* visual = dvz_point(vt.batch, 0);
+    AT(visual->scalar_slot == 0);
+    AT(visual->params[2] == NULL);
 
     // Visual allocation.
     dvz_point_alloc(visual, n);
@@ -70,3 +72,51 @@ int test_point_1(TstSuite* suite)
 
     return 0;
 }
+
+
+
+int test_point_scalar(TstSuite* suite)
+{
+    VisualTest vt = visual_test_start("point_scalar", VISUAL_TEST_PANZOOM, 0);
+
+    // Number of items.
+    const uint32_t n = 10000;
+
+    // Create the visual with one scalar value per point instead of a color.
+    DvzVisual* visual = dvz_point(vt.batch, DVZ_VISUAL_FLAGS_SCALAR);
+    AT(visual->attrs[2].format == DVZ_FORMAT_R32_SFLOAT);
+    AT(visual->attrs[2].item_size == sizeof(float));
+    AT(visual->scalar_slot == 2);
+    AT(visual->params[2] != NULL);
+
+    // Visual allocation.
+    dvz_point_alloc(visual, n);
+
+    // Position.
+    vec3* pos = dvz_mock_pos_2D(n, 0.25);
+    dvz_point_position(visual, 0, n, pos, 0);
+
+    // Scalar values.
+    float* values = dvz_mock_uniform(n, -10, 10);
+    dvz_point_scalar(visual, 0, n, values, 0);
+
+    // Size.
+    float* size = dvz_mock_uniform(n, 1, 50);
+    dvz_point_size(visual, 0, n, size, 0);
+
+    // Colormap: only the params uniform is updated, not the vertex buffer.
+    dvz_visual_colormap(visual, DVZ_CMAP_HSV, -10, 10);
+
+    // Add the visual to the panel AFTER setting the visual's data.
+    dvz_panel_visual(vt.panel, visual, 0);
+
+    // Run the test.
+    visual_test_end(vt);
+
+    // Cleanup.
+    FREE(pos);
+    FREE(values);
+    FREE(size);
+
+    return 0;
+}
@@ -27,11 +27,14 @@
 #include "scene/test_axis.h"
 #include "scene/test_baker.h"
 #include "scene/test_box.h"
+#include "scene/test_bricks.h"
 #include "scene/test_camera.h"
 #include "scene/test_colormaps.h"
+#include "scene/test_culling.h"
 #include "scene/test_dual.h"
 #include "scene/test_font.h"
 #include "scene/test_graphics.h"
+#include "scene/test_kernels.h"
 #include "scene/test_mvp.h"
 #include "scene/test_ortho.h"
 #include "scene/test_panzoom.h"
@@ -40,6 +43,9 @@
 #include "scene/test_scene.h"
 #include "scene/test_sdf.h"
 #include "scene/test_shape.h"
+#include "scene/test_spatial.h"
+#include "scene/test_texture.h"
+#include "scene/test_tiles.h"
 #include "scene/test_ticks.h"
 #include "scene/test_viewset.h"
 #include "scene/test_visual.h"
@@ -68,6 +74,7 @@
 #include "test_external.h"
 #include "test_fifo.h"
 #include "test_fileio.h"
+#include "test_gpu_timer.h"
 #include "test_gui.h"
 #include "test_input.h"
 #include "test_keyboard.h"
@@ -76,7 +83,10 @@
 #include "test_map.h"
 #include "test_mouse.h"
 #include "test_obj.h"
+#include "test_oit.h"
+#include "test_pick.h"
 #include "test_pipe.h"
+#include "test_pipecache.h"
 #include "test_pipelib.h"
 #include "test_presenter.h"
 #include "test_prng.h"
@@ -86,6 +96,7 @@
 #include "test_server.h"
 #include "test_thread.h"
 #include "test_timer.h"
+#include "test_trace.h"
 #include "test_transfers.h"
 #include "test_vklite.h"
 #include "test_window.h"
@@ -114,6 +125,10 @@ int dvz_run_tests(const char* match)
     TEST(test_cond_1)
     TEST(test_atomic_1)
 
+    // Testing trace.
+    TEST(test_trace_1)
+    TEST(test_trace_2)
+
     // Test PRNG.
     TEST(test_prng_1)
 
@@ -139,11 +154,20 @@ int dvz_run_tests(const char* match)
     TEST(test_alloc_2)
     TEST(test_alloc_3)
     TEST(test_alloc_4)
+    TEST(test_alloc_compact)
+    TEST(test_alloc_trim)
+    TEST(test_alloc_extend)
+    TEST(test_alloc_capacity)
 
 
     // Testing map.
     TEST(test_map_1)
     TEST(test_map_2)
+    TEST(test_map_3)
+    TEST(test_map_4)
+
+    // Testing pipe cache.
+    TEST(test_pipecache_1)
 
     // Testing list.
     TEST(test_list_1)
@@ -194,6 +218,7 @@ int dvz_run_tests(const char* match)
     TEST(test_vklite_shader)
     TEST(test_vklite_swapchain)
     TEST(test_vklite_graphics)
+    TEST(test_vklite_pipeline_cache)
     TEST(test_vklite_indirect)
     TEST(test_vklite_indexed)
     TEST(test_vklite_instanced)
@@ -242,6 +267,7 @@ int dvz_run_tests(const char* match)
     TEST(test_resources_tex_1)
     TEST(test_datalloc_1)
     TEST(test_datalloc_2)
+    TEST(test_datalloc_compact)
 
     // Testing transfers.
     TEST(test_transfers_buffer_mappable)
@@ -257,12 +283,23 @@ int dvz_run_tests(const char* match)
     // Testing resources transfers.
     TEST(test_resources_dat_transfers)
     TEST(test_resources_dat_resize)
+    TEST(test_resources_dat_keep)
     TEST(test_resources_tex_transfers)
     TEST(test_resources_tex_resize)
 
     // Testing board.
     TEST(test_board_1)
 
+    // Testing pick.
+    TEST(test_pick_1)
+    TEST(test_pick_2)
+
+    // Testing OIT.
+    TEST(test_oit_1)
+
+    // Testing GPU timer.
+    TEST(test_gpu_timer_1)
+
     // Testing pipe.
     TEST(test_pipe_1)
 
@@ -276,6 +313,7 @@ int dvz_run_tests(const char* match)
     TEST(test_renderer_1)
     TEST(test_renderer_graphics)
     TEST(test_renderer_push)
+    TEST(test_renderer_compute)
     TEST(test_renderer_resize)
 
     // TEST(test_external_1)
@@ -283,6 +321,7 @@ int dvz_run_tests(const char* match)
     // Test visuals.
     TEST(test_visual_1)
     TEST(test_viewset_1)
+    TEST(test_viewset_culling)
     TEST(test_viewset_mouse)
 
     // Teardown the gpu fixture.
@@ -300,10 +339,13 @@ int dvz_run_tests(const char* match)
     // Testing client.
     TEST(test_client_1)
     TEST(test_client_2)
+    TEST(test_client_on_demand)
+    TEST(test_client_coalesce)
     TEST(test_client_thread)
 
     // Testing request.
     TEST(test_request_1)
+    TEST(test_request_compute)
     TEST(test_requester_1)
 
 
@@ -327,6 +369,7 @@ int dvz_run_tests(const char* match)
     // Testing dual.
     TEST(test_dual_1)
     TEST(test_dual_2)
+    TEST(test_dual_resize)
 
     // Testing params.
     TEST(test_params_1)
@@ -336,6 +379,19 @@ int dvz_run_tests(const char* match)
     TEST(test_baker_2)
     // TEST(test_baker_3)
 
+    // Testing texture.
+    TEST(test_texture_bricks)
+    TEST(test_texture_occupancy)
+    TEST(test_texture_stream)
+
+    // Testing bricks.
+    TEST(test_bricks_1)
+    TEST(test_bricks_2)
+
+    // Testing tiles.
+    TEST(test_tiles_1)
+    TEST(test_tiles_2)
+
     // Testing colormaps.
     TEST(test_colormaps_default)
     TEST(test_colormaps_scale)
@@ -355,6 +411,24 @@ int dvz_run_tests(const char* match)
     TEST(test_shape_transform)
     TEST(test_shape_obj)
 
+    // Testing spatial index.
+    TEST(test_spatial_points)
+    TEST(test_spatial_mesh)
+
+    // Testing kernels.
+    TEST(test_kernels_path)
+    TEST(test_kernels_normals)
+    TEST(test_kernels_min_max)
+    TEST(test_kernels_histogram)
+    TEST(test_kernels_path_gpu)
+    TEST(test_kernels_normals_gpu)
+    TEST(test_kernels_min_max_gpu)
+    TEST(test_kernels_histogram_gpu)
+
+    // Testing GPU culling.
+    TEST(test_culling_points)
+    TEST(test_culling_quads)
+
     // Box, ticks and axes.
     TEST(test_box_1)
     TEST(test_box_2)
@@ -362,15 +436,19 @@ int dvz_run_tests(const char* match)
     TEST(test_box_4)
     TEST(test_box_5)
     TEST(test_box_6)
+    TEST(test_box_visible)
     TEST(test_ticks_1)
     TEST(test_ticks_labels)
     TEST(test_ticks_2)
     TEST(test_ref_1)
     TEST(test_axis_1)
+    TEST(test_axis_2)
     TEST(test_axes_1)
 
     // Testing atlas.
     TEST(test_atlas_1)
+    TEST(test_atlas_2)
+    TEST(test_atlas_3)
 
     // Testing sdf.
     TEST(test_sdf_single)
@@ -402,6 +480,7 @@ int dvz_run_tests(const char* match)
     TEST(test_monoglyph_1)
     TEST(test_pixel_1)
     TEST(test_point_1)
+    TEST(test_point_scalar)
     TEST(test_marker_code)
     TEST(test_marker_bitmap)
     TEST(test_marker_sdf)
@@ -165,3 +165,236 @@ int test_alloc_4(TstSuite* suite)
     dvz_alloc_destroy(alloc);
     return 0;
 }
+
+
+
+int test_alloc_compact(TstSuite* suite)
+{
+    DvzSize size = 64;
+    DvzSize alignment = 8;
+    DvzSize offset = 0;
+    DvzAllocMove* moves = NULL;
+    uint32_t count = 0;
+
+    DvzAlloc* alloc = dvz_alloc(size, alignment);
+
+    // Nothing to compact.
+    count = dvz_alloc_compact(alloc, &moves);
+    AT(count == 0);
+    AT(moves == NULL);
+
+    for (uint32_t i = 0; i < 6; i++)
+        dvz_alloc_new(alloc, 8, NULL);
+    // [A|B|C|D|E|F|-|-]
+
+    dvz_alloc_free(alloc, 8);
+    dvz_alloc_free(alloc, 16);
+    dvz_alloc_free(alloc, 32);
+    // [A|-|-|D|-|F|-|-]
+
+    count = dvz_alloc_compact(alloc, &moves);
+    // [A|D|F|-|-|-|-|-]
+    AT(count == 2);
+    ANN(moves);
+    AT(moves[0].src == 24);
+    AT(moves[0].dst == 8);
+    AT(moves[0].size == 8);
+    AT(moves[1].src == 40);
+    AT(moves[1].dst == 16);
+    AT(moves[1].size == 8);
+
+    // Offsets within the moved items are relocated, the others are kept.
+    AT(dvz_alloc_relocated(count, moves, 0) == 0);
+    AT(dvz_alloc_relocated(count, moves, 24) == 8);
+    AT(dvz_alloc_relocated(count, moves, 28) == 12);
+    AT(dvz_alloc_relocated(count, moves, 40) == 16);
+    FREE(moves);
+
+    AT(dvz_alloc_get(alloc, 0) == 8);
+    AT(dvz_alloc_get(alloc, 8) == 8);
+    AT(dvz_alloc_get(alloc, 16) == 8);
+
+    DvzSize allocated = 0, total = 0;
+    dvz_alloc_size(alloc, &allocated, &total);
+    AT(allocated == 24);
+    AT(total == size);
+
+    // The free space is now a single block.
+    offset = dvz_alloc_new(alloc, 40, NULL);
+    AT(offset == 24);
+
+    // Compacting again does not move anything.
+    count = dvz_alloc_compact(alloc, &moves);
+    AT(count == 0);
+    AT(moves == NULL);
+
+    // Freeing a compacted item works as before.
+    dvz_alloc_free(alloc, 8);
+    dvz_alloc_size(alloc, &allocated, NULL);
+    AT(allocated == 56);
+
+    dvz_alloc_destroy(alloc);
+    return 0;
+}
+
+
+
+int test_alloc_trim(TstSuite* suite)
+{
+    DvzSize size = 64;
+    DvzSize alignment = 8;
+    DvzSize offset = 0;
+    DvzSize resized = 0;
+    DvzSize total = 0;
+    DvzAllocMove* moves = NULL;
+
+    DvzAlloc* alloc = dvz_alloc(size, alignment);
+
+    // Grow the virtual buffer twice: 64 -> 128 -> 256.
+    offset = dvz_alloc_new(alloc, 48, &resized);
+    AT(offset == 0);
+    offset = dvz_alloc_new(alloc, 48, &resized);
+    AT(offset == 64);
+    AT(resized == 128);
+    offset = dvz_alloc_new(alloc, 96, &resized);
+    AT(offset == 128);
+    AT(resized == 256);
+
+    // Nothing to trim, the last item ends at the end of the buffer.
+    dvz_alloc_free(alloc, 64);
+    AT(dvz_alloc_trim(alloc, size) == 256);
+
+    // The last item is gone: the buffer can shrink back to 64.
+    dvz_alloc_free(alloc, 128);
+    AT(dvz_alloc_trim(alloc, size) == 64);
+    dvz_alloc_size(alloc, NULL, &total);
+    AT(total == 64);
+    AT(dvz_alloc_get(alloc, 0) == 48);
+
+    // Growing after trimming still doubles the size.
+    resized = 0;
+    offset = dvz_alloc_new(alloc, 32, &resized);
+    AT(offset == 64);
+    AT(resized == 128);
+
+    // Free the first item: trimming needs a compaction first.
+    dvz_alloc_free(alloc, 0);
+    AT(dvz_alloc_trim(alloc, size) == 128);
+    AT(dvz_alloc_compact(alloc, &moves) == 1);
+    AT(moves[0].src == 64);
+    AT(moves[0].dst == 0);
+    FREE(moves);
+    AT(dvz_alloc_trim(alloc, size) == 64);
+
+    // The remaining space can be allocated without resizing.
+    resized = 0;
+    offset = dvz_alloc_new(alloc, 32, &resized);
+    AT(offset == 32);
+    AT(!resized);
+
+    // Trimming an empty allocator goes back to the minimum size.
+    dvz_alloc_clear(alloc);
+    AT(dvz_alloc_trim(alloc, 16) == 16);
+
+    dvz_alloc_destroy(alloc);
+    return 0;
+}
+
+
+
+int test_alloc_extend(TstSuite* suite)
+{
+    DvzSize size = 64;
+    DvzSize alignment = 8;
+    DvzSize offset = 0;
+    DvzSize resized = 0;
+    DvzSize allocated = 0;
+
+    DvzAlloc* alloc = dvz_alloc(size, alignment);
+
+    offset = dvz_alloc_new(alloc, 8, NULL);
+    AT(offset == 0);
+    offset = dvz_alloc_new(alloc, 8, NULL);
+    AT(offset == 8);
+    // [A|B|-|-|-|-|-|-]
+
+    // The first item cannot grow, the second one can.
+    AT(!dvz_alloc_extend(alloc, 0, 16));
+    AT(dvz_alloc_extend(alloc, 8, 20));
+    // [A|B|B|B|-|-|-|-]
+    AT(dvz_alloc_get(alloc, 8) == 24);
+    dvz_alloc_size(alloc, &allocated, NULL);
+    AT(allocated == 32);
+
+    // New items go after the extended item.
+    offset = dvz_alloc_new(alloc, 8, NULL);
+    AT(offset == 32);
+    dvz_alloc_free(alloc, 32);
+
+    // Shrink in place, the end goes back to the free space.
+    AT(dvz_alloc_extend(alloc, 8, 8));
+    AT(dvz_alloc_get(alloc, 8) == 8);
+    offset = dvz_alloc_new(alloc, 48, NULL);
+    AT(offset == 16);
+    // [A|B|C|C|C|C|C|C]
+    dvz_alloc_free(alloc, 16);
+
+    // Shrink an item followed by an allocated item.
+    offset = dvz_alloc_new(alloc, 8, NULL);
+    AT(offset == 16);
+    AT(dvz_alloc_extend(alloc, 8, 8));
+    AT(dvz_alloc_extend(alloc, 0, 4));
+    dvz_alloc_size(alloc, &allocated, NULL);
+    AT(allocated == 24);
+
+    // Grow the virtual buffer twice (64 -> 128 -> 256), the appended free blocks are not merged.
+    offset = dvz_alloc_new(alloc, 100, &resized);
+    AT(resized == 256);
+    AT(offset == 128);
+
+    // Extend an item across the free blocks.
+    AT(dvz_alloc_extend(alloc, 16, 100));
+    AT(dvz_alloc_get(alloc, 16) == 104);
+    AT(!dvz_alloc_extend(alloc, 16, 120));
+
+    // Unknown offset.
+    AT(!dvz_alloc_extend(alloc, 4, 8));
+
+    dvz_alloc_destroy(alloc);
+    return 0;
+}
+
+
+
+int test_alloc_capacity(TstSuite* suite)
+{
+    // First allocation: exact size.
+    AT(dvz_alloc_capacity(0, 100) == 100);
+
+    // Growing at least doubles the capacity.
+    AT(dvz_alloc_capacity(100, 101) == 200);
+    AT(dvz_alloc_capacity(100, 500) == 500);
+
+    // The capacity is kept while the size remains above a quarter of it.
+    AT(dvz_alloc_capacity(200, 200) == 200);
+    AT(dvz_alloc_capacity(200, 51) == 200);
+
+    // Below, it is halved.
+    AT(dvz_alloc_capacity(200, 50) == 100);
+    AT(dvz_alloc_capacity(200, 1) == 100);
+
+    // Appending one byte at a time only reallocates a logarithmic number of times.
+    DvzSize capacity = 0, new_capacity = 0;
+    uint32_t reallocs = 0;
+    for (DvzSize size = 1; size <= 1000000; size++)
+    {
+        new_capacity = dvz_alloc_capacity(capacity, size);
+        AT(new_capacity >= size);
+        if (new_capacity != capacity)
+            reallocs++;
+        capacity = new_capacity;
+    }
+    AT(reallocs == 21);
+
+    return 0;
+}
@@ -33,6 +33,14 @@ int test_alloc_3(TstSuite*);
 
 int test_alloc_4(TstSuite*);
 
+int test_alloc_compact(TstSuite*);
+
+int test_alloc_trim(TstSuite*);
+
+int test_alloc_extend(TstSuite*);
+
+int test_alloc_capacity(TstSuite*);
+
 
 
 #endif
@@ -64,6 +64,75 @@ static void _delete_window(DvzClient* client, DvzId id)
 
 
 
+static void _count_frame(DvzClient* client, DvzClientEvent ev)
+{
+    ANN(client);
+    ASSERT(ev.type == DVZ_CLIENT_EVENT_FRAME);
+
+    uint32_t* frame_count = (uint32_t*)ev.user_data;
+    ANN(frame_count);
+    (*frame_count)++;
+}
+
+
+
+typedef struct
+{
+    uint32_t count;
+    DvzMouseEvent events[8];
+} MouseEvents;
+
+static void _record_mouse(DvzClient* client, DvzClientEvent ev)
+{
+    ANN(client);
+    ASSERT(ev.type == DVZ_CLIENT_EVENT_MOUSE);
+
+    MouseEvents* events = (MouseEvents*)ev.user_data;
+    ANN(events);
+    if (events->count < 8)
+        events->events[events->count] = ev.content.m;
+    events->count++;
+}
+
+
+
+static void _sum_wheel(DvzClient* client, DvzClientEvent ev)
+{
+    ANN(client);
+    if (ev.content.m.type == DVZ_MOUSE_EVENT_WHEEL)
+        *((float*)ev.user_data) += ev.content.m.content.w.dir[1];
+}
+
+
+
+static void* _wheel_thread(void* user_data)
+{
+    DvzClient* client = (DvzClient*)user_data;
+    ANN(client);
+
+    DvzClientEvent ev = {.type = DVZ_CLIENT_EVENT_MOUSE, .window_id = WID};
+    ev.content.m.type = DVZ_MOUSE_EVENT_WHEEL;
+    ev.content.m.content.w.dir[1] = 1;
+    for (uint32_t k = 0; k < 10000; k++)
+        dvz_client_event(client, ev);
+    return NULL;
+}
+
+
+
+static void _mouse_event(DvzClient* client, DvzId id, DvzMouseEventType type, vec2 pos)
+{
+    ANN(client);
+
+    DvzClientEvent ev = {.type = DVZ_CLIENT_EVENT_MOUSE, .window_id = id};
+    ev.content.m.type = type;
+    ev.content.m.pos[0] = pos[0];
+    ev.content.m.pos[1] = pos[1];
+    dvz_client_event(client, ev);
+}
+
+
+
 /*************************************************************************************************/
 /*  Client tests                                                                                 */
 /*************************************************************************************************/
@@ -105,6 +174,135 @@ int test_client_2(TstSuite* suite)
 
 
 
+int test_client_on_demand(TstSuite* suite)
+{
+    // NOTE: the offscreen backend does not create actual windows, so that the FRAME events can be
+    // counted without a display.
+    DvzClient* client = dvz_client(DVZ_BACKEND_OFFSCREEN);
+    dvz_client_on_demand(client, true);
+    client->wait_timeout = 0.001;
+
+    uint32_t frame_count = 0;
+    dvz_client_callback(
+        client, DVZ_CLIENT_EVENT_FRAME, DVZ_CLIENT_CALLBACK_SYNC, _count_frame, &frame_count);
+
+    // A new window is drawn once, and then not redrawn while nothing changes.
+    _create_window(client, WID);
+    dvz_client_run(client, 10);
+    AT(frame_count == 1);
+
+    // An input event redraws its window once.
+    DvzClientEvent ev = {.type = DVZ_CLIENT_EVENT_MOUSE, .window_id = WID};
+    ev.content.m.type = DVZ_MOUSE_EVENT_MOVE;
+    dvz_client_event(client, ev);
+    dvz_client_run(client, 10);
+    AT(frame_count == 2);
+
+    // Explicit redraw request.
+    dvz_client_redraw(client, WID);
+    dvz_client_run(client, 10);
+    AT(frame_count == 3);
+
+    // Scheduled redraw: the event loop draws the window once the time has come.
+    dvz_client_redraw_at(client, dvz_clock_get(&client->clock) + 0.005);
+    dvz_client_run(client, 1);
+    AT(frame_count == 3);
+    dvz_client_run(client, 20);
+    AT(frame_count == 4);
+    AT(client->wake_time < 0);
+
+    // Without on-demand rendering, every iteration of the event loop draws the window.
+    dvz_client_on_demand(client, false);
+    dvz_client_run(client, 10);
+    AT(frame_count == 14);
+
+    dvz_client_destroy(client);
+    return 0;
+}
+
+
+
+int test_client_coalesce(TstSuite* suite)
+{
+    DvzClient* client = dvz_client(DVZ_BACKEND_OFFSCREEN);
+
+    MouseEvents events = {0};
+    dvz_client_callback(
+        client, DVZ_CLIENT_EVENT_MOUSE, DVZ_CLIENT_CALLBACK_SYNC, _record_mouse, &events);
+
+    // Consecutive moves are merged into the last one.
+    for (uint32_t k = 0; k < 100; k++)
+        _mouse_event(client, WID, DVZ_MOUSE_EVENT_MOVE, (vec2){k, 2 * k});
+    dvz_client_process(client);
+    AT(events.count == 1);
+    AT(events.events[0].pos[0] == 99);
+    AT(events.events[0].pos[1] == 198);
+
+    // Consecutive wheel events are merged by accumulating their directions.
+    memset(&events, 0, sizeof(events));
+    DvzClientEvent ev = {.type = DVZ_CLIENT_EVENT_MOUSE, .window_id = WID};
+    ev.content.m.type = DVZ_MOUSE_EVENT_WHEEL;
+    ev.content.m.content.w.dir[1] = 1;
+    for (uint32_t k = 0; k < 10; k++)
+        dvz_client_event(client, ev);
+    dvz_client_process(client);
+    AT(events.count == 1);
+    AT(events.events[0].content.w.dir[1] == 10);
+
+    // Drag events keep the last position of the first event.
+    memset(&events, 0, sizeof(events));
+    ev.content.m.type = DVZ_MOUSE_EVENT_DRAG;
+    for (uint32_t k = 0; k < 10; k++)
+    {
+        ev.content.m.content.d.last_pos[0] = k;
+        ev.content.m.pos[0] = k + 1;
+        dvz_client_event(client, ev);
+    }
+    dvz_client_process(client);
+    AT(events.count == 1);
+    AT(events.events[0].content.d.last_pos[0] == 0);
+    AT(events.events[0].pos[0] == 10);
+
+    // The other events are not merged and keep their order.
+    memset(&events, 0, sizeof(events));
+    _mouse_event(client, WID, DVZ_MOUSE_EVENT_MOVE, (vec2){1, 1});
+    _mouse_event(client, WID, DVZ_MOUSE_EVENT_MOVE, (vec2){2, 2});
+    _mouse_event(client, WID, DVZ_MOUSE_EVENT_PRESS, (vec2){2, 2});
+    _mouse_event(client, WID, DVZ_MOUSE_EVENT_MOVE, (vec2){3, 3});
+    _mouse_event(client, WID + 1, DVZ_MOUSE_EVENT_MOVE, (vec2){4, 4});
+    dvz_client_process(client);
+    AT(events.count == 4);
+    AT(events.events[0].type == DVZ_MOUSE_EVENT_MOVE);
+    AT(events.events[0].pos[0] == 2);
+    AT(events.events[1].type == DVZ_MOUSE_EVENT_PRESS);
+    AT(events.events[2].pos[0] == 3);
+    AT(events.events[3].pos[0] == 4);
+
+    // Events emitted from another thread while the events are processed are not lost.
+    float wheel = 0;
+    dvz_client_callback(
+        client, DVZ_CLIENT_EVENT_MOUSE, DVZ_CLIENT_CALLBACK_SYNC, _sum_wheel, &wheel);
+    DvzThread* thread = dvz_thread(_wheel_thread, client);
+    for (uint32_t k = 0; k < 1000; k++)
+        dvz_client_process(client);
+    dvz_thread_join(thread);
+    dvz_client_process(client);
+    AT(wheel == 10000);
+
+    // Without coalescing, every event reaches the callbacks.
+    memset(&events, 0, sizeof(events));
+    dvz_client_coalesce(client, false);
+    for (uint32_t k = 0; k < 3; k++)
+        _mouse_event(client, WID, DVZ_MOUSE_EVENT_MOVE, (vec2){k, k});
+    dvz_client_process(client);
+    AT(events.count == 3);
+
+    dvz_client_destroy(client);
+    return 0;
+}
+
+
+
 int test_client_thread(TstSuite* suite)
 {
 #if OS_MACOS
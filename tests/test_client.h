@@ -30,6 +30,10 @@ int test_client_1(TstSuite*);
 
 int test_client_2(TstSuite*);
 
+int test_client_on_demand(TstSuite*);
+
+int test_client_coalesce(TstSuite*);
+
 int test_client_thread(TstSuite*);
 
 
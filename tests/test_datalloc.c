@@ -142,3 +142,77 @@ int test_datalloc_2(TstSuite* suite)
     dvz_context_destroy(ctx);
     return 0;
 }
+
+
+
+int test_datalloc_compact(TstSuite* suite)
+{
+    ANN(suite);
+    DvzGpu* gpu = get_gpu(suite);
+    ANN(gpu);
+
+    // Create the resources object.
+    DvzContext* ctx = dvz_context(gpu);
+    DvzSize size = 1024;
+    uint8_t data[1024] = {0};
+    uint8_t out[1024] = {0};
+
+    // 3 dats in the vertex buffer.
+    DvzDat* dats[3] = {0};
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        dats[i] = dvz_dat(ctx, DVZ_BUFFER_TYPE_VERTEX, size, 0);
+        ANN(dats[i]);
+        memset(data, (int)(i + 1), size);
+        dvz_dat_upload(dats[i], 0, size, data, true);
+    }
+    DvzBuffer* buffer = dats[0]->br.buffer;
+    DvzSize alignment = buffer->vma.alignment;
+    DvzSize step = _align(size, alignment);
+    AT(dats[2]->br.offsets[0] == 2 * step);
+
+    // A large dat makes the vertex buffer grow.
+    DvzDat* large = dvz_dat(ctx, DVZ_BUFFER_TYPE_VERTEX, 2 * DVZ_BUFFER_DEFAULT_SIZE, 0);
+    ANN(large);
+    AT(buffer->size > DVZ_BUFFER_DEFAULT_SIZE);
+    log_trace("[1 | 2 | 3 | large | ---");
+
+    // Delete the second and the large dats.
+    dvz_dat_destroy(dats[1]);
+    dvz_dat_destroy(large);
+    log_trace("[1 | --- | 3 | ---");
+
+    // Compact the vertex buffer: the third dat moves to the second position, and the buffer
+    // shrinks back to its initial size.
+    DvzAllocMove* moves = NULL;
+    uint32_t count = dvz_datalloc_compact(
+        &ctx->datalloc, &ctx->res, DVZ_BUFFER_TYPE_VERTEX, false, &moves);
+    log_trace("[1 | 3 | ---");
+    AT(count == 1);
+    ANN(moves);
+    AT(moves[0].src == 2 * step);
+    AT(moves[0].dst == step);
+    FREE(moves);
+
+    AT(buffer->size == DVZ_BUFFER_DEFAULT_SIZE);
+    AT(dats[0]->br.offsets[0] == 0);
+    AT(dats[2]->br.offsets[0] == step);
+
+    // The contents of the dats have been kept.
+    dvz_dat_download(dats[0], 0, size, out, true);
+    AT(out[0] == 1 && out[size - 1] == 1);
+    dvz_dat_download(dats[2], 0, size, out, true);
+    AT(out[0] == 3 && out[size - 1] == 3);
+
+    // Nothing left to compact or trim.
+    AT(dvz_datalloc_compact(&ctx->datalloc, &ctx->res, DVZ_BUFFER_TYPE_VERTEX, false, NULL) == 0);
+    AT(dvz_datalloc_trim(&ctx->datalloc, &ctx->res, DVZ_BUFFER_TYPE_VERTEX, false) ==
+       DVZ_BUFFER_DEFAULT_SIZE);
+
+    // New allocations go after the compacted dats.
+    DvzDat* dat = dvz_dat(ctx, DVZ_BUFFER_TYPE_VERTEX, size, 0);
+    AT(dat->br.offsets[0] == 2 * step);
+
+    dvz_context_destroy(ctx);
+    return 0;
+}
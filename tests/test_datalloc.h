@@ -29,6 +29,8 @@ int test_datalloc_1(TstSuite*);
 
 int test_datalloc_2(TstSuite*);
 
+int test_datalloc_compact(TstSuite*);
+
 
 
 #endif
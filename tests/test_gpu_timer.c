@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing GPU timer                                                                            */
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "test_gpu_timer.h"
+#include "board.h"
+#include "canvas.h"
+#include "gpu_timer.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  GPU timer tests                                                                              */
+/*************************************************************************************************/
+
+int test_gpu_timer_1(TstSuite* suite)
+{
+    ANN(suite);
+    DvzGpu* gpu = get_gpu(suite);
+    ANN(gpu);
+
+    DvzRenderpass renderpass = offscreen_renderpass(gpu);
+    DvzCanvas board = dvz_board(gpu, &renderpass, WIDTH, HEIGHT, DVZ_CANVAS_FLAGS_PROFILE);
+    dvz_board_create(&board);
+    if (!dvz_obj_is_created(&board.render.timer.queries.obj))
+    {
+        log_warn("skipping GPU timer test as the GPU does not support timestamps");
+        dvz_board_destroy(&board);
+        dvz_renderpass_destroy(&renderpass);
+        return 0;
+    }
+
+    // Record a view span containing two visual spans, and an unbalanced span.
+    DvzCommands cmds = dvz_commands(gpu, DVZ_DEFAULT_QUEUE_RENDER, 1);
+    dvz_board_begin(&board, &cmds, 0);
+    dvz_board_viewport(&board, &cmds, 0, DVZ_DEFAULT_VIEWPORT, DVZ_DEFAULT_VIEWPORT);
+    dvz_canvas_timestamp(&board, &cmds, 0, 1, false);
+    dvz_canvas_timestamp(&board, &cmds, 0, 2, false);
+    dvz_canvas_timestamp(&board, &cmds, 0, 2, true);
+    dvz_canvas_timestamp(&board, &cmds, 0, 3, false);
+    dvz_canvas_timestamp(&board, &cmds, 0, 3, true);
+    dvz_canvas_timestamp(&board, &cmds, 0, 1, true);
+    dvz_canvas_timestamp(&board, &cmds, 0, 4, false); // ended by dvz_board_end()
+    dvz_board_end(&board, &cmds, 0);
+    AT(board.render.timer.recorded_count[0] == 4);
+    AT(board.render.timer.depth == 0);
+
+    DvzId ids[8] = {0};
+    uint64_t ns[8] = {0};
+
+    // Nothing has been submitted yet.
+    dvz_canvas_gpu_collect(&board, 0);
+    AT(dvz_canvas_gpu_times(&board, 8, ids, ns) == 0);
+
+    // The durations are available once the submission has completed.
+    dvz_cmd_submit_sync(&cmds, 0);
+    dvz_canvas_gpu_collect(&board, 0);
+    AT(dvz_canvas_gpu_times(&board, 8, ids, ns) == 4);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        AT(ids[i] == i + 1);
+        log_debug("GPU time of span 0x%" PRIx64 ": %" PRIu64 " ns", ids[i], ns[i]);
+    }
+    // The view span contains the visual spans.
+    AT(ns[0] >= ns[1]);
+    AT(ns[0] >= ns[2]);
+
+    // The output arrays may be smaller than the number of spans.
+    AT(dvz_canvas_gpu_times(&board, 2, ids, ns) == 2);
+
+    // Submitting the same command buffer again resets and rewrites the timestamps.
+    dvz_canvas_gpu_collect(&board, 0);
+    dvz_cmd_submit_sync(&cmds, 0);
+    dvz_canvas_gpu_collect(&board, 0);
+    AT(dvz_canvas_gpu_times(&board, 8, ids, ns) == 4);
+
+    // Destruction.
+    dvz_commands_destroy(&cmds);
+    dvz_board_destroy(&board);
+    dvz_renderpass_destroy(&renderpass);
+
+    return 0;
+}
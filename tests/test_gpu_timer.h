@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing GPU timer                                                                            */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_GPU_TIMER
+#define DVZ_HEADER_TEST_GPU_TIMER
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "gpu_timer.h"
+#include "test.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  GPU timer tests                                                                              */
+/*************************************************************************************************/
+
+int test_gpu_timer_1(TstSuite*);
+
+
+
+#endif
@@ -16,7 +16,11 @@
 
 #include <stdio.h>
 
+#include "_handle.h"
 #include "_map.h"
+#include "_prng.h"
+#include "_time_utils.h"
+#include "datoviz_protocol.h"
 #include "test.h"
 #include "test_map.h"
 #include "testing.h"
@@ -108,3 +112,121 @@ int test_map_2(TstSuite* suite)
     dvz_map_destroy(map);
     return 0;
 }
+
+
+
+int test_map_3(TstSuite* suite)
+{
+    DvzMap* map = dvz_map();
+    DvzHandles* handles = dvz_handles();
+
+    int type = 3;
+    int data[3] = {42, 103, 7};
+
+    // Dense handles of different types are independent.
+    DvzId id0 = dvz_handles_alloc(handles, (uint32_t)type);
+    DvzId id1 = dvz_handles_alloc(handles, (uint32_t)type);
+    DvzId other = dvz_handles_alloc(handles, (uint32_t)type + 1);
+    AT(dvz_handle_is_dense(id0));
+    AT(dvz_handle_type(id0) == (uint32_t)type);
+    AT(dvz_handle_index(id0) == 0);
+    AT(dvz_handle_index(id1) == 1);
+    AT(dvz_handle_index(other) == 0);
+    AT(dvz_handle_generation(id0) == 0);
+
+    dvz_map_add(map, id0, type, &data[0]);
+    dvz_map_add(map, id1, type, &data[1]);
+    AT(dvz_map_get(map, id0) == &data[0]);
+    AT(dvz_map_get(map, id1) == &data[1]);
+    AT(dvz_map_get(map, other) == NULL);
+    AT(dvz_map_type(map, id1) == type);
+    AT(dvz_map_count(map, type) == 2);
+
+    // Dense handles and random IDs coexist in the same map.
+    DvzId rid = 12345;
+    AT(!dvz_handle_is_dense(rid));
+    dvz_map_add(map, rid, type, &data[2]);
+    AT(dvz_map_get(map, rid) == &data[2]);
+    AT(dvz_map_count(map, 0) == 3);
+
+    // Free a handle: its slot is reused with a new generation, and the stale handle no longer
+    // resolves to anything.
+    dvz_map_remove(map, id0);
+    dvz_handles_free(handles, id0);
+    AT(!dvz_map_exists(map, id0));
+    DvzId id2 = dvz_handles_alloc(handles, (uint32_t)type);
+    AT(dvz_handle_index(id2) == dvz_handle_index(id0));
+    AT(dvz_handle_generation(id2) == 1);
+    AT(id2 != id0);
+    dvz_map_add(map, id2, type, &data[2]);
+    AT(dvz_map_get(map, id2) == &data[2]);
+    AT(dvz_map_get(map, id0) == NULL);
+    AT(dvz_map_count(map, 0) == 3);
+
+    // The process-wide allocator is created once and outlives the requesters.
+    DvzHandles* global = dvz_handles_global();
+    AT(global != NULL);
+    DvzRequester* rqr = dvz_requester();
+    dvz_requester_destroy(rqr);
+    AT(dvz_handles_global() == global);
+    DvzId id3 = dvz_handles_alloc(global, (uint32_t)type);
+    AT(dvz_handle_is_dense(id3));
+    dvz_handles_free(global, id3);
+
+    dvz_handles_destroy(handles);
+    dvz_map_destroy(map);
+    return 0;
+}
+
+
+
+static double _map_bench(DvzMap* map, uint32_t n, DvzId* ids, int* data)
+{
+    DvzClock clock = dvz_clock();
+    for (uint32_t i = 0; i < n; i++)
+        dvz_map_add(map, ids[i], 1, &data[i]);
+    for (uint32_t i = 0; i < n; i++)
+        ASSERT(dvz_map_get(map, ids[i]) == &data[i]);
+    for (uint32_t i = 0; i < n; i++)
+        dvz_map_remove(map, ids[i]);
+    return dvz_clock_get(&clock);
+}
+
+
+
+int test_map_4(TstSuite* suite)
+{
+    const uint32_t n = 100000;
+    DvzId* ids = (DvzId*)calloc(n, sizeof(DvzId));
+    int* data = (int*)calloc(n, sizeof(int));
+
+    // Random IDs, resolved with the ordered map.
+    DvzPrng* prng = dvz_prng();
+    for (uint32_t i = 0; i < n; i++)
+        ids[i] = dvz_prng_uuid(prng) & DVZ_HANDLE_RANDOM_MASK;
+    dvz_prng_destroy(prng);
+
+    DvzMap* map = dvz_map();
+    double t_random = _map_bench(map, n, ids, data);
+    AT(dvz_map_count(map, 0) == 0);
+    dvz_map_destroy(map);
+
+    // Dense handles, resolved with the slot arrays.
+    DvzHandles* handles = dvz_handles();
+    for (uint32_t i = 0; i < n; i++)
+        ids[i] = dvz_handles_alloc(handles, 1);
+    dvz_handles_destroy(handles);
+
+    map = dvz_map();
+    double t_dense = _map_bench(map, n, ids, data);
+    AT(dvz_map_count(map, 0) == 0);
+    dvz_map_destroy(map);
+
+    log_info(
+        "add/get/remove %d objects: random IDs %.3f ms, dense handles %.3f ms", n,
+        t_random * 1000, t_dense * 1000);
+
+    FREE(ids);
+    FREE(data);
+    return 0;
+}
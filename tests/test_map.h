@@ -29,6 +29,10 @@ int test_map_1(TstSuite*);
 
 int test_map_2(TstSuite*);
 
+int test_map_3(TstSuite*);
+
+int test_map_4(TstSuite*);
+
 
 
 #endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing OIT                                                                                  */
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "test_oit.h"
+#include "app.h"
+#include "board.h"
+#include "canvas.h"
+#include "datoviz.h"
+#include "oit.h"
+#include "renderer.h"
+#include "scene/scene.h"
+#include "scene/visual.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  OIT tests                                                                                    */
+/*************************************************************************************************/
+
+int test_oit_1(TstSuite* suite)
+{
+    ANN(suite);
+    DvzGpu* gpu = get_gpu(suite);
+    ANN(gpu);
+
+    cvec4 clear_color = {32, 64, 128, 255};
+    DvzRenderpass renderpass = dvz_gpu_renderpass_flags(
+        gpu, clear_color, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, DVZ_RENDERPASS_FLAGS_OIT);
+    AT(renderpass.subpass_count == 2);
+    AT(renderpass.attachment_count == 4);
+    AT(renderpass.attachments[2].type == DVZ_RENDERPASS_ATTACHMENT_ACCUM);
+    AT(renderpass.attachments[3].type == DVZ_RENDERPASS_ATTACHMENT_REVEAL);
+
+    // Create a board with the OIT attachments.
+    DvzCanvas board = dvz_board(gpu, &renderpass, WIDTH, HEIGHT, DVZ_CANVAS_FLAGS_OIT);
+    dvz_board_create(&board);
+
+    // Render an empty frame: the composite subpass must leave the clear color untouched.
+    DvzCommands cmds = dvz_commands(gpu, DVZ_DEFAULT_QUEUE_RENDER, 1);
+    dvz_board_begin(&board, &cmds, 0);
+    dvz_board_viewport(&board, &cmds, 0, DVZ_DEFAULT_VIEWPORT, DVZ_DEFAULT_VIEWPORT);
+    dvz_board_end(&board, &cmds, 0);
+    dvz_cmd_submit_sync(&cmds, 0);
+
+    uint8_t* rgb = dvz_board_alloc(&board);
+    dvz_board_download(&board, board.size, rgb);
+    for (uint32_t i = 0; i < WIDTH * HEIGHT; i += 97)
+    {
+        AT(rgb[3 * i + 0] == clear_color[0]);
+        AT(rgb[3 * i + 1] == clear_color[1]);
+        AT(rgb[3 * i + 2] == clear_color[2]);
+    }
+    dvz_board_free(&board);
+
+    // Destruction.
+    dvz_commands_destroy(&cmds);
+    dvz_board_destroy(&board);
+    dvz_renderpass_destroy(&renderpass);
+
+    // Offscreen scene with the OIT attachments and a translucent point at the center.
+    DvzApp* app = dvz_app(DVZ_APP_FLAGS_OFFSCREEN);
+    DvzBatch* batch = dvz_app_batch(app);
+    DvzScene* scene = dvz_scene(batch);
+    DvzFigure* figure = dvz_figure(scene, WIDTH, HEIGHT, DVZ_CANVAS_FLAGS_OIT);
+    DvzPanel* panel = dvz_panel_default(figure);
+
+    DvzVisual* visual = dvz_point(batch, 0);
+    dvz_visual_blend(visual, DVZ_BLEND_OIT);
+    dvz_point_alloc(visual, 1);
+    dvz_point_position(visual, 0, 1, (vec3[]){{0, 0, 0}}, 0);
+    dvz_point_color(visual, 0, 1, (DvzColor[]){{COLOR_U2DV(255, 0, 0, 128)}}, 0);
+    dvz_point_size(visual, 0, 1, (float[]){40}, 0);
+    dvz_panel_visual(panel, visual, 0);
+
+    // NOTE: with offscreen rendering, the scene is just rendered once.
+    dvz_scene_run(scene, app, N_FRAMES);
+
+    DvzSize size = 0;
+    rgb = dvz_renderer_image(app->rd, figure->canvas_id, &size, NULL);
+    AT(size == WIDTH * HEIGHT * 3);
+
+    // The composite subpass blends the translucent point halfway onto the background, and leaves
+    // the background untouched elsewhere.
+    uint8_t* bg = &rgb[0];
+    uint8_t* center = &rgb[3 * ((HEIGHT / 2) * WIDTH + WIDTH / 2)];
+    const int tol = 8;
+    AT(abs((int)center[0] - (255 + (int)bg[0]) / 2) <= tol);
+    AT(abs((int)center[1] - (int)bg[1] / 2) <= tol);
+    AT(abs((int)center[2] - (int)bg[2] / 2) <= tol);
+    AT(memcmp(&rgb[3 * (HEIGHT / 4) * WIDTH], bg, 3) == 0);
+
+    // Cleanup.
+    dvz_scene_destroy(scene);
+    dvz_app_destroy(app);
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing OIT                                                                                  */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_OIT
+#define DVZ_HEADER_TEST_OIT
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "oit.h"
+#include "test.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  OIT tests                                                                                    */
+/*************************************************************************************************/
+
+int test_oit_1(TstSuite*);
+
+
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing pick                                                                                 */
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "test_pick.h"
+#include "_time_utils.h"
+#include "app.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "pick.h"
+#include "renderer.h"
+#include "scene/scene.h"
+#include "scene/visual.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Pick tests                                                                                   */
+/*************************************************************************************************/
+
+int test_pick_1(TstSuite* suite)
+{
+    ANN(suite);
+
+    const uint32_t w = 9, h = 7;
+    ivec4 data[9 * 7] = {0};
+    DvzPick pick = {0};
+
+    // Empty region.
+    AT(!dvz_pick_closest(w, h, data, 4, 3, 3, &pick));
+    AT(pick.visual == 0);
+
+    // Two items, the closest one to the center wins.
+    data[3 * w + 6][0] = 1; // visual 1, item 10 at (6, 3)
+    data[3 * w + 6][1] = 10;
+    data[1 * w + 4][0] = 2; // visual 2, item 20 at (4, 1)
+    data[1 * w + 4][1] = 20;
+    data[3 * w + 5][0] = 2; // visual 2, item 21 at (5, 3)
+    data[3 * w + 5][1] = 21;
+    AT(dvz_pick_closest(w, h, data, 4, 3, 3, &pick));
+    AT(pick.visual == 2);
+    AT(pick.item == 21);
+    AT(pick.x == 5);
+    AT(pick.y == 3);
+
+    // Exact hit.
+    AT(dvz_pick_closest(w, h, data, 6, 3, 0, &pick));
+    AT(pick.visual == 1);
+    AT(pick.item == 10);
+
+    // Outside of the radius.
+    AT(!dvz_pick_closest(w, h, data, 0, 6, 2, &pick));
+    AT(pick.visual == 0);
+
+    return 0;
+}
+
+
+
+int test_pick_2(TstSuite* suite)
+{
+    ANN(suite);
+
+    // Offscreen scene with a pick attachment.
+    DvzApp* app = dvz_app(DVZ_APP_FLAGS_OFFSCREEN);
+    DvzBatch* batch = dvz_app_batch(app);
+    DvzScene* scene = dvz_scene(batch);
+    DvzFigure* figure = dvz_figure(scene, WIDTH, HEIGHT, DVZ_CANVAS_FLAGS_PICK);
+    DvzPanel* panel = dvz_panel_default(figure);
+
+    // Pickable point visual, item #1 is at the center of the canvas.
+    const uint32_t n = 3;
+    DvzVisual* visual = dvz_point(batch, DVZ_VISUAL_FLAGS_PICK);
+    AT(dvz_visual_pick_id(visual) > 0);
+    dvz_point_alloc(visual, n);
+
+    vec3 pos[] = {{-.9, -.9, 0}, {0, 0, 0}, {+.9, +.9, 0}};
+    dvz_point_position(visual, 0, n, pos, 0);
+
+    DvzColor* color = dvz_mock_color(n, ALPHA_U2D(255));
+    dvz_point_color(visual, 0, n, color, 0);
+
+    float size[] = {20, 20, 20};
+    dvz_point_size(visual, 0, n, size, 0);
+
+    dvz_panel_visual(panel, visual, 0);
+
+    // NOTE: with offscreen rendering, the scene is just rendered once.
+    dvz_scene_run(scene, app, N_FRAMES);
+    DvzId canvas_id = figure->canvas_id;
+
+    // Pick asynchronously next to the center and poll the result.
+    DvzPick pick = {0};
+    dvz_pick(batch, canvas_id, WIDTH / 2 + 2, HEIGHT / 2 - 2, 4);
+    dvz_app_submit(app);
+    uint32_t i = 0;
+    for (i = 0; i < 1000; i++)
+    {
+        if (dvz_renderer_pick(app->rd, canvas_id, &pick))
+            break;
+        dvz_sleep(1);
+    }
+    AT(i < 1000);
+    AT(pick.visual == dvz_visual_pick_id(visual));
+    AT(pick.item == 1);
+
+    // Nothing is picked in an empty region of the canvas.
+    dvz_pick(batch, canvas_id, WIDTH / 4, 3 * HEIGHT / 4, 4);
+    dvz_app_submit(app);
+    for (i = 0; i < 1000; i++)
+    {
+        if (dvz_renderer_pick(app->rd, canvas_id, &pick))
+            break;
+        dvz_sleep(1);
+    }
+    AT(i < 1000);
+    AT(pick.visual == 0);
+
+    // Nothing is picked outside of the canvas.
+    dvz_pick(batch, canvas_id, -100, -100, 4);
+    dvz_app_submit(app);
+    for (i = 0; i < 1000; i++)
+    {
+        if (dvz_renderer_pick(app->rd, canvas_id, &pick))
+            break;
+        dvz_sleep(1);
+    }
+    AT(i < 1000);
+    AT(pick.visual == 0);
+
+    // Cleanup.
+    dvz_scene_destroy(scene);
+    dvz_app_destroy(app);
+    FREE(color);
+
+    return 0;
+}
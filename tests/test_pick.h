@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing pick                                                                                 */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_PICK
+#define DVZ_HEADER_TEST_PICK
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "pick.h"
+#include "test.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Pick tests                                                                                   */
+/*************************************************************************************************/
+
+int test_pick_1(TstSuite*);
+
+int test_pick_2(TstSuite*);
+
+
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing pipe cache                                                                           */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_hash.h"
+#include "pipecache.h"
+#include "test.h"
+#include "test_pipecache.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Pipe cache tests                                                                             */
+/*************************************************************************************************/
+
+int test_pipecache_1(TstSuite* suite)
+{
+    DvzPipeCache* cache = dvz_pipecache();
+    ANN(cache);
+
+    // Two identical shaders have the same hash, a different one does not.
+    uint32_t code0[] = {0x07230203, 1, 2, 3};
+    uint32_t code1[] = {0x07230203, 1, 2, 4};
+    uint32_t code2[] = {0x07230203, 1, 2, 3, 0};
+    uint64_t h0 = dvz_hash(DVZ_HASH_SEED, sizeof(code0), code0);
+    uint64_t h1 = dvz_hash(DVZ_HASH_SEED, sizeof(code1), code1);
+    AT(h0 != h1);
+    AT(h0 == dvz_hash(DVZ_HASH_SEED, sizeof(code0), code0));
+
+    // First graphics: miss, the caller creates the module and puts it in the cache.
+    AT(dvz_pipecache_get(cache, DVZ_PIPECACHE_MODULE, sizeof(code0), code0) == 0);
+    dvz_pipecache_put(cache, DVZ_PIPECACHE_MODULE, sizeof(code0), code0, 100);
+
+    // Second graphics with the same code: hit.
+    AT(dvz_pipecache_get(cache, DVZ_PIPECACHE_MODULE, sizeof(code0), code0) == 100);
+
+    // Third graphics with a different code: miss.
+    AT(dvz_pipecache_get(cache, DVZ_PIPECACHE_MODULE, sizeof(code1), code1) == 0);
+    dvz_pipecache_put(cache, DVZ_PIPECACHE_MODULE, sizeof(code1), code1, 101);
+
+    // The keys are compared in full, including their size.
+    AT(dvz_pipecache_get(cache, DVZ_PIPECACHE_MODULE, sizeof(code2), code2) == 0);
+
+    // The object types are independent.
+    AT(dvz_pipecache_get(cache, DVZ_PIPECACHE_PIPELINE, sizeof(code0), code0) == 0);
+
+    DvzPipeCacheStats stats = dvz_pipecache_stats(cache, DVZ_PIPECACHE_MODULE);
+    AT(stats.count == 2);
+    AT(stats.refs == 3);
+    AT(stats.hits == 1);
+    AT(stats.misses == 3);
+
+    // Release: the object must only be destroyed by its last user.
+    AT(dvz_pipecache_release(cache, DVZ_PIPECACHE_MODULE, 100) == 1);
+    AT(dvz_pipecache_release(cache, DVZ_PIPECACHE_MODULE, 100) == 0);
+    AT(dvz_pipecache_release(cache, DVZ_PIPECACHE_MODULE, 101) == 0);
+
+    // An object that is not in the cache must be destroyed by the caller.
+    AT(dvz_pipecache_release(cache, DVZ_PIPECACHE_MODULE, 100) == -1);
+
+    // Once released, the object is no longer in the cache.
+    AT(dvz_pipecache_get(cache, DVZ_PIPECACHE_MODULE, sizeof(code0), code0) == 0);
+    stats = dvz_pipecache_stats(cache, DVZ_PIPECACHE_MODULE);
+    AT(stats.count == 0);
+    AT(stats.refs == 0);
+
+    dvz_pipecache_destroy(cache);
+    return 0;
+}
@@ -411,6 +411,67 @@ int test_renderer_push(TstSuite* suite)
 
 
 
+int test_renderer_compute(TstSuite* suite)
+{
+    DvzGpu* gpu = get_gpu(suite);
+    ANN(gpu);
+
+    DvzRenderer* rd = dvz_renderer(gpu, 0);
+    DvzBatch* batch = dvz_batch();
+    DvzRequest req = {0};
+
+    // Load the compute shader, which doubles the first 20 values of a storage buffer.
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/test_double.comp.spv", SPIRV_DIR);
+    DvzSize shader_size = 0;
+    uint32_t* shader_code = (uint32_t*)dvz_read_file(path, &shader_size);
+    ASSERT(shader_size > 0);
+    req = dvz_create_spirv(
+        batch, DVZ_SHADER_COMPUTE, shader_size, (const unsigned char*)shader_code);
+    DvzId shader_id = req.id;
+    FREE(shader_code);
+
+    // Create the compute pipe.
+    req = dvz_create_compute(batch, shader_id, 0);
+    DvzId compute_id = req.id;
+    dvz_set_slot(batch, compute_id, 0, DVZ_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    // Create and upload the storage buffer dat.
+    const uint32_t n = 20;
+    float data[20] = {0};
+    for (uint32_t i = 0; i < n; i++)
+        data[i] = i;
+    req = dvz_create_dat(batch, DVZ_BUFFER_TYPE_STORAGE, sizeof(data), 0);
+    DvzId dat_id = req.id;
+    dvz_upload_dat(batch, dat_id, 0, sizeof(data), data, 0);
+    dvz_bind_dat(batch, compute_id, 0, dat_id, 0);
+
+    // Dispatch the compute, twice.
+    dvz_dispatch_compute(batch, compute_id, (uvec3){1, 1, 1});
+    dvz_dispatch_compute(batch, compute_id, (uvec3){1, 1, 1});
+
+    dvz_renderer_requests(rd, dvz_batch_size(batch), dvz_batch_requests(batch));
+
+    // Download the results.
+    DvzDat* dat = dvz_renderer_dat(rd, dat_id);
+    ANN(dat);
+    float out[20] = {0};
+    dvz_dat_download(dat, 0, sizeof(out), out, true);
+    for (uint32_t i = 0; i < n; i++)
+        AT(out[i] == 4 * data[i]);
+
+    // Delete the compute pipe.
+    dvz_batch_clear(batch);
+    dvz_delete_compute(batch, compute_id);
+    dvz_renderer_requests(rd, dvz_batch_size(batch), dvz_batch_requests(batch));
+
+    dvz_batch_destroy(batch);
+    dvz_renderer_destroy(rd);
+    return 0;
+}
+
+
+
 int test_renderer_resize(TstSuite* suite)
 {
     DvzGpu* gpu = get_gpu(suite);
@@ -31,6 +31,8 @@ int test_renderer_graphics(TstSuite*);
 
 int test_renderer_push(TstSuite*);
 
+int test_renderer_compute(TstSuite*);
+
 int test_renderer_resize(TstSuite*);
 
 
@@ -60,6 +60,65 @@ int test_request_1(TstSuite* suite)
 
 
 
+int test_request_compute(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+
+    DvzRequest req = dvz_create_glsl(batch, DVZ_SHADER_COMPUTE, "void main() {}");
+    DvzId shader_id = req.id;
+
+    DvzRequest req_compute = dvz_create_compute(batch, shader_id, 0);
+    DvzId compute_id = req_compute.id;
+    AT(compute_id != DVZ_ID_NONE);
+    AT(compute_id != shader_id);
+    AT(req_compute.action == DVZ_REQUEST_ACTION_CREATE);
+    AT(req_compute.type == DVZ_REQUEST_OBJECT_COMPUTE);
+    AT(req_compute.content.compute.shader == shader_id);
+
+    // Slots and bindings reuse the graphics requests with the compute id.
+    dvz_set_slot(batch, compute_id, 0, DVZ_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    req = dvz_create_dat(batch, DVZ_BUFFER_TYPE_STORAGE, 64, 0);
+    dvz_bind_dat(batch, compute_id, 0, req.id, 0);
+
+    DvzRequest req_dispatch = dvz_dispatch_compute(batch, compute_id, (uvec3){4, 2, 1});
+    AT(req_dispatch.action == DVZ_REQUEST_ACTION_DISPATCH);
+    AT(req_dispatch.type == DVZ_REQUEST_OBJECT_COMPUTE);
+    AT(req_dispatch.id == compute_id);
+    AT(req_dispatch.content.dispatch.group_count[0] == 4);
+    AT(req_dispatch.content.dispatch.group_count[1] == 2);
+    AT(req_dispatch.content.dispatch.group_count[2] == 1);
+
+    // The dispatch can also be recorded in the command buffers of a canvas.
+    DvzId canvas_id = 1;
+    DvzRequest req_record =
+        dvz_record_dispatch(batch, canvas_id, compute_id, (uvec3){8, 1, 1}, req.id);
+    AT(req_record.action == DVZ_REQUEST_ACTION_RECORD);
+    AT(req_record.id == canvas_id);
+    DvzRecorderCommand* rc = &req_record.content.record.command;
+    AT(rc->type == DVZ_RECORDER_DISPATCH);
+    AT(rc->contents.dispatch.pipe_id == compute_id);
+    AT(rc->contents.dispatch.group_count[0] == 8);
+    AT(rc->contents.dispatch.dat_indirect_id == req.id);
+
+    DvzRequest req_delete = dvz_delete_compute(batch, compute_id);
+    AT(req_delete.action == DVZ_REQUEST_ACTION_DELETE);
+    AT(req_delete.type == DVZ_REQUEST_OBJECT_COMPUTE);
+
+    // The requests are stored in order in the batch.
+    DvzRequest* reqs = dvz_batch_requests(batch);
+    AT(dvz_batch_size(batch) == 8);
+    AT(memcmp(&reqs[1], &req_compute, sizeof(DvzRequest)) == 0);
+    AT(memcmp(&reqs[5], &req_dispatch, sizeof(DvzRequest)) == 0);
+    AT(memcmp(&reqs[6], &req_record, sizeof(DvzRequest)) == 0);
+    AT(memcmp(&reqs[7], &req_delete, sizeof(DvzRequest)) == 0);
+    dvz_batch_print(batch, 0);
+
+    dvz_batch_destroy(batch);
+    return 0;
+}
+
+
+
 int test_requester_1(TstSuite* suite)
 {
     // Create a requester.
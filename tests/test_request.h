@@ -27,6 +27,8 @@
 
 int test_request_1(TstSuite*);
 
+int test_request_compute(TstSuite*);
+
 int test_requester_1(TstSuite*);
 
 
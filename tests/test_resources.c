@@ -199,6 +199,69 @@ int test_resources_dat_resize(TstSuite* suite)
 
 
 
+int test_resources_dat_keep(TstSuite* suite)
+{
+    ANN(suite);
+    DvzGpu* gpu = get_gpu(suite);
+    ANN(gpu);
+
+    DvzContext* ctx = dvz_context(gpu);
+    ANN(ctx);
+    ctx->res.img_count = 3;
+
+    uint8_t data[256] = {0};
+    uint8_t data1[256] = {0};
+    for (uint32_t i = 0; i < 256; i++)
+        data[i] = i;
+
+    // Shared, standalone, and with a persistent staging dat.
+    int flags[] = {
+        DVZ_DAT_FLAGS_KEEP_ON_RESIZE,
+        DVZ_DAT_FLAGS_KEEP_ON_RESIZE | DVZ_DAT_FLAGS_STANDALONE,
+        DVZ_DAT_FLAGS_KEEP_ON_RESIZE | DVZ_DAT_FLAGS_PERSISTENT_STAGING,
+    };
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        // A dat followed by another dat, so that it cannot grow in place.
+        DvzDat* dat = dvz_dat(ctx, DVZ_BUFFER_TYPE_VERTEX, 16, flags[k]);
+        DvzDat* other = dvz_dat(ctx, DVZ_BUFFER_TYPE_VERTEX, 16, flags[k]);
+        dvz_dat_upload(dat, 0, 16, data, true);
+
+        // Append 16 bytes at a time: the data is kept and the capacity grows geometrically.
+        uint32_t reallocs = 0;
+        DvzSize capacity = dat->br.size;
+        for (DvzSize size = 32; size <= 256; size += 16)
+        {
+            dvz_dat_resize(dat, size);
+            AT(dat->size == size);
+            AT(dat->br.size >= size);
+            if (dat->br.size != capacity)
+                reallocs++;
+            capacity = dat->br.size;
+            dvz_dat_upload(dat, size - 16, 16, &data[size - 16], true);
+        }
+        AT(reallocs == 4); // 16 -> 32 -> 64 -> 128 -> 256
+
+        dvz_dat_download(dat, 0, 256, data1, true);
+        AT(memcmp(data1, data, 256) == 0);
+
+        // Shrinking keeps the beginning of the data.
+        dvz_dat_resize(dat, 32);
+        AT(dat->size == 32);
+        memset(data1, 0, sizeof(data1));
+        dvz_dat_download(dat, 0, 32, data1, true);
+        AT(memcmp(data1, data, 32) == 0);
+
+        dvz_dat_destroy(dat);
+        dvz_dat_destroy(other);
+    }
+
+    dvz_context_destroy(ctx);
+    return 0;
+}
+
+
+
 int test_resources_tex_transfers(TstSuite* suite)
 {
     ANN(suite);
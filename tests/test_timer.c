@@ -77,18 +77,22 @@ int test_timer_1(TstSuite* suite)
     AT(dvz_timer_running(item));
 
     // The timer should fire at 0.5, 1.5, 2.5, 3.5, etc.
+    AT(dvz_timer_next(timer) == 0.5);
     AFF(0)
     AFF(0.49)
     AFT(0.5)
+    AT(dvz_timer_next(timer) == 1.5);
     AFF(0.99)
     AFF(1.01)
     AFF(1.49)
     AFT(1.60)
+    AT(dvz_timer_next(timer) == 2.5);
     AFF(2.49)
     AFT(2.51)
 
     // Pause.
     dvz_timer_pause(item);
+    AT(dvz_timer_next(timer) < 0);
     AFF(3.49)
     AFF(3.51)
     AFF(4.5)
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing trace                                                                                */
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "test_trace.h"
+#include "_thread_utils.h"
+#include "_trace.h"
+#include "datoviz_protocol.h"
+#include "fileio.h"
+#include "test.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+#define TRACE_THREAD_SPANS 10000
+
+static void* _trace_thread(void* user_data)
+{
+    dvz_trace_thread("worker");
+    for (uint32_t i = 0; i < TRACE_THREAD_SPANS; i++)
+    {
+        dvz_trace_begin_args("test", "span", "i", i, NULL, 0);
+        dvz_trace_end();
+    }
+    return NULL;
+}
+
+
+
+/*************************************************************************************************/
+/*  Trace tests                                                                                  */
+/*************************************************************************************************/
+
+int test_trace_1(TstSuite* suite)
+{
+    ANN(suite);
+    dvz_trace_clear();
+
+    // Nothing is recorded while tracing is disabled.
+    AT(!dvz_trace_enabled());
+    dvz_trace_begin("test", "disabled");
+    dvz_trace_end();
+    AT(dvz_trace_count() == 0);
+
+    dvz_trace_start();
+    AT(dvz_trace_enabled());
+    dvz_trace_thread("main");
+    dvz_trace_begin("test", "outer");
+    dvz_trace_instant("test", "instant");
+
+    // Two threads record spans concurrently in their own buffers, which span several chunks.
+    DvzThread* thread0 = dvz_thread(_trace_thread, NULL);
+    DvzThread* thread1 = dvz_thread(_trace_thread, NULL);
+    dvz_thread_join(thread0);
+    dvz_thread_join(thread1);
+
+    dvz_trace_end();
+    dvz_trace_stop();
+    AT(dvz_trace_count() == 3 + 2 * 2 * TRACE_THREAD_SPANS);
+
+    // Export the trace.
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/trace.json", ARTIFACTS_DIR);
+    AT(dvz_trace_write(path) == 0);
+
+    DvzSize size = 0;
+    char* json = (char*)dvz_read_file(path, &size);
+    ANN(json);
+    AT(size > 0);
+    AT(strncmp(json, "{\"traceEvents\":[", 16) == 0);
+    AT(strstr(json, "\"name\":\"worker\"") != NULL);
+    AT(strstr(json, "\"ph\":\"B\"") != NULL);
+    AT(strstr(json, "\"ph\":\"E\"") != NULL);
+    AT(strstr(json, "\"s\":\"t\"") != NULL);
+    AT(strstr(json, "\"args\":{\"i\":9999}") != NULL);
+    FREE(json);
+
+    dvz_trace_clear();
+    AT(dvz_trace_count() == 0);
+
+    // The main thread keeps recording into its emptied buffer after a clear.
+    dvz_trace_start();
+    dvz_trace_begin("test", "again");
+    dvz_trace_end();
+    dvz_trace_stop();
+    AT(dvz_trace_count() == 2);
+
+    dvz_trace_clear();
+    AT(dvz_trace_count() == 0);
+    return 0;
+}
+
+
+
+int test_trace_2(TstSuite* suite)
+{
+    ANN(suite);
+    dvz_trace_clear();
+    dvz_trace_start();
+
+    // The request pipeline is traced without any GPU.
+    DvzRequester* rqr = dvz_requester();
+    DvzBatch* batch = dvz_batch();
+    dvz_create_dat(batch, DVZ_BUFFER_TYPE_VERTEX, 16, 0);
+    dvz_requester_commit(rqr, batch);
+
+    uint32_t count = 0;
+    DvzBatch* batches = dvz_requester_flush(rqr, &count);
+    AT(count == 1);
+
+    dvz_trace_stop();
+    AT(dvz_trace_count() == 4); // commit and flush spans
+
+    FREE(batches);
+    dvz_batch_destroy(batch);
+    dvz_requester_destroy(rqr);
+    dvz_trace_clear();
+    return 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing trace                                                                                */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_TRACE
+#define DVZ_HEADER_TEST_TRACE
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_trace.h"
+#include "test.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Trace tests                                                                                  */
+/*************************************************************************************************/
+
+int test_trace_1(TstSuite*);
+
+int test_trace_2(TstSuite*);
+
+
+
+#endif
@@ -767,25 +767,54 @@ int test_vklite_shader(TstSuite* suite)
 #if HAS_SHADERC
     DvzHost* host = get_host(suite);
 
+    // Keep the SPIR-V disk cache in the artifacts directory.
+    char prev[1024] = {0};
+    test_cache_dir(prev, sizeof(prev));
+
     DvzGpu* gpu = dvz_gpu_best(host);
     dvz_gpu_queue(gpu, 0, DVZ_QUEUE_RENDER);
     dvz_gpu_create(gpu, VK_NULL_HANDLE);
 
-    VkShaderModule module = dvz_compile_glsl(
-        gpu,
-        "#version 450\n"
-        "layout (location = 0) in vec3 pos;\n"
-        "layout (location = 1) in vec4 color;\n"
-        "layout (location = 0) out vec4 out_color;\n"
-        "void main() {\n"
-        "    gl_Position = vec4(pos, 1.0);\n"
-        "    out_color = color;\n"
-        "}",
-        VK_SHADER_STAGE_VERTEX_BIT);
+    const char* code = "#version 450\n"
+                       "layout (location = 0) in vec3 pos;\n"
+                       "layout (location = 1) in vec4 color;\n"
+                       "layout (location = 0) out vec4 out_color;\n"
+                       "void main() {\n"
+                       "    gl_Position = vec4(pos, 1.0);\n"
+                       "    out_color = color;\n"
+                       "}";
+    VkShaderModule module = dvz_compile_glsl(gpu, code, VK_SHADER_STAGE_VERTEX_BIT);
+    AT(module != VK_NULL_HANDLE);
     vkDestroyShaderModule(gpu->device, module, NULL);
 
+    // The second compilation of the same code hits the in-memory SPIR-V cache.
+    DvzCompiler* compiler = dvz_host_compiler(gpu);
+    ANN(compiler);
+    uint32_t hits = compiler->hits;
+    DvzSize size = 0;
+    uint32_t* spirv = dvz_compile_spirv(gpu, code, VK_SHADER_STAGE_VERTEX_BIT, &size);
+    ANN(spirv);
+    AT(size > 0);
+    AT(spirv[0] == 0x07230203);
+    AT(compiler->hits == hits + 1);
+
+    // Compile several shaders in parallel, then check they are all in the cache.
+    const char* codes[] = {
+        code,
+        "#version 450\nlayout (location = 0) out vec4 c;\nvoid main() {c = vec4(1);}",
+        "#version 450\nlayout (location = 0) out vec4 c;\nvoid main() {c = vec4(0);}",
+    };
+    VkShaderStageFlagBits stages[] = {
+        VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_FRAGMENT_BIT};
+    dvz_compiler_batch(compiler, 3, codes, stages);
+    hits = compiler->hits;
+    for (uint32_t i = 0; i < 3; i++)
+        ANN(dvz_compile_spirv(gpu, codes[i], stages[i], &size));
+    AT(compiler->hits == hits + 3);
+
     dvz_gpu_destroy(gpu);
     // dvz_host_destroy(host);
+    test_cache_restore(prev);
     return 0;
 #else
     log_warn("skip shader compilation test as the library was not compiled with glslc support");
@@ -852,6 +881,61 @@ int test_vklite_graphics(TstSuite* suite)
 
 
 
+int test_vklite_pipeline_cache(TstSuite* suite)
+{
+    ANN(suite);
+    DvzHost* host = get_host(suite);
+    DvzGpu* gpu = dvz_gpu_best(host);
+    double time[2] = {0};
+    DvzSize loaded[2] = {0};
+    int saved = 0;
+
+    // Start from an empty pipeline cache in the artifacts directory.
+    char prev[1024] = {0};
+    test_cache_dir(prev, sizeof(prev));
+    char path[1024] = {0};
+    if (pipeline_cache_path(gpu, path, sizeof(path)) == 0)
+        remove(path);
+
+    // Create the same graphics pipeline twice, the second GPU creation loads the pipeline cache
+    // saved by the first one.
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        dvz_gpu_queue(gpu, 0, DVZ_QUEUE_RENDER);
+        dvz_gpu_create(gpu, 0);
+        loaded[i] = gpu->pipeline_cache_loaded;
+
+        TestCanvas canvas = offscreen_canvas(gpu);
+        DvzGraphics graphics = triangle_graphics(gpu, &canvas.renderpass);
+        DvzDescriptors descriptors = dvz_descriptors(&graphics.dslots, 1);
+        dvz_descriptors_update(&descriptors);
+        dvz_graphics_create(&graphics);
+        AT(dvz_obj_is_created(&graphics.obj));
+        AT(gpu->pipeline_count == 1);
+        time[i] = gpu->pipeline_time;
+
+        dvz_graphics_destroy(&graphics);
+        dvz_descriptors_destroy(&descriptors);
+        canvas_destroy(&canvas);
+        if (i == 0)
+            saved = dvz_gpu_save_cache(gpu);
+        dvz_gpu_destroy(gpu);
+    }
+
+    // NOTE: the cache may be disabled with DVZ_NO_CACHE, or the cache directory not writable.
+    AT(loaded[0] == 0);
+    if (saved == 0)
+        AT(loaded[1] > 0);
+    log_info(
+        "pipeline creation: %.3f ms (cache %s), then %.3f ms (cache %s)", time[0] * 1000,
+        pretty_size(loaded[0]), time[1] * 1000, pretty_size(loaded[1]));
+
+    test_cache_restore(prev);
+    return 0;
+}
+
+
+
 int test_vklite_indirect(TstSuite* suite)
 {
     ANN(suite);
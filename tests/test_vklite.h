@@ -42,6 +42,7 @@ int test_vklite_shader(TstSuite*);
 int test_vklite_surface(TstSuite*);
 int test_vklite_swapchain(TstSuite*);
 int test_vklite_graphics(TstSuite*);
+int test_vklite_pipeline_cache(TstSuite*);
 int test_vklite_indirect(TstSuite*);
 int test_vklite_indexed(TstSuite*);
 int test_vklite_instanced(TstSuite*);
@@ -442,4 +442,46 @@ static void* graphics_scatter(DvzBatch* batch, DvzId dat_id, const uint32_t n)
 
 
 
+/*************************************************************************************************/
+/*  Cache utils                                                                                  */
+/*************************************************************************************************/
+
+static void _test_setenv(const char* name, const char* value)
+{
+    ANN(name);
+    ANN(value);
+    // NOTE: an empty value unsets the variable.
+#if OS_WINDOWS
+    _putenv_s(name, value);
+#else
+    if (strlen(value) > 0)
+        setenv(name, value, 1);
+    else
+        unsetenv(name);
+#endif
+}
+
+
+
+// Redirect the on-disk caches to the artifacts directory, so that a test neither depends on nor
+// modifies the user cache. The previous value is saved in prev, to be passed to
+// test_cache_restore() at the end of the test.
+static void test_cache_dir(char* prev, size_t size)
+{
+    ANN(prev);
+    const char* env = getenv("DVZ_CACHE_DIR");
+    snprintf(prev, size, "%s", env != NULL ? env : "");
+    _test_setenv("DVZ_CACHE_DIR", ARTIFACTS_DIR);
+}
+
+
+
+static void test_cache_restore(const char* prev)
+{
+    ANN(prev);
+    _test_setenv("DVZ_CACHE_DIR", prev);
+}
+
+
+
 #endif
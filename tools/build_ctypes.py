@@ -34,6 +34,8 @@ on_frame = DvzAppFrameCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, P_(Dv
 on_timer = DvzAppTimerCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, P_(DvzTimerEvent))
 on_resize = DvzAppResizeCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, P_(DvzWindowEvent))
 DvzErrorCallback = ctypes.CFUNCTYPE(None, ctypes.c_char_p)
+DvzBricksCallback = ctypes.CFUNCTYPE(None, P_(DvzBricks), ctypes.c_uint32, P_(ctypes.c_uint32), P_(ctypes.c_uint32), ctypes.c_void_p, ctypes.c_void_p)
+DvzTilesCallback = ctypes.CFUNCTYPE(None, P_(DvzTiles), ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_void_p, ctypes.c_void_p)
 
 """)
 